@@ -1,13 +1,14 @@
 /**
  * @file EARS_backLightManagerLib.h
  * @author Julian (51fiftyone51fiftyone@gmail.com)
- * @brief Manages LCD backlight with PWM control, NVS storage, and screen saver integration
- * @version 1.8.0
+ * @brief Manages LCD backlight with PWM control, ears.config storage, and screen saver integration
+ * @version 1.10.0
  * @date 20260118
  * 
  * @copyright Copyright (c) 2026 JTB. All rights reserved.
  */
 #include "EARS_backLightManagerLib.h"
+#include "EARS_loggerLib.h"
 
 // Constructor
 EARS_backLightManager::EARS_backLightManager()
@@ -35,7 +36,7 @@ bool EARS_backLightManager::begin(uint8_t pin, uint8_t pwmChannel,
 
     // Open NVS preferences
     if (!_preferences.begin(NVS_NAMESPACE, false)) {
-        Serial.println("[BacklightManager] ERROR: Failed to open NVS");
+        LOG_TAG_ERROR(BACKLIGHT, "[BacklightManager] Failed to open NVS");
         return false;
     }
 
@@ -45,19 +46,27 @@ bool EARS_backLightManager::begin(uint8_t pin, uint8_t pwmChannel,
     if (isInitialConfig()) {
         // First time setup - use 100% brightness
         initialBrightness = INITIAL_CONFIG_BRIGHTNESS;
-        Serial.println("[BacklightManager] Initial config detected - using 100% brightness");
+        LOG_TAG_INFO(BACKLIGHT, "[BacklightManager] Initial config detected - using 100% brightness");
+    } else if (EARS_config::getInstance().isLoaded()) {
+        // Load saved brightness (ears.config default if never saved)
+        migrateBrightness();
+        initialBrightness = EARS_config::getInstance().display().brightness;
+        LOG_TAG_INFOF(BACKLIGHT, "[BacklightManager] Loaded brightness: %d%%", initialBrightness);
     } else {
-        // Load saved brightness or use default
+        // No ears.config (yet): NVS keeps the level until it is loaded
         initialBrightness = _preferences.getUChar(NVS_BRIGHTNESS_KEY, DEFAULT_BRIGHTNESS);
-        Serial.printf("[BacklightManager] Loaded brightness: %d%%\n", initialBrightness);
+        LOG_TAG_INFOF(BACKLIGHT, "[BacklightManager] Loaded brightness from NVS: %d%%", initialBrightness);
     }
 
+    // Follow display.brightness from here on, whoever changes it
+    EARS_config::getInstance().subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS), configChanged, this);
+
     // Set initial brightness immediately
     setBrightness(initialBrightness);
     
     _initialized = true;
-    Serial.printf("[BacklightManager] Initialized on pin %d, PWM channel %d, freq %d Hz\n", 
-                  _pin, _pwmChannel, pwmFrequency);
+    LOG_TAG_INFOF(BACKLIGHT, "[BacklightManager] Initialized on pin %d, PWM channel %d, freq %d Hz", 
+                   _pin, _pwmChannel, pwmFrequency);
     
     return true;
 }
@@ -65,7 +74,7 @@ bool EARS_backLightManager::begin(uint8_t pin, uint8_t pwmChannel,
 // Set brightness immediately
 void EARS_backLightManager::setBrightness(uint8_t level) {
     if (!_initialized) {
-        Serial.println("[BacklightManager] ERROR: Not initialized");
+        LOG_TAG_ERROR(BACKLIGHT, "[BacklightManager] Not initialized");
         return;
     }
 
@@ -78,13 +87,13 @@ void EARS_backLightManager::setBrightness(uint8_t level) {
     uint32_t dutyCycle = percentageToDutyCycle(level);
     ledcWrite(_pwmChannel, dutyCycle);
     
-    Serial.printf("[BacklightManager] Brightness set to %d%% (duty: %d)\n", level, dutyCycle);
+    LOG_TAG_DEBUGF(BACKLIGHT, "[BacklightManager] Brightness set to %d%% (duty: %d)", level, dutyCycle);
 }
 
 // Fade to brightness smoothly
 void EARS_backLightManager::fadeToBrightness(uint8_t targetLevel, uint16_t durationMs) {
     if (!_initialized) {
-        Serial.println("[BacklightManager] ERROR: Not initialized");
+        LOG_TAG_ERROR(BACKLIGHT, "[BacklightManager] Not initialized");
         return;
     }
 
@@ -103,8 +112,8 @@ void EARS_backLightManager::fadeToBrightness(uint8_t targetLevel, uint16_t durat
     uint32_t startTime = millis();
     uint32_t endTime = startTime + durationMs;
     
-    Serial.printf("[BacklightManager] Fading from %d%% to %d%% over %dms\n", 
-                  startLevel, targetLevel, durationMs);
+    LOG_TAG_DEBUGF(BACKLIGHT, "[BacklightManager] Fading from %d%% to %d%% over %dms", 
+                   startLevel, targetLevel, durationMs);
 
     // Perform fade
     while (millis() < endTime) {
@@ -129,38 +138,56 @@ uint8_t EARS_backLightManager::getBrightness() const {
     return _currentBrightness;
 }
 
-// Save brightness to NVS
+// Save brightness to ears.config (written back by EARS_config after its
+// debounce), or to NVS while ears.config is not loaded
 bool EARS_backLightManager::saveBrightness() {
     if (!_initialized) {
-        Serial.println("[BacklightManager] ERROR: Not initialized");
+        LOG_TAG_ERROR(BACKLIGHT, "[BacklightManager] Not initialized");
         return false;
     }
 
-    size_t written = _preferences.putUChar(NVS_BRIGHTNESS_KEY, _currentBrightness);
-    
-    if (written) {
-        Serial.printf("[BacklightManager] Saved brightness: %d%%\n", _currentBrightness);
+    EARS_config& config = EARS_config::getInstance();
+    if (!config.isLoaded()) {
+        if (!_preferences.putUChar(NVS_BRIGHTNESS_KEY, _currentBrightness)) {
+            LOG_TAG_ERROR(BACKLIGHT, "[BacklightManager] Failed to save brightness");
+            return false;
+        }
+        LOG_TAG_INFOF(BACKLIGHT, "[BacklightManager] Saved brightness to NVS: %d%%", _currentBrightness);
         return true;
-    } else {
-        Serial.println("[BacklightManager] ERROR: Failed to save brightness");
-        return false;
     }
+
+    DisplaySettings display = config.display();
+    display.brightness = _currentBrightness;
+    config.setDisplay(display, millis());
+    // ears.config holds the level now; an older NVS copy must not win later
+    if (_preferences.isKey(NVS_BRIGHTNESS_KEY)) {
+        _preferences.remove(NVS_BRIGHTNESS_KEY);
+    }
+    LOG_TAG_INFOF(BACKLIGHT, "[BacklightManager] Saved brightness: %d%%", _currentBrightness);
+    return true;
 }
 
-// Load brightness from NVS
+// Load brightness from ears.config, or from NVS while it is not loaded
 bool EARS_backLightManager::loadBrightness() {
     if (!_initialized) {
-        Serial.println("[BacklightManager] ERROR: Not initialized");
+        LOG_TAG_ERROR(BACKLIGHT, "[BacklightManager] Not initialized");
         return false;
     }
 
-    if (_preferences.isKey(NVS_BRIGHTNESS_KEY)) {
+    EARS_config& config = EARS_config::getInstance();
+    if (config.isLoaded()) {
+        migrateBrightness();
+        uint8_t savedLevel = config.display().brightness;
+        setBrightness(savedLevel);
+        LOG_TAG_INFOF(BACKLIGHT, "[BacklightManager] Loaded brightness: %d%%", savedLevel);
+        return true;
+    } else if (_preferences.isKey(NVS_BRIGHTNESS_KEY)) {
         uint8_t savedLevel = _preferences.getUChar(NVS_BRIGHTNESS_KEY, DEFAULT_BRIGHTNESS);
         setBrightness(savedLevel);
-        Serial.printf("[BacklightManager] Loaded brightness: %d%%\n", savedLevel);
+        LOG_TAG_INFOF(BACKLIGHT, "[BacklightManager] Loaded brightness from NVS: %d%%", savedLevel);
         return true;
     } else {
-        Serial.println("[BacklightManager] No saved brightness found");
+        LOG_TAG_INFO(BACKLIGHT, "[BacklightManager] No saved brightness found");
         return false;
     }
 }
@@ -188,7 +215,7 @@ void EARS_backLightManager::completeInitialConfig() {
     // Save current brightness and set default for future
     saveBrightness();
     
-    Serial.println("[BacklightManager] Initial config marked complete");
+    LOG_TAG_INFO(BACKLIGHT, "[BacklightManager] Initial config marked complete");
 }
 
 // Store brightness before screen saver activates
@@ -200,8 +227,8 @@ void EARS_backLightManager::screenSaverActivate() {
     _savedBrightness = _currentBrightness;
     _screenSaverActive = true;
     
-    Serial.printf("[BacklightManager] Screen saver activated - saved brightness: %d%%\n", 
-                  _savedBrightness);
+    LOG_TAG_INFOF(BACKLIGHT, "[BacklightManager] Screen saver activated - saved brightness: %d%%", 
+                   _savedBrightness);
     
     // Fade to off or dim level (you can make this configurable)
     fadeToBrightness(0, 500);  // 500ms fade to black
@@ -215,8 +242,8 @@ void EARS_backLightManager::screenSaverDeactivate() {
 
     _screenSaverActive = false;
     
-    Serial.printf("[BacklightManager] Screen saver deactivated - restoring brightness: %d%%\n", 
-                  _savedBrightness);
+    LOG_TAG_INFOF(BACKLIGHT, "[BacklightManager] Screen saver deactivated - restoring brightness: %d%%", 
+                   _savedBrightness);
     
     // Fade back to saved brightness
     fadeToBrightness(_savedBrightness, 300);  // 300ms fade back
@@ -227,6 +254,34 @@ bool EARS_backLightManager::isScreenSaverActive() const {
     return _screenSaverActive;
 }
 
+// Move a brightness saved in NVS (by older firmware, or while ears.config
+// was not loaded) to ears.config; the key is only removed once it is
+void EARS_backLightManager::migrateBrightness() {
+    EARS_config& config = EARS_config::getInstance();
+    if (!config.isLoaded() || !_preferences.isKey(NVS_BRIGHTNESS_KEY)) {
+        return;
+    }
+
+    DisplaySettings display = config.display();
+    display.brightness = _preferences.getUChar(NVS_BRIGHTNESS_KEY, DEFAULT_BRIGHTNESS);
+    config.setDisplay(display, millis());
+    _preferences.remove(NVS_BRIGHTNESS_KEY);
+    LOG_TAG_INFOF(BACKLIGHT, "[BacklightManager] Moved brightness %d%% from NVS to ears.config", display.brightness);
+}
+
+// Apply display.brightness changed elsewhere; while the screen saver is
+// active it becomes the level restored on wake
+void EARS_backLightManager::configChanged(ConfigKeyMask changed, const ConfigModel& model, void* context) {
+    EARS_backLightManager* manager = static_cast<EARS_backLightManager*>(context);
+    (void)changed;
+    uint8_t level = model.display.brightness;
+    if (manager->_screenSaverActive) {
+        manager->_savedBrightness = level;
+    } else if (level != manager->_currentBrightness) {
+        manager->setBrightness(level);
+    }
+}
+
 // Convert percentage to PWM duty cycle
 uint32_t EARS_backLightManager::percentageToDutyCycle(uint8_t percentage) const {
     // Simple linear mapping: 0% = 0, 100% = maxDutyCycle
@@ -1,13 +1,15 @@
 /**
  * @file EARS_backLightManagerLib.h
  * @author Julian (51fiftyone51fiftyone@gmail.com)
- * @brief Manages LCD backlight with PWM control, NVS storage, and screen saver integration
- * @version 1.8.0
+ * @brief Manages LCD backlight with PWM control, ears.config storage, and screen saver integration
+ * @version 1.10.0
  * @date 2026018
  * 
  * Features:
  * - Analog PWM brightness control (0-100%)
- * - NVS storage for user preferences
+ * - Brightness kept in ears.config (display.brightness) and followed
+ *   through EARS_config, so a change made anywhere applies at once;
+ *   NVS keeps it while ears.config is not loaded
  * - Screen saver integration
  * - Smooth fade transitions
  * - Initial device config detection (100% brightness)
@@ -25,6 +27,7 @@
  *****************************************************************************/
 #include <Arduino.h>
 #include <Preferences.h>
+#include "EARS_configLib.h"
 
 class EARS_backLightManager {
 public:
@@ -64,13 +67,13 @@ public:
     uint8_t getBrightness() const;
 
     /**
-     * @brief Save current brightness to NVS
+     * @brief Save current brightness to ears.config (NVS while it is not loaded)
      * @return true if save successful
      */
     bool saveBrightness();
 
     /**
-     * @brief Load brightness from NVS
+     * @brief Load brightness from ears.config (NVS while it is not loaded)
      * @return true if load successful
      */
     bool loadBrightness();
@@ -125,7 +128,7 @@ private:
 
     Preferences _preferences;
 
-    // NVS keys
+    // NVS keys (brightness only until it is moved to ears.config)
     static constexpr const char* NVS_NAMESPACE = "backlight";
     static constexpr const char* NVS_BRIGHTNESS_KEY = "brightness";
     static constexpr const char* NVS_INIT_FLAG_KEY = "init_done";
@@ -140,6 +143,19 @@ private:
      * @return uint32_t PWM duty cycle value
      */
     uint32_t percentageToDutyCycle(uint8_t percentage) const;
+
+    /**
+     * @brief Move a brightness saved in NVS to ears.config once it is loaded
+     */
+    void migrateBrightness();
+
+    /**
+     * @brief EARS_config observer for display.brightness
+     * @param changed Keys that changed
+     * @param model Every setting
+     * @param context EARS_backLightManager instance
+     */
+    static void configChanged(ConfigKeyMask changed, const ConfigModel& model, void* context);
 };
 
 // Global instance access function
@@ -0,0 +1,513 @@
+/**
+ * @file EARS_configJson.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Heap-free JSON reader and pretty writer for ears.config
+ * @version 1.1.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_configJson.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Reader position and the buffers values are decoded into
+ */
+struct ConfigJsonParse {
+    const char* at;
+    const char* end;
+    ConfigJsonVisitor visitor;
+    void* context;
+    char keys[EARS_configJsonReader::MAX_DEPTH][EARS_configJsonReader::KEY_BYTES];
+    const char* keyList[EARS_configJsonReader::MAX_DEPTH];
+    char value[EARS_configJsonReader::VALUE_BYTES];
+};
+
+static bool parseValue(ConfigJsonParse& state, uint8_t depth, uint8_t nesting, bool report);
+
+/**
+ * @brief Skip whitespace
+ */
+static void skipSpace(ConfigJsonParse& state) {
+    while (state.at < state.end &&
+           (*state.at == ' ' || *state.at == '\t' || *state.at == '\n' || *state.at == '\r')) {
+        state.at++;
+    }
+}
+
+/**
+ * @brief Hand a value to the visitor
+ */
+static void report(ConfigJsonParse& state, uint8_t depth, ConfigJsonType type, const char* text, bool boolean,
+                   const char* raw, const char* rawEnd) {
+    ConfigJsonValue value;
+    value.type = type;
+    value.text = text;
+    value.boolean = boolean;
+    value.raw = raw;
+    value.rawLength = (size_t)(rawEnd - raw);
+    state.visitor(state.keyList, depth, value, state.context);
+}
+
+/**
+ * @brief Value of one hex digit, -1 if not one
+ */
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief Decode a string starting at its opening quote
+ * @param state Reader
+ * @param out Destination, cut to capacity - 1 bytes
+ * @param capacity Size of out
+ * @return true if the string was well formed
+ *
+ * \\u escapes outside ASCII become '?'; ears.config holds no such text.
+ */
+static bool parseString(ConfigJsonParse& state, char* out, size_t capacity) {
+    size_t used = 0;
+    state.at++;
+    while (state.at < state.end) {
+        char c = *state.at++;
+        if (c == '"') {
+            out[used] = '\0';
+            return true;
+        }
+        if ((unsigned char)c < 0x20) {
+            return false;
+        }
+        if (c == '\\') {
+            if (state.at >= state.end) {
+                return false;
+            }
+            char escaped = *state.at++;
+            switch (escaped) {
+                case '"': case '\\': case '/': c = escaped; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'u': {
+                    if (state.end - state.at < 4) {
+                        return false;
+                    }
+                    int code = 0;
+                    for (int i = 0; i < 4; i++) {
+                        int digit = hexDigit(state.at[i]);
+                        if (digit < 0) {
+                            return false;
+                        }
+                        code = (code << 4) | digit;
+                    }
+                    state.at += 4;
+                    c = code < 0x80 ? (char)code : '?';
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        if (used + 1 < capacity) {
+            out[used++] = c;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Parse an object starting at its opening brace
+ * @param state Reader
+ * @param depth Keys leading to this object
+ * @param nesting Objects and arrays open around it
+ * @param reportMembers Whether its members are reported
+ * @return true if well formed
+ */
+static bool parseObject(ConfigJsonParse& state, uint8_t depth, uint8_t nesting, bool reportMembers) {
+    char scratch[EARS_configJsonReader::KEY_BYTES];
+    state.at++;
+    skipSpace(state);
+    if (state.at < state.end && *state.at == '}') {
+        state.at++;
+        return true;
+    }
+
+    bool keep = reportMembers && depth < EARS_configJsonReader::MAX_DEPTH;
+    for (;;) {
+        skipSpace(state);
+        if (state.at >= state.end || *state.at != '"') {
+            return false;
+        }
+        char* key = keep ? state.keys[depth] : scratch;
+        if (!parseString(state, key, EARS_configJsonReader::KEY_BYTES)) {
+            return false;
+        }
+        if (keep) {
+            state.keyList[depth] = state.keys[depth];
+        }
+        skipSpace(state);
+        if (state.at >= state.end || *state.at != ':') {
+            return false;
+        }
+        state.at++;
+        if (!parseValue(state, depth + 1, nesting, keep)) {
+            return false;
+        }
+        skipSpace(state);
+        if (state.at >= state.end) {
+            return false;
+        }
+        char c = *state.at++;
+        if (c == '}') {
+            return true;
+        }
+        if (c != ',') {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Skip an array starting at its opening bracket
+ */
+static bool skipArray(ConfigJsonParse& state, uint8_t depth, uint8_t nesting) {
+    state.at++;
+    skipSpace(state);
+    if (state.at < state.end && *state.at == ']') {
+        state.at++;
+        return true;
+    }
+    for (;;) {
+        if (!parseValue(state, depth, nesting, false)) {
+            return false;
+        }
+        skipSpace(state);
+        if (state.at >= state.end) {
+            return false;
+        }
+        char c = *state.at++;
+        if (c == ']') {
+            return true;
+        }
+        if (c != ',') {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Match a literal such as "true"
+ */
+static bool literal(ConfigJsonParse& state, const char* word) {
+    size_t length = strlen(word);
+    if ((size_t)(state.end - state.at) < length || memcmp(state.at, word, length) != 0) {
+        return false;
+    }
+    state.at += length;
+    return true;
+}
+
+/**
+ * @brief Find where the object or array starting at `at` ends
+ * @return Just past its closing bracket, or `end` if it has none
+ *
+ * Brackets inside strings are passed over; the text is validated when it
+ * is parsed, not here.
+ */
+static const char* containerEnd(const char* at, const char* end) {
+    int open = 0;
+    while (at < end) {
+        char c = *at++;
+        if (c == '"') {
+            while (at < end && *at != '"') {
+                at += (*at == '\\' && at + 1 < end) ? 2 : 1;
+            }
+            at++;
+        } else if (c == '{' || c == '[') {
+            open++;
+        } else if ((c == '}' || c == ']') && --open == 0) {
+            return at;
+        }
+    }
+    return end;
+}
+
+/**
+ * @brief Parse any value
+ * @param state Reader
+ * @param depth Keys leading to the value
+ * @param nesting Objects and arrays open around it
+ * @param reportValue Whether the value is reported
+ * @return true if well formed
+ */
+static bool parseValue(ConfigJsonParse& state, uint8_t depth, uint8_t nesting, bool reportValue) {
+    skipSpace(state);
+    if (state.at >= state.end) {
+        return false;
+    }
+    const char* start = state.at;
+    char c = *state.at;
+    if (c == '{' || c == '[') {
+        if (nesting >= EARS_configJsonReader::MAX_NESTING) {
+            return false;
+        }
+        if (c == '[') {
+            if (!skipArray(state, depth, nesting + 1)) {
+                return false;
+            }
+            if (reportValue) {
+                report(state, depth, ConfigJsonType::ARRAY, "", false, start, state.at);
+            }
+            return true;
+        }
+        if (reportValue) {
+            // Reported before its members, so its extent is found ahead
+            report(state, depth, ConfigJsonType::OBJECT, "", false, start, containerEnd(start, state.end));
+        }
+        return parseObject(state, depth, nesting + 1, reportValue);
+    }
+    if (c == '"') {
+        if (!parseString(state, state.value, sizeof(state.value))) {
+            return false;
+        }
+        if (reportValue) {
+            report(state, depth, ConfigJsonType::STRING, state.value, false, start, state.at);
+        }
+        return true;
+    }
+    if (c == 't' || c == 'f' || c == 'n') {
+        bool isTrue = literal(state, "true");
+        if (!isTrue && !literal(state, "false") && !literal(state, "null")) {
+            return false;
+        }
+        if (reportValue) {
+            bool isNull = c == 'n';
+            report(state, depth, isNull ? ConfigJsonType::NUL : ConfigJsonType::BOOL, "", isTrue, start, state.at);
+        }
+        return true;
+    }
+
+    size_t used = 0;
+    bool digits = false;
+    while (state.at < state.end && (strchr("+-.eE", *state.at) || (*state.at >= '0' && *state.at <= '9'))) {
+        digits = digits || (*state.at >= '0' && *state.at <= '9');
+        if (used + 1 < sizeof(state.value)) {
+            state.value[used++] = *state.at;
+        }
+        state.at++;
+    }
+    state.value[used] = '\0';
+    if (!digits) {
+        return false;
+    }
+    if (reportValue) {
+        report(state, depth, ConfigJsonType::NUMBER, state.value, false, start, state.at);
+    }
+    return true;
+}
+
+/**
+ * @brief Parse a document whose root is an object
+ * @param text Document text
+ * @param length Bytes of text
+ * @param visitor Called for each value
+ * @param context Passed to visitor unchanged
+ * @return true if the root object was well formed
+ */
+bool EARS_configJsonReader::parse(const char* text, size_t length, ConfigJsonVisitor visitor, void* context) {
+    if (!text || !visitor) {
+        return false;
+    }
+    ConfigJsonParse state;
+    state.at = text;
+    state.end = text + length;
+    state.visitor = visitor;
+    state.context = context;
+    skipSpace(state);
+    if (state.at >= state.end || *state.at != '{') {
+        return false;
+    }
+    // Anything after the root object (e.g. a trailer) is not read
+    return parseObject(state, 0, 1, true);
+}
+
+/**
+ * @brief Start writing
+ * @param out Destination
+ * @param capacity Size of out, a terminator is always kept
+ * @param depth Indent level of the first member (0 = root value)
+ */
+EARS_configJsonWriter::EARS_configJsonWriter(char* out, size_t capacity, uint8_t depth)
+    : _out(out), _capacity(capacity), _used(0), _overflow(false), _depth(depth), _started(false) {
+    for (uint8_t i = 0; i <= MAX_DEPTH; i++) {
+        _empty[i] = true;
+    }
+    if (_capacity > 0) {
+        _out[0] = '\0';
+    }
+}
+
+/**
+ * @brief Append text, cutting it when the buffer is full
+ */
+void EARS_configJsonWriter::put(const char* text, size_t length) {
+    if (_capacity == 0) {
+        _overflow = true;
+        return;
+    }
+    size_t room = _capacity - 1 - _used;
+    if (length > room) {
+        length = room;
+        _overflow = true;
+    }
+    memcpy(_out + _used, text, length);
+    _used += length;
+    _out[_used] = '\0';
+}
+
+void EARS_configJsonWriter::put(const char* text) {
+    put(text, strlen(text));
+}
+
+/**
+ * @brief Append a quoted, escaped string
+ */
+void EARS_configJsonWriter::quoted(const char* text) {
+    put("\"", 1);
+    for (const char* c = text; *c; c++) {
+        char escape[8];
+        switch (*c) {
+            case '"': put("\\\""); break;
+            case '\\': put("\\\\"); break;
+            case '\b': put("\\b"); break;
+            case '\f': put("\\f"); break;
+            case '\n': put("\\n"); break;
+            case '\r': put("\\r"); break;
+            case '\t': put("\\t"); break;
+            default:
+                if ((unsigned char)*c < 0x20) {
+                    snprintf(escape, sizeof(escape), "\\u%04x", (unsigned)*c);
+                    put(escape);
+                } else {
+                    put(c, 1);
+                }
+                break;
+        }
+    }
+    put("\"", 1);
+}
+
+/**
+ * @brief Start a member: separator, line break, indent and key
+ */
+void EARS_configJsonWriter::member(const char* key) {
+    if (_started) {
+        if (!_empty[_depth]) {
+            put(",", 1);
+        }
+        put("\n", 1);
+    }
+    for (uint8_t i = 0; i < _depth; i++) {
+        put("  ", 2);
+    }
+    _empty[_depth] = false;
+    _started = true;
+    if (key) {
+        quoted(key);
+        put(": ", 2);
+    }
+}
+
+/**
+ * @brief Open an object
+ * @param key Member name, nullptr for the root
+ * @return void
+ */
+void EARS_configJsonWriter::beginObject(const char* key) {
+    member(key);
+    put("{", 1);
+    if (_depth < MAX_DEPTH) {
+        _depth++;
+        _empty[_depth] = true;
+    } else {
+        _overflow = true;
+    }
+}
+
+/**
+ * @brief Close the innermost object
+ * @return void
+ */
+void EARS_configJsonWriter::endObject() {
+    if (_depth == 0) {
+        return;
+    }
+    if (!_empty[_depth]) {
+        put("\n", 1);
+        for (uint8_t i = 0; i + 1 < _depth; i++) {
+            put("  ", 2);
+        }
+    }
+    put("}", 1);
+    _depth--;
+}
+
+/**
+ * @brief Write a string member
+ * @param key Member name
+ * @param value String, escaped as needed
+ * @return void
+ */
+void EARS_configJsonWriter::string(const char* key, const char* value) {
+    member(key);
+    quoted(value);
+}
+
+/**
+ * @brief Write a number member
+ * @param key Member name
+ * @param value Number
+ * @return void
+ */
+void EARS_configJsonWriter::number(const char* key, uint32_t value) {
+    char text[12];
+    snprintf(text, sizeof(text), "%lu", (unsigned long)value);
+    member(key);
+    put(text);
+}
+
+/**
+ * @brief Write a boolean member
+ * @param key Member name
+ * @param value true or false
+ * @return void
+ */
+void EARS_configJsonWriter::boolean(const char* key, bool value) {
+    member(key);
+    put(value ? "true" : "false");
+}
+
+/**
+ * @brief Write a member whose value is already JSON text
+ * @param key Member name
+ * @param value JSON text, copied as is
+ * @param length Bytes of value
+ * @return void
+ */
+void EARS_configJsonWriter::raw(const char* key, const char* value, size_t length) {
+    member(key);
+    put(value, length);
+}
+
+/****************************************************************************
+ * End of EARS_configJson.cpp
+ ***************************************************************************/
@@ -0,0 +1,195 @@
+/**
+ * @file EARS_configJson.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Heap-free JSON reader and pretty writer for ears.config
+ * @version 1.1.1
+ * @date 20261016
+ *
+ * @details
+ * The reader walks a document held in memory and reports every scalar
+ * value with the chain of object keys leading to it; nothing is built, so
+ * it needs a few hundred bytes of stack and no heap. Arrays are reported
+ * whole, their elements are not. Every value also carries its source text
+ * as written, so a caller can keep members it does not understand.
+ * Parsing stops at the end of the root object, like ArduinoJson, so the
+ * trailer an atomic write leaves after it is never seen.
+ *
+ * The writer emits the same layout as serializeJsonPretty (two space
+ * indent, "key": value), into a fixed buffer.
+ *
+ * ears.config does not go through ArduinoJson (still used for errors.json):
+ * EARS_config works in one workspace sized at begin() and allocates nothing
+ * after it. It re-encodes only the sections that changed, and keeps unknown
+ * members as their source text inside the snapshot, which is a plain copy
+ * of ConfigModel. A JsonDocument needs heap in proportion to the file, and
+ * a JsonVariant cannot be kept in the snapshot.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_CONFIG_JSON_H__
+#define __EARS_CONFIG_JSON_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Kind of value reported to a ConfigJsonVisitor
+ */
+enum class ConfigJsonType : uint8_t {
+    OBJECT,     // An object starts; its members follow
+    ARRAY,      // An array, reported whole after it ends
+    STRING,     // text is the unescaped string
+    NUMBER,     // text is the number as written
+    BOOL,       // boolean holds the value
+    NUL         // null
+};
+
+/**
+ * @brief A value as the reader reports it
+ */
+struct ConfigJsonValue {
+    ConfigJsonType type;
+    const char* text;       // NUL terminated, "" for OBJECT/ARRAY/BOOL/NUL
+    bool boolean;
+    const char* raw;        // Source text of the whole value, not terminated
+    size_t rawLength;       // Bytes of raw
+};
+
+/**
+ * @brief Called for each value inside the root object
+ * @param keys Object keys from the root down to the value
+ * @param depth Number of keys (1 = member of the root)
+ * @param value The value
+ * @param context Caller context
+ * @return void
+ */
+typedef void (*ConfigJsonVisitor)(const char* const* keys, uint8_t depth,
+                                  const ConfigJsonValue& value, void* context);
+
+/**
+ * @brief Reads a JSON document, reporting values to a visitor
+ */
+class EARS_configJsonReader {
+public:
+    // Deepest key chain reported; deeper members are skipped
+    static const uint8_t MAX_DEPTH = 4;
+    // Deepest nesting accepted at all
+    static const uint8_t MAX_NESTING = 16;
+    // Longest key and string value kept; longer ones are cut
+    static const size_t KEY_BYTES = 32;
+    static const size_t VALUE_BYTES = 128;
+
+    /**
+     * @brief Parse a document whose root is an object
+     * @param text Document text
+     * @param length Bytes of text
+     * @param visitor Called for each value
+     * @param context Passed to visitor unchanged
+     * @return true if the root object was well formed
+     *
+     * Values seen before an error have already been reported.
+     */
+    static bool parse(const char* text, size_t length, ConfigJsonVisitor visitor, void* context);
+};
+
+/**
+ * @brief Writes pretty printed JSON into a fixed buffer
+ *
+ * Members written at the starting depth need no enclosing object, so a
+ * section can be written on its own and joined to others later.
+ */
+class EARS_configJsonWriter {
+public:
+    static const uint8_t MAX_DEPTH = 8;
+
+    /**
+     * @brief Start writing
+     * @param out Destination
+     * @param capacity Size of out, a terminator is always kept
+     * @param depth Indent level of the first member (0 = root value)
+     */
+    EARS_configJsonWriter(char* out, size_t capacity, uint8_t depth);
+
+    /**
+     * @brief Open an object
+     * @param key Member name, nullptr for the root
+     * @return void
+     */
+    void beginObject(const char* key);
+
+    /**
+     * @brief Close the innermost object
+     * @return void
+     */
+    void endObject();
+
+    /**
+     * @brief Write a string member
+     * @param key Member name
+     * @param value String, escaped as needed
+     * @return void
+     */
+    void string(const char* key, const char* value);
+
+    /**
+     * @brief Write a number member
+     * @param key Member name
+     * @param value Number
+     * @return void
+     */
+    void number(const char* key, uint32_t value);
+
+    /**
+     * @brief Write a boolean member
+     * @param key Member name
+     * @param value true or false
+     * @return void
+     */
+    void boolean(const char* key, bool value);
+
+    /**
+     * @brief Write a member whose value is already JSON text
+     * @param key Member name
+     * @param value JSON text, copied as is
+     * @param length Bytes of value
+     * @return void
+     */
+    void raw(const char* key, const char* value, size_t length);
+
+    /**
+     * @brief Bytes written so far
+     * @return size_t length, excluding the terminator
+     */
+    size_t length() const { return _used; }
+
+    /**
+     * @brief Check whether anything was cut for lack of room
+     * @return true if the output is incomplete
+     */
+    bool overflowed() const { return _overflow; }
+
+private:
+    char* _out;
+    size_t _capacity;
+    size_t _used;
+    bool _overflow;
+    uint8_t _depth;
+    bool _empty[MAX_DEPTH + 1];     // No member written yet at this depth
+    bool _started;                  // Anything written at all
+
+    void put(const char* text, size_t length);
+    void put(const char* text);
+    void quoted(const char* text);
+    void member(const char* key);
+};
+
+#endif // __EARS_CONFIG_JSON_H__
+
+/****************************************************************************
+ * End of EARS_configJson.h
+ ***************************************************************************/
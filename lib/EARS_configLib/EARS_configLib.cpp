@@ -0,0 +1,459 @@
+/**
+ * @file EARS_configLib.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Central ears.config service: parsed once, edited in RAM, written back lazily
+ * @version 1.3.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_configLib.h"
+#include <string.h>
+#include <new>
+
+// Bit mask with every section set
+static const uint32_t ALL_SECTIONS = (1u << (uint32_t)ConfigSection::COUNT) - 1;
+
+/**
+ * @brief Read a file from the start into a buffer
+ * @param fs File system
+ * @param path File path
+ * @param buffer Destination
+ * @param capacity Size of buffer
+ * @param oversized Set if the file is longer than capacity
+ * @return size_t bytes read
+ */
+static size_t readWhole(EARS_fsPort& fs, const char* path, uint8_t* buffer, size_t capacity, bool& oversized) {
+    size_t length = 0;
+    size_t got;
+    while (length < capacity && (got = fs.readFileAt(path, (uint32_t)length, buffer + length, capacity - length)) > 0) {
+        length += got;
+    }
+    uint8_t more;
+    oversized = length == capacity && fs.readFileAt(path, (uint32_t)length, &more, 1) > 0;
+    return length;
+}
+
+/**
+ * @brief The service every library shares
+ * @return EARS_config& instance
+ */
+EARS_config& EARS_config::getInstance() {
+    static EARS_config instance;
+    return instance;
+}
+
+/**
+ * @brief Construct an unloaded service holding the defaults
+ */
+EARS_config::EARS_config()
+    : _fs(nullptr),
+      _loaded(false),
+      _dirty(0),
+      _encoded(0),
+      _firstChangeMs(0),
+      _lastChangeMs(0),
+      _sections(nullptr),
+      _file(nullptr),
+      _snapshot(nullptr),
+      _observerCount(0),
+      _published(nullptr),
+      _unpublished(0) {
+    _path[0] = '\0';
+    _snapshotPath[0] = '\0';
+    memset(_sectionLength, 0, sizeof(_sectionLength));
+}
+
+/**
+ * @brief Recover and read the file, then load the snapshot or parse once
+ * @param fs File system holding the file
+ * @param path File path, e.g. "/config/ears.config"
+ * @param workspace At least workspaceBytes(), owned by the caller
+ * @param bytes Size of workspace
+ * @param nowMs Current time in milliseconds
+ * @return true if the service is ready
+ */
+bool EARS_config::begin(EARS_fsPort& fs, const char* path, uint8_t* workspace, size_t bytes, uint32_t nowMs) {
+    if (!path || !workspace || bytes < workspaceBytes() || strlen(path) >= sizeof(_path) ||
+        !EARS_configSnapshotPath(path, _snapshotPath, sizeof(_snapshotPath))) {
+        return false;
+    }
+
+    bool parsed = false;
+    {
+        std::lock_guard<std::mutex> observerLock(_observerMutex);
+        std::lock_guard<std::mutex> writeLock(_writeMutex);
+        std::lock_guard<std::mutex> lock(_mutex);
+        _fs = &fs;
+        strcpy(_path, path);
+        _sections = reinterpret_cast<char*>(workspace);
+        _file = _sections + SECTION_BYTES * (size_t)ConfigSection::COUNT;
+        _snapshot = new (workspace + SNAPSHOT_OFFSET) ConfigSnapshot();
+        _published = new (workspace + PUBLISHED_OFFSET) ConfigModel();
+        _model = ConfigModel();
+        _dirty = 0;
+        _encoded = 0;
+
+        // A save cut short by a reset is finished or undone before reading
+        _stats.recovery = EARS_atomicFile::recover(fs, path);
+
+        uint32_t present = 0;
+        bool oversized = false;
+        size_t length = 0;
+        if (fs.fileExists(path)) {
+            length = readWhole(fs, path, reinterpret_cast<uint8_t*>(_file), FILE_BYTES, oversized);
+        }
+        if (length > 0 && !oversized) {
+            // The snapshot is only good for the exact file it was made from
+            EARS_atomicFile sum;
+            sum.add(reinterpret_cast<const uint8_t*>(_file), length);
+            bool ignored;
+            size_t got = 0;
+            if (fs.fileExists(_snapshotPath)) {
+                got = readWhole(fs, _snapshotPath, reinterpret_cast<uint8_t*>(_snapshot), sizeof(ConfigSnapshot),
+                                ignored);
+            }
+            if (EARS_configSnapshotMatches(*_snapshot, got, sum.length(), sum.check())) {
+                _model = _snapshot->model;
+                present = _snapshot->header.present;
+                _stats.snapshotLoads++;
+                parsed = true;
+            } else {
+                _stats.parses++;
+                parsed = EARS_configDecode(_file, length, _model, present);
+                if (parsed) {
+                    _snapshot->model = _model;
+                    EARS_configSnapshotSeal(*_snapshot, present, sum.length(), sum.check());
+                    if (writeSnapshot()) {
+                        _stats.snapshotWrites++;
+                    }
+                }
+            }
+        }
+
+        // Observers start from the defaults; the first dispatch() reports the rest
+        _unpublished = ALL_SECTIONS;
+        _loaded = true;
+        if (!parsed) {
+            _stats.parseFailures++;
+            _model = ConfigModel();
+            markDirty(ALL_SECTIONS, nowMs);
+        } else if (present != ALL_SECTIONS) {
+            // Written with their defaults once changes settle
+            markDirty(ALL_SECTIONS & ~present, nowMs);
+        }
+        _stats.unknownDropped = _model.extras.dropped;
+    }
+
+    // No usable file: write the defaults now, as the logger always did
+    if (!parsed) {
+        flush();
+    }
+    return true;
+}
+
+SystemSettings EARS_config::system() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _model.system;
+}
+
+LoggerSettings EARS_config::logger() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _model.logger;
+}
+
+DisplaySettings EARS_config::display() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _model.display;
+}
+
+NetworkSettings EARS_config::network() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _model.network;
+}
+
+SecuritySettings EARS_config::security() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _model.security;
+}
+
+ApplicationSettings EARS_config::application() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _model.application;
+}
+
+void EARS_config::setSystem(const SystemSettings& value, uint32_t nowMs) {
+    update(_model.system, value, ConfigSection::SYSTEM, nowMs);
+}
+
+void EARS_config::setLogger(const LoggerSettings& value, uint32_t nowMs) {
+    update(_model.logger, value, ConfigSection::LOGGER, nowMs);
+}
+
+void EARS_config::setDisplay(const DisplaySettings& value, uint32_t nowMs) {
+    update(_model.display, value, ConfigSection::DISPLAY, nowMs);
+}
+
+void EARS_config::setNetwork(const NetworkSettings& value, uint32_t nowMs) {
+    update(_model.network, value, ConfigSection::NETWORK, nowMs);
+}
+
+void EARS_config::setSecurity(const SecuritySettings& value, uint32_t nowMs) {
+    update(_model.security, value, ConfigSection::SECURITY, nowMs);
+}
+
+void EARS_config::setApplication(const ApplicationSettings& value, uint32_t nowMs) {
+    update(_model.application, value, ConfigSection::APPLICATION, nowMs);
+}
+
+/**
+ * @brief Be told when any of keys changes
+ * @param keys EARS_configKeyBit() of each key to follow
+ * @param observer Callback
+ * @param context Passed to observer
+ * @return true if subscribed, false if MAX_OBSERVERS are taken
+ */
+bool EARS_config::subscribe(ConfigKeyMask keys, ConfigObserver observer, void* context) {
+    std::lock_guard<std::mutex> lock(_observerMutex);
+    if (!observer || _observerCount == MAX_OBSERVERS) {
+        return false;
+    }
+    _observers[_observerCount].keys = keys;
+    _observers[_observerCount].observer = observer;
+    _observers[_observerCount].context = context;
+    _observerCount++;
+    return true;
+}
+
+/**
+ * @brief Stop calling an observer
+ * @param observer Callback given to subscribe()
+ * @param context Context given to subscribe()
+ * @return void
+ */
+void EARS_config::unsubscribe(ConfigObserver observer, void* context) {
+    std::lock_guard<std::mutex> lock(_observerMutex);
+    for (size_t i = 0; i < _observerCount; i++) {
+        if (_observers[i].observer == observer && _observers[i].context == context) {
+            _observers[i] = _observers[--_observerCount];
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Tell observers about keys changed since the last dispatch
+ * @return void
+ */
+void EARS_config::dispatch() {
+    // The common case, nothing set since the last tick: no lock taken
+    if (_unpublished.load() == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> observerLock(_observerMutex);
+    ConfigKeyMask changed;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_loaded) {
+            return;
+        }
+        // Values changed and changed back in between are no change at all
+        changed = EARS_configChangedKeys(*_published, _model, _unpublished.exchange(0));
+        if (changed == 0) {
+            return;
+        }
+        *_published = _model;
+        _stats.dispatches++;
+    }
+
+    uint32_t notified = 0;
+    for (size_t i = 0; i < _observerCount; i++) {
+        ConfigKeyMask keys = changed & _observers[i].keys;
+        if (keys) {
+            _observers[i].observer(keys, *_published, _observers[i].context);
+            notified++;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.notifications += notified;
+}
+
+/**
+ * @brief Check for changes not yet written
+ * @return true if any section is dirty
+ */
+bool EARS_config::isDirty() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _dirty != 0;
+}
+
+/**
+ * @brief Check one section for changes not yet written
+ * @param section Section
+ * @return true if dirty
+ */
+bool EARS_config::isDirty(ConfigSection section) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return section < ConfigSection::COUNT && (_dirty & (1u << (uint32_t)section)) != 0;
+}
+
+/**
+ * @brief Mark sections dirty (caller holds _mutex)
+ * @param sections Bit per ConfigSection
+ * @param nowMs Current time in milliseconds
+ * @return void
+ */
+void EARS_config::markDirty(uint32_t sections, uint32_t nowMs) {
+    if (_dirty == 0) {
+        _firstChangeMs = nowMs;
+    }
+    _dirty |= sections;
+    _lastChangeMs = nowMs;
+}
+
+/**
+ * @brief Notify observers, then write back if changes are due
+ * @param nowMs Current time in milliseconds
+ * @return true if nothing is left to write
+ */
+bool EARS_config::poll(uint32_t nowMs) {
+    dispatch();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_loaded || _dirty == 0) {
+            return true;
+        }
+        if (nowMs - _lastChangeMs < DEBOUNCE_MS && nowMs - _firstChangeMs < MAX_DELAY_MS) {
+            return false;
+        }
+    }
+    return writeBack(true, nowMs);
+}
+
+/**
+ * @brief Write back any changes now
+ * @return true if the file holds every change
+ */
+bool EARS_config::flush() {
+    return writeBack(false, 0);
+}
+
+/**
+ * @brief Get the service counters
+ * @return ConfigStats counts
+ */
+ConfigStats EARS_config::getStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+/**
+ * @brief Replace the snapshot file with _snapshot (caller holds _writeMutex)
+ * @return true if written
+ *
+ * Not atomic: a torn snapshot fails its check and the next boot parses.
+ */
+bool EARS_config::writeSnapshot() {
+    if (_fs->fileExists(_snapshotPath) && !_fs->removeFile(_snapshotPath)) {
+        return false;
+    }
+    return _fs->appendFile(_snapshotPath, reinterpret_cast<const uint8_t*>(_snapshot), sizeof(ConfigSnapshot));
+}
+
+/**
+ * @brief Encode dirty sections, assemble and write the file
+ * @param delayRetry On failure, wait DEBOUNCE_MS from nowMs before the next try
+ * @param nowMs Current time in milliseconds
+ * @return true if written (or nothing was dirty)
+ */
+bool EARS_config::writeBack(bool delayRetry, uint32_t nowMs) {
+    std::lock_guard<std::mutex> writeLock(_writeMutex);
+    uint32_t writing;
+    bool encoded = true;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_loaded || _dirty == 0) {
+            return _loaded;
+        }
+        writing = _dirty;
+        _dirty = 0;
+
+        // Clean sections keep the text they were last written with
+        for (size_t i = 0; i < (size_t)ConfigSection::COUNT && encoded; i++) {
+            uint32_t bit = 1u << i;
+            if ((writing & bit) || !(_encoded & bit)) {
+                _sectionLength[i] = EARS_configEncodeSection((ConfigSection)i, _model,
+                                                             _sections + i * SECTION_BYTES, SECTION_BYTES);
+                _stats.serializes++;
+                encoded = _sectionLength[i] > 0;
+                _encoded = encoded ? _encoded | bit : _encoded & ~bit;
+            }
+        }
+        // The values this write holds, for the snapshot
+        _snapshot->model = _model;
+    }
+
+    bool written = false;
+    size_t length = 0;
+    if (encoded) {
+        _file[length++] = '{';
+        _file[length++] = '\n';
+        for (size_t i = 0; i < (size_t)ConfigSection::COUNT; i++) {
+            if (i > 0) {
+                _file[length++] = ',';
+                _file[length++] = '\n';
+            }
+            memcpy(_file + length, _sections + i * SECTION_BYTES, _sectionLength[i]);
+            length += _sectionLength[i];
+        }
+        // Root members that are not sections go back after them
+        size_t unknown = EARS_configEncodeUnknownSections(_snapshot->model, _file + length + 2,
+                                                          CONTENT_BYTES - length - 4);
+        if (unknown > 0) {
+            _file[length++] = ',';
+            _file[length++] = '\n';
+            length += unknown;
+        }
+        _file[length++] = '\n';
+        _file[length++] = '}';
+        written = EARS_atomicFile::write(*_fs, _path, reinterpret_cast<const uint8_t*>(_file), length);
+    }
+
+    bool snapshot = false;
+    if (written) {
+        // Key the snapshot to the file as stored: contents and trailer
+        EARS_atomicFile seal;
+        seal.add(reinterpret_cast<const uint8_t*>(_file), length);
+        char trailer[EARS_atomicFile::TRAILER_BYTES + 1];
+        EARS_atomicFile stored = seal;
+        stored.add(reinterpret_cast<const uint8_t*>(trailer), seal.trailer(trailer));
+        EARS_configSnapshotSeal(*_snapshot, ALL_SECTIONS, stored.length(), stored.check());
+        snapshot = writeSnapshot();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!written) {
+        _stats.writeFailures++;
+        _dirty |= writing;
+        if (delayRetry) {
+            _firstChangeMs = nowMs;
+            _lastChangeMs = nowMs;
+        }
+        return false;
+    }
+    _stats.writes++;
+    if (snapshot) {
+        _stats.snapshotWrites++;
+    }
+    return true;
+}
+
+/****************************************************************************
+ * End of EARS_configLib.cpp
+ ***************************************************************************/
@@ -0,0 +1,307 @@
+/**
+ * @file EARS_configLib.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Central ears.config service: parsed once, edited in RAM, written back lazily
+ * @version 1.3.1
+ * @date 20261016
+ *
+ * @details
+ * ears.config is read and parsed once at boot into a ConfigModel. Libraries
+ * read and change their section through typed getters and setters; a
+ * change only marks its section dirty. poll() writes the file back once
+ * changes have stopped for DEBOUNCE_MS (or MAX_DELAY_MS after the first
+ * one, so a steady stream of changes still reaches the card), re-encoding
+ * only the dirty sections and reusing the cached text of the others. The
+ * file is replaced atomically (EARS_atomicFile).
+ *
+ * Each write also leaves a binary snapshot of the model next to the file
+ * (EARS_configSnapshot). A boot that finds ears.config unchanged since
+ * then loads the snapshot and skips the JSON parse.
+ *
+ * Libraries that follow a setting subscribe() to its ConfigKey and keep
+ * their own copy of the value. dispatch() (run by poll()) compares the
+ * model with what observers last saw and calls each observer once with
+ * the keys of its that changed, however many setter calls happened in
+ * between. An idle dispatch() is one atomic load.
+ *
+ * Changes not yet written are lost on a power cut; call flush() before a
+ * planned restart. The application calls poll() once per UI tick.
+ *
+ * Thread safe: getters and setters may be called from any task while
+ * another writes the file back.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_CONFIG_LIB_H__
+#define __EARS_CONFIG_LIB_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include "EARS_fsPortLib.h"
+#include "EARS_atomicFile.h"
+#include "EARS_configModel.h"
+#include "EARS_configSnapshot.h"
+
+/**
+ * @brief Config service counters
+ */
+struct ConfigStats {
+    uint32_t parses;            // Whole document parses
+    uint32_t snapshotLoads;     // Boots that used the snapshot instead of parsing
+    uint32_t snapshotWrites;    // Snapshots written
+    uint32_t parseFailures;     // Missing, oversized or malformed file at begin()
+    uint32_t serializes;        // Section encodes
+    uint32_t writes;            // File write-backs
+    uint32_t writeFailures;     // Write-backs that failed (retried after DEBOUNCE_MS)
+    uint32_t changes;           // Setter calls that changed a value
+    uint32_t dispatches;        // dispatch() calls that found changed keys
+    uint32_t notifications;     // Observer calls
+    uint32_t unknownDropped;    // Unknown members not kept at begin() (over EARS_CONFIG_EXTRA_BYTES)
+    AtomicRecovery recovery;    // What begin() found of an interrupted write
+
+    ConfigStats()
+        : parses(0), snapshotLoads(0), snapshotWrites(0), parseFailures(0), serializes(0), writes(0), writeFailures(0), changes(0), dispatches(0),
+          notifications(0), unknownDropped(0),
+          recovery(AtomicRecovery::NONE) {}
+};
+
+/**
+ * @brief Change callback
+ * @param changed Subscribed keys whose value changed since the last call
+ * @param model Every setting as of this dispatch, valid during the call
+ * @param context Pointer given to subscribe()
+ * @return void
+ *
+ * Runs on the task calling dispatch(). May use getters and setters, but
+ * must not subscribe, unsubscribe or dispatch.
+ */
+typedef void (*ConfigObserver)(ConfigKeyMask changed, const ConfigModel& model, void* context);
+
+/**
+ * @brief Owns the in-RAM ears.config and writes it back
+ */
+class EARS_config {
+public:
+    // Quiet time after the last change before writing back
+    static const uint32_t DEBOUNCE_MS = 2000;
+    // Longest a change waits while further changes keep coming
+    static const uint32_t MAX_DELAY_MS = 10000;
+    // Encoded size limit per section, with room for its unknown members
+    static const size_t SECTION_BYTES = 1536 + EARS_CONFIG_EXTRA_BYTES;
+    // Contents limit: every section, unknown root members, braces and separators
+    static const size_t CONTENT_BYTES = SECTION_BYTES * (size_t)ConfigSection::COUNT + EARS_CONFIG_EXTRA_BYTES + 16;
+    // Whole file limit: the contents and the seal EARS_atomicFile appends
+    static const size_t FILE_BYTES = CONTENT_BYTES + EARS_atomicFile::TRAILER_BYTES;
+    // Workspace offset of the snapshot image, 8 byte aligned
+    static const size_t SNAPSHOT_OFFSET = (SECTION_BYTES * (size_t)ConfigSection::COUNT + FILE_BYTES + 7) & ~(size_t)7;
+    // Workspace offset of the values observers last saw, 8 byte aligned
+    static const size_t PUBLISHED_OFFSET = (SNAPSHOT_OFFSET + sizeof(ConfigSnapshot) + 7) & ~(size_t)7;
+    // Observers that can subscribe at once
+    static const size_t MAX_OBSERVERS = 8;
+
+    /**
+     * @brief Workspace begin() needs (section texts, file and snapshot images, published values)
+     * @return size_t bytes
+     */
+    static size_t workspaceBytes() { return PUBLISHED_OFFSET + sizeof(ConfigModel); }
+
+    /**
+     * @brief The service every library shares
+     * @return EARS_config& instance
+     */
+    static EARS_config& getInstance();
+
+    EARS_config();
+
+    /**
+     * @brief Recover, read and parse the file once
+     * @param fs File system holding the file
+     * @param path File path, e.g. "/config/ears.config"
+     * @param workspace At least workspaceBytes(), owned by the caller
+     * @param bytes Size of workspace
+     * @param nowMs Current time in milliseconds
+     * @return true if the service is ready (a missing or unreadable file is
+     *         replaced with the defaults at once)
+     *
+     * Sections the file lacks take their defaults and are written after
+     * DEBOUNCE_MS.
+     */
+    bool begin(EARS_fsPort& fs, const char* path, uint8_t* workspace, size_t bytes, uint32_t nowMs);
+
+    /**
+     * @brief Check begin() succeeded
+     * @return true if settings come from the file
+     */
+    bool isLoaded() const { return _loaded; }
+
+    SystemSettings system();
+    LoggerSettings logger();
+    DisplaySettings display();
+    NetworkSettings network();
+    SecuritySettings security();
+    ApplicationSettings application();
+
+    /**
+     * @brief Replace a section; marks it dirty if anything differs
+     * @param value New section values
+     * @param nowMs Current time in milliseconds
+     * @return void
+     */
+    void setSystem(const SystemSettings& value, uint32_t nowMs);
+    void setLogger(const LoggerSettings& value, uint32_t nowMs);
+    void setDisplay(const DisplaySettings& value, uint32_t nowMs);
+    void setNetwork(const NetworkSettings& value, uint32_t nowMs);
+    void setSecurity(const SecuritySettings& value, uint32_t nowMs);
+    void setApplication(const ApplicationSettings& value, uint32_t nowMs);
+
+    /**
+     * @brief Be told when any of keys changes
+     * @param keys EARS_configKeyBit() of each key to follow
+     * @param observer Callback
+     * @param context Passed to observer
+     * @return true if subscribed, false if MAX_OBSERVERS are taken
+     *
+     * Subscribe first, then read the current values. Values begin() loads
+     * are reported as changes from the defaults by the first dispatch().
+     */
+    bool subscribe(ConfigKeyMask keys, ConfigObserver observer, void* context);
+
+    /**
+     * @brief Stop calling an observer
+     * @param observer Callback given to subscribe()
+     * @param context Context given to subscribe()
+     * @return void
+     */
+    void unsubscribe(ConfigObserver observer, void* context);
+
+    /**
+     * @brief Tell observers about keys changed since the last dispatch
+     * @return void
+     *
+     * Called by poll(); one call per UI tick batches every change made
+     * since the previous one.
+     */
+    void dispatch();
+
+    /**
+     * @brief Check for changes not yet written
+     * @return true if any section is dirty
+     */
+    bool isDirty();
+
+    /**
+     * @brief Check one section for changes not yet written
+     * @param section Section
+     * @return true if dirty
+     */
+    bool isDirty(ConfigSection section);
+
+    /**
+     * @brief Notify observers, then write back if changes are due; call once per UI tick
+     * @param nowMs Current time in milliseconds
+     * @return true if nothing is left to write
+     */
+    bool poll(uint32_t nowMs);
+
+    /**
+     * @brief Write back any changes now
+     * @return true if the file holds every change
+     */
+    bool flush();
+
+    /**
+     * @brief Get the service counters
+     * @return ConfigStats counts
+     */
+    ConfigStats getStats();
+
+private:
+    std::mutex _mutex;          // Model, dirty state, counters
+    std::mutex _writeMutex;     // One write-back at a time; section texts and file image
+    EARS_fsPort* _fs;
+    char _path[EARS_FS_PORT_MAX_PATH];
+    char _snapshotPath[EARS_FS_PORT_MAX_PATH];
+    bool _loaded;
+
+    ConfigModel _model;
+    uint32_t _dirty;            // Bit per ConfigSection changed since the last write
+    uint32_t _encoded;          // Bit per ConfigSection with current text in _sections
+    uint32_t _firstChangeMs;
+    uint32_t _lastChangeMs;
+    ConfigStats _stats;
+
+    char* _sections;            // SECTION_BYTES per section
+    size_t _sectionLength[(size_t)ConfigSection::COUNT];
+    char* _file;                // FILE_BYTES, read buffer at begin(), then the assembled file
+    ConfigSnapshot* _snapshot;  // Snapshot image, guarded by _writeMutex
+
+    /**
+     * @brief One subscribe() call
+     */
+    struct Subscription {
+        ConfigKeyMask keys;
+        ConfigObserver observer;
+        void* context;
+    };
+
+    std::mutex _observerMutex;  // One dispatch at a time; subscriptions and _published
+    Subscription _observers[MAX_OBSERVERS];
+    size_t _observerCount;
+    ConfigModel* _published;    // Values observers last saw
+    std::atomic<uint32_t> _unpublished;    // Bit per ConfigSection changed since the last dispatch
+
+    /**
+     * @brief Store a section value and mark it dirty if it changed
+     * @param stored Field in _model
+     * @param value New value
+     * @param section Its section
+     * @param nowMs Current time in milliseconds
+     * @return void
+     */
+    template <typename T>
+    void update(T& stored, const T& value, ConfigSection section, uint32_t nowMs) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (stored == value) {
+            return;
+        }
+        stored = value;
+        markDirty(1u << (uint32_t)section, nowMs);
+        _unpublished.fetch_or(1u << (uint32_t)section);
+        _stats.changes++;
+    }
+
+    /**
+     * @brief Mark sections dirty (caller holds _mutex)
+     * @param sections Bit per ConfigSection
+     * @param nowMs Current time in milliseconds
+     * @return void
+     */
+    void markDirty(uint32_t sections, uint32_t nowMs);
+
+    /**
+     * @brief Replace the snapshot file with _snapshot (caller holds _writeMutex)
+     * @return true if written
+     */
+    bool writeSnapshot();
+
+    /**
+     * @brief Encode dirty sections, assemble and write the file
+     * @param delayRetry On failure, wait DEBOUNCE_MS from nowMs before the next try
+     * @param nowMs Current time in milliseconds
+     * @return true if written (or nothing was dirty)
+     */
+    bool writeBack(bool delayRetry, uint32_t nowMs);
+};
+
+#endif // __EARS_CONFIG_LIB_H__
+
+/****************************************************************************
+ * End of EARS_configLib.h
+ ***************************************************************************/
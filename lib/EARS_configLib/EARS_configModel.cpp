@@ -0,0 +1,713 @@
+/**
+ * @file EARS_configModel.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Typed in-memory model of every ears.config section
+ * @version 1.2.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_configModel.h"
+#include "EARS_configJson.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const SECTION_NAMES[] = {
+    "system", "logger", "display", "network", "security", "application"
+};
+
+/**
+ * @brief Copy a string into a fixed field, cutting it to fit
+ */
+static void copyText(char* field, size_t size, const char* text) {
+    size_t length = strnlen(text, size - 1);
+    memcpy(field, text, length);
+    field[length] = '\0';
+}
+
+#define COPY_TEXT(field, text) copyText(field, sizeof(field), text)
+
+/**
+ * @brief Take a string value
+ */
+static void readText(const ConfigJsonValue& value, char* field, size_t size) {
+    if (value.type == ConfigJsonType::STRING) {
+        copyText(field, size, value.text);
+    }
+}
+
+#define READ_TEXT(value, field) readText(value, field, sizeof(field))
+
+/**
+ * @brief Take a boolean value
+ */
+static void readBool(const ConfigJsonValue& value, bool& field) {
+    if (value.type == ConfigJsonType::BOOL) {
+        field = value.boolean;
+    }
+}
+
+/**
+ * @brief Take a non-negative number, clamped to max
+ * @return true if value was a number
+ */
+static bool readNumber(const ConfigJsonValue& value, uint32_t max, uint32_t& out) {
+    if (value.type != ConfigJsonType::NUMBER) {
+        return false;
+    }
+    if (value.text[0] == '-') {
+        out = 0;
+        return true;
+    }
+    unsigned long parsed = strtoul(value.text, nullptr, 10);
+    out = parsed > max ? max : (uint32_t)parsed;
+    return true;
+}
+
+/**
+ * @brief Default "system" section
+ */
+SystemSettings::SystemSettings() {
+    COPY_TEXT(version, "1.0.0");
+    COPY_TEXT(zapNumber, "");
+    COPY_TEXT(deviceName, "EARS");
+    COPY_TEXT(created, "");
+    COPY_TEXT(lastModified, "");
+}
+
+bool SystemSettings::operator==(const SystemSettings& other) const {
+    return strcmp(version, other.version) == 0 && strcmp(zapNumber, other.zapNumber) == 0 &&
+           strcmp(deviceName, other.deviceName) == 0 && strcmp(created, other.created) == 0 &&
+           strcmp(lastModified, other.lastModified) == 0;
+}
+
+/**
+ * @brief Default "logger" section
+ */
+LoggerSettings::LoggerSettings()
+    : maxFileSizeBytes(1048576),
+      maxRotatedFiles(3),
+      async(false),
+      asyncBufferBytes(65536),
+      compressRotated(false),
+      preallocate(false),
+      memoryEntries(64),
+      tagCount(0) {
+    COPY_TEXT(logLevel, "DEBUG");
+    COPY_TEXT(overflowPolicy, "DROP_OLDEST");
+    COPY_TEXT(logFormat, "TEXT");
+    COPY_TEXT(timestampPrecision, "SECONDS");
+    COPY_TEXT(sdLevel, "DEBUG");
+    COPY_TEXT(serialLevel, "NONE");
+    COPY_TEXT(memoryLevel, "DEBUG");
+    for (uint8_t i = 0; i < EARS_CONFIG_MAX_TAGS; i++) {
+        tags[i].name[0] = '\0';
+        tags[i].level[0] = '\0';
+    }
+}
+
+bool LoggerSettings::operator==(const LoggerSettings& other) const {
+    if (strcmp(logLevel, other.logLevel) != 0 || maxFileSizeBytes != other.maxFileSizeBytes ||
+        maxRotatedFiles != other.maxRotatedFiles || async != other.async ||
+        asyncBufferBytes != other.asyncBufferBytes || strcmp(overflowPolicy, other.overflowPolicy) != 0 ||
+        strcmp(logFormat, other.logFormat) != 0 || compressRotated != other.compressRotated ||
+        preallocate != other.preallocate || strcmp(timestampPrecision, other.timestampPrecision) != 0 ||
+        strcmp(sdLevel, other.sdLevel) != 0 || strcmp(serialLevel, other.serialLevel) != 0 ||
+        strcmp(memoryLevel, other.memoryLevel) != 0 || memoryEntries != other.memoryEntries ||
+        tagCount != other.tagCount) {
+        return false;
+    }
+    for (uint8_t i = 0; i < tagCount; i++) {
+        if (strcmp(tags[i].name, other.tags[i].name) != 0 || strcmp(tags[i].level, other.tags[i].level) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Set a module's level, adding the module if it is new
+ * @param name Module name, e.g. "SDCARD"
+ * @param level Level name
+ * @return true if stored, false if all EARS_CONFIG_MAX_TAGS are taken
+ */
+bool LoggerSettings::setTagLevel(const char* name, const char* level) {
+    for (uint8_t i = 0; i < tagCount; i++) {
+        if (strcmp(tags[i].name, name) == 0) {
+            COPY_TEXT(tags[i].level, level);
+            return true;
+        }
+    }
+    if (tagCount >= EARS_CONFIG_MAX_TAGS) {
+        return false;
+    }
+    COPY_TEXT(tags[tagCount].name, name);
+    COPY_TEXT(tags[tagCount].level, level);
+    tagCount++;
+    return true;
+}
+
+/**
+ * @brief Default "display" section
+ */
+DisplaySettings::DisplaySettings() : brightness(80), timeoutSeconds(30) {
+    COPY_TEXT(theme, "default");
+}
+
+bool DisplaySettings::operator==(const DisplaySettings& other) const {
+    return brightness == other.brightness && timeoutSeconds == other.timeoutSeconds &&
+           strcmp(theme, other.theme) == 0;
+}
+
+/**
+ * @brief Default "network" section
+ */
+NetworkSettings::NetworkSettings() : wifiEnabled(false), autoConnect(false) {
+    COPY_TEXT(ssid, "");
+}
+
+bool NetworkSettings::operator==(const NetworkSettings& other) const {
+    return wifiEnabled == other.wifiEnabled && strcmp(ssid, other.ssid) == 0 &&
+           autoConnect == other.autoConnect;
+}
+
+/**
+ * @brief Default "security" section
+ */
+SecuritySettings::SecuritySettings() : requirePassword(true), autoLockMinutes(5) {
+}
+
+bool SecuritySettings::operator==(const SecuritySettings& other) const {
+    return requirePassword == other.requirePassword && autoLockMinutes == other.autoLockMinutes;
+}
+
+/**
+ * @brief Default "application" section
+ */
+ApplicationSettings::ApplicationSettings() {
+    COPY_TEXT(units, "metric");
+    COPY_TEXT(language, "en");
+    COPY_TEXT(dateFormat, "YYYY-MM-DD");
+    COPY_TEXT(timeFormat, "24h");
+}
+
+bool ApplicationSettings::operator==(const ApplicationSettings& other) const {
+    return strcmp(units, other.units) == 0 && strcmp(language, other.language) == 0 &&
+           strcmp(dateFormat, other.dateFormat) == 0 && strcmp(timeFormat, other.timeFormat) == 0;
+}
+
+/**
+ * @brief Nothing kept
+ */
+ConfigExtras::ConfigExtras() : used(0), dropped(0) {
+    text[0] = '\0';
+}
+
+/**
+ * @brief Keep a member
+ * @param section Section holding it
+ * @param parent Key of the object holding it, "" for the section
+ * @param key Member name
+ * @param value JSON text of the value
+ * @param length Bytes of value
+ * @return true if kept, false (and dropped counted) if out of room
+ *
+ * Stored as one byte of section + 1, then parent, key and value, each
+ * NUL terminated.
+ */
+bool ConfigExtras::add(ConfigSection section, const char* parent, const char* key, const char* value,
+                       size_t length) {
+    size_t parentBytes = strlen(parent) + 1;
+    size_t keyBytes = strlen(key) + 1;
+    size_t bytes = 1 + parentBytes + keyBytes + length + 1;
+    if (bytes > sizeof(text) - used) {
+        dropped++;
+        return false;
+    }
+    char* at = text + used;
+    *at++ = (char)((uint8_t)section + 1);
+    memcpy(at, parent, parentBytes);
+    at += parentBytes;
+    memcpy(at, key, keyBytes);
+    at += keyBytes;
+    memcpy(at, value, length);
+    at[length] = '\0';
+    used = (uint16_t)(used + bytes);
+    return true;
+}
+
+/**
+ * @brief Forget every member of a section
+ * @param section Section
+ * @return void
+ */
+void ConfigExtras::clear(ConfigSection section) {
+    size_t at = 0;
+    size_t kept = 0;
+    ConfigSection found;
+    const char* parent;
+    const char* key;
+    const char* value;
+    while (at < used) {
+        size_t start = at;
+        next(at, found, parent, key, value);
+        if (found != section) {
+            memmove(text + kept, text + start, at - start);
+            kept += at - start;
+        }
+    }
+    used = (uint16_t)kept;
+}
+
+/**
+ * @brief Check whether an object holds any kept member
+ * @param section Section
+ * @param parent Key of the object, "" for the section
+ * @return true if at least one member is kept there
+ */
+bool ConfigExtras::has(ConfigSection section, const char* parent) const {
+    size_t at = 0;
+    ConfigSection found;
+    const char* foundParent;
+    const char* key;
+    const char* value;
+    while (next(at, found, foundParent, key, value)) {
+        if (found == section && strcmp(foundParent, parent) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Step through kept members
+ * @param at Offset to resume from, 0 to start; advanced past the member
+ * @param section Receives its section
+ * @param parent Receives the key of the object holding it
+ * @param key Receives its name
+ * @param value Receives its JSON text, NUL terminated
+ * @return false when there are no more
+ */
+bool ConfigExtras::next(size_t& at, ConfigSection& section, const char*& parent, const char*& key,
+                        const char*& value) const {
+    if (at >= used) {
+        return false;
+    }
+    section = (ConfigSection)((uint8_t)text[at] - 1);
+    parent = text + at + 1;
+    key = parent + strlen(parent) + 1;
+    value = key + strlen(key) + 1;
+    at = (size_t)(value - text) + strlen(value) + 1;
+    return true;
+}
+
+/**
+ * @brief Section name as used in ears.config
+ * @param section Section
+ * @return const char* name, "" for COUNT
+ */
+const char* EARS_configSectionName(ConfigSection section) {
+    return section < ConfigSection::COUNT ? SECTION_NAMES[(size_t)section] : "";
+}
+
+/**
+ * @brief Section for a name, COUNT if unknown
+ */
+static ConfigSection sectionNamed(const char* name) {
+    for (size_t i = 0; i < (size_t)ConfigSection::COUNT; i++) {
+        if (strcmp(SECTION_NAMES[i], name) == 0) {
+            return (ConfigSection)i;
+        }
+    }
+    return ConfigSection::COUNT;
+}
+
+/**
+ * @brief Decode state handed through the JSON reader
+ */
+struct ConfigDecode {
+    ConfigModel* model;
+    uint32_t present;
+};
+
+/**
+ * @brief Store a "system" member
+ * @return false if the key is not one of the section's
+ */
+static bool decodeSystem(SystemSettings& system, const char* key, const ConfigJsonValue& value) {
+    if (strcmp(key, "version") == 0) READ_TEXT(value, system.version);
+    else if (strcmp(key, "zap_number") == 0) READ_TEXT(value, system.zapNumber);
+    else if (strcmp(key, "device_name") == 0) READ_TEXT(value, system.deviceName);
+    else if (strcmp(key, "created") == 0) READ_TEXT(value, system.created);
+    else if (strcmp(key, "last_modified") == 0) READ_TEXT(value, system.lastModified);
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Store a "sinks" member of the logger section
+ * @return false if the key is not one of the object's
+ */
+static bool decodeSinks(LoggerSettings& logger, const char* key, const ConfigJsonValue& value) {
+    uint32_t number;
+    if (strcmp(key, "sd") == 0) READ_TEXT(value, logger.sdLevel);
+    else if (strcmp(key, "serial") == 0) READ_TEXT(value, logger.serialLevel);
+    else if (strcmp(key, "memory") == 0) READ_TEXT(value, logger.memoryLevel);
+    else if (strcmp(key, "memory_entries") == 0) {
+        if (readNumber(value, 0xFFFF, number)) {
+            logger.memoryEntries = (uint16_t)number;
+        }
+    } else return false;
+    return true;
+}
+
+/**
+ * @brief Store a "logger" member
+ * @return false if the key is not one of the section's
+ */
+static bool decodeLogger(LoggerSettings& logger, const char* key, const ConfigJsonValue& value) {
+    uint32_t number;
+    if (strcmp(key, "log_level") == 0) READ_TEXT(value, logger.logLevel);
+    else if (strcmp(key, "max_file_size_bytes") == 0) {
+        if (readNumber(value, 0xFFFFFFFF, number)) {
+            logger.maxFileSizeBytes = number;
+        }
+    } else if (strcmp(key, "max_rotated_files") == 0) {
+        if (readNumber(value, 0xFF, number)) {
+            logger.maxRotatedFiles = (uint8_t)number;
+        }
+    } else if (strcmp(key, "async") == 0) readBool(value, logger.async);
+    else if (strcmp(key, "async_buffer_bytes") == 0) {
+        if (readNumber(value, 0xFFFFFFFF, number)) {
+            logger.asyncBufferBytes = number;
+        }
+    } else if (strcmp(key, "overflow_policy") == 0) READ_TEXT(value, logger.overflowPolicy);
+    else if (strcmp(key, "log_format") == 0) READ_TEXT(value, logger.logFormat);
+    else if (strcmp(key, "compress_rotated") == 0) readBool(value, logger.compressRotated);
+    else if (strcmp(key, "preallocate") == 0) readBool(value, logger.preallocate);
+    else if (strcmp(key, "timestamp_precision") == 0) READ_TEXT(value, logger.timestampPrecision);
+    else if (strcmp(key, "sinks") != 0 && strcmp(key, "tag_levels") != 0) return false;
+    return true;
+}
+
+/**
+ * @brief Store a "display" member
+ * @return false if the key is not one of the section's
+ */
+static bool decodeDisplay(DisplaySettings& display, const char* key, const ConfigJsonValue& value) {
+    uint32_t number;
+    if (strcmp(key, "brightness") == 0) {
+        if (readNumber(value, 100, number)) {
+            display.brightness = (uint8_t)number;
+        }
+    } else if (strcmp(key, "timeout_seconds") == 0) {
+        if (readNumber(value, 0xFFFF, number)) {
+            display.timeoutSeconds = (uint16_t)number;
+        }
+    } else if (strcmp(key, "theme") == 0) READ_TEXT(value, display.theme);
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Store a "network" member
+ * @return false if the key is not one of the section's
+ */
+static bool decodeNetwork(NetworkSettings& network, const char* key, const ConfigJsonValue& value) {
+    if (strcmp(key, "wifi_enabled") == 0) readBool(value, network.wifiEnabled);
+    else if (strcmp(key, "ssid") == 0) READ_TEXT(value, network.ssid);
+    else if (strcmp(key, "auto_connect") == 0) readBool(value, network.autoConnect);
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Store a "security" member
+ * @return false if the key is not one of the section's
+ */
+static bool decodeSecurity(SecuritySettings& security, const char* key, const ConfigJsonValue& value) {
+    uint32_t number;
+    if (strcmp(key, "require_password") == 0) readBool(value, security.requirePassword);
+    else if (strcmp(key, "auto_lock_minutes") == 0) {
+        if (readNumber(value, 0xFFFF, number)) {
+            security.autoLockMinutes = (uint16_t)number;
+        }
+    } else return false;
+    return true;
+}
+
+/**
+ * @brief Store an "application" member
+ * @return false if the key is not one of the section's
+ */
+static bool decodeApplication(ApplicationSettings& application, const char* key, const ConfigJsonValue& value) {
+    if (strcmp(key, "units") == 0) READ_TEXT(value, application.units);
+    else if (strcmp(key, "language") == 0) READ_TEXT(value, application.language);
+    else if (strcmp(key, "date_format") == 0) READ_TEXT(value, application.dateFormat);
+    else if (strcmp(key, "time_format") == 0) READ_TEXT(value, application.timeFormat);
+    else return false;
+    return true;
+}
+
+/**
+ * @brief ConfigJsonVisitor routing each value to its section
+ *
+ * Members no decoder knows are kept as written, with the objects below
+ * them, so writing the section back loses nothing.
+ */
+static void decodeValue(const char* const* keys, uint8_t depth, const ConfigJsonValue& value, void* context) {
+    ConfigDecode* decode = static_cast<ConfigDecode*>(context);
+    ConfigModel& model = *decode->model;
+    ConfigSection section = sectionNamed(keys[0]);
+    if (depth == 1) {
+        if (section == ConfigSection::COUNT) {
+            model.extras.add(section, "", keys[0], value.raw, value.rawLength);
+        } else if (value.type == ConfigJsonType::OBJECT) {
+            decode->present |= 1u << (uint32_t)section;
+            model.extras.clear(section);
+        }
+        return;
+    }
+    if (section == ConfigSection::COUNT) {
+        return;
+    }
+
+    bool known = true;
+    const char* parent = "";
+    if (depth == 2) {
+        switch (section) {
+            case ConfigSection::SYSTEM: known = decodeSystem(model.system, keys[1], value); break;
+            case ConfigSection::LOGGER: known = decodeLogger(model.logger, keys[1], value); break;
+            case ConfigSection::DISPLAY: known = decodeDisplay(model.display, keys[1], value); break;
+            case ConfigSection::NETWORK: known = decodeNetwork(model.network, keys[1], value); break;
+            case ConfigSection::SECURITY: known = decodeSecurity(model.security, keys[1], value); break;
+            case ConfigSection::APPLICATION: known = decodeApplication(model.application, keys[1], value); break;
+            default: break;
+        }
+    } else if (depth == 3 && section == ConfigSection::LOGGER) {
+        // Members of anything else below a section were kept with it
+        parent = keys[1];
+        if (strcmp(parent, "sinks") == 0) {
+            known = decodeSinks(model.logger, keys[2], value);
+        } else if (strcmp(parent, "tag_levels") == 0) {
+            known = value.type == ConfigJsonType::STRING && model.logger.setTagLevel(keys[2], value.text);
+        }
+    }
+    if (!known) {
+        model.extras.add(section, parent, keys[depth - 1], value.raw, value.rawLength);
+    }
+}
+
+// Set key's bit when a field differs
+#define DIFF_VALUE(key, field) \
+    if (before.field != after.field) changed |= EARS_configKeyBit(ConfigKey::key)
+#define DIFF_TEXT(key, field) \
+    if (strcmp(before.field, after.field) != 0) changed |= EARS_configKeyBit(ConfigKey::key)
+
+/**
+ * @brief Find the settings that differ between two models
+ * @param before Old values
+ * @param after New values
+ * @param sections Bit per ConfigSection to compare, others are skipped
+ * @return ConfigKeyMask bit per differing key
+ */
+ConfigKeyMask EARS_configChangedKeys(const ConfigModel& before, const ConfigModel& after, uint32_t sections) {
+    ConfigKeyMask changed = 0;
+    if (sections & (1u << (uint32_t)ConfigSection::SYSTEM)) {
+        DIFF_TEXT(SYSTEM_VERSION, system.version);
+        DIFF_TEXT(SYSTEM_ZAP_NUMBER, system.zapNumber);
+        DIFF_TEXT(SYSTEM_DEVICE_NAME, system.deviceName);
+        DIFF_TEXT(SYSTEM_CREATED, system.created);
+        DIFF_TEXT(SYSTEM_LAST_MODIFIED, system.lastModified);
+    }
+    if (sections & (1u << (uint32_t)ConfigSection::LOGGER)) {
+        DIFF_TEXT(LOGGER_LOG_LEVEL, logger.logLevel);
+        DIFF_VALUE(LOGGER_MAX_FILE_SIZE_BYTES, logger.maxFileSizeBytes);
+        DIFF_VALUE(LOGGER_MAX_ROTATED_FILES, logger.maxRotatedFiles);
+        DIFF_VALUE(LOGGER_ASYNC, logger.async);
+        DIFF_VALUE(LOGGER_ASYNC_BUFFER_BYTES, logger.asyncBufferBytes);
+        DIFF_TEXT(LOGGER_OVERFLOW_POLICY, logger.overflowPolicy);
+        DIFF_TEXT(LOGGER_LOG_FORMAT, logger.logFormat);
+        DIFF_VALUE(LOGGER_COMPRESS_ROTATED, logger.compressRotated);
+        DIFF_VALUE(LOGGER_PREALLOCATE, logger.preallocate);
+        DIFF_TEXT(LOGGER_TIMESTAMP_PRECISION, logger.timestampPrecision);
+        DIFF_TEXT(LOGGER_SD_LEVEL, logger.sdLevel);
+        DIFF_TEXT(LOGGER_SERIAL_LEVEL, logger.serialLevel);
+        DIFF_TEXT(LOGGER_MEMORY_LEVEL, logger.memoryLevel);
+        DIFF_VALUE(LOGGER_MEMORY_ENTRIES, logger.memoryEntries);
+        bool tagsDiffer = before.logger.tagCount != after.logger.tagCount;
+        for (uint8_t i = 0; i < after.logger.tagCount && !tagsDiffer; i++) {
+            tagsDiffer = strcmp(before.logger.tags[i].name, after.logger.tags[i].name) != 0 ||
+                         strcmp(before.logger.tags[i].level, after.logger.tags[i].level) != 0;
+        }
+        if (tagsDiffer) {
+            changed |= EARS_configKeyBit(ConfigKey::LOGGER_TAG_LEVELS);
+        }
+    }
+    if (sections & (1u << (uint32_t)ConfigSection::DISPLAY)) {
+        DIFF_VALUE(DISPLAY_BRIGHTNESS, display.brightness);
+        DIFF_VALUE(DISPLAY_TIMEOUT_SECONDS, display.timeoutSeconds);
+        DIFF_TEXT(DISPLAY_THEME, display.theme);
+    }
+    if (sections & (1u << (uint32_t)ConfigSection::NETWORK)) {
+        DIFF_VALUE(NETWORK_WIFI_ENABLED, network.wifiEnabled);
+        DIFF_TEXT(NETWORK_SSID, network.ssid);
+        DIFF_VALUE(NETWORK_AUTO_CONNECT, network.autoConnect);
+    }
+    if (sections & (1u << (uint32_t)ConfigSection::SECURITY)) {
+        DIFF_VALUE(SECURITY_REQUIRE_PASSWORD, security.requirePassword);
+        DIFF_VALUE(SECURITY_AUTO_LOCK_MINUTES, security.autoLockMinutes);
+    }
+    if (sections & (1u << (uint32_t)ConfigSection::APPLICATION)) {
+        DIFF_TEXT(APPLICATION_UNITS, application.units);
+        DIFF_TEXT(APPLICATION_LANGUAGE, application.language);
+        DIFF_TEXT(APPLICATION_DATE_FORMAT, application.dateFormat);
+        DIFF_TEXT(APPLICATION_TIME_FORMAT, application.timeFormat);
+    }
+    return changed;
+}
+
+/**
+ * @brief Read a whole ears.config document into a model
+ * @param text Document text (anything after the root object is ignored)
+ * @param length Bytes of text
+ * @param model Receives the values found; others keep their value
+ * @param present Receives a bit per ConfigSection found in the document
+ * @return true if the document was well formed
+ */
+bool EARS_configDecode(const char* text, size_t length, ConfigModel& model, uint32_t& present) {
+    ConfigDecode decode;
+    decode.model = &model;
+    decode.present = 0;
+    model.extras.clear(ConfigSection::COUNT);
+    bool ok = EARS_configJsonReader::parse(text, length, decodeValue, &decode);
+    present = decode.present;
+    return ok;
+}
+
+/**
+ * @brief Write the kept unknown members of one object
+ */
+static void encodeExtras(EARS_configJsonWriter& json, const ConfigExtras& extras, ConfigSection section,
+                         const char* parent) {
+    size_t at = 0;
+    ConfigSection found;
+    const char* foundParent;
+    const char* key;
+    const char* value;
+    while (extras.next(at, found, foundParent, key, value)) {
+        if (found == section && strcmp(foundParent, parent) == 0) {
+            json.raw(key, value, strlen(value));
+        }
+    }
+}
+
+/**
+ * @brief Write one section the way it appears inside the root object
+ * @param section Section to write
+ * @param model Values
+ * @param out Destination, starts with two spaces of indent, no trailing comma
+ * @param capacity Size of out
+ * @return size_t bytes written, 0 if it did not fit
+ */
+size_t EARS_configEncodeSection(ConfigSection section, const ConfigModel& model, char* out, size_t capacity) {
+    if (section >= ConfigSection::COUNT) {
+        return 0;
+    }
+    EARS_configJsonWriter json(out, capacity, 1);
+    json.beginObject(EARS_configSectionName(section));
+    switch (section) {
+        case ConfigSection::SYSTEM: {
+            const SystemSettings& system = model.system;
+            json.string("version", system.version);
+            json.string("zap_number", system.zapNumber);
+            json.string("device_name", system.deviceName);
+            json.string("created", system.created);
+            json.string("last_modified", system.lastModified);
+            break;
+        }
+        case ConfigSection::LOGGER: {
+            const LoggerSettings& logger = model.logger;
+            json.string("log_level", logger.logLevel);
+            json.number("max_file_size_bytes", logger.maxFileSizeBytes);
+            json.number("max_rotated_files", logger.maxRotatedFiles);
+            json.boolean("async", logger.async);
+            json.number("async_buffer_bytes", logger.asyncBufferBytes);
+            json.string("overflow_policy", logger.overflowPolicy);
+            json.string("log_format", logger.logFormat);
+            json.boolean("compress_rotated", logger.compressRotated);
+            json.boolean("preallocate", logger.preallocate);
+            json.string("timestamp_precision", logger.timestampPrecision);
+            json.beginObject("sinks");
+            json.string("sd", logger.sdLevel);
+            json.string("serial", logger.serialLevel);
+            json.string("memory", logger.memoryLevel);
+            json.number("memory_entries", logger.memoryEntries);
+            encodeExtras(json, model.extras, section, "sinks");
+            json.endObject();
+            if (logger.tagCount > 0 || model.extras.has(section, "tag_levels")) {
+                json.beginObject("tag_levels");
+                for (uint8_t i = 0; i < logger.tagCount; i++) {
+                    json.string(logger.tags[i].name, logger.tags[i].level);
+                }
+                encodeExtras(json, model.extras, section, "tag_levels");
+                json.endObject();
+            }
+            break;
+        }
+        case ConfigSection::DISPLAY: {
+            const DisplaySettings& display = model.display;
+            json.number("brightness", display.brightness);
+            json.number("timeout_seconds", display.timeoutSeconds);
+            json.string("theme", display.theme);
+            break;
+        }
+        case ConfigSection::NETWORK: {
+            const NetworkSettings& network = model.network;
+            json.boolean("wifi_enabled", network.wifiEnabled);
+            json.string("ssid", network.ssid);
+            json.boolean("auto_connect", network.autoConnect);
+            break;
+        }
+        case ConfigSection::SECURITY: {
+            const SecuritySettings& security = model.security;
+            json.boolean("require_password", security.requirePassword);
+            json.number("auto_lock_minutes", security.autoLockMinutes);
+            break;
+        }
+        case ConfigSection::APPLICATION: {
+            const ApplicationSettings& application = model.application;
+            json.string("units", application.units);
+            json.string("language", application.language);
+            json.string("date_format", application.dateFormat);
+            json.string("time_format", application.timeFormat);
+            break;
+        }
+        default:
+            break;
+    }
+    encodeExtras(json, model.extras, section, "");
+    json.endObject();
+    return json.overflowed() ? 0 : json.length();
+}
+
+/**
+ * @brief Write the kept members of the root object that are not sections
+ * @param model Values
+ * @param out Destination, members at two spaces of indent, no trailing comma
+ * @param capacity Size of out
+ * @return size_t bytes written, 0 if there are none or they did not fit
+ */
+size_t EARS_configEncodeUnknownSections(const ConfigModel& model, char* out, size_t capacity) {
+    EARS_configJsonWriter json(out, capacity, 1);
+    encodeExtras(json, model.extras, ConfigSection::COUNT, "");
+    return json.overflowed() ? 0 : json.length();
+}
+
+/****************************************************************************
+ * End of EARS_configModel.cpp
+ ***************************************************************************/
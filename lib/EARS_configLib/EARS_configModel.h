@@ -0,0 +1,323 @@
+/**
+ * @file EARS_configModel.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Typed in-memory model of every ears.config section
+ * @version 1.2.0
+ * @date 20261016
+ *
+ * @details
+ * One plain struct per top-level section, with fixed size strings and the
+ * defaults the firmware used when the file lacked a value. Level, policy
+ * and format names stay strings here; the library that owns a setting
+ * parses it, so this library depends on none of them.
+ *
+ * Strings longer than their field are cut when read. Members the model
+ * does not know are kept as written in ConfigExtras and put back, after
+ * the known ones, whenever their section is written again.
+ *
+ * ConfigKey names each setting so observers can ask for just the values
+ * they use; EARS_configChangedKeys() finds which of them differ.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_CONFIG_MODEL_H__
+#define __EARS_CONFIG_MODEL_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+// Per-module levels kept in the logger section
+#define EARS_CONFIG_MAX_TAGS 12
+// Room for the members of ears.config the model does not know
+#define EARS_CONFIG_EXTRA_BYTES 512
+
+/**
+ * @brief Top-level sections, in file order
+ */
+enum class ConfigSection : uint8_t {
+    SYSTEM = 0,
+    LOGGER,
+    DISPLAY,
+    NETWORK,
+    SECURITY,
+    APPLICATION,
+    COUNT
+};
+
+/**
+ * @brief Individual settings, for change observers
+ */
+enum class ConfigKey : uint8_t {
+    SYSTEM_VERSION = 0,
+    SYSTEM_ZAP_NUMBER,
+    SYSTEM_DEVICE_NAME,
+    SYSTEM_CREATED,
+    SYSTEM_LAST_MODIFIED,
+    LOGGER_LOG_LEVEL,
+    LOGGER_MAX_FILE_SIZE_BYTES,
+    LOGGER_MAX_ROTATED_FILES,
+    LOGGER_ASYNC,
+    LOGGER_ASYNC_BUFFER_BYTES,
+    LOGGER_OVERFLOW_POLICY,
+    LOGGER_LOG_FORMAT,
+    LOGGER_COMPRESS_ROTATED,
+    LOGGER_PREALLOCATE,
+    LOGGER_TIMESTAMP_PRECISION,
+    LOGGER_SD_LEVEL,
+    LOGGER_SERIAL_LEVEL,
+    LOGGER_MEMORY_LEVEL,
+    LOGGER_MEMORY_ENTRIES,
+    LOGGER_TAG_LEVELS,              // Any entry of "tag_levels"
+    DISPLAY_BRIGHTNESS,
+    DISPLAY_TIMEOUT_SECONDS,
+    DISPLAY_THEME,
+    NETWORK_WIFI_ENABLED,
+    NETWORK_SSID,
+    NETWORK_AUTO_CONNECT,
+    SECURITY_REQUIRE_PASSWORD,
+    SECURITY_AUTO_LOCK_MINUTES,
+    APPLICATION_UNITS,
+    APPLICATION_LANGUAGE,
+    APPLICATION_DATE_FORMAT,
+    APPLICATION_TIME_FORMAT,
+    COUNT
+};
+
+// Bit per ConfigKey
+typedef uint64_t ConfigKeyMask;
+
+/**
+ * @brief Mask bit for one key
+ * @param key Key
+ * @return ConfigKeyMask bit
+ */
+inline ConfigKeyMask EARS_configKeyBit(ConfigKey key) {
+    return (ConfigKeyMask)1 << (uint8_t)key;
+}
+
+/**
+ * @brief "system" section
+ */
+struct SystemSettings {
+    char version[16];
+    char zapNumber[24];
+    char deviceName[32];
+    char created[16];
+    char lastModified[16];
+
+    SystemSettings();
+    bool operator==(const SystemSettings& other) const;
+};
+
+/**
+ * @brief One "tag_levels" entry of the logger section
+ */
+struct LoggerTagSetting {
+    char name[16];
+    char level[8];
+};
+
+/**
+ * @brief "logger" section
+ */
+struct LoggerSettings {
+    char logLevel[8];
+    uint32_t maxFileSizeBytes;
+    uint8_t maxRotatedFiles;
+    bool async;
+    uint32_t asyncBufferBytes;
+    char overflowPolicy[16];
+    char logFormat[8];
+    bool compressRotated;
+    bool preallocate;
+    char timestampPrecision[8];
+    char sdLevel[8];                // "sinks" object
+    char serialLevel[8];
+    char memoryLevel[8];
+    uint16_t memoryEntries;
+    LoggerTagSetting tags[EARS_CONFIG_MAX_TAGS];
+    uint8_t tagCount;
+
+    LoggerSettings();
+    bool operator==(const LoggerSettings& other) const;
+
+    /**
+     * @brief Set a module's level, adding the module if it is new
+     * @param name Module name, e.g. "SDCARD"
+     * @param level Level name
+     * @return true if stored, false if all EARS_CONFIG_MAX_TAGS are taken
+     */
+    bool setTagLevel(const char* name, const char* level);
+};
+
+/**
+ * @brief "display" section
+ */
+struct DisplaySettings {
+    uint8_t brightness;
+    uint16_t timeoutSeconds;
+    char theme[16];
+
+    DisplaySettings();
+    bool operator==(const DisplaySettings& other) const;
+};
+
+/**
+ * @brief "network" section
+ */
+struct NetworkSettings {
+    bool wifiEnabled;
+    char ssid[33];
+    bool autoConnect;
+
+    NetworkSettings();
+    bool operator==(const NetworkSettings& other) const;
+};
+
+/**
+ * @brief "security" section
+ */
+struct SecuritySettings {
+    bool requirePassword;
+    uint16_t autoLockMinutes;
+
+    SecuritySettings();
+    bool operator==(const SecuritySettings& other) const;
+};
+
+/**
+ * @brief "application" section
+ */
+struct ApplicationSettings {
+    char units[12];
+    char language[8];
+    char dateFormat[16];
+    char timeFormat[8];
+
+    ApplicationSettings();
+    bool operator==(const ApplicationSettings& other) const;
+};
+
+/**
+ * @brief Members of ears.config the model does not know, kept as written
+ *
+ * Each member is stored as its section (COUNT for a member of the root
+ * object that is not a section), the key of the object holding it
+ * ("" for a member of the section itself), its key and its JSON text, so
+ * a rewrite puts it back in the same object. A key is kept to
+ * EARS_configJsonReader::KEY_BYTES - 1 bytes, like every key read.
+ */
+struct ConfigExtras {
+    char text[EARS_CONFIG_EXTRA_BYTES];
+    uint16_t used;
+    uint16_t dropped;               // Members that did not fit
+
+    ConfigExtras();
+
+    /**
+     * @brief Keep a member
+     * @param section Section holding it
+     * @param parent Key of the object holding it, "" for the section
+     * @param key Member name
+     * @param value JSON text of the value
+     * @param length Bytes of value
+     * @return true if kept, false (and dropped counted) if out of room
+     */
+    bool add(ConfigSection section, const char* parent, const char* key, const char* value, size_t length);
+
+    /**
+     * @brief Forget every member of a section
+     * @param section Section
+     * @return void
+     */
+    void clear(ConfigSection section);
+
+    /**
+     * @brief Check whether an object holds any kept member
+     * @param section Section
+     * @param parent Key of the object, "" for the section
+     * @return true if at least one member is kept there
+     */
+    bool has(ConfigSection section, const char* parent) const;
+
+    /**
+     * @brief Step through kept members
+     * @param at Offset to resume from, 0 to start; advanced past the member
+     * @param section Receives its section
+     * @param parent Receives the key of the object holding it
+     * @param key Receives its name
+     * @param value Receives its JSON text, NUL terminated
+     * @return false when there are no more
+     */
+    bool next(size_t& at, ConfigSection& section, const char*& parent, const char*& key, const char*& value) const;
+};
+
+/**
+ * @brief Every section of ears.config
+ */
+struct ConfigModel {
+    SystemSettings system;
+    LoggerSettings logger;
+    DisplaySettings display;
+    NetworkSettings network;
+    SecuritySettings security;
+    ApplicationSettings application;
+    ConfigExtras extras;
+};
+
+/**
+ * @brief Section name as used in ears.config
+ * @param section Section
+ * @return const char* name, "" for COUNT
+ */
+const char* EARS_configSectionName(ConfigSection section);
+
+/**
+ * @brief Find the settings that differ between two models
+ * @param before Old values
+ * @param after New values
+ * @param sections Bit per ConfigSection to compare, others are skipped
+ * @return ConfigKeyMask bit per differing key
+ */
+ConfigKeyMask EARS_configChangedKeys(const ConfigModel& before, const ConfigModel& after, uint32_t sections);
+
+/**
+ * @brief Read a whole ears.config document into a model
+ * @param text Document text (anything after the root object is ignored)
+ * @param length Bytes of text
+ * @param model Receives the values found; others keep their value. The
+ *              unknown members of each section found replace those kept
+ * @param present Receives a bit per ConfigSection found in the document
+ * @return true if the document was well formed
+ */
+bool EARS_configDecode(const char* text, size_t length, ConfigModel& model, uint32_t& present);
+
+/**
+ * @brief Write one section the way it appears inside the root object
+ * @param section Section to write
+ * @param model Values, followed in each object by its kept unknown members
+ * @param out Destination, starts with two spaces of indent, no trailing comma
+ * @param capacity Size of out
+ * @return size_t bytes written, 0 if it did not fit
+ */
+size_t EARS_configEncodeSection(ConfigSection section, const ConfigModel& model, char* out, size_t capacity);
+
+/**
+ * @brief Write the kept members of the root object that are not sections
+ * @param model Values
+ * @param out Destination, members at two spaces of indent, no trailing comma
+ * @param capacity Size of out
+ * @return size_t bytes written, 0 if there are none or they did not fit
+ */
+size_t EARS_configEncodeUnknownSections(const ConfigModel& model, char* out, size_t capacity);
+
+#endif // __EARS_CONFIG_MODEL_H__
+
+/****************************************************************************
+ * End of EARS_configModel.h
+ ***************************************************************************/
@@ -0,0 +1,89 @@
+/**
+ * @file EARS_configSnapshot.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Binary copy of the parsed ears.config for fast boot
+ * @version 1.0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_configSnapshot.h"
+#include <string.h>
+#include "EARS_atomicFile.h"
+
+/**
+ * @brief Checksum of the header fields before check, and the model
+ * @param snapshot Snapshot image
+ * @return uint32_t FNV-1a checksum
+ */
+static uint32_t snapshotCheck(const ConfigSnapshot& snapshot) {
+    EARS_atomicFile sum;
+    sum.add(reinterpret_cast<const uint8_t*>(&snapshot.header), offsetof(ConfigSnapshotHeader, check));
+    sum.add(reinterpret_cast<const uint8_t*>(&snapshot.model), sizeof(snapshot.model));
+    return sum.check();
+}
+
+/**
+ * @brief Snapshot path for a config file
+ * @param path Config file path
+ * @param out Receives "<path>.snap"
+ * @param outBytes Size of out
+ * @return true if it fitted
+ */
+bool EARS_configSnapshotPath(const char* path, char* out, size_t outBytes) {
+    size_t length = strlen(path);
+    size_t suffix = sizeof(EARS_CONFIG_SNAPSHOT_SUFFIX) - 1;
+    if (length + suffix >= outBytes) {
+        return false;
+    }
+    memcpy(out, path, length);
+    memcpy(out + length, EARS_CONFIG_SNAPSHOT_SUFFIX, suffix + 1);
+    return true;
+}
+
+/**
+ * @brief Fill in the header for snapshot.model
+ * @param snapshot Snapshot whose model is set
+ * @param present Bit per ConfigSection found in the file
+ * @param jsonLength Length of the config file the model matches
+ * @param jsonCheck FNV-1a checksum of that file
+ * @return void
+ */
+void EARS_configSnapshotSeal(ConfigSnapshot& snapshot, uint32_t present, uint32_t jsonLength, uint32_t jsonCheck) {
+    ConfigSnapshotHeader& header = snapshot.header;
+    memcpy(header.magic, EARS_CONFIG_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.layout = EARS_CONFIG_SNAPSHOT_LAYOUT;
+    header.modelBytes = (uint16_t)sizeof(ConfigModel);
+    header.present = present;
+    header.jsonLength = jsonLength;
+    header.jsonCheck = jsonCheck;
+    header.check = snapshotCheck(snapshot);
+}
+
+/**
+ * @brief Check a snapshot read from the card against the config file
+ * @param snapshot Snapshot image
+ * @param length Bytes read into snapshot
+ * @param jsonLength Length of the config file now on the card
+ * @param jsonCheck FNV-1a checksum of that file
+ * @return true if snapshot.model may be used in place of parsing
+ */
+bool EARS_configSnapshotMatches(const ConfigSnapshot& snapshot, size_t length, uint32_t jsonLength,
+                                uint32_t jsonCheck) {
+    const ConfigSnapshotHeader& header = snapshot.header;
+    return length == sizeof(ConfigSnapshot) &&
+           memcmp(header.magic, EARS_CONFIG_SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+           header.layout == EARS_CONFIG_SNAPSHOT_LAYOUT &&
+           header.modelBytes == sizeof(ConfigModel) &&
+           header.jsonLength == jsonLength &&
+           header.jsonCheck == jsonCheck &&
+           header.check == snapshotCheck(snapshot);
+}
+
+/****************************************************************************
+ * End of EARS_configSnapshot.cpp
+ ***************************************************************************/
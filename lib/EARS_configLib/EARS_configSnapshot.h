@@ -0,0 +1,97 @@
+/**
+ * @file EARS_configSnapshot.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Binary copy of the parsed ears.config for fast boot
+ * @version 1.0.1
+ * @date 20261016
+ *
+ * @details
+ * The snapshot is a small header followed by the ConfigModel exactly as it
+ * sits in RAM, stored next to ears.config as "<path>.snap". The header
+ * records the length and FNV-1a checksum of the ears.config file the model
+ * came from, so a boot that finds the same file loads the model with one
+ * read instead of parsing the JSON. A file edited by hand, a model layout
+ * change or a torn snapshot write all fail the check and fall back to
+ * parsing, after which the snapshot is written again.
+ *
+ * ears.config stays the only source of truth; the snapshot is a cache and
+ * is only ever used together with the file it was made from. It is not
+ * portable between builds with a different ConfigModel layout.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_CONFIG_SNAPSHOT_H__
+#define __EARS_CONFIG_SNAPSHOT_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "EARS_configModel.h"
+
+// Snapshot magic and file suffix
+#define EARS_CONFIG_SNAPSHOT_MAGIC "ECS1"
+#define EARS_CONFIG_SNAPSHOT_SUFFIX ".snap"
+
+// Bump whenever a settings struct changes, even if its size does not
+#define EARS_CONFIG_SNAPSHOT_LAYOUT 2
+
+/**
+ * @brief Snapshot header
+ */
+struct ConfigSnapshotHeader {
+    char magic[4];          // EARS_CONFIG_SNAPSHOT_MAGIC
+    uint16_t layout;        // EARS_CONFIG_SNAPSHOT_LAYOUT
+    uint16_t modelBytes;    // sizeof(ConfigModel)
+    uint32_t present;       // Bit per ConfigSection found in the file
+    uint32_t jsonLength;    // ears.config length in bytes, trailer included
+    uint32_t jsonCheck;     // ears.config FNV-1a checksum, trailer included
+    uint32_t check;         // FNV-1a of the fields above and the model
+};
+
+/**
+ * @brief Snapshot file image
+ */
+struct ConfigSnapshot {
+    ConfigSnapshotHeader header;
+    ConfigModel model;
+};
+
+/**
+ * @brief Snapshot path for a config file
+ * @param path Config file path
+ * @param out Receives "<path>.snap"
+ * @param outBytes Size of out
+ * @return true if it fitted
+ */
+bool EARS_configSnapshotPath(const char* path, char* out, size_t outBytes);
+
+/**
+ * @brief Fill in the header for snapshot.model
+ * @param snapshot Snapshot whose model is set
+ * @param present Bit per ConfigSection found in the file
+ * @param jsonLength Length of the config file the model matches
+ * @param jsonCheck FNV-1a checksum of that file
+ * @return void
+ */
+void EARS_configSnapshotSeal(ConfigSnapshot& snapshot, uint32_t present, uint32_t jsonLength, uint32_t jsonCheck);
+
+/**
+ * @brief Check a snapshot read from the card against the config file
+ * @param snapshot Snapshot image
+ * @param length Bytes read into snapshot
+ * @param jsonLength Length of the config file now on the card
+ * @param jsonCheck FNV-1a checksum of that file
+ * @return true if snapshot.model may be used in place of parsing
+ */
+bool EARS_configSnapshotMatches(const ConfigSnapshot& snapshot, size_t length, uint32_t jsonLength,
+                                uint32_t jsonCheck);
+
+#endif // __EARS_CONFIG_SNAPSHOT_H__
+
+/****************************************************************************
+ * End of EARS_configSnapshot.h
+ ***************************************************************************/
@@ -0,0 +1,284 @@
+/**
+ * @file EARS_crashLogLib.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Reboot-surviving mirror of the last log entries
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_crashLogLib.h"
+#include <string.h>
+#include <stddef.h>
+
+/**
+ * @brief Construct a detached crash log
+ */
+EARS_crashLog::EARS_crashLog()
+    : _region(nullptr),
+      _slotBytes(0),
+      _slotCount(0),
+      _active(false),
+      _nextSequence(0),
+      _recoveredCount(0),
+      _recoveredFlags(0),
+      _recoveredBaseUs(0),
+      _recoveredLast(0),
+      _appended(0),
+      _truncated(0),
+      _collisions(0) {
+}
+
+/**
+ * @brief Attach the region and check what the previous session left
+ * @param region Memory that survives a reset, 4 byte aligned
+ * @param regionBytes Size of region in bytes
+ * @param slotBytes Size of one slot including its header, multiple of 4
+ * @return true if the region is usable
+ * @return false if parameters are invalid
+ */
+bool EARS_crashLog::begin(uint8_t* region, size_t regionBytes, size_t slotBytes) {
+    _active = false;
+    _recoveredCount = 0;
+    _recoveredFlags = 0;
+    _recoveredBaseUs = 0;
+    _recoveredLast = 0;
+
+    if (region == nullptr || ((uintptr_t)region & 3) != 0) {
+        return false;
+    }
+    if (slotBytes <= SLOT_HEADER_BYTES || (slotBytes & 3) != 0 || slotBytes > 0xFFFF) {
+        return false;
+    }
+    if (regionBytes < sizeof(CrashLogHeader) + slotBytes) {
+        return false;
+    }
+
+    _region = region;
+    _slotBytes = slotBytes;
+    _slotCount = (regionBytes - sizeof(CrashLogHeader)) / slotBytes;
+    if (_slotCount > 0xFFFF) {
+        _slotCount = 0xFFFF;
+    }
+
+    scan();
+    return true;
+}
+
+/**
+ * @brief Hand every recovered entry to sink, oldest first
+ * @param sink Entry callback
+ * @param context Passed to sink unchanged
+ * @return size_t number of entries delivered
+ */
+size_t EARS_crashLog::recover(CrashLogSink sink, void* context) const {
+    if (_recoveredCount == 0 || sink == nullptr) {
+        return 0;
+    }
+
+    // Sequence n lives in slot (n - 1) % slotCount, so walking the last
+    // slotCount sequences visits the slots oldest first
+    uint32_t first = _recoveredLast > _slotCount ? _recoveredLast - (uint32_t)_slotCount + 1 : 1;
+    size_t delivered = 0;
+    for (uint32_t sequence = first; sequence <= _recoveredLast; sequence++) {
+        size_t index = (sequence - 1) % _slotCount;
+        if (commitWord(index).load(std::memory_order_acquire) != sequence) {
+            continue;
+        }
+        uint8_t* entry = slot(index);
+        uint16_t length;
+        memcpy(&length, entry + 4, sizeof(length));
+        if (length > slotPayloadBytes()) {
+            continue;
+        }
+        sink(reinterpret_cast<const char*>(entry + SLOT_HEADER_BYTES), length, context);
+        delivered++;
+    }
+    return delivered;
+}
+
+/**
+ * @brief Clear the slots and write a fresh header
+ * @param flags Caller flags stored for the next boot
+ * @param baseUs Caller time base stored for the next boot
+ * @return void
+ */
+void EARS_crashLog::startSession(uint32_t flags, uint64_t baseUs) {
+    if (_region == nullptr) {
+        return;
+    }
+    _active = false;
+
+    for (size_t index = 0; index < _slotCount; index++) {
+        commitWord(index).store(0, std::memory_order_relaxed);
+    }
+
+    CrashLogHeader* head = header();
+    head->magic = MAGIC;
+    head->slotBytes = (uint16_t)_slotBytes;
+    head->slotCount = (uint16_t)_slotCount;
+    head->flags = flags;
+    head->baseUsLow = (uint32_t)baseUs;
+    head->baseUsHigh = (uint32_t)(baseUs >> 32);
+    head->crc = crc32(_region, offsetof(CrashLogHeader, crc));
+
+    _nextSequence.store(0, std::memory_order_relaxed);
+    _appended.store(0, std::memory_order_relaxed);
+    _truncated.store(0, std::memory_order_relaxed);
+    _collisions.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _active = true;
+}
+
+/**
+ * @brief Mirror one entry, overwriting the oldest
+ * @param data Entry bytes
+ * @param length Number of bytes, cut to slotPayloadBytes()
+ * @return void
+ */
+void EARS_crashLog::append(const char* data, size_t length) {
+    if (!_active || data == nullptr) {
+        return;
+    }
+
+    uint32_t sequence = _nextSequence.fetch_add(1, std::memory_order_relaxed) + 1;
+    size_t index = (sequence - 1) % _slotCount;
+    std::atomic<uint32_t>& commit = commitWord(index);
+
+    // A slot still BUSY or already holding a newer entry means another
+    // writer lapped the ring while this one was scheduled out; dropping
+    // the older entry keeps the slot consistent
+    uint32_t current = commit.load(std::memory_order_relaxed);
+    if (current == BUSY || current > sequence ||
+        !commit.compare_exchange_strong(current, BUSY, std::memory_order_acquire, std::memory_order_relaxed)) {
+        _collisions.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (length > slotPayloadBytes()) {
+        length = slotPayloadBytes();
+        _truncated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint8_t* entry = slot(index);
+    uint16_t stored = (uint16_t)length;
+    memcpy(entry + 4, &stored, sizeof(stored));
+    memcpy(entry + SLOT_HEADER_BYTES, data, length);
+
+    commit.store(sequence, std::memory_order_release);
+    _appended.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Counters for the current session
+ * @return CrashLogStats counters
+ */
+CrashLogStats EARS_crashLog::getStats() const {
+    CrashLogStats stats;
+    stats.appended = _appended.load(std::memory_order_relaxed);
+    stats.truncated = _truncated.load(std::memory_order_relaxed);
+    stats.collisions = _collisions.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * @brief CRC32 (IEEE, reflected) used for the header
+ * @param data Bytes to check
+ * @param length Number of bytes
+ * @return uint32_t CRC
+ */
+uint32_t EARS_crashLog::crc32(const uint8_t* data, size_t length) {
+    // Nibble table: only the header is checked, once per boot
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+/**
+ * @brief Start of a slot
+ * @param index Slot number
+ * @return uint8_t* slot header
+ */
+uint8_t* EARS_crashLog::slot(size_t index) const {
+    return _region + sizeof(CrashLogHeader) + index * _slotBytes;
+}
+
+/**
+ * @brief Commit word at the start of a slot
+ * @param index Slot number
+ * @return std::atomic<uint32_t>& commit word
+ */
+std::atomic<uint32_t>& EARS_crashLog::commitWord(size_t index) const {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(slot(index));
+}
+
+/**
+ * @brief Check magic, geometry and CRC of the header
+ * @return true if the header was written by startSession()
+ */
+bool EARS_crashLog::headerValid() const {
+    const CrashLogHeader* head = header();
+    return head->magic == MAGIC &&
+           head->slotBytes == _slotBytes &&
+           head->slotCount == _slotCount &&
+           head->crc == crc32(_region, offsetof(CrashLogHeader, crc));
+}
+
+/**
+ * @brief Find the newest committed entry and count the recoverable ones
+ * @return void
+ */
+void EARS_crashLog::scan() {
+    if (!headerValid()) {
+        return;
+    }
+
+    // A committed slot must sit where its sequence number puts it; anything
+    // else is left over from a torn write and ignored
+    uint32_t newest = 0;
+    for (size_t index = 0; index < _slotCount; index++) {
+        uint32_t sequence = commitWord(index).load(std::memory_order_acquire);
+        if (sequence == 0 || sequence == BUSY || (sequence - 1) % _slotCount != index) {
+            continue;
+        }
+        if (sequence > newest) {
+            newest = sequence;
+        }
+    }
+    if (newest == 0) {
+        return;
+    }
+
+    _recoveredLast = newest;
+    _recoveredFlags = header()->flags;
+    _recoveredBaseUs = ((uint64_t)header()->baseUsHigh << 32) | header()->baseUsLow;
+
+    uint32_t first = newest > _slotCount ? newest - (uint32_t)_slotCount + 1 : 1;
+    for (uint32_t sequence = first; sequence <= newest; sequence++) {
+        size_t index = (sequence - 1) % _slotCount;
+        uint16_t length;
+        memcpy(&length, slot(index) + 4, sizeof(length));
+        if (commitWord(index).load(std::memory_order_relaxed) == sequence && length <= slotPayloadBytes()) {
+            _recoveredCount++;
+        }
+    }
+}
+
+/****************************************************************************
+ * End of EARS_crashLogLib.cpp
+ ***************************************************************************/
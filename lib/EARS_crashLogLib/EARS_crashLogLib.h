@@ -0,0 +1,197 @@
+/**
+ * @file EARS_crashLogLib.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Reboot-surviving mirror of the last log entries
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * The crash log keeps the most recent entries in a small memory region
+ * that is not cleared by a reset or panic (.noinit on the device, a plain
+ * array in host tests). On the next boot begin() validates the region and
+ * recover() hands back what the previous session logged last, oldest
+ * first, so it can be written to the SD log.
+ *
+ * Region layout:
+ * - header: magic, geometry, session flags and time base, CRC32 of the header
+ * - slots:  u32 commit word, u16 length, u16 unused, entry bytes
+ *
+ * A slot's commit word is the entry's sequence number (from 1), BUSY while
+ * it is being written and 0 when empty, so a write cut short by a crash
+ * is simply skipped. append() is lock-free: one fetch_add picks the slot
+ * and one compare-and-swap claims it. The region must be in internal RAM
+ * for the atomics.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_CRASH_LOG_LIB_H__
+#define __EARS_CRASH_LOG_LIB_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/**
+ * @brief Receives one recovered entry
+ * @param data Entry bytes as appended (possibly cut to the slot size)
+ * @param length Number of bytes
+ * @param context Caller context given to recover()
+ * @return void
+ */
+typedef void (*CrashLogSink)(const char* data, size_t length, void* context);
+
+/**
+ * @brief Region header, first bytes of the region
+ */
+struct CrashLogHeader {
+    uint32_t magic;
+    uint16_t slotBytes;
+    uint16_t slotCount;
+    uint32_t flags;         // Caller defined, e.g. log file format
+    uint32_t baseUsLow;     // Caller time base (binary log records)
+    uint32_t baseUsHigh;
+    uint32_t crc;           // CRC32 of the fields above
+};
+
+/**
+ * @brief Crash log counters for the current session
+ */
+struct CrashLogStats {
+    uint32_t appended;      // Entries mirrored
+    uint32_t truncated;     // Entries cut to fit a slot
+    uint32_t collisions;    // Entries skipped because their slot was still being written
+
+    CrashLogStats() : appended(0), truncated(0), collisions(0) {}
+};
+
+/**
+ * @brief Fixed-slot crash log over a caller supplied region
+ */
+class EARS_crashLog {
+public:
+    // "ECL1"
+    static const uint32_t MAGIC = 0x314C4345;
+    // Bytes in front of each slot's entry
+    static const size_t SLOT_HEADER_BYTES = 8;
+    // Commit word of a slot being written
+    static const uint32_t BUSY = 0xFFFFFFFF;
+
+    EARS_crashLog();
+
+    /**
+     * @brief Attach the region and check what the previous session left
+     * @param region Memory that survives a reset, 4 byte aligned
+     * @param regionBytes Size of region in bytes
+     * @param slotBytes Size of one slot including its header, multiple of 4
+     * @return true if the region is usable
+     * @return false if parameters are invalid
+     *
+     * Does not modify the region; call startSession() after recover().
+     */
+    bool begin(uint8_t* region, size_t regionBytes, size_t slotBytes);
+
+    /**
+     * @brief Number of entries the previous session left
+     * @return size_t recoverable entries, 0 if the region was invalid
+     */
+    size_t recoveredCount() const { return _recoveredCount; }
+
+    /**
+     * @brief Flags the previous session was started with
+     * @return uint32_t flags, 0 if nothing was recovered
+     */
+    uint32_t recoveredFlags() const { return _recoveredFlags; }
+
+    /**
+     * @brief Time base the previous session was started with
+     * @return uint64_t time base, 0 if nothing was recovered
+     */
+    uint64_t recoveredBaseUs() const { return _recoveredBaseUs; }
+
+    /**
+     * @brief Hand every recovered entry to sink, oldest first
+     * @param sink Entry callback
+     * @param context Passed to sink unchanged
+     * @return size_t number of entries delivered
+     */
+    size_t recover(CrashLogSink sink, void* context) const;
+
+    /**
+     * @brief Clear the slots and write a fresh header
+     * @param flags Caller flags stored for the next boot
+     * @param baseUs Caller time base stored for the next boot
+     * @return void
+     */
+    void startSession(uint32_t flags, uint64_t baseUs);
+
+    /**
+     * @brief Mirror one entry, overwriting the oldest
+     * @param data Entry bytes
+     * @param length Number of bytes, cut to slotPayloadBytes()
+     * @return void
+     *
+     * Lock-free; safe from any task on either core. No-op before
+     * startSession().
+     */
+    void append(const char* data, size_t length);
+
+    size_t slotCount() const { return _slotCount; }
+    size_t slotPayloadBytes() const { return _slotBytes - SLOT_HEADER_BYTES; }
+
+    /**
+     * @brief Counters for the current session
+     * @return CrashLogStats counters
+     */
+    CrashLogStats getStats() const;
+
+    /**
+     * @brief CRC32 (IEEE, reflected) used for the header
+     * @param data Bytes to check
+     * @param length Number of bytes
+     * @return uint32_t CRC
+     */
+    static uint32_t crc32(const uint8_t* data, size_t length);
+
+private:
+    uint8_t* _region;
+    size_t _slotBytes;
+    size_t _slotCount;
+    bool _active;
+    std::atomic<uint32_t> _nextSequence;
+
+    size_t _recoveredCount;
+    uint32_t _recoveredFlags;
+    uint64_t _recoveredBaseUs;
+    uint32_t _recoveredLast;    // Newest recovered sequence
+
+    std::atomic<uint32_t> _appended;
+    std::atomic<uint32_t> _truncated;
+    std::atomic<uint32_t> _collisions;
+
+    CrashLogHeader* header() const { return reinterpret_cast<CrashLogHeader*>(_region); }
+    uint8_t* slot(size_t index) const;
+    std::atomic<uint32_t>& commitWord(size_t index) const;
+
+    /**
+     * @brief Check magic, geometry and CRC of the header
+     * @return true if the header was written by startSession()
+     */
+    bool headerValid() const;
+
+    /**
+     * @brief Find the newest committed entry and count the recoverable ones
+     * @return void
+     */
+    void scan();
+};
+
+#endif // __EARS_CRASH_LOG_LIB_H__
+
+/****************************************************************************
+ * End of EARS_crashLogLib.h
+ ***************************************************************************/
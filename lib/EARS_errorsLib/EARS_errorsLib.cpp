@@ -5,10 +5,12 @@
  * It loads error messages from a JSON file on a TF card and logs occurrences to a history file.
  * @author Julian
  * @date 20260112
- * @version 1.6.0
+ * @version 1.10.0
  */
 
 #include "EARS_errorsLib.h"
+#include "EARS_sdCardLib.h"
+#include "EARS_loggerLib.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // I do not understand why this is necessary?
@@ -142,50 +144,58 @@ bool EARS_errors::reloadErrorMessages() {
  * @return true if successful
  */
 bool EARS_errors::loadErrorMessages() {
-    if (!SD.exists(errorJsonPath.c_str())) {
-        Serial.println("Error: errors.json not found on TF card");
+    if (!using_sdcard().fileExists(errorJsonPath.c_str())) {
+        LOG_TAG_ERROR(ERRORS, "errors.json not found on TF card");
         return false;
     }
     
-    File file = SD.open(errorJsonPath.c_str(), FILE_READ);
-    if (!file) {
-        Serial.println("Error: Could not open errors.json");
+    if (!using_sdcard().readStream(errorJsonPath.c_str(), readCatalog, this)) {
         return false;
     }
     
-    // Parse JSON
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
+    LOG_TAG_INFOF(ERRORS, "Loaded %u error messages", (unsigned)errorMessageCount);
     
-    if (error) {
-        Serial.print("Error parsing errors.json: ");
-        Serial.println(error.c_str());
+    return true;
+}
+
+/**
+ * Parse the "errors" array one entry at a time
+ * Only one entry is in memory at once, so the catalog's size does not matter
+ * @param in errors.json, positioned at its start
+ * @param context The EARS_errors instance
+ * @return true if the array parsed
+ */
+bool EARS_errors::readCatalog(Stream& in, void* context) {
+    EARS_errors* self = static_cast<EARS_errors*>(context);
+    
+    if (!in.find("\"errors\"") || !in.find("[")) {
+        LOG_TAG_ERROR(ERRORS, "Error parsing errors.json: no errors array");
         return false;
     }
     
     // Clear existing messages
-    errorMessageCount = 0;
+    self->errorMessageCount = 0;
     
-    // Load error messages from JSON
-    JsonArray errors = doc["errors"].as<JsonArray>();
-    for (JsonObject error : errors) {
-        if (errorMessageCount >= MAX_ERROR_MESSAGES) {
-            Serial.println("Warning: Too many error messages, some ignored");
+    JsonDocument entry;
+    do {
+        DeserializationError error = deserializeJson(entry, in);
+        if (error) {
+            LOG_TAG_ERRORF(ERRORS, "Error parsing errors.json: %s", error.c_str());
+            return false;
+        }
+        
+        if (self->errorMessageCount >= MAX_ERROR_MESSAGES) {
+            LOG_TAG_WARN(ERRORS, "Too many error messages, some ignored");
             break;
         }
         
-        uint16_t code = error["code"];
-        const char* message = error["message"];
+        uint16_t code = entry["code"];
+        const char* message = entry["message"];
         
-        errorMessages[errorMessageCount].code = code;
-        errorMessages[errorMessageCount].message = String(message);
-        errorMessageCount++;
-    }
-    
-    Serial.print("Loaded ");
-    Serial.print(errorMessageCount);
-    Serial.println(" error messages");
+        self->errorMessages[self->errorMessageCount].code = code;
+        self->errorMessages[self->errorMessageCount].message = String(message);
+        self->errorMessageCount++;
+    } while (in.findUntil(",", "]"));
     
     return true;
 }
@@ -197,12 +207,6 @@ bool EARS_errors::loadErrorMessages() {
  * @param message Error message
  */
 void EARS_errors::logToHistory(uint16_t code, ErrorLevel level, const char* message) {
-    File file = SD.open(logFilePath.c_str(), FILE_APPEND);
-    if (!file) {
-        Serial.println("Error: Could not open error_log.txt for writing");
-        return;
-    }
-    
     // Create timestamp string
     char timestamp[32];
     unsigned long ms = millis();
@@ -214,16 +218,22 @@ void EARS_errors::logToHistory(uint16_t code, ErrorLevel level, const char* mess
             hours % 24, minutes % 60, seconds % 60, ms % 1000);
     
     // Write log entry: [timestamp] LEVEL Code:1234 Message
-    file.print("[");
-    file.print(timestamp);
-    file.print("] ");
-    file.print(levelToString(level));
-    file.print(" Code:");
-    file.print(code);
-    file.print(" ");
-    file.println(message);
+    // One append through the card's pooled handle instead of an open/close
+    char line[256];
+    int length = snprintf(line, sizeof(line), "[%s] %s Code:%u %s\r\n",
+                          timestamp, levelToString(level).c_str(), (unsigned)code, message);
+    if (length < 0) {
+        return;
+    }
+    if ((size_t)length >= sizeof(line)) {
+        length = sizeof(line) - 1;
+        line[length - 2] = '\r';
+        line[length - 1] = '\n';
+    }
     
-    file.close();
+    if (!using_sdcard().appendFile(logFilePath.c_str(), (const uint8_t*)line, (size_t)length)) {
+        LOG_TAG_ERROR(ERRORS, "Could not open error_log.txt for writing");
+    }
 }
 
 /**
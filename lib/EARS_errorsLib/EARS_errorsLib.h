@@ -3,7 +3,7 @@
  * EARS_errorsLib.h
  *  * @author JTB & Claude Sonnet 4.2
  * @brief Error Management Library for EARS Project
- * @version 1.7.0
+ * @version 1.10.0
  * @date 20260116
  * 
  * @copyright Copyright (c) 2025
@@ -81,6 +81,7 @@ private:
     
     // Internal methods
     bool loadErrorMessages();
+    static bool readCatalog(Stream& in, void* context);
     void logToHistory(uint16_t code, ErrorLevel level, const char* message);
     String findErrorMessage(uint16_t code);
     String levelToString(ErrorLevel level);
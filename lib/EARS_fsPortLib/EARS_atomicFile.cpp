@@ -0,0 +1,234 @@
+/**
+ * @file EARS_atomicFile.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Replace a file all at once: temporary file, checksum, rename
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_atomicFile.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Parse 8 hex digits
+ */
+static bool parseHex8(const uint8_t* in, uint32_t& value) {
+    value = 0;
+    for (int i = 0; i < 8; i++) {
+        uint8_t c = in[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else {
+            return false;
+        }
+        value = (value << 4) | digit;
+    }
+    return true;
+}
+
+/**
+ * @brief Construct an empty seal
+ */
+EARS_atomicFile::EARS_atomicFile() : _length(0), _check(2166136261u) {
+}
+
+/**
+ * @brief Fold written contents into the seal (FNV-1a)
+ * @param data Bytes just written
+ * @param length Number of bytes
+ * @return void
+ */
+void EARS_atomicFile::add(const uint8_t* data, size_t length) {
+    uint32_t hash = _check;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    _check = hash;
+    _length += (uint32_t)length;
+}
+
+/**
+ * @brief Encode the trailer for the contents added so far
+ * @param out At least TRAILER_BYTES + 1 (a terminator is written)
+ * @return size_t TRAILER_BYTES
+ */
+size_t EARS_atomicFile::trailer(char* out) const {
+    snprintf(out, TRAILER_BYTES + 1, "\n" EARS_ATOMIC_MAGIC "%08lx %08lx\n",
+             (unsigned long)_length, (unsigned long)_check);
+    return TRAILER_BYTES;
+}
+
+/**
+ * @brief Decode a trailer
+ * @param in TRAILER_BYTES from the end of a file
+ * @param length Receives the contents length
+ * @param check Receives the contents checksum
+ * @return true if in is a well formed trailer
+ */
+bool EARS_atomicFile::decodeTrailer(const uint8_t* in, uint32_t& length, uint32_t& check) {
+    const size_t magicBytes = sizeof(EARS_ATOMIC_MAGIC) - 1;
+    if (in[0] != '\n' || memcmp(in + 1, EARS_ATOMIC_MAGIC, magicBytes) != 0) {
+        return false;
+    }
+    const uint8_t* fields = in + 1 + magicBytes;
+    return parseHex8(fields, length) && fields[8] == ' ' &&
+           parseHex8(fields + 9, check) && fields[17] == '\n';
+}
+
+/**
+ * @brief Temporary file path for a target
+ * @param path Target path
+ * @param out Receives "<path>.tmp"
+ * @param outBytes Size of out
+ * @return true if it fitted
+ */
+bool EARS_atomicFile::tempPath(const char* path, char* out, size_t outBytes) {
+    int written = snprintf(out, outBytes, "%s" EARS_ATOMIC_SUFFIX, path);
+    return written > 0 && (size_t)written < outBytes;
+}
+
+/**
+ * @brief Replace a file with new contents through a sealed temporary file
+ * @param fs File system
+ * @param path Target path
+ * @param data New contents
+ * @param length Number of bytes
+ * @return true if path now holds the new contents
+ * @return false if a step failed; path holds the old or the new contents
+ */
+bool EARS_atomicFile::write(EARS_fsPort& fs, const char* path, const uint8_t* data, size_t length) {
+    char temp[EARS_FS_PORT_MAX_PATH];
+    if (!tempPath(path, temp, sizeof(temp))) {
+        return false;
+    }
+
+    // A leftover would be appended to
+    if (fs.fileExists(temp) && !fs.removeFile(temp)) {
+        return false;
+    }
+
+    EARS_atomicFile seal;
+    seal.add(data, length);
+    char end[TRAILER_BYTES + 1];
+    seal.trailer(end);
+    if ((length > 0 && !fs.appendFile(temp, data, length)) ||
+        !fs.appendFile(temp, reinterpret_cast<const uint8_t*>(end), TRAILER_BYTES)) {
+        return false;
+    }
+    return commit(fs, path);
+}
+
+/**
+ * @brief Move a sealed temporary file over its target
+ * @param fs File system
+ * @param path Target path; "<path>.tmp" must be complete and sealed
+ * @return true if renamed
+ */
+bool EARS_atomicFile::commit(EARS_fsPort& fs, const char* path) {
+    char temp[EARS_FS_PORT_MAX_PATH];
+    if (!tempPath(path, temp, sizeof(temp))) {
+        return false;
+    }
+
+    // The old file may only go once the new one is on the medium
+    if (!fs.syncFile(temp)) {
+        return false;
+    }
+    if (fs.fileExists(path) && !fs.removeFile(path)) {
+        return false;
+    }
+    return fs.renameFile(temp, path);
+}
+
+/**
+ * @brief Check a file's trailer against its contents
+ * @param fs File system
+ * @param path File path
+ * @param contentBytes Receives the bytes before any trailer (may be nullptr)
+ * @return AtomicFileState what the file's end says
+ */
+AtomicFileState EARS_atomicFile::inspect(EARS_fsPort& fs, const char* path, uint32_t* contentBytes) {
+    if (!fs.fileExists(path)) {
+        if (contentBytes) {
+            *contentBytes = 0;
+        }
+        return AtomicFileState::MISSING;
+    }
+
+    // Hash everything but the last TRAILER_BYTES seen, which stay in window
+    uint8_t window[CHECK_CHUNK_BYTES + TRAILER_BYTES];
+    size_t held = 0;
+    uint32_t offset = 0;
+    EARS_atomicFile seal;
+    for (;;) {
+        size_t got = fs.readFileAt(path, offset, window + held, CHECK_CHUNK_BYTES);
+        offset += (uint32_t)got;
+        held += got;
+        if (held > TRAILER_BYTES) {
+            size_t hashed = held - TRAILER_BYTES;
+            seal.add(window, hashed);
+            memmove(window, window + hashed, TRAILER_BYTES);
+            held = TRAILER_BYTES;
+        }
+        if (got < CHECK_CHUNK_BYTES) {
+            break;
+        }
+    }
+
+    uint32_t length;
+    uint32_t check;
+    if (held < TRAILER_BYTES || !decodeTrailer(window, length, check)) {
+        if (contentBytes) {
+            *contentBytes = offset;
+        }
+        return AtomicFileState::PLAIN;
+    }
+    if (contentBytes) {
+        *contentBytes = seal.length();
+    }
+    return length == seal.length() && check == seal._check ?
+        AtomicFileState::SEALED : AtomicFileState::DAMAGED;
+}
+
+/**
+ * @brief Finish or undo a write interrupted by a reset
+ * @param fs File system
+ * @param path Target path
+ * @return AtomicRecovery what was found and done
+ */
+AtomicRecovery EARS_atomicFile::recover(EARS_fsPort& fs, const char* path) {
+    char temp[EARS_FS_PORT_MAX_PATH];
+    if (!tempPath(path, temp, sizeof(temp))) {
+        return AtomicRecovery::FAILED;
+    }
+    if (!fs.fileExists(temp)) {
+        return AtomicRecovery::NONE;
+    }
+
+    if (inspect(fs, temp, nullptr) == AtomicFileState::SEALED) {
+        // Cut between sealing and the rename: finish the write
+        if (fs.fileExists(path) && !fs.removeFile(path)) {
+            return AtomicRecovery::FAILED;
+        }
+        return fs.renameFile(temp, path) ? AtomicRecovery::COMPLETED : AtomicRecovery::FAILED;
+    }
+
+    // Cut while writing: the old file was never touched
+    if (!fs.fileExists(path)) {
+        return AtomicRecovery::FAILED;
+    }
+    return fs.removeFile(temp) ? AtomicRecovery::DISCARDED : AtomicRecovery::FAILED;
+}
+
+/****************************************************************************
+ * End of EARS_atomicFile.cpp
+ ***************************************************************************/
@@ -0,0 +1,175 @@
+/**
+ * @file EARS_atomicFile.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Replace a file all at once: temporary file, checksum, rename
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * Overwriting a file in place leaves it truncated or half written if the
+ * power goes mid-write. Here the new contents go to "<path>.tmp", sealed by
+ * a trailer with their length and checksum; only then is the old file
+ * removed and the temporary one renamed over it. FAT cannot rename onto an
+ * existing name, so the remove stands where the truncating open was and the
+ * rename is the only extra operation.
+ *
+ * The trailer is one text line after the contents:
+ *   "\n#EAW1 LLLLLLLL CCCCCCCC\n"
+ * with the length and FNV-1a checksum of the contents in hex. JSON parsers
+ * stop at the end of the document and never see it. A file without a
+ * trailer (shipped or edited by hand) is still read as a whole.
+ *
+ * After a power cut, recover() finishes or undoes the interrupted write:
+ * - temporary file sealed: it replaces the file (remove if needed, rename)
+ * - temporary file unsealed and the file present: the temporary is removed
+ * - temporary file unsealed and the file missing: cannot happen with ordered
+ *   writes; nothing is touched and FAILED is returned
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_ATOMIC_FILE_H__
+#define __EARS_ATOMIC_FILE_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "EARS_fsPortLib.h"
+
+// Trailer line prefix and temporary file suffix
+#define EARS_ATOMIC_MAGIC "#EAW1 "
+#define EARS_ATOMIC_SUFFIX ".tmp"
+
+/**
+ * @brief What a file's end says about its contents
+ */
+enum class AtomicFileState : uint8_t {
+    MISSING,    // No such file
+    PLAIN,      // No trailer: written some other way, or cut before sealing
+    SEALED,     // Trailer matches the contents
+    DAMAGED     // Trailer present but length or checksum disagree
+};
+
+/**
+ * @brief What recover() found and did
+ */
+enum class AtomicRecovery : uint8_t {
+    NONE,       // No temporary file
+    DISCARDED,  // Unfinished temporary file removed, old file kept
+    COMPLETED,  // Sealed temporary file moved over the old one
+    FAILED      // Remove/rename failed, or neither file is usable
+};
+
+/**
+ * @brief Running length and checksum of contents being written, and the
+ *        static helpers that write, inspect and recover sealed files
+ */
+class EARS_atomicFile {
+public:
+    // "\n" + magic + 8 hex + " " + 8 hex + "\n"
+    static const size_t TRAILER_BYTES = 25;
+    // Read chunk used when checking a file
+    static const size_t CHECK_CHUNK_BYTES = 256;
+
+    EARS_atomicFile();
+
+    /**
+     * @brief Fold written contents into the seal
+     * @param data Bytes just written
+     * @param length Number of bytes
+     * @return void
+     */
+    void add(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Contents length so far
+     * @return uint32_t bytes added
+     */
+    uint32_t length() const { return _length; }
+
+    /**
+     * @brief Contents checksum so far (FNV-1a)
+     * @return uint32_t checksum, as written in the trailer
+     */
+    uint32_t check() const { return _check; }
+
+    /**
+     * @brief Encode the trailer for the contents added so far
+     * @param out At least TRAILER_BYTES + 1 (a terminator is written)
+     * @return size_t TRAILER_BYTES
+     */
+    size_t trailer(char* out) const;
+
+    /**
+     * @brief Temporary file path for a target
+     * @param path Target path
+     * @param out Receives "<path>.tmp"
+     * @param outBytes Size of out
+     * @return true if it fitted
+     */
+    static bool tempPath(const char* path, char* out, size_t outBytes);
+
+    /**
+     * @brief Replace a file with new contents through a sealed temporary file
+     * @param fs File system
+     * @param path Target path
+     * @param data New contents
+     * @param length Number of bytes
+     * @return true if path now holds the new contents
+     * @return false if a step failed; path holds the old or the new contents
+     */
+    static bool write(EARS_fsPort& fs, const char* path, const uint8_t* data, size_t length);
+
+    /**
+     * @brief Move a sealed temporary file over its target
+     * @param fs File system
+     * @param path Target path; "<path>.tmp" must be complete and sealed
+     * @return true if renamed
+     *
+     * For writers that produce the temporary file themselves (streams)
+     */
+    static bool commit(EARS_fsPort& fs, const char* path);
+
+    /**
+     * @brief Check a file's trailer against its contents
+     * @param fs File system
+     * @param path File path
+     * @param contentBytes Receives the bytes before any trailer (may be nullptr)
+     * @return AtomicFileState what the file's end says
+     *
+     * Reads the whole file in CHECK_CHUNK_BYTES pieces, no heap use
+     */
+    static AtomicFileState inspect(EARS_fsPort& fs, const char* path, uint32_t* contentBytes);
+
+    /**
+     * @brief Finish or undo a write interrupted by a reset, call at boot
+     * @param fs File system
+     * @param path Target path
+     * @return AtomicRecovery what was found and done
+     *
+     * Costs one existence check when nothing was interrupted.
+     */
+    static AtomicRecovery recover(EARS_fsPort& fs, const char* path);
+
+    /**
+     * @brief Decode a trailer
+     * @param in TRAILER_BYTES from the end of a file
+     * @param length Receives the contents length
+     * @param check Receives the contents checksum
+     * @return true if in is a well formed trailer
+     */
+    static bool decodeTrailer(const uint8_t* in, uint32_t& length, uint32_t& check);
+
+private:
+    uint32_t _length;
+    uint32_t _check;
+};
+
+#endif // __EARS_ATOMIC_FILE_H__
+
+/****************************************************************************
+ * End of EARS_atomicFile.h
+ ***************************************************************************/
@@ -0,0 +1,147 @@
+/**
+ * @file EARS_dirWalker.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Iterative directory tree walk with a bounded stack
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_dirWalker.h"
+#include <string.h>
+
+/**
+ * @brief Check a name against a suffix filter
+ * @param name Entry name
+ * @param suffix Suffix, nullptr or "" matches everything
+ * @return true if name ends in suffix
+ */
+bool EARS_dirWalker::matchesSuffix(const char* name, const char* suffix) {
+    if (!suffix || !suffix[0]) {
+        return true;
+    }
+    size_t nameLength = strlen(name);
+    size_t suffixLength = strlen(suffix);
+    return nameLength >= suffixLength && strcmp(name + nameLength - suffixLength, suffix) == 0;
+}
+
+/**
+ * @brief Walk a directory tree, parents before their contents
+ * @param reader Directory lister
+ * @param root Directory to walk
+ * @param options Filters and depth limit
+ * @param visitor Called for each entry passing the filters
+ * @param context Passed to visitor unchanged
+ * @return WalkStats what the walk did; complete is false if root could not be opened
+ */
+WalkStats EARS_dirWalker::walk(EARS_dirReader& reader, const char* root, const WalkOptions& options,
+                               DirVisitor visitor, void* context) {
+    WalkStats stats;
+
+    // One level per open directory: where its path ends and where its listing stopped
+    struct Frame {
+        uint16_t pathLength;
+        long position;
+    };
+    Frame stack[MAX_DEPTH + 1];
+    char path[PATH_BYTES];
+
+    size_t rootLength = strlen(root);
+    if (rootLength > 1 && root[rootLength - 1] == '/') {
+        rootLength--;
+    }
+    if (rootLength == 0 || rootLength >= PATH_BYTES || !reader.openDirectory(root)) {
+        stats.complete = false;
+        return stats;
+    }
+    memcpy(path, root, rootLength);
+    path[rootLength] = '\0';
+    stats.directories++;
+
+    uint8_t depth = 0;
+    stack[0].pathLength = (uint16_t)rootLength;
+    uint8_t maxDepth = options.maxDepth < MAX_DEPTH ? options.maxDepth : MAX_DEPTH;
+
+    for (;;) {
+        size_t dirLength = stack[depth].pathLength;
+        // The root "/" already ends in a separator
+        size_t nameStart = (dirLength == 1 && path[0] == '/') ? 1 : dirLength + 1;
+
+        DirEntry entry;
+        if (nameStart >= PATH_BYTES ||
+            !reader.nextEntry(entry, path + nameStart, PATH_BYTES - nameStart)) {
+            // Listing finished, back to the parent where it stopped
+            reader.closeDirectory();
+            if (depth == 0) {
+                break;
+            }
+            depth--;
+            path[stack[depth].pathLength] = '\0';
+            if (!reader.openDirectory(path)) {
+                stats.complete = false;
+                break;
+            }
+            reader.seekDirectory(stack[depth].position);
+            continue;
+        }
+        stats.entries++;
+
+        size_t nameLength = strlen(path + nameStart);
+        if (nameStart + nameLength + 1 >= PATH_BYTES) {
+            // The reader filled the buffer: the name was cut short
+            stats.tooLong++;
+            path[dirLength] = '\0';
+            continue;
+        }
+        path[nameStart - 1] = '/';
+        entry.path = path;
+        entry.name = path + nameStart;
+        entry.depth = depth;
+
+        WalkAction action = WalkAction::CONTINUE;
+        if ((options.types & (uint8_t)entry.type) && matchesSuffix(entry.name, options.suffix)) {
+            stats.visited++;
+            action = visitor(entry, context);
+        }
+        if (action == WalkAction::STOP) {
+            stats.stopped = true;
+            reader.closeDirectory();
+            break;
+        }
+
+        if (entry.type == DirEntryType::DIRECTORY && action != WalkAction::SKIP) {
+            if (depth < maxDepth) {
+                // Remember the parent's place, then list the child instead
+                stack[depth].position = reader.tellDirectory();
+                reader.closeDirectory();
+                if (reader.openDirectory(path)) {
+                    depth++;
+                    stack[depth].pathLength = (uint16_t)(nameStart + nameLength);
+                    stats.directories++;
+                    continue;
+                }
+                stats.complete = false;
+                path[dirLength] = '\0';
+                if (!reader.openDirectory(path)) {
+                    break;
+                }
+                reader.seekDirectory(stack[depth].position);
+                continue;
+            }
+            if (depth < options.maxDepth) {
+                // Wanted, but deeper than the stack allows
+                stats.tooDeep++;
+            }
+        }
+        path[dirLength] = '\0';
+    }
+    return stats;
+}
+
+/****************************************************************************
+ * End of EARS_dirWalker.cpp
+ ***************************************************************************/
@@ -0,0 +1,181 @@
+/**
+ * @file EARS_dirWalker.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Iterative directory tree walk with a bounded stack
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * EARS_dirWalker visits a directory tree without recursion or allocation:
+ * the current path lives in one fixed buffer and each level only remembers
+ * where its name ends and where its listing stopped. Just one directory is
+ * open at a time; returning from a subdirectory reopens the parent and
+ * seeks back, so a walk never competes with the card's open file limit.
+ *
+ * Entries reach a visitor as DirEntry (path, size, type, modification
+ * time). The visitor can skip a subdirectory or stop the walk; type, name
+ * suffix and depth filters decide which entries it sees. A visitor may
+ * remove the entry it was given; other changes to the tree during a walk
+ * can make the walk miss entries.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_DIR_WALKER_H__
+#define __EARS_DIR_WALKER_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Kind of directory entry, also used as a filter bit
+ */
+enum class DirEntryType : uint8_t {
+    FILE = 0x01,
+    DIRECTORY = 0x02
+};
+
+// WalkOptions::types values
+#define EARS_WALK_FILES         0x01
+#define EARS_WALK_DIRECTORIES   0x02
+#define EARS_WALK_ALL           0x03
+
+/**
+ * @brief One directory entry
+ */
+struct DirEntry {
+    const char* path;       // Full path, valid during the visit only
+    const char* name;       // Last component of path
+    DirEntryType type;
+    uint32_t size;          // Bytes, 0 for directories
+    uint32_t modified;      // Seconds since 1970, 0 if unknown
+    uint8_t depth;          // 0 = directly in the walked directory
+};
+
+/**
+ * @brief What the walk does after a visit
+ */
+enum class WalkAction : uint8_t {
+    CONTINUE,   // Go on, descending into a visited directory
+    SKIP,       // Go on without descending into this directory
+    STOP        // End the walk
+};
+
+/**
+ * @brief Visits one entry
+ * @param entry Entry that passed the filters
+ * @param context Caller context
+ * @return WalkAction how to go on
+ */
+typedef WalkAction (*DirVisitor)(const DirEntry& entry, void* context);
+
+/**
+ * @brief Lists one directory at a time for EARS_dirWalker
+ */
+class EARS_dirReader {
+public:
+    virtual ~EARS_dirReader() {}
+
+    /**
+     * @brief Open a directory, closing any open one
+     * @param path Directory path
+     * @return true if opened
+     */
+    virtual bool openDirectory(const char* path) = 0;
+
+    /**
+     * @brief Read the next entry ("." and ".." are skipped)
+     * @param entry Receives type, size and modified time
+     * @param name Receives the entry name
+     * @param nameBytes Size of name
+     * @return true if an entry was read, false at the end
+     */
+    virtual bool nextEntry(DirEntry& entry, char* name, size_t nameBytes) = 0;
+
+    /**
+     * @brief Listing position, for seekDirectory() after a reopen
+     * @return long opaque position
+     */
+    virtual long tellDirectory() = 0;
+
+    /**
+     * @brief Continue a listing where tellDirectory() was called
+     * @param position Value from tellDirectory() on the same directory
+     * @return void
+     */
+    virtual void seekDirectory(long position) = 0;
+
+    /**
+     * @brief Close the open directory
+     * @return void
+     */
+    virtual void closeDirectory() = 0;
+};
+
+/**
+ * @brief Which entries a walk reports
+ */
+struct WalkOptions {
+    uint8_t maxDepth;       // Deepest level reported, 0 = the directory itself only
+    uint8_t types;          // EARS_WALK_FILES / EARS_WALK_DIRECTORIES
+    const char* suffix;     // Report only names ending in this (e.g. ".log"), nullptr = all
+
+    WalkOptions() : maxDepth(0), types(EARS_WALK_ALL), suffix(nullptr) {}
+};
+
+/**
+ * @brief What a walk did
+ */
+struct WalkStats {
+    uint32_t visited;       // Entries handed to the visitor
+    uint32_t entries;       // Entries read, filtered or not
+    uint32_t directories;   // Directories opened
+    uint32_t tooLong;       // Entries left out, path longer than PATH_BYTES
+    uint32_t tooDeep;       // Directories not entered, beyond MAX_DEPTH
+    bool stopped;           // The visitor returned STOP
+    bool complete;          // Every directory could be opened
+
+    WalkStats() : visited(0), entries(0), directories(0), tooLong(0), tooDeep(0),
+                  stopped(false), complete(true) {}
+};
+
+/**
+ * @brief Walks a tree through an EARS_dirReader
+ */
+class EARS_dirWalker {
+public:
+    // Levels below the walked directory
+    static const uint8_t MAX_DEPTH = 8;
+    // Longest path plus terminator
+    static const size_t PATH_BYTES = 128;
+
+    /**
+     * @brief Walk a directory tree, parents before their contents
+     * @param reader Directory lister
+     * @param root Directory to walk
+     * @param options Filters and depth limit
+     * @param visitor Called for each entry passing the filters
+     * @param context Passed to visitor unchanged
+     * @return WalkStats what the walk did; complete is false if root could not be opened
+     */
+    static WalkStats walk(EARS_dirReader& reader, const char* root, const WalkOptions& options,
+                          DirVisitor visitor, void* context);
+
+    /**
+     * @brief Check a name against a suffix filter
+     * @param name Entry name
+     * @param suffix Suffix, nullptr or "" matches everything
+     * @return true if name ends in suffix
+     */
+    static bool matchesSuffix(const char* name, const char* suffix);
+};
+
+#endif // __EARS_DIR_WALKER_H__
+
+/****************************************************************************
+ * End of EARS_dirWalker.h
+ ***************************************************************************/
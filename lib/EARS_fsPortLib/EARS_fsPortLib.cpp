@@ -0,0 +1,76 @@
+/**
+ * @file EARS_fsPortLib.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Minimal file system interface shared by the SD card and host stand-ins
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_fsPortLib.h"
+#include <stdio.h>
+
+/**
+ * @brief Build "basePath.index" into buffer
+ * @param buffer Destination, EARS_FS_PORT_MAX_PATH bytes
+ * @param basePath Active file path
+ * @param index Generation number
+ * @return true if the path fitted
+ */
+static bool generationPath(char* buffer, const char* basePath, unsigned index) {
+    int length = snprintf(buffer, EARS_FS_PORT_MAX_PATH, "%s.%u", basePath, index);
+    return length > 0 && length < EARS_FS_PORT_MAX_PATH;
+}
+
+/**
+ * @brief Shift numbered generations of a file by renaming only
+ * @param fs File system
+ * @param basePath Active file path
+ * @param generations Number of numbered generations to keep
+ * @return true if basePath no longer exists (rotation complete)
+ * @return false if a rename failed; basePath is left untouched
+ */
+bool EARS_rotateGenerations(EARS_fsPort& fs, const char* basePath, uint8_t generations) {
+    if (generations == 0) {
+        // No history kept - start over
+        return !fs.fileExists(basePath) || fs.removeFile(basePath);
+    }
+
+    char fromPath[EARS_FS_PORT_MAX_PATH];
+    char toPath[EARS_FS_PORT_MAX_PATH];
+
+    // Drop the oldest generation (the only data rotation discards)
+    if (!generationPath(toPath, basePath, generations)) {
+        return false;
+    }
+    if (fs.fileExists(toPath) && !fs.removeFile(toPath)) {
+        return false;
+    }
+
+    // Shift base.(i) -> base.(i+1), oldest first so targets are always free
+    for (unsigned i = generations - 1; i >= 1; i--) {
+        if (!generationPath(fromPath, basePath, i) || !generationPath(toPath, basePath, i + 1)) {
+            return false;
+        }
+        if (fs.fileExists(fromPath) && !fs.renameFile(fromPath, toPath)) {
+            return false;
+        }
+    }
+
+    // Active file becomes generation 1; the next append creates a new one
+    if (!generationPath(toPath, basePath, 1)) {
+        return false;
+    }
+    if (fs.fileExists(basePath) && !fs.renameFile(basePath, toPath)) {
+        return false;
+    }
+    return true;
+}
+
+/*****************************************************************************
+ * End of EARS_fsPortLib.cpp
+ ****************************************************************************/
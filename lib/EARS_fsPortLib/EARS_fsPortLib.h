@@ -0,0 +1,143 @@
+/**
+ * @file EARS_fsPortLib.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Minimal file system interface shared by the SD card and host stand-ins
+ * @version 1.3.0
+ * @date 20261016
+ *
+ * @details
+ * EARS_fsPort names its operations after the EARS_sdCard API so the SD card
+ * class implements it directly. File algorithms written against it (log
+ * rotation, ...) run unchanged on the device and against EARS_memFs in host
+ * tests.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_FS_PORT_LIB_H__
+#define __EARS_FS_PORT_LIB_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief File system operations used by portable algorithms
+ */
+class EARS_fsPort {
+public:
+    virtual ~EARS_fsPort() {}
+
+    /**
+     * @brief Check if file exists
+     * @param path File path
+     * @return true if a regular file exists at path
+     */
+    virtual bool fileExists(const char* path) = 0;
+
+    /**
+     * @brief Remove a file
+     * @param path File path
+     * @return true if file removed
+     */
+    virtual bool removeFile(const char* path) = 0;
+
+    /**
+     * @brief Rename a file without copying its data
+     * @param fromPath Existing file path
+     * @param toPath New path, must not exist
+     * @return true if renamed
+     */
+    virtual bool renameFile(const char* fromPath, const char* toPath) = 0;
+
+    /**
+     * @brief Read part of a file
+     * @param path File path
+     * @param offset Byte offset to start at
+     * @param buffer Destination
+     * @param length Bytes wanted
+     * @return size_t bytes read, less than length at the end of the file, 0 if missing
+     */
+    virtual size_t readFileAt(const char* path, uint32_t offset, uint8_t* buffer, size_t length) = 0;
+
+    /**
+     * @brief Append bytes to a file, creating it if needed
+     * @param path File path
+     * @param data Bytes to append
+     * @param length Number of bytes
+     * @return true if all bytes were written
+     */
+    virtual bool appendFile(const char* path, const uint8_t* data, size_t length) = 0;
+
+    /**
+     * @brief Create or replace a file of a fixed size in one allocation
+     * @param path File path
+     * @param bytes File size; the contents are undefined
+     * @return true if the file now has that size, false if unsupported or failed
+     *
+     * Optional; gives the file contiguous clusters where the file system can.
+     */
+    virtual bool preallocateFile(const char* path, uint32_t bytes) {
+        (void)path;
+        (void)bytes;
+        return false;
+    }
+
+    /**
+     * @brief Overwrite part of an existing file
+     * @param path File path
+     * @param offset Byte offset to start at
+     * @param data Bytes to write
+     * @param length Number of bytes
+     * @return true if all bytes were written, false if unsupported or failed
+     *
+     * Optional; writes past the end grow the file.
+     */
+    virtual bool writeFileAt(const char* path, uint32_t offset, const uint8_t* data, size_t length) {
+        (void)path;
+        (void)offset;
+        (void)data;
+        (void)length;
+        return false;
+    }
+
+    /**
+     * @brief Commit a file's buffered writes to the medium
+     * @param path File path
+     * @return true if nothing of the file is left in buffers
+     *
+     * Optional; implementations that never buffer keep the default.
+     */
+    virtual bool syncFile(const char* path) {
+        (void)path;
+        return true;
+    }
+};
+
+// Longest path the portable helpers build (base path + ".NNN" suffix)
+#define EARS_FS_PORT_MAX_PATH 128
+
+/**
+ * @brief Shift numbered generations of a file by renaming only
+ *
+ * base.N is removed, base.(i) becomes base.(i+1) for i = N-1..1 and base
+ * becomes base.1. No file data is read or written, and the active file is
+ * never removed: a power cut at any step leaves every surviving generation
+ * under exactly one name, and the next call simply carries on.
+ *
+ * @param fs File system
+ * @param basePath Active file path, e.g. "/logs/debug.log"
+ * @param generations Number of numbered generations to keep (1-255)
+ * @return true if basePath no longer exists (rotation complete)
+ * @return false if a rename failed; basePath is left untouched
+ */
+bool EARS_rotateGenerations(EARS_fsPort& fs, const char* basePath, uint8_t generations);
+
+#endif // __EARS_FS_PORT_LIB_H__
+
+/****************************************************************************
+ * End of EARS_fsPortLib.h
+ ***************************************************************************/
@@ -0,0 +1,250 @@
+/**
+ * @file EARS_handlePool.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Small LRU pool of open file handles keyed by path
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_handlePool.h"
+#include <string.h>
+
+/**
+ * @brief Construct an unconfigured pool
+ */
+EARS_handlePool::EARS_handlePool()
+    : _owner(nullptr), _handles(0), _maxDirtyMs(0), _useClock(0) {
+    for (uint8_t i = 0; i < MAX_HANDLES; i++) {
+        _slots[i].path[0] = '\0';
+        _slots[i].open = false;
+        _slots[i].dirty = false;
+        _slots[i].lastUse = 0;
+        _slots[i].dirtySinceMs = 0;
+    }
+}
+
+/**
+ * @brief Configure the pool
+ * @param owner Handle owner
+ * @param handles Handles kept open (1 - MAX_HANDLES)
+ * @param maxDirtyMs Longest a write stays unflushed once flushExpired() runs
+ * @return true if the configuration is valid
+ */
+bool EARS_handlePool::begin(EARS_handleOwner* owner, uint8_t handles, uint32_t maxDirtyMs) {
+    if (!owner || handles == 0 || handles > MAX_HANDLES) {
+        return false;
+    }
+    closeAll();
+    _owner = owner;
+    _handles = handles;
+    _maxDirtyMs = maxDirtyMs;
+    return true;
+}
+
+/**
+ * @brief Get an open handle for path, opening it if needed
+ * @param path File path
+ * @param truncate true to reopen the file emptied, false to append
+ * @return int slot index, -1 if the file could not be opened
+ */
+int EARS_handlePool::acquire(const char* path, bool truncate) {
+    if (!_owner || !path || strlen(path) >= EARS_FS_PORT_MAX_PATH) {
+        return -1;
+    }
+
+    int slot = find(path);
+    if (slot >= 0 && !truncate) {
+        _stats.hits++;
+        _slots[slot].lastUse = ++_useClock;
+        return slot;
+    }
+
+    if (slot >= 0) {
+        // Truncating needs a fresh open of the same file
+        closeSlot((uint8_t)slot);
+    } else {
+        // A free slot, else the least recently used one
+        for (uint8_t i = 0; i < _handles; i++) {
+            if (!_slots[i].open) {
+                slot = i;
+                break;
+            }
+            if (slot < 0 || _slots[i].lastUse < _slots[slot].lastUse) {
+                slot = i;
+            }
+        }
+        if (_slots[slot].open) {
+            _stats.evictions++;
+            closeSlot((uint8_t)slot);
+        }
+    }
+
+    if (!_owner->openHandle((uint8_t)slot, path, truncate)) {
+        return -1;
+    }
+    _stats.opens++;
+    Slot& entry = _slots[slot];
+    strcpy(entry.path, path);
+    entry.open = true;
+    entry.dirty = false;
+    entry.lastUse = ++_useClock;
+    return slot;
+}
+
+/**
+ * @brief Record a write to a slot
+ * @param slot Slot from acquire()
+ * @param nowMs Current time in milliseconds
+ * @return void
+ */
+void EARS_handlePool::markDirty(uint8_t slot, uint32_t nowMs) {
+    if (slot >= _handles || !_slots[slot].open || _slots[slot].dirty) {
+        return;
+    }
+    _slots[slot].dirty = true;
+    _slots[slot].dirtySinceMs = nowMs;
+}
+
+/**
+ * @brief Flush path's handle if it is open and dirty
+ * @param path File path
+ * @return true unless the flush failed
+ */
+bool EARS_handlePool::flush(const char* path) {
+    int slot = find(path);
+    return slot < 0 || flushSlot((uint8_t)slot);
+}
+
+/**
+ * @brief Close path's handle if it is open
+ * @param path File path
+ * @return void
+ */
+void EARS_handlePool::close(const char* path) {
+    int slot = find(path);
+    if (slot >= 0) {
+        closeSlot((uint8_t)slot);
+    }
+}
+
+/**
+ * @brief Flush every dirty handle
+ * @return true unless a flush failed
+ */
+bool EARS_handlePool::flushAll() {
+    bool ok = true;
+    for (uint8_t i = 0; i < _handles; i++) {
+        if (_slots[i].open && !flushSlot(i)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Flush handles dirty for maxDirtyMs or longer
+ * @param nowMs Current time in milliseconds
+ * @return uint8_t handles flushed
+ */
+uint8_t EARS_handlePool::flushExpired(uint32_t nowMs) {
+    uint8_t flushed = 0;
+    for (uint8_t i = 0; i < _handles; i++) {
+        // Unsigned difference stays right across the millis() wrap
+        if (_slots[i].open && _slots[i].dirty && nowMs - _slots[i].dirtySinceMs >= _maxDirtyMs) {
+            flushSlot(i);
+            flushed++;
+        }
+    }
+    return flushed;
+}
+
+/**
+ * @brief Close every handle
+ * @return void
+ */
+void EARS_handlePool::closeAll() {
+    for (uint8_t i = 0; i < _handles; i++) {
+        if (_slots[i].open) {
+            closeSlot(i);
+        }
+    }
+}
+
+/**
+ * @brief Number of open handles
+ * @return uint8_t open handles
+ */
+uint8_t EARS_handlePool::openCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < _handles; i++) {
+        if (_slots[i].open) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Check for unflushed writes
+ * @return true if any handle is dirty
+ */
+bool EARS_handlePool::isDirty() const {
+    for (uint8_t i = 0; i < _handles; i++) {
+        if (_slots[i].open && _slots[i].dirty) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Find path's slot
+ * @param path File path
+ * @return int slot index, -1 if not open
+ */
+int EARS_handlePool::find(const char* path) const {
+    if (!path) {
+        return -1;
+    }
+    for (uint8_t i = 0; i < _handles; i++) {
+        if (_slots[i].open && strcmp(_slots[i].path, path) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Flush a slot if dirty
+ * @param slot Open slot
+ * @return true unless the flush failed
+ */
+bool EARS_handlePool::flushSlot(uint8_t slot) {
+    if (!_slots[slot].dirty) {
+        return true;
+    }
+    _slots[slot].dirty = false;
+    _stats.flushes++;
+    return _owner->flushHandle(slot);
+}
+
+/**
+ * @brief Close a slot's handle and free it
+ * @param slot Open slot
+ * @return void
+ */
+void EARS_handlePool::closeSlot(uint8_t slot) {
+    _owner->closeHandle(slot);
+    _slots[slot].open = false;
+    _slots[slot].dirty = false;
+    _slots[slot].path[0] = '\0';
+}
+
+/****************************************************************************
+ * End of EARS_handlePool.cpp
+ ***************************************************************************/
@@ -0,0 +1,209 @@
+/**
+ * @file EARS_handlePool.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Small LRU pool of open file handles keyed by path
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @details
+ * Opening and closing a file on the SD card costs far more than appending a
+ * log line to it. EARS_handlePool keeps the most recently used files open
+ * and only does the bookkeeping: which slot holds which path, which slots
+ * have unflushed writes and since when. The real handles live with the
+ * owner (EARS_sdCard keeps a File per slot), which the pool calls to open,
+ * flush and close them. Not thread safe; the owner serializes calls.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_HANDLE_POOL_H__
+#define __EARS_HANDLE_POOL_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "EARS_fsPortLib.h"
+
+/**
+ * @brief Opens, flushes and closes the real handles behind a pool
+ */
+class EARS_handleOwner {
+public:
+    virtual ~EARS_handleOwner() {}
+
+    /**
+     * @brief Open path into a slot
+     * @param slot Slot index, free until this call
+     * @param path File path
+     * @param truncate true to empty the file, false to append
+     * @return true if the handle is open
+     */
+    virtual bool openHandle(uint8_t slot, const char* path, bool truncate) = 0;
+
+    /**
+     * @brief Commit a slot's buffered writes to the card
+     * @param slot Open slot
+     * @return true if flushed
+     */
+    virtual bool flushHandle(uint8_t slot) = 0;
+
+    /**
+     * @brief Close a slot's handle (which also flushes it)
+     * @param slot Open slot
+     * @return void
+     */
+    virtual void closeHandle(uint8_t slot) = 0;
+};
+
+/**
+ * @brief Pool counters
+ */
+struct HandlePoolStats {
+    uint32_t hits;          // acquire() found the file already open
+    uint32_t opens;         // Handles opened
+    uint32_t evictions;     // Handles closed to make room
+    uint32_t flushes;       // Dirty handles flushed
+
+    HandlePoolStats() : hits(0), opens(0), evictions(0), flushes(0) {}
+};
+
+/**
+ * @brief LRU pool of open handles with a bound on unflushed time
+ */
+class EARS_handlePool {
+public:
+    static const uint8_t MAX_HANDLES = 4;
+
+    EARS_handlePool();
+
+    /**
+     * @brief Configure the pool
+     * @param owner Handle owner
+     * @param handles Handles kept open (1 - MAX_HANDLES)
+     * @param maxDirtyMs Longest a write stays unflushed once flushExpired() runs
+     * @return true if the configuration is valid
+     */
+    bool begin(EARS_handleOwner* owner, uint8_t handles, uint32_t maxDirtyMs);
+
+    /**
+     * @brief Get an open handle for path, opening it if needed
+     * @param path File path
+     * @param truncate true to reopen the file emptied (writeFile), false to append
+     * @return int slot index, -1 if the file could not be opened
+     *
+     * When all slots are in use the least recently used one is closed.
+     */
+    int acquire(const char* path, bool truncate);
+
+    /**
+     * @brief Find path's slot without opening it
+     * @param path File path
+     * @return int slot index, -1 if not open
+     */
+    int slotOf(const char* path) const { return find(path); }
+
+    /**
+     * @brief Record a write to a slot
+     * @param slot Slot from acquire()
+     * @param nowMs Current time in milliseconds
+     * @return void
+     */
+    void markDirty(uint8_t slot, uint32_t nowMs);
+
+    /**
+     * @brief Flush path's handle if it is open and dirty
+     * @param path File path
+     * @return true unless the flush failed
+     *
+     * Call before anything else opens or measures the file.
+     */
+    bool flush(const char* path);
+
+    /**
+     * @brief Close path's handle if it is open
+     * @param path File path
+     * @return void
+     *
+     * Call before the file is removed or renamed.
+     */
+    void close(const char* path);
+
+    /**
+     * @brief Flush every dirty handle
+     * @return true unless a flush failed
+     */
+    bool flushAll();
+
+    /**
+     * @brief Flush handles dirty for maxDirtyMs or longer
+     * @param nowMs Current time in milliseconds
+     * @return uint8_t handles flushed
+     */
+    uint8_t flushExpired(uint32_t nowMs);
+
+    /**
+     * @brief Close every handle, e.g. when the card is removed
+     * @return void
+     */
+    void closeAll();
+
+    /**
+     * @brief Number of open handles
+     * @return uint8_t open handles
+     */
+    uint8_t openCount() const;
+
+    /**
+     * @brief Check for unflushed writes
+     * @return true if any handle is dirty
+     */
+    bool isDirty() const;
+
+    HandlePoolStats getStats() const { return _stats; }
+
+private:
+    struct Slot {
+        char path[EARS_FS_PORT_MAX_PATH];
+        bool open;
+        bool dirty;
+        uint32_t lastUse;       // _useClock value, larger = more recent
+        uint32_t dirtySinceMs;  // First unflushed write
+    };
+
+    EARS_handleOwner* _owner;
+    uint8_t _handles;
+    uint32_t _maxDirtyMs;
+    uint32_t _useClock;
+    Slot _slots[MAX_HANDLES];
+    HandlePoolStats _stats;
+
+    /**
+     * @brief Find path's slot
+     * @param path File path
+     * @return int slot index, -1 if not open
+     */
+    int find(const char* path) const;
+
+    /**
+     * @brief Flush a slot if dirty
+     * @param slot Open slot
+     * @return true unless the flush failed
+     */
+    bool flushSlot(uint8_t slot);
+
+    /**
+     * @brief Close a slot's handle and free it
+     * @param slot Open slot
+     * @return void
+     */
+    void closeSlot(uint8_t slot);
+};
+
+#endif // __EARS_HANDLE_POOL_H__
+
+/****************************************************************************
+ * End of EARS_handlePool.h
+ ***************************************************************************/
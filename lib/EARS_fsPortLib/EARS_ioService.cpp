@@ -0,0 +1,317 @@
+/**
+ * @file EARS_ioService.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Prioritised file request queue served by a background task
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_ioService.h"
+#include <string.h>
+#include <chrono>
+
+/**
+ * @brief Construct an empty inbox
+ */
+EARS_ioInbox::EARS_ioInbox() : _service(nullptr), _head(-1), _tail(-1), _count(0) {
+}
+
+/**
+ * @brief Run every parked completion on the calling task
+ * @return size_t completions run
+ */
+size_t EARS_ioInbox::dispatch() {
+    if (_count.load() == 0 || !_service) {
+        return 0;
+    }
+    return _service->dispatch(*this);
+}
+
+/**
+ * @brief Construct a service without a device
+ */
+EARS_ioService::EARS_ioService()
+    : _device(nullptr), _queued(0), _sequence(0), _wakeups(0) {
+    for (uint8_t i = 0; i < QUEUE_DEPTH; i++) {
+        _slots[i].state = FREE;
+        _slots[i].next = -1;
+    }
+    for (uint8_t i = 0; i < IO_PRIORITIES; i++) {
+        _skipped[i] = 0;
+    }
+}
+
+/**
+ * @brief Attach the device requests run against
+ * @param device File system
+ * @return true if device is valid
+ */
+bool EARS_ioService::begin(EARS_ioDevice* device) {
+    if (!device) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _device = device;
+    return true;
+}
+
+/**
+ * @brief Queue a request
+ * @param request Request, copied
+ * @return true if queued
+ * @return false if the queue is full, the service is not started or the request is invalid
+ */
+bool EARS_ioService::submit(const IoRequest& request) {
+    size_t pathLength = request.path ? strlen(request.path) : PATH_BYTES;
+    bool needsBuffer = request.op == IoOp::READ || request.op == IoOp::WRITE ||
+                       request.op == IoOp::APPEND || request.op == IoOp::LIST;
+    bool valid = pathLength > 0 && pathLength < PATH_BYTES &&
+                 (uint8_t)request.priority < IO_PRIORITIES &&
+                 (!needsBuffer || request.buffer || request.length == 0);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    int free = -1;
+    for (uint8_t i = 0; i < QUEUE_DEPTH && free < 0; i++) {
+        if (_slots[i].state == FREE) {
+            free = i;
+        }
+    }
+    if (!valid || !_device || free < 0) {
+        _stats.rejected++;
+        return false;
+    }
+
+    Slot& slot = _slots[free];
+    slot.request = request;
+    memcpy(slot.path, request.path, pathLength + 1);
+    slot.request.path = slot.path;
+    slot.sequence = _sequence++;
+    slot.queuedUs = nowUs();
+    slot.next = -1;
+    slot.state = QUEUED;
+    _queued++;
+    _stats.submitted++;
+    _ready.notify_one();
+    return true;
+}
+
+/**
+ * @brief Choose the next request, lock held
+ * @return int slot index, -1 if nothing is queued
+ */
+int EARS_ioService::pick() {
+    // Oldest queued request of each priority
+    int oldest[IO_PRIORITIES] = { -1, -1, -1 };
+    for (uint8_t i = 0; i < QUEUE_DEPTH; i++) {
+        if (_slots[i].state != QUEUED) {
+            continue;
+        }
+        uint8_t priority = (uint8_t)_slots[i].request.priority;
+        if (oldest[priority] < 0 || _slots[i].sequence < _slots[oldest[priority]].sequence) {
+            oldest[priority] = i;
+        }
+    }
+
+    uint8_t chosen = IO_PRIORITIES;
+    for (uint8_t p = 0; p < IO_PRIORITIES && chosen == IO_PRIORITIES; p++) {
+        if (oldest[p] >= 0) {
+            chosen = p;
+        }
+    }
+    if (chosen == IO_PRIORITIES) {
+        return -1;
+    }
+
+    // A priority passed over too often goes next, the lowest first
+    bool promoted = false;
+    for (uint8_t p = IO_PRIORITIES - 1; p > chosen; p--) {
+        if (oldest[p] >= 0 && _skipped[p] >= STARVATION_LIMIT) {
+            chosen = p;
+            promoted = true;
+            break;
+        }
+    }
+    for (uint8_t p = chosen + 1; p < IO_PRIORITIES; p++) {
+        if (oldest[p] >= 0) {
+            _skipped[p]++;
+        }
+    }
+    _skipped[chosen] = 0;
+
+    // Never overtake an earlier request for the same path
+    int index = oldest[chosen];
+    for (uint8_t i = 0; i < QUEUE_DEPTH; i++) {
+        if (_slots[i].state == QUEUED && _slots[i].sequence < _slots[index].sequence &&
+            strcmp(_slots[i].path, _slots[index].path) == 0) {
+            index = i;
+            promoted = true;
+        }
+    }
+    if (promoted) {
+        _stats.promoted++;
+    }
+    return index;
+}
+
+/**
+ * @brief Wait for one request and run it
+ * @param timeoutMs Longest wait for a request
+ * @return true if a request ran
+ */
+bool EARS_ioService::serviceOne(uint32_t timeoutMs) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    uint32_t wakeups = _wakeups;
+    _ready.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                    [&] { return _queued > 0 || _wakeups != wakeups; });
+
+    int index = pick();
+    if (index < 0) {
+        return false;
+    }
+    Slot& slot = _slots[index];
+    slot.state = ACTIVE;
+    _queued--;
+    uint64_t startUs = nowUs();
+    lock.unlock();
+
+    IoRequest& request = slot.request;
+    size_t transferred = 0;
+    bool ok = _device->ioExecute(request.op, slot.path, request.offset,
+                                 request.buffer, request.length, transferred);
+    uint64_t endUs = nowUs();
+
+    IoResult& result = slot.result;
+    result.op = request.op;
+    result.priority = request.priority;
+    result.ok = ok;
+    result.path = slot.path;
+    result.buffer = request.buffer;
+    result.transferred = transferred;
+    result.waitUs = (uint32_t)(startUs - slot.queuedUs);
+    result.serviceUs = (uint32_t)(endUs - startUs);
+
+    lock.lock();
+    uint8_t priority = (uint8_t)request.priority;
+    _stats.completed[priority]++;
+    if (!ok) {
+        _stats.failed[priority]++;
+    }
+    _stats.waitUs[priority] += result.waitUs;
+    if (result.waitUs > _stats.maxWaitUs[priority]) {
+        _stats.maxWaitUs[priority] = result.waitUs;
+    }
+
+    EARS_ioInbox* inbox = request.inbox;
+    if (inbox && request.done) {
+        // Parked until the owner's loop dispatches it
+        slot.state = PARKED;
+        slot.next = -1;
+        if (inbox->_tail >= 0) {
+            _slots[inbox->_tail].next = (int8_t)index;
+        } else {
+            inbox->_head = (int8_t)index;
+        }
+        inbox->_tail = (int8_t)index;
+        inbox->_service = this;
+        inbox->_count++;
+        return true;
+    }
+    lock.unlock();
+
+    if (request.done) {
+        request.done(result, request.context);
+    }
+
+    lock.lock();
+    slot.state = FREE;
+    return true;
+}
+
+/**
+ * @brief Serve requests until stop is set, then finish the queue
+ * @param stop Set by another task, followed by wake()
+ * @return void
+ */
+void EARS_ioService::run(const std::atomic<bool>& stop) {
+    while (!stop.load()) {
+        serviceOne(IDLE_WAIT_MS);
+    }
+    while (serviceOne(0)) {
+    }
+}
+
+/**
+ * @brief Wake a waiting serviceOne()/run() early
+ * @return void
+ */
+void EARS_ioService::wake() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _wakeups++;
+    _ready.notify_all();
+}
+
+/**
+ * @brief Requests waiting for the device
+ * @return size_t count
+ */
+size_t EARS_ioService::queued() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _queued;
+}
+
+/**
+ * @brief Get the service counters
+ * @return IoServiceStats counters
+ */
+IoServiceStats EARS_ioService::getStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+/**
+ * @brief Deliver parked completions of an inbox
+ * @param inbox Inbox
+ * @return size_t completions run
+ */
+size_t EARS_ioService::dispatch(EARS_ioInbox& inbox) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    int8_t index = inbox._head;
+    inbox._head = -1;
+    inbox._tail = -1;
+    lock.unlock();
+
+    // Completions may submit again; their slots are still PARKED meanwhile
+    size_t delivered = 0;
+    while (index >= 0) {
+        Slot& slot = _slots[index];
+        int8_t next = slot.next;
+        slot.request.done(slot.result, slot.request.context);
+
+        lock.lock();
+        slot.state = FREE;
+        inbox._count--;
+        lock.unlock();
+
+        delivered++;
+        index = next;
+    }
+    return delivered;
+}
+
+/**
+ * @brief Monotonic time in microseconds
+ * @return uint64_t microseconds
+ */
+uint64_t EARS_ioService::nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/****************************************************************************
+ * End of EARS_ioService.cpp
+ ***************************************************************************/
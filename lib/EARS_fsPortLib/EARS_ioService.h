@@ -0,0 +1,280 @@
+/**
+ * @file EARS_ioService.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Prioritised file request queue served by a background task
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * Tasks that must not block on the card (the LVGL loop) submit requests
+ * instead of calling the file system. One service task runs them through an
+ * EARS_ioDevice in priority order: CRITICAL (UI images, config) overtakes
+ * NORMAL, which overtakes BULK (log writes). A lower priority that has been
+ * passed over STARVATION_LIMIT times in a row is served next, and a request
+ * never overtakes an earlier one for the same path.
+ *
+ * Completions run on the service task, or are parked in an EARS_ioInbox and
+ * run when its owner calls dispatch() from its own loop.
+ *
+ * Buffers stay owned by the caller and must stay valid until the completion
+ * runs. The service is portable C++11: the device owns a FreeRTOS task that
+ * calls run(), host tests use a std::thread.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_IO_SERVICE_H__
+#define __EARS_IO_SERVICE_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @brief File operation of a request
+ */
+enum class IoOp : uint8_t {
+    READ,       // buffer <- length bytes at offset
+    WRITE,      // Replace the file with buffer
+    APPEND,     // Append buffer
+    REMOVE,     // Remove the file
+    MKDIR,      // Create the directory
+    LIST        // buffer <- entry names, one per line, directories end in '/'
+};
+
+/**
+ * @brief Request priority, CRITICAL first
+ */
+enum class IoPriority : uint8_t {
+    CRITICAL = 0,   // The UI is waiting (images, config)
+    NORMAL = 1,
+    BULK = 2        // Nobody is waiting (log writes, history)
+};
+
+static const uint8_t IO_PRIORITIES = 3;
+
+/**
+ * @brief Runs requests against the real file system
+ */
+class EARS_ioDevice {
+public:
+    virtual ~EARS_ioDevice() {}
+
+    /**
+     * @brief Execute one operation
+     * @param op Operation
+     * @param path File or directory path
+     * @param offset READ offset
+     * @param buffer READ/LIST destination or WRITE/APPEND source
+     * @param length Size of buffer
+     * @param transferred Receives the bytes read, written or listed
+     * @return true if the operation succeeded
+     */
+    virtual bool ioExecute(IoOp op, const char* path, uint32_t offset,
+                           uint8_t* buffer, size_t length, size_t& transferred) = 0;
+};
+
+/**
+ * @brief Outcome of a request, handed to its completion
+ */
+struct IoResult {
+    IoOp op;
+    IoPriority priority;
+    bool ok;
+    const char* path;       // Valid during the completion only
+    uint8_t* buffer;
+    size_t transferred;
+    uint32_t waitUs;        // Queued until the device started it
+    uint32_t serviceUs;     // Time in the device
+};
+
+/**
+ * @brief Completion callback
+ * @param result Outcome
+ * @param context Caller context from the request
+ * @return void
+ */
+typedef void (*IoCompletion)(const IoResult& result, void* context);
+
+class EARS_ioService;
+
+/**
+ * @brief Completions waiting for their owner's loop
+ *
+ * Must outlive every request naming it.
+ */
+class EARS_ioInbox {
+public:
+    EARS_ioInbox();
+
+    /**
+     * @brief Run every parked completion on the calling task
+     * @return size_t completions run
+     */
+    size_t dispatch();
+
+    /**
+     * @brief Completions waiting for dispatch()
+     * @return size_t count
+     */
+    size_t pending() const { return _count.load(); }
+
+private:
+    friend class EARS_ioService;
+    EARS_ioService* _service;
+    int8_t _head;               // Slot indexes, guarded by the service mutex
+    int8_t _tail;
+    std::atomic<size_t> _count;
+};
+
+/**
+ * @brief One file request
+ */
+struct IoRequest {
+    IoOp op;
+    IoPriority priority;
+    const char* path;           // Copied, at most EARS_ioService::PATH_BYTES - 1 characters
+    uint8_t* buffer;            // Caller owned until the completion runs
+    size_t length;
+    uint32_t offset;            // READ only
+    IoCompletion done;          // nullptr for fire and forget
+    void* context;
+    EARS_ioInbox* inbox;        // nullptr runs done on the service task
+
+    IoRequest() : op(IoOp::READ), priority(IoPriority::NORMAL), path(nullptr), buffer(nullptr),
+                  length(0), offset(0), done(nullptr), context(nullptr), inbox(nullptr) {}
+};
+
+/**
+ * @brief Service counters, per priority where indexed
+ */
+struct IoServiceStats {
+    uint32_t submitted;
+    uint32_t rejected;                      // Queue full or invalid
+    uint32_t promoted;                      // Served early against starvation or for path order
+    uint32_t completed[IO_PRIORITIES];
+    uint32_t failed[IO_PRIORITIES];
+    uint64_t waitUs[IO_PRIORITIES];         // Total queueing time
+    uint32_t maxWaitUs[IO_PRIORITIES];
+
+    IoServiceStats() : submitted(0), rejected(0), promoted(0) {
+        for (uint8_t i = 0; i < IO_PRIORITIES; i++) {
+            completed[i] = 0;
+            failed[i] = 0;
+            waitUs[i] = 0;
+            maxWaitUs[i] = 0;
+        }
+    }
+};
+
+/**
+ * @brief Priority queue of file requests and the loop that serves them
+ */
+class EARS_ioService {
+public:
+    // Requests queued or awaiting dispatch at once
+    static const uint8_t QUEUE_DEPTH = 16;
+    // Longest path plus terminator
+    static const size_t PATH_BYTES = 64;
+    // Times a waiting priority may be passed over before it is served
+    static const uint8_t STARVATION_LIMIT = 8;
+    // run() checks its stop flag at least this often
+    static const uint32_t IDLE_WAIT_MS = 100;
+
+    EARS_ioService();
+
+    /**
+     * @brief Attach the device requests run against
+     * @param device File system
+     * @return true if device is valid
+     */
+    bool begin(EARS_ioDevice* device);
+
+    /**
+     * @brief Queue a request
+     * @param request Request, copied
+     * @return true if queued
+     * @return false if the queue is full, the service is not started or the request is invalid
+     */
+    bool submit(const IoRequest& request);
+
+    /**
+     * @brief Wait for one request and run it
+     * @param timeoutMs Longest wait for a request
+     * @return true if a request ran
+     */
+    bool serviceOne(uint32_t timeoutMs);
+
+    /**
+     * @brief Serve requests until stop is set, then finish the queue
+     * @param stop Set by another task, followed by wake()
+     * @return void
+     */
+    void run(const std::atomic<bool>& stop);
+
+    /**
+     * @brief Wake a waiting serviceOne()/run() early
+     * @return void
+     */
+    void wake();
+
+    /**
+     * @brief Requests waiting for the device
+     * @return size_t count
+     */
+    size_t queued();
+
+    IoServiceStats getStats();
+
+private:
+    friend class EARS_ioInbox;
+
+    enum SlotState : uint8_t { FREE, QUEUED, ACTIVE, PARKED };
+
+    struct Slot {
+        IoRequest request;
+        IoResult result;
+        char path[PATH_BYTES];
+        uint32_t sequence;
+        uint64_t queuedUs;
+        int8_t next;            // Inbox list
+        SlotState state;
+    };
+
+    EARS_ioDevice* _device;
+    Slot _slots[QUEUE_DEPTH];
+    size_t _queued;
+    uint32_t _sequence;
+    uint32_t _wakeups;
+    uint8_t _skipped[IO_PRIORITIES];
+    IoServiceStats _stats;
+    std::mutex _mutex;
+    std::condition_variable _ready;
+
+    /**
+     * @brief Choose the next request, lock held
+     * @return int slot index, -1 if nothing is queued
+     */
+    int pick();
+
+    /**
+     * @brief Deliver parked completions of an inbox
+     * @param inbox Inbox
+     * @return size_t completions run
+     */
+    size_t dispatch(EARS_ioInbox& inbox);
+
+    static uint64_t nowUs();
+};
+
+#endif // __EARS_IO_SERVICE_H__
+
+/****************************************************************************
+ * End of EARS_ioService.h
+ ***************************************************************************/
@@ -0,0 +1,151 @@
+/**
+ * @file EARS_lineReader.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Constant-memory chunk and line reading over EARS_fsPort
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_lineReader.h"
+#include <string.h>
+
+/**
+ * @brief Construct a splitter
+ * @param buffer Line buffer, the longest line kept is bufferBytes - 1
+ * @param bufferBytes Size of buffer, at least 2
+ * @param visitor Called for every line
+ * @param context Passed to visitor unchanged
+ */
+EARS_lineSplitter::EARS_lineSplitter(char* buffer, size_t bufferBytes, FsLineVisitor visitor, void* context)
+    : _buffer(buffer), _capacity(bufferBytes > 0 ? bufferBytes - 1 : 0), _length(0),
+      _truncated(false), _stopped(buffer == nullptr || bufferBytes < 2 || visitor == nullptr),
+      _lines(0), _visitor(visitor), _context(context) {
+}
+
+/**
+ * @brief Split the next chunk
+ * @param data Chunk bytes
+ * @param length Number of bytes
+ * @return false once the visitor asked to stop
+ */
+bool EARS_lineSplitter::feed(const uint8_t* data, size_t length) {
+    const uint8_t* end = data + length;
+    while (data < end && !_stopped) {
+        const uint8_t* newline = static_cast<const uint8_t*>(memchr(data, '\n', (size_t)(end - data)));
+        const uint8_t* stop = newline ? newline : end;
+
+        // Copy what fits; the rest of an overlong line is skipped
+        size_t count = (size_t)(stop - data);
+        size_t room = _capacity - _length;
+        if (count > room) {
+            count = room;
+            _truncated = true;
+        }
+        memcpy(_buffer + _length, data, count);
+        _length += count;
+
+        if (!newline) {
+            break;
+        }
+        data = newline + 1;
+        emit();
+    }
+    return !_stopped;
+}
+
+/**
+ * @brief Hand over a last line that had no newline
+ * @return false if the visitor asked to stop
+ */
+bool EARS_lineSplitter::finish() {
+    if (!_stopped && (_length > 0 || _truncated)) {
+        emit();
+    }
+    return !_stopped;
+}
+
+/**
+ * @brief FsChunkVisitor that feeds a splitter
+ * @param data Chunk bytes
+ * @param length Number of bytes
+ * @param context The EARS_lineSplitter
+ * @return false once the line visitor asked to stop
+ */
+bool EARS_lineSplitter::feedChunk(const uint8_t* data, size_t length, void* context) {
+    return static_cast<EARS_lineSplitter*>(context)->feed(data, length);
+}
+
+/**
+ * @brief Hand the buffered line to the visitor and start a new one
+ * @return false if the visitor asked to stop
+ */
+bool EARS_lineSplitter::emit() {
+    // "\r\n" endings; a cut line keeps its last character
+    if (!_truncated && _length > 0 && _buffer[_length - 1] == '\r') {
+        _length--;
+    }
+    _buffer[_length] = '\0';
+    _lines++;
+    _stopped = !_visitor(_buffer, _length, _truncated, _context);
+    _length = 0;
+    _truncated = false;
+    return !_stopped;
+}
+
+/**
+ * @brief Read a file chunk by chunk through a caller buffer
+ * @param fs File system
+ * @param path File path
+ * @param buffer Chunk buffer
+ * @param bufferBytes Size of buffer
+ * @param visitor Called for each chunk
+ * @param context Passed to visitor unchanged
+ * @return size_t bytes handed to the visitor
+ */
+size_t EARS_readChunks(EARS_fsPort& fs, const char* path, uint8_t* buffer, size_t bufferBytes,
+                       FsChunkVisitor visitor, void* context) {
+    if (!buffer || bufferBytes == 0 || !visitor) {
+        return 0;
+    }
+    size_t total = 0;
+    for (;;) {
+        size_t count = fs.readFileAt(path, (uint32_t)total, buffer, bufferBytes);
+        if (count == 0) {
+            break;
+        }
+        total += count;
+        if (!visitor(buffer, count, context) || count < bufferBytes) {
+            break;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Read a file line by line through caller buffers
+ * @param fs File system
+ * @param path File path
+ * @param chunk Chunk buffer
+ * @param chunkBytes Size of chunk
+ * @param line Line buffer
+ * @param lineBytes Size of line
+ * @param visitor Called for each line
+ * @param context Passed to visitor unchanged
+ * @return uint32_t lines handed to the visitor
+ */
+uint32_t EARS_readLines(EARS_fsPort& fs, const char* path, uint8_t* chunk, size_t chunkBytes,
+                        char* line, size_t lineBytes, FsLineVisitor visitor, void* context) {
+    EARS_lineSplitter splitter(line, lineBytes, visitor, context);
+    EARS_readChunks(fs, path, chunk, chunkBytes, EARS_lineSplitter::feedChunk, &splitter);
+    splitter.finish();
+    return splitter.lines();
+}
+
+/****************************************************************************
+ * End of EARS_lineReader.cpp
+ ***************************************************************************/
@@ -0,0 +1,147 @@
+/**
+ * @file EARS_lineReader.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Constant-memory chunk and line reading over EARS_fsPort
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * Files are read through a caller buffer one chunk at a time, so their
+ * size is not limited by free heap. EARS_lineSplitter turns chunks into
+ * lines in a second caller buffer; a line longer than that buffer is cut
+ * and reported as truncated, and the rest of it is skipped. EARS_sdCard
+ * feeds the splitter from a single open file; EARS_readChunks() and
+ * EARS_readLines() do the same over any EARS_fsPort.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_LINE_READER_H__
+#define __EARS_LINE_READER_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "EARS_fsPortLib.h"
+
+/**
+ * @brief Visits one chunk of a file
+ * @param data Chunk bytes, valid only during the call
+ * @param length Number of bytes
+ * @param context Caller context
+ * @return true to continue, false to stop reading
+ */
+typedef bool (*FsChunkVisitor)(const uint8_t* data, size_t length, void* context);
+
+/**
+ * @brief Visits one line of a file
+ * @param line Line without its "\n" or "\r\n", NUL terminated, valid only during the call
+ * @param length Characters in line
+ * @param truncated true if the line did not fit the line buffer and was cut
+ * @param context Caller context
+ * @return true to continue, false to stop reading
+ */
+typedef bool (*FsLineVisitor)(const char* line, size_t length, bool truncated, void* context);
+
+/**
+ * @brief Splits a stream of chunks into lines without allocating
+ */
+class EARS_lineSplitter {
+public:
+    /**
+     * @brief Construct a splitter
+     * @param buffer Line buffer, the longest line kept is bufferBytes - 1
+     * @param bufferBytes Size of buffer, at least 2
+     * @param visitor Called for every line
+     * @param context Passed to visitor unchanged
+     */
+    EARS_lineSplitter(char* buffer, size_t bufferBytes, FsLineVisitor visitor, void* context);
+
+    /**
+     * @brief Split the next chunk
+     * @param data Chunk bytes
+     * @param length Number of bytes
+     * @return false once the visitor asked to stop
+     */
+    bool feed(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Hand over a last line that had no newline
+     * @return false if the visitor asked to stop
+     */
+    bool finish();
+
+    /**
+     * @brief Lines handed to the visitor so far
+     * @return uint32_t lines
+     */
+    uint32_t lines() const { return _lines; }
+
+    /**
+     * @brief Check if the visitor stopped the split
+     * @return true if stopped
+     */
+    bool stopped() const { return _stopped; }
+
+    /**
+     * @brief FsChunkVisitor that feeds a splitter, for use as a chunk callback
+     * @param data Chunk bytes
+     * @param length Number of bytes
+     * @param context The EARS_lineSplitter
+     * @return false once the line visitor asked to stop
+     */
+    static bool feedChunk(const uint8_t* data, size_t length, void* context);
+
+private:
+    char* _buffer;
+    size_t _capacity;       // Characters that fit, excluding the NUL
+    size_t _length;
+    bool _truncated;        // Current line overflowed, skip to its newline
+    bool _stopped;
+    uint32_t _lines;
+    FsLineVisitor _visitor;
+    void* _context;
+
+    /**
+     * @brief Hand the buffered line to the visitor and start a new one
+     * @return false if the visitor asked to stop
+     */
+    bool emit();
+};
+
+/**
+ * @brief Read a file chunk by chunk through a caller buffer
+ * @param fs File system
+ * @param path File path
+ * @param buffer Chunk buffer
+ * @param bufferBytes Size of buffer
+ * @param visitor Called for each chunk
+ * @param context Passed to visitor unchanged
+ * @return size_t bytes handed to the visitor
+ */
+size_t EARS_readChunks(EARS_fsPort& fs, const char* path, uint8_t* buffer, size_t bufferBytes,
+                       FsChunkVisitor visitor, void* context);
+
+/**
+ * @brief Read a file line by line through caller buffers
+ * @param fs File system
+ * @param path File path
+ * @param chunk Chunk buffer
+ * @param chunkBytes Size of chunk
+ * @param line Line buffer
+ * @param lineBytes Size of line
+ * @param visitor Called for each line
+ * @param context Passed to visitor unchanged
+ * @return uint32_t lines handed to the visitor
+ */
+uint32_t EARS_readLines(EARS_fsPort& fs, const char* path, uint8_t* chunk, size_t chunkBytes,
+                        char* line, size_t lineBytes, FsLineVisitor visitor, void* context);
+
+#endif // __EARS_LINE_READER_H__
+
+/****************************************************************************
+ * End of EARS_lineReader.h
+ ***************************************************************************/
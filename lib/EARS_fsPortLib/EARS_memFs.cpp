@@ -0,0 +1,211 @@
+/**
+ * @file EARS_memFs.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief In-memory EARS_fsPort for host tests and benchmarks
+ * @version 1.2.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_memFs.h"
+#include <string.h>
+
+/**
+ * @brief Construct an empty file system with no operation budget
+ */
+EARS_memFs::EARS_memFs() : _budget(-1) {
+}
+
+/**
+ * @brief Consume one operation from the budget
+ * @return true if the operation may run
+ */
+bool EARS_memFs::spend() {
+    if (_budget < 0) {
+        return true;
+    }
+    if (_budget == 0) {
+        return false;
+    }
+    _budget--;
+    return true;
+}
+
+/**
+ * @brief Check if file exists
+ * @param path File path
+ * @return true if file exists
+ */
+bool EARS_memFs::fileExists(const char* path) {
+    if (!spend()) return false;
+    _stats.metadataOps++;
+    return _files.count(path) != 0;
+}
+
+/**
+ * @brief Remove a file
+ * @param path File path
+ * @return true if file removed
+ */
+bool EARS_memFs::removeFile(const char* path) {
+    if (!spend()) return false;
+    _stats.metadataOps++;
+    return _files.erase(path) != 0;
+}
+
+/**
+ * @brief Rename a file, failing if the target exists (FAT semantics)
+ * @param fromPath Existing file path
+ * @param toPath New path
+ * @return true if renamed
+ */
+bool EARS_memFs::renameFile(const char* fromPath, const char* toPath) {
+    if (!spend()) return false;
+    _stats.metadataOps++;
+    std::map<std::string, std::string>::iterator it = _files.find(fromPath);
+    if (it == _files.end() || _files.count(toPath) != 0) {
+        return false;
+    }
+    std::string content;
+    content.swap(it->second);
+    _files.erase(it);
+    _files[toPath].swap(content);
+    return true;
+}
+
+/**
+ * @brief Read part of a file
+ * @param path File path
+ * @param offset Byte offset to start at
+ * @param buffer Destination
+ * @param length Bytes wanted
+ * @return size_t bytes read, 0 if missing or past the end
+ */
+size_t EARS_memFs::readFileAt(const char* path, uint32_t offset, uint8_t* buffer, size_t length) {
+    if (!spend()) return 0;
+    std::map<std::string, std::string>::const_iterator it = _files.find(path);
+    if (it == _files.end() || offset >= it->second.size()) {
+        return 0;
+    }
+    size_t count = it->second.size() - offset;
+    if (count > length) {
+        count = length;
+    }
+    memcpy(buffer, it->second.data() + offset, count);
+    _stats.reads++;
+    _stats.bytesRead += count;
+    return count;
+}
+
+/**
+ * @brief Read a whole file
+ * @param path File path
+ * @param content Receives the file contents
+ * @return true if the file exists
+ */
+bool EARS_memFs::readFile(const char* path, std::string& content) {
+    if (!spend()) return false;
+    std::map<std::string, std::string>::const_iterator it = _files.find(path);
+    if (it == _files.end()) {
+        return false;
+    }
+    content = it->second;
+    _stats.reads++;
+    _stats.bytesRead += content.size();
+    return true;
+}
+
+/**
+ * @brief Create or overwrite a file
+ * @param path File path
+ * @param data Bytes to write
+ * @param length Number of bytes
+ * @return true if written
+ */
+bool EARS_memFs::writeFile(const char* path, const void* data, size_t length) {
+    if (!spend()) return false;
+    _files[path].assign(static_cast<const char*>(data), length);
+    _stats.writes++;
+    _stats.bytesWritten += length;
+    return true;
+}
+
+/**
+ * @brief Append to a file, creating it if needed
+ * @param path File path
+ * @param data Bytes to append
+ * @param length Number of bytes
+ * @return true if written
+ */
+bool EARS_memFs::appendFile(const char* path, const void* data, size_t length) {
+    if (!spend()) return false;
+    _files[path].append(static_cast<const char*>(data), length);
+    _stats.writes++;
+    _stats.bytesWritten += length;
+    return true;
+}
+
+/**
+ * @brief Append raw bytes to a file, creating it if needed
+ * @param path File path
+ * @param data Bytes to append
+ * @param length Number of bytes
+ * @return true if written
+ */
+bool EARS_memFs::appendFile(const char* path, const uint8_t* data, size_t length) {
+    return appendFile(path, static_cast<const void*>(data), length);
+}
+
+/**
+ * @brief Create or replace a file of a fixed size
+ * @param path File path
+ * @param bytes File size, filled with 0xFF to stand in for old card contents
+ * @return true if created
+ */
+bool EARS_memFs::preallocateFile(const char* path, uint32_t bytes) {
+    if (!spend()) return false;
+    _files[path].assign(bytes, '\xFF');
+    _stats.writes++;
+    return true;
+}
+
+/**
+ * @brief Overwrite part of an existing file
+ * @param path File path
+ * @param offset Byte offset to start at, at most the file size
+ * @param data Bytes to write
+ * @param length Number of bytes
+ * @return true if written
+ */
+bool EARS_memFs::writeFileAt(const char* path, uint32_t offset, const uint8_t* data, size_t length) {
+    if (!spend()) return false;
+    std::map<std::string, std::string>::iterator it = _files.find(path);
+    if (it == _files.end() || offset > it->second.size()) {
+        return false;
+    }
+    if (offset + length > it->second.size()) {
+        it->second.resize(offset + length);
+    }
+    it->second.replace(offset, length, reinterpret_cast<const char*>(data), length);
+    _stats.writes++;
+    _stats.bytesWritten += length;
+    return true;
+}
+
+/**
+ * @brief Direct access to a file's bytes (not counted)
+ * @param path File path
+ * @return const std::string* contents, nullptr if missing
+ */
+const std::string* EARS_memFs::peek(const char* path) const {
+    std::map<std::string, std::string>::const_iterator it = _files.find(path);
+    return it == _files.end() ? nullptr : &it->second;
+}
+
+/*****************************************************************************
+ * End of EARS_memFs.cpp
+ ****************************************************************************/
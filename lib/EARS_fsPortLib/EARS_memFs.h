@@ -0,0 +1,116 @@
+/**
+ * @file EARS_memFs.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief In-memory EARS_fsPort for host tests and benchmarks
+ * @version 1.2.0
+ * @date 20261016
+ *
+ * @details
+ * Files live in a std::map. Every operation is counted so tests can
+ * compare the I/O an algorithm generates, and an operation budget
+ * simulates a power cut: once it runs out every further call fails and
+ * changes nothing.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_MEM_FS_H__
+#define __EARS_MEM_FS_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_fsPortLib.h"
+#include <map>
+#include <string>
+
+/**
+ * @brief Operation counters
+ */
+struct MemFsStats {
+    uint32_t metadataOps;   // exists/remove/rename calls
+    uint32_t reads;         // readFile calls
+    uint32_t writes;        // writeFile/appendFile calls
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+
+    MemFsStats() : metadataOps(0), reads(0), writes(0), bytesRead(0), bytesWritten(0) {}
+};
+
+/**
+ * @brief In-memory file system
+ */
+class EARS_memFs : public EARS_fsPort {
+public:
+    EARS_memFs();
+
+    bool fileExists(const char* path) override;
+    bool removeFile(const char* path) override;
+    bool renameFile(const char* fromPath, const char* toPath) override;
+    size_t readFileAt(const char* path, uint32_t offset, uint8_t* buffer, size_t length) override;
+    bool appendFile(const char* path, const uint8_t* data, size_t length) override;
+    bool preallocateFile(const char* path, uint32_t bytes) override;
+    bool writeFileAt(const char* path, uint32_t offset, const uint8_t* data, size_t length) override;
+
+    /**
+     * @brief Read a whole file
+     * @param path File path
+     * @param content Receives the file contents
+     * @return true if the file exists
+     */
+    bool readFile(const char* path, std::string& content);
+
+    /**
+     * @brief Create or overwrite a file
+     * @param path File path
+     * @param data Bytes to write
+     * @param length Number of bytes
+     * @return true if written
+     */
+    bool writeFile(const char* path, const void* data, size_t length);
+
+    /**
+     * @brief Append to a file, creating it if needed
+     * @param path File path
+     * @param data Bytes to append
+     * @param length Number of bytes
+     * @return true if written
+     */
+    bool appendFile(const char* path, const void* data, size_t length);
+
+    /**
+     * @brief Allow count more operations, then fail everything (-1 = unlimited)
+     * @param count Operations left before the simulated power cut
+     * @return void
+     */
+    void setOperationBudget(int32_t count) { _budget = count; }
+
+    /**
+     * @brief Direct access to a file's bytes (not counted)
+     * @param path File path
+     * @return const std::string* contents, nullptr if missing
+     */
+    const std::string* peek(const char* path) const;
+
+    size_t fileCount() const { return _files.size(); }
+    MemFsStats getStats() const { return _stats; }
+    void resetStats() { _stats = MemFsStats(); }
+
+private:
+    std::map<std::string, std::string> _files;
+    MemFsStats _stats;
+    int32_t _budget;
+
+    /**
+     * @brief Consume one operation from the budget
+     * @return true if the operation may run
+     */
+    bool spend();
+};
+
+#endif // __EARS_MEM_FS_H__
+
+/****************************************************************************
+ * End of EARS_memFs.h
+ ***************************************************************************/
@@ -0,0 +1,228 @@
+/**
+ * @file EARS_pathCache.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Small LRU cache of path metadata (type and size)
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_pathCache.h"
+#include <string.h>
+
+/**
+ * @brief Construct an empty cache
+ */
+EARS_pathCache::EARS_pathCache() : _clock(0) {
+    for (uint8_t i = 0; i < MAX_ENTRIES; i++) {
+        _entries[i].hash = 0;
+    }
+}
+
+/**
+ * @brief Path length without a trailing '/' (the root stays "/")
+ * @param path Path
+ * @return size_t significant length
+ */
+size_t EARS_pathCache::keyLength(const char* path) {
+    size_t length = strlen(path);
+    if (length > 1 && path[length - 1] == '/') {
+        length--;
+    }
+    return length;
+}
+
+/**
+ * @brief FNV-1a of the significant part of a path, never 0
+ * @param path Path
+ * @param length Significant length
+ * @return uint32_t hash
+ */
+uint32_t EARS_pathCache::hash(const char* path, size_t length) {
+    uint32_t value = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        value ^= (uint8_t)path[i];
+        value *= 16777619u;
+    }
+    return value ? value : 1;
+}
+
+/**
+ * @brief Find a path's entry, lock held
+ * @param path Path
+ * @param length Significant length
+ * @param pathHash hash(path, length)
+ * @return Entry* entry, nullptr if not cached
+ */
+EARS_pathCache::Entry* EARS_pathCache::find(const char* path, size_t length, uint32_t pathHash) {
+    for (uint8_t i = 0; i < MAX_ENTRIES; i++) {
+        Entry& entry = _entries[i];
+        if (entry.hash == pathHash && strncmp(entry.path, path, length) == 0 && entry.path[length] == '\0') {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Look up a path
+ * @param path Path
+ * @param info Receives the metadata on a hit
+ * @return true on a hit
+ */
+bool EARS_pathCache::lookup(const char* path, PathInfo& info) {
+    size_t length = keyLength(path);
+    uint32_t pathHash = hash(path, length);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry* entry = find(path, length, pathHash);
+    if (!entry) {
+        _stats.misses++;
+        return false;
+    }
+    entry->lastUse = ++_clock;
+    info = entry->info;
+    _stats.hits++;
+    return true;
+}
+
+/**
+ * @brief Remember a path's metadata, evicting the least recently used entry
+ * @param path Path
+ * @param info Metadata
+ * @return void
+ */
+void EARS_pathCache::store(const char* path, const PathInfo& info) {
+    size_t length = keyLength(path);
+    if (length >= PATH_BYTES) {
+        return;
+    }
+    uint32_t pathHash = hash(path, length);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry* entry = find(path, length, pathHash);
+    if (!entry) {
+        entry = &_entries[0];
+        for (uint8_t i = 0; i < MAX_ENTRIES; i++) {
+            if (_entries[i].hash == 0) {
+                entry = &_entries[i];
+                break;
+            }
+            if (_entries[i].lastUse < entry->lastUse) {
+                entry = &_entries[i];
+            }
+        }
+        if (entry->hash != 0) {
+            _stats.evictions++;
+        }
+        memcpy(entry->path, path, length);
+        entry->path[length] = '\0';
+        entry->hash = pathHash;
+    }
+    entry->info = info;
+    entry->lastUse = ++_clock;
+}
+
+/**
+ * @brief Account for bytes appended to a file
+ * @param path File path
+ * @param bytes Bytes appended
+ * @return void
+ */
+void EARS_pathCache::appended(const char* path, uint32_t bytes) {
+    size_t length = keyLength(path);
+    uint32_t pathHash = hash(path, length);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry* entry = find(path, length, pathHash);
+    if (!entry) {
+        return;
+    }
+    if (entry->info.type == PathType::MISSING) {
+        entry->info = PathInfo(PathType::FILE, true, bytes);
+    } else if (entry->info.type == PathType::FILE && entry->info.sizeKnown) {
+        entry->info.size += bytes;
+    }
+}
+
+/**
+ * @brief Forget a path
+ * @param path Path
+ * @return void
+ */
+void EARS_pathCache::erase(const char* path) {
+    size_t length = keyLength(path);
+    uint32_t pathHash = hash(path, length);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry* entry = find(path, length, pathHash);
+    if (entry) {
+        entry->hash = 0;
+    }
+}
+
+/**
+ * @brief Forget a path and everything below it
+ * @param path Directory path
+ * @return void
+ */
+void EARS_pathCache::eraseTree(const char* path) {
+    size_t length = keyLength(path);
+    bool root = length == 1 && path[0] == '/';
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (uint8_t i = 0; i < MAX_ENTRIES; i++) {
+        Entry& entry = _entries[i];
+        if (entry.hash == 0) {
+            continue;
+        }
+        if (root || (strncmp(entry.path, path, length) == 0 &&
+                     (entry.path[length] == '\0' || entry.path[length] == '/'))) {
+            entry.hash = 0;
+        }
+    }
+}
+
+/**
+ * @brief Forget everything (card removed or swapped)
+ * @return void
+ */
+void EARS_pathCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (uint8_t i = 0; i < MAX_ENTRIES; i++) {
+        _entries[i].hash = 0;
+    }
+    _stats.clears++;
+}
+
+/**
+ * @brief Number of cached paths
+ * @return size_t count
+ */
+size_t EARS_pathCache::count() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t used = 0;
+    for (uint8_t i = 0; i < MAX_ENTRIES; i++) {
+        if (_entries[i].hash != 0) {
+            used++;
+        }
+    }
+    return used;
+}
+
+/**
+ * @brief Get the cache counters
+ * @return PathCacheStats hits, misses, evictions and clears
+ */
+PathCacheStats EARS_pathCache::getStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+/****************************************************************************
+ * End of EARS_pathCache.cpp
+ ***************************************************************************/
@@ -0,0 +1,169 @@
+/**
+ * @file EARS_pathCache.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Small LRU cache of path metadata (type and size)
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * Every existence or size check on the card opens the path. EARS_pathCache
+ * remembers what those opens found, including paths that do not exist, so
+ * repeated checks (log rotation, size polling) are answered from RAM. The
+ * file system wrapper owning the cache updates it from its own create,
+ * write, remove and rename calls and clears it when the card may have
+ * changed behind its back.
+ *
+ * Paths are compared as given, except that a trailing '/' is ignored.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_PATH_CACHE_H__
+#define __EARS_PATH_CACHE_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <mutex>
+
+/**
+ * @brief What is at a path
+ */
+enum class PathType : uint8_t {
+    MISSING,
+    FILE,
+    DIRECTORY
+};
+
+/**
+ * @brief Cached metadata of one path
+ */
+struct PathInfo {
+    PathType type;
+    bool sizeKnown;     // FILE only
+    uint32_t size;
+
+    PathInfo() : type(PathType::MISSING), sizeKnown(false), size(0) {}
+    PathInfo(PathType pathType, bool known, uint32_t bytes) : type(pathType), sizeKnown(known), size(bytes) {}
+};
+
+/**
+ * @brief Path cache counters
+ */
+struct PathCacheStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t clears;
+
+    PathCacheStats() : hits(0), misses(0), evictions(0), clears(0) {}
+};
+
+/**
+ * @brief Fixed-size LRU map from path to PathInfo, thread safe
+ */
+class EARS_pathCache {
+public:
+    // Paths remembered at once
+    static const uint8_t MAX_ENTRIES = 32;
+    // Longest cacheable path plus terminator; longer paths are never cached
+    static const size_t PATH_BYTES = 64;
+
+    EARS_pathCache();
+
+    /**
+     * @brief Look up a path
+     * @param path Path
+     * @param info Receives the metadata on a hit
+     * @return true on a hit
+     */
+    bool lookup(const char* path, PathInfo& info);
+
+    /**
+     * @brief Remember a path's metadata, evicting the least recently used entry
+     * @param path Path
+     * @param info Metadata
+     * @return void
+     */
+    void store(const char* path, const PathInfo& info);
+
+    /**
+     * @brief Account for bytes appended to a file
+     * @param path File path
+     * @param bytes Bytes appended
+     * @return void
+     *
+     * A cached MISSING path becomes a FILE of bytes; an uncached path stays
+     * uncached.
+     */
+    void appended(const char* path, uint32_t bytes);
+
+    /**
+     * @brief Forget a path
+     * @param path Path
+     * @return void
+     */
+    void erase(const char* path);
+
+    /**
+     * @brief Forget a path and everything below it
+     * @param path Directory path
+     * @return void
+     */
+    void eraseTree(const char* path);
+
+    /**
+     * @brief Forget everything (card removed or swapped)
+     * @return void
+     */
+    void clear();
+
+    size_t count();
+    PathCacheStats getStats();
+
+private:
+    struct Entry {
+        uint32_t hash;      // 0 = unused
+        uint32_t lastUse;
+        PathInfo info;
+        char path[PATH_BYTES];
+    };
+
+    Entry _entries[MAX_ENTRIES];
+    uint32_t _clock;
+    PathCacheStats _stats;
+    std::mutex _mutex;
+
+    /**
+     * @brief Path length without a trailing '/' (the root stays "/")
+     * @param path Path
+     * @return size_t significant length
+     */
+    static size_t keyLength(const char* path);
+
+    /**
+     * @brief FNV-1a of the significant part of a path, never 0
+     * @param path Path
+     * @param length Significant length
+     * @return uint32_t hash
+     */
+    static uint32_t hash(const char* path, size_t length);
+
+    /**
+     * @brief Find a path's entry, lock held
+     * @param path Path
+     * @param length Significant length
+     * @param pathHash hash(path, length)
+     * @return Entry* entry, nullptr if not cached
+     */
+    Entry* find(const char* path, size_t length, uint32_t pathHash);
+};
+
+#endif // __EARS_PATH_CACHE_H__
+
+/****************************************************************************
+ * End of EARS_pathCache.h
+ ***************************************************************************/
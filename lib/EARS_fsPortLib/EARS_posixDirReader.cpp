@@ -0,0 +1,136 @@
+/**
+ * @file EARS_posixDirReader.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief EARS_dirReader over opendir/readdir/stat
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_posixDirReader.h"
+#include <string.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Construct a reader
+ * @param mountPoint Prefix put before every path, "" for none (not copied)
+ */
+EARS_posixDirReader::EARS_posixDirReader(const char* mountPoint)
+    : _mountPoint(mountPoint ? mountPoint : ""), _dir(nullptr), _dirLength(0) {
+    _fullPath[0] = '\0';
+}
+
+EARS_posixDirReader::~EARS_posixDirReader() {
+    closeDirectory();
+}
+
+/**
+ * @brief Open a directory, closing any open one
+ * @param path Directory path below the mount point
+ * @return true if opened
+ */
+bool EARS_posixDirReader::openDirectory(const char* path) {
+    closeDirectory();
+    size_t mountLength = strlen(_mountPoint);
+    size_t pathLength = strlen(path);
+    if (mountLength + pathLength + 2 > FULL_PATH_BYTES) {
+        return false;
+    }
+    memcpy(_fullPath, _mountPoint, mountLength);
+    memcpy(_fullPath + mountLength, path, pathLength + 1);
+    _dir = opendir(_fullPath);
+    if (!_dir) {
+        return false;
+    }
+    _dirLength = mountLength + pathLength;
+    if (_dirLength > 0 && _fullPath[_dirLength - 1] != '/') {
+        _fullPath[_dirLength++] = '/';
+        _fullPath[_dirLength] = '\0';
+    }
+    return true;
+}
+
+/**
+ * @brief Read the next entry ("." and ".." are skipped)
+ * @param entry Receives type, size and modified time
+ * @param name Receives the entry name
+ * @param nameBytes Size of name
+ * @return true if an entry was read, false at the end
+ */
+bool EARS_posixDirReader::nextEntry(DirEntry& entry, char* name, size_t nameBytes) {
+    if (!_dir || nameBytes == 0) {
+        return false;
+    }
+    for (;;) {
+        struct dirent* item = readdir(_dir);
+        if (!item) {
+            return false;
+        }
+        const char* itemName = item->d_name;
+        if (itemName[0] == '.' && (itemName[1] == '\0' || (itemName[1] == '.' && itemName[2] == '\0'))) {
+            continue;
+        }
+
+        // Copies at most nameBytes - 1 characters; the walker spots a full buffer
+        size_t nameLength = strlen(itemName);
+        size_t copyLength = nameLength < nameBytes - 1 ? nameLength : nameBytes - 1;
+        memcpy(name, itemName, copyLength);
+        name[copyLength] = '\0';
+
+        entry.type = DirEntryType::FILE;
+        entry.size = 0;
+        entry.modified = 0;
+        if (_dirLength + nameLength < FULL_PATH_BYTES) {
+            memcpy(_fullPath + _dirLength, itemName, nameLength + 1);
+            struct stat info;
+            if (stat(_fullPath, &info) == 0) {
+                if (S_ISDIR(info.st_mode)) {
+                    entry.type = DirEntryType::DIRECTORY;
+                } else {
+                    entry.size = (uint32_t)info.st_size;
+                }
+                entry.modified = info.st_mtime > 0 ? (uint32_t)info.st_mtime : 0;
+            }
+            _fullPath[_dirLength] = '\0';
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Listing position, for seekDirectory() after a reopen
+ * @return long opaque position
+ */
+long EARS_posixDirReader::tellDirectory() {
+    return _dir ? telldir(_dir) : 0;
+}
+
+/**
+ * @brief Continue a listing where tellDirectory() was called
+ * @param position Value from tellDirectory() on the same directory
+ * @return void
+ */
+void EARS_posixDirReader::seekDirectory(long position) {
+    if (_dir) {
+        seekdir(_dir, position);
+    }
+}
+
+/**
+ * @brief Close the open directory
+ * @return void
+ */
+void EARS_posixDirReader::closeDirectory() {
+    if (_dir) {
+        closedir(_dir);
+        _dir = nullptr;
+    }
+}
+
+/****************************************************************************
+ * End of EARS_posixDirReader.cpp
+ ***************************************************************************/
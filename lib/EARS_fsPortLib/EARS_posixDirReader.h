@@ -0,0 +1,59 @@
+/**
+ * @file EARS_posixDirReader.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief EARS_dirReader over opendir/readdir/stat
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * Works wherever the file system is reachable through POSIX calls: a host
+ * directory in tests and tools, or the SD card's VFS mount ("/sd") on the
+ * device. Paths given to the walker stay relative to the mount point, so
+ * entries come back as the card sees them ("/logs/a.log").
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_POSIX_DIR_READER_H__
+#define __EARS_POSIX_DIR_READER_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_dirWalker.h"
+#include <dirent.h>
+
+/**
+ * @brief Lists directories below a mount point
+ */
+class EARS_posixDirReader : public EARS_dirReader {
+public:
+    // Mount point plus path plus terminator
+    static const size_t FULL_PATH_BYTES = 192;
+
+    /**
+     * @brief Construct a reader
+     * @param mountPoint Prefix put before every path, "" for none (not copied)
+     */
+    explicit EARS_posixDirReader(const char* mountPoint);
+    ~EARS_posixDirReader() override;
+
+    bool openDirectory(const char* path) override;
+    bool nextEntry(DirEntry& entry, char* name, size_t nameBytes) override;
+    long tellDirectory() override;
+    void seekDirectory(long position) override;
+    void closeDirectory() override;
+
+private:
+    const char* _mountPoint;
+    DIR* _dir;
+    char _fullPath[FULL_PATH_BYTES];    // Mount point and open directory
+    size_t _dirLength;                  // Length of _fullPath without an entry name
+};
+
+#endif // __EARS_POSIX_DIR_READER_H__
+
+/****************************************************************************
+ * End of EARS_posixDirReader.h
+ ***************************************************************************/
@@ -0,0 +1,281 @@
+/**
+ * @file EARS_preallocLog.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Log file allocated once at full size and filled in place
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_preallocLog.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Store a 32 bit value little endian
+ */
+static void put32(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * @brief Load a 32 bit little endian value
+ */
+static uint32_t get32(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+/**
+ * @brief FNV-1a over a slot's fields
+ */
+static uint32_t slotCheck(const uint8_t* in, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ in[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Construct an unattached log
+ */
+EARS_preallocLog::EARS_preallocLog()
+    : _capacity(0), _fileCapacity(0), _end(0), _committedEnd(0), _sequence(0), _attached(false) {
+}
+
+/**
+ * @brief Set the data capacity of files this log creates
+ * @param capacity Data bytes per file
+ * @return void
+ */
+void EARS_preallocLog::begin(uint32_t capacity) {
+    _capacity = capacity;
+}
+
+/**
+ * @brief Encode a header slot
+ * @param header Header to store
+ * @param out At least SLOT_RECORD_BYTES
+ * @return void
+ */
+void EARS_preallocLog::encodeSlot(const PreallocHeader& header, uint8_t* out) {
+    memcpy(out, EARS_PREALLOC_MAGIC, 4);
+    put32(out + 4, header.capacity);
+    put32(out + 8, header.end);
+    put32(out + 12, header.sequence);
+    put32(out + 16, slotCheck(out, 16));
+}
+
+/**
+ * @brief Decode a header slot
+ * @param in SLOT_RECORD_BYTES read from the file
+ * @param header Receives the slot
+ * @return true if magic and check match
+ */
+bool EARS_preallocLog::decodeSlot(const uint8_t* in, PreallocHeader& header) {
+    if (memcmp(in, EARS_PREALLOC_MAGIC, 4) != 0 || get32(in + 16) != slotCheck(in, 16)) {
+        return false;
+    }
+    header.capacity = get32(in + 4);
+    header.end = get32(in + 8);
+    header.sequence = get32(in + 12);
+    return header.end <= header.capacity;
+}
+
+/**
+ * @brief Read a file's committed header
+ * @param fs File system
+ * @param path File path
+ * @param header Receives the newer valid slot
+ * @return true if path is a preallocated file
+ */
+bool EARS_preallocLog::readHeader(EARS_fsPort& fs, const char* path, PreallocHeader& header) {
+    uint8_t record[SLOT_RECORD_BYTES];
+    PreallocHeader slots[2];
+    bool valid[2];
+    for (int i = 0; i < 2; i++) {
+        valid[i] = fs.readFileAt(path, i * SLOT_BYTES, record, sizeof(record)) == sizeof(record) &&
+                   decodeSlot(record, slots[i]);
+    }
+    if (!valid[0] && !valid[1]) {
+        return false;
+    }
+    // Sequence comparison that survives wrapping
+    int newer = !valid[1] || (valid[0] && (int32_t)(slots[0].sequence - slots[1].sequence) >= 0) ? 0 : 1;
+    header = slots[newer];
+    return true;
+}
+
+/**
+ * @brief Build "<path>.spare"
+ * @param out Destination, EARS_FS_PORT_MAX_PATH bytes
+ * @param path Active file path
+ * @return true if it fit
+ */
+bool EARS_preallocLog::sparePath(char* out, const char* path) {
+    int length = snprintf(out, EARS_FS_PORT_MAX_PATH, "%s.spare", path);
+    return length > 0 && length < EARS_FS_PORT_MAX_PATH;
+}
+
+/**
+ * @brief Write the header with the next sequence into the older slot
+ * @param fs File system
+ * @param path Active file path
+ * @return true if written
+ */
+bool EARS_preallocLog::writeHeader(EARS_fsPort& fs, const char* path) {
+    PreallocHeader header;
+    header.capacity = _fileCapacity;
+    header.end = _end;
+    header.sequence = _sequence + 1;
+    uint8_t record[SLOT_RECORD_BYTES];
+    encodeSlot(header, record);
+    if (!fs.writeFileAt(path, (header.sequence & 1) * SLOT_BYTES, record, sizeof(record))) {
+        return false;
+    }
+    _sequence = header.sequence;
+    _committedEnd = _end;
+    _stats.commits++;
+    return true;
+}
+
+/**
+ * @brief Use path as the active file, creating it if missing
+ * @param fs File system
+ * @param path Active file path
+ * @return true if attached
+ * @return false if path is a plain file or allocation failed
+ */
+bool EARS_preallocLog::attach(EARS_fsPort& fs, const char* path) {
+    _attached = false;
+    PreallocHeader header;
+
+    if (fs.fileExists(path)) {
+        // Carry on where the last commit left off
+        if (!readHeader(fs, path, header)) {
+            return false;
+        }
+        _fileCapacity = header.capacity;
+        _end = header.end;
+        _committedEnd = header.end;
+        _sequence = header.sequence;
+        _attached = true;
+        return true;
+    }
+    if (_capacity == 0) {
+        return false;
+    }
+
+    // Reuse the clusters the last rotation set aside
+    char spare[EARS_FS_PORT_MAX_PATH];
+    if (sparePath(spare, path) && fs.fileExists(spare)) {
+        if (readHeader(fs, spare, header) && header.capacity == _capacity) {
+            // Emptied before it takes the active name, so its old data never shows
+            _fileCapacity = _capacity;
+            _end = 0;
+            _sequence = header.sequence;
+            if (writeHeader(fs, spare) && fs.renameFile(spare, path)) {
+                _stats.recycled++;
+                _attached = true;
+                return true;
+            }
+        }
+        fs.removeFile(spare);
+    }
+
+    if (!fs.preallocateFile(path, HEADER_BYTES + _capacity)) {
+        return false;
+    }
+    // Both slots, so nothing the clusters held before can pass for a header
+    header.capacity = _capacity;
+    header.end = 0;
+    header.sequence = 0;
+    uint8_t record[SLOT_RECORD_BYTES];
+    encodeSlot(header, record);
+    if (!fs.writeFileAt(path, 0, record, sizeof(record)) ||
+        !fs.writeFileAt(path, SLOT_BYTES, record, sizeof(record))) {
+        return false;
+    }
+    _fileCapacity = _capacity;
+    _end = 0;
+    _committedEnd = 0;
+    _sequence = 0;
+    _stats.created++;
+    _attached = true;
+    return true;
+}
+
+/**
+ * @brief Write bytes after the data
+ * @param fs File system
+ * @param path Active file path
+ * @param data Bytes
+ * @param length Number of bytes
+ * @return true if written
+ * @return false if they do not fit or the write failed
+ */
+bool EARS_preallocLog::append(EARS_fsPort& fs, const char* path, const uint8_t* data, size_t length) {
+    if (!fits(length)) {
+        _stats.full++;
+        return false;
+    }
+    if (!fs.writeFileAt(path, HEADER_BYTES + _end, data, length)) {
+        return false;
+    }
+    _end += (uint32_t)length;
+    return true;
+}
+
+/**
+ * @brief Record the current end in the header if it moved
+ * @param fs File system
+ * @param path Active file path
+ * @return true if the header is current
+ */
+bool EARS_preallocLog::commit(EARS_fsPort& fs, const char* path) {
+    if (!isDirty()) {
+        return true;
+    }
+    return writeHeader(fs, path);
+}
+
+/**
+ * @brief Commit, then shift generations keeping the oldest file's clusters
+ * @param fs File system
+ * @param path Active file path
+ * @param generations Numbered generations to keep
+ * @return true if path no longer exists
+ */
+bool EARS_preallocLog::rotate(EARS_fsPort& fs, const char* path, uint8_t generations) {
+    commit(fs, path);
+
+    char oldest[EARS_FS_PORT_MAX_PATH];
+    char spare[EARS_FS_PORT_MAX_PATH];
+    int length = generations == 0 ? snprintf(oldest, sizeof(oldest), "%s", path)
+                                  : snprintf(oldest, sizeof(oldest), "%s.%u", path, (unsigned)generations);
+    PreallocHeader header;
+    if (length > 0 && length < (int)sizeof(oldest) && sparePath(spare, path) && fs.fileExists(oldest) &&
+        readHeader(fs, oldest, header) && header.capacity == _capacity) {
+        // Anything else (compressed, plain, other size) is removed as usual
+        if (!fs.fileExists(spare) || fs.removeFile(spare)) {
+            fs.renameFile(oldest, spare);
+        }
+    }
+
+    if (!EARS_rotateGenerations(fs, path, generations)) {
+        return false;
+    }
+    _attached = false;
+    return true;
+}
+
+/****************************************************************************
+ * End of EARS_preallocLog.cpp
+ ***************************************************************************/
@@ -0,0 +1,229 @@
+/**
+ * @file EARS_preallocLog.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Log file allocated once at full size and filled in place
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * A log that grows one append at a time takes a new cluster whenever the
+ * last one fills, wherever the FAT finds one; with other files growing at
+ * the same time its clusters end up scattered across the card. Here the
+ * file is created at its final size in one allocation, data is written
+ * sequentially inside it, and a header records where the data ends.
+ * Rotation hands the oldest generation's clusters to the next active file
+ * instead of freeing them, so after the first cycle logs never allocate.
+ *
+ * File layout (little endian):
+ * - bytes 0-511:    header slot A
+ * - bytes 512-1023: header slot B
+ * - bytes 1024-:    data, capacity bytes of which end are valid
+ *
+ * A slot holds magic "EPL1", u32 capacity, u32 end, u32 sequence and an
+ * FNV-1a check of those 16 bytes. Commits alternate between the slots so a
+ * torn write leaves the previous one intact; the valid slot with the
+ * higher sequence wins. Bytes past end are whatever the card held before.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_PREALLOC_LOG_H__
+#define __EARS_PREALLOC_LOG_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "EARS_fsPortLib.h"
+
+// Header slot magic
+#define EARS_PREALLOC_MAGIC "EPL1"
+
+/**
+ * @brief A preallocated file's committed header
+ */
+struct PreallocHeader {
+    uint32_t capacity;      // Data bytes the file holds
+    uint32_t end;           // Data bytes written
+    uint32_t sequence;      // Commit count, the newer slot wins
+
+    PreallocHeader() : capacity(0), end(0), sequence(0) {}
+};
+
+/**
+ * @brief Preallocated log counters
+ */
+struct PreallocStats {
+    uint32_t created;       // Files allocated from free space
+    uint32_t recycled;      // Files made from a rotated generation's clusters
+    uint32_t commits;       // Header writes
+    uint32_t full;          // Appends refused for lack of room
+
+    PreallocStats() : created(0), recycled(0), commits(0), full(0) {}
+};
+
+/**
+ * @brief Writes one preallocated log file and rotates it
+ *
+ * Not thread safe; the logger calls it under its write lock.
+ */
+class EARS_preallocLog {
+public:
+    // Bytes before the data: two sector-sized header slots
+    static const uint32_t HEADER_BYTES = 1024;
+    static const uint32_t SLOT_BYTES = 512;
+    // Encoded slot length; the rest of the sector is left as is
+    static const size_t SLOT_RECORD_BYTES = 20;
+
+    EARS_preallocLog();
+
+    /**
+     * @brief Set the data capacity of files this log creates
+     * @param capacity Data bytes per file
+     * @return void
+     */
+    void begin(uint32_t capacity);
+
+    /**
+     * @brief Use path as the active file, creating it if missing
+     * @param fs File system
+     * @param path Active file path
+     * @return true if attached
+     * @return false if path is a plain file (rotate it away first) or
+     *         allocation failed; nothing was changed
+     *
+     * A missing file is made from "<path>.spare" when a rotation left one,
+     * otherwise allocated with preallocateFile().
+     */
+    bool attach(EARS_fsPort& fs, const char* path);
+
+    /**
+     * @brief Forget the active file, e.g. after it was removed
+     * @return void
+     */
+    void detach() { _attached = false; }
+
+    /**
+     * @brief Check for an active file
+     * @return true if attach() succeeded since the last detach
+     */
+    bool isAttached() const { return _attached; }
+
+    /**
+     * @brief Check if length more bytes fit
+     * @param length Number of bytes
+     * @return true if they fit in the active file
+     */
+    bool fits(size_t length) const { return _attached && length <= _fileCapacity - _end; }
+
+    /**
+     * @brief Write bytes after the data
+     * @param fs File system
+     * @param path Active file path
+     * @param data Bytes
+     * @param length Number of bytes
+     * @return true if written
+     * @return false if they do not fit (rotate) or the write failed
+     *
+     * The header is not touched; commit() makes the new end durable.
+     */
+    bool append(EARS_fsPort& fs, const char* path, const uint8_t* data, size_t length);
+
+    /**
+     * @brief Record the current end in the header if it moved
+     * @param fs File system
+     * @param path Active file path
+     * @return true if the header is current
+     */
+    bool commit(EARS_fsPort& fs, const char* path);
+
+    /**
+     * @brief Commit, then shift generations keeping the oldest file's clusters
+     * @param fs File system
+     * @param path Active file path
+     * @param generations Numbered generations to keep
+     * @return true if path no longer exists; the next attach() recycles
+     *
+     * The oldest generation becomes "<path>.spare" instead of being
+     * removed when it is a preallocated file of this capacity.
+     */
+    bool rotate(EARS_fsPort& fs, const char* path, uint8_t generations);
+
+    /**
+     * @brief Data bytes written to the active file
+     * @return uint32_t logical size
+     */
+    uint32_t end() const { return _end; }
+
+    /**
+     * @brief Data capacity of the active file
+     * @return uint32_t bytes
+     */
+    uint32_t capacity() const { return _fileCapacity; }
+
+    /**
+     * @brief Check for data not yet recorded in the header
+     * @return true if commit() would write
+     */
+    bool isDirty() const { return _attached && _end != _committedEnd; }
+
+    PreallocStats getStats() const { return _stats; }
+
+    /**
+     * @brief Read a file's committed header
+     * @param fs File system
+     * @param path File path
+     * @param header Receives the newer valid slot
+     * @return true if path is a preallocated file
+     */
+    static bool readHeader(EARS_fsPort& fs, const char* path, PreallocHeader& header);
+
+    /**
+     * @brief Encode a header slot
+     * @param header Header to store
+     * @param out At least SLOT_RECORD_BYTES
+     * @return void
+     */
+    static void encodeSlot(const PreallocHeader& header, uint8_t* out);
+
+    /**
+     * @brief Decode a header slot
+     * @param in SLOT_RECORD_BYTES read from the file
+     * @param header Receives the slot
+     * @return true if magic and check match
+     */
+    static bool decodeSlot(const uint8_t* in, PreallocHeader& header);
+
+private:
+    uint32_t _capacity;         // Capacity of new files
+    uint32_t _fileCapacity;     // Capacity of the active file
+    uint32_t _end;
+    uint32_t _committedEnd;
+    uint32_t _sequence;
+    bool _attached;
+    PreallocStats _stats;
+
+    /**
+     * @brief Write the header with the next sequence into the older slot
+     * @param fs File system
+     * @param path Active file path
+     * @return true if written
+     */
+    bool writeHeader(EARS_fsPort& fs, const char* path);
+
+    /**
+     * @brief Build "<path>.spare"
+     * @param out Destination, EARS_FS_PORT_MAX_PATH bytes
+     * @param path Active file path
+     * @return true if it fit
+     */
+    static bool sparePath(char* out, const char* path);
+};
+
+#endif // __EARS_PREALLOC_LOG_H__
+
+/****************************************************************************
+ * End of EARS_preallocLog.h
+ ***************************************************************************/
@@ -0,0 +1,196 @@
+/**
+ * @file EARS_spaceTracker.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Free space estimate kept current from the writes that change it
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_spaceTracker.h"
+
+/**
+ * @brief Construct a tracker for no volume
+ */
+EARS_spaceTracker::EARS_spaceTracker()
+    : _totalBytes(0), _clusterBytes(1), _countedBytes(0), _deltaBytes(0),
+      _deltaAtCount(0), _countedAtMs(0), _known(false) {
+}
+
+/**
+ * @brief Start tracking a freshly mounted volume, nothing counted yet
+ * @param totalBytes Volume size
+ * @param clusterBytes Allocation unit, see typicalClusterBytes()
+ * @return void
+ */
+void EARS_spaceTracker::begin(uint64_t totalBytes, uint32_t clusterBytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _totalBytes = totalBytes;
+    _clusterBytes = clusterBytes ? clusterBytes : 1;
+    _countedBytes = 0;
+    _deltaBytes = 0;
+    _deltaAtCount = 0;
+    _known = false;
+    _stats = SpaceTrackerStats();
+}
+
+/**
+ * @brief Mark the start of a count
+ * @return void
+ */
+void EARS_spaceTracker::beginCount() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _deltaAtCount = _deltaBytes;
+}
+
+/**
+ * @brief Replace the estimate with a count
+ * @param usedBytes Used space the count found
+ * @param nowMs Current time in milliseconds
+ * @return void
+ */
+void EARS_spaceTracker::endCount(uint64_t usedBytes, uint32_t nowMs) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_known) {
+        int64_t estimated = (int64_t)_countedBytes + _deltaAtCount;
+        _stats.lastDriftBytes = (int64_t)usedBytes - estimated;
+    }
+    // Changes made while the count ran stay on top of it
+    _countedBytes = usedBytes;
+    _deltaBytes -= _deltaAtCount;
+    _deltaAtCount = 0;
+    _countedAtMs = nowMs;
+    _known = true;
+    _stats.counts++;
+    _stats.uncertainBytes = 0;
+}
+
+/**
+ * @brief Bytes a file of size takes on the volume
+ * @param size File size
+ * @return uint64_t whole clusters in bytes
+ */
+uint64_t EARS_spaceTracker::allocated(uint64_t size) const {
+    return (size + _clusterBytes - 1) / _clusterBytes * _clusterBytes;
+}
+
+/**
+ * @brief Follow a file changing size
+ * @param oldSize Size before
+ * @param newSize Size after
+ * @return void
+ */
+void EARS_spaceTracker::resized(uint64_t oldSize, uint64_t newSize) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _deltaBytes += (int64_t)allocated(newSize) - (int64_t)allocated(oldSize);
+    _stats.changes++;
+}
+
+/**
+ * @brief Follow bytes added to a file of unknown size
+ * @param bytes Bytes written
+ * @return void
+ */
+void EARS_spaceTracker::added(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _deltaBytes += (int64_t)bytes;
+    _stats.uncertainBytes += _clusterBytes;
+    _stats.changes++;
+}
+
+/**
+ * @brief Follow a change whose size is unknown (e.g. a failed write)
+ * @return void
+ */
+void EARS_spaceTracker::unknownChange() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    // Forces a recount at the next check
+    _stats.uncertainBytes += RECOUNT_UNCERTAIN_BYTES;
+    _stats.changes++;
+}
+
+/**
+ * @brief Check if a count has finished since begin()
+ * @return true if usedBytes()/freeBytes() are meaningful
+ */
+bool EARS_spaceTracker::isKnown() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _known;
+}
+
+/**
+ * @brief Check if a count should run
+ * @param nowMs Current time in milliseconds
+ * @return true if never counted, the interval passed or the estimate is too uncertain
+ */
+bool EARS_spaceTracker::countDue(uint32_t nowMs) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return !_known || (uint32_t)(nowMs - _countedAtMs) >= RECOUNT_INTERVAL_MS ||
+           _stats.uncertainBytes >= RECOUNT_UNCERTAIN_BYTES;
+}
+
+/**
+ * @brief Estimate, lock held
+ * @return uint64_t used bytes within [0, total]
+ */
+uint64_t EARS_spaceTracker::estimate() const {
+    int64_t used = (int64_t)_countedBytes + _deltaBytes;
+    if (used < 0) {
+        return 0;
+    }
+    return (uint64_t)used > _totalBytes ? _totalBytes : (uint64_t)used;
+}
+
+/**
+ * @brief Estimated used space
+ * @return uint64_t used bytes, 0 until the first count
+ */
+uint64_t EARS_spaceTracker::usedBytes() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _known ? estimate() : 0;
+}
+
+/**
+ * @brief Estimated free space
+ * @return uint64_t free bytes, 0 until the first count
+ */
+uint64_t EARS_spaceTracker::freeBytes() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _known ? _totalBytes - estimate() : 0;
+}
+
+/**
+ * @brief Get the tracker counters
+ * @return SpaceTrackerStats counts, changes and drift
+ */
+SpaceTrackerStats EARS_spaceTracker::getStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+/**
+ * @brief Default cluster size of an SD card formatted to the SD specification
+ * @param totalBytes Card size
+ * @return uint32_t cluster size in bytes
+ */
+uint32_t EARS_spaceTracker::typicalClusterBytes(uint64_t totalBytes) {
+    const uint64_t gigabyte = 1024ULL * 1024ULL * 1024ULL;
+    if (totalBytes <= 2 * gigabyte) {
+        return 16384;           // FAT16 (SDSC)
+    }
+    if (totalBytes <= 32 * gigabyte) {
+        return 32768;           // FAT32 (SDHC)
+    }
+    if (totalBytes <= 512 * gigabyte) {
+        return 131072;          // exFAT (SDXC)
+    }
+    return 262144;
+}
+
+/****************************************************************************
+ * End of EARS_spaceTracker.cpp
+ ***************************************************************************/
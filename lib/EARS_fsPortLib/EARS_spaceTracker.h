@@ -0,0 +1,157 @@
+/**
+ * @file EARS_spaceTracker.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Free space estimate kept current from the writes that change it
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * Counting the used space of a FAT volume means reading the whole FAT,
+ * which takes seconds on a large card. EARS_spaceTracker takes one such
+ * count from a background task, then follows every size change the file
+ * system wrapper reports, rounded to whole clusters. A recount replaces the
+ * estimate when RECOUNT_INTERVAL_MS has passed or when too many changes
+ * were only approximate.
+ *
+ * Changes made while a count runs are kept on top of its result, so a
+ * count never loses them.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_SPACE_TRACKER_H__
+#define __EARS_SPACE_TRACKER_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <mutex>
+
+/**
+ * @brief Space tracker counters
+ */
+struct SpaceTrackerStats {
+    uint32_t counts;            // Completed counts
+    uint32_t changes;           // Size changes followed
+    int64_t lastDriftBytes;     // Count result minus the estimate it replaced
+    uint64_t uncertainBytes;    // Possible error of the estimate since the last count
+
+    SpaceTrackerStats() : counts(0), changes(0), lastDriftBytes(0), uncertainBytes(0) {}
+};
+
+/**
+ * @brief Used/free space of one volume, counted once and then followed
+ */
+class EARS_spaceTracker {
+public:
+    // Recount at least this often
+    static const uint32_t RECOUNT_INTERVAL_MS = 15UL * 60UL * 1000UL;
+    // Recount early once approximate changes could be this far off
+    static const uint64_t RECOUNT_UNCERTAIN_BYTES = 64ULL * 1024ULL * 1024ULL;
+
+    EARS_spaceTracker();
+
+    /**
+     * @brief Start tracking a freshly mounted volume, nothing counted yet
+     * @param totalBytes Volume size
+     * @param clusterBytes Allocation unit, see typicalClusterBytes()
+     * @return void
+     */
+    void begin(uint64_t totalBytes, uint32_t clusterBytes);
+
+    /**
+     * @brief Mark the start of a count
+     * @return void
+     */
+    void beginCount();
+
+    /**
+     * @brief Replace the estimate with a count
+     * @param usedBytes Used space the count found
+     * @param nowMs Current time in milliseconds
+     * @return void
+     */
+    void endCount(uint64_t usedBytes, uint32_t nowMs);
+
+    /**
+     * @brief Follow a file changing size
+     * @param oldSize Size before
+     * @param newSize Size after
+     * @return void
+     */
+    void resized(uint64_t oldSize, uint64_t newSize);
+
+    /**
+     * @brief Follow bytes added to a file of unknown size
+     * @param bytes Bytes written
+     * @return void
+     *
+     * Counted as bytes; may be off by a cluster.
+     */
+    void added(uint64_t bytes);
+
+    /**
+     * @brief Follow a change whose size is unknown (e.g. a failed write)
+     * @return void
+     */
+    void unknownChange();
+
+    /**
+     * @brief Check if a count has finished since begin()
+     * @return true if usedBytes()/freeBytes() are meaningful
+     */
+    bool isKnown();
+
+    /**
+     * @brief Check if a count should run
+     * @param nowMs Current time in milliseconds
+     * @return true if never counted, the interval passed or the estimate is too uncertain
+     */
+    bool countDue(uint32_t nowMs);
+
+    uint64_t usedBytes();
+    uint64_t freeBytes();
+    uint64_t totalBytes() const { return _totalBytes; }
+    uint32_t clusterBytes() const { return _clusterBytes; }
+    SpaceTrackerStats getStats();
+
+    /**
+     * @brief Default cluster size of an SD card formatted to the SD specification
+     * @param totalBytes Card size
+     * @return uint32_t cluster size in bytes
+     */
+    static uint32_t typicalClusterBytes(uint64_t totalBytes);
+
+private:
+    uint64_t _totalBytes;
+    uint32_t _clusterBytes;
+    uint64_t _countedBytes;     // Result of the last count
+    int64_t _deltaBytes;        // Changes since then
+    int64_t _deltaAtCount;      // _deltaBytes when the running count started
+    uint32_t _countedAtMs;
+    bool _known;
+    SpaceTrackerStats _stats;
+    std::mutex _mutex;
+
+    /**
+     * @brief Bytes a file of size takes on the volume
+     * @param size File size
+     * @return uint64_t whole clusters in bytes
+     */
+    uint64_t allocated(uint64_t size) const;
+
+    /**
+     * @brief Estimate, lock held
+     * @return uint64_t used bytes within [0, total]
+     */
+    uint64_t estimate() const;
+};
+
+#endif // __EARS_SPACE_TRACKER_H__
+
+/****************************************************************************
+ * End of EARS_spaceTracker.h
+ ***************************************************************************/
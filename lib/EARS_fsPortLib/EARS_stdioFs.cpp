@@ -0,0 +1,128 @@
+/**
+ * @file EARS_stdioFs.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief EARS_fsPort over C stdio for host tools
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_stdioFs.h"
+#include <stdio.h>
+
+/**
+ * @brief Check if file exists
+ * @param path File path
+ * @return true if the file can be opened for reading
+ */
+bool EARS_stdioFs::fileExists(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief Remove a file
+ * @param path File path
+ * @return true if file removed
+ */
+bool EARS_stdioFs::removeFile(const char* path) {
+    return remove(path) == 0;
+}
+
+/**
+ * @brief Rename a file, failing if the target exists like FAT does
+ * @param fromPath Existing file path
+ * @param toPath New path
+ * @return true if renamed
+ */
+bool EARS_stdioFs::renameFile(const char* fromPath, const char* toPath) {
+    if (fileExists(toPath)) {
+        return false;
+    }
+    return rename(fromPath, toPath) == 0;
+}
+
+/**
+ * @brief Read part of a file
+ * @param path File path
+ * @param offset Byte offset to start at
+ * @param buffer Destination
+ * @param length Bytes wanted
+ * @return size_t bytes read, 0 if missing or past the end
+ */
+size_t EARS_stdioFs::readFileAt(const char* path, uint32_t offset, uint8_t* buffer, size_t length) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    size_t count = 0;
+    if (fseek(file, (long)offset, SEEK_SET) == 0) {
+        count = fread(buffer, 1, length, file);
+    }
+    fclose(file);
+    return count;
+}
+
+/**
+ * @brief Append bytes to a file, creating it if needed
+ * @param path File path
+ * @param data Bytes to append
+ * @param length Number of bytes
+ * @return true if all bytes were written
+ */
+bool EARS_stdioFs::appendFile(const char* path, const uint8_t* data, size_t length) {
+    FILE* file = fopen(path, "ab");
+    if (!file) {
+        return false;
+    }
+    size_t written = fwrite(data, 1, length, file);
+    return fclose(file) == 0 && written == length;
+}
+
+/**
+ * @brief Create or replace a file of a fixed size
+ * @param path File path
+ * @param bytes File size
+ * @return true if the file has that size
+ */
+bool EARS_stdioFs::preallocateFile(const char* path, uint32_t bytes) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    // Writing the last byte sizes the file (sparse on most host file systems)
+    bool ok = bytes == 0 || (fseek(file, (long)bytes - 1, SEEK_SET) == 0 && fputc(0, file) == 0);
+    return fclose(file) == 0 && ok;
+}
+
+/**
+ * @brief Overwrite part of an existing file
+ * @param path File path
+ * @param offset Byte offset to start at
+ * @param data Bytes to write
+ * @param length Number of bytes
+ * @return true if all bytes were written
+ */
+bool EARS_stdioFs::writeFileAt(const char* path, uint32_t offset, const uint8_t* data, size_t length) {
+    FILE* file = fopen(path, "r+b");
+    if (!file) {
+        return false;
+    }
+    size_t written = 0;
+    if (fseek(file, (long)offset, SEEK_SET) == 0) {
+        written = fwrite(data, 1, length, file);
+    }
+    return fclose(file) == 0 && written == length;
+}
+
+/*****************************************************************************
+ * End of EARS_stdioFs.cpp
+ ****************************************************************************/
@@ -0,0 +1,42 @@
+/**
+ * @file EARS_stdioFs.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief EARS_fsPort over C stdio for host tools
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @details
+ * Lets host tools run the same portable readers the device uses on files
+ * copied off the SD card. Paths are passed to fopen() unchanged.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_STDIO_FS_H__
+#define __EARS_STDIO_FS_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_fsPortLib.h"
+
+/**
+ * @brief Host file system through fopen/fread/fwrite
+ */
+class EARS_stdioFs : public EARS_fsPort {
+public:
+    bool fileExists(const char* path) override;
+    bool removeFile(const char* path) override;
+    bool renameFile(const char* fromPath, const char* toPath) override;
+    size_t readFileAt(const char* path, uint32_t offset, uint8_t* buffer, size_t length) override;
+    bool appendFile(const char* path, const uint8_t* data, size_t length) override;
+    bool preallocateFile(const char* path, uint32_t bytes) override;
+    bool writeFileAt(const char* path, uint32_t offset, const uint8_t* data, size_t length) override;
+};
+
+#endif // __EARS_STDIO_FS_H__
+
+/****************************************************************************
+ * End of EARS_stdioFs.h
+ ***************************************************************************/
@@ -0,0 +1,138 @@
+/**
+ * @file EARS_writeCache.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Write-behind cache that hands appends to the card in aligned blocks
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_writeCache.h"
+#include <string.h>
+
+/**
+ * @brief Construct a cache without a buffer
+ */
+EARS_writeCache::EARS_writeCache()
+    : _buffer(nullptr), _blockBytes(0), _fileSize(0), _used(0) {
+}
+
+/**
+ * @brief Attach the block buffer
+ * @param buffer Buffer of blockBytes
+ * @param blockBytes Block size, a power of two of at least 512
+ * @return true if the configuration is valid
+ */
+bool EARS_writeCache::begin(uint8_t* buffer, size_t blockBytes) {
+    if (!buffer || blockBytes < 512 || (blockBytes & (blockBytes - 1)) != 0) {
+        return false;
+    }
+    _buffer = buffer;
+    _blockBytes = blockBytes;
+    _used = 0;
+    return true;
+}
+
+/**
+ * @brief Start caching a freshly opened file
+ * @param fileSize Current size of the file, where appends land
+ * @return void
+ */
+void EARS_writeCache::reset(uint32_t fileSize) {
+    _fileSize = fileSize;
+    _used = 0;
+}
+
+/**
+ * @brief Append bytes, writing every block that fills
+ * @param data Bytes to append
+ * @param length Number of bytes
+ * @param sink Writes blocks to the file
+ * @param context Passed to sink unchanged
+ * @return false if the sink failed
+ */
+bool EARS_writeCache::append(const uint8_t* data, size_t length, FsBlockSink sink, void* context) {
+    _stats.appends++;
+    _stats.bytes += length;
+    if (!_buffer) {
+        return write(data, length, sink, context);
+    }
+
+    while (length > 0) {
+        size_t target = fillTarget();
+
+        // Whole blocks straight from the caller when nothing is buffered
+        if (_used == 0 && target == _blockBytes && length >= _blockBytes) {
+            size_t direct = length & ~(_blockBytes - 1);
+            if (!write(data, direct, sink, context)) {
+                return false;
+            }
+            data += direct;
+            length -= direct;
+            continue;
+        }
+
+        size_t count = target - _used;
+        if (count > length) {
+            count = length;
+        }
+        memcpy(_buffer + _used, data, count);
+        _used += count;
+        data += count;
+        length -= count;
+
+        if (_used == target) {
+            if (!write(_buffer, _used, sink, context)) {
+                return false;
+            }
+            _used = 0;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Write whatever is buffered
+ * @param sink Writes to the file
+ * @param context Passed to sink unchanged
+ * @return false if the sink failed
+ */
+bool EARS_writeCache::drain(FsBlockSink sink, void* context) {
+    if (_used == 0) {
+        return true;
+    }
+    _stats.partialWrites++;
+    if (!write(_buffer, _used, sink, context)) {
+        return false;
+    }
+    _used = 0;
+    return true;
+}
+
+/**
+ * @brief Hand bytes to the sink and advance the file size
+ * @param data Bytes
+ * @param length Number of bytes
+ * @param sink Sink
+ * @param context Sink context
+ * @return true if written
+ */
+bool EARS_writeCache::write(const uint8_t* data, size_t length, FsBlockSink sink, void* context) {
+    if (length == 0) {
+        return true;
+    }
+    _stats.sinkWrites++;
+    if (!sink(data, length, context)) {
+        return false;
+    }
+    _fileSize += (uint32_t)length;
+    return true;
+}
+
+/****************************************************************************
+ * End of EARS_writeCache.cpp
+ ***************************************************************************/
@@ -0,0 +1,137 @@
+/**
+ * @file EARS_writeCache.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Write-behind cache that hands appends to the card in aligned blocks
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * An SD card programs whole sectors, so every small append costs at least a
+ * sector write, and more when it straddles two. EARS_writeCache collects
+ * appends to one file in a caller buffer and passes them on only as blocks
+ * that end on a multiple of the block size in the file: the first write
+ * tops the file up to the next boundary, every later one is a full block.
+ * drain() passes on the partial rest when the data must reach the card.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_WRITE_CACHE_H__
+#define __EARS_WRITE_CACHE_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Writes bytes at the end of the cached file
+ * @param data Bytes to write
+ * @param length Number of bytes
+ * @param context Caller context
+ * @return true if every byte was written
+ */
+typedef bool (*FsBlockSink)(const uint8_t* data, size_t length, void* context);
+
+/**
+ * @brief Write cache counters
+ */
+struct WriteCacheStats {
+    uint32_t appends;       // append() calls
+    uint32_t sinkWrites;    // Writes handed to the sink
+    uint32_t partialWrites; // ... of which drain() had to send unaligned
+    uint64_t bytes;         // Bytes appended
+
+    WriteCacheStats() : appends(0), sinkWrites(0), partialWrites(0), bytes(0) {}
+};
+
+/**
+ * @brief Collects appends to one file into aligned blocks
+ */
+class EARS_writeCache {
+public:
+    EARS_writeCache();
+
+    /**
+     * @brief Attach the block buffer
+     * @param buffer Buffer of blockBytes
+     * @param blockBytes Block size, a power of two of at least 512
+     * @return true if the configuration is valid
+     */
+    bool begin(uint8_t* buffer, size_t blockBytes);
+
+    /**
+     * @brief Start caching a freshly opened file
+     * @param fileSize Current size of the file, where appends land
+     * @return void
+     *
+     * Anything still buffered is discarded; drain() first.
+     */
+    void reset(uint32_t fileSize);
+
+    /**
+     * @brief Append bytes, writing every block that fills
+     * @param data Bytes to append
+     * @param length Number of bytes
+     * @param sink Writes blocks to the file
+     * @param context Passed to sink unchanged
+     * @return false if the sink failed (the block stays buffered)
+     *
+     * Without a buffer every append goes straight to the sink.
+     */
+    bool append(const uint8_t* data, size_t length, FsBlockSink sink, void* context);
+
+    /**
+     * @brief Write whatever is buffered
+     * @param sink Writes to the file
+     * @param context Passed to sink unchanged
+     * @return false if the sink failed
+     */
+    bool drain(FsBlockSink sink, void* context);
+
+    /**
+     * @brief Bytes buffered but not yet written
+     * @return size_t pending bytes
+     */
+    size_t pending() const { return _used; }
+
+    /**
+     * @brief Size of the file once pending bytes are written
+     * @return uint32_t file size
+     */
+    uint32_t fileSize() const { return _fileSize + (uint32_t)_used; }
+
+    size_t blockBytes() const { return _blockBytes; }
+    WriteCacheStats getStats() const { return _stats; }
+
+private:
+    uint8_t* _buffer;
+    size_t _blockBytes;
+    uint32_t _fileSize;     // Bytes already handed to the sink
+    size_t _used;           // Bytes in _buffer, they start at _fileSize
+    WriteCacheStats _stats;
+
+    /**
+     * @brief Bytes the buffer needs to end on a block boundary
+     * @return size_t target fill, 1 to blockBytes
+     */
+    size_t fillTarget() const { return _blockBytes - (_fileSize & (_blockBytes - 1)); }
+
+    /**
+     * @brief Hand bytes to the sink and advance the file size
+     * @param data Bytes
+     * @param length Number of bytes
+     * @param sink Sink
+     * @param context Sink context
+     * @return true if written
+     */
+    bool write(const uint8_t* data, size_t length, FsBlockSink sink, void* context);
+};
+
+#endif // __EARS_WRITE_CACHE_H__
+
+/****************************************************************************
+ * End of EARS_writeCache.h
+ ***************************************************************************/
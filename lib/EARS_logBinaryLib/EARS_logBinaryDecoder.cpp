@@ -0,0 +1,419 @@
+/**
+ * @file EARS_logBinaryDecoder.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Turns binary log records back into text log lines
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_logBinaryDecoder.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*
+  Bounded input cursor, the reading counterpart of the writer's Cursor.
+  Every read fails once the data runs out.
+*/
+namespace {
+
+struct Reader {
+    const uint8_t* data;
+    size_t used;
+    size_t length;
+
+    Reader(const uint8_t* buffer, size_t bytes) : data(buffer), used(0), length(bytes) {}
+
+    bool atEnd() const {
+        return used >= length;
+    }
+
+    bool get(void* out, size_t count) {
+        if (used + count > length) {
+            return false;
+        }
+        memcpy(out, data + used, count);
+        used += count;
+        return true;
+    }
+
+    bool getByte(uint8_t& value) {
+        return get(&value, 1);
+    }
+
+    bool getVarint(uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            uint8_t byte;
+            if (!getByte(byte)) {
+                return false;
+            }
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool getSigned(int64_t& value) {
+        uint64_t raw;
+        if (!getVarint(raw)) {
+            return false;
+        }
+        value = (int64_t)(raw >> 1) ^ -(int64_t)(raw & 1);
+        return true;
+    }
+
+    bool getU32(uint32_t& value) {
+        uint8_t bytes[4];
+        if (!get(bytes, sizeof(bytes))) {
+            return false;
+        }
+        value = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+        return true;
+    }
+};
+
+const char* levelName(uint8_t level) {
+    switch (level) {
+        case 1: return "ERROR";
+        case 2: return "WARN";
+        case 3: return "INFO";
+        case 4: return "DEBUG";
+        default: return "NONE";
+    }
+}
+
+/*
+  Rebuild the conversion without its size modifier so the host printf
+  can be handed the widened value (long long or double).
+*/
+std::string stripSize(const LogFormatSpec& spec) {
+    std::string result;
+    for (const char* p = spec.start; p < spec.end - 1; p++) {
+        if (!strchr("hljztL", *p)) {
+            result += *p;
+        }
+    }
+    return result;
+}
+
+void appendFormatted(std::string& out, const char* format, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (written > 0) {
+        out.append(buffer, ((size_t)written < sizeof(buffer)) ? (size_t)written : sizeof(buffer) - 1);
+    }
+}
+
+/*
+  Copy literal text between conversions, collapsing "%%".
+*/
+void appendLiteral(std::string& out, const char* begin, const char* end) {
+    for (const char* p = begin; p < end; p++) {
+        out += *p;
+        if (*p == '%' && p + 1 < end && p[1] == '%') {
+            p++;
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Construct an empty decoder
+ */
+EARS_logBinaryDecoder::EARS_logBinaryDecoder() :
+    _baseUs(0),
+    _unknownFormats(0) {
+}
+
+/**
+ * @brief Collect FORMAT records without decoding entries
+ * @param data File contents
+ * @param length Number of bytes
+ * @return size_t number of new formats learned
+ */
+size_t EARS_logBinaryDecoder::learnFormats(const uint8_t* data, size_t length) {
+    size_t learned = 0;
+    walk(data, length, nullptr, learned);
+    return learned;
+}
+
+/**
+ * @brief Decode every record
+ * @param data File contents
+ * @param length Number of bytes
+ * @param lines Decoded entries are appended here
+ * @return true if the whole buffer was decoded
+ * @return false if a corrupt or cut off record stopped decoding
+ */
+bool EARS_logBinaryDecoder::decode(const uint8_t* data, size_t length, std::vector<LogBinaryLine>& lines) {
+    size_t learned = 0;
+    return walk(data, length, &lines, learned);
+}
+
+/**
+ * @brief Walk the records, decoding entries only when lines is set
+ * @param data File contents
+ * @param length Number of bytes
+ * @param lines Output, or nullptr to only learn formats
+ * @param learned Incremented per new format
+ * @return true if the whole buffer was walked
+ */
+bool EARS_logBinaryDecoder::walk(const uint8_t* data, size_t length, std::vector<LogBinaryLine>* lines, size_t& learned) {
+    Reader reader(data, length);
+
+    while (!reader.atEnd()) {
+        uint8_t tag = 0;
+        reader.getByte(tag);
+        uint8_t level = tag & 0x0F;
+
+        switch ((LogBinaryRecord)(tag >> 4)) {
+            case LogBinaryRecord::FILE_HEADER: {
+                char magic[4];
+                uint32_t low, high;
+                if (!reader.get(magic, sizeof(magic)) || memcmp(magic, EARS_LOG_BINARY_MAGIC, 4) != 0 ||
+                    !reader.getU32(low) || !reader.getU32(high)) {
+                    return false;
+                }
+                _baseUs = ((uint64_t)high << 32) | low;
+                break;
+            }
+
+            case LogBinaryRecord::FORMAT: {
+                uint32_t id;
+                uint8_t formatLength;
+                if (!reader.getU32(id) || !reader.getByte(formatLength) || reader.used + formatLength > length) {
+                    return false;
+                }
+                std::string format((const char*)data + reader.used, formatLength);
+                reader.used += formatLength;
+                if (_formats.insert(std::make_pair(id, format)).second) {
+                    learned++;
+                }
+                break;
+            }
+
+            case LogBinaryRecord::ENTRY: {
+                uint32_t id;
+                int64_t offset;
+                uint8_t argsLength;
+                if (!reader.getU32(id) || !reader.getSigned(offset) || !reader.getByte(argsLength) ||
+                    reader.used + argsLength > length) {
+                    return false;
+                }
+                const uint8_t* args = data + reader.used;
+                reader.used += argsLength;
+                if (!lines) {
+                    break;
+                }
+
+                LogBinaryLine line;
+                line.timestampUs = _baseUs + (uint64_t)offset;
+                line.level = level;
+                std::map<uint32_t, std::string>::const_iterator format = _formats.find(id);
+                if (format != _formats.end()) {
+                    line.message = render(format->second, args, argsLength);
+                } else {
+                    char unknown[40];
+                    snprintf(unknown, sizeof(unknown), "<unknown format %08X>", (unsigned)id);
+                    line.message = unknown;
+                    _unknownFormats++;
+                }
+                lines->push_back(line);
+                break;
+            }
+
+            case LogBinaryRecord::TEXT: {
+                int64_t offset;
+                uint8_t lengthBytes[2];
+                if (!reader.getSigned(offset) || !reader.get(lengthBytes, sizeof(lengthBytes))) {
+                    return false;
+                }
+                size_t textLength = (size_t)lengthBytes[0] | ((size_t)lengthBytes[1] << 8);
+                if (reader.used + textLength > length) {
+                    return false;
+                }
+                if (lines) {
+                    LogBinaryLine line;
+                    line.timestampUs = _baseUs + (uint64_t)offset;
+                    line.level = level;
+                    line.message.assign((const char*)data + reader.used, textLength);
+                    lines->push_back(line);
+                }
+                reader.used += textLength;
+                break;
+            }
+
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Format an entry's arguments with its format string
+ * @param format Format string
+ * @param args Encoded arguments
+ * @param length Number of argument bytes
+ * @return std::string the formatted message
+ */
+std::string EARS_logBinaryDecoder::render(const std::string& format, const uint8_t* args, size_t length) {
+    Reader reader(args, length);
+    std::string out;
+    LogFormatSpec spec;
+    const char* p = format.c_str();
+
+    while (EARS_logBinaryNextSpec(p, spec)) {
+        appendLiteral(out, p, spec.start);
+        p = spec.end;
+
+        int64_t width = 0;
+        int64_t precision = 0;
+        if ((spec.widthArg && !reader.getSigned(width)) || (spec.precisionArg && !reader.getSigned(precision))) {
+            out += '?';
+            continue;
+        }
+
+        std::string conversion = stripSize(spec);
+        bool ok = true;
+        switch (spec.conversion) {
+            case 'd':
+            case 'i': {
+                int64_t value;
+                conversion += "ll";
+                conversion += spec.conversion;
+                if ((ok = reader.getSigned(value))) {
+                    if (spec.widthArg && spec.precisionArg) {
+                        appendFormatted(out, conversion.c_str(), (int)width, (int)precision, (long long)value);
+                    } else if (spec.widthArg || spec.precisionArg) {
+                        appendFormatted(out, conversion.c_str(), (int)(spec.widthArg ? width : precision), (long long)value);
+                    } else {
+                        appendFormatted(out, conversion.c_str(), (long long)value);
+                    }
+                }
+                break;
+            }
+
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            case 'c':
+            case 'p': {
+                uint64_t value;
+                if (spec.conversion == 'p') {
+                    conversion += "#llx";
+                } else if (spec.conversion != 'c') {
+                    conversion += "ll";
+                    conversion += spec.conversion;
+                } else {
+                    conversion += 'c';
+                }
+                if ((ok = reader.getVarint(value))) {
+                    if (spec.conversion == 'c') {
+                        appendFormatted(out, conversion.c_str(), (int)value);
+                    } else if (spec.widthArg && spec.precisionArg) {
+                        appendFormatted(out, conversion.c_str(), (int)width, (int)precision, (unsigned long long)value);
+                    } else if (spec.widthArg || spec.precisionArg) {
+                        appendFormatted(out, conversion.c_str(), (int)(spec.widthArg ? width : precision), (unsigned long long)value);
+                    } else {
+                        appendFormatted(out, conversion.c_str(), (unsigned long long)value);
+                    }
+                }
+                break;
+            }
+
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A': {
+                double value;
+                conversion += spec.conversion;
+                if ((ok = reader.get(&value, sizeof(value)))) {
+                    if (spec.widthArg && spec.precisionArg) {
+                        appendFormatted(out, conversion.c_str(), (int)width, (int)precision, value);
+                    } else if (spec.widthArg || spec.precisionArg) {
+                        appendFormatted(out, conversion.c_str(), (int)(spec.widthArg ? width : precision), value);
+                    } else {
+                        appendFormatted(out, conversion.c_str(), value);
+                    }
+                }
+                break;
+            }
+
+            case 's': {
+                uint8_t stringLength;
+                conversion += 's';
+                if ((ok = reader.getByte(stringLength) && reader.used + stringLength <= length)) {
+                    std::string value((const char*)args + reader.used, stringLength);
+                    reader.used += stringLength;
+                    if (spec.widthArg && spec.precisionArg) {
+                        appendFormatted(out, conversion.c_str(), (int)width, (int)precision, value.c_str());
+                    } else if (spec.widthArg || spec.precisionArg) {
+                        appendFormatted(out, conversion.c_str(), (int)(spec.widthArg ? width : precision), value.c_str());
+                    } else {
+                        appendFormatted(out, conversion.c_str(), value.c_str());
+                    }
+                }
+                break;
+            }
+
+            case 'n':
+            default:
+                break;
+        }
+
+        if (!ok) {
+            // Argument left out on the device because the record was full
+            out += '?';
+            reader.used = length;
+        }
+    }
+
+    appendLiteral(out, p, p + strlen(p));
+    return out;
+}
+
+/**
+ * @brief Render an entry as a text log line
+ * @param line Decoded entry
+ * @return std::string "[timestamp] [LEVEL] message" without newline
+ */
+std::string EARS_logBinaryDecoder::toText(const LogBinaryLine& line) {
+    time_t seconds = (time_t)(line.timestampUs / 1000000ULL);
+    unsigned long micros = (unsigned long)(line.timestampUs % 1000000ULL);
+    struct tm timeinfo;
+    gmtime_r(&seconds, &timeinfo);
+
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "[%04d-%02d-%02d %02d:%02d:%02d.%06lu] [%s] ",
+             timeinfo.tm_year + 1900,
+             timeinfo.tm_mon + 1,
+             timeinfo.tm_mday,
+             timeinfo.tm_hour,
+             timeinfo.tm_min,
+             timeinfo.tm_sec,
+             micros,
+             levelName(line.level));
+    return std::string(prefix) + line.message;
+}
+
+/*****************************************************************************
+ * End of EARS_logBinaryDecoder.cpp
+ ****************************************************************************/
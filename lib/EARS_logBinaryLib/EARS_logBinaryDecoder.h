@@ -0,0 +1,116 @@
+/**
+ * @file EARS_logBinaryDecoder.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Turns binary log records back into text log lines
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * Host side counterpart of EARS_logBinaryWriter, used by tools/ears_logdecode
+ * and the host tests. Lines come out in the text logger's layout:
+ * "[YYYY-MM-DD HH:MM:SS.uuuuuu] [LEVEL] message".
+ *
+ * With the asynchronous logger a FORMAT record can land in the previous
+ * file, or after its first use, so learnFormats() should be run over every
+ * file before decode().
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_LOG_BINARY_DECODER_H__
+#define __EARS_LOG_BINARY_DECODER_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "EARS_logBinaryLib.h"
+
+/**
+ * @brief One decoded log entry
+ */
+struct LogBinaryLine {
+    uint64_t timestampUs;   // Wall clock time in microseconds
+    uint8_t level;          // Log level as stored
+    std::string message;    // Formatted message without timestamp or level
+};
+
+/**
+ * @brief Decoder for binary log files
+ */
+class EARS_logBinaryDecoder {
+public:
+    EARS_logBinaryDecoder();
+
+    /**
+     * @brief Collect FORMAT records without decoding entries
+     * @param data File contents
+     * @param length Number of bytes
+     * @return size_t number of new formats learned
+     */
+    size_t learnFormats(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Decode every record
+     * @param data File contents
+     * @param length Number of bytes
+     * @param lines Decoded entries are appended here
+     * @return true if the whole buffer was decoded
+     * @return false if a corrupt or cut off record stopped decoding
+     */
+    bool decode(const uint8_t* data, size_t length, std::vector<LogBinaryLine>& lines);
+
+    /**
+     * @brief Render an entry as a text log line
+     * @param line Decoded entry
+     * @return std::string "[timestamp] [LEVEL] message" without newline
+     */
+    static std::string toText(const LogBinaryLine& line);
+
+    /**
+     * @brief Number of known format strings
+     * @return size_t format count
+     */
+    size_t formatCount() const { return _formats.size(); }
+
+    /**
+     * @brief Entries whose format string was never found
+     * @return uint32_t count of entries decoded as "<unknown format ...>"
+     */
+    uint32_t unknownFormats() const { return _unknownFormats; }
+
+private:
+    std::map<uint32_t, std::string> _formats;
+    uint64_t _baseUs;
+    uint32_t _unknownFormats;
+
+    /**
+     * @brief Walk the records, decoding entries only when lines is set
+     * @param data File contents
+     * @param length Number of bytes
+     * @param lines Output, or nullptr to only learn formats
+     * @param learned Incremented per new format
+     * @return true if the whole buffer was walked
+     */
+    bool walk(const uint8_t* data, size_t length, std::vector<LogBinaryLine>* lines, size_t& learned);
+
+    /**
+     * @brief Format an entry's arguments with its format string
+     * @param format Format string
+     * @param args Encoded arguments
+     * @param length Number of argument bytes
+     * @return std::string the formatted message
+     */
+    static std::string render(const std::string& format, const uint8_t* args, size_t length);
+};
+
+#endif // __EARS_LOG_BINARY_DECODER_H__
+
+/****************************************************************************
+ * End of EARS_logBinaryDecoder.h
+ ***************************************************************************/
@@ -0,0 +1,432 @@
+/**
+ * @file EARS_logBinaryLib.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Compact binary log records with deferred formatting
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_logBinaryLib.h"
+#include <string.h>
+#include <stddef.h>
+
+/*
+  Bounded output cursor. Once a write does not fit, every later write
+  fails too, so a record is never left with a hole in the middle.
+*/
+namespace {
+
+struct Cursor {
+    uint8_t* out;
+    size_t used;
+    size_t capacity;
+    bool full;
+
+    Cursor(uint8_t* buffer, size_t bytes) : out(buffer), used(0), capacity(bytes), full(false) {}
+
+    bool put(const void* data, size_t length) {
+        if (full || used + length > capacity) {
+            full = true;
+            return false;
+        }
+        memcpy(out + used, data, length);
+        used += length;
+        return true;
+    }
+
+    bool putByte(uint8_t value) {
+        return put(&value, 1);
+    }
+
+    bool putVarint(uint64_t value) {
+        uint8_t bytes[10];
+        size_t count = 0;
+        do {
+            uint8_t byte = value & 0x7F;
+            value >>= 7;
+            bytes[count++] = value ? (byte | 0x80) : byte;
+        } while (value);
+        return put(bytes, count);
+    }
+
+    bool putSigned(int64_t value) {
+        return putVarint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+    }
+
+    bool putU32(uint32_t value) {
+        uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+        return put(bytes, sizeof(bytes));
+    }
+};
+
+inline uint8_t recordTag(LogBinaryRecord type, uint8_t level) {
+    return (uint8_t)(((uint8_t)type << 4) | (level & 0x0F));
+}
+
+/*
+  Pull one argument for spec off args and append it. Returns false once
+  the record is full.
+*/
+bool encodeArgument(Cursor& cursor, const LogFormatSpec& spec, va_list& args) {
+    switch (spec.conversion) {
+        case 'd':
+        case 'i': {
+            int64_t value;
+            switch (spec.size) {
+                case 'l': value = va_arg(args, long); break;
+                case 'L': value = va_arg(args, long long); break;
+                case 'j': value = va_arg(args, intmax_t); break;
+                case 'z': value = (int64_t)va_arg(args, size_t); break;
+                case 't': value = va_arg(args, ptrdiff_t); break;
+                case 'H': value = (signed char)va_arg(args, int); break;
+                case 'h': value = (short)va_arg(args, int); break;
+                default:  value = va_arg(args, int); break;
+            }
+            return cursor.putSigned(value);
+        }
+
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X': {
+            uint64_t value;
+            switch (spec.size) {
+                case 'l': value = va_arg(args, unsigned long); break;
+                case 'L': value = va_arg(args, unsigned long long); break;
+                case 'j': value = va_arg(args, uintmax_t); break;
+                case 'z': value = va_arg(args, size_t); break;
+                case 't': value = (uint64_t)va_arg(args, ptrdiff_t); break;
+                case 'H': value = (unsigned char)va_arg(args, unsigned int); break;
+                case 'h': value = (unsigned short)va_arg(args, unsigned int); break;
+                default:  value = va_arg(args, unsigned int); break;
+            }
+            return cursor.putVarint(value);
+        }
+
+        case 'c':
+            return cursor.putVarint((unsigned char)va_arg(args, int));
+
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A': {
+            double value = (spec.size == 'D') ? (double)va_arg(args, long double) : va_arg(args, double);
+            return cursor.put(&value, sizeof(value));
+        }
+
+        case 's': {
+            const char* value = va_arg(args, const char*);
+            if (!value) {
+                value = "(null)";
+            }
+            // Precision may bound a string that is not terminated
+            size_t limit = (spec.precision >= 0 && spec.precision < 255) ? (size_t)spec.precision : 255;
+            size_t length = 0;
+            while (length < limit && value[length]) {
+                length++;
+            }
+            // Long strings are cut to fit rather than losing the argument
+            size_t room = (cursor.capacity > cursor.used + 1) ? cursor.capacity - cursor.used - 1 : 0;
+            if (length > room) {
+                length = room;
+            }
+            return cursor.putByte((uint8_t)length) && cursor.put(value, length);
+        }
+
+        case 'p':
+            return cursor.putVarint((uintptr_t)va_arg(args, void*));
+
+        case 'n':
+            // Never written through - just consumed
+            (void)va_arg(args, void*);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Find the next conversion in a format string ("%%" is skipped)
+ * @param format Position to search from
+ * @param spec Receives the conversion
+ * @return true if a conversion was found, continue from spec.end
+ * @return false at the end of the string or on a malformed conversion
+ */
+bool EARS_logBinaryNextSpec(const char* format, LogFormatSpec& spec) {
+    const char* p = format;
+    while (*p) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            p += 2;
+            continue;
+        }
+
+        spec.start = p++;
+        spec.widthArg = false;
+        spec.precisionArg = false;
+        spec.precision = -1;
+        spec.size = 0;
+
+        while (*p && strchr("-+ #0'", *p)) {
+            p++;
+        }
+        if (*p == '*') {
+            spec.widthArg = true;
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                p++;
+            }
+        }
+        if (*p == '.') {
+            p++;
+            if (*p == '*') {
+                spec.precisionArg = true;
+                p++;
+            } else {
+                spec.precision = 0;
+                while (*p >= '0' && *p <= '9') {
+                    spec.precision = spec.precision * 10 + (*p++ - '0');
+                }
+            }
+        }
+
+        switch (*p) {
+            case 'h': spec.size = (p[1] == 'h') ? 'H' : 'h'; p += (p[1] == 'h') ? 2 : 1; break;
+            case 'l': spec.size = (p[1] == 'l') ? 'L' : 'l'; p += (p[1] == 'l') ? 2 : 1; break;
+            case 'j':
+            case 'z':
+            case 't': spec.size = *p++; break;
+            case 'L': spec.size = 'D'; p++; break;
+            default: break;
+        }
+
+        if (!*p || !strchr("diuoxXcspfFeEgGaAn", *p)) {
+            return false;
+        }
+        spec.conversion = *p++;
+        spec.end = p;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief FNV-1a hash of a format string, used as its ID
+ * @param format Format string
+ * @return uint32_t non-zero format ID
+ */
+uint32_t EARS_logBinaryFormatId(const char* format) {
+    uint32_t hash = 2166136261u;
+    while (*format) {
+        hash ^= (uint8_t)*format++;
+        hash *= 16777619u;
+    }
+    // 0 marks an empty dictionary slot
+    return hash ? hash : 1;
+}
+
+/**
+ * @brief Construct a writer with an empty dictionary and zero time base
+ */
+EARS_logBinaryWriter::EARS_logBinaryWriter() :
+    _baseUs(0) {
+    resetDictionary();
+}
+
+/**
+ * @brief Set the time base entries are stored relative to
+ * @param baseUs Wall clock time in microseconds
+ * @return void
+ */
+void EARS_logBinaryWriter::begin(uint64_t baseUs) {
+    _baseUs = baseUs;
+    resetDictionary();
+}
+
+/**
+ * @brief Forget which formats were written, call when a new file starts
+ * @return void
+ */
+void EARS_logBinaryWriter::resetDictionary() {
+    for (size_t i = 0; i < DICTIONARY_SIZE; i++) {
+        _written[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Mark id as written to the current file
+ * @param id Format ID (never 0)
+ * @return true if the caller must write the FORMAT record
+ */
+bool EARS_logBinaryWriter::claim(uint32_t id) {
+    size_t index = id % DICTIONARY_SIZE;
+    for (size_t probe = 0; probe < DICTIONARY_SIZE; probe++) {
+        std::atomic<uint32_t>& slot = _written[(index + probe) % DICTIONARY_SIZE];
+        uint32_t current = slot.load(std::memory_order_relaxed);
+        if (current == id) {
+            return false;
+        }
+        if (current == 0) {
+            // Only the task that fills the slot writes the record
+            if (slot.compare_exchange_strong(current, id)) {
+                return true;
+            }
+            if (current == id) {
+                return false;
+            }
+        }
+    }
+    // Dictionary full - repeating the record is always safe
+    return true;
+}
+
+/**
+ * @brief Encode the FILE_HEADER record
+ * @param out Destination buffer
+ * @param capacity Size of out, at least FILE_HEADER_BYTES
+ * @return size_t record length, 0 if it did not fit
+ */
+size_t EARS_logBinaryWriter::fileHeader(uint8_t* out, size_t capacity) const {
+    Cursor cursor(out, capacity);
+    cursor.putByte(recordTag(LogBinaryRecord::FILE_HEADER, 0));
+    cursor.put(EARS_LOG_BINARY_MAGIC, 4);
+    cursor.putU32((uint32_t)_baseUs);
+    cursor.putU32((uint32_t)(_baseUs >> 32));
+    return cursor.full ? 0 : cursor.used;
+}
+
+/**
+ * @brief Encode the FORMAT record for format if this file lacks it
+ * @param out Destination buffer
+ * @param capacity Size of out in bytes
+ * @param format printf-style format string
+ * @param id Receives the format ID
+ * @return size_t record length, 0 if the format was already written
+ */
+size_t EARS_logBinaryWriter::formatRecord(uint8_t* out, size_t capacity, const char* format, uint32_t& id) {
+    id = EARS_logBinaryFormatId(format);
+    if (!claim(id)) {
+        return 0;
+    }
+
+    // Overlong formats are cut rather than lost, the ID is already claimed
+    size_t length = strlen(format);
+    if (length > 255) {
+        length = 255;
+    }
+    if (capacity < 6) {
+        return 0;
+    }
+    if (length > capacity - 6) {
+        length = capacity - 6;
+    }
+    Cursor cursor(out, capacity);
+    cursor.putByte(recordTag(LogBinaryRecord::FORMAT, 0));
+    cursor.putU32(id);
+    cursor.putByte((uint8_t)length);
+    cursor.put(format, length);
+    return cursor.full ? 0 : cursor.used;
+}
+
+/**
+ * @brief Encode a formatted call
+ * @param out Destination buffer
+ * @param capacity Size of out in bytes
+ * @param nowUs Wall clock time in microseconds
+ * @param level Log level (0-15)
+ * @param id Format ID from formatRecord()
+ * @param format The same format string
+ * @param args Arguments matching format, consumed
+ * @return size_t record length, 0 if even the header did not fit
+ */
+size_t EARS_logBinaryWriter::entry(uint8_t* out, size_t capacity, uint64_t nowUs, uint8_t level,
+                                   uint32_t id, const char* format, va_list args) const {
+    Cursor cursor(out, capacity);
+    cursor.putByte(recordTag(LogBinaryRecord::ENTRY, level));
+    cursor.putU32(id);
+    cursor.putSigned((int64_t)(nowUs - _baseUs));
+    size_t lengthAt = cursor.used;
+    if (!cursor.putByte(0)) {
+        return 0;
+    }
+
+    // Arguments live in at most 255 bytes after the length byte
+    size_t argsCapacity = cursor.capacity - cursor.used;
+    if (argsCapacity > 255) {
+        argsCapacity = 255;
+    }
+    Cursor argsCursor(out + cursor.used, argsCapacity);
+
+    va_list walk;
+    va_copy(walk, args);
+    LogFormatSpec spec;
+    const char* p = format;
+    while (EARS_logBinaryNextSpec(p, spec)) {
+        if (spec.widthArg && !argsCursor.putSigned(va_arg(walk, int))) {
+            break;
+        }
+        if (spec.precisionArg && !argsCursor.putSigned(va_arg(walk, int))) {
+            break;
+        }
+        if (!encodeArgument(argsCursor, spec, walk)) {
+            break;
+        }
+        p = spec.end;
+    }
+    va_end(walk);
+
+    out[lengthAt] = (uint8_t)argsCursor.used;
+    return cursor.used + argsCursor.used;
+}
+
+/**
+ * @brief Encode a plain message
+ * @param out Destination buffer
+ * @param capacity Size of out in bytes
+ * @param nowUs Wall clock time in microseconds
+ * @param level Log level (0-15)
+ * @param message Message text, cut to fit capacity
+ * @return size_t record length, 0 if even the header did not fit
+ */
+size_t EARS_logBinaryWriter::text(uint8_t* out, size_t capacity, uint64_t nowUs, uint8_t level,
+                                  const char* message) const {
+    Cursor cursor(out, capacity);
+    cursor.putByte(recordTag(LogBinaryRecord::TEXT, level));
+    cursor.putSigned((int64_t)(nowUs - _baseUs));
+    if (cursor.full || cursor.used + 2 > capacity) {
+        return 0;
+    }
+
+    size_t length = strlen(message);
+    size_t room = capacity - cursor.used - 2;
+    if (length > room) {
+        length = room;
+    }
+    if (length > 0xFFFF) {
+        length = 0xFFFF;
+    }
+    cursor.putByte((uint8_t)length);
+    cursor.putByte((uint8_t)(length >> 8));
+    cursor.put(message, length);
+    return cursor.used;
+}
+
+/*****************************************************************************
+ * End of EARS_logBinaryLib.cpp
+ ****************************************************************************/
@@ -0,0 +1,181 @@
+/**
+ * @file EARS_logBinaryLib.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Compact binary log records with deferred formatting
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * Instead of running vsnprintf on the device, a formatted log call is stored
+ * as a small header (level, format ID, microsecond timestamp) followed by the
+ * raw argument values. The format string itself is written once per file as
+ * a FORMAT record, keyed by its FNV-1a hash. EARS_logBinaryDecoder turns the
+ * records back into the same text lines the text logger writes.
+ *
+ * Record layout (little endian, varint = unsigned LEB128, zigzag for signed):
+ * - FILE_HEADER: tag, "EBL1", u64 base time in microseconds
+ * - FORMAT:      tag, u32 format ID, u8 length, format characters
+ * - ENTRY:       tag|level, u32 format ID, zigzag varint offset, u8 argument bytes, arguments
+ * - TEXT:        tag|level, zigzag varint offset, u16 length, message characters
+ *
+ * Arguments follow the format string: integers as (zigzag) varints,
+ * floating point as 8 byte doubles, strings as u8 length plus characters.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_LOG_BINARY_LIB_H__
+#define __EARS_LOG_BINARY_LIB_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <atomic>
+
+/**
+ * @brief Record type, stored in the high nibble of a record's first byte
+ */
+enum class LogBinaryRecord : uint8_t {
+    FILE_HEADER = 0x0,  // Magic and time base, starts every file and boot
+    FORMAT = 0x1,       // Format string for a format ID
+    ENTRY = 0x2,        // Formatted call with raw arguments
+    TEXT = 0x3          // Plain message, stored as is
+};
+
+// File header magic
+#define EARS_LOG_BINARY_MAGIC "EBL1"
+
+/**
+ * @brief One conversion of a printf format string
+ */
+struct LogFormatSpec {
+    const char* start;      // The '%'
+    const char* end;        // One past the conversion character
+    bool widthArg;          // Width given as '*'
+    bool precisionArg;      // Precision given as '*'
+    int precision;          // Literal precision, -1 if none
+    char size;              // 'H' = hh, 'h', 'l', 'L' = ll, 'j', 'z', 't', 'D' = long double, 0 = none
+    char conversion;        // d i u o x X c s p f F e E g G a A n
+};
+
+/**
+ * @brief Find the next conversion in a format string ("%%" is skipped)
+ * @param format Position to search from
+ * @param spec Receives the conversion
+ * @return true if a conversion was found, continue from spec.end
+ * @return false at the end of the string or on a malformed conversion
+ */
+bool EARS_logBinaryNextSpec(const char* format, LogFormatSpec& spec);
+
+/**
+ * @brief Encodes log calls into binary records
+ *
+ * Thread safe: any number of tasks may encode at once. The writer only
+ * remembers which format strings have already been written to the current
+ * file.
+ */
+class EARS_logBinaryWriter {
+public:
+    // Longest record header before the arguments/message
+    static const size_t ENTRY_HEADER_BYTES = 16;
+    // FILE_HEADER record size
+    static const size_t FILE_HEADER_BYTES = 13;
+    // Format strings remembered per file before FORMAT records are repeated
+    static const size_t DICTIONARY_SIZE = 128;
+
+    EARS_logBinaryWriter();
+
+    /**
+     * @brief Set the time base entries are stored relative to
+     * @param baseUs Wall clock time in microseconds
+     * @return void
+     */
+    void begin(uint64_t baseUs);
+
+    /**
+     * @brief Time base set by begin()
+     * @return uint64_t base time in microseconds
+     */
+    uint64_t baseUs() const { return _baseUs; }
+
+    /**
+     * @brief Forget which formats were written, call when a new file starts
+     * @return void
+     */
+    void resetDictionary();
+
+    /**
+     * @brief Encode the FILE_HEADER record
+     * @param out Destination buffer
+     * @param capacity Size of out, at least FILE_HEADER_BYTES
+     * @return size_t record length, 0 if it did not fit
+     */
+    size_t fileHeader(uint8_t* out, size_t capacity) const;
+
+    /**
+     * @brief Encode the FORMAT record for format if this file lacks it
+     * @param out Destination buffer
+     * @param capacity Size of out in bytes
+     * @param format printf-style format string
+     * @param id Receives the format ID
+     * @return size_t record length, 0 if the format was already written
+     *
+     * A format longer than capacity allows is stored cut short.
+     */
+    size_t formatRecord(uint8_t* out, size_t capacity, const char* format, uint32_t& id);
+
+    /**
+     * @brief Encode a formatted call
+     * @param out Destination buffer
+     * @param capacity Size of out in bytes
+     * @param nowUs Wall clock time in microseconds
+     * @param level Log level (0-15)
+     * @param id Format ID from formatRecord()
+     * @param format The same format string
+     * @param args Arguments matching format, consumed
+     * @return size_t record length, 0 if even the header did not fit
+     *
+     * Arguments that do not fit are left out; the decoder shows them as "?".
+     */
+    size_t entry(uint8_t* out, size_t capacity, uint64_t nowUs, uint8_t level,
+                 uint32_t id, const char* format, va_list args) const;
+
+    /**
+     * @brief Encode a plain message
+     * @param out Destination buffer
+     * @param capacity Size of out in bytes
+     * @param nowUs Wall clock time in microseconds
+     * @param level Log level (0-15)
+     * @param message Message text, cut to fit capacity
+     * @return size_t record length, 0 if even the header did not fit
+     */
+    size_t text(uint8_t* out, size_t capacity, uint64_t nowUs, uint8_t level, const char* message) const;
+
+private:
+    uint64_t _baseUs;
+    std::atomic<uint32_t> _written[DICTIONARY_SIZE];   // Open addressed set of format IDs, 0 = empty
+
+    /**
+     * @brief Mark id as written to the current file
+     * @param id Format ID (never 0)
+     * @return true if the caller must write the FORMAT record
+     */
+    bool claim(uint32_t id);
+};
+
+/**
+ * @brief FNV-1a hash of a format string, used as its ID
+ * @param format Format string
+ * @return uint32_t non-zero format ID
+ */
+uint32_t EARS_logBinaryFormatId(const char* format);
+
+#endif // __EARS_LOG_BINARY_LIB_H__
+
+/****************************************************************************
+ * End of EARS_logBinaryLib.h
+ ***************************************************************************/
@@ -0,0 +1,348 @@
+/**
+ * @file EARS_logCompressLib.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Bounded-memory streaming compression of rotated log files
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_logCompressLib.h"
+#include "EARS_preallocLog.h"
+#include <string.h>
+
+/*
+  LZ4 block format limits: a match is at least 4 bytes, the last 5 bytes
+  are always literals and the last match starts at least 12 bytes before
+  the end, so blocks also decode with the reference LZ4 decoder.
+*/
+namespace {
+
+const size_t MIN_MATCH = 4;
+const size_t LAST_LITERALS = 5;
+const size_t MF_LIMIT = 12;
+const size_t MAX_OFFSET = 65535;
+// Misses before the search step grows (skips incompressible runs quickly)
+const unsigned SKIP_TRIGGER = 6;
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t hash32(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - EARS_lz4Block::HASH_LOG);
+}
+
+inline void put16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+inline uint16_t get16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/*
+  Bounded output for one block
+*/
+struct Output {
+    uint8_t* out;
+    size_t used;
+    size_t capacity;
+
+    bool room(size_t bytes) const { return used + bytes <= capacity; }
+
+    // Length beyond the 4 bit token field as a run of 255s
+    bool putLength(size_t length) {
+        while (length >= 255) {
+            if (!room(1)) return false;
+            out[used++] = 255;
+            length -= 255;
+        }
+        if (!room(1)) return false;
+        out[used++] = (uint8_t)length;
+        return true;
+    }
+
+    bool sequence(const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength) {
+        if (!room(1)) return false;
+        size_t tokenAt = used++;
+        uint8_t token = (uint8_t)((literalLength < 15 ? literalLength : 15) << 4);
+        if (literalLength >= 15 && !putLength(literalLength - 15)) return false;
+        if (!room(literalLength)) return false;
+        memcpy(out + used, literals, literalLength);
+        used += literalLength;
+
+        if (matchLength > 0) {
+            if (!room(2)) return false;
+            put16(out + used, (uint16_t)offset);
+            used += 2;
+            size_t extra = matchLength - MIN_MATCH;
+            token |= (uint8_t)(extra < 15 ? extra : 15);
+            if (extra >= 15 && !putLength(extra - 15)) return false;
+        }
+        out[tokenAt] = token;
+        return true;
+    }
+};
+
+} // namespace
+
+/**
+ * @brief Compress one block
+ * @param in Raw bytes, at most 65535
+ * @param length Number of raw bytes
+ * @param out Destination
+ * @param capacity Size of out
+ * @param table Hash table, TABLE_BYTES, contents are overwritten
+ * @return size_t packed length, 0 if it did not fit capacity
+ */
+size_t EARS_lz4Block::compress(const uint8_t* in, size_t length, uint8_t* out, size_t capacity, uint16_t* table) {
+    if (length == 0 || length > 65535) {
+        return 0;
+    }
+
+    Output output = { out, 0, capacity };
+    size_t anchor = 0;
+
+    if (length > MF_LIMIT) {
+        memset(table, 0, TABLE_BYTES);
+        const size_t matchStartLimit = length - MF_LIMIT;
+        const size_t matchEndLimit = length - LAST_LITERALS;
+        size_t position = 1;
+        table[hash32(read32(in))] = 0;
+        unsigned misses = 0;
+
+        while (position < matchStartLimit) {
+            uint32_t sequence = read32(in + position);
+            uint32_t slot = hash32(sequence);
+            size_t candidate = table[slot];
+            table[slot] = (uint16_t)position;
+
+            if (candidate >= position || position - candidate > MAX_OFFSET || read32(in + candidate) != sequence) {
+                position += 1 + (misses++ >> SKIP_TRIGGER);
+                continue;
+            }
+            misses = 0;
+
+            // Extend backwards over literals, then forwards
+            while (position > anchor && candidate > 0 && in[position - 1] == in[candidate - 1]) {
+                position--;
+                candidate--;
+            }
+            size_t matchLength = MIN_MATCH;
+            while (position + matchLength < matchEndLimit && in[candidate + matchLength] == in[position + matchLength]) {
+                matchLength++;
+            }
+
+            if (!output.sequence(in + anchor, position - anchor, position - candidate, matchLength)) {
+                return 0;
+            }
+            position += matchLength;
+            anchor = position;
+
+            // Remember the position just before the next search start too
+            if (position < matchStartLimit) {
+                table[hash32(read32(in + position - 2))] = (uint16_t)(position - 2);
+            }
+        }
+    }
+
+    if (!output.sequence(in + anchor, length - anchor, 0, 0)) {
+        return 0;
+    }
+    return output.used;
+}
+
+/**
+ * @brief Decompress one block, checking every bound
+ * @param in Packed bytes
+ * @param length Number of packed bytes
+ * @param out Destination
+ * @param capacity Size of out
+ * @return size_t raw length, 0 if the block is corrupt or does not fit
+ */
+size_t EARS_lz4Block::decompress(const uint8_t* in, size_t length, uint8_t* out, size_t capacity) {
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < length) {
+        uint8_t token = in[ip++];
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15) {
+            uint8_t byte;
+            do {
+                if (ip >= length) return 0;
+                byte = in[ip++];
+                literalLength += byte;
+            } while (byte == 255);
+        }
+        if (literalLength > length - ip || literalLength > capacity - op) {
+            return 0;
+        }
+        memcpy(out + op, in + ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        // The last sequence has literals only
+        if (ip == length) {
+            return op;
+        }
+
+        if (length - ip < 2) return 0;
+        size_t offset = get16(in + ip);
+        ip += 2;
+        if (offset == 0 || offset > op) {
+            return 0;
+        }
+
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15) {
+            uint8_t byte;
+            do {
+                if (ip >= length) return 0;
+                byte = in[ip++];
+                matchLength += byte;
+            } while (byte == 255);
+        }
+        matchLength += MIN_MATCH;
+        if (matchLength > capacity - op) {
+            return 0;
+        }
+
+        // Byte by byte: the match may overlap what it produces
+        const uint8_t* match = out + op - offset;
+        for (size_t i = 0; i < matchLength; i++) {
+            out[op + i] = match[i];
+        }
+        op += matchLength;
+    }
+    return 0;
+}
+
+/**
+ * @brief Workspace a compressor with this block size needs
+ * @param blockBytes Block size
+ * @return size_t bytes for begin()
+ */
+size_t EARS_logCompressor::workspaceBytes(size_t blockBytes) {
+    return EARS_lz4Block::TABLE_BYTES + blockBytes + FILE_HEADER_BYTES + BLOCK_HEADER_BYTES + blockBytes;
+}
+
+/**
+ * @brief Construct a compressor without workspace
+ */
+EARS_logCompressor::EARS_logCompressor()
+    : _input(nullptr), _output(nullptr), _table(nullptr), _blockBytes(0) {
+}
+
+/**
+ * @brief Attach the caller's workspace
+ * @param workspace Memory of at least workspaceBytes(blockBytes), 2 byte aligned
+ * @param bytes Size of workspace
+ * @param blockBytes Block size, 64 to MAX_BLOCK_BYTES
+ * @return true if ready
+ */
+bool EARS_logCompressor::begin(uint8_t* workspace, size_t bytes, size_t blockBytes) {
+    if (workspace == nullptr || ((uintptr_t)workspace & 1) != 0 ||
+        blockBytes < 64 || blockBytes > MAX_BLOCK_BYTES || bytes < workspaceBytes(blockBytes)) {
+        return false;
+    }
+    _table = reinterpret_cast<uint16_t*>(workspace);
+    _input = workspace + EARS_lz4Block::TABLE_BYTES;
+    _output = _input + blockBytes;
+    _blockBytes = blockBytes;
+    return true;
+}
+
+/**
+ * @brief Compress fromPath into a new file at toPath
+ * @param fs File system
+ * @param fromPath Plain source file
+ * @param toPath Destination, removed first if it exists
+ * @param stats Receives sizes
+ * @return true if toPath holds the complete compressed file
+ */
+bool EARS_logCompressor::compressFile(EARS_fsPort& fs, const char* fromPath, const char* toPath, LogCompressStats& stats) {
+    stats = LogCompressStats();
+    if (_input == nullptr || !fs.fileExists(fromPath)) {
+        return false;
+    }
+    if (fs.fileExists(toPath) && !fs.removeFile(toPath)) {
+        return false;
+    }
+
+    // The file header rides along with the first block
+    memcpy(_output, EARS_LOG_COMPRESS_MAGIC, 4);
+    put16(_output + 4, (uint16_t)_blockBytes);
+    size_t used = FILE_HEADER_BYTES;
+
+    // Of a preallocated file only the committed data
+    uint32_t offset = 0;
+    uint32_t limit = UINT32_MAX;
+    PreallocHeader extent;
+    if (EARS_preallocLog::readHeader(fs, fromPath, extent)) {
+        offset = EARS_preallocLog::HEADER_BYTES;
+        limit = EARS_preallocLog::HEADER_BYTES + extent.end;
+    }
+    for (;;) {
+        size_t wanted = limit - offset < _blockBytes ? limit - offset : _blockBytes;
+        size_t rawLength = wanted ? fs.readFileAt(fromPath, offset, _input, wanted) : 0;
+        if (rawLength == 0) {
+            break;
+        }
+        offset += rawLength;
+
+        // Only worth keeping if smaller than the raw block
+        uint8_t* block = _output + used;
+        size_t packed = EARS_lz4Block::compress(_input, rawLength, block + BLOCK_HEADER_BYTES, rawLength - 1, _table);
+        put16(block, (uint16_t)rawLength);
+        put16(block + 2, (uint16_t)packed);
+        if (packed == 0) {
+            memcpy(block + BLOCK_HEADER_BYTES, _input, rawLength);
+            packed = rawLength;
+            stats.storedBlocks++;
+        }
+        used += BLOCK_HEADER_BYTES + packed;
+
+        if (!fs.appendFile(toPath, _output, used)) {
+            return false;
+        }
+        stats.rawBytes += rawLength;
+        stats.packedBytes += used;
+        stats.blocks++;
+        used = 0;
+    }
+
+    // Empty source: header only
+    if (used > 0) {
+        if (!fs.appendFile(toPath, _output, used)) {
+            return false;
+        }
+        stats.packedBytes += used;
+    }
+    return true;
+}
+
+/**
+ * @brief Check whether a file starts with the compressed file magic
+ * @param fs File system
+ * @param path File path
+ * @return true if compressed
+ */
+bool EARS_logCompressor::isCompressed(EARS_fsPort& fs, const char* path) {
+    uint8_t magic[4];
+    return fs.readFileAt(path, 0, magic, sizeof(magic)) == sizeof(magic) &&
+           memcmp(magic, EARS_LOG_COMPRESS_MAGIC, sizeof(magic)) == 0;
+}
+
+/****************************************************************************
+ * End of EARS_logCompressLib.cpp
+ ***************************************************************************/
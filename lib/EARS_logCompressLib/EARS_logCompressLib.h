@@ -0,0 +1,158 @@
+/**
+ * @file EARS_logCompressLib.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Bounded-memory streaming compression of rotated log files
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @details
+ * A file is compressed in independent blocks. Each block is a standard LZ4
+ * block (greedy single-hash matcher), so memory stays fixed at one input
+ * block, one output block and the hash table whatever the file size, and a
+ * reader only ever needs one block of each.
+ *
+ * File layout (little endian):
+ * - header: "ELZ4", u16 block size
+ * - blocks: u16 raw length, u16 packed length, packed bytes
+ *
+ * A packed length of 0 means the block is stored as is (raw length bytes),
+ * used when LZ4 does not make it smaller. Files without the magic are plain
+ * and EARS_logCompressReader passes them through unchanged.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_LOG_COMPRESS_LIB_H__
+#define __EARS_LOG_COMPRESS_LIB_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "EARS_fsPortLib.h"
+
+// File header magic
+#define EARS_LOG_COMPRESS_MAGIC "ELZ4"
+
+/**
+ * @brief Result of compressing one file
+ */
+struct LogCompressStats {
+    uint32_t rawBytes;      // Bytes read from the source
+    uint32_t packedBytes;   // Bytes written, headers included
+    uint32_t blocks;
+    uint32_t storedBlocks;  // Blocks kept uncompressed
+
+    LogCompressStats() : rawBytes(0), packedBytes(0), blocks(0), storedBlocks(0) {}
+
+    /**
+     * @brief Compression ratio
+     * @return float raw size / compressed size (0 if nothing written)
+     */
+    float ratio() const {
+        return packedBytes ? (float)rawBytes / (float)packedBytes : 0.0f;
+    }
+};
+
+/**
+ * @brief LZ4 block codec
+ */
+class EARS_lz4Block {
+public:
+    // Hash table entries (u16 positions), 2^HASH_LOG
+    static const unsigned HASH_LOG = 12;
+    static const size_t TABLE_BYTES = (1u << HASH_LOG) * sizeof(uint16_t);
+
+    /**
+     * @brief Worst case packed size of a block
+     * @param rawLength Block size in bytes
+     * @return size_t bytes compress() may need
+     */
+    static size_t bound(size_t rawLength) { return rawLength + rawLength / 255 + 16; }
+
+    /**
+     * @brief Compress one block
+     * @param in Raw bytes, at most 65535
+     * @param length Number of raw bytes
+     * @param out Destination
+     * @param capacity Size of out
+     * @param table Hash table, TABLE_BYTES, contents are overwritten
+     * @return size_t packed length, 0 if it did not fit capacity
+     */
+    static size_t compress(const uint8_t* in, size_t length, uint8_t* out, size_t capacity, uint16_t* table);
+
+    /**
+     * @brief Decompress one block, checking every bound
+     * @param in Packed bytes
+     * @param length Number of packed bytes
+     * @param out Destination
+     * @param capacity Size of out
+     * @return size_t raw length, 0 if the block is corrupt or does not fit
+     */
+    static size_t decompress(const uint8_t* in, size_t length, uint8_t* out, size_t capacity);
+};
+
+/**
+ * @brief Compresses whole files through EARS_fsPort with fixed memory
+ */
+class EARS_logCompressor {
+public:
+    static const size_t FILE_HEADER_BYTES = 6;
+    static const size_t BLOCK_HEADER_BYTES = 4;
+    static const size_t DEFAULT_BLOCK_BYTES = 8192;
+    static const size_t MAX_BLOCK_BYTES = 32768;
+
+    /**
+     * @brief Workspace a compressor with this block size needs
+     * @param blockBytes Block size
+     * @return size_t bytes for begin()
+     */
+    static size_t workspaceBytes(size_t blockBytes);
+
+    EARS_logCompressor();
+
+    /**
+     * @brief Attach the caller's workspace
+     * @param workspace Memory of at least workspaceBytes(blockBytes), 2 byte aligned
+     * @param bytes Size of workspace
+     * @param blockBytes Block size, 64 to MAX_BLOCK_BYTES
+     * @return true if ready
+     */
+    bool begin(uint8_t* workspace, size_t bytes, size_t blockBytes = DEFAULT_BLOCK_BYTES);
+
+    /**
+     * @brief Compress fromPath into a new file at toPath
+     * @param fs File system
+     * @param fromPath Plain source file
+     * @param toPath Destination, removed first if it exists
+     * @param stats Receives sizes
+     * @return true if toPath holds the complete compressed file
+     *
+     * Of a preallocated source (EARS_preallocLog) only the committed data
+     * is compressed; stats.rawBytes is its length. The source is not modified. On failure toPath may hold a partial
+     * file; callers write to a temporary name and rename on success.
+     */
+    bool compressFile(EARS_fsPort& fs, const char* fromPath, const char* toPath, LogCompressStats& stats);
+
+    /**
+     * @brief Check whether a file starts with the compressed file magic
+     * @param fs File system
+     * @param path File path
+     * @return true if compressed
+     */
+    static bool isCompressed(EARS_fsPort& fs, const char* path);
+
+private:
+    uint8_t* _input;
+    uint8_t* _output;
+    uint16_t* _table;
+    size_t _blockBytes;
+};
+
+#endif // __EARS_LOG_COMPRESS_LIB_H__
+
+/****************************************************************************
+ * End of EARS_logCompressLib.h
+ ***************************************************************************/
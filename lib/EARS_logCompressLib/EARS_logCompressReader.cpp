@@ -0,0 +1,189 @@
+/**
+ * @file EARS_logCompressReader.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Streaming reader for compressed and plain log files
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_logCompressReader.h"
+#include "EARS_preallocLog.h"
+#include <string.h>
+
+/**
+ * @brief Workspace a reader for blocks up to maxBlockBytes needs
+ * @param maxBlockBytes Largest block size the reader accepts
+ * @return size_t bytes for begin()
+ */
+size_t EARS_logCompressReader::workspaceBytes(size_t maxBlockBytes) {
+    return EARS_logCompressor::BLOCK_HEADER_BYTES + EARS_lz4Block::bound(maxBlockBytes) + maxBlockBytes;
+}
+
+/**
+ * @brief Construct a reader without workspace
+ */
+EARS_logCompressReader::EARS_logCompressReader()
+    : _fs(nullptr),
+      _offset(0),
+      _limit(0),
+      _compressed(false),
+      _failed(false),
+      _ended(true),
+      _packed(nullptr),
+      _raw(nullptr),
+      _maxBlockBytes(0),
+      _fileBlockBytes(0),
+      _rawLength(0),
+      _rawPosition(0) {
+    _path[0] = '\0';
+}
+
+/**
+ * @brief Attach the caller's workspace
+ * @param workspace Memory of at least workspaceBytes(maxBlockBytes)
+ * @param bytes Size of workspace
+ * @param maxBlockBytes Largest block size accepted
+ * @return true if ready
+ */
+bool EARS_logCompressReader::begin(uint8_t* workspace, size_t bytes, size_t maxBlockBytes) {
+    if (workspace == nullptr || maxBlockBytes == 0 ||
+        maxBlockBytes > EARS_logCompressor::MAX_BLOCK_BYTES || bytes < workspaceBytes(maxBlockBytes)) {
+        return false;
+    }
+    _packed = workspace;
+    _raw = workspace + EARS_logCompressor::BLOCK_HEADER_BYTES + EARS_lz4Block::bound(maxBlockBytes);
+    _maxBlockBytes = maxBlockBytes;
+    return true;
+}
+
+/**
+ * @brief Start reading a file
+ * @param fs File system
+ * @param path File path
+ * @return true if the file exists and its header is valid
+ */
+bool EARS_logCompressReader::open(EARS_fsPort& fs, const char* path) {
+    _fs = &fs;
+    _offset = 0;
+    _limit = UINT32_MAX;
+    _compressed = false;
+    _failed = false;
+    _ended = true;
+    _rawLength = 0;
+    _rawPosition = 0;
+
+    if (_packed == nullptr || strlen(path) >= sizeof(_path) || !fs.fileExists(path)) {
+        return false;
+    }
+    strcpy(_path, path);
+    _ended = false;
+
+    // Preallocated: plain data between the header and the committed end
+    PreallocHeader extent;
+    if (EARS_preallocLog::readHeader(fs, path, extent)) {
+        _offset = EARS_preallocLog::HEADER_BYTES;
+        _limit = EARS_preallocLog::HEADER_BYTES + extent.end;
+        return true;
+    }
+
+    uint8_t header[EARS_logCompressor::FILE_HEADER_BYTES];
+    size_t got = fs.readFileAt(path, 0, header, sizeof(header));
+    if (got < 4 || memcmp(header, EARS_LOG_COMPRESS_MAGIC, 4) != 0) {
+        // Plain file
+        return true;
+    }
+
+    _compressed = true;
+    _fileBlockBytes = got == sizeof(header) ? (size_t)(header[4] | (header[5] << 8)) : 0;
+    if (_fileBlockBytes == 0 || _fileBlockBytes > _maxBlockBytes) {
+        _failed = true;
+        _ended = true;
+        return false;
+    }
+    _offset = EARS_logCompressor::FILE_HEADER_BYTES;
+    return true;
+}
+
+/**
+ * @brief Read the next original bytes
+ * @param out Destination
+ * @param length Bytes wanted
+ * @return size_t bytes delivered, 0 at the end of the file or on error
+ */
+size_t EARS_logCompressReader::read(uint8_t* out, size_t length) {
+    if (_ended || _fs == nullptr) {
+        return 0;
+    }
+
+    if (!_compressed) {
+        if (length > _limit - _offset) {
+            length = _limit - _offset;
+        }
+        size_t got = length ? _fs->readFileAt(_path, _offset, out, length) : 0;
+        _offset += got;
+        if (got == 0) {
+            _ended = true;
+        }
+        return got;
+    }
+
+    size_t delivered = 0;
+    while (delivered < length) {
+        if (_rawPosition == _rawLength && !nextBlock()) {
+            break;
+        }
+        size_t count = _rawLength - _rawPosition;
+        if (count > length - delivered) {
+            count = length - delivered;
+        }
+        memcpy(out + delivered, _raw + _rawPosition, count);
+        _rawPosition += count;
+        delivered += count;
+    }
+    return delivered;
+}
+
+/**
+ * @brief Load and decompress the next block
+ * @return true if a block is ready, false at the end or on error
+ */
+bool EARS_logCompressReader::nextBlock() {
+    // One read covers the block header and the largest possible payload
+    const size_t headerBytes = EARS_logCompressor::BLOCK_HEADER_BYTES;
+    size_t got = _fs->readFileAt(_path, _offset, _packed, headerBytes + EARS_lz4Block::bound(_fileBlockBytes));
+    if (got == 0) {
+        _ended = true;
+        return false;
+    }
+
+    size_t rawLength = _packed[0] | (_packed[1] << 8);
+    size_t packedLength = _packed[2] | (_packed[3] << 8);
+    size_t payload = packedLength ? packedLength : rawLength;
+    if (got < headerBytes || rawLength == 0 || rawLength > _fileBlockBytes || payload > got - headerBytes) {
+        _failed = true;
+        _ended = true;
+        return false;
+    }
+
+    if (packedLength == 0) {
+        memcpy(_raw, _packed + headerBytes, rawLength);
+    } else if (EARS_lz4Block::decompress(_packed + headerBytes, packedLength, _raw, rawLength) != rawLength) {
+        _failed = true;
+        _ended = true;
+        return false;
+    }
+
+    _offset += headerBytes + payload;
+    _rawLength = rawLength;
+    _rawPosition = 0;
+    return true;
+}
+
+/****************************************************************************
+ * End of EARS_logCompressReader.cpp
+ ***************************************************************************/
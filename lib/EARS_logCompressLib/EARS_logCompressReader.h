@@ -0,0 +1,109 @@
+/**
+ * @file EARS_logCompressReader.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Streaming reader for compressed and plain log files
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @details
+ * Reads a log generation through EARS_fsPort, decompressing one block at a
+ * time, so the same code serves the device (EARS_sdCard) and host tools
+ * (EARS_stdioFs). Plain files are passed through, so callers need not know
+ * whether a generation has been compressed yet; of a preallocated file
+ * (EARS_preallocLog) only the committed data is returned.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_LOG_COMPRESS_READER_H__
+#define __EARS_LOG_COMPRESS_READER_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "EARS_fsPortLib.h"
+#include "EARS_logCompressLib.h"
+
+/**
+ * @brief Pull-style reader returning the original file bytes
+ */
+class EARS_logCompressReader {
+public:
+    /**
+     * @brief Workspace a reader for blocks up to maxBlockBytes needs
+     * @param maxBlockBytes Largest block size the reader accepts
+     * @return size_t bytes for begin()
+     */
+    static size_t workspaceBytes(size_t maxBlockBytes);
+
+    EARS_logCompressReader();
+
+    /**
+     * @brief Attach the caller's workspace
+     * @param workspace Memory of at least workspaceBytes(maxBlockBytes)
+     * @param bytes Size of workspace
+     * @param maxBlockBytes Largest block size accepted
+     * @return true if ready
+     */
+    bool begin(uint8_t* workspace, size_t bytes,
+               size_t maxBlockBytes = EARS_logCompressor::DEFAULT_BLOCK_BYTES);
+
+    /**
+     * @brief Start reading a file
+     * @param fs File system, must outlive the reader's use of the file
+     * @param path File path
+     * @return true if the file exists and its header is valid
+     */
+    bool open(EARS_fsPort& fs, const char* path);
+
+    /**
+     * @brief Read the next original bytes
+     * @param out Destination
+     * @param length Bytes wanted
+     * @return size_t bytes delivered, 0 at the end of the file or on error
+     */
+    size_t read(uint8_t* out, size_t length);
+
+    /**
+     * @brief Whether the open file is compressed
+     * @return true if compressed
+     */
+    bool isCompressed() const { return _compressed; }
+
+    /**
+     * @brief Whether reading stopped at a corrupt or cut off block
+     * @return true if the file is damaged
+     */
+    bool failed() const { return _failed; }
+
+private:
+    EARS_fsPort* _fs;
+    char _path[EARS_FS_PORT_MAX_PATH];
+    uint32_t _offset;           // Next file byte to read
+    uint32_t _limit;            // Plain files: end of the data
+    bool _compressed;
+    bool _failed;
+    bool _ended;
+
+    uint8_t* _packed;           // Block header plus packed bytes
+    uint8_t* _raw;              // Current decompressed block
+    size_t _maxBlockBytes;
+    size_t _fileBlockBytes;     // Block size from the file header
+    size_t _rawLength;
+    size_t _rawPosition;
+
+    /**
+     * @brief Load and decompress the next block
+     * @return true if a block is ready, false at the end or on error
+     */
+    bool nextBlock();
+};
+
+#endif // __EARS_LOG_COMPRESS_READER_H__
+
+/****************************************************************************
+ * End of EARS_logCompressReader.h
+ ***************************************************************************/
@@ -0,0 +1,114 @@
+/**
+ * @file EARS_logFilterLib.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Compile-time and runtime per-module log filtering
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_logFilterLib.h"
+#include <strings.h>
+
+namespace {
+
+const char* const TAG_NAMES[(size_t)LogTag::COUNT] = {
+    "APP",
+    "LOGGER",
+    "SDCARD",
+    "NVS",
+    "BACKLIGHT",
+    "SCREENSAVER",
+    "ERRORS",
+    "FLOW"
+};
+
+} // namespace
+
+/**
+ * @brief Construct with every module at DEBUG (the global level decides)
+ */
+EARS_logTagLevels::EARS_logTagLevels() {
+    setAll(EARS_LOG_LEVEL_DEBUG);
+}
+
+/**
+ * @brief Set one module's level
+ * @param tag Module tag
+ * @param level Most verbose level logged for tag
+ * @return void
+ */
+void EARS_logTagLevels::set(LogTag tag, uint8_t level) {
+    if (tag < LogTag::COUNT) {
+        _levels[(size_t)tag].store(level, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Set every module's level
+ * @param level Most verbose level logged
+ * @return void
+ */
+void EARS_logTagLevels::setAll(uint8_t level) {
+    for (size_t i = 0; i < (size_t)LogTag::COUNT; i++) {
+        _levels[i].store(level, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Take a whole table of levels
+ * @param levels Level per LogTag, (size_t)LogTag::COUNT entries
+ * @return void
+ */
+void EARS_logTagLevels::assign(const uint8_t* levels) {
+    for (size_t i = 0; i < (size_t)LogTag::COUNT; i++) {
+        if (_levels[i].load(std::memory_order_relaxed) != levels[i]) {
+            _levels[i].store(levels[i], std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Get one module's level
+ * @param tag Module tag
+ * @return uint8_t most verbose level logged for tag
+ */
+uint8_t EARS_logTagLevels::get(LogTag tag) const {
+    if (tag >= LogTag::COUNT) {
+        return EARS_LOG_LEVEL_NONE;
+    }
+    return _levels[(size_t)tag].load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Tag name as used in ears.config
+ * @param tag Module tag
+ * @return const char* e.g. "SDCARD"
+ */
+const char* EARS_logTagLevels::tagName(LogTag tag) {
+    return (tag < LogTag::COUNT) ? TAG_NAMES[(size_t)tag] : "UNKNOWN";
+}
+
+/**
+ * @brief Look up a tag by name (case insensitive)
+ * @param name e.g. "sdcard"
+ * @param tag Receives the tag
+ * @return true if name is a tag
+ */
+bool EARS_logTagLevels::parseTag(const char* name, LogTag& tag) {
+    for (size_t i = 0; i < (size_t)LogTag::COUNT; i++) {
+        if (strcasecmp(name, TAG_NAMES[i]) == 0) {
+            tag = (LogTag)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*****************************************************************************
+ * End of EARS_logFilterLib.cpp
+ ****************************************************************************/
@@ -0,0 +1,183 @@
+/**
+ * @file EARS_logFilterLib.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Compile-time and runtime per-module log filtering
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @details
+ * Every tagged log statement passes two filters before its arguments are
+ * evaluated:
+ * - Compile time: EARS_LOG_COMPILE_LEVEL_<TAG> is the most verbose level
+ *   built in for a module. Statements above it are constant-false and the
+ *   compiler removes them, format strings included.
+ * - Runtime: EARS_logTagLevels holds one level per module, checked with a
+ *   single relaxed load.
+ *
+ * The compile-time level defaults to DEBUG with EARS_DEBUG=1 and INFO
+ * otherwise. Override it for all modules with EARS_LOG_COMPILE_LEVEL or for
+ * one module with e.g. -D EARS_LOG_COMPILE_LEVEL_SDCARD=EARS_LOG_LEVEL_WARN.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_LOG_FILTER_LIB_H__
+#define __EARS_LOG_FILTER_LIB_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Level numbers, the same values as LogLevel in EARS_loggerLib.h
+#define EARS_LOG_LEVEL_NONE 0
+#define EARS_LOG_LEVEL_ERROR 1
+#define EARS_LOG_LEVEL_WARN 2
+#define EARS_LOG_LEVEL_INFO 3
+#define EARS_LOG_LEVEL_DEBUG 4
+
+/**
+ * @brief Module a log statement belongs to
+ */
+enum class LogTag : uint8_t {
+    APP = 0,        // Application code and untagged LOG_* macros
+    LOGGER,         // EARS_loggerLib
+    SDCARD,         // EARS_sdCardLib
+    NVS,            // EARS_nvsEepromLib
+    BACKLIGHT,      // EARS_backLightManagerLib
+    SCREENSAVER,    // EARS_screenSaverLib
+    ERRORS,         // EARS_errorsLib
+    FLOW,           // EEZ Flow UI
+    COUNT           // Number of tags, not a tag
+};
+
+/******************************************************************************
+ * Compile-time levels
+ *****************************************************************************/
+#ifndef EARS_LOG_COMPILE_LEVEL
+    #if defined(EARS_DEBUG) && EARS_DEBUG
+        #define EARS_LOG_COMPILE_LEVEL EARS_LOG_LEVEL_DEBUG
+    #else
+        #define EARS_LOG_COMPILE_LEVEL EARS_LOG_LEVEL_INFO
+    #endif
+#endif
+
+#ifndef EARS_LOG_COMPILE_LEVEL_APP
+    #define EARS_LOG_COMPILE_LEVEL_APP EARS_LOG_COMPILE_LEVEL
+#endif
+#ifndef EARS_LOG_COMPILE_LEVEL_LOGGER
+    #define EARS_LOG_COMPILE_LEVEL_LOGGER EARS_LOG_COMPILE_LEVEL
+#endif
+#ifndef EARS_LOG_COMPILE_LEVEL_SDCARD
+    #define EARS_LOG_COMPILE_LEVEL_SDCARD EARS_LOG_COMPILE_LEVEL
+#endif
+#ifndef EARS_LOG_COMPILE_LEVEL_NVS
+    #define EARS_LOG_COMPILE_LEVEL_NVS EARS_LOG_COMPILE_LEVEL
+#endif
+#ifndef EARS_LOG_COMPILE_LEVEL_BACKLIGHT
+    #define EARS_LOG_COMPILE_LEVEL_BACKLIGHT EARS_LOG_COMPILE_LEVEL
+#endif
+#ifndef EARS_LOG_COMPILE_LEVEL_SCREENSAVER
+    #define EARS_LOG_COMPILE_LEVEL_SCREENSAVER EARS_LOG_COMPILE_LEVEL
+#endif
+#ifndef EARS_LOG_COMPILE_LEVEL_ERRORS
+    #define EARS_LOG_COMPILE_LEVEL_ERRORS EARS_LOG_COMPILE_LEVEL
+#endif
+#ifndef EARS_LOG_COMPILE_LEVEL_FLOW
+    #define EARS_LOG_COMPILE_LEVEL_FLOW EARS_LOG_COMPILE_LEVEL
+#endif
+
+// True if statements for tag at level are built in (a constant expression)
+#define EARS_LOG_COMPILED(tag, level) ((level) <= EARS_LOG_COMPILE_LEVEL_##tag)
+
+/**
+ * @brief Run statement only if tag/level is built in and enabled evaluates true
+ *
+ * enabled and statement are never evaluated for compiled out levels, and
+ * statement (with its arguments) only when enabled is true.
+ */
+#define EARS_LOG_IF(tag, level, enabled, statement) \
+    do { \
+        if (EARS_LOG_COMPILED(tag, level) && (enabled)) { \
+            statement; \
+        } \
+    } while (0)
+
+/**
+ * @brief Runtime level per module
+ *
+ * Safe to read from any task while another changes a level.
+ */
+class EARS_logTagLevels {
+public:
+    EARS_logTagLevels();
+
+    /**
+     * @brief Check if a tag logs at level
+     * @param tag Module tag
+     * @param level Level number (EARS_LOG_LEVEL_*)
+     * @return true if level is enabled for tag
+     */
+    bool allows(LogTag tag, uint8_t level) const {
+        return level <= _levels[(size_t)tag].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Set one module's level
+     * @param tag Module tag
+     * @param level Most verbose level logged for tag
+     * @return void
+     */
+    void set(LogTag tag, uint8_t level);
+
+    /**
+     * @brief Set every module's level
+     * @param level Most verbose level logged
+     * @return void
+     */
+    void setAll(uint8_t level);
+
+    /**
+     * @brief Take a whole table of levels
+     * @param levels Level per LogTag, (size_t)LogTag::COUNT entries
+     * @return void
+     *
+     * Only levels that differ are stored, so readers never see a module
+     * pass through another level on its way to the new one.
+     */
+    void assign(const uint8_t* levels);
+
+    /**
+     * @brief Get one module's level
+     * @param tag Module tag
+     * @return uint8_t most verbose level logged for tag
+     */
+    uint8_t get(LogTag tag) const;
+
+    /**
+     * @brief Tag name as used in ears.config
+     * @param tag Module tag
+     * @return const char* e.g. "SDCARD"
+     */
+    static const char* tagName(LogTag tag);
+
+    /**
+     * @brief Look up a tag by name (case insensitive)
+     * @param name e.g. "sdcard"
+     * @param tag Receives the tag
+     * @return true if name is a tag
+     */
+    static bool parseTag(const char* name, LogTag& tag);
+
+private:
+    std::atomic<uint8_t> _levels[(size_t)LogTag::COUNT];
+};
+
+#endif // __EARS_LOG_FILTER_LIB_H__
+
+/****************************************************************************
+ * End of EARS_logFilterLib.h
+ ***************************************************************************/
@@ -0,0 +1,471 @@
+/**
+ * @file EARS_logRingLib.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Fixed-size log entry ring and batch flusher for asynchronous logging
+ * @version 1.2.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_logRingLib.h"
+#include <string.h>
+#include <chrono>
+#include <algorithm>
+#include <new>
+#include <thread>
+
+/**
+ * @brief Construct an empty ring, begin() must be called before use
+ */
+EARS_logRing::EARS_logRing() :
+    _sequence(nullptr),
+    _storage(nullptr),
+    _slotBytes(0),
+    _slotCount(0),
+    _slotMask(0),
+    _enqueuePos(0),
+    _dequeuePos(0),
+    _open(false),
+    _policy((uint8_t)LogOverflowPolicy::DROP_OLDEST),
+    _blockTimeoutMs(100),
+    _consumerWants(0),
+    _blockedProducers(0) {
+    resetStats();
+}
+
+/**
+ * @brief Destructor, wakes anyone still waiting and frees the sequences
+ */
+EARS_logRing::~EARS_logRing() {
+    end();
+    delete[] _sequence;
+}
+
+/**
+ * @brief Attach storage and reset the ring
+ * @param storage Buffer owned by the caller
+ * @param storageBytes Size of storage in bytes
+ * @param slotBytes Size of one slot including its length header
+ * @param policy Overflow policy
+ * @return true if at least two slots fit in storage
+ * @return false if parameters are invalid
+ */
+bool EARS_logRing::begin(uint8_t* storage, size_t storageBytes, size_t slotBytes, LogOverflowPolicy policy) {
+    if (!storage || slotBytes <= SLOT_HEADER_BYTES || slotBytes > 0xFFFF + SLOT_HEADER_BYTES) {
+        return false;
+    }
+    if (storageBytes / slotBytes < 2) {
+        return false;
+    }
+
+    // Power of two so positions wrap cleanly at 2^32
+    size_t slots = 2;
+    while (slots * 2 <= storageBytes / slotBytes) {
+        slots *= 2;
+    }
+
+    if (slots != _slotCount) {
+        delete[] _sequence;
+        _sequence = new (std::nothrow) std::atomic<uint32_t>[slots];
+        if (!_sequence) {
+            _slotCount = 0;
+            return false;
+        }
+    }
+    for (size_t i = 0; i < slots; i++) {
+        _sequence[i].store((uint32_t)i, std::memory_order_relaxed);
+    }
+
+    _storage = storage;
+    _slotBytes = slotBytes;
+    _slotCount = slots;
+    _slotMask = slots - 1;
+    _enqueuePos.store(0, std::memory_order_relaxed);
+    _dequeuePos.store(0, std::memory_order_relaxed);
+    _policy.store((uint8_t)policy);
+    resetStats();
+    _open.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Detach storage and release any waiting producers or consumers
+ * @return void
+ */
+void EARS_logRing::end() {
+    _open.store(false);
+    _dequeuePos.store(_enqueuePos.load());
+    _storage = nullptr;
+    _notEmpty.notify_all();
+    _notFull.notify_all();
+}
+
+/**
+ * @brief Copy an entry into the ring
+ * @param data Entry bytes
+ * @param length Number of bytes
+ * @return true if the entry was queued
+ * @return false if it was dropped
+ */
+bool EARS_logRing::push(const char* data, size_t length) {
+    if (!_open.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    size_t payload = _slotBytes - SLOT_HEADER_BYTES;
+    if (length > payload) {
+        length = payload;
+        _truncated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool blocked = false;
+    uint32_t dropRetries = 0;
+    std::chrono::steady_clock::time_point deadline;
+
+    for (;;) {
+        uint32_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        std::atomic<uint32_t>& sequence = _sequence[pos & _slotMask];
+        int32_t diff = (int32_t)(sequence.load(std::memory_order_acquire) - pos);
+
+        if (diff == 0) {
+            // Slot free at this position - claim it
+            if (!_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                continue;
+            }
+            uint8_t* slot = _storage + (pos & _slotMask) * _slotBytes;
+            slot[0] = (uint8_t)(length & 0xFF);
+            slot[1] = (uint8_t)(length >> 8);
+            memcpy(slot + SLOT_HEADER_BYTES, data, length);
+            sequence.store(pos + 1, std::memory_order_release);
+
+            _pushed.fetch_add(1, std::memory_order_relaxed);
+            trackHighWater(pos);
+
+            // Wake the flusher once the batch it waits for is complete,
+            // only the first producer to see that pays for the notify
+            uint32_t wants = _consumerWants.load(std::memory_order_relaxed);
+            if (wants && pos + 1 - _dequeuePos.load(std::memory_order_relaxed) >= wants &&
+                _consumerWants.exchange(0)) {
+                _notEmpty.notify_one();
+            }
+            return true;
+        }
+
+        if (diff > 0) {
+            // Another producer claimed pos first
+            continue;
+        }
+
+        // Full: the slot still holds an entry from the previous lap
+        switch ((LogOverflowPolicy)_policy.load(std::memory_order_relaxed)) {
+            case LogOverflowPolicy::DROP_NEWEST:
+                _droppedNewest.fetch_add(1, std::memory_order_relaxed);
+                return false;
+
+            case LogOverflowPolicy::BLOCK:
+                if (!blocked) {
+                    blocked = true;
+                    _blockedPushes.fetch_add(1, std::memory_order_relaxed);
+                    deadline = std::chrono::steady_clock::now() +
+                               std::chrono::milliseconds(_blockTimeoutMs.load(std::memory_order_relaxed));
+                }
+                if (!_open.load() || std::chrono::steady_clock::now() >= deadline) {
+                    _droppedNewest.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                {
+                    _blockedProducers.fetch_add(1);
+                    std::unique_lock<std::mutex> lock(_waitMutex);
+                    _notFull.wait_until(lock, std::min(deadline, std::chrono::steady_clock::now() +
+                                                                 std::chrono::milliseconds(WAIT_POLL_MS)));
+                    _blockedProducers.fetch_sub(1);
+                }
+                break;
+
+            case LogOverflowPolicy::DROP_OLDEST:
+            default:
+                if (discardOldest()) {
+                    _droppedOldest.fetch_add(1, std::memory_order_relaxed);
+                } else if (++dropRetries >= DROP_OLDEST_RETRIES) {
+                    // The oldest slot belongs to a preempted task - never spin on it
+                    _droppedNewest.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                } else {
+                    std::this_thread::yield();
+                }
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Claim the oldest published entry and throw it away
+ * @return true if an entry was dropped
+ * @return false if the oldest entry is still being written or drained
+ */
+bool EARS_logRing::discardOldest() {
+    uint32_t pos = _dequeuePos.load(std::memory_order_relaxed);
+    std::atomic<uint32_t>& sequence = _sequence[pos & _slotMask];
+    if ((int32_t)(sequence.load(std::memory_order_acquire) - (pos + 1)) != 0) {
+        return false;
+    }
+    if (!_dequeuePos.compare_exchange_strong(pos, pos + 1, std::memory_order_relaxed)) {
+        // The flusher or another producer took it - that frees a slot too
+        return true;
+    }
+    sequence.store(pos + (uint32_t)_slotCount, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Raise the high water mark to the current fill level
+ * @param pos Position just published
+ * @return void
+ */
+void EARS_logRing::trackHighWater(uint32_t pos) {
+    uint32_t used = pos + 1 - _dequeuePos.load(std::memory_order_relaxed);
+    if (used > _slotCount) {
+        return;     // Stale read across a concurrent drain
+    }
+    uint32_t high = _highWater.load(std::memory_order_relaxed);
+    while (used > high && !_highWater.compare_exchange_weak(high, used, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Copy as many whole queued entries as fit into out
+ * @param out Destination buffer
+ * @param capacity Size of out in bytes
+ * @return size_t Number of bytes written to out
+ */
+size_t EARS_logRing::drain(char* out, size_t capacity) {
+    if (!_open.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    size_t used = 0;
+    uint32_t taken = 0;
+    for (;;) {
+        uint32_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        std::atomic<uint32_t>& sequence = _sequence[pos & _slotMask];
+        int32_t diff = (int32_t)(sequence.load(std::memory_order_acquire) - (pos + 1));
+        if (diff < 0) {
+            // Empty, or the next entry is still being copied in - keep order
+            break;
+        }
+        if (diff > 0) {
+            // A DROP_OLDEST producer moved the head
+            continue;
+        }
+
+        const uint8_t* slot = _storage + (pos & _slotMask) * _slotBytes;
+        size_t length = (size_t)slot[0] | ((size_t)slot[1] << 8);
+        if (used + length > capacity) {
+            break;
+        }
+        if (!_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            continue;
+        }
+        memcpy(out + used, slot + SLOT_HEADER_BYTES, length);
+        sequence.store(pos + (uint32_t)_slotCount, std::memory_order_release);
+        used += length;
+        taken++;
+    }
+    _drained.fetch_add(taken, std::memory_order_relaxed);
+    if (taken > 0 && _blockedProducers.load()) {
+        _notFull.notify_all();
+    }
+    return used;
+}
+
+/**
+ * @brief Wait until at least minEntries are queued
+ * @param minEntries Entry count to wait for
+ * @param timeoutMs Maximum wait in milliseconds
+ * @return true if any entries are queued on return
+ * @return false if the ring is empty
+ *
+ * Producers wake the flusher once minEntries are queued; the
+ * WAIT_POLL_MS re-check covers a wakeup sent just before it slept.
+ */
+bool EARS_logRing::waitFor(size_t minEntries, uint32_t timeoutMs) {
+    if (minEntries == 0) {
+        minEntries = 1;
+    }
+    if (minEntries > _slotCount) {
+        minEntries = _slotCount;
+    }
+
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::unique_lock<std::mutex> lock(_waitMutex);
+    while (_open.load() && pending() < minEntries) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            break;
+        }
+        _consumerWants.store((uint32_t)minEntries);
+        _notEmpty.wait_until(lock, std::min(deadline, now + std::chrono::milliseconds(WAIT_POLL_MS)));
+    }
+    _consumerWants.store(0);
+    return pending() > 0;
+}
+
+/**
+ * @brief Set the overflow policy
+ * @param policy New policy
+ * @return void
+ */
+void EARS_logRing::setPolicy(LogOverflowPolicy policy) {
+    // Producers blocked under the old policy re-evaluate on their next retry
+    _policy.store((uint8_t)policy);
+}
+
+/**
+ * @brief Set how long a BLOCK push waits before dropping its entry
+ * @param timeoutMs Timeout in milliseconds
+ * @return void
+ */
+void EARS_logRing::setBlockTimeout(uint32_t timeoutMs) {
+    _blockTimeoutMs.store(timeoutMs);
+}
+
+/**
+ * @brief Number of entries currently queued
+ * @return size_t queued entry count
+ */
+size_t EARS_logRing::pending() {
+    uint32_t used = _enqueuePos.load(std::memory_order_relaxed) - _dequeuePos.load(std::memory_order_relaxed);
+    // Reads are not one snapshot - never report more than fits
+    return (used > _slotCount) ? _slotCount : used;
+}
+
+/**
+ * @brief Snapshot of the ring counters
+ * @return LogRingStats counters
+ */
+LogRingStats EARS_logRing::getStats() {
+    LogRingStats stats;
+    stats.pushed = _pushed.load(std::memory_order_relaxed);
+    stats.drained = _drained.load(std::memory_order_relaxed);
+    stats.droppedOldest = _droppedOldest.load(std::memory_order_relaxed);
+    stats.droppedNewest = _droppedNewest.load(std::memory_order_relaxed);
+    stats.blockedPushes = _blockedPushes.load(std::memory_order_relaxed);
+    stats.truncated = _truncated.load(std::memory_order_relaxed);
+    stats.highWater = _highWater.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * @brief Zero all counters
+ * @return void
+ */
+void EARS_logRing::resetStats() {
+    _pushed.store(0);
+    _drained.store(0);
+    _droppedOldest.store(0);
+    _droppedNewest.store(0);
+    _blockedPushes.store(0);
+    _truncated.store(0);
+    _highWater.store(_slotCount ? (uint32_t)pending() : 0);
+}
+
+/**
+ * @brief Construct an unconfigured flusher
+ */
+EARS_logFlusher::EARS_logFlusher() :
+    _ring(nullptr),
+    _batch(nullptr),
+    _batchBytes(0),
+    _sink(nullptr),
+    _idle(nullptr),
+    _context(nullptr),
+    _maxLatencyMs(0) {
+}
+
+/**
+ * @brief Configure the flusher
+ * @param ring Ring to drain
+ * @param batch Batch buffer owned by the caller
+ * @param batchBytes Size of batch, at least one slot
+ * @param sink Batch sink
+ * @param context Passed to the sink unchanged
+ * @param maxLatencyMs Longest an entry waits for the batch to fill
+ * @return true if configuration is valid
+ * @return false if any parameter is invalid
+ */
+bool EARS_logFlusher::begin(EARS_logRing* ring, char* batch, size_t batchBytes,
+                            LogFlushSink sink, void* context, uint32_t maxLatencyMs) {
+    if (!ring || !batch || !sink || batchBytes < ring->slotPayloadBytes()) {
+        return false;
+    }
+    _ring = ring;
+    _batch = batch;
+    _batchBytes = batchBytes;
+    _sink = sink;
+    _context = context;
+    _maxLatencyMs = maxLatencyMs;
+    _stats = LogFlusherStats();
+    return true;
+}
+
+/**
+ * @brief Drain everything currently queued
+ * @return size_t Bytes handed to the sink
+ */
+size_t EARS_logFlusher::flushPending() {
+    if (!_ring) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(_flushMutex);
+    size_t total = 0;
+    size_t length;
+    while ((length = _ring->drain(_batch, _batchBytes)) > 0) {
+        _stats.batches++;
+        _stats.bytes += length;
+        if (!_sink(_batch, length, _context)) {
+            _stats.sinkFailures++;
+        }
+        total += length;
+    }
+    return total;
+}
+
+/**
+ * @brief Flush loop, returns once stop is set and the ring is empty
+ * @param stop Set by another thread/task to request exit
+ * @return void
+ */
+void EARS_logFlusher::run(const std::atomic<bool>& stop) {
+    if (!_ring) {
+        return;
+    }
+
+    // Entries that roughly fill one batch; waiting for them turns many
+    // small lines into a single large write.
+    size_t fillEntries = _batchBytes / _ring->slotPayloadBytes();
+    if (fillEntries == 0) {
+        fillEntries = 1;
+    }
+
+    while (!stop.load()) {
+        if (!_ring->waitFor(1, _maxLatencyMs)) {
+            if (_idle) {
+                _idle(_context);
+            }
+            continue;
+        }
+        _ring->waitFor(fillEntries, _maxLatencyMs);
+        flushPending();
+    }
+    flushPending();
+}
+
+/*****************************************************************************
+ * End of EARS_logRingLib.cpp
+ ****************************************************************************/
@@ -0,0 +1,309 @@
+/**
+ * @file EARS_logRingLib.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Fixed-size log entry ring and batch flusher for asynchronous logging
+ * @version 1.2.0
+ * @date 20261016
+ *
+ * @details
+ * The ring stores whole log entries in fixed-size slots inside a caller
+ * supplied buffer (PSRAM on the device, heap on the host). Producers copy
+ * entries in with push(); a single flusher drains them into large batches
+ * and hands each batch to a sink callback. Only the C++ standard library
+ * is used so the same code builds for the ESP32-S3 and for host benchmarks.
+ *
+ * push() takes no lock: each slot carries a sequence number (kept in
+ * internal RAM, apart from the PSRAM payload) and producers claim slots
+ * with one compare-and-swap, so tasks on both cores and esp_timer
+ * callbacks can log concurrently. Entries from one producer are drained
+ * in the order it pushed them. Only sleeping sides touch a mutex: the
+ * flusher waiting for entries and BLOCK producers waiting for space.
+ * BLOCK must not be used from an ISR.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_LOG_RING_LIB_H__
+#define __EARS_LOG_RING_LIB_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/**
+ * @brief What push() does when every slot is in use
+ */
+enum class LogOverflowPolicy : uint8_t {
+    DROP_OLDEST = 0,    // Overwrite the oldest queued entry
+    DROP_NEWEST = 1,    // Discard the entry being pushed
+    BLOCK = 2           // Wait for space, up to the block timeout
+};
+
+/**
+ * @brief Ring counters, all monotonic until resetStats()
+ */
+struct LogRingStats {
+    uint32_t pushed;            // Entries accepted into the ring
+    uint32_t drained;           // Entries handed to the flusher
+    uint32_t droppedOldest;     // Entries overwritten by DROP_OLDEST
+    uint32_t droppedNewest;     // Entries rejected (DROP_NEWEST or BLOCK timeout)
+    uint32_t blockedPushes;     // Pushes that had to wait for space
+    uint32_t truncated;         // Entries cut to fit a slot
+    uint32_t highWater;         // Most slots ever in use at once
+
+    LogRingStats() :
+        pushed(0),
+        drained(0),
+        droppedOldest(0),
+        droppedNewest(0),
+        blockedPushes(0),
+        truncated(0),
+        highWater(0) {}
+};
+
+/**
+ * @brief Lock-free multi-producer, single-consumer ring of log entries
+ */
+class EARS_logRing {
+public:
+    // Bytes of each slot used to store the entry length
+    static const size_t SLOT_HEADER_BYTES = 2;
+    // Longest sleep before a waiter re-checks the ring (covers missed wakeups)
+    static const uint32_t WAIT_POLL_MS = 10;
+    // Failed attempts to drop the oldest entry before dropping the new one
+    static const uint32_t DROP_OLDEST_RETRIES = 64;
+
+    EARS_logRing();
+    ~EARS_logRing();
+
+    /**
+     * @brief Attach storage and reset the ring
+     * @param storage Buffer owned by the caller, must outlive the ring
+     * @param storageBytes Size of storage in bytes
+     * @param slotBytes Size of one slot including its length header
+     * @param policy Overflow policy
+     * @return true if at least two slots fit in storage
+     * @return false if parameters are invalid
+     *
+     * The slot count is rounded down to a power of two. Call before any
+     * producer starts.
+     */
+    bool begin(uint8_t* storage, size_t storageBytes, size_t slotBytes, LogOverflowPolicy policy);
+
+    /**
+     * @brief Detach storage and release any waiting producers or consumers
+     * @return void
+     *
+     * Call once producers have stopped.
+     */
+    void end();
+
+    /**
+     * @brief Copy an entry into the ring
+     * @param data Entry bytes (need not be null terminated)
+     * @param length Number of bytes, truncated to the slot payload size
+     * @return true if the entry was queued
+     * @return false if it was dropped
+     *
+     * Lock-free; safe from any task on either core.
+     */
+    bool push(const char* data, size_t length);
+
+    /**
+     * @brief Copy as many whole queued entries as fit into out
+     * @param out Destination buffer
+     * @param capacity Size of out in bytes
+     * @return size_t Number of bytes written to out
+     */
+    size_t drain(char* out, size_t capacity);
+
+    /**
+     * @brief Wait until at least minEntries are queued
+     * @param minEntries Entry count to wait for
+     * @param timeoutMs Maximum wait in milliseconds
+     * @return true if any entries are queued on return
+     * @return false if the ring is empty
+     */
+    bool waitFor(size_t minEntries, uint32_t timeoutMs);
+
+    /**
+     * @brief Set the overflow policy
+     * @param policy New policy
+     * @return void
+     */
+    void setPolicy(LogOverflowPolicy policy);
+
+    /**
+     * @brief Set how long a BLOCK push waits before dropping its entry
+     * @param timeoutMs Timeout in milliseconds
+     * @return void
+     */
+    void setBlockTimeout(uint32_t timeoutMs);
+
+    LogOverflowPolicy getPolicy() const { return (LogOverflowPolicy)_policy.load(); }
+    size_t slotCount() const { return _slotCount; }
+    size_t slotPayloadBytes() const { return _slotBytes - SLOT_HEADER_BYTES; }
+
+    /**
+     * @brief Number of entries currently queued
+     * @return size_t queued entry count (including ones still being copied in)
+     */
+    size_t pending();
+
+    /**
+     * @brief Snapshot of the ring counters
+     * @return LogRingStats counters
+     */
+    LogRingStats getStats();
+
+    /**
+     * @brief Zero all counters
+     * @return void
+     */
+    void resetStats();
+
+private:
+    EARS_logRing(const EARS_logRing&) = delete;
+    EARS_logRing& operator=(const EARS_logRing&) = delete;
+
+    std::atomic<uint32_t>* _sequence;   // Per slot: position it may next be written (== pos) or read (== pos + 1) at
+    uint8_t* _storage;
+    size_t _slotBytes;
+    size_t _slotCount;
+    size_t _slotMask;
+    std::atomic<uint32_t> _enqueuePos;  // Next position a producer claims
+    std::atomic<uint32_t> _dequeuePos;  // Next position to drain
+    std::atomic<bool> _open;
+    std::atomic<uint8_t> _policy;
+    std::atomic<uint32_t> _blockTimeoutMs;
+
+    // Sleeping is off the lock-free path; producers only notify when asked
+    std::mutex _waitMutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    std::atomic<uint32_t> _consumerWants;       // Entries the sleeping flusher waits for, 0 = awake
+    std::atomic<uint32_t> _blockedProducers;    // BLOCK producers sleeping for space
+
+    // Counters, see LogRingStats
+    std::atomic<uint32_t> _pushed;
+    std::atomic<uint32_t> _drained;
+    std::atomic<uint32_t> _droppedOldest;
+    std::atomic<uint32_t> _droppedNewest;
+    std::atomic<uint32_t> _blockedPushes;
+    std::atomic<uint32_t> _truncated;
+    std::atomic<uint32_t> _highWater;
+
+    /**
+     * @brief Claim the oldest published entry and throw it away
+     * @return true if an entry was dropped
+     * @return false if the oldest entry is still being written or drained
+     */
+    bool discardOldest();
+
+    /**
+     * @brief Raise the high water mark to the current fill level
+     * @param pos Position just published
+     * @return void
+     */
+    void trackHighWater(uint32_t pos);
+};
+
+/**
+ * @brief Sink called by the flusher with each batch
+ * @param data Batch bytes
+ * @param length Batch length
+ * @param context Caller context given to EARS_logFlusher::begin()
+ * @return true if the batch was written
+ */
+typedef bool (*LogFlushSink)(const char* data, size_t length, void* context);
+
+/**
+ * @brief Called by run() when maxLatencyMs passes without an entry
+ * @param context Caller context given to EARS_logFlusher::begin()
+ * @return void
+ */
+typedef void (*LogFlushIdle)(void* context);
+
+/**
+ * @brief Flusher counters
+ */
+struct LogFlusherStats {
+    uint32_t batches;       // Sink calls
+    uint32_t bytes;         // Bytes handed to the sink
+    uint32_t sinkFailures;  // Sink calls that returned false
+
+    LogFlusherStats() : batches(0), bytes(0), sinkFailures(0) {}
+};
+
+/**
+ * @brief Drains an EARS_logRing into large batches for a sink
+ *
+ * The device runs run() in a FreeRTOS task; host benchmarks run it in a
+ * std::thread. flushPending() can be called from any context to force out
+ * everything queued (e.g. before a restart).
+ */
+class EARS_logFlusher {
+public:
+    EARS_logFlusher();
+
+    /**
+     * @brief Configure the flusher
+     * @param ring Ring to drain
+     * @param batch Batch buffer owned by the caller
+     * @param batchBytes Size of batch, at least one slot
+     * @param sink Batch sink
+     * @param context Passed to the sink unchanged
+     * @param maxLatencyMs Longest an entry waits for the batch to fill
+     * @return true if configuration is valid
+     * @return false if any parameter is invalid
+     */
+    bool begin(EARS_logRing* ring, char* batch, size_t batchBytes,
+               LogFlushSink sink, void* context, uint32_t maxLatencyMs);
+
+    /**
+     * @brief Drain everything currently queued
+     * @return size_t Bytes handed to the sink
+     */
+    size_t flushPending();
+
+    /**
+     * @brief Run a hook whenever the ring stays empty for maxLatencyMs
+     * @param idle Hook, nullptr for none; gets the sink's context
+     * @return void
+     *
+     * Set before run() starts.
+     */
+    void setIdle(LogFlushIdle idle) { _idle = idle; }
+
+    /**
+     * @brief Flush loop, returns once stop is set and the ring is empty
+     * @param stop Set by another thread/task to request exit
+     * @return void
+     */
+    void run(const std::atomic<bool>& stop);
+
+    LogFlusherStats getStats() const { return _stats; }
+
+private:
+    EARS_logRing* _ring;
+    char* _batch;
+    size_t _batchBytes;
+    LogFlushSink _sink;
+    LogFlushIdle _idle;
+    void* _context;
+    uint32_t _maxLatencyMs;
+    std::mutex _flushMutex;     // flushPending() may race run()
+    LogFlusherStats _stats;
+};
+
+#endif // __EARS_LOG_RING_LIB_H__
+
+/****************************************************************************
+ * End of EARS_logRingLib.h
+ ***************************************************************************/
@@ -0,0 +1,149 @@
+/**
+ * @file EARS_logSinkLib.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Log sinks with their own level thresholds, and an in-RAM ring sink
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_logSinkLib.h"
+#include <string.h>
+
+/*
+  Slot layout: u16 text length, u8 level, u8 unused, u32 sequence, text
+*/
+
+/**
+ * @brief Construct a sink without storage
+ */
+EARS_logMemorySink::EARS_logMemorySink()
+    : _storage(nullptr), _slotBytes(0), _slotCount(0), _oldestSequence(1), _lastSequence(0) {
+}
+
+/**
+ * @brief Attach storage
+ * @param storage slotCount * slotBytes bytes, 4 byte aligned
+ * @param bytes Size of storage
+ * @param slotBytes Size of one slot including its header
+ * @return true if at least one slot fits
+ */
+bool EARS_logMemorySink::begin(uint8_t* storage, size_t bytes, size_t slotBytes) {
+    if (storage == nullptr || slotBytes <= SLOT_HEADER_BYTES || slotBytes > 0xFFFF || bytes < slotBytes) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _storage = storage;
+    _slotBytes = slotBytes;
+    _slotCount = bytes / slotBytes;
+    _oldestSequence = _lastSequence.load(std::memory_order_relaxed) + 1;
+    return true;
+}
+
+/**
+ * @brief Detach storage, the sink then drops everything
+ * @return void
+ */
+void EARS_logMemorySink::end() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _storage = nullptr;
+    _slotCount = 0;
+}
+
+/**
+ * @brief Store a line, replacing the oldest when full
+ * @param level Message level
+ * @param line Formatted line, a trailing newline is dropped
+ * @param length Number of bytes, cut to textCapacity()
+ * @return void
+ */
+void EARS_logMemorySink::write(uint8_t level, const char* line, size_t length) {
+    if (length > 0 && line[length - 1] == '\n') {
+        length--;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_storage == nullptr) {
+        return;
+    }
+    if (length > textCapacity()) {
+        length = textCapacity();
+    }
+
+    uint32_t sequence = _lastSequence.load(std::memory_order_relaxed) + 1;
+    uint8_t* entry = slot(sequence);
+    uint16_t stored = (uint16_t)length;
+    memcpy(entry, &stored, sizeof(stored));
+    entry[2] = level;
+    entry[3] = 0;
+    memcpy(entry + 4, &sequence, sizeof(sequence));
+    memcpy(entry + SLOT_HEADER_BYTES, line, length);
+
+    if (sequence - _oldestSequence >= _slotCount) {
+        _oldestSequence = sequence - (uint32_t)_slotCount + 1;
+    }
+    _lastSequence.store(sequence, std::memory_order_release);
+}
+
+/**
+ * @brief Visit the held lines oldest first, without copying
+ * @param visitor Called for each line
+ * @param context Passed to visitor unchanged
+ * @param afterSequence Only lines newer than this (0 = all)
+ * @return size_t lines visited
+ */
+size_t EARS_logMemorySink::forEach(LogMemoryVisitor visitor, void* context, uint32_t afterSequence) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_storage == nullptr || visitor == nullptr) {
+        return 0;
+    }
+
+    uint32_t last = _lastSequence.load(std::memory_order_relaxed);
+    uint32_t first = afterSequence >= _oldestSequence ? afterSequence + 1 : _oldestSequence;
+    size_t visited = 0;
+    for (uint32_t sequence = first; sequence <= last && sequence != 0; sequence++) {
+        const uint8_t* entry = slot(sequence);
+        uint16_t length;
+        memcpy(&length, entry, sizeof(length));
+
+        LogMemoryEntry view;
+        view.sequence = sequence;
+        view.level = entry[2];
+        view.text = reinterpret_cast<const char*>(entry + SLOT_HEADER_BYTES);
+        view.length = length;
+        visited++;
+        if (!visitor(view, context)) {
+            break;
+        }
+    }
+    return visited;
+}
+
+/**
+ * @brief Drop all held lines (sequences keep counting)
+ * @return void
+ */
+void EARS_logMemorySink::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _oldestSequence = _lastSequence.load(std::memory_order_relaxed) + 1;
+}
+
+/**
+ * @brief Number of lines held
+ * @return size_t lines
+ */
+size_t EARS_logMemorySink::count() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_storage == nullptr) {
+        return 0;
+    }
+    return (size_t)(_lastSequence.load(std::memory_order_relaxed) + 1 - _oldestSequence);
+}
+
+/****************************************************************************
+ * End of EARS_logSinkLib.cpp
+ ***************************************************************************/
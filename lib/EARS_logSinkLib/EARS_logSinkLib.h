@@ -0,0 +1,168 @@
+/**
+ * @file EARS_logSinkLib.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Log sinks with their own level thresholds, and an in-RAM ring sink
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * EARS_logger formats a text line once and hands it to every sink whose
+ * level allows it, next to its own SD file. EARS_logMemorySink keeps the
+ * last N lines in fixed slots so a UI screen can show recent logs without
+ * touching the card; forEach() hands out pointers into the slots, nothing
+ * is copied.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_LOG_SINK_LIB_H__
+#define __EARS_LOG_SINK_LIB_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include "EARS_logFilterLib.h"
+
+/**
+ * @brief Destination for formatted log lines
+ */
+class EARS_logSink {
+public:
+    explicit EARS_logSink(uint8_t level = EARS_LOG_LEVEL_DEBUG) : _level(level) {}
+    virtual ~EARS_logSink() {}
+
+    /**
+     * @brief Set the most verbose level this sink takes
+     * @param level EARS_LOG_LEVEL_NONE .. EARS_LOG_LEVEL_DEBUG
+     * @return void
+     */
+    void setLevel(uint8_t level) { _level.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief Most verbose level this sink takes
+     * @return uint8_t level
+     */
+    uint8_t getLevel() const { return _level.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Check the sink's threshold
+     * @param level Message level
+     * @return true if the sink wants the message
+     */
+    bool accepts(uint8_t level) const { return level != EARS_LOG_LEVEL_NONE && level <= getLevel(); }
+
+    /**
+     * @brief Take one line
+     * @param level Message level
+     * @param line Formatted line ending in '\n'
+     * @param length Number of bytes
+     * @return void
+     *
+     * Called from any task, possibly on both cores at once.
+     */
+    virtual void write(uint8_t level, const char* line, size_t length) = 0;
+
+private:
+    std::atomic<uint8_t> _level;
+};
+
+/**
+ * @brief One line held by EARS_logMemorySink
+ */
+struct LogMemoryEntry {
+    uint32_t sequence;      // 1 for the first line ever written, then +1
+    uint8_t level;
+    const char* text;       // Points into the sink's storage, no newline, not NUL terminated
+    size_t length;
+};
+
+/**
+ * @brief Visits one held line
+ * @param entry The line, valid only during the call
+ * @param context Caller context given to forEach()
+ * @return true to continue, false to stop
+ */
+typedef bool (*LogMemoryVisitor)(const LogMemoryEntry& entry, void* context);
+
+/**
+ * @brief Ring of the last N lines in fixed slots
+ */
+class EARS_logMemorySink : public EARS_logSink {
+public:
+    // Bytes in front of each slot's text
+    static const size_t SLOT_HEADER_BYTES = 8;
+
+    EARS_logMemorySink();
+
+    /**
+     * @brief Attach storage
+     * @param storage slotCount * slotBytes bytes, 4 byte aligned
+     * @param bytes Size of storage
+     * @param slotBytes Size of one slot including its header
+     * @return true if at least one slot fits
+     */
+    bool begin(uint8_t* storage, size_t bytes, size_t slotBytes);
+
+    /**
+     * @brief Detach storage, the sink then drops everything
+     * @return void
+     */
+    void end();
+
+    /**
+     * @brief Store a line, replacing the oldest when full
+     * @param level Message level
+     * @param line Formatted line, a trailing newline is dropped
+     * @param length Number of bytes, cut to textCapacity()
+     * @return void
+     */
+    void write(uint8_t level, const char* line, size_t length) override;
+
+    /**
+     * @brief Visit the held lines oldest first, without copying
+     * @param visitor Called for each line
+     * @param context Passed to visitor unchanged
+     * @param afterSequence Only lines newer than this (0 = all)
+     * @return size_t lines visited
+     *
+     * Writers wait while this runs, so keep visitor short.
+     */
+    size_t forEach(LogMemoryVisitor visitor, void* context, uint32_t afterSequence = 0) const;
+
+    /**
+     * @brief Sequence of the newest line, 0 if none; changes when lines arrive
+     * @return uint32_t sequence
+     */
+    uint32_t lastSequence() const { return _lastSequence.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Drop all held lines (sequences keep counting)
+     * @return void
+     */
+    void clear();
+
+    size_t count() const;
+    size_t slotCount() const { return _slotCount; }
+    size_t textCapacity() const { return _slotBytes > SLOT_HEADER_BYTES ? _slotBytes - SLOT_HEADER_BYTES : 0; }
+
+private:
+    uint8_t* _storage;
+    size_t _slotBytes;
+    size_t _slotCount;
+    mutable std::mutex _mutex;
+    uint32_t _oldestSequence;       // Oldest held line, under _mutex
+    std::atomic<uint32_t> _lastSequence;
+
+    uint8_t* slot(uint32_t sequence) const { return _storage + ((sequence - 1) % _slotCount) * _slotBytes; }
+};
+
+#endif // __EARS_LOG_SINK_LIB_H__
+
+/****************************************************************************
+ * End of EARS_logSinkLib.h
+ ***************************************************************************/
@@ -0,0 +1,191 @@
+/**
+ * @file EARS_logTimeLib.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Allocation-free cached timestamp formatter for log lines
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_logTimeLib.h"
+#include <string.h>
+#include <time.h>
+
+namespace {
+
+// "00".."99"
+const char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+inline char* putPair(char* out, unsigned value) {
+    memcpy(out, DIGIT_PAIRS + value * 2, 2);
+    return out + 2;
+}
+
+} // namespace
+
+/**
+ * @brief Construct a formatter with an empty cache
+ * @param precision Sub-second digits
+ */
+EARS_logTimestamp::EARS_logTimestamp(LogTimePrecision precision)
+    : _precision((uint8_t)precision), _sequence(0), _hourStart(EMPTY) {
+    for (size_t i = 0; i < PREFIX_WORDS; i++) {
+        _prefix[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Format a time
+ * @param nowUs Microseconds since the epoch
+ * @param out Destination
+ * @param capacity Size of out, MAX_LENGTH always fits
+ * @return size_t length without the NUL, 0 if it did not fit (out is then "")
+ */
+size_t EARS_logTimestamp::format(uint64_t nowUs, char* out, size_t capacity) {
+    LogTimePrecision precision = getPrecision();
+    size_t length = PREFIX_LENGTH + 5;
+    if (precision == LogTimePrecision::MILLIS) {
+        length += 4;
+    } else if (precision == LogTimePrecision::MICROS) {
+        length += 7;
+    }
+    if (capacity < length + 1) {
+        if (capacity > 0) {
+            out[0] = '\0';
+        }
+        return 0;
+    }
+
+    uint32_t seconds = (uint32_t)(nowUs / 1000000ULL);
+    uint32_t micros = (uint32_t)(nowUs % 1000000ULL);
+
+    char prefix[PREFIX_WORDS * 4];
+    uint32_t hourStart;
+    if (!lookup(seconds, prefix, hourStart)) {
+        render(seconds, prefix, hourStart);
+    }
+
+    // Only minutes, seconds and the fraction change within the hour
+    uint32_t intoHour = seconds - hourStart;
+    char* p = out;
+    memcpy(p, prefix, PREFIX_LENGTH);
+    p += PREFIX_LENGTH;
+    p = putPair(p, intoHour / 60);
+    *p++ = ':';
+    p = putPair(p, intoHour % 60);
+
+    if (precision == LogTimePrecision::MILLIS) {
+        unsigned millis = micros / 1000;
+        *p++ = '.';
+        *p++ = (char)('0' + millis / 100);
+        p = putPair(p, millis % 100);
+    } else if (precision == LogTimePrecision::MICROS) {
+        *p++ = '.';
+        p = putPair(p, micros / 10000);
+        p = putPair(p, (micros / 100) % 100);
+        p = putPair(p, micros % 100);
+    }
+    *p = '\0';
+    return (size_t)(p - out);
+}
+
+/**
+ * @brief Drop the cached hour, e.g. after the clock or TZ changed
+ * @return void
+ */
+void EARS_logTimestamp::invalidate() {
+    char none[PREFIX_WORDS * 4] = {};
+    publish(EMPTY, none);
+}
+
+/**
+ * @brief Read the cached prefix if it covers seconds
+ * @param seconds Epoch seconds
+ * @param prefix Receives the prefix
+ * @param hourStart Receives the start of the hour
+ * @return true on a cache hit
+ */
+bool EARS_logTimestamp::lookup(uint32_t seconds, char* prefix, uint32_t& hourStart) const {
+    uint32_t sequence = _sequence.load(std::memory_order_acquire);
+    if (sequence & 1) {
+        return false;
+    }
+
+    uint32_t start = _hourStart.load(std::memory_order_relaxed);
+    uint32_t words[PREFIX_WORDS];
+    for (size_t i = 0; i < PREFIX_WORDS; i++) {
+        words[i] = _prefix[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_sequence.load(std::memory_order_relaxed) != sequence) {
+        return false;
+    }
+
+    if (seconds < start || seconds - start >= 3600) {
+        return false;
+    }
+    memcpy(prefix, words, sizeof(words));
+    hourStart = start;
+    return true;
+}
+
+/**
+ * @brief Render the prefix with localtime_r and try to cache it
+ * @param seconds Epoch seconds
+ * @param prefix Receives the prefix
+ * @param hourStart Receives the start of the hour
+ * @return void
+ */
+void EARS_logTimestamp::render(uint32_t seconds, char* prefix, uint32_t& hourStart) {
+    time_t now = (time_t)seconds;
+    struct tm parts;
+    localtime_r(&now, &parts);
+
+    memset(prefix, 0, PREFIX_WORDS * 4);
+    unsigned year = (unsigned)(parts.tm_year + 1900) % 10000;
+    char* p = putPair(prefix, year / 100);
+    p = putPair(p, year % 100);
+    *p++ = '-';
+    p = putPair(p, (unsigned)parts.tm_mon + 1);
+    *p++ = '-';
+    p = putPair(p, (unsigned)parts.tm_mday);
+    *p++ = ' ';
+    p = putPair(p, (unsigned)parts.tm_hour);
+    *p++ = ':';
+    hourStart = seconds - (uint32_t)(parts.tm_min * 60 + parts.tm_sec);
+
+    publish(hourStart, prefix);
+}
+
+/**
+ * @brief Publish an hour to the cache unless another task is writing
+ * @param hourStart Start of the hour, EMPTY to clear
+ * @param prefix Prefix for that hour
+ * @return void
+ */
+void EARS_logTimestamp::publish(uint32_t hourStart, const char* prefix) {
+    uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1) || !_sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_relaxed)) {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint32_t words[PREFIX_WORDS];
+    memcpy(words, prefix, sizeof(words));
+    _hourStart.store(hourStart, std::memory_order_relaxed);
+    for (size_t i = 0; i < PREFIX_WORDS; i++) {
+        _prefix[i].store(words[i], std::memory_order_relaxed);
+    }
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/****************************************************************************
+ * End of EARS_logTimeLib.cpp
+ ***************************************************************************/
@@ -0,0 +1,126 @@
+/**
+ * @file EARS_logTimeLib.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Allocation-free cached timestamp formatter for log lines
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * Formats "YYYY-MM-DD HH:MM:SS" with optional ".mmm" or ".uuuuuu" into a
+ * caller buffer. The local date and hour ("YYYY-MM-DD HH:") are rendered
+ * with localtime_r once per hour and cached; minutes, seconds and the
+ * fraction are plain arithmetic on the time since that hour started.
+ *
+ * The cache is a seqlock of atomic words, so any number of tasks may
+ * format at once without locking. A task that finds the cache being
+ * updated renders its own prefix instead of waiting.
+ *
+ * Time zone offsets are assumed to change on hour boundaries (true for
+ * DST rules in the POSIX TZ strings the device uses); call invalidate()
+ * after changing TZ.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_LOG_TIME_LIB_H__
+#define __EARS_LOG_TIME_LIB_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/**
+ * @brief Sub-second digits in a timestamp
+ */
+enum class LogTimePrecision : uint8_t {
+    SECONDS = 0,    // 2026-10-16 12:34:56
+    MILLIS = 1,     // 2026-10-16 12:34:56.789
+    MICROS = 2      // 2026-10-16 12:34:56.789012
+};
+
+/**
+ * @brief Cached local time formatter
+ */
+class EARS_logTimestamp {
+public:
+    // Longest timestamp plus the terminating NUL
+    static const size_t MAX_LENGTH = 27;
+
+    explicit EARS_logTimestamp(LogTimePrecision precision = LogTimePrecision::SECONDS);
+
+    /**
+     * @brief Select the sub-second digits
+     * @param precision SECONDS, MILLIS or MICROS
+     * @return void
+     */
+    void setPrecision(LogTimePrecision precision) { _precision.store((uint8_t)precision, std::memory_order_relaxed); }
+
+    /**
+     * @brief Current sub-second digits
+     * @return LogTimePrecision precision
+     */
+    LogTimePrecision getPrecision() const { return (LogTimePrecision)_precision.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Format a time
+     * @param nowUs Microseconds since the epoch
+     * @param out Destination
+     * @param capacity Size of out, MAX_LENGTH always fits
+     * @return size_t length without the NUL, 0 if it did not fit (out is then "")
+     */
+    size_t format(uint64_t nowUs, char* out, size_t capacity);
+
+    /**
+     * @brief Drop the cached hour, e.g. after the clock or TZ changed
+     * @return void
+     */
+    void invalidate();
+
+private:
+    static const size_t PREFIX_LENGTH = 14;     // "YYYY-MM-DD HH:"
+    static const size_t PREFIX_WORDS = 4;
+    static const uint32_t EMPTY = 0xFFFFFFFF;
+
+    std::atomic<uint8_t> _precision;
+
+    // Seqlock, odd while being written
+    std::atomic<uint32_t> _sequence;
+    std::atomic<uint32_t> _hourStart;           // Epoch second the cached hour starts at, EMPTY if none
+    std::atomic<uint32_t> _prefix[PREFIX_WORDS];
+
+    /**
+     * @brief Read the cached prefix if it covers seconds
+     * @param seconds Epoch seconds
+     * @param prefix Receives the prefix
+     * @param hourStart Receives the start of the hour
+     * @return true on a cache hit
+     */
+    bool lookup(uint32_t seconds, char* prefix, uint32_t& hourStart) const;
+
+    /**
+     * @brief Publish an hour to the cache unless another task is writing
+     * @param hourStart Start of the hour, EMPTY to clear
+     * @param prefix Prefix for that hour
+     * @return void
+     */
+    void publish(uint32_t hourStart, const char* prefix);
+
+    /**
+     * @brief Render the prefix with localtime_r and try to cache it
+     * @param seconds Epoch seconds
+     * @param prefix Receives the prefix
+     * @param hourStart Receives the start of the hour
+     * @return void
+     */
+    void render(uint32_t seconds, char* prefix, uint32_t& hourStart);
+};
+
+#endif // __EARS_LOG_TIME_LIB_H__
+
+/****************************************************************************
+ * End of EARS_logTimeLib.h
+ ***************************************************************************/
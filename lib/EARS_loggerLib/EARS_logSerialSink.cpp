@@ -0,0 +1,33 @@
+/**
+ * @file EARS_logSerialSink.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Log sink writing lines to the USB serial port
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_logSerialSink.h"
+
+/**
+ * @brief Write one line to Serial
+ * @param level Message level
+ * @param line Formatted line ending in '\n'
+ * @param length Number of bytes
+ * @return void
+ */
+void EARS_logSerialSink::write(uint8_t level, const char* line, size_t length) {
+    (void)level;
+    if (!Serial) {
+        return;
+    }
+    Serial.write(reinterpret_cast<const uint8_t*>(line), length);
+}
+
+/****************************************************************************
+ * End of EARS_logSerialSink.cpp
+ ***************************************************************************/
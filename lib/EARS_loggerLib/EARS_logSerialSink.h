@@ -0,0 +1,44 @@
+/**
+ * @file EARS_logSerialSink.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Log sink writing lines to the USB serial port
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_LOG_SERIAL_SINK_H__
+#define __EARS_LOG_SERIAL_SINK_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <Arduino.h>
+#include "EARS_logSinkLib.h"
+
+/**
+ * @brief Writes each line to Serial, off until a level is set
+ */
+class EARS_logSerialSink : public EARS_logSink {
+public:
+    EARS_logSerialSink() : EARS_logSink(EARS_LOG_LEVEL_NONE) {}
+
+    /**
+     * @brief Write one line to Serial
+     * @param level Message level
+     * @param line Formatted line ending in '\n'
+     * @param length Number of bytes
+     * @return void
+     *
+     * Dropped while no host has the port open, so logging never blocks on USB.
+     */
+    void write(uint8_t level, const char* line, size_t length) override;
+};
+
+#endif // __EARS_LOG_SERIAL_SINK_H__
+
+/****************************************************************************
+ * End of EARS_logSerialSink.h
+ ***************************************************************************/
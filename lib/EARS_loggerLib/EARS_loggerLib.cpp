@@ -2,14 +2,26 @@
  * @file EARS_loggerLib.cpp
  * @author JTB & Claude Sonnet 4.2
  * @brief Enhanced logging system with hierarchical levels and unified config
- * @version 2.7.0
- * @date 20260116
+ * @version 2.23.3
+ * @date 20261016
  * 
  * @copyright Copyright (c) 2026 JTB. All rights reserved.
  */
 #include "EARS_loggerLib.h"
 #include <time.h>
 #include <sys/time.h>
+#include <esp_heap_caps.h>
+#include <esp_attr.h>
+
+// ears.config keys the logger follows while running
+static const ConfigKeyMask CONFIG_LEVEL_KEYS =
+    EARS_configKeyBit(ConfigKey::LOGGER_LOG_LEVEL) | EARS_configKeyBit(ConfigKey::LOGGER_SD_LEVEL) |
+    EARS_configKeyBit(ConfigKey::LOGGER_SERIAL_LEVEL) | EARS_configKeyBit(ConfigKey::LOGGER_MEMORY_LEVEL) |
+    EARS_configKeyBit(ConfigKey::LOGGER_TAG_LEVELS);
+
+// Crash log region: .noinit survives resets, panics and watchdogs (not power
+// loss) and is internal RAM, which the crash log's atomics need
+static __NOINIT_ATTR uint32_t s_crashRegion[4096 / sizeof(uint32_t)];
 
 /**
  * @brief Get singleton instance.
@@ -27,7 +39,26 @@ EARS_logger::EARS_logger() :
     _initialized(false),
     _logFilePath(""),
     _configFilePath(""),
-    _sdCard(nullptr) {
+    _sdCard(nullptr),
+    _rotating(false),
+    _activeFileSize(0),
+    _writesSinceResync(0),
+    _linesLogged(0),
+    _bytesLogged(0),
+    _asyncActive(false),
+    _ringStorage(nullptr),
+    _batchBuffer(nullptr),
+    _flushTask(nullptr),
+    _flushStop(false),
+    _compressWorkspace(nullptr),
+    _compressTask(nullptr),
+    _rotationCount(0),
+    _lastCommitMs(0),
+    _memoryStorage(nullptr),
+    _sinkCount(0),
+    _outputLevel(static_cast<uint8_t>(LogLevel::DEBUG)) {
+    _sinks[_sinkCount++] = &_serialSink;
+    _sinks[_sinkCount++] = &_memorySink;
 }
 
 /**
@@ -44,6 +75,8 @@ EARS_logger::~EARS_logger() {
  * @param configFilePath Path to unified config file (e.g., "/config/ears.config")
  * @param sdCard Pointer to SDCard instance 
  * 
+ * EARS_config is started by the application (setup()) before this; if it
+ * is not loaded the logger runs on its defaults and says so.
  */
 bool EARS_logger::begin(const char* logFilePath, const char* configFilePath, EARS_sdCard* sdCard) {
     if (_initialized) {
@@ -67,31 +100,363 @@ bool EARS_logger::begin(const char* logFilePath, const char* configFilePath, EAR
         }
     }
     
-    // Ensure config directory exists
-    lastSlash = _configFilePath.lastIndexOf('/');
-    if (lastSlash > 0) {
-        String configDir = _configFilePath.substring(0, lastSlash);
-        if (!_sdCard->directoryExists(configDir.c_str())) {
-            _sdCard->createDirectory(configDir.c_str());
+    // Load configuration (defaults if ears.config is not loaded)
+    EARS_config& config = EARS_config::getInstance();
+    loadConfig();
+    // Levels changed elsewhere (e.g. a settings screen) apply without a restart
+    config.subscribe(CONFIG_LEVEL_KEYS, configChanged, this);
+    
+    // Binary records go to their own file so text and binary never mix
+    if (_config.fileFormat == LogFileFormat::BINARY) {
+        int dot = _logFilePath.lastIndexOf('.');
+        if (dot > _logFilePath.lastIndexOf('/')) {
+            _logFilePath = _logFilePath.substring(0, dot);
         }
+        _logFilePath += ".ebl";
+        _binary.begin(nowUs());
     }
     
-    // Load configuration (creates default if not exists)
-    loadConfig();
+    // Recent lines for the UI; without PSRAM the memory sink stays empty
+    size_t memoryBytes = (size_t)_config.memoryEntries * MEMORY_SLOT_BYTES;
+    if (memoryBytes > 0) {
+        _memoryStorage = (uint8_t*)heap_caps_malloc(memoryBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (_memoryStorage) {
+            _memorySink.begin(_memoryStorage, memoryBytes, MEMORY_SLOT_BYTES);
+        }
+    }
+    
+    // Preallocated files are filled up to maxFileSizeBytes
+    if (_config.preallocate) {
+        _prealloc.begin(_config.maxFileSizeBytes);
+    }
+    
+    // Seed the tracked size - the only size lookup until the next resync
+    syncLogFileSize();
+    
+    // A preallocated file left from before the mode was turned off is full
+    PreallocHeader extent;
+    if (!_config.preallocate && EARS_preallocLog::readHeader(*_sdCard, _logFilePath.c_str(), extent)) {
+        _activeFileSize = _config.maxFileSizeBytes;
+    }
     
     _initialized = true;
     
+    // Last entries of the previous session, written before async mode starts
+    recoverCrashLog();
+    
+    // Start background flushing if configured (falls back to synchronous)
+    if (_config.asyncEnabled) {
+        startAsync();
+    }
+    
+    // Compress rotated generations in the background if configured
+    bool compressing = _config.compressRotated && startCompression();
+    
     // Log initialization
     info("=== Logger v2.1 Initialized ===");
     infof("Log file: %s", _logFilePath.c_str());
     infof("Config file: %s", _configFilePath.c_str());
+    if (!config.isLoaded()) {
+        warn("ears.config not loaded - logger defaults in use");
+    }
     infof("Log level: %s", getLogLevelString().c_str());
     infof("Max file size: %d bytes (%.2f MB)", _config.maxFileSizeBytes, _config.maxFileSizeBytes / 1048576.0);
     infof("Max rotated files: %d", _config.maxRotatedFiles);
+    infof("Log format: %s", formatToString(_config.fileFormat));
+    if (_config.preallocate) {
+        infof("Preallocated log files: %s", _prealloc.isAttached() ? "yes" : "after next rotation");
+    }
+    infof("Sinks: file %s, serial %s, memory %s (%u lines)",
+          levelToString(_config.sdLevel).c_str(), levelToString(_config.serialLevel).c_str(),
+          levelToString(_config.memoryLevel).c_str(), (unsigned)_memorySink.slotCount());
+    if (_asyncActive) {
+        infof("Async: %u slots, overflow %s", (unsigned)_ring.slotCount(), policyToString(_config.overflowPolicy));
+    } else if (_config.asyncEnabled) {
+        warn("Async logging unavailable, writing synchronously");
+    }
+    if (compressing) {
+        infof("Rotated logs compressed in %u byte blocks", (unsigned)COMPRESS_BLOCK_BYTES);
+    } else if (_config.compressRotated) {
+        warn("Log compression unavailable, rotated logs stay plain");
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Allocate the PSRAM ring and start the Core 0 flush task
+ * @return true if async mode started
+ * @return false if allocation or task creation failed
+ */
+bool EARS_logger::startAsync() {
+    _ringStorage = (uint8_t*)heap_caps_malloc(_config.asyncBufferBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    _batchBuffer = (char*)heap_caps_malloc(ASYNC_BATCH_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
     
+    bool ready = _ringStorage && _batchBuffer &&
+                 _ring.begin(_ringStorage, _config.asyncBufferBytes, ASYNC_SLOT_BYTES, _config.overflowPolicy) &&
+                 _flusher.begin(&_ring, _batchBuffer, ASYNC_BATCH_BYTES, writeBatch, this, ASYNC_MAX_LATENCY_MS);
+    
+    if (ready) {
+        _flusher.setIdle(flushIdle);
+        _flushStop.store(false);
+        ready = xTaskCreatePinnedToCore(flushTaskMain, "EARS_logFlush", ASYNC_TASK_STACK, this,
+                                        ASYNC_TASK_PRIORITY, &_flushTask, ASYNC_TASK_CORE) == pdPASS;
+    }
+    
+    if (!ready) {
+        _ring.end();
+        heap_caps_free(_ringStorage);
+        heap_caps_free(_batchBuffer);
+        _ringStorage = nullptr;
+        _batchBuffer = nullptr;
+        _flushTask = nullptr;
+        return false;
+    }
+    
+    _asyncActive = true;
     return true;
 }
 
+/**
+ * @brief FreeRTOS task body draining the ring
+ * @param param EARS_logger instance
+ * @return void
+ */
+void EARS_logger::flushTaskMain(void* param) {
+    EARS_logger* logger = static_cast<EARS_logger*>(param);
+    logger->_flusher.run(logger->_flushStop);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Allocate the compression workspace and start the background task
+ * @return true if compression started
+ * @return false if allocation or task creation failed
+ */
+bool EARS_logger::startCompression() {
+    size_t bytes = EARS_logCompressor::workspaceBytes(COMPRESS_BLOCK_BYTES);
+    _compressWorkspace = (uint8_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    
+    bool ready = _compressWorkspace && _compressor.begin(_compressWorkspace, bytes, COMPRESS_BLOCK_BYTES);
+    if (ready) {
+        recoverCompression();
+        ready = xTaskCreatePinnedToCore(compressTaskMain, "EARS_logZip", COMPRESS_TASK_STACK, this,
+                                        COMPRESS_TASK_PRIORITY, &_compressTask, COMPRESS_TASK_CORE) == pdPASS;
+    }
+    
+    if (!ready) {
+        heap_caps_free(_compressWorkspace);
+        _compressWorkspace = nullptr;
+        _compressTask = nullptr;
+        return false;
+    }
+    
+    // Generations left plain by an earlier boot
+    xTaskNotifyGive(_compressTask);
+    return true;
+}
+
+/**
+ * @brief FreeRTOS task body compressing generations after each rotation
+ * @param param EARS_logger instance
+ * @return void
+ */
+void EARS_logger::compressTaskMain(void* param) {
+    EARS_logger* logger = static_cast<EARS_logger*>(param);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        logger->compressGenerations();
+    }
+}
+
+/**
+ * @brief Compress every plain rotated generation
+ * @return void
+ */
+void EARS_logger::compressGenerations() {
+    char path[EARS_FS_PORT_MAX_PATH];
+    char tempPath[EARS_FS_PORT_MAX_PATH];
+    
+    for (unsigned generation = 1; generation <= _config.maxRotatedFiles; generation++) {
+        snprintf(path, sizeof(path), "%s.%u", _logFilePath.c_str(), generation);
+        snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+        if (!_sdCard->fileExists(path) || EARS_logCompressor::isCompressed(*_sdCard, path)) {
+            continue;
+        }
+        
+        uint32_t rotations;
+        {
+            std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+            rotations = _rotationCount;
+        }
+        
+        LogCompressStats result;
+        bool compressed = _compressor.compressFile(*_sdCard, path, tempPath, result);
+        
+        bool swapped = false;
+        bool moved = false;
+        {
+            std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+            moved = rotations != _rotationCount;
+            
+            // Only replace the plain file if it is still the one compressed
+            PreallocHeader extent;
+            uint32_t rawSize = EARS_preallocLog::readHeader(*_sdCard, path, extent) ? extent.end
+                                                                                    : _sdCard->getFileSize(path);
+            if (compressed && !moved && result.rawBytes == rawSize) {
+                swapped = _sdCard->removeFile(path) && _sdCard->renameFile(tempPath, path);
+            }
+            if (swapped) {
+                _stats.filesCompressed++;
+                _stats.compressRawBytes += result.rawBytes;
+                _stats.compressPackedBytes += result.packedBytes;
+            } else if (_sdCard->fileExists(tempPath)) {
+                _sdCard->removeFile(tempPath);
+            }
+        }
+        
+        if (swapped) {
+            debugf("Compressed %s: %u -> %u bytes (%.2fx)", path, (unsigned)result.rawBytes,
+                   (unsigned)result.packedBytes, result.ratio());
+        } else if (moved) {
+            // A rotation renamed the generations; start over from .1
+            generation = 0;
+        } else {
+            warnf("Could not compress %s, left plain", path);
+        }
+    }
+}
+
+/**
+ * @brief Finish or discard swaps a reset interrupted
+ * @return void
+ *
+ * A complete temporary file without its plain original means the reset
+ * came between the remove and the rename; anything else is discarded.
+ */
+void EARS_logger::recoverCompression() {
+    char path[EARS_FS_PORT_MAX_PATH];
+    char tempPath[EARS_FS_PORT_MAX_PATH];
+    
+    for (unsigned generation = 1; generation <= _config.maxRotatedFiles; generation++) {
+        snprintf(path, sizeof(path), "%s.%u", _logFilePath.c_str(), generation);
+        snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+        if (!_sdCard->fileExists(tempPath)) {
+            continue;
+        }
+        if (_sdCard->fileExists(path)) {
+            _sdCard->removeFile(tempPath);
+        } else {
+            _sdCard->renameFile(tempPath, path);
+        }
+    }
+}
+
+/**
+ * @brief Flusher idle hook, commits log writes left unflushed
+ * @param context EARS_logger instance
+ * @return void
+ */
+void EARS_logger::flushIdle(void* context) {
+    EARS_logger* logger = static_cast<EARS_logger*>(context);
+    if (logger->_config.preallocate) {
+        // The header goes with the data the card commits below
+        std::lock_guard<std::recursive_mutex> lock(logger->_writeMutex);
+        if (millis() - logger->_lastCommitMs >= PREALLOC_COMMIT_MS) {
+            logger->commitLog();
+        }
+    }
+    logger->_sdCard->flushExpired();
+}
+
+/**
+ * @brief Flusher sink, forwards a batch to writeEntries()
+ * @param data Batch bytes
+ * @param length Batch length
+ * @param context EARS_logger instance
+ * @return true if the batch was written
+ */
+bool EARS_logger::writeBatch(const char* data, size_t length, void* context) {
+    return static_cast<EARS_logger*>(context)->writeEntries(data, length);
+}
+
+/**
+ * @brief Write all queued entries to the SD card now
+ * @return true if the queue was drained
+ * @return false if the logger is not initialized
+ */
+bool EARS_logger::flush() {
+    if (!_initialized) {
+        return false;
+    }
+    if (_asyncActive) {
+        _flusher.flushPending();
+    }
+    if (_config.preallocate) {
+        std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+        commitLog();
+    }
+    // Pending setting changes go out too, without waiting for the debounce
+    EARS_config::getInstance().flush();
+    return _sdCard->sync();
+}
+
+/**
+ * @brief Drop the cached timestamp hour after the time zone (TZ) changed
+ * @return void
+ */
+void EARS_logger::timeZoneChanged() {
+    _timestamp.invalidate();
+}
+
+/**
+ * @brief Get async ring counters
+ * @return LogRingStats ring statistics, all zero in synchronous mode
+ */
+LogRingStats EARS_logger::getAsyncStats() {
+    if (!_asyncActive) {
+        return LogRingStats();
+    }
+    return _ring.getStats();
+}
+
+/**
+ * @brief Get logger I/O counters
+ * @return LoggerStats counters since begin() or resetStats()
+ */
+LoggerStats EARS_logger::getStats() const {
+    LoggerStats stats;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+        stats = _stats;
+    }
+    stats.linesLogged = _linesLogged.load(std::memory_order_relaxed);
+    stats.bytesLogged = _bytesLogged.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * @brief Get preallocated log file counters
+ * @return PreallocStats files created and recycled, header commits
+ */
+PreallocStats EARS_logger::getPreallocStats() const {
+    std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+    return _prealloc.getStats();
+}
+
+/**
+ * @brief Zero the logger I/O counters
+ * @return void
+ */
+void EARS_logger::resetStats() {
+    {
+        std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+        _stats = LoggerStats();
+    }
+    _linesLogged.store(0);
+    _bytesLogged.store(0);
+}
+
 /**
  * @brief Log a message at DEBUG level
  * @param message Message to log
@@ -187,22 +552,410 @@ void EARS_logger::log(LogLevel level, const char* message) {
         return;
     }
     
-    // Check if rotation needed
-    if (needsRotation()) {
+    _linesLogged.fetch_add(1, std::memory_order_relaxed);
+    
+    char entry[ENTRY_BUFFER_SIZE];
+    
+    if (_config.fileFormat == LogFileFormat::BINARY) {
+        // Sinks always get text; the file gets the record
+        if (sinksAccept(level)) {
+            writeSinks(level, entry, formatEntry(level, message, entry, sizeof(entry)));
+        }
+        if (!fileAccepts(level)) {
+            return;
+        }
+        
+        // Records must fit a ring slot whole - a cut record corrupts the file
+        size_t capacity = _asyncActive ? _ring.slotPayloadBytes() : sizeof(entry);
+        size_t length = _binary.text((uint8_t*)entry, capacity, nowUs(), static_cast<uint8_t>(level), message);
+        submitEntry(entry, length);
+        return;
+    }
+    
+    size_t length = formatEntry(level, message, entry, sizeof(entry));
+    
+    // One formatted line for every destination
+    writeSinks(level, entry, length);
+    if (!fileAccepts(level)) {
+        return;
+    }
+    
+    if (_asyncActive) {
+        // Keep the newline on entries cut to fit a ring slot
+        size_t payload = _ring.slotPayloadBytes();
+        if (length > payload) {
+            length = payload;
+            entry[length - 1] = '\n';
+        }
+    }
+    
+    submitEntry(entry, length);
+}
+
+/**
+ * @brief Core formatted logging function for binary mode (no vsnprintf)
+ * @param level Log level
+ * @param format Format string
+ * @param args Variable argument list
+ * @return void
+ */
+void EARS_logger::logBinary(LogLevel level, const char* format, va_list args) {
+    _linesLogged.fetch_add(1, std::memory_order_relaxed);
+    
+    // Only pay for vsnprintf when a sink wants the text
+    if (sinksAccept(level)) {
+        va_list sinkArgs;
+        va_copy(sinkArgs, args);
+        writeSinksFormatted(level, format, sinkArgs);
+        va_end(sinkArgs);
+    }
+    if (!fileAccepts(level)) {
+        return;
+    }
+    
+    uint8_t entry[ENTRY_BUFFER_SIZE];
+    size_t capacity = _asyncActive ? _ring.slotPayloadBytes() : sizeof(entry);
+    uint64_t now = nowUs();
+    
+    // First use of a format in this file carries the format string
+    uint32_t id;
+    size_t formatLength = _binary.formatRecord(entry, capacity, format, id);
+    if (_asyncActive && formatLength > 0) {
+        submitEntry((const char*)entry, formatLength);
+        formatLength = 0;
+    }
+    
+    size_t length = _binary.entry(entry + formatLength, capacity - formatLength, now,
+                                  static_cast<uint8_t>(level), id, format, args);
+    submitEntry((const char*)entry, formatLength + length);
+}
+
+/**
+ * @brief Queue or write one encoded entry
+ * @param data Entry bytes (text line or binary record)
+ * @param length Number of bytes
+ * @return void
+ */
+void EARS_logger::submitEntry(const char* data, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    
+    _bytesLogged.fetch_add(length, std::memory_order_relaxed);
+    
+    // A cut binary record would derail the decoder; skip those instead
+    if (_config.fileFormat != LogFileFormat::BINARY || length <= _crashLog.slotPayloadBytes()) {
+        _crashLog.append(data, length);
+    }
+    
+    if (_asyncActive) {
+        _ring.push(data, length);
+        return;
+    }
+    
+    writeEntries(data, length);
+}
+
+/**
+ * @brief Check if any attached sink takes a level
+ * @param level LogLevel of the message
+ * @return true if at least one sink wants the line
+ */
+bool EARS_logger::sinksAccept(LogLevel level) const {
+    size_t count = _sinkCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+        if (_sinks[i]->accepts(static_cast<uint8_t>(level))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Hand a formatted line to every sink that takes its level
+ * @param level LogLevel of the message
+ * @param line Formatted line ending in '\n'
+ * @param length Number of bytes
+ * @return void
+ */
+void EARS_logger::writeSinks(LogLevel level, const char* line, size_t length) {
+    size_t count = _sinkCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+        if (_sinks[i]->accepts(static_cast<uint8_t>(level))) {
+            _sinks[i]->write(static_cast<uint8_t>(level), line, length);
+        }
+    }
+}
+
+/**
+ * @brief Format a message as text for the sinks only (binary mode)
+ * @param level LogLevel of the message
+ * @param format printf-style format string
+ * @param args va_list of arguments, consumed
+ * @return void
+ */
+void EARS_logger::writeSinksFormatted(LogLevel level, const char* format, va_list args) {
+    char message[512];
+    vsnprintf(message, sizeof(message), format, args);
+    char line[ENTRY_BUFFER_SIZE];
+    writeSinks(level, line, formatEntry(level, message, line, sizeof(line)));
+}
+
+/**
+ * @brief Send every line to another sink as well
+ * @param sink Sink that lives as long as the logger
+ * @return true if added
+ * @return false if MAX_SINKS are already attached
+ */
+bool EARS_logger::addSink(EARS_logSink* sink) {
+    if (!sink) {
+        return false;
+    }
+    std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+    size_t count = _sinkCount.load(std::memory_order_relaxed);
+    if (count >= MAX_SINKS) {
+        return false;
+    }
+    // Fill the slot before publishing it to lock-free readers
+    _sinks[count] = sink;
+    _sinkCount.store(count + 1, std::memory_order_release);
+    refreshOutputLevel();
+    return true;
+}
+
+/**
+ * @brief Set the most verbose level a sink receives
+ * @param sink An attached sink
+ * @param level New level (NONE turns the sink off)
+ * @return void
+ */
+void EARS_logger::setSinkLevel(EARS_logSink& sink, LogLevel level) {
+    sink.setLevel(static_cast<uint8_t>(level));
+    if (&sink == &_serialSink) {
+        _config.serialLevel = level;
+    } else if (&sink == &_memorySink) {
+        _config.memoryLevel = level;
+    }
+    refreshOutputLevel();
+}
+
+/**
+ * @brief Set the most verbose level written to the log file
+ * @param level New level (NONE stops writing the file)
+ * @return void
+ */
+void EARS_logger::setFileLevel(LogLevel level) {
+    _config.sdLevel = level;
+    refreshOutputLevel();
+}
+
+/**
+ * @brief Recompute _outputLevel from the file and sink levels
+ * @return void
+ */
+void EARS_logger::refreshOutputLevel() {
+    uint8_t level = static_cast<uint8_t>(_config.sdLevel);
+    size_t count = _sinkCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+        if (_sinks[i]->getLevel() > level) {
+            level = _sinks[i]->getLevel();
+        }
+    }
+    _outputLevel.store(level, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Write what the previous session left in the crash log, then start a new one
+ * @return void
+ */
+void EARS_logger::recoverCrashLog() {
+    static_assert(sizeof(s_crashRegion) == CRASH_LOG_BYTES, "crash region size");
+    
+    bool binary = _config.fileFormat == LogFileFormat::BINARY;
+    uint32_t flags = binary ? CRASH_FLAG_BINARY : 0;
+    
+    if (!_crashLog.begin((uint8_t*)s_crashRegion, sizeof(s_crashRegion), CRASH_SLOT_BYTES)) {
+        return;
+    }
+    
+    size_t count = _crashLog.recoveredCount();
+    if (count > 0 && _crashLog.recoveredFlags() != flags) {
+        warnf("=== Previous session: %u entries in the other log format discarded ===", (unsigned)count);
+    } else if (count > 0) {
+        warnf("=== Previous session: last %u entries before reset ===", (unsigned)count);
+        
+        if (binary) {
+            // Recovered records are relative to the previous boot's time base
+            EARS_logBinaryWriter previous;
+            previous.begin(_crashLog.recoveredBaseUs());
+            uint8_t header[EARS_logBinaryWriter::FILE_HEADER_BYTES];
+            size_t headerLength = previous.fileHeader(header, sizeof(header));
+            writeEntries((const char*)header, headerLength);
+        }
+        
+        _crashLog.recover(writeRecovered, this);
+        
+        if (binary) {
+            uint8_t header[EARS_logBinaryWriter::FILE_HEADER_BYTES];
+            size_t headerLength = _binary.fileHeader(header, sizeof(header));
+            writeEntries((const char*)header, headerLength);
+        }
+        
+        warn("=== End of previous session ===");
+    }
+    
+    _crashLog.startSession(flags, binary ? _binary.baseUs() : 0);
+}
+
+/**
+ * @brief Crash log sink, writes one recovered entry
+ * @param data Entry bytes
+ * @param length Number of bytes
+ * @param context The logger
+ * @return void
+ */
+void EARS_logger::writeRecovered(const char* data, size_t length, void* context) {
+    EARS_logger* logger = static_cast<EARS_logger*>(context);
+    logger->writeEntries(data, length);
+    
+    // Text lines longer than a slot lost their newline
+    if (logger->_config.fileFormat != LogFileFormat::BINARY && length > 0 && data[length - 1] != '\n') {
+        logger->writeEntries("\n", 1);
+    }
+}
+
+/**
+ * @brief Current wall clock time
+ * @return uint64_t Microseconds since the epoch
+ */
+uint64_t EARS_logger::nowUs() const {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
+}
+
+/**
+ * @brief Format a complete log line
+ * @param level Log level
+ * @param message Message to log
+ * @param buffer Destination buffer
+ * @param bufferSize Size of buffer in bytes
+ * @return size_t Length of the line including the trailing newline
+ */
+size_t EARS_logger::formatEntry(LogLevel level, const char* message, char* buffer, size_t bufferSize) const {
+    // Timestamp straight into the line, no temporary string
+    buffer[0] = '[';
+    size_t stampLength = getTimestamp(buffer + 1, bufferSize - 1);
+    int written = snprintf(buffer + 1 + stampLength, bufferSize - 1 - stampLength, "] [%s] %s\n",
+                           getLevelString(level), message);
+    if (written < 0) {
+        return 0;
+    }
+    
+    size_t length = 1 + stampLength + (size_t)written;
+    if (length >= bufferSize) {
+        // Truncated - keep the line terminated
+        length = bufferSize - 1;
+        buffer[length - 1] = '\n';
+    }
+    return length;
+}
+
+/**
+ * @brief Append formatted entries to the log file, rotating first if needed
+ * @param data One or more complete log lines
+ * @param length Number of bytes
+ * @return true if append successful
+ * @return false if append failed
+ */
+bool EARS_logger::writeEntries(const char* data, size_t length) {
+    std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+    uint32_t opensBefore = _sdCard->getOpenCount();
+    
+    // Check if rotation needed; a preallocated file also when the entries do not fit
+    bool preallocated = usePrealloc();
+    if (!_rotating && (needsRotation() ||
+                       (preallocated && !_prealloc.fits(length + EARS_logBinaryWriter::FILE_HEADER_BYTES)))) {
         performRotation();
+        preallocated = usePrealloc();
+    }
+    
+    // Every binary file starts with its time base
+    if (_config.fileFormat == LogFileFormat::BINARY && _activeFileSize == 0) {
+        uint8_t header[EARS_logBinaryWriter::FILE_HEADER_BYTES];
+        size_t headerLength = _binary.fileHeader(header, sizeof(header));
+        if (appendActive(header, headerLength, preallocated)) {
+            _activeFileSize += headerLength;
+        }
+    }
+    
+    bool written = appendActive((const uint8_t*)data, length, preallocated);
+    if (written) {
+        _activeFileSize += length;
     }
     
-    // Format log entry
-    String logEntry = "[";
-    logEntry += getTimestamp();
-    logEntry += "] [";
-    logEntry += getLevelString(level);
-    logEntry += "] ";
-    logEntry += message;
-    logEntry += "\n";
+    if (preallocated) {
+        // The tracked size is exact; only the header needs catching up
+        if (millis() - _lastCommitMs >= PREALLOC_COMMIT_MS) {
+            commitLog();
+        }
+    } else if (++_writesSinceResync >= SIZE_RESYNC_WRITES) {
+        // Catch up with anything the tracked size missed (failed or external writes)
+        syncLogFileSize();
+    }
+    
+    // Rotation markers re-enter here; the outermost call counts for them
+    if (!_rotating) {
+        _stats.sdOpens += _sdCard->getOpenCount() - opensBefore;
+    }
     
-    // Write to file
-    _sdCard->appendFile(_logFilePath.c_str(), logEntry);
+    return written;
+}
+
+/**
+ * @brief Attach the preallocated log file if that mode is on
+ * @return true if entries go into a preallocated file
+ * @return false if they are appended (mode off, or a plain file is still active)
+ */
+bool EARS_logger::usePrealloc() {
+    if (!_config.preallocate) {
+        return false;
+    }
+    if (_prealloc.isAttached()) {
+        return true;
+    }
+    if (_prealloc.attach(*_sdCard, _logFilePath.c_str())) {
+        _activeFileSize = _prealloc.end();
+        _lastCommitMs = millis();
+        return true;
+    }
+    // A plain file from before the mode was turned on fills up first
+    return false;
+}
+
+/**
+ * @brief Append bytes to the active log file in its format
+ * @param data Bytes
+ * @param length Number of bytes
+ * @param preallocated Result of usePrealloc()
+ * @return true if written
+ */
+bool EARS_logger::appendActive(const uint8_t* data, size_t length, bool preallocated) {
+    if (preallocated) {
+        return _prealloc.append(*_sdCard, _logFilePath.c_str(), data, length);
+    }
+    return _sdCard->appendFile(_logFilePath.c_str(), data, length);
+}
+
+/**
+ * @brief Record the preallocated file's end in its header if it moved
+ * @return void
+ */
+void EARS_logger::commitLog() {
+    if (_prealloc.isDirty()) {
+        _prealloc.commit(*_sdCard, _logFilePath.c_str());
+    }
+    _lastCommitMs = millis();
 }
 
 /**
@@ -217,6 +970,11 @@ void EARS_logger::logf(LogLevel level, const char* format, va_list args) {
         return;
     }
     
+    if (_config.fileFormat == LogFileFormat::BINARY) {
+        logBinary(level, format, args);
+        return;
+    }
+    
     char buffer[512];
     vsnprintf(buffer, sizeof(buffer), format, args);
     log(level, buffer);
@@ -229,8 +987,9 @@ void EARS_logger::logf(LogLevel level, const char* format, va_list args) {
  * @return false if should not log
  */
 bool EARS_logger::shouldLog(LogLevel level) const {
-    // Hierarchical: current level must be >= message level
-    return (static_cast<int>(_config.currentLevel) >= static_cast<int>(level));
+    // Hierarchical: current level must be >= message level, and something must take it
+    return (static_cast<int>(_config.currentLevel) >= static_cast<int>(level)) &&
+           static_cast<uint8_t>(level) <= _outputLevel.load(std::memory_order_relaxed);
 }
 
 /**
@@ -265,26 +1024,13 @@ const char* EARS_logger::getLevelString(LogLevel level) const {
 }
 
 /**
- * @brief Get current timestamp string
- * @return String Timestamp in "YYYY-MM-DD HH:MM:SS" format 
+ * @brief Write the current timestamp into a buffer
+ * @param buffer Destination buffer
+ * @param bufferSize Size of buffer in bytes
+ * @return size_t Length in "YYYY-MM-DD HH:MM:SS[.mmm|.uuuuuu]" format, 0 if it did not fit
  */
-String EARS_logger::getTimestamp() const {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    
-    struct tm timeinfo;
-    localtime_r(&tv.tv_sec, &timeinfo);
-    
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d",
-             timeinfo.tm_year + 1900,
-             timeinfo.tm_mon + 1,
-             timeinfo.tm_mday,
-             timeinfo.tm_hour,
-             timeinfo.tm_min,
-             timeinfo.tm_sec);
-    
-    return String(buffer);
+size_t EARS_logger::getTimestamp(char* buffer, size_t bufferSize) const {
+    return _timestamp.format(nowUs(), buffer, bufferSize);
 }
 
 /**
@@ -302,6 +1048,21 @@ void EARS_logger::setLogLevel(LogLevel level) {
     }
 }
 
+/**
+ * @brief Set one module's runtime log level
+ * @param tag Module tag
+ * @param level Most verbose level logged for the module
+ * @return void
+ */
+void EARS_logger::setTagLevel(LogTag tag, LogLevel level) {
+    _tagLevels.set(tag, static_cast<uint8_t>(level));
+    saveConfig();
+    
+    if (shouldLog(LogLevel::INFO)) {
+        infof("Log level for %s changed to: %s", EARS_logTagLevels::tagName(tag), levelToString(level).c_str());
+    }
+}
+
 /**
  * @brief Get log level as string
  * @return String Log level string
@@ -366,93 +1127,207 @@ String EARS_logger::levelToString(LogLevel level) const {
 }
 
 /**
- * @brief Load entire unified config file
- * @param doc JsonDocument to load into
- * @return true if load successful
- * @return false if load failed* 
+ * @brief Parse overflow policy from string
+ * @param policyStr Overflow policy string
+ * @return LogOverflowPolicy Parsed policy
  */
-bool EARS_logger::loadUnifiedConfig(JsonDocument& doc) {
-    if (!_sdCard || !_sdCard->fileExists(_configFilePath.c_str())) {
-        return false;
+LogOverflowPolicy EARS_logger::parsePolicyString(const String& policyStr) const {
+    String upper = policyStr;
+    upper.toUpperCase();
+    
+    if (upper == "DROP_NEWEST") return LogOverflowPolicy::DROP_NEWEST;
+    if (upper == "BLOCK") return LogOverflowPolicy::BLOCK;
+    
+    return LogOverflowPolicy::DROP_OLDEST;  // Default, never stalls the caller
+}
+
+/**
+ * @brief Convert overflow policy to string
+ * @param policy Overflow policy
+ * @return const char* Policy string
+ */
+const char* EARS_logger::policyToString(LogOverflowPolicy policy) const {
+    switch (policy) {
+        case LogOverflowPolicy::DROP_NEWEST:
+            return "DROP_NEWEST";
+        case LogOverflowPolicy::BLOCK:
+            return "BLOCK";
+        case LogOverflowPolicy::DROP_OLDEST:
+        default:
+            return "DROP_OLDEST";
     }
+}
+
+/**
+ * @brief Parse log file format from string
+ * @param formatStr Log file format string
+ * @return LogFileFormat Parsed format
+ */
+LogFileFormat EARS_logger::parseFormatString(const String& formatStr) const {
+    String upper = formatStr;
+    upper.toUpperCase();
     
-    String jsonString = _sdCard->readFile(_configFilePath.c_str());
-    if (jsonString.length() == 0) {
-        return false;
+    if (upper == "BINARY") return LogFileFormat::BINARY;
+    
+    return LogFileFormat::TEXT;  // Default, readable without tools
+}
+
+/**
+ * @brief Convert log file format to string
+ * @param format Log file format
+ * @return const char* Format string
+ */
+const char* EARS_logger::formatToString(LogFileFormat format) const {
+    switch (format) {
+        case LogFileFormat::BINARY:
+            return "BINARY";
+        case LogFileFormat::TEXT:
+        default:
+            return "TEXT";
     }
+}
+
+/**
+ * @brief Parse timestamp precision from string
+ * @param precisionStr Timestamp precision string
+ * @return LogTimePrecision Parsed precision
+ */
+LogTimePrecision EARS_logger::parsePrecisionString(const String& precisionStr) const {
+    String upper = precisionStr;
+    upper.toUpperCase();
+    
+    if (upper == "MILLIS") return LogTimePrecision::MILLIS;
+    if (upper == "MICROS") return LogTimePrecision::MICROS;
     
-    DeserializationError error = deserializeJson(doc, jsonString);
-    return !error;
+    return LogTimePrecision::SECONDS;  // Default, matches older logs
 }
 
 /**
- * @brief Save entire unified config file
- * @param doc JsonDocument to save
- * @return true if save successful
- * @return false if save failed
+ * @brief Convert timestamp precision to string
+ * @param precision Timestamp precision
+ * @return const char* Precision string
  */
-bool EARS_logger::saveUnifiedConfig(const JsonDocument& doc) {
-    String jsonString;
-    serializeJsonPretty(doc, jsonString);
-    return _sdCard->writeFile(_configFilePath.c_str(), jsonString);
+const char* EARS_logger::precisionToString(LogTimePrecision precision) const {
+    switch (precision) {
+        case LogTimePrecision::MILLIS:
+            return "MILLIS";
+        case LogTimePrecision::MICROS:
+            return "MICROS";
+        case LogTimePrecision::SECONDS:
+        default:
+            return "SECONDS";
+    }
 }
 
 /**
- * @brief Load logger config from unified ears.config
- * @return true if load successful
- * @return false if load failed
+ * @brief Load logger config from the ears.config service
+ * @return true always, missing values keep their defaults
  */
 bool EARS_logger::loadConfig() {
-    JsonDocument doc;
+    LoggerSettings settings = EARS_config::getInstance().logger();
     
-    if (!loadUnifiedConfig(doc)) {
-        // Config doesn't exist, create default
-        doc["system"]["version"] = "1.0.0";
-        doc["system"]["zap_number"] = "";  // Will be populated from NVS
-        doc["system"]["device_name"] = "EARS";
-        
-        doc["logger"]["log_level"] = "DEBUG";
-        doc["logger"]["max_file_size_bytes"] = 1048576;
-        doc["logger"]["max_rotated_files"] = 3;
+    _config.maxFileSizeBytes = settings.maxFileSizeBytes;
+    _config.maxRotatedFiles = settings.maxRotatedFiles;
+    _config.asyncEnabled = settings.async;
+    _config.asyncBufferBytes = settings.asyncBufferBytes;
+    _config.overflowPolicy = parsePolicyString(String(settings.overflowPolicy));
+    _config.fileFormat = parseFormatString(String(settings.logFormat));
+    _config.compressRotated = settings.compressRotated;
+    _config.preallocate = settings.preallocate;
+    _config.timePrecision = parsePrecisionString(String(settings.timestampPrecision));
+    _timestamp.setPrecision(_config.timePrecision);
+    _config.memoryEntries = settings.memoryEntries;
+    applyLevels(settings, CONFIG_LEVEL_KEYS);
+    
+    return true;
+}
+
+/**
+ * @brief Take the global, per-destination and per-module levels
+ * @param settings Logger section
+ * @param changed Level keys to take; the others are left as they are
+ * @return void
+ */
+void EARS_logger::applyLevels(const LoggerSettings& settings, ConfigKeyMask changed) {
+    const ConfigKeyMask levelKeys = CONFIG_LEVEL_KEYS & ~EARS_configKeyBit(ConfigKey::LOGGER_TAG_LEVELS);
+    if (changed & levelKeys) {
+        _config.currentLevel = parseLevelString(String(settings.logLevel));
         
-        saveUnifiedConfig(doc);
+        // Per-destination levels, e.g. "sinks": { "sd": "DEBUG", "serial": "INFO" }
+        _config.sdLevel = parseLevelString(String(settings.sdLevel));
+        _config.serialLevel = parseLevelString(String(settings.serialLevel));
+        _config.memoryLevel = parseLevelString(String(settings.memoryLevel));
+        _serialSink.setLevel(static_cast<uint8_t>(_config.serialLevel));
+        _memorySink.setLevel(static_cast<uint8_t>(_config.memoryLevel));
+        refreshOutputLevel();
     }
     
-    // Extract logger section
-    JsonObject loggerObj = doc["logger"];
-    if (loggerObj.isNull()) {
-        return false;
+    if (!(changed & EARS_configKeyBit(ConfigKey::LOGGER_TAG_LEVELS))) {
+        return;
     }
-    
-    String levelStr = loggerObj["log_level"] | "DEBUG";
-    _config.currentLevel = parseLevelString(levelStr);
-    _config.maxFileSizeBytes = loggerObj["max_file_size_bytes"] | 1048576;
-    _config.maxRotatedFiles = loggerObj["max_rotated_files"] | 3;
-    
-    return true;
+    // Optional per-module levels, e.g. "tag_levels": { "SDCARD": "WARN" };
+    // built aside and published once while other tasks are logging
+    uint8_t levels[(size_t)LogTag::COUNT];
+    for (size_t i = 0; i < (size_t)LogTag::COUNT; i++) {
+        levels[i] = static_cast<uint8_t>(LogLevel::DEBUG);
+    }
+    for (uint8_t i = 0; i < settings.tagCount; i++) {
+        LogTag tag;
+        if (EARS_logTagLevels::parseTag(settings.tags[i].name, tag)) {
+            levels[(size_t)tag] = static_cast<uint8_t>(parseLevelString(String(settings.tags[i].level)));
+        }
+    }
+    _tagLevels.assign(levels);
+}
+
+/**
+ * @brief EARS_config observer: levels changed by other code apply at once
+ * @param changed Level keys that changed
+ * @param model Every setting
+ * @param context EARS_logger instance
+ * @return void
+ *
+ * Sizes, formats and async mode still need a restart.
+ */
+void EARS_logger::configChanged(ConfigKeyMask changed, const ConfigModel& model, void* context) {
+    static_cast<EARS_logger*>(context)->applyLevels(model.logger, changed);
 }
 
 /**
- * @brief Save logger config to unified ears.config
- * @return true if save successful
- * @return false if save failed
+ * @brief Save logger config to the ears.config service
+ * @return true if the logger section was handed over
+ * @return false if the logger is not initialized
+ *
+ * Only marks the section dirty; the service writes it after the debounce.
  */
 bool EARS_logger::saveConfig() {
     if (!_initialized) {
         return false;
     }
     
-    JsonDocument doc;
-    
-    // Load existing config or create new
-    loadUnifiedConfig(doc);
-    
-    // Update logger section
-    doc["logger"]["log_level"] = levelToString(_config.currentLevel);
-    doc["logger"]["max_file_size_bytes"] = _config.maxFileSizeBytes;
-    doc["logger"]["max_rotated_files"] = _config.maxRotatedFiles;
+    LoggerSettings settings;
+    snprintf(settings.logLevel, sizeof(settings.logLevel), "%s", levelToString(_config.currentLevel).c_str());
+    settings.maxFileSizeBytes = _config.maxFileSizeBytes;
+    settings.maxRotatedFiles = _config.maxRotatedFiles;
+    settings.async = _config.asyncEnabled;
+    settings.asyncBufferBytes = _config.asyncBufferBytes;
+    snprintf(settings.overflowPolicy, sizeof(settings.overflowPolicy), "%s", policyToString(_config.overflowPolicy));
+    snprintf(settings.logFormat, sizeof(settings.logFormat), "%s", formatToString(_config.fileFormat));
+    settings.compressRotated = _config.compressRotated;
+    settings.preallocate = _config.preallocate;
+    snprintf(settings.timestampPrecision, sizeof(settings.timestampPrecision), "%s",
+             precisionToString(_config.timePrecision));
+    snprintf(settings.sdLevel, sizeof(settings.sdLevel), "%s", levelToString(_config.sdLevel).c_str());
+    snprintf(settings.serialLevel, sizeof(settings.serialLevel), "%s", levelToString(_config.serialLevel).c_str());
+    snprintf(settings.memoryLevel, sizeof(settings.memoryLevel), "%s", levelToString(_config.memoryLevel).c_str());
+    settings.memoryEntries = _config.memoryEntries;
+    for (size_t i = 0; i < (size_t)LogTag::COUNT; i++) {
+        LogTag tag = (LogTag)i;
+        settings.setTagLevel(EARS_logTagLevels::tagName(tag), levelToString(getTagLevel(tag)).c_str());
+    }
     
-    return saveUnifiedConfig(doc);
+    EARS_config::getInstance().setLogger(settings, millis());
+    return true;
 }
 
 /**
@@ -465,7 +1340,16 @@ bool EARS_logger::clearLog() {
         return false;
     }
     
-    bool result = _sdCard->removeFile(_logFilePath.c_str());
+    bool result;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+        result = _sdCard->removeFile(_logFilePath.c_str());
+        if (result) {
+            _prealloc.detach();
+            _activeFileSize = 0;
+            _binary.resetDictionary();
+        }
+    }
     
     if (result) {
         info("Log file cleared");
@@ -476,22 +1360,28 @@ bool EARS_logger::clearLog() {
 
 /**
  * @brief Get current log file size in bytes
- * @return uint32_t Log file size in bytes
+ * @return uint32_t Log file size in bytes (tracked in RAM)
  */
 uint32_t EARS_logger::getLogFileSize() {
-    if (!_initialized || !_sdCard->fileExists(_logFilePath.c_str())) {
+    if (!_initialized) {
         return 0;
     }
-    
-    File file = SD.open(_logFilePath.c_str(), FILE_READ);
-    if (!file) {
-        return 0;
+    return _activeFileSize;
+}
+
+/**
+ * @brief Re-read the active log file size from the card
+ * @return void
+ */
+void EARS_logger::syncLogFileSize() {
+    // A preallocated file's size is its capacity; its header knows the data
+    if (usePrealloc()) {
+        _activeFileSize = _prealloc.end();
+    } else {
+        _activeFileSize = _sdCard->getFileSize(_logFilePath.c_str());
     }
-    
-    uint32_t size = file.size();
-    file.close();
-    
-    return size;
+    _writesSinceResync = 0;
+    _stats.sizeResyncs++;
 }
 
 /**
@@ -508,54 +1398,88 @@ float EARS_logger::getLogFileSizeMB() {
  * @return false if rotation not needed
  */
 bool EARS_logger::needsRotation() {
-    uint32_t currentSize = getLogFileSize();
-    return (currentSize >= _config.maxFileSizeBytes);
+    return (_activeFileSize >= _config.maxFileSizeBytes);
 }
 
 /**
- * @brief Perform log rotation
+ * @brief Perform log rotation by renaming generations (no data copied)
  * @return true if rotation successful
  * @return false if rotation failed
+ * 
+ * The active log is only ever renamed, never deleted, so a power cut at
+ * any point leaves it intact under either its own name or ".1".
  */
 bool EARS_logger::performRotation() {
     if (!_initialized) {
         return false;
     }
     
-    info("Starting log rotation...");
-    
-    // Delete oldest rotated file if it exists
-    String oldestFile = _logFilePath + "." + String(_config.maxRotatedFiles);
-    if (_sdCard->fileExists(oldestFile.c_str())) {
-        _sdCard->removeFile(oldestFile.c_str());
+    std::lock_guard<std::recursive_mutex> lock(_writeMutex);
+    if (_rotating) {
+        return false;
     }
     
-    // Shift all rotated files up by one
-    for (int i = _config.maxRotatedFiles - 1; i >= 1; i--) {
-        String oldName = _logFilePath + "." + String(i);
-        String newName = _logFilePath + "." + String(i + 1);
-        
-        if (_sdCard->fileExists(oldName.c_str())) {
-            // Read old file
-            String content = _sdCard->readFile(oldName.c_str());
-            // Write to new file
-            _sdCard->writeFile(newName.c_str(), content);
-            // Delete old file
-            _sdCard->removeFile(oldName.c_str());
+    _rotating = true;
+    
+    logRotationMarker(LogLevel::INFO, "Starting log rotation...");
+    // Preallocated: the oldest generation's clusters become the next file
+    bool rotated = _config.preallocate
+                       ? _prealloc.rotate(*_sdCard, _logFilePath.c_str(), _config.maxRotatedFiles)
+                       : EARS_rotateGenerations(*_sdCard, _logFilePath.c_str(), _config.maxRotatedFiles);
+    if (rotated) {
+        _activeFileSize = 0;
+        _writesSinceResync = 0;
+        _binary.resetDictionary();
+        _rotationCount++;
+        if (_compressTask) {
+            xTaskNotifyGive(_compressTask);
         }
+        logRotationMarker(LogLevel::INFO, "Log rotation completed");
+    } else {
+        logRotationMarker(LogLevel::ERROR, "Log rotation failed, continuing in current file");
     }
     
-    // Rename current log to .1
-    String rotatedName = _logFilePath + ".1";
-    if (_sdCard->fileExists(_logFilePath.c_str())) {
-        String content = _sdCard->readFile(_logFilePath.c_str());
-        _sdCard->writeFile(rotatedName.c_str(), content);
-        _sdCard->removeFile(_logFilePath.c_str());
+    _rotating = false;
+    
+    return rotated;
+}
+
+/**
+ * @brief Log a rotation marker straight to the sinks and the file
+ * @param level LogLevel of the marker
+ * @param message Marker text
+ * @return void
+ *
+ * Rotation runs with _writeMutex held, usually on the flusher task, so a
+ * marker queued in the ring would wait on (or land behind) the very
+ * batch being written. It is written in place instead: "Starting" ends
+ * the old file, "completed" opens the new one.
+ */
+void EARS_logger::logRotationMarker(LogLevel level, const char* message) {
+    if (!shouldLog(level)) {
+        return;
     }
     
-    info("Log rotation completed");
+    _linesLogged.fetch_add(1, std::memory_order_relaxed);
     
-    return true;
+    char entry[ENTRY_BUFFER_SIZE];
+    size_t length = formatEntry(level, message, entry, sizeof(entry));
+    writeSinks(level, entry, length);
+    if (!fileAccepts(level)) {
+        return;
+    }
+    if (_config.fileFormat == LogFileFormat::BINARY) {
+        length = _binary.text((uint8_t*)entry, sizeof(entry), nowUs(), static_cast<uint8_t>(level), message);
+    }
+    if (length == 0) {
+        return;
+    }
+    
+    _bytesLogged.fetch_add(length, std::memory_order_relaxed);
+    if (_config.fileFormat != LogFileFormat::BINARY || length <= _crashLog.slotPayloadBytes()) {
+        _crashLog.append(entry, length);
+    }
+    writeEntries(entry, length);
 }
 
 /**
@@ -2,8 +2,8 @@
  * @file EARS_loggerLib.h
  * @author JTB & Claude Sonnet 4.2
  * @brief Enhanced logging system with hierarchical levels and unified config
- * @version 2.7.0
- * @date 20260116
+ * @version 2.23.3
+ * @date 20261016
  * 
  * @copyright Copyright (c) 2026 JTB. All rights reserved.
  */
@@ -17,8 +17,21 @@
  *****************************************************************************/
 #include <Arduino.h>
 #include <SD.h>
-#include <ArduinoJson.h>
+#include <atomic>
+#include <mutex>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include "EARS_sdCardLib.h"
+#include "EARS_logRingLib.h"
+#include "EARS_logBinaryLib.h"
+#include "EARS_logFilterLib.h"
+#include "EARS_crashLogLib.h"
+#include "EARS_logCompressLib.h"
+#include "EARS_configLib.h"
+#include "EARS_logTimeLib.h"
+#include "EARS_logSinkLib.h"
+#include "EARS_logSerialSink.h"
+#include "EARS_preallocLog.h"
 
 /**
  * @brief Hierarchical log level enumeration
@@ -38,6 +51,18 @@ enum class LogLevel {
     DEBUG = 4   // Everything (most verbose)
 };
 
+/**
+ * @brief On-card log file format
+ *
+ * - TEXT: formatted lines, readable as is
+ * - BINARY: compact records with deferred formatting (EARS_logBinaryLib),
+ *   read back with tools/ears_logdecode
+ */
+enum class LogFileFormat : uint8_t {
+    TEXT = 0,
+    BINARY = 1
+};
+
 /**
  * @brief Logger configuration structure
  */
@@ -45,12 +70,66 @@ struct LoggerConfig {
     LogLevel currentLevel;
     uint32_t maxFileSizeBytes;
     uint8_t maxRotatedFiles;
+    bool asyncEnabled;                  // Queue entries for the Core 0 flush task
+    uint32_t asyncBufferBytes;          // PSRAM ring size for async mode
+    LogOverflowPolicy overflowPolicy;   // What to do when the ring is full
+    LogFileFormat fileFormat;           // Text lines or binary records
+    bool compressRotated;               // Compress rotated generations in the background
+    bool preallocate;                   // Allocate each log file at maxFileSizeBytes and fill it in place
+    LogTimePrecision timePrecision;     // Sub-second digits in text timestamps
+    LogLevel sdLevel;                   // Most verbose level written to the log file
+    LogLevel serialLevel;               // ... to USB serial
+    LogLevel memoryLevel;               // ... to the in-RAM ring
+    uint16_t memoryEntries;             // Lines the in-RAM ring holds
     
     // Default constructor - Development defaults
     LoggerConfig() : 
         currentLevel(LogLevel::DEBUG),  // Most verbose for development
         maxFileSizeBytes(1048576),      // 1MB
-        maxRotatedFiles(3) {}
+        maxRotatedFiles(3),
+        asyncEnabled(false),            // Synchronous unless ears.config says otherwise
+        asyncBufferBytes(65536),        // 64KB = 256 entries
+        overflowPolicy(LogOverflowPolicy::DROP_OLDEST),
+        fileFormat(LogFileFormat::TEXT),
+        compressRotated(false),
+        preallocate(false),
+        timePrecision(LogTimePrecision::SECONDS),
+        sdLevel(LogLevel::DEBUG),
+        serialLevel(LogLevel::NONE),    // Quiet unless ears.config says otherwise
+        memoryLevel(LogLevel::DEBUG),
+        memoryEntries(64) {}
+};
+
+/**
+ * @brief Logger I/O counters
+ */
+struct LoggerStats {
+    uint32_t linesLogged;   // Entries accepted by log()
+    uint32_t sdOpens;       // SD opens made writing entries, incl. rotation
+    uint32_t sizeResyncs;   // Times the tracked file size was re-read from the card
+    uint32_t bytesLogged;   // Entry bytes produced by log()/logf(), before any drops
+    uint32_t filesCompressed;       // Rotated generations compressed
+    uint32_t compressRawBytes;      // Their size before compression
+    uint32_t compressPackedBytes;   // And after
+    
+    LoggerStats() : linesLogged(0), sdOpens(0), sizeResyncs(0), bytesLogged(0),
+                    filesCompressed(0), compressRawBytes(0), compressPackedBytes(0) {}
+    
+    /**
+     * @brief Average SD opens per logged line
+     * @return float opens per line (0 if nothing logged)
+     */
+    float opensPerLine() const {
+        return linesLogged ? (float)sdOpens / (float)linesLogged : 0.0f;
+    }
+    
+    /**
+     * @brief Average entry size
+     * @return float bytes per logged line (0 if nothing logged)
+     */
+    float bytesPerLine() const {
+        return linesLogged ? (float)bytesLogged / (float)linesLogged : 0.0f;
+    }
 };
 
 /**
@@ -71,6 +150,8 @@ public:
      * @param sdCard Pointer to SDCard instance
      * @return true if initialization successful
      * @return false if initialization failed
+     *
+     * Start EARS_config first; without it the logger uses its defaults.
      */
     bool begin(const char* logFilePath, const char* configFilePath, EARS_sdCard* sdCard);
     
@@ -167,17 +248,16 @@ public:
     
     /**
      * @brief Save logger config to unified ears.config
-     * @return true if save successful
-     * @return false if save failed
+     * @return true if the logger section was handed to the config service
+     * @return false if the logger is not initialized
      * 
-     * Only updates the logger section, preserves other sections
+     * Only updates the logger section; EARS_config writes it after its debounce
      */
     bool saveConfig();
     
     /**
      * @brief Load logger config from unified ears.config
-     * @return true if load successful
-     * @return false if load failed
+     * @return true always, missing values keep their defaults
      */
     bool loadConfig();
     
@@ -191,6 +271,8 @@ public:
     /**
      * @brief Get current log file size in bytes
      * @return uint32_t log file size in bytes
+     * 
+     * Tracked in RAM from bytes written, no SD access
      */
     uint32_t getLogFileSize();
     
@@ -217,7 +299,182 @@ public:
      */
     bool wouldLog(LogLevel level) const;
     
+    /**
+     * @brief Check if a module's message at given level would be logged
+     * @param tag Module tag
+     * @param level LogLevel to check
+     * @return true if both the global and the module level allow it
+     * @return false if the message would be ignored
+     * 
+     * Inline so the tagged LOG_* macros can skip argument evaluation cheaply
+     */
+    bool wouldLog(LogTag tag, LogLevel level) const {
+        return _initialized &&
+               static_cast<int>(level) <= static_cast<int>(_config.currentLevel) &&
+               static_cast<uint8_t>(level) <= _outputLevel.load(std::memory_order_relaxed) &&
+               _tagLevels.allows(tag, static_cast<uint8_t>(level));
+    }
+    
+    /**
+     * @brief Set one module's runtime log level
+     * @param tag Module tag
+     * @param level Most verbose level logged for the module
+     * @return void
+     * 
+     * The global log level still applies; saved to ears.config
+     */
+    void setTagLevel(LogTag tag, LogLevel level);
+    
+    /**
+     * @brief Get one module's runtime log level
+     * @param tag Module tag
+     * @return LogLevel most verbose level logged for the module
+     */
+    LogLevel getTagLevel(LogTag tag) const { return static_cast<LogLevel>(_tagLevels.get(tag)); }
+    
+    /**
+     * @brief Check if entries are queued for the background flush task
+     * @return true if async mode is running
+     * @return false if entries are written synchronously
+     */
+    bool isAsync() const { return _asyncActive; }
+    
+    /**
+     * @brief Check if entries are written as binary records
+     * @return true if the log file holds EARS_logBinaryLib records
+     * @return false if the log file holds text lines
+     */
+    bool isBinary() const { return _config.fileFormat == LogFileFormat::BINARY; }
+    
+    /**
+     * @brief Get the path entries are written to
+     * @return const char* active log file path (".ebl" in binary mode)
+     */
+    const char* getLogFilePath() const { return _logFilePath.c_str(); }
+    
+    /**
+     * @brief Write all queued entries to the SD card now
+     * @return true if the queue was drained and the file committed
+     * @return false if the logger is not initialized or the commit failed
+     * 
+     * Drains the async queue, then syncs the card's write cache and open files.
+     * Call before a planned restart.
+     */
+    bool flush();
+    
+    /**
+     * @brief Drop the cached timestamp hour after the time zone (TZ) changed
+     * @return void
+     * 
+     * Clock jumps (e.g. NTP sync) need no call; only the UTC offset is cached.
+     */
+    void timeZoneChanged();
+    
+    /**
+     * @brief Get async ring counters (queued, dropped, high water)
+     * @return LogRingStats ring statistics, all zero in synchronous mode
+     */
+    LogRingStats getAsyncStats();
+    
+    /**
+     * @brief Get logger I/O counters
+     * @return LoggerStats counters since begin() or resetStats()
+     */
+    LoggerStats getStats() const;
+    
+    /**
+     * @brief Zero the logger I/O counters
+     * @return void
+     */
+    void resetStats();
+    
+    /**
+     * @brief Get preallocated log file counters
+     * @return PreallocStats files created and recycled, header commits
+     */
+    PreallocStats getPreallocStats() const;
+    
+    /**
+     * @brief Send every line to another sink as well
+     * @param sink Sink that lives as long as the logger; its level filters what it gets
+     * @return true if added
+     * @return false if MAX_SINKS are already attached
+     * 
+     * The USB serial and in-RAM ring sinks are attached from the start
+     */
+    bool addSink(EARS_logSink* sink);
+    
+    /**
+     * @brief Set the most verbose level a sink receives
+     * @param sink An attached sink, e.g. getMemorySink()
+     * @param level New level (NONE turns the sink off)
+     * @return void
+     * 
+     * Use this rather than sink.setLevel() so the logger's fast level
+     * check follows; saveConfig() stores the built-in sinks' levels
+     */
+    void setSinkLevel(EARS_logSink& sink, LogLevel level);
+    
+    /**
+     * @brief Set the most verbose level written to the log file
+     * @param level New level (NONE stops writing the file)
+     * @return void
+     */
+    void setFileLevel(LogLevel level);
+    
+    /**
+     * @brief Most verbose level written to the log file
+     * @return LogLevel file level
+     */
+    LogLevel getFileLevel() const { return _config.sdLevel; }
+    
+    /**
+     * @brief The last lines, for showing on screen
+     * @return EARS_logMemorySink& ring of the last memory_entries lines
+     */
+    EARS_logMemorySink& getMemorySink() { return _memorySink; }
+    
+    /**
+     * @brief The USB serial sink
+     * @return EARS_logSink& serial sink
+     */
+    EARS_logSink& getSerialSink() { return _serialSink; }
+    
 private:
+    // Re-read the real file size from the card after this many appends
+    static const uint32_t SIZE_RESYNC_WRITES = 256;
+    
+    // Async mode tuning
+    static const size_t ASYNC_SLOT_BYTES = 256;         // Longest queued entry + 2
+    static const size_t ASYNC_BATCH_BYTES = 8192;       // Bytes per SD append
+    static const uint32_t ASYNC_MAX_LATENCY_MS = 250;   // Max wait for a full batch
+    static const uint32_t ASYNC_TASK_STACK = 6144;
+    static const UBaseType_t ASYNC_TASK_PRIORITY = 1;
+    static const BaseType_t ASYNC_TASK_CORE = 0;
+    
+    // Longest formatted entry: timestamp + level + 512 byte message
+    // (also holds a binary FORMAT record plus its ENTRY record)
+    static const size_t ENTRY_BUFFER_SIZE = 560;
+    
+    // Crash log: the last entries kept in .noinit RAM across resets
+    static const size_t CRASH_LOG_BYTES = 4096;
+    static const size_t CRASH_SLOT_BYTES = 128;         // 120 byte entries, longer lines are cut
+    static const uint32_t CRASH_FLAG_BINARY = 0x01;     // Session wrote binary records
+    
+    // Rotated log compression, runs only when nothing else wants Core 0
+    static const size_t COMPRESS_BLOCK_BYTES = EARS_logCompressor::DEFAULT_BLOCK_BYTES;
+    static const uint32_t COMPRESS_TASK_STACK = 4096;
+    static const UBaseType_t COMPRESS_TASK_PRIORITY = tskIDLE_PRIORITY;
+    static const BaseType_t COMPRESS_TASK_CORE = 0;
+    
+    // Longest a preallocated file's header lags behind its data
+    static const uint32_t PREALLOC_COMMIT_MS = 1000;
+    
+    // Sinks besides the log file, incl. the built-in serial and memory sinks
+    static const size_t MAX_SINKS = 4;
+    static const size_t MEMORY_SLOT_BYTES = 160;        // 152 characters per line on screen
+    
+
     // Singleton - private constructor
     EARS_logger();
     ~EARS_logger();
@@ -231,6 +488,48 @@ private:
     String _configFilePath;
     EARS_sdCard* _sdCard;
     LoggerConfig _config;
+    bool _rotating;     // Rotation in progress - its own messages must not re-trigger it
+    uint32_t _activeFileSize;       // Tracked size of the active log file
+    uint32_t _writesSinceResync;
+    LoggerStats _stats;             // sdOpens and sizeResyncs, guarded by _writeMutex
+    std::atomic<uint32_t> _linesLogged;     // Bumped by any task without a lock
+    std::atomic<uint32_t> _bytesLogged;
+    
+    // Serializes everything that touches the card: synchronous writes,
+    // the flush task's batches, rotation and clearing. Recursive because
+    // rotation logs its own messages in synchronous mode.
+    mutable std::recursive_mutex _writeMutex;
+    EARS_logBinaryWriter _binary;   // Binary mode encoder
+    EARS_logTagLevels _tagLevels;   // Runtime level per module
+    EARS_crashLog _crashLog;        // Mirror of the last entries for the next boot
+    mutable EARS_logTimestamp _timestamp;   // Cached date and hour for text lines
+    
+    // Async mode state
+    bool _asyncActive;
+    EARS_logRing _ring;
+    EARS_logFlusher _flusher;
+    uint8_t* _ringStorage;
+    char* _batchBuffer;
+    TaskHandle_t _flushTask;
+    std::atomic<bool> _flushStop;
+    
+    // Compression state
+    EARS_logCompressor _compressor;
+    uint8_t* _compressWorkspace;
+    TaskHandle_t _compressTask;
+    uint32_t _rotationCount;        // Bumped under _writeMutex by every rotation
+    
+    // Preallocated file state, guarded by _writeMutex
+    EARS_preallocLog _prealloc;
+    uint32_t _lastCommitMs;
+    
+    // Sink state; entries below _sinkCount never change once published
+    EARS_logSerialSink _serialSink;
+    EARS_logMemorySink _memorySink;
+    uint8_t* _memoryStorage;
+    EARS_logSink* _sinks[MAX_SINKS];
+    std::atomic<size_t> _sinkCount;
+    std::atomic<uint8_t> _outputLevel;      // Most verbose level the file or any sink takes
     
     /**
      * @brief Core logging function
@@ -249,6 +548,205 @@ private:
      */
     void logf(LogLevel level, const char* format, va_list args);
     
+    /**
+     * @brief Core formatted logging function for binary mode (no vsnprintf)
+     * @param level LogLevel of the message
+     * @param format printf-style format string
+     * @param args va_list of arguments
+     * @return void
+     */
+    void logBinary(LogLevel level, const char* format, va_list args);
+    
+    /**
+     * @brief Queue or write one encoded entry
+     * @param data Entry bytes (text line or binary record)
+     * @param length Number of bytes
+     * @return void
+     */
+    void submitEntry(const char* data, size_t length);
+    
+    /**
+     * @brief Check if the log file takes a level
+     * @param level LogLevel of the message
+     * @return true if the entry goes to the file
+     */
+    bool fileAccepts(LogLevel level) const {
+        return static_cast<int>(level) <= static_cast<int>(_config.sdLevel);
+    }
+    
+    /**
+     * @brief Check if any attached sink takes a level
+     * @param level LogLevel of the message
+     * @return true if at least one sink wants the line
+     */
+    bool sinksAccept(LogLevel level) const;
+    
+    /**
+     * @brief Hand a formatted line to every sink that takes its level
+     * @param level LogLevel of the message
+     * @param line Formatted line ending in '\n'
+     * @param length Number of bytes
+     * @return void
+     */
+    void writeSinks(LogLevel level, const char* line, size_t length);
+    
+    /**
+     * @brief Format a message as text for the sinks only (binary mode)
+     * @param level LogLevel of the message
+     * @param format printf-style format string
+     * @param args va_list of arguments, consumed
+     * @return void
+     */
+    void writeSinksFormatted(LogLevel level, const char* format, va_list args);
+    
+    /**
+     * @brief Recompute _outputLevel from the file and sink levels
+     * @return void
+     */
+    void refreshOutputLevel();
+    
+    /**
+     * @brief Current wall clock time
+     * @return uint64_t microseconds since the epoch
+     */
+    uint64_t nowUs() const;
+    
+    /**
+     * @brief Format a complete log line
+     * @param level LogLevel of the message
+     * @param message Message to log
+     * @param buffer Destination buffer
+     * @param bufferSize Size of buffer in bytes
+     * @return size_t length of the line including the trailing newline
+     */
+    size_t formatEntry(LogLevel level, const char* message, char* buffer, size_t bufferSize) const;
+    
+    /**
+     * @brief Append formatted entries to the log file, rotating first if needed
+     * @param data One or more complete log lines
+     * @param length Number of bytes
+     * @return true if append successful
+     * @return false if append failed
+     */
+    bool writeEntries(const char* data, size_t length);
+    
+    /**
+     * @brief Attach the preallocated log file if that mode is on
+     * @return true if entries go into a preallocated file
+     * @return false if they are appended (mode off, or a plain file is still active)
+     */
+    bool usePrealloc();
+    
+    /**
+     * @brief Append bytes to the active log file in its format
+     * @param data Bytes
+     * @param length Number of bytes
+     * @param preallocated Result of usePrealloc()
+     * @return true if written
+     */
+    bool appendActive(const uint8_t* data, size_t length, bool preallocated);
+    
+    /**
+     * @brief Record the preallocated file's end in its header if it moved
+     * @return void
+     */
+    void commitLog();
+    
+    /**
+     * @brief Write what the previous session left in the crash log, then start a new one
+     * @return void
+     *
+     * Called from begin() before async mode starts, so everything goes
+     * straight to the card.
+     */
+    void recoverCrashLog();
+    
+    /**
+     * @brief Crash log sink, writes one recovered entry
+     * @param data Entry bytes
+     * @param length Number of bytes
+     * @param context The logger
+     * @return void
+     */
+    static void writeRecovered(const char* data, size_t length, void* context);
+    
+    /**
+     * @brief Allocate the PSRAM ring and start the Core 0 flush task
+     * @return true if async mode started
+     * @return false if allocation or task creation failed
+     */
+    bool startAsync();
+    
+    /**
+     * @brief Flusher sink, forwards a batch to writeEntries()
+     * @param data Batch bytes
+     * @param length Batch length
+     * @param context EARS_logger instance
+     * @return true if the batch was written
+     */
+    static bool writeBatch(const char* data, size_t length, void* context);
+    
+    /**
+     * @brief Take the global, per-destination and per-module levels
+     * @param settings Logger section
+     * @param changed Level keys to take; the others are left as they are
+     * @return void
+     */
+    void applyLevels(const LoggerSettings& settings, ConfigKeyMask changed);
+    
+    /**
+     * @brief EARS_config observer, applies level changes made elsewhere
+     * @param changed Level keys that changed
+     * @param model Every setting
+     * @param context EARS_logger instance
+     * @return void
+     */
+    static void configChanged(ConfigKeyMask changed, const ConfigModel& model, void* context);
+    
+    /**
+     * @brief Flusher idle hook, commits log writes left unflushed
+     * @param context EARS_logger instance
+     * @return void
+     */
+    static void flushIdle(void* context);
+    
+    /**
+     * @brief FreeRTOS task body draining the ring
+     * @param param EARS_logger instance
+     * @return void
+     */
+    static void flushTaskMain(void* param);
+    
+    /**
+     * @brief Allocate the compression workspace and start the background task
+     * @return true if compression started
+     * @return false if allocation or task creation failed
+     */
+    bool startCompression();
+    
+    /**
+     * @brief FreeRTOS task body compressing generations after each rotation
+     * @param param EARS_logger instance
+     * @return void
+     */
+    static void compressTaskMain(void* param);
+    
+    /**
+     * @brief Compress every plain rotated generation
+     * @return void
+     *
+     * Each generation is compressed to "<name>.tmp" without holding the
+     * write lock, then swapped in under the lock only if no rotation moved
+     * the generation meanwhile.
+     */
+    void compressGenerations();
+    
+    /**
+     * @brief Finish or discard swaps a reset interrupted
+     * @return void
+     */
+    void recoverCompression();
+    
     /**
      * @brief Check if level should be logged (hierarchical)
      * @param level LogLevel to check
@@ -263,40 +761,40 @@ private:
     const char* getLevelString(LogLevel level) const;
     
     /**
-     * @brief Get current timestamp string
-     * @return String timestamp in "YYYY-MM-DD HH:MM:SS" format
+     * @brief Write the current timestamp into a buffer
+     * @param buffer Destination, EARS_logTimestamp::MAX_LENGTH always fits
+     * @param bufferSize Size of buffer in bytes
+     * @return size_t length in "YYYY-MM-DD HH:MM:SS[.mmm|.uuuuuu]" format, 0 if it did not fit
      */
-    String getTimestamp() const;
+    size_t getTimestamp(char* buffer, size_t bufferSize) const;
     
     /**
-     * @brief Check if log needs rotation
+     * @brief Check if log needs rotation (tracked size, no SD access)
      * @return true if rotation needed
      * @return false if rotation not needed
      */
     bool needsRotation();
     
     /**
-     * @brief Perform log rotation
-     * @return true if rotation successful
-     * @return false if rotation failed
+     * @brief Re-read the active log file size from the card
+     * @return void
      */
-    bool performRotation();
+    void syncLogFileSize();
     
     /**
-     * @brief Load entire unified config file
-     * @param doc JsonDocument to load config into
-     * @return true if load successful
-     * @return false if load failed
+     * @brief Perform log rotation by renaming generations (no data copied)
+     * @return true if rotation successful
+     * @return false if rotation failed
      */
-    bool loadUnifiedConfig(JsonDocument& doc);
+    bool performRotation();
     
     /**
-     * @brief Save entire unified config file
-     * @param doc JsonDocument containing config to save
-     * @return true if save successful
-     * @return false if save failed
+     * @brief Log a rotation marker straight to the sinks and the file
+     * @param level LogLevel of the marker
+     * @param message Marker text
+     * @return void
      */
-    bool saveUnifiedConfig(const JsonDocument& doc);
+    void logRotationMarker(LogLevel level, const char* message);
     
     /**
      * @brief Parse log level from string
@@ -311,22 +809,80 @@ private:
      * @return String log level as string
      */
     String levelToString(LogLevel level) const;
+    
+    /**
+     * @brief Parse overflow policy from string
+     * @param policyStr "DROP_OLDEST", "DROP_NEWEST" or "BLOCK"
+     * @return LogOverflowPolicy parsed policy (DROP_OLDEST if invalid)
+     */
+    LogOverflowPolicy parsePolicyString(const String& policyStr) const;
+    
+    /**
+     * @brief Convert overflow policy to string
+     * @param policy LogOverflowPolicy to convert
+     * @return const char* policy as string
+     */
+    const char* policyToString(LogOverflowPolicy policy) const;
+    
+    /**
+     * @brief Parse log file format from string
+     * @param formatStr "TEXT" or "BINARY"
+     * @return LogFileFormat parsed format (TEXT if invalid)
+     */
+    LogFileFormat parseFormatString(const String& formatStr) const;
+    
+    /**
+     * @brief Convert log file format to string
+     * @param format LogFileFormat to convert
+     * @return const char* format as string
+     */
+    const char* formatToString(LogFileFormat format) const;
+    
+    /**
+     * @brief Parse timestamp precision from string
+     * @param precisionStr "SECONDS", "MILLIS" or "MICROS"
+     * @return LogTimePrecision parsed precision (SECONDS if invalid)
+     */
+    LogTimePrecision parsePrecisionString(const String& precisionStr) const;
+    
+    /**
+     * @brief Convert timestamp precision to string
+     * @param precision LogTimePrecision to convert
+     * @return const char* precision as string
+     */
+    const char* precisionToString(LogTimePrecision precision) const;
 };
 
-// Convenience macros for easy logging
-#define LOG_DEBUG(msg) EARS_logger::getInstance().debug(msg)
-#define LOG_DEBUGF(fmt, ...) EARS_logger::getInstance().debugf(fmt, __VA_ARGS__)
-#define LOG_INFO(msg) EARS_logger::getInstance().info(msg)
-#define LOG_INFOF(fmt, ...) EARS_logger::getInstance().infof(fmt, __VA_ARGS__)
-#define LOG_WARN(msg) EARS_logger::getInstance().warn(msg)
-#define LOG_WARNF(fmt, ...) EARS_logger::getInstance().warnf(fmt, __VA_ARGS__)
-#define LOG_ERROR(msg) EARS_logger::getInstance().error(msg)
-#define LOG_ERRORF(fmt, ...) EARS_logger::getInstance().errorf(fmt, __VA_ARGS__)
+// Tagged logging - compiled out above EARS_LOG_COMPILE_LEVEL_<tag>, and
+// arguments are only evaluated when the global and module levels allow it
+#define EARS_LOG_TAGGED(tag, level, method, ...) \
+    EARS_LOG_IF(tag, EARS_LOG_LEVEL_##level, \
+                EARS_logger::getInstance().wouldLog(LogTag::tag, LogLevel::level), \
+                EARS_logger::getInstance().method(__VA_ARGS__))
+
+#define LOG_TAG_DEBUG(tag, msg) EARS_LOG_TAGGED(tag, DEBUG, debug, msg)
+#define LOG_TAG_DEBUGF(tag, fmt, ...) EARS_LOG_TAGGED(tag, DEBUG, debugf, fmt, __VA_ARGS__)
+#define LOG_TAG_INFO(tag, msg) EARS_LOG_TAGGED(tag, INFO, info, msg)
+#define LOG_TAG_INFOF(tag, fmt, ...) EARS_LOG_TAGGED(tag, INFO, infof, fmt, __VA_ARGS__)
+#define LOG_TAG_WARN(tag, msg) EARS_LOG_TAGGED(tag, WARN, warn, msg)
+#define LOG_TAG_WARNF(tag, fmt, ...) EARS_LOG_TAGGED(tag, WARN, warnf, fmt, __VA_ARGS__)
+#define LOG_TAG_ERROR(tag, msg) EARS_LOG_TAGGED(tag, ERROR, error, msg)
+#define LOG_TAG_ERRORF(tag, fmt, ...) EARS_LOG_TAGGED(tag, ERROR, errorf, fmt, __VA_ARGS__)
+
+// Convenience macros for easy logging (APP tag)
+#define LOG_DEBUG(msg) LOG_TAG_DEBUG(APP, msg)
+#define LOG_DEBUGF(fmt, ...) LOG_TAG_DEBUGF(APP, fmt, __VA_ARGS__)
+#define LOG_INFO(msg) LOG_TAG_INFO(APP, msg)
+#define LOG_INFOF(fmt, ...) LOG_TAG_INFOF(APP, fmt, __VA_ARGS__)
+#define LOG_WARN(msg) LOG_TAG_WARN(APP, msg)
+#define LOG_WARNF(fmt, ...) LOG_TAG_WARNF(APP, fmt, __VA_ARGS__)
+#define LOG_ERROR(msg) LOG_TAG_ERROR(APP, msg)
+#define LOG_ERRORF(fmt, ...) LOG_TAG_ERRORF(APP, fmt, __VA_ARGS__)
 
 // Legacy macros for backward compatibility (map to INFO level)
 #define LOG_INIT(path, sd) EARS_logger::getInstance().begin(path, "/config/ears.config", sd)
-#define LOG(msg) EARS_logger::getInstance().info(msg)
-#define LOGF(fmt, ...) EARS_logger::getInstance().infof(fmt, __VA_ARGS__)
+#define LOG(msg) LOG_TAG_INFO(APP, msg)
+#define LOGF(fmt, ...) LOG_TAG_INFOF(APP, fmt, __VA_ARGS__)
 
 #endif // __EARS_LOGGER_LIB_H__
 
@@ -2,8 +2,8 @@
  * @file EARS_nvsEepromLib.cpp
  * @author Julian (51fiftyone51fiftyone@gmail.com)
  * @brief NVS EEPROM wrapper class header
- * @version 1.5.0
- * @date 20260116
+ * @version 1.7.0
+ * @date 20261016
  * 
  * @copyright Copyright (c) 2026 JTB. All rights reserved.
  */
@@ -14,20 +14,22 @@
 #include "EARS_nvsEepromLib.h"
 
 // NVS Namespace
-const char* EARS_nvsEeprom::NAMESPACE = "EARS";
+const char* EARS_nvsEeprom::NAMESPACE = EARS_NVS_NAMESPACE;
 
 // Standard NVS Keys
-const char* EARS_nvsEeprom::KEY_VERSION = "nvsVersion";
-const char* EARS_nvsEeprom::KEY_ZAPNUMBER = "zapNumber";
-const char* EARS_nvsEeprom::KEY_PASSWORD_HASH = "pwdHash";
-const char* EARS_nvsEeprom::KEY_NVS_CRC = "nvsCRC";
+const char* EARS_nvsEeprom::KEY_VERSION = EARS_NVS_KEY_VERSION;
+const char* EARS_nvsEeprom::KEY_ZAPNUMBER = EARS_NVS_KEY_ZAPNUMBER;
+const char* EARS_nvsEeprom::KEY_PASSWORD_HASH = EARS_NVS_KEY_PASSWORD_HASH;
+const char* EARS_nvsEeprom::KEY_NVS_CRC = EARS_NVS_KEY_CRC;
 
 // NVS Constructor 
-EARS_nvsEeprom::EARS_nvsEeprom() {
+EARS_nvsEeprom::EARS_nvsEeprom() : _session(0), _sessionOpen(false), _sessionMissing(false), _shadow(*this) {
 }
 
 // NVS Destructor
 EARS_nvsEeprom::~EARS_nvsEeprom() {
+    _shadow.flush();
+    closeNamespace();
 }
 
 /**
@@ -52,6 +54,14 @@ bool EARS_nvsEeprom::begin() {
  * @return Hash String 
  */
 String EARS_nvsEeprom::getHash(const char* key, const String& defaultValue) {
+    if (_shadow.accepts(key, NvsValueType::STRING)) {
+        char hash[EARS_nvsTransaction::MAX_STRING];
+        if (_shadow.getString(key, hash, sizeof(hash)) > 0) {
+            return String(hash);
+        }
+        // Missing, or too long for the shadow: ask NVS
+    }
+    
     // Open namespace in read-only mode
     if (!Preferences::begin(NAMESPACE, true)) {
         return defaultValue;
@@ -72,6 +82,10 @@ String EARS_nvsEeprom::getHash(const char* key, const String& defaultValue) {
  * @return false 
  */
 bool EARS_nvsEeprom::putHash(const char* key, const String& value) {
+    if (value.length() < EARS_nvsTransaction::MAX_STRING && _shadow.accepts(key, NvsValueType::STRING)) {
+        return _shadow.putString(key, value.c_str(), millis());
+    }
+    
     // Open namespace in read-write mode
     if (!Preferences::begin(NAMESPACE, false)) {
         return false;
@@ -80,6 +94,8 @@ bool EARS_nvsEeprom::putHash(const char* key, const String& value) {
     size_t result = putString(key, value);
     end();
     
+    // Written around the shadow
+    _shadow.invalidate();
     return (result > 0);
 }
 
@@ -91,16 +107,7 @@ bool EARS_nvsEeprom::putHash(const char* key, const String& value) {
  * @return uint32_t 
  */
 uint32_t EARS_nvsEeprom::calculateCRC32(const uint8_t* data, size_t length) {
-    uint32_t crc = 0xFFFFFFFF;
-    
-    for (size_t i = 0; i < length; i++) {
-        crc ^= data[i];
-        for (uint8_t j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
-        }
-    }
-    
-    return ~crc;
+    return EARS_nvsCRC32(data, length);
 }
 
 /**
@@ -140,6 +147,10 @@ bool EARS_nvsEeprom::compareHash(const String& data, const String& storedHash) {
  * @return uint16_t Version number (0-65535)
  */
 uint16_t EARS_nvsEeprom::getVersion(const char* key, uint16_t defaultVersion) {
+    if (_shadow.accepts(key, NvsValueType::U16)) {
+        return _shadow.getU16(key, defaultVersion);
+    }
+    
     // Open namespace in read-only mode
     if (!Preferences::begin(NAMESPACE, true)) {
         return defaultVersion;
@@ -160,6 +171,10 @@ uint16_t EARS_nvsEeprom::getVersion(const char* key, uint16_t defaultVersion) {
  * @return false Failed
  */
 bool EARS_nvsEeprom::putVersion(const char* key, uint16_t version) {
+    if (_shadow.accepts(key, NvsValueType::U16)) {
+        return _shadow.putU16(key, version, millis());
+    }
+    
     // Open namespace in read-write mode
     if (!Preferences::begin(NAMESPACE, false)) {
         return false;
@@ -179,24 +194,7 @@ bool EARS_nvsEeprom::putVersion(const char* key, uint16_t version) {
  * @return false Invalid format
  */
 bool EARS_nvsEeprom::isValidZapNumber(const String& zapNumber) {
-    // Must be exactly 6 characters
-    if (zapNumber.length() != 6) {
-        return false;
-    }
-    
-    // First two characters must be letters (A-Z)
-    if (!isAlpha(zapNumber[0]) || !isAlpha(zapNumber[1])) {
-        return false;
-    }
-    
-    // Last four characters must be digits (0-9)
-    for (int i = 2; i < 6; i++) {
-        if (!isDigit(zapNumber[i])) {
-            return false;
-        }
-    }
-    
-    return true;
+    return EARS_nvsValidZapNumber(zapNumber.c_str());
 }
 
 /**
@@ -205,32 +203,7 @@ bool EARS_nvsEeprom::isValidZapNumber(const String& zapNumber) {
  * @return uint32_t CRC32 value
  */
 uint32_t EARS_nvsEeprom::calculateNVSCRC() {
-    String dataToHash = "";
-    
-    // Open namespace in read-only mode
-    if (!Preferences::begin(NAMESPACE, true)) {
-        return 0;
-    }
-    
-    // Concatenate all critical data in a specific order
-    // Version
-    uint16_t version = getUShort(KEY_VERSION, 0);
-    dataToHash += String(version);
-    dataToHash += "|";
-    
-    // ZapNumber
-    String zapNum = getString(KEY_ZAPNUMBER, "");
-    dataToHash += zapNum;
-    dataToHash += "|";
-    
-    // Password Hash
-    String pwdHash = getString(KEY_PASSWORD_HASH, "");
-    dataToHash += pwdHash;
-    
-    end();
-    
-    // Calculate CRC32 of concatenated data
-    return calculateCRC32((const uint8_t*)dataToHash.c_str(), dataToHash.length());
+    return _shadow.calculateCRC();
 }
 
 /**
@@ -240,28 +213,22 @@ uint32_t EARS_nvsEeprom::calculateNVSCRC() {
  * @return false Failed
  */
 bool EARS_nvsEeprom::updateNVSCRC() {
-    uint32_t crc = calculateNVSCRC();
-    
-    // Open namespace in read-write mode
-    if (!Preferences::begin(NAMESPACE, false)) {
-        return false;
-    }
-    
-    size_t result = putUInt(KEY_NVS_CRC, crc);
-    end();
-    
-    return (result > 0);
+    return _shadow.updateCRC();
 }
 
 /**
  * @brief Upgrade NVS from one version to another
  * 
+ * Runs inside the validation transaction, which stores the new version
+ * and CRC afterwards with a single commit.
+ * 
+ * @param transaction Read-write session on the namespace
  * @param fromVersion Current version
  * @param toVersion Target version
  * @return true Upgrade successful
  * @return false Upgrade failed
  */
-bool EARS_nvsEeprom::upgradeNVS(uint16_t fromVersion, uint16_t toVersion) {
+bool EARS_nvsEeprom::upgradeNVS(EARS_nvsTransaction& transaction, uint16_t fromVersion, uint16_t toVersion) {
     // Prevent downgrade
     if (toVersion <= fromVersion) {
         return false;
@@ -272,30 +239,32 @@ bool EARS_nvsEeprom::upgradeNVS(uint16_t fromVersion, uint16_t toVersion) {
         return false;
     }
     
-    // Open namespace in read-write mode
-    if (!Preferences::begin(NAMESPACE, false)) {
-        return false;
-    }
-    
-    // Future: Add version-specific upgrade logic here
-    // For now, just update the version number
+    // Future: Add version-specific upgrade logic here, writing through
+    // transaction. For now only the version number changes.
     
     // Example upgrade paths:
     // if (fromVersion == 0 && toVersion >= 1) {
     //     // Upgrade from version 0 to 1
     //     // Add new keys, migrate data, etc.
     // }
+    (void)transaction;
     
-    // Update version
-    size_t result = putUShort(KEY_VERSION, toVersion);
-    end();
-    
-    if (result == 0) {
-        return false;
-    }
-    
-    // Recalculate and update CRC after upgrade
-    return updateNVSCRC();
+    return true;
+}
+
+/**
+ * @brief NVSUpgrade callback forwarding to upgradeNVS()
+ * 
+ * @param transaction Read-write session on the namespace
+ * @param fromVersion Current version
+ * @param toVersion Target version
+ * @param context The EARS_nvsEeprom
+ * @return true Upgrade successful
+ * @return false Upgrade failed
+ */
+bool EARS_nvsEeprom::upgradeStep(EARS_nvsTransaction& transaction, uint16_t fromVersion,
+                                 uint16_t toVersion, void* context) {
+    return static_cast<EARS_nvsEeprom*>(context)->upgradeNVS(transaction, fromVersion, toVersion);
 }
 
 /**
@@ -307,89 +276,24 @@ bool EARS_nvsEeprom::upgradeNVS(uint16_t fromVersion, uint16_t toVersion) {
  * 3. Password hash exists
  * 4. Overall CRC32 is valid (no tampering)
  * 
+ * All in one read only session; an upgrade reopens it read-write once.
+ * 
  * @return NVSValidationResult Structure containing validation results
  */
 NVSValidationResult EARS_nvsEeprom::validateNVS() {
-    NVSValidationResult result;
-    result.expectedVersion = CURRENT_VERSION;
-    
-    // Step 1: Check NVS initialization
-    if (!Preferences::begin(NAMESPACE, true)) {
-        result.status = NVSStatus::INITIALIZATION_FAILED;
-        end();
-        return result;
-    }
-    
-    // Step 2: Get and check version
-    result.currentVersion = getUShort(KEY_VERSION, 0);
-    
-    // Check if upgrade is needed
-    if (result.currentVersion < CURRENT_VERSION) {
-        end(); // Close read-only session
-        
-        // Attempt upgrade
-        if (upgradeNVS(result.currentVersion, CURRENT_VERSION)) {
-            result.wasUpgraded = true;
-            result.currentVersion = CURRENT_VERSION;
-        } else {
-            result.status = NVSStatus::INVALID_VERSION;
-            return result;
-        }
-        
-        // Reopen for continued validation
-        if (!Preferences::begin(NAMESPACE, true)) {
-            result.status = NVSStatus::INITIALIZATION_FAILED;
-            return result;
-        }
-    } else if (result.currentVersion > CURRENT_VERSION) {
-        // Version from future - cannot handle
-        result.status = NVSStatus::INVALID_VERSION;
-        end();
-        return result;
-    }
-    
-    // Step 3: Check ZapNumber
-    String zapNum = getString(KEY_ZAPNUMBER, "");
-    if (zapNum.length() == 0 || !isValidZapNumber(zapNum)) {
-        result.zapNumberValid = false;
-        result.status = NVSStatus::MISSING_ZAPNUMBER;
-        end();
-        return result;
-    }
-    result.zapNumberValid = true;
-    zapNum.toCharArray(result.zapNumber, 7);
+    // Validate what is on flash, pending changes included
+    _shadow.flush();
     
-    // Step 4: Check password hash
-    String pwdHash = getString(KEY_PASSWORD_HASH, "");
-    if (pwdHash.length() == 0) {
-        result.passwordHashValid = false;
-        result.status = NVSStatus::MISSING_PASSWORD;
-        end();
-        return result;
-    }
-    result.passwordHashValid = true;
-    
-    // Step 5: Check overall CRC32
-    uint32_t storedCRC = getUInt(KEY_NVS_CRC, 0);
-    end(); // Close before calculating new CRC
-    
-    uint32_t calculatedCRC = calculateNVSCRC();
-    result.calculatedCRC = calculatedCRC;
-    
-    if (storedCRC != calculatedCRC) {
-        result.crcValid = false;
-        result.status = NVSStatus::CRC_FAILED;
-        return result;
+    NVSValidationResult result;
+    {
+        EARS_nvsTransaction transaction(*this, true);
+        result = transaction.validate(CURRENT_VERSION, upgradeStep, this);
     }
-    result.crcValid = true;
     
-    // Step 6: All checks passed
+    // The upgrade wrote around the shadow
     if (result.wasUpgraded) {
-        result.status = NVSStatus::UPGRADED;
-    } else {
-        result.status = NVSStatus::VALID;
+        _shadow.invalidate();
     }
-    
     return result;
 }
 
@@ -399,23 +303,17 @@ NVSValidationResult EARS_nvsEeprom::validateNVS() {
  * @return String The stored ZapNumber or empty string if not found
  */
 String EARS_nvsEeprom::getZapNumber() {
-    // Open namespace in read-only mode
-    if (!Preferences::begin(NAMESPACE, true)) {
-        return "";
-    }
-    
-    String zapNumber = getString(KEY_ZAPNUMBER, "");
-    end();
-    
-    return zapNumber;
+    char zapNumber[EARS_nvsTransaction::MAX_STRING];
+    _shadow.getString(KEY_ZAPNUMBER, zapNumber, sizeof(zapNumber));
+    return String(zapNumber);
 }
 
 /**
  * @brief Set ZapNumber in NVS
  * 
  * @param zapNumber The ZapNumber to store (format: AANNNN)
- * @return true if successful
- * @return false if invalid format or write failed
+ * @return true if stored, poll() or flush() writes it back with the CRC
+ * @return false if invalid format
  */
 bool EARS_nvsEeprom::setZapNumber(const String& zapNumber) {
     // Validate format first
@@ -423,21 +321,134 @@ bool EARS_nvsEeprom::setZapNumber(const String& zapNumber) {
         return false;
     }
     
-    // Open namespace in read-write mode
-    if (!Preferences::begin(NAMESPACE, false)) {
+    // Written back with the CRC by poll() or flush()
+    return _shadow.putString(KEY_ZAPNUMBER, zapNumber.c_str(), millis());
+}
+
+/**
+ * @brief Write back shadowed changes once they settle, call once per UI tick
+ * 
+ * @param nowMs Current time in milliseconds
+ * @return true if nothing is left to write
+ */
+bool EARS_nvsEeprom::poll(uint32_t nowMs) {
+    return _shadow.poll(nowMs);
+}
+
+/**
+ * @brief Write back shadowed changes now, call before a planned restart
+ * 
+ * @return true if flash holds every change
+ */
+bool EARS_nvsEeprom::flush() {
+    return _shadow.flush();
+}
+
+/**
+ * @brief Open a namespace, one may be open at a time
+ * 
+ * @param name Namespace name
+ * @param readOnly true to open read only
+ * @return true if opened; read only fails if the namespace does not exist
+ */
+bool EARS_nvsEeprom::openNamespace(const char* name, bool readOnly) {
+    _sessionMissing = false;
+    if (_sessionOpen) {
         return false;
     }
-    
-    // Store in NVS
-    size_t result = putString(KEY_ZAPNUMBER, zapNumber);
-    end();
-    
-    if (result == 0) {
-        return false;
+    esp_err_t err = nvs_open(name, readOnly ? NVS_READONLY : NVS_READWRITE, &_session);
+    _sessionOpen = (err == ESP_OK);
+    _sessionMissing = (err == ESP_ERR_NVS_NOT_FOUND);
+    return _sessionOpen;
+}
+
+/**
+ * @brief Close the open namespace
+ * 
+ * @return void
+ */
+void EARS_nvsEeprom::closeNamespace() {
+    if (_sessionOpen) {
+        nvs_close(_session);
+        _sessionOpen = false;
     }
-    
-    // Update CRC after successful write
-    return updateNVSCRC();
+}
+
+/**
+ * @brief Read an unsigned 16 bit value
+ * 
+ * @param key Key name
+ * @param value Receives the value
+ * @return true if the key exists with this type
+ */
+bool EARS_nvsEeprom::readU16(const char* key, uint16_t& value) {
+    return _sessionOpen && nvs_get_u16(_session, key, &value) == ESP_OK;
+}
+
+/**
+ * @brief Read an unsigned 32 bit value
+ * 
+ * @param key Key name
+ * @param value Receives the value
+ * @return true if the key exists with this type
+ */
+bool EARS_nvsEeprom::readU32(const char* key, uint32_t& value) {
+    return _sessionOpen && nvs_get_u32(_session, key, &value) == ESP_OK;
+}
+
+/**
+ * @brief Read a string
+ * 
+ * @param key Key name
+ * @param out Receives the string, null terminated
+ * @param outBytes Size of out in bytes
+ * @return true if the key exists with this type and fits in out
+ */
+bool EARS_nvsEeprom::readString(const char* key, char* out, size_t outBytes) {
+    size_t length = outBytes;
+    return _sessionOpen && nvs_get_str(_session, key, out, &length) == ESP_OK;
+}
+
+/**
+ * @brief Write an unsigned 16 bit value, durable after commitNamespace()
+ * 
+ * @param key Key name
+ * @param value Value to store
+ * @return true if written
+ */
+bool EARS_nvsEeprom::writeU16(const char* key, uint16_t value) {
+    return _sessionOpen && nvs_set_u16(_session, key, value) == ESP_OK;
+}
+
+/**
+ * @brief Write an unsigned 32 bit value, durable after commitNamespace()
+ * 
+ * @param key Key name
+ * @param value Value to store
+ * @return true if written
+ */
+bool EARS_nvsEeprom::writeU32(const char* key, uint32_t value) {
+    return _sessionOpen && nvs_set_u32(_session, key, value) == ESP_OK;
+}
+
+/**
+ * @brief Write a string, durable after commitNamespace()
+ * 
+ * @param key Key name
+ * @param value Null terminated string to store
+ * @return true if written
+ */
+bool EARS_nvsEeprom::writeString(const char* key, const char* value) {
+    return _sessionOpen && nvs_set_str(_session, key, value) == ESP_OK;
+}
+
+/**
+ * @brief Make the writes since the last commit durable
+ * 
+ * @return true if committed
+ */
+bool EARS_nvsEeprom::commitNamespace() {
+    return _sessionOpen && nvs_commit(_session) == ESP_OK;
 }
 
 /**
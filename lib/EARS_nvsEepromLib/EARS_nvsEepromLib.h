@@ -2,9 +2,20 @@
  * @file EARS_nvsEepromLib.h
  * @author Julian (51fiftyone51fiftyone@gmail.com)
  * @brief NVS EEPROM wrapper class header
- * @version 1.5.0
- * @date 20260116
+ * @version 1.7.0
+ * @date 20261016
  * 
+ * @details
+ * NVSStatus, NVSValidationResult and the validation itself live in
+ * EARS_nvsTransaction so they run on the host. The class implements
+ * EARS_nvsPort on the raw nvs_* handle API, which lets one transaction
+ * batch several writes under a single nvs_commit.
+ *
+ * The getters and setters go through an EARS_nvsShadow: reads are RAM
+ * lookups, and changes reach flash in one commit per change set when
+ * poll() or flush() writes them back. The record CRC is included in that
+ * commit whenever a record key changed.
+ *
  * @copyright Copyright (c) 2026 JTB. All rights reserved.
  */
 
@@ -19,65 +30,8 @@
 #include <Arduino.h>
 #include <nvs.h>
 #include <nvs_flash.h>
-
-/******************************************************************************
- * Validation Status Enum
- *****************************************************************************/
-/**
- * @enum NVSStatus
- * @brief Enumeration for NVS validation status.
- *
- * @details
- * This enum defines various status codes for validating the Non-Volatile Storage (NVS). It includes states for not checked, valid, invalid version, missing zap number, missing password, CRC failure, upgraded, and initialization failure. It is used to indicate the result of NVS validation operations.
- */
-enum class NVSStatus : uint8_t {
-    NOT_CHECKED = 0,
-    VALID = 1,
-    INVALID_VERSION = 2,
-    MISSING_ZAPNUMBER = 3,
-    MISSING_PASSWORD = 4,
-    CRC_FAILED = 5,
-    UPGRADED = 6,
-    INITIALIZATION_FAILED = 7
-};
-
-/******************************************************************************
- * Core0/Core1 Communication Struct
- *****************************************************************************/
-/**
- * @struct NVSValidationResult
- * @brief Structure to hold NVS validation results.
- * 
- * @details
- * This struct contains detailed information about the validation status of the NVS, including version info, zap number validity, password hash validity, CRC status, and whether an upgrade was performed. It also holds the calculated CRC32 value and the zap number string. It is used to provide comprehensive feedback after validating the NVS. It is used for communication between Core0 and Core1.
- */
-struct NVSValidationResult {
-    NVSStatus status;           // Overall validation status
-    uint16_t currentVersion;    // Version found in NVS
-    uint16_t expectedVersion;   // Version expected by code
-    bool zapNumberValid;        // ZapNumber (AANNNN) exists and valid
-    bool passwordHashValid;     // Password hash exists
-    bool crcValid;              // Overall CRC32 check passed
-    bool wasUpgraded;           // NVS was upgraded during validation
-    uint32_t calculatedCRC;     // The calculated CRC32 value
-    char zapNumber[7];          // The ZapNumber value (AANNNN format + null)
-    
-    /**
-     * @brief Construct a new NVSValidationResult object
-     * 
-     */
-    NVSValidationResult() : 
-        status(NVSStatus::NOT_CHECKED),
-        currentVersion(0),
-        expectedVersion(0),
-        zapNumberValid(false),
-        passwordHashValid(false),
-        crcValid(false),
-        wasUpgraded(false),
-        calculatedCRC(0) {
-        zapNumber[0] = '\0';
-    }
-};
+#include "EARS_nvsTransaction.h"
+#include "EARS_nvsShadow.h"
 
 /**
  * @brief NVS EEPROM wrapper class.
@@ -87,8 +41,19 @@ struct NVSValidationResult {
  * 
  * CORRECTED: Class name is now EARS_nvsEeprom (without Lib suffix)
  * This matches the naming convention standard
+ *
+ * Getters read the RAM shadow, setters change it and poll() writes
+ * the changes back. Writes through an EARS_nvsTransaction on this object
+ * bypass the shadow; call shadow().invalidate() after them.
+ *
+ * The shadow holds up to EARS_nvsShadow::MAX_KEYS keys, names shorter than
+ * EARS_nvsShadow::KEY_BYTES and strings shorter than
+ * EARS_nvsTransaction::MAX_STRING. getHash(), putHash(), getVersion() and
+ * putVersion() read and write anything else directly, committed at once,
+ * as they did before the shadow. A missing string key is also looked up
+ * directly, since it may only be too long to shadow.
  */
-class EARS_nvsEeprom : public Preferences {
+class EARS_nvsEeprom : public Preferences, public EARS_nvsPort {
 public:
     // NVS Version - increment when NVS structure changes
     static const uint16_t CURRENT_VERSION = 1;
@@ -130,13 +95,42 @@ public:
     String getZapNumber();
     bool setZapNumber(const String& zapNumber);
 
+    // Deferred write-back - call poll() once per UI tick, flush() before a restart
+    bool poll(uint32_t nowMs);
+    bool flush();
+
+    // RAM shadow, for per-key write counters and other diagnostics
+    EARS_nvsShadow& shadow() { return _shadow; }
+
+    // EARS_nvsPort, used by EARS_nvsTransaction
+    bool openNamespace(const char* name, bool readOnly) override;
+    bool namespaceMissing() const override { return _sessionMissing; }
+    void closeNamespace() override;
+    bool readU16(const char* key, uint16_t& value) override;
+    bool readU32(const char* key, uint32_t& value) override;
+    bool readString(const char* key, char* out, size_t outBytes) override;
+    bool writeU16(const char* key, uint16_t value) override;
+    bool writeU32(const char* key, uint32_t value) override;
+    bool writeString(const char* key, const char* value) override;
+    bool commitNamespace() override;
+
 private:
     // NVS Namespace
     static const char* NAMESPACE;
     uint32_t calculateCRC32(const uint8_t* data, size_t length);
+
+    // Handle of the open transaction
+    nvs_handle_t _session;
+    bool _sessionOpen;
+    bool _sessionMissing;
+
+    // RAM copy of the namespace
+    EARS_nvsShadow _shadow;
     
     // Internal upgrade function
-    bool upgradeNVS(uint16_t fromVersion, uint16_t toVersion);
+    bool upgradeNVS(EARS_nvsTransaction& transaction, uint16_t fromVersion, uint16_t toVersion);
+    static bool upgradeStep(EARS_nvsTransaction& transaction, uint16_t fromVersion,
+                            uint16_t toVersion, void* context);
 };
 
 #endif // __EARS_NVSEEPROM_LIB_H__
@@ -0,0 +1,189 @@
+/**
+ * @file EARS_memNvs.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief In-memory EARS_nvsPort for host tests and benchmarks
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_memNvs.h"
+#include <string.h>
+
+/**
+ * @brief Construct an empty NVS with nothing open
+ */
+EARS_memNvs::EARS_memNvs() : _current(nullptr), _readOnly(true), _missing(false) {
+}
+
+/**
+ * @brief Open a namespace, one may be open at a time
+ * @param name Namespace name
+ * @param readOnly true to open read only
+ * @return true if opened; read only fails if the namespace does not exist
+ */
+bool EARS_memNvs::openNamespace(const char* name, bool readOnly) {
+    _missing = false;
+    if (_current != nullptr || name == nullptr) {
+        return false;
+    }
+    std::map<std::string, Space>::iterator it = _spaces.find(name);
+    if (it == _spaces.end()) {
+        if (readOnly) {
+            _missing = true;
+            return false;
+        }
+        it = _spaces.insert(std::make_pair(std::string(name), Space())).first;
+    }
+    _current = &it->second;
+    _readOnly = readOnly;
+    _stats.opens++;
+    return true;
+}
+
+/**
+ * @brief Close the open namespace
+ * @return void
+ */
+void EARS_memNvs::closeNamespace() {
+    _current = nullptr;
+}
+
+/**
+ * @brief Find a key of the given type in the open namespace
+ * @param key Key name
+ * @param type Expected type
+ * @return const Entry* entry, nullptr if missing or of another type
+ */
+const EARS_memNvs::Entry* EARS_memNvs::find(const char* key, Type type) {
+    _stats.reads++;
+    if (_current == nullptr) {
+        return nullptr;
+    }
+    Space::const_iterator it = _current->find(key);
+    if (it == _current->end() || it->second.type != type) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+/**
+ * @brief Store a key in the open namespace
+ * @param key Key name
+ * @param entry Value and type
+ * @return true if the namespace is open read-write
+ */
+bool EARS_memNvs::store(const char* key, const Entry& entry) {
+    if (_current == nullptr || _readOnly) {
+        return false;
+    }
+    (*_current)[key] = entry;
+    _stats.writes++;
+    return true;
+}
+
+/**
+ * @brief Read an unsigned 16 bit value
+ * @param key Key name
+ * @param value Receives the value
+ * @return true if the key exists with this type
+ */
+bool EARS_memNvs::readU16(const char* key, uint16_t& value) {
+    const Entry* entry = find(key, Type::U16);
+    if (entry == nullptr) {
+        return false;
+    }
+    value = (uint16_t)entry->number;
+    return true;
+}
+
+/**
+ * @brief Read an unsigned 32 bit value
+ * @param key Key name
+ * @param value Receives the value
+ * @return true if the key exists with this type
+ */
+bool EARS_memNvs::readU32(const char* key, uint32_t& value) {
+    const Entry* entry = find(key, Type::U32);
+    if (entry == nullptr) {
+        return false;
+    }
+    value = entry->number;
+    return true;
+}
+
+/**
+ * @brief Read a string
+ * @param key Key name
+ * @param out Receives the string, null terminated
+ * @param outBytes Size of out in bytes
+ * @return true if the key exists with this type and fits in out
+ */
+bool EARS_memNvs::readString(const char* key, char* out, size_t outBytes) {
+    const Entry* entry = find(key, Type::STRING);
+    if (entry == nullptr || entry->text.size() >= outBytes) {
+        return false;
+    }
+    memcpy(out, entry->text.c_str(), entry->text.size() + 1);
+    return true;
+}
+
+/**
+ * @brief Write an unsigned 16 bit value
+ * @param key Key name
+ * @param value Value to store
+ * @return true if written
+ */
+bool EARS_memNvs::writeU16(const char* key, uint16_t value) {
+    Entry entry;
+    entry.type = Type::U16;
+    entry.number = value;
+    return store(key, entry);
+}
+
+/**
+ * @brief Write an unsigned 32 bit value
+ * @param key Key name
+ * @param value Value to store
+ * @return true if written
+ */
+bool EARS_memNvs::writeU32(const char* key, uint32_t value) {
+    Entry entry;
+    entry.type = Type::U32;
+    entry.number = value;
+    return store(key, entry);
+}
+
+/**
+ * @brief Write a string
+ * @param key Key name
+ * @param value Null terminated string to store
+ * @return true if written
+ */
+bool EARS_memNvs::writeString(const char* key, const char* value) {
+    Entry entry;
+    entry.type = Type::STRING;
+    entry.number = 0;
+    entry.text = value;
+    return store(key, entry);
+}
+
+/**
+ * @brief Make the writes since the last commit durable
+ * @return true if a namespace is open read-write
+ */
+bool EARS_memNvs::commitNamespace() {
+    if (_current == nullptr || _readOnly) {
+        return false;
+    }
+    _stats.commits++;
+    return true;
+}
+
+/******************************************************************************
+ * End of EARS_memNvs.cpp
+ ******************************************************************************/
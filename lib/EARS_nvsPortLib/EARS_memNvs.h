@@ -0,0 +1,106 @@
+/**
+ * @file EARS_memNvs.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief In-memory EARS_nvsPort for host tests and benchmarks
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @details
+ * Namespaces and typed entries live in std::maps. Like ESP-IDF NVS, a read
+ * only open of a missing namespace fails, a read of a key stored with
+ * another type finds nothing and writes are visible to the session at
+ * once. Every operation is counted so tests can compare how often an
+ * algorithm opens and commits.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_MEM_NVS_H__
+#define __EARS_MEM_NVS_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_nvsPortLib.h"
+#include <map>
+#include <string>
+
+/**
+ * @brief Operation counters
+ */
+struct MemNvsStats {
+    uint32_t opens;     // Successful openNamespace calls
+    uint32_t commits;   // Successful commitNamespace calls
+    uint32_t reads;     // read* calls
+    uint32_t writes;    // Successful write* calls
+
+    MemNvsStats() : opens(0), commits(0), reads(0), writes(0) {}
+};
+
+/**
+ * @brief In-memory NVS
+ */
+class EARS_memNvs : public EARS_nvsPort {
+public:
+    EARS_memNvs();
+
+    bool openNamespace(const char* name, bool readOnly) override;
+    bool namespaceMissing() const override { return _missing; }
+    void closeNamespace() override;
+    bool readU16(const char* key, uint16_t& value) override;
+    bool readU32(const char* key, uint32_t& value) override;
+    bool readString(const char* key, char* out, size_t outBytes) override;
+    bool writeU16(const char* key, uint16_t value) override;
+    bool writeU32(const char* key, uint32_t value) override;
+    bool writeString(const char* key, const char* value) override;
+    bool commitNamespace() override;
+
+    /**
+     * @brief Check a namespace is open
+     * @return true between a successful openNamespace() and closeNamespace()
+     */
+    bool isOpen() const { return _current != nullptr; }
+
+    MemNvsStats getStats() const { return _stats; }
+    void resetStats() { _stats = MemNvsStats(); }
+
+private:
+    enum class Type : uint8_t { U16, U32, STRING };
+
+    struct Entry {
+        Type type;
+        uint32_t number;
+        std::string text;
+    };
+
+    typedef std::map<std::string, Entry> Space;
+
+    std::map<std::string, Space> _spaces;
+    Space* _current;
+    bool _readOnly;
+    bool _missing;      // Last failed open found no namespace
+    MemNvsStats _stats;
+
+    /**
+     * @brief Find a key of the given type in the open namespace
+     * @param key Key name
+     * @param type Expected type
+     * @return const Entry* entry, nullptr if missing or of another type
+     */
+    const Entry* find(const char* key, Type type);
+
+    /**
+     * @brief Store a key in the open namespace
+     * @param key Key name
+     * @param entry Value and type
+     * @return true if the namespace is open read-write
+     */
+    bool store(const char* key, const Entry& entry);
+};
+
+#endif // __EARS_MEM_NVS_H__
+
+/****************************************************************************
+ * End of EARS_memNvs.h
+ ***************************************************************************/
@@ -0,0 +1,122 @@
+/**
+ * @file EARS_nvsPortLib.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Minimal NVS interface shared by the NVS EEPROM class and host stand-ins
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @details
+ * EARS_nvsPort is one open namespace at a time, with typed reads and
+ * writes and an explicit commit, the way the ESP-IDF nvs_* handle API
+ * works. Writes are not durable until commitNamespace() so several of
+ * them can share one commit. EARS_nvsEeprom implements it on flash;
+ * EARS_memNvs implements it in memory for host tests.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_NVS_PORT_LIB_H__
+#define __EARS_NVS_PORT_LIB_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+// Namespace and keys of the EARS NVS record
+#define EARS_NVS_NAMESPACE "EARS"
+#define EARS_NVS_KEY_VERSION "nvsVersion"
+#define EARS_NVS_KEY_ZAPNUMBER "zapNumber"
+#define EARS_NVS_KEY_PASSWORD_HASH "pwdHash"
+#define EARS_NVS_KEY_CRC "nvsCRC"
+
+/**
+ * @brief NVS operations used by portable algorithms
+ */
+class EARS_nvsPort {
+public:
+    virtual ~EARS_nvsPort() {}
+
+    /**
+     * @brief Open a namespace, one may be open at a time
+     * @param name Namespace name
+     * @param readOnly true to open read only
+     * @return true if opened; read only fails if the namespace does not exist
+     */
+    virtual bool openNamespace(const char* name, bool readOnly) = 0;
+
+    /**
+     * @brief Tell a namespace that does not exist yet from a failed open
+     * @return true if the last failed openNamespace() found no such namespace
+     */
+    virtual bool namespaceMissing() const = 0;
+
+    /**
+     * @brief Close the open namespace, uncommitted writes may be lost
+     * @return void
+     */
+    virtual void closeNamespace() = 0;
+
+    /**
+     * @brief Read an unsigned 16 bit value
+     * @param key Key name
+     * @param value Receives the value
+     * @return true if the key exists with this type
+     */
+    virtual bool readU16(const char* key, uint16_t& value) = 0;
+
+    /**
+     * @brief Read an unsigned 32 bit value
+     * @param key Key name
+     * @param value Receives the value
+     * @return true if the key exists with this type
+     */
+    virtual bool readU32(const char* key, uint32_t& value) = 0;
+
+    /**
+     * @brief Read a string
+     * @param key Key name
+     * @param out Receives the string, null terminated
+     * @param outBytes Size of out in bytes
+     * @return true if the key exists with this type and fits in out
+     */
+    virtual bool readString(const char* key, char* out, size_t outBytes) = 0;
+
+    /**
+     * @brief Write an unsigned 16 bit value
+     * @param key Key name
+     * @param value Value to store
+     * @return true if written
+     */
+    virtual bool writeU16(const char* key, uint16_t value) = 0;
+
+    /**
+     * @brief Write an unsigned 32 bit value
+     * @param key Key name
+     * @param value Value to store
+     * @return true if written
+     */
+    virtual bool writeU32(const char* key, uint32_t value) = 0;
+
+    /**
+     * @brief Write a string
+     * @param key Key name
+     * @param value Null terminated string to store
+     * @return true if written
+     */
+    virtual bool writeString(const char* key, const char* value) = 0;
+
+    /**
+     * @brief Make the writes since the last commit durable
+     * @return true if committed
+     */
+    virtual bool commitNamespace() = 0;
+};
+
+#endif // __EARS_NVS_PORT_LIB_H__
+
+/****************************************************************************
+ * End of EARS_nvsPortLib.h
+ ***************************************************************************/
@@ -0,0 +1,517 @@
+/**
+ * @file EARS_nvsShadow.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Write-back RAM shadow of an NVS namespace with wear accounting
+ * @version 1.0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_nvsShadow.h"
+#include <string.h>
+
+/**
+ * @brief Shadow a namespace, tracking the EARS record keys
+ * @param port NVS to use
+ * @param name Namespace name
+ */
+EARS_nvsShadow::EARS_nvsShadow(EARS_nvsPort& port, const char* name) :
+    _port(port),
+    _name(name),
+    _count(0),
+    _loaded(false),
+    _pending(false),
+    _crcStale(false),
+    _firstChangeMs(0),
+    _lastChangeMs(0) {
+    track(EARS_NVS_KEY_VERSION, NvsValueType::U16);
+    track(EARS_NVS_KEY_ZAPNUMBER, NvsValueType::STRING);
+    track(EARS_NVS_KEY_PASSWORD_HASH, NvsValueType::STRING);
+    track(EARS_NVS_KEY_CRC, NvsValueType::U32);
+}
+
+/**
+ * @brief Read every tracked key that has no pending change
+ * @return true if read; a namespace that does not exist yet loads as empty
+ */
+bool EARS_nvsShadow::load() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _loaded = read(0);
+    return _loaded;
+}
+
+/**
+ * @brief Reread keys without pending changes on the next access
+ * @return void
+ */
+void EARS_nvsShadow::invalidate() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _loaded = false;
+}
+
+/**
+ * @brief Read an unsigned 16 bit value
+ * @param key Key name
+ * @param defaultValue Returned if the key is missing or of another type
+ * @return uint16_t value or defaultValue
+ */
+uint16_t EARS_nvsShadow::getU16(const char* key, uint16_t defaultValue) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.lookups++;
+    Entry* entry = lookup(key, NvsValueType::U16);
+    return (entry != nullptr && entry->exists) ? (uint16_t)entry->number : defaultValue;
+}
+
+/**
+ * @brief Read an unsigned 32 bit value
+ * @param key Key name
+ * @param defaultValue Returned if the key is missing or of another type
+ * @return uint32_t value or defaultValue
+ */
+uint32_t EARS_nvsShadow::getU32(const char* key, uint32_t defaultValue) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.lookups++;
+    Entry* entry = lookup(key, NvsValueType::U32);
+    return (entry != nullptr && entry->exists) ? entry->number : defaultValue;
+}
+
+/**
+ * @brief Read a string
+ * @param key Key name
+ * @param out Receives the string, "" if missing, cut to fit
+ * @param outBytes Size of out in bytes
+ * @return size_t string length, 0 if missing
+ */
+size_t EARS_nvsShadow::getString(const char* key, char* out, size_t outBytes) {
+    if (outBytes == 0) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.lookups++;
+    Entry* entry = lookup(key, NvsValueType::STRING);
+    out[0] = '\0';
+    if (entry == nullptr || !entry->exists) {
+        return 0;
+    }
+    size_t length = strlen(entry->text);
+    if (length >= outBytes) {
+        length = outBytes - 1;
+    }
+    memcpy(out, entry->text, length);
+    out[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief Change an unsigned 16 bit value
+ * @param key Key name
+ * @param value New value
+ * @param nowMs Current time in milliseconds
+ * @return true if stored in RAM; false if the key has another type or no slot is free
+ */
+bool EARS_nvsShadow::putU16(const char* key, uint16_t value, uint32_t nowMs) {
+    return putNumber(key, NvsValueType::U16, value, nowMs);
+}
+
+/**
+ * @brief Change an unsigned 32 bit value
+ * @param key Key name
+ * @param value New value
+ * @param nowMs Current time in milliseconds
+ * @return true if stored in RAM; false if the key has another type or no slot is free
+ */
+bool EARS_nvsShadow::putU32(const char* key, uint32_t value, uint32_t nowMs) {
+    return putNumber(key, NvsValueType::U32, value, nowMs);
+}
+
+/**
+ * @brief Change a string
+ * @param key Key name
+ * @param value New value, shorter than EARS_nvsTransaction::MAX_STRING
+ * @param nowMs Current time in milliseconds
+ * @return true if stored in RAM; false if too long, of another type or no slot is free
+ */
+bool EARS_nvsShadow::putString(const char* key, const char* value, uint32_t nowMs) {
+    if (value == nullptr || strlen(value) >= EARS_nvsTransaction::MAX_STRING) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry* entry = lookup(key, NvsValueType::STRING);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (entry->exists && strcmp(entry->text, value) == 0) {
+        entry->skipped++;
+        _stats.skipped++;
+        return true;
+    }
+    strcpy(entry->text, value);
+    markDirty(*entry, nowMs);
+    return true;
+}
+
+/**
+ * @brief Change a numeric value, lock not held
+ * @param key Key name
+ * @param type U16 or U32
+ * @param value New value
+ * @param nowMs Current time in milliseconds
+ * @return true if stored in RAM
+ */
+bool EARS_nvsShadow::putNumber(const char* key, NvsValueType type, uint32_t value, uint32_t nowMs) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry* entry = lookup(key, type);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (entry->exists && entry->number == value) {
+        entry->skipped++;
+        _stats.skipped++;
+        return true;
+    }
+    entry->number = value;
+    markDirty(*entry, nowMs);
+    return true;
+}
+
+/**
+ * @brief Record CRC of the values in RAM
+ * @return uint32_t CRC32 of "version|zap|pwdHash"
+ */
+uint32_t EARS_nvsShadow::calculateCRC() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_loaded) {
+        _loaded = read(0);
+    }
+    return crcLocked();
+}
+
+/**
+ * @brief Recalculate the record CRC and write back now
+ * @return true if flash holds every change and a matching CRC
+ */
+bool EARS_nvsShadow::updateCRC() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_loaded) {
+        _loaded = read(0);
+    }
+    _crcStale = true;
+    return commitLocked();
+}
+
+/**
+ * @brief Check for changes not yet written
+ * @return true if a key is dirty
+ */
+bool EARS_nvsShadow::isDirty() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending;
+}
+
+/**
+ * @brief Write back if changes are due, call once per UI tick
+ * @param nowMs Current time in milliseconds
+ * @return true if nothing is left to write
+ */
+bool EARS_nvsShadow::poll(uint32_t nowMs) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_pending) {
+        return true;
+    }
+    if (nowMs - _lastChangeMs < DEBOUNCE_MS && nowMs - _firstChangeMs < MAX_DELAY_MS) {
+        return false;
+    }
+    if (commitLocked()) {
+        return true;
+    }
+    // Try again once DEBOUNCE_MS has passed
+    _firstChangeMs = nowMs;
+    _lastChangeMs = nowMs;
+    return false;
+}
+
+/**
+ * @brief Write back any changes now
+ * @return true if flash holds every change
+ */
+bool EARS_nvsShadow::flush() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return commitLocked();
+}
+
+/**
+ * @brief Get the shadow counters
+ * @return NvsShadowStats counts
+ */
+NvsShadowStats EARS_nvsShadow::getStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+/**
+ * @brief Get the wear counters of every tracked key
+ * @param out Receives up to count entries
+ * @param count Size of out
+ * @return size_t number of tracked keys
+ */
+size_t EARS_nvsShadow::keyStats(NvsKeyStats* out, size_t count) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (size_t i = 0; i < _count && i < count; i++) {
+        out[i].key = _entries[i].key;
+        out[i].writes = _entries[i].writes;
+        out[i].skipped = _entries[i].skipped;
+    }
+    return _count;
+}
+
+/**
+ * @brief Check a key can be shadowed
+ * @param key Key name
+ * @param type Type it is stored with
+ * @return true if tracked with this type, or untracked with a free slot and a short enough name
+ */
+bool EARS_nvsShadow::accepts(const char* key, NvsValueType type) {
+    if (key == nullptr) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (size_t i = 0; i < _count; i++) {
+        if (strcmp(_entries[i].key, key) == 0) {
+            return _entries[i].type == type;
+        }
+    }
+    return _count < MAX_KEYS && strlen(key) < KEY_BYTES;
+}
+
+/**
+ * @brief Flash writes of one key since boot
+ * @param key Key name
+ * @return uint32_t writes, 0 if the key is not tracked
+ */
+uint32_t EARS_nvsShadow::writeCount(const char* key) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (size_t i = 0; i < _count; i++) {
+        if (strcmp(_entries[i].key, key) == 0) {
+            return _entries[i].writes;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Start tracking a key, value not read yet
+ * @param key Key name
+ * @param type Stored type
+ * @return Entry* new slot, nullptr if full or the name is too long
+ */
+EARS_nvsShadow::Entry* EARS_nvsShadow::track(const char* key, NvsValueType type) {
+    if (_count == MAX_KEYS || key == nullptr || strlen(key) >= KEY_BYTES) {
+        return nullptr;
+    }
+    Entry& entry = _entries[_count++];
+    strcpy(entry.key, key);
+    entry.type = type;
+    entry.known = false;
+    entry.exists = false;
+    entry.dirty = false;
+    entry.number = 0;
+    entry.text[0] = '\0';
+    entry.writes = 0;
+    entry.skipped = 0;
+    return &entry;
+}
+
+/**
+ * @brief Find a key, tracking and reading it if new
+ * @param key Key name
+ * @param type Expected type
+ * @return Entry* slot, nullptr if of another type or untrackable
+ */
+EARS_nvsShadow::Entry* EARS_nvsShadow::lookup(const char* key, NvsValueType type) {
+    Entry* entry = nullptr;
+    for (size_t i = 0; i < _count && entry == nullptr; i++) {
+        if (strcmp(_entries[i].key, key) == 0) {
+            entry = &_entries[i];
+        }
+    }
+    if (entry == nullptr) {
+        entry = track(key, type);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+    }
+    if (!_loaded) {
+        _loaded = read(0);
+    } else if (!entry->known && !entry->dirty) {
+        // Loaded already: read just this key
+        read(entry - _entries);
+    }
+    return entry->type == type ? entry : nullptr;
+}
+
+/**
+ * @brief Read keys without pending changes in one read only session
+ * @param first First slot to read
+ * @return true if read; a missing namespace reads as empty
+ * @return false if the session could not be opened, nothing changed
+ */
+bool EARS_nvsShadow::read(size_t first) {
+    bool open = _port.openNamespace(_name, true);
+    if (!open && !_port.namespaceMissing()) {
+        // Busy or failing: keep what was read before
+        return false;
+    }
+    if (open) {
+        _stats.loads++;
+    }
+    for (size_t i = first; i < _count; i++) {
+        Entry& entry = _entries[i];
+        if (entry.dirty) {
+            continue;
+        }
+        entry.known = true;
+        entry.number = 0;
+        entry.text[0] = '\0';
+        if (!open) {
+            entry.exists = false;
+            continue;
+        }
+        switch (entry.type) {
+            case NvsValueType::U16: {
+                uint16_t value = 0;
+                entry.exists = _port.readU16(entry.key, value);
+                entry.number = value;
+                break;
+            }
+            case NvsValueType::U32:
+                entry.exists = _port.readU32(entry.key, entry.number);
+                break;
+            case NvsValueType::STRING:
+                entry.exists = _port.readString(entry.key, entry.text, sizeof(entry.text));
+                if (!entry.exists) {
+                    entry.text[0] = '\0';
+                }
+                break;
+        }
+        if (!entry.exists) {
+            entry.number = 0;
+        }
+    }
+    if (open) {
+        _port.closeNamespace();
+    }
+    return true;
+}
+
+/**
+ * @brief Record a change for write-back
+ * @param entry Changed slot
+ * @param nowMs Current time in milliseconds
+ * @return void
+ */
+void EARS_nvsShadow::markDirty(Entry& entry, uint32_t nowMs) {
+    if (!_pending) {
+        _firstChangeMs = nowMs;
+    }
+    _pending = true;
+    _lastChangeMs = nowMs;
+    entry.known = true;
+    entry.exists = true;
+    entry.dirty = true;
+    if (&entry - _entries < (ptrdiff_t)CRC_SLOT) {
+        _crcStale = true;
+    }
+    _stats.changes++;
+}
+
+/**
+ * @brief Write dirty keys in one session with one commit, lock held
+ * @return true if flash holds every change
+ */
+bool EARS_nvsShadow::commitLocked() {
+    if (_crcStale) {
+        // Never a CRC over record keys that were not read
+        for (size_t i = 0; i <= CRC_SLOT; i++) {
+            if (!_entries[i].known) {
+                if (!read(0)) {
+                    _stats.commitFailures++;
+                    return false;
+                }
+                _loaded = true;
+                break;
+            }
+        }
+        // The CRC only goes out if the record it covers really changed
+        uint32_t crc = crcLocked();
+        Entry& entry = _entries[CRC_SLOT];
+        if (!entry.exists || entry.number != crc) {
+            entry.number = crc;
+            entry.exists = true;
+            entry.dirty = true;
+            _pending = true;
+        }
+        _crcStale = false;
+    }
+    if (!_pending) {
+        return true;
+    }
+
+    if (!_port.openNamespace(_name, false)) {
+        _stats.commitFailures++;
+        return false;
+    }
+    bool written = true;
+    for (size_t i = 0; i < _count && written; i++) {
+        const Entry& entry = _entries[i];
+        if (!entry.dirty) {
+            continue;
+        }
+        switch (entry.type) {
+            case NvsValueType::U16:
+                written = _port.writeU16(entry.key, (uint16_t)entry.number);
+                break;
+            case NvsValueType::U32:
+                written = _port.writeU32(entry.key, entry.number);
+                break;
+            case NvsValueType::STRING:
+                written = _port.writeString(entry.key, entry.text);
+                break;
+        }
+    }
+    written = written && _port.commitNamespace();
+    _port.closeNamespace();
+    if (!written) {
+        _stats.commitFailures++;
+        return false;
+    }
+
+    for (size_t i = 0; i < _count; i++) {
+        Entry& entry = _entries[i];
+        if (entry.dirty) {
+            entry.dirty = false;
+            entry.writes++;
+            _stats.flashWrites++;
+        }
+    }
+    _pending = false;
+    _stats.commits++;
+    return true;
+}
+
+/**
+ * @brief Record CRC of the values in RAM, lock held
+ * @return uint32_t record CRC
+ */
+uint32_t EARS_nvsShadow::crcLocked() const {
+    return EARS_nvsRecordCRC((uint16_t)_entries[VERSION_SLOT].number,
+                             _entries[ZAPNUMBER_SLOT].text,
+                             _entries[PASSWORD_HASH_SLOT].text);
+}
+
+/******************************************************************************
+ * End of EARS_nvsShadow.cpp
+ ******************************************************************************/
@@ -0,0 +1,319 @@
+/**
+ * @file EARS_nvsShadow.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Write-back RAM shadow of an NVS namespace with wear accounting
+ * @version 1.0.1
+ * @date 20261016
+ *
+ * @details
+ * The shadow reads the EARS record keys (and any other key on its first
+ * use) into RAM once, so reads are memory lookups. A put that changes a
+ * value only marks its key dirty; one that matches the stored value is
+ * skipped. poll() writes the dirty keys back once changes have stopped
+ * for DEBOUNCE_MS (or MAX_DELAY_MS after the first one) in one session
+ * with one commit. If a record key changed, the record CRC is
+ * recalculated in RAM and goes out in the same commit, and only if its
+ * value changed.
+ *
+ * Every flash write is counted per key, so diagnostics can show which
+ * keys wear the flash.
+ *
+ * Changes not yet written are lost on a power cut; call flush() before a
+ * planned restart. Writes made around the shadow, through an
+ * EARS_nvsTransaction for example, need invalidate() afterwards.
+ *
+ * Thread safe. The shadow opens its own sessions on the port. If one
+ * cannot be opened (a transaction holds the port, or nvs_open fails),
+ * nothing is marked loaded. Getters return the last values read, or the
+ * default before the first read, and try again on the next call. A
+ * commit that would need a CRC over values never read fails and is
+ * retried.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_NVS_SHADOW_H__
+#define __EARS_NVS_SHADOW_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <mutex>
+#include "EARS_nvsPortLib.h"
+#include "EARS_nvsTransaction.h"
+
+/**
+ * @brief Type a key is stored with
+ */
+enum class NvsValueType : uint8_t {
+    U16,
+    U32,
+    STRING
+};
+
+/**
+ * @brief Wear counters of one key
+ */
+struct NvsKeyStats {
+    const char* key;    // Key name, valid for the life of the shadow
+    uint32_t writes;    // Flash writes since boot
+    uint32_t skipped;   // Puts that matched the stored value
+};
+
+/**
+ * @brief Shadow counters
+ */
+struct NvsShadowStats {
+    uint32_t loads;             // Sessions that read keys into RAM
+    uint32_t lookups;           // Gets served from RAM
+    uint32_t changes;           // Puts that changed a value
+    uint32_t skipped;           // Puts that matched the stored value
+    uint32_t commits;           // Sessions that wrote dirty keys back
+    uint32_t flashWrites;       // Keys written, record CRC included
+    uint32_t commitFailures;    // Write-backs that failed (retried after DEBOUNCE_MS)
+
+    NvsShadowStats()
+        : loads(0), lookups(0), changes(0), skipped(0), commits(0), flashWrites(0), commitFailures(0) {}
+};
+
+/**
+ * @brief Owns the RAM copy of a namespace and writes it back
+ */
+class EARS_nvsShadow {
+public:
+    // Keys tracked, the four record keys included
+    static const size_t MAX_KEYS = 8;
+    // NVS key names are at most 15 characters
+    static const size_t KEY_BYTES = 16;
+    // Quiet time after the last change before writing back
+    static const uint32_t DEBOUNCE_MS = 1000;
+    // Longest a change waits while further changes keep coming
+    static const uint32_t MAX_DELAY_MS = 5000;
+
+    /**
+     * @brief Shadow a namespace, tracking the EARS record keys
+     * @param port NVS to use
+     * @param name Namespace name
+     */
+    EARS_nvsShadow(EARS_nvsPort& port, const char* name = EARS_NVS_NAMESPACE);
+
+    /**
+     * @brief Read every tracked key that has no pending change
+     * @return true if read; a namespace that does not exist yet loads as empty
+     *
+     * Called on first access, so calling it is only needed to pick the moment.
+     */
+    bool load();
+
+    /**
+     * @brief Reread keys without pending changes on the next access
+     * @return void
+     */
+    void invalidate();
+
+    /**
+     * @brief Read an unsigned 16 bit value
+     * @param key Key name
+     * @param defaultValue Returned if the key is missing or of another type
+     * @return uint16_t value or defaultValue
+     */
+    uint16_t getU16(const char* key, uint16_t defaultValue = 0);
+
+    /**
+     * @brief Read an unsigned 32 bit value
+     * @param key Key name
+     * @param defaultValue Returned if the key is missing or of another type
+     * @return uint32_t value or defaultValue
+     */
+    uint32_t getU32(const char* key, uint32_t defaultValue = 0);
+
+    /**
+     * @brief Read a string
+     * @param key Key name
+     * @param out Receives the string, "" if missing, cut to fit
+     * @param outBytes Size of out in bytes
+     * @return size_t string length, 0 if missing
+     */
+    size_t getString(const char* key, char* out, size_t outBytes);
+
+    /**
+     * @brief Change an unsigned 16 bit value
+     * @param key Key name
+     * @param value New value
+     * @param nowMs Current time in milliseconds
+     * @return true if stored in RAM; false if the key has another type or no slot is free
+     */
+    bool putU16(const char* key, uint16_t value, uint32_t nowMs);
+
+    /**
+     * @brief Change an unsigned 32 bit value
+     * @param key Key name
+     * @param value New value
+     * @param nowMs Current time in milliseconds
+     * @return true if stored in RAM; false if the key has another type or no slot is free
+     */
+    bool putU32(const char* key, uint32_t value, uint32_t nowMs);
+
+    /**
+     * @brief Change a string
+     * @param key Key name
+     * @param value New value, shorter than EARS_nvsTransaction::MAX_STRING
+     * @param nowMs Current time in milliseconds
+     * @return true if stored in RAM; false if too long, of another type or no slot is free
+     */
+    bool putString(const char* key, const char* value, uint32_t nowMs);
+
+    /**
+     * @brief Record CRC of the values in RAM
+     * @return uint32_t CRC32 of "version|zap|pwdHash"
+     */
+    uint32_t calculateCRC();
+
+    /**
+     * @brief Recalculate the record CRC and write back now
+     * @return true if flash holds every change and a matching CRC
+     */
+    bool updateCRC();
+
+    /**
+     * @brief Check for changes not yet written
+     * @return true if a key is dirty
+     */
+    bool isDirty();
+
+    /**
+     * @brief Write back if changes are due, call once per UI tick
+     * @param nowMs Current time in milliseconds
+     * @return true if nothing is left to write
+     */
+    bool poll(uint32_t nowMs);
+
+    /**
+     * @brief Write back any changes now
+     * @return true if flash holds every change
+     */
+    bool flush();
+
+    /**
+     * @brief Get the shadow counters
+     * @return NvsShadowStats counts
+     */
+    NvsShadowStats getStats();
+
+    /**
+     * @brief Get the wear counters of every tracked key
+     * @param out Receives up to count entries
+     * @param count Size of out
+     * @return size_t number of tracked keys
+     */
+    size_t keyStats(NvsKeyStats* out, size_t count);
+
+    /**
+     * @brief Check a key can be shadowed
+     * @param key Key name
+     * @param type Type it is stored with
+     * @return true if tracked with this type, or untracked with a free slot and a short enough name
+     */
+    bool accepts(const char* key, NvsValueType type);
+
+    /**
+     * @brief Flash writes of one key since boot
+     * @param key Key name
+     * @return uint32_t writes, 0 if the key is not tracked
+     */
+    uint32_t writeCount(const char* key);
+
+private:
+    // Record keys, always tracked in these slots
+    static const size_t VERSION_SLOT = 0;
+    static const size_t ZAPNUMBER_SLOT = 1;
+    static const size_t PASSWORD_HASH_SLOT = 2;
+    static const size_t CRC_SLOT = 3;
+
+    struct Entry {
+        char key[KEY_BYTES];
+        NvsValueType type;
+        bool known;         // Read from NVS or put since
+        bool exists;        // Present in NVS or put since
+        bool dirty;         // Changed in RAM, not yet written
+        uint32_t number;
+        char text[EARS_nvsTransaction::MAX_STRING];
+        uint32_t writes;
+        uint32_t skipped;
+    };
+
+    EARS_nvsPort& _port;
+    const char* _name;
+    std::mutex _mutex;
+    Entry _entries[MAX_KEYS];
+    size_t _count;
+    bool _loaded;
+    bool _pending;          // A key is dirty
+    bool _crcStale;         // A record key changed since the CRC was calculated
+    uint32_t _firstChangeMs;
+    uint32_t _lastChangeMs;
+    NvsShadowStats _stats;
+
+    /**
+     * @brief Start tracking a key, value not read yet
+     * @param key Key name
+     * @param type Stored type
+     * @return Entry* new slot, nullptr if full or the name is too long
+     */
+    Entry* track(const char* key, NvsValueType type);
+
+    /**
+     * @brief Find a key, tracking and reading it if new
+     * @param key Key name
+     * @param type Expected type
+     * @return Entry* slot, nullptr if of another type or untrackable
+     */
+    Entry* lookup(const char* key, NvsValueType type);
+
+    /**
+     * @brief Read keys without pending changes in one read only session
+     * @param first First slot to read
+     * @return true if read; a missing namespace reads as empty
+     * @return false if the session could not be opened, nothing changed
+     */
+    bool read(size_t first);
+
+    /**
+     * @brief Change a numeric value, lock not held
+     * @param key Key name
+     * @param type U16 or U32
+     * @param value New value
+     * @param nowMs Current time in milliseconds
+     * @return true if stored in RAM
+     */
+    bool putNumber(const char* key, NvsValueType type, uint32_t value, uint32_t nowMs);
+
+    /**
+     * @brief Record a change for write-back
+     * @param entry Changed slot
+     * @param nowMs Current time in milliseconds
+     * @return void
+     */
+    void markDirty(Entry& entry, uint32_t nowMs);
+
+    /**
+     * @brief Write dirty keys in one session with one commit, lock held
+     * @return true if flash holds every change
+     */
+    bool commitLocked();
+
+    /**
+     * @brief Record CRC of the values in RAM, lock held
+     * @return uint32_t record CRC
+     */
+    uint32_t crcLocked() const;
+};
+
+#endif // __EARS_NVS_SHADOW_H__
+
+/****************************************************************************
+ * End of EARS_nvsShadow.h
+ ***************************************************************************/
@@ -0,0 +1,328 @@
+/**
+ * @file EARS_nvsTransaction.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Scoped NVS session with a single CRC update on commit
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_nvsTransaction.h"
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+/**
+ * @brief Open the namespace for the lifetime of the transaction
+ * @param port NVS to use
+ * @param readOnly true to open read only, see makeWritable()
+ * @param name Namespace name
+ */
+EARS_nvsTransaction::EARS_nvsTransaction(EARS_nvsPort& port, bool readOnly, const char* name) :
+    _port(port),
+    _name(name),
+    _open(false),
+    _readOnly(readOnly),
+    _pending(false) {
+    _open = _port.openNamespace(_name, _readOnly);
+}
+
+/**
+ * @brief Commit pending writes and close the namespace
+ */
+EARS_nvsTransaction::~EARS_nvsTransaction() {
+    if (!_open) {
+        return;
+    }
+    commit();
+    _port.closeNamespace();
+}
+
+/**
+ * @brief Reopen a read only transaction read-write
+ * @return true if the transaction is now writable
+ */
+bool EARS_nvsTransaction::makeWritable() {
+    if (!_readOnly) {
+        return _open;
+    }
+    if (_open) {
+        _port.closeNamespace();
+    }
+    _open = _port.openNamespace(_name, false);
+    if (_open) {
+        _readOnly = false;
+    }
+    return _open;
+}
+
+/**
+ * @brief Read an unsigned 16 bit value
+ * @param key Key name
+ * @param defaultValue Returned if the key is missing
+ * @return uint16_t stored value or defaultValue
+ */
+uint16_t EARS_nvsTransaction::getU16(const char* key, uint16_t defaultValue) {
+    uint16_t value;
+    if (_open && _port.readU16(key, value)) {
+        return value;
+    }
+    return defaultValue;
+}
+
+/**
+ * @brief Read an unsigned 32 bit value
+ * @param key Key name
+ * @param defaultValue Returned if the key is missing
+ * @return uint32_t stored value or defaultValue
+ */
+uint32_t EARS_nvsTransaction::getU32(const char* key, uint32_t defaultValue) {
+    uint32_t value;
+    if (_open && _port.readU32(key, value)) {
+        return value;
+    }
+    return defaultValue;
+}
+
+/**
+ * @brief Read a string
+ * @param key Key name
+ * @param out Receives the string, "" if missing or too long
+ * @param outBytes Size of out in bytes
+ * @return size_t string length, 0 if missing
+ */
+size_t EARS_nvsTransaction::getString(const char* key, char* out, size_t outBytes) {
+    if (outBytes == 0) {
+        return 0;
+    }
+    if (!_open || !_port.readString(key, out, outBytes)) {
+        out[0] = '\0';
+        return 0;
+    }
+    return strlen(out);
+}
+
+/**
+ * @brief Write an unsigned 16 bit value, durable on commit()
+ * @param key Key name
+ * @param value Value to store
+ * @return true if written
+ */
+bool EARS_nvsTransaction::putU16(const char* key, uint16_t value) {
+    if (!_open || _readOnly || !_port.writeU16(key, value)) {
+        return false;
+    }
+    _pending = true;
+    return true;
+}
+
+/**
+ * @brief Write an unsigned 32 bit value, durable on commit()
+ * @param key Key name
+ * @param value Value to store
+ * @return true if written
+ */
+bool EARS_nvsTransaction::putU32(const char* key, uint32_t value) {
+    if (!_open || _readOnly || !_port.writeU32(key, value)) {
+        return false;
+    }
+    _pending = true;
+    return true;
+}
+
+/**
+ * @brief Write a string, durable on commit()
+ * @param key Key name
+ * @param value Null terminated string to store
+ * @return true if written
+ */
+bool EARS_nvsTransaction::putString(const char* key, const char* value) {
+    if (!_open || _readOnly || !_port.writeString(key, value)) {
+        return false;
+    }
+    _pending = true;
+    return true;
+}
+
+/**
+ * @brief Calculate the record CRC from this session's values
+ * @return uint32_t CRC32 of "version|zap|pwdHash", 0 if not open
+ */
+uint32_t EARS_nvsTransaction::calculateCRC() {
+    if (!_open) {
+        return 0;
+    }
+    char zapNumber[MAX_STRING];
+    char passwordHash[MAX_STRING];
+    getString(EARS_NVS_KEY_ZAPNUMBER, zapNumber, sizeof(zapNumber));
+    getString(EARS_NVS_KEY_PASSWORD_HASH, passwordHash, sizeof(passwordHash));
+    return EARS_nvsRecordCRC(getU16(EARS_NVS_KEY_VERSION, 0), zapNumber, passwordHash);
+}
+
+/**
+ * @brief Store the record CRC and commit, whether or not anything changed
+ * @return true if committed
+ */
+bool EARS_nvsTransaction::updateCRC() {
+    if (!_open || _readOnly) {
+        return false;
+    }
+    if (!_port.writeU32(EARS_NVS_KEY_CRC, calculateCRC()) || !_port.commitNamespace()) {
+        return false;
+    }
+    _pending = false;
+    return true;
+}
+
+/**
+ * @brief Store the record CRC and commit if anything was written
+ * @return true if committed or nothing was pending
+ */
+bool EARS_nvsTransaction::commit() {
+    if (!_pending) {
+        return _open;
+    }
+    return updateCRC();
+}
+
+/**
+ * @brief Validate the EARS record in this session
+ * @param currentVersion Version expected by the code
+ * @param upgrade Migration for older records, nullptr if none is needed
+ * @param context Passed to upgrade
+ * @return NVSValidationResult Structure containing validation results
+ */
+NVSValidationResult EARS_nvsTransaction::validate(uint16_t currentVersion, NVSUpgrade upgrade, void* context) {
+    NVSValidationResult result;
+    result.expectedVersion = currentVersion;
+
+    // Step 1: Check NVS initialization
+    if (!_open) {
+        result.status = NVSStatus::INITIALIZATION_FAILED;
+        return result;
+    }
+
+    // Step 2: Get and check version
+    result.currentVersion = getU16(EARS_NVS_KEY_VERSION, 0);
+
+    if (result.currentVersion < currentVersion) {
+        // Upgrade in this session, the new CRC goes out with the version
+        if (!makeWritable() ||
+            (upgrade != nullptr && !upgrade(*this, result.currentVersion, currentVersion, context)) ||
+            !putU16(EARS_NVS_KEY_VERSION, currentVersion) ||
+            !updateCRC()) {
+            result.status = NVSStatus::INVALID_VERSION;
+            return result;
+        }
+        result.wasUpgraded = true;
+        result.currentVersion = currentVersion;
+    } else if (result.currentVersion > currentVersion) {
+        // Version from future - cannot handle
+        result.status = NVSStatus::INVALID_VERSION;
+        return result;
+    }
+
+    // Step 3: Check ZapNumber
+    char zapNumber[MAX_STRING];
+    getString(EARS_NVS_KEY_ZAPNUMBER, zapNumber, sizeof(zapNumber));
+    if (!EARS_nvsValidZapNumber(zapNumber)) {
+        result.status = NVSStatus::MISSING_ZAPNUMBER;
+        return result;
+    }
+    result.zapNumberValid = true;
+    memcpy(result.zapNumber, zapNumber, sizeof(result.zapNumber));
+
+    // Step 4: Check password hash
+    char passwordHash[MAX_STRING];
+    if (getString(EARS_NVS_KEY_PASSWORD_HASH, passwordHash, sizeof(passwordHash)) == 0) {
+        result.status = NVSStatus::MISSING_PASSWORD;
+        return result;
+    }
+    result.passwordHashValid = true;
+
+    // Step 5: Check overall CRC32 against the values already read
+    uint32_t storedCRC = getU32(EARS_NVS_KEY_CRC, 0);
+    result.calculatedCRC = EARS_nvsRecordCRC(result.currentVersion, zapNumber, passwordHash);
+    if (storedCRC != result.calculatedCRC) {
+        result.status = NVSStatus::CRC_FAILED;
+        return result;
+    }
+    result.crcValid = true;
+
+    // Step 6: All checks passed
+    result.status = result.wasUpgraded ? NVSStatus::UPGRADED : NVSStatus::VALID;
+    return result;
+}
+
+/**
+ * @brief Calculate CRC32 checksum.
+ * @param data Bytes to hash
+ * @param length Number of bytes
+ * @return uint32_t CRC32 (reflected, polynomial 0xEDB88320)
+ */
+uint32_t EARS_nvsCRC32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+
+    return ~crc;
+}
+
+/**
+ * @brief CRC32 of "version|zap|pwdHash", the layout earlier releases stored
+ * @param version Record version
+ * @param zapNumber ZapNumber, "" if missing
+ * @param passwordHash Password hash, "" if missing
+ * @return uint32_t record CRC
+ */
+uint32_t EARS_nvsRecordCRC(uint16_t version, const char* zapNumber, const char* passwordHash) {
+    char data[2 * EARS_nvsTransaction::MAX_STRING + 8];
+    int length = snprintf(data, sizeof(data), "%u|%s|%s", (unsigned)version, zapNumber, passwordHash);
+    if (length < 0) {
+        return 0;
+    }
+    if ((size_t)length >= sizeof(data)) {
+        length = sizeof(data) - 1;
+    }
+    return EARS_nvsCRC32((const uint8_t*)data, (size_t)length);
+}
+
+/**
+ * @brief Validate ZapNumber format (AANNNN)
+ * @param zapNumber String to validate
+ * @return true Valid format
+ * @return false Invalid format
+ */
+bool EARS_nvsValidZapNumber(const char* zapNumber) {
+    // Must be exactly 6 characters
+    if (zapNumber == nullptr || strlen(zapNumber) != 6) {
+        return false;
+    }
+
+    // First two characters must be letters (A-Z)
+    if (!isalpha((unsigned char)zapNumber[0]) || !isalpha((unsigned char)zapNumber[1])) {
+        return false;
+    }
+
+    // Last four characters must be digits (0-9)
+    for (int i = 2; i < 6; i++) {
+        if (!isdigit((unsigned char)zapNumber[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * End of EARS_nvsTransaction.cpp
+ ******************************************************************************/
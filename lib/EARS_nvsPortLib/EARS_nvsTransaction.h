@@ -0,0 +1,267 @@
+/**
+ * @file EARS_nvsTransaction.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Scoped NVS session with a single CRC update on commit
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @details
+ * Opening the EARS namespace once per getter or setter made validateNVS()
+ * open it up to five times and every setter pay for its own CRC update.
+ * EARS_nvsTransaction opens it once for its whole scope, serves every read
+ * from that session and batches writes: commit() recalculates the record
+ * CRC once and makes all of them durable with one commit. A transaction
+ * that goes out of scope with writes pending commits them, so the stored
+ * CRC never falls behind the data.
+ *
+ * The CRC is calculated exactly as before, CRC32 of "version|zap|pwdHash",
+ * so records written by earlier releases still validate.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_NVS_TRANSACTION_H__
+#define __EARS_NVS_TRANSACTION_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_nvsPortLib.h"
+
+/******************************************************************************
+ * Validation Status Enum
+ *****************************************************************************/
+/**
+ * @enum NVSStatus
+ * @brief Enumeration for NVS validation status.
+ *
+ * @details
+ * This enum defines various status codes for validating the Non-Volatile Storage (NVS). It includes states for not checked, valid, invalid version, missing zap number, missing password, CRC failure, upgraded, and initialization failure. It is used to indicate the result of NVS validation operations.
+ */
+enum class NVSStatus : uint8_t {
+    NOT_CHECKED = 0,
+    VALID = 1,
+    INVALID_VERSION = 2,
+    MISSING_ZAPNUMBER = 3,
+    MISSING_PASSWORD = 4,
+    CRC_FAILED = 5,
+    UPGRADED = 6,
+    INITIALIZATION_FAILED = 7
+};
+
+/******************************************************************************
+ * Core0/Core1 Communication Struct
+ *****************************************************************************/
+/**
+ * @struct NVSValidationResult
+ * @brief Structure to hold NVS validation results.
+ * 
+ * @details
+ * This struct contains detailed information about the validation status of the NVS, including version info, zap number validity, password hash validity, CRC status, and whether an upgrade was performed. It also holds the calculated CRC32 value and the zap number string. It is used to provide comprehensive feedback after validating the NVS. It is used for communication between Core0 and Core1.
+ */
+struct NVSValidationResult {
+    NVSStatus status;           // Overall validation status
+    uint16_t currentVersion;    // Version found in NVS
+    uint16_t expectedVersion;   // Version expected by code
+    bool zapNumberValid;        // ZapNumber (AANNNN) exists and valid
+    bool passwordHashValid;     // Password hash exists
+    bool crcValid;              // Overall CRC32 check passed
+    bool wasUpgraded;           // NVS was upgraded during validation
+    uint32_t calculatedCRC;     // The calculated CRC32 value
+    char zapNumber[7];          // The ZapNumber value (AANNNN format + null)
+    
+    /**
+     * @brief Construct a new NVSValidationResult object
+     * 
+     */
+    NVSValidationResult() : 
+        status(NVSStatus::NOT_CHECKED),
+        currentVersion(0),
+        expectedVersion(0),
+        zapNumberValid(false),
+        passwordHashValid(false),
+        crcValid(false),
+        wasUpgraded(false),
+        calculatedCRC(0) {
+        zapNumber[0] = '\0';
+    }
+};
+
+class EARS_nvsTransaction;
+
+/**
+ * @brief Version specific migration run by validate() before it stores the new version
+ * @param transaction Read-write session on the namespace
+ * @param fromVersion Version found in NVS
+ * @param toVersion Version expected by the code
+ * @param context Pointer given to validate()
+ * @return true if the migration succeeded
+ */
+typedef bool (*NVSUpgrade)(EARS_nvsTransaction& transaction, uint16_t fromVersion,
+                           uint16_t toVersion, void* context);
+
+/**
+ * @brief One open session on an NVS namespace
+ *
+ * Not thread safe, and only one transaction per port may be open at a time.
+ */
+class EARS_nvsTransaction {
+public:
+    // Longest string value read, password hash and ZapNumber included
+    static const size_t MAX_STRING = 64;
+
+    /**
+     * @brief Open the namespace for the lifetime of the transaction
+     * @param port NVS to use
+     * @param readOnly true to open read only, see makeWritable()
+     * @param name Namespace name
+     */
+    EARS_nvsTransaction(EARS_nvsPort& port, bool readOnly, const char* name = EARS_NVS_NAMESPACE);
+
+    /**
+     * @brief Commit pending writes and close the namespace
+     */
+    ~EARS_nvsTransaction();
+
+    /**
+     * @brief Check the namespace opened
+     * @return true if reads and writes can be made
+     */
+    bool isOpen() const { return _open; }
+
+    /**
+     * @brief Reopen a read only transaction read-write
+     * @return true if the transaction is now writable
+     *
+     * Costs a second open, so validation only pays it when it has to write.
+     */
+    bool makeWritable();
+
+    /**
+     * @brief Read an unsigned 16 bit value
+     * @param key Key name
+     * @param defaultValue Returned if the key is missing
+     * @return uint16_t stored value or defaultValue
+     */
+    uint16_t getU16(const char* key, uint16_t defaultValue = 0);
+
+    /**
+     * @brief Read an unsigned 32 bit value
+     * @param key Key name
+     * @param defaultValue Returned if the key is missing
+     * @return uint32_t stored value or defaultValue
+     */
+    uint32_t getU32(const char* key, uint32_t defaultValue = 0);
+
+    /**
+     * @brief Read a string
+     * @param key Key name
+     * @param out Receives the string, "" if missing or too long
+     * @param outBytes Size of out in bytes
+     * @return size_t string length, 0 if missing
+     */
+    size_t getString(const char* key, char* out, size_t outBytes);
+
+    /**
+     * @brief Write an unsigned 16 bit value, durable on commit()
+     * @param key Key name
+     * @param value Value to store
+     * @return true if written
+     */
+    bool putU16(const char* key, uint16_t value);
+
+    /**
+     * @brief Write an unsigned 32 bit value, durable on commit()
+     * @param key Key name
+     * @param value Value to store
+     * @return true if written
+     */
+    bool putU32(const char* key, uint32_t value);
+
+    /**
+     * @brief Write a string, durable on commit()
+     * @param key Key name
+     * @param value Null terminated string to store
+     * @return true if written
+     */
+    bool putString(const char* key, const char* value);
+
+    /**
+     * @brief Calculate the record CRC from this session's values
+     * @return uint32_t CRC32 of "version|zap|pwdHash", 0 if not open
+     */
+    uint32_t calculateCRC();
+
+    /**
+     * @brief Store the record CRC and commit, whether or not anything changed
+     * @return true if committed
+     */
+    bool updateCRC();
+
+    /**
+     * @brief Store the record CRC and commit if anything was written
+     * @return true if committed or nothing was pending
+     */
+    bool commit();
+
+    /**
+     * @brief Validate the EARS record in this session
+     * @param currentVersion Version expected by the code
+     * @param upgrade Migration for older records, nullptr if none is needed
+     * @param context Passed to upgrade
+     * @return NVSValidationResult Structure containing validation results
+     *
+     * This function checks:
+     * 1. Version matches or can be upgraded
+     * 2. ZapNumber exists and is valid format
+     * 3. Password hash exists
+     * 4. Overall CRC32 is valid (no tampering)
+     *
+     * A valid record costs the one open of this transaction; an upgrade
+     * adds one reopen and one commit.
+     */
+    NVSValidationResult validate(uint16_t currentVersion, NVSUpgrade upgrade = nullptr,
+                                 void* context = nullptr);
+
+private:
+    EARS_nvsPort& _port;
+    const char* _name;
+    bool _open;
+    bool _readOnly;
+    bool _pending;  // Written since the last commit
+
+    EARS_nvsTransaction(const EARS_nvsTransaction&) = delete;
+    EARS_nvsTransaction& operator=(const EARS_nvsTransaction&) = delete;
+};
+
+/**
+ * @brief Calculate CRC32 checksum.
+ * @param data Bytes to hash
+ * @param length Number of bytes
+ * @return uint32_t CRC32 (reflected, polynomial 0xEDB88320)
+ */
+uint32_t EARS_nvsCRC32(const uint8_t* data, size_t length);
+
+/**
+ * @brief CRC32 of "version|zap|pwdHash", the layout earlier releases stored
+ * @param version Record version
+ * @param zapNumber ZapNumber, "" if missing
+ * @param passwordHash Password hash, "" if missing
+ * @return uint32_t record CRC
+ */
+uint32_t EARS_nvsRecordCRC(uint16_t version, const char* zapNumber, const char* passwordHash);
+
+/**
+ * @brief Validate ZapNumber format (AANNNN)
+ * @param zapNumber String to validate
+ * @return true Valid format
+ * @return false Invalid format
+ */
+bool EARS_nvsValidZapNumber(const char* zapNumber);
+
+#endif // __EARS_NVS_TRANSACTION_H__
+
+/****************************************************************************
+ * End of EARS_nvsTransaction.h
+ ***************************************************************************/
@@ -2,7 +2,7 @@
  * @file EARS_screenSaverLib.cpp
  * @author JTB & Claude Sonnet 4.2
  * @brief Screensaver library implementation header file
- * @version 1.5.0
+ * @version 1.6.0
  * @date 20260116
  * 
  * @copyright Copyright (c) 2026 JTB. All rights reserved.
@@ -10,6 +10,9 @@
 
 #include "EARS_screenSaverLib.h"
 
+// Longest timeout the settings structure documents
+static const uint8_t MAX_TIMEOUT_SECONDS = 120;
+
 /**
  * @brief Construct a new Screensaver Lib:: Screensaver Lib object
  * @return EARS_screenSaver&* 
@@ -37,6 +40,12 @@ EARS_screenSaver::EARS_screenSaver() {
 void EARS_screenSaver::begin(lv_display_t* display) {
     _display = display;
     _last_activity_ms = millis();
+    
+    // Timeout lives in ears.config; follow it instead of polling
+    EARS_config& config = EARS_config::getInstance();
+    config.subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_TIMEOUT_SECONDS), configChanged, this);
+    uint16_t seconds = config.display().timeoutSeconds;
+    _settings.timeout_seconds = seconds > MAX_TIMEOUT_SECONDS ? MAX_TIMEOUT_SECONDS : (uint8_t)seconds;
 }
 
 /**
@@ -65,12 +74,17 @@ void EARS_screenSaver::toggleEnabled() {
 }
 
 /**
- * @brief  Set timeout in seconds
+ * @brief  Set timeout in seconds, saved to ears.config
  * @param seconds 
  * @return void
  */
 void EARS_screenSaver::setTimeout(uint8_t seconds) {
     _settings.timeout_seconds = seconds;
+    
+    EARS_config& config = EARS_config::getInstance();
+    DisplaySettings display = config.display();
+    display.timeoutSeconds = seconds;
+    config.setDisplay(display, millis());
 }
 
 /**
@@ -204,6 +218,20 @@ void EARS_screenSaver::updateAnimation() {
     // TODO: Implement animation
 }
 
+/**
+ * @brief Private: EARS_config observer for display.timeout_seconds
+ * @param changed Keys that changed
+ * @param model Every setting
+ * @param context EARS_screenSaver instance
+ * @return void
+ */
+void EARS_screenSaver::configChanged(ConfigKeyMask changed, const ConfigModel& model, void* context) {
+    EARS_screenSaver* saver = static_cast<EARS_screenSaver*>(context);
+    (void)changed;
+    uint16_t seconds = model.display.timeoutSeconds;
+    saver->_settings.timeout_seconds = seconds > MAX_TIMEOUT_SECONDS ? MAX_TIMEOUT_SECONDS : (uint8_t)seconds;
+}
+
 /**
  * @brief Get reference to global screensaver instance (Singleton pattern)
  * 
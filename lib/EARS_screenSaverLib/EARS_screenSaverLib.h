@@ -2,7 +2,7 @@
  * @file EARS_screenSaverLib.h
  * @author JTB & Claude Sonnet 4.2
  * @brief Screensaver library implementation header file
- * @version 1.5.0
+ * @version 1.6.0
  * @date 20260116
  * 
  * @copyright Copyright (c) 2026 JTB. All rights reserved.
@@ -14,6 +14,7 @@
 
 #include <Arduino.h>
 #include <lvgl.h>
+#include "EARS_configLib.h"
 
 /**
  * @brief Screensaver modes
@@ -62,7 +63,7 @@ public:
     EARS_screenSaver();
     
     /**
-     * @brief Initialization
+     * @brief Initialization, takes the timeout from ears.config and follows it
      * @param display
      * @return void 
      */
@@ -71,7 +72,7 @@ public:
     // Settings management
     void setEnabled(bool enabled);
     void toggleEnabled();
-    void setTimeout(uint8_t seconds);
+    void setTimeout(uint8_t seconds);   // Saved to ears.config display.timeout_seconds
     void setMode(ScreensaverMode mode);
     void setAnimationSpeed(uint8_t speed);
     void setBounceMode(bool bounce);
@@ -99,6 +100,7 @@ private:
     void saveBacklight();
     void restoreBacklight();
     void updateAnimation();
+    static void configChanged(ConfigKeyMask changed, const ConfigModel& model, void* context);
 };
 
 /**
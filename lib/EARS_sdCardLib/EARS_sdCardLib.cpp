@@ -2,14 +2,126 @@
  * @file EARS_sdCardLib.cpp
  * @author JTB & Claude Sonnet 4.2
  * @brief SD Card wrapper library for ESP32-S3 with separate SPI bus
- * @version 1.5.0
- * @date 20260116
+ * @version 1.19.1
+ * @date 20261016
  * 
  * @copyright Copyright (c) 2026 JTB. All rights reserved.
  */
 
 #include "EARS_sdCardLib.h"
 #include "EARS_ws35tlcdPins.h"
+#include <esp_heap_caps.h>
+#include "EARS_posixDirReader.h"
+#include "EARS_logFilterLib.h"
+
+// Card messages go to Serial, not EARS_logger: the logger writes its file
+// through this class, so a failed write would be logged into the file that
+// just failed. EARS_LOG_COMPILE_LEVEL_SDCARD still strips what is not built in.
+#define SDCARD_LOG(level, fmt, ...) \
+    EARS_LOG_IF(SDCARD, EARS_LOG_LEVEL_##level, true, \
+                Serial.printf("[SDCard] " fmt "\n", ##__VA_ARGS__))
+
+// Where SD.begin() mounts the card in the VFS
+static const char SD_MOUNT_POINT[] = "/sd";
+
+/**
+ * @brief Print that batches a writer's small writes into a File, noting failures
+ */
+class SdBufferedPrint : public Print {
+public:
+    explicit SdBufferedPrint(File& file) : _file(file), _used(0), _written(0), _failed(false) {}
+    
+    size_t write(uint8_t c) override {
+        if (_used == sizeof(_buffer)) {
+            drain();
+        }
+        _buffer[_used++] = c;
+        return 1;
+    }
+    
+    size_t write(const uint8_t* data, size_t length) override {
+        if (length >= sizeof(_buffer)) {
+            drain();
+            check(_file.write(data, length), length);
+            return length;
+        }
+        for (size_t i = 0; i < length; i++) {
+            write(data[i]);
+        }
+        return length;
+    }
+    
+    void drain() {
+        if (_used > 0) {
+            check(_file.write(_buffer, _used), _used);
+            _used = 0;
+        }
+    }
+    
+    bool failed() const { return _failed; }
+    size_t written() const { return _written; }
+    
+private:
+    File& _file;
+    uint8_t _buffer[128];
+    size_t _used;
+    size_t _written;
+    bool _failed;
+    
+    void check(size_t written, size_t wanted) {
+        _written += written;
+        if (written != wanted) {
+            _failed = true;
+        }
+    }
+};
+
+/**
+ * @brief Print that seals everything passed through it for EARS_atomicFile
+ */
+class SdSealingPrint : public Print {
+public:
+    SdSealingPrint(Print& out, EARS_atomicFile& seal) : _out(out), _seal(seal) {}
+    
+    size_t write(uint8_t c) override {
+        return write(&c, 1);
+    }
+    
+    size_t write(const uint8_t* data, size_t length) override {
+        _seal.add(data, length);
+        return _out.write(data, length);
+    }
+    
+private:
+    Print& _out;
+    EARS_atomicFile& _seal;
+};
+
+/**
+ * @brief A writeStreamAtomic() writer and its context
+ */
+struct SdSealedWriter {
+    SdStreamWriter writer;
+    void* context;
+};
+
+/**
+ * @brief SdStreamWriter running a caller's writer, then appending the seal
+ * @param out Emptied temporary file
+ * @param context SdSealedWriter
+ * @return true if the caller's writer succeeded
+ */
+static bool writeSealed(Print& out, void* context) {
+    SdSealedWriter* sealed = static_cast<SdSealedWriter*>(context);
+    EARS_atomicFile seal;
+    SdSealingPrint sealing(out, seal);
+    bool ok = sealed->writer(sealing, sealed->context);
+    
+    char trailer[EARS_atomicFile::TRAILER_BYTES + 1];
+    seal.trailer(trailer);
+    out.write(reinterpret_cast<const uint8_t*>(trailer), EARS_atomicFile::TRAILER_BYTES);
+    return ok;
+}
 
 /**
  * @brief Construct a new EARS_sdCard object
@@ -17,16 +129,33 @@
  * @param Initialised flag
  * @return void
  */
-EARS_sdCard::EARS_sdCard() : _initialized(false), _spi(nullptr) {
+EARS_sdCard::EARS_sdCard()
+    : _initialized(false), _spi(nullptr), _openCount(0), _placeAt(NO_PLACE), _cacheStorage(nullptr),
+      _spaceTask(nullptr), _spaceStop(false), _spaceRunning(false) {
+    _pool.begin(this, HANDLE_POOL_SIZE, HANDLE_MAX_DIRTY_MS);
+    memset(_placed, 0, sizeof(_placed));
+    memset(_rules, 0, sizeof(_rules));
+    setDurability("/config/", SdDurability::WRITE_THROUGH);
 }
 
 /**
  * @brief Destroy the EARS_sdCard object
  */
 EARS_sdCard::~EARS_sdCard() {
+    if (_spaceRunning.load()) {
+        _spaceStop.store(true);
+        xTaskNotifyGive(_spaceTask);
+        while (_spaceRunning.load()) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    closeFiles();
     if (_spi) {
         _spi->end();
     }
+    if (_cacheStorage) {
+        heap_caps_free(_cacheStorage);
+    }
 }
 
 /**
@@ -41,6 +170,360 @@ void EARS_sdCard::initSPI() {
     _spi->begin(SD_SCK, SD_MISO, SD_MOSI, SD_CS);
 }
 
+/**
+ * @brief Open a file through the SD library, counting the open
+ * @param path File path
+ * @param mode FILE_READ, FILE_WRITE or FILE_APPEND
+ * @return File handle (false if open failed)
+ */
+File EARS_sdCard::openFile(const char* path, const char* mode) {
+    _openCount++;
+    return SD.open(path, mode);
+}
+
+/**
+ * @brief Open a pool slot's handle
+ * @param slot Free slot
+ * @param path File path
+ * @param truncate true to empty the file, false to append
+ * @return true if opened
+ */
+bool EARS_sdCard::openHandle(uint8_t slot, const char* path, bool truncate) {
+    _placed[slot] = !truncate && _placeAt != NO_PLACE;
+    if (_placed[slot]) {
+        // "r+" keeps the contents and writes where seek() puts it
+        _handles[slot] = openFile(path, "r+");
+        if (_handles[slot] && !_handles[slot].seek(_placeAt)) {
+            _handles[slot].close();
+        }
+        if (!_handles[slot]) {
+            return false;
+        }
+        _caches[slot].reset(_placeAt);
+        _paths.store(path, PathInfo(PathType::FILE, true, (uint32_t)_handles[slot].size()));
+        return true;
+    }
+    
+    _handles[slot] = openFile(path, truncate ? FILE_WRITE : FILE_APPEND);
+    if (!_handles[slot]) {
+        return false;
+    }
+    uint32_t size = truncate ? 0 : (uint32_t)_handles[slot].size();
+    _caches[slot].reset(size);
+    _paths.store(path, PathInfo(PathType::FILE, true, size));
+    return true;
+}
+
+/**
+ * @brief Write a slot's cached bytes, then flush its handle (fflush and fsync)
+ * @param slot Open slot
+ * @return false if the cached bytes could not be written
+ */
+bool EARS_sdCard::flushHandle(uint8_t slot) {
+    bool ok = _caches[slot].drain(writeHandle, &_handles[slot]);
+    _handles[slot].flush();
+    return ok;
+}
+
+/**
+ * @brief Write a slot's cached bytes and close its handle
+ * @param slot Open slot
+ * @return void
+ */
+void EARS_sdCard::closeHandle(uint8_t slot) {
+    _caches[slot].drain(writeHandle, &_handles[slot]);
+    _caches[slot].reset(0);
+    _handles[slot].close();
+}
+
+/**
+ * @brief Write cache sink, appends to the File in context
+ * @param data Bytes
+ * @param length Number of bytes
+ * @param context File*
+ * @return true if every byte was written
+ */
+bool EARS_sdCard::writeHandle(const uint8_t* data, size_t length, void* context) {
+    return static_cast<File*>(context)->write(data, length) == length;
+}
+
+/**
+ * @brief Allocate the write cache blocks (once, after SD.begin())
+ * @return void
+ */
+void EARS_sdCard::initWriteCache() {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    if (_cacheStorage) {
+        return;
+    }
+    _cacheStorage = static_cast<uint8_t*>(heap_caps_malloc(HANDLE_POOL_SIZE * WRITE_CACHE_BYTES,
+                                                           MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (!_cacheStorage) {
+        // Without the blocks every append is written through
+        SDCARD_LOG(WARN, "Write cache unavailable, writing through");
+        return;
+    }
+    for (uint8_t i = 0; i < HANDLE_POOL_SIZE; i++) {
+        _caches[i].begin(_cacheStorage + i * WRITE_CACHE_BYTES, WRITE_CACHE_BYTES);
+    }
+}
+
+/**
+ * @brief Write through a pooled handle
+ * @param path File path
+ * @param data Bytes to write
+ * @param length Number of bytes
+ * @param truncate true to replace the file, false to append
+ * @return true if all bytes were written
+ */
+bool EARS_sdCard::writePooled(const char* path, const uint8_t* data, size_t length, bool truncate) {
+    SdSpan span = { data, length };
+    return writeSpans(path, &span, 1, truncate);
+}
+
+/**
+ * @brief Write several pieces through one pooled handle
+ * @param path File path
+ * @param spans Pieces to write
+ * @param count Number of pieces
+ * @param truncate true to replace the file, false to append
+ * @return true if all bytes were written
+ */
+bool EARS_sdCard::writeSpans(const char* path, const SdSpan* spans, size_t count, bool truncate) {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    
+    // Size before the write, for free space; truncating frees the old clusters
+    PathInfo before;
+    bool sized = true;
+    if (truncate) {
+        before = statPath(path);
+    }
+    
+    // A handle left by writeFileAt() does not append
+    int open = _pool.slotOf(path);
+    if (open >= 0 && _placed[open]) {
+        _pool.close(path);
+    }
+    
+    int slot = _pool.acquire(path, truncate);
+    if (slot < 0) {
+        SDCARD_LOG(ERROR, "Failed to open file for %s: %s", truncate ? "writing" : "appending", path);
+        return false;
+    }
+    
+    // Whole-file writes (config) and WRITE_THROUGH paths bypass the cache
+    bool cached = !truncate && getDurability(path) == SdDurability::CACHED;
+    if (!truncate) {
+        sized = _paths.lookup(path, before);
+    }
+    bool complete = true;
+    for (size_t i = 0; i < count && complete; i++) {
+        if (cached) {
+            complete = _caches[slot].append(spans[i].data, spans[i].length, writeHandle, &_handles[slot]);
+        } else {
+            complete = writeHandle(spans[i].data, spans[i].length, &_handles[slot]);
+        }
+    }
+    uint32_t now = millis();
+    _pool.markDirty((uint8_t)slot, now);
+    
+    if (!complete) {
+        // Most likely the card was pulled - every pooled handle is stale
+        closeFiles();
+        _space.unknownChange();
+        SDCARD_LOG(ERROR, "%s failed: %s", truncate ? "Write" : "Append", path);
+        return false;
+    }
+    
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += spans[i].length;
+    }
+    _paths.appended(path, (uint32_t)total);
+    uint64_t oldSize = before.type == PathType::FILE ? before.size : 0;
+    if (sized) {
+        _space.resized(oldSize, truncate ? total : oldSize + total);
+    } else {
+        _space.added(total);
+    }
+    
+    if (!cached) {
+        _pool.flush(path);
+    }
+    _pool.flushExpired(now);
+    return true;
+}
+
+/**
+ * @brief Flush path's pooled handle so a separate open sees its data
+ * @param path File path
+ * @return void
+ */
+void EARS_sdCard::flushPooled(const char* path) {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    _pool.flush(path);
+}
+
+/**
+ * @brief Commit one pooled file's cached and buffered writes to the card
+ * @param path File path
+ * @return true unless the flush failed
+ */
+bool EARS_sdCard::syncFile(const char* path) {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    return _pool.flush(path);
+}
+
+/**
+ * @brief Commit every pooled file's cached and buffered writes to the card
+ * @return true if all flushes succeeded
+ * @return false if a flush failed
+ */
+bool EARS_sdCard::sync() {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    return _pool.flushAll();
+}
+
+/**
+ * @brief Set how appends to paths starting with pathPrefix reach the card
+ * @param pathPrefix Path or directory prefix
+ * @param durability CACHED or WRITE_THROUGH
+ * @return true if the rule was stored
+ * @return false if all DURABILITY_RULES are taken
+ */
+bool EARS_sdCard::setDurability(const char* pathPrefix, SdDurability durability) {
+    if (!pathPrefix || !pathPrefix[0] || strlen(pathPrefix) >= DURABILITY_PREFIX_BYTES) {
+        return false;
+    }
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    
+    DurabilityRule* rule = nullptr;
+    for (uint8_t i = 0; i < DURABILITY_RULES && !rule; i++) {
+        if (strcmp(_rules[i].prefix, pathPrefix) == 0) {
+            rule = &_rules[i];
+        }
+    }
+    for (uint8_t i = 0; i < DURABILITY_RULES && !rule; i++) {
+        if (!_rules[i].prefix[0]) {
+            rule = &_rules[i];
+        }
+    }
+    if (!rule) {
+        return false;
+    }
+    
+    // Nothing cached under the old rule may outlive it
+    _pool.flushAll();
+    strcpy(rule->prefix, pathPrefix);
+    rule->durability = durability;
+    return true;
+}
+
+/**
+ * @brief Get the durability that applies to path
+ * @param path File path
+ * @return SdDurability CACHED or WRITE_THROUGH
+ */
+SdDurability EARS_sdCard::getDurability(const char* path) {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    
+    SdDurability durability = SdDurability::CACHED;
+    size_t longest = 0;
+    for (uint8_t i = 0; i < DURABILITY_RULES; i++) {
+        size_t length = strlen(_rules[i].prefix);
+        if (length > longest && strncmp(path, _rules[i].prefix, length) == 0) {
+            longest = length;
+            durability = _rules[i].durability;
+        }
+    }
+    return durability;
+}
+
+/**
+ * @brief Flush pooled files with writes older than HANDLE_MAX_DIRTY_MS
+ * @return void
+ */
+void EARS_sdCard::flushExpired() {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    _pool.flushExpired(millis());
+}
+
+/**
+ * @brief Close every pooled file
+ * @return void
+ */
+void EARS_sdCard::closeFiles() {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    _pool.closeAll();
+    _paths.clear();
+}
+
+/**
+ * @brief Forget all cached path metadata
+ * @return void
+ */
+void EARS_sdCard::invalidateMetadata() {
+    _paths.clear();
+}
+
+/**
+ * @brief Get the path metadata cache counters
+ * @return PathCacheStats hits, misses, evictions and clears
+ */
+PathCacheStats EARS_sdCard::getPathCacheStats() {
+    return _paths.getStats();
+}
+
+/**
+ * @brief Look up a path's type and size, opening it on a cache miss
+ * @param path File or directory path
+ * @return PathInfo what is at path
+ */
+PathInfo EARS_sdCard::statPath(const char* path) {
+    PathInfo info;
+    if (_paths.lookup(path, info)) {
+        return info;
+    }
+    
+    // Under the pool lock, so no write or remove can slip between open and store
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    flushPooled(path);
+    File file = openFile(path, FILE_READ);
+    if (file) {
+        info = file.isDirectory() ? PathInfo(PathType::DIRECTORY, false, 0)
+                                  : PathInfo(PathType::FILE, true, (uint32_t)file.size());
+        file.close();
+    }
+    _paths.store(path, info);
+    return info;
+}
+
+/**
+ * @brief Get the handle pool counters
+ * @return HandlePoolStats hits, opens, evictions and flushes
+ */
+HandlePoolStats EARS_sdCard::getHandleStats() {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    return _pool.getStats();
+}
+
+/**
+ * @brief Get the write cache counters, summed over the pool
+ * @return WriteCacheStats appends, card writes and bytes
+ */
+WriteCacheStats EARS_sdCard::getWriteCacheStats() {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    WriteCacheStats total;
+    for (uint8_t i = 0; i < HANDLE_POOL_SIZE; i++) {
+        WriteCacheStats stats = _caches[i].getStats();
+        total.appends += stats.appends;
+        total.sinkWrites += stats.sinkWrites;
+        total.partialWrites += stats.partialWrites;
+        total.bytes += stats.bytes;
+    }
+    return total;
+}
+
 /**
  * @brief Initialize the SD card
  * @return true if SD card initialized successfully
@@ -56,7 +539,7 @@ bool EARS_sdCard::begin() {
     
     // Try to initialize SD card
     if (!SD.begin(SD_CS, *_spi)) {
-        Serial.println("[SDCard] Initialization failed!");
+        SDCARD_LOG(ERROR, "Initialization failed");
         _initialized = false;
         return false;
     }
@@ -64,23 +547,25 @@ bool EARS_sdCard::begin() {
     // Check card type
     uint8_t cardType = SD.cardType();
     if (cardType == CARD_NONE) {
-        Serial.println("[SDCard] No SD card attached");
+        SDCARD_LOG(WARN, "No SD card attached");
         _initialized = false;
         return false;
     }
     
     _initialized = true;
+    _paths.clear();
+    initWriteCache();
+    
+    // Counting used space reads the whole FAT, leave it to a background task
+    uint64_t totalBytes = SD.totalBytes();
+    _space.begin(totalBytes, EARS_spaceTracker::typicalClusterBytes(totalBytes));
+    startSpaceTask();
     
     // Print card info
-    Serial.println("[SDCard] Initialization successful");
-    Serial.print("[SDCard] Type: ");
-    Serial.println(getCardType());
-    Serial.print("[SDCard] Size: ");
-    Serial.print(getCardSizeMB());
-    Serial.println(" MB");
-    Serial.print("[SDCard] Free: ");
-    Serial.print(getFreeSpaceMB());
-    Serial.println(" MB");
+    SDCARD_LOG(INFO, "Initialization successful");
+    SDCARD_LOG(INFO, "Type: %s", getCardType().c_str());
+    SDCARD_LOG(INFO, "Size: %llu MB", (unsigned long long)getCardSizeMB());
+    SDCARD_LOG(INFO, "Free: counting in background");
     
     return true;
 }
@@ -133,11 +618,80 @@ uint64_t EARS_sdCard::getCardSizeMB() {
 uint64_t EARS_sdCard::getFreeSpaceMB() {
     if (!_initialized) return 0;
     
-    uint64_t totalBytes = SD.totalBytes();
+    return _space.freeBytes() / (1024 * 1024);
+}
+
+/**
+ * @brief Check if the free space count has finished
+ * @return true if getFreeSpaceMB() is meaningful
+ */
+bool EARS_sdCard::isFreeSpaceKnown() {
+    return _initialized && _space.isKnown();
+}
+
+/**
+ * @brief Get the free space tracking counters
+ * @return SpaceTrackerStats counts, changes and drift
+ */
+SpaceTrackerStats EARS_sdCard::getSpaceStats() {
+    return _space.getStats();
+}
+
+/**
+ * @brief Start the task that counts and recounts used space
+ * @return void
+ */
+void EARS_sdCard::startSpaceTask() {
+    if (_spaceRunning.load()) {
+        // Already running, it counts the new card at its next check
+        xTaskNotifyGive(_spaceTask);
+        return;
+    }
+    _spaceStop.store(false);
+    _spaceRunning.store(true);
+    if (xTaskCreatePinnedToCore(spaceTaskMain, "EARS_sdSpace", SPACE_TASK_STACK, this,
+                                SPACE_TASK_PRIORITY, &_spaceTask, SPACE_TASK_CORE) != pdPASS) {
+        // Count now rather than never
+        _spaceRunning.store(false);
+        _spaceTask = nullptr;
+        countSpace();
+    }
+}
+
+/**
+ * @brief FreeRTOS task body counting used space when due
+ * @param param EARS_sdCard instance
+ * @return void
+ */
+void EARS_sdCard::spaceTaskMain(void* param) {
+    EARS_sdCard* card = static_cast<EARS_sdCard*>(param);
+    while (!card->_spaceStop.load()) {
+        if (card->_initialized && card->_space.countDue(millis())) {
+            card->countSpace();
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SPACE_CHECK_MS));
+    }
+    card->_spaceRunning.store(false);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Count used space (reads the whole FAT, seconds on large cards)
+ * @return void
+ */
+void EARS_sdCard::countSpace() {
+    bool first = !_space.isKnown();
+    _space.beginCount();
     uint64_t usedBytes = SD.usedBytes();
-    uint64_t freeBytes = totalBytes - usedBytes;
+    if (usedBytes == 0) {
+        // Count failed (a mounted volume always uses its root directory)
+        return;
+    }
+    _space.endCount(usedBytes, millis());
     
-    return freeBytes / (1024 * 1024);
+    if (first) {
+        SDCARD_LOG(INFO, "Free: %llu MB", (unsigned long long)getFreeSpaceMB());
+    }
 }
 
 /**
@@ -149,17 +703,23 @@ uint64_t EARS_sdCard::getFreeSpaceMB() {
 bool EARS_sdCard::createDirectory(const char* path) {
     if (!_initialized) return false;
     
+    if (directoryExists(path)) {
+        return true;
+    }
+    
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
     if (SD.mkdir(path)) {
-        Serial.print("[SDCard] Directory created: ");
-        Serial.println(path);
+        _paths.store(path, PathInfo(PathType::DIRECTORY, false, 0));
+        _space.resized(0, 1);
+        SDCARD_LOG(INFO, "Directory created: %s", path);
         return true;
     } else {
-        // Check if it already exists
+        // Created behind our back since the check
+        _paths.erase(path);
         if (directoryExists(path)) {
             return true;
         }
-        Serial.print("[SDCard] Failed to create directory: ");
-        Serial.println(path);
+        SDCARD_LOG(ERROR, "Failed to create directory: %s", path);
         return false;
     }
 }
@@ -173,13 +733,19 @@ bool EARS_sdCard::createDirectory(const char* path) {
 bool EARS_sdCard::fileExists(const char* path) {
     if (!_initialized) return false;
     
-    File file = SD.open(path);
-    if (file) {
-        bool isFile = !file.isDirectory();
-        file.close();
-        return isFile;
-    }
-    return false;
+    return statPath(path).type == PathType::FILE;
+}
+
+/**
+ * @brief Get file size with a single open
+ * @param path File path
+ * @return uint32_t file size in bytes (0 if missing or a directory)
+ */
+uint32_t EARS_sdCard::getFileSize(const char* path) {
+    if (!_initialized) return 0;
+    
+    PathInfo info = statPath(path);
+    return info.type == PathType::FILE ? info.size : 0;
 }
 
 /**
@@ -191,13 +757,7 @@ bool EARS_sdCard::fileExists(const char* path) {
 bool EARS_sdCard::directoryExists(const char* path) {
     if (!_initialized) return false;
     
-    File dir = SD.open(path);
-    if (dir) {
-        bool isDir = dir.isDirectory();
-        dir.close();
-        return isDir;
-    }
-    return false;
+    return statPath(path).type == PathType::DIRECTORY;
 }
 
 /**
@@ -209,13 +769,48 @@ bool EARS_sdCard::directoryExists(const char* path) {
 bool EARS_sdCard::removeFile(const char* path) {
     if (!_initialized) return false;
     
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    PathInfo before = statPath(path);
+    _pool.close(path);
     if (SD.remove(path)) {
-        Serial.print("[SDCard] File removed: ");
-        Serial.println(path);
+        _paths.store(path, PathInfo());
+        _space.resized(before.type == PathType::FILE ? before.size : 0, 0);
+        SDCARD_LOG(INFO, "File removed: %s", path);
+        return true;
+    }
+    _paths.erase(path);
+    SDCARD_LOG(ERROR, "Failed to remove file: %s", path);
+    return false;
+}
+
+/**
+ * @brief Rename a file (directory entry only, no data copied)
+ * @param fromPath Existing file path
+ * @param toPath New file path, must not exist
+ * @return true if file renamed
+ * @return false if rename failed
+ */
+bool EARS_sdCard::renameFile(const char* fromPath, const char* toPath) {
+    if (!_initialized) return false;
+    
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    _pool.close(fromPath);
+    _pool.close(toPath);
+    PathInfo moved;
+    bool known = _paths.lookup(fromPath, moved) && moved.type == PathType::FILE;
+    if (SD.rename(fromPath, toPath)) {
+        // A renamed directory takes its whole tree along
+        _paths.eraseTree(fromPath);
+        _paths.eraseTree(toPath);
+        _paths.store(fromPath, PathInfo());
+        if (known) {
+            _paths.store(toPath, moved);
+        }
         return true;
     }
-    Serial.print("[SDCard] Failed to remove file: ");
-    Serial.println(path);
+    _paths.erase(fromPath);
+    _paths.erase(toPath);
+    SDCARD_LOG(ERROR, "Failed to rename file: %s -> %s", fromPath, toPath);
     return false;
 }
 
@@ -228,62 +823,126 @@ bool EARS_sdCard::removeFile(const char* path) {
 bool EARS_sdCard::removeDirectory(const char* path) {
     if (!_initialized) return false;
     
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
     if (SD.rmdir(path)) {
-        Serial.print("[SDCard] Directory removed: ");
-        Serial.println(path);
+        _paths.eraseTree(path);
+        _paths.store(path, PathInfo());
+        _space.resized(1, 0);
+        SDCARD_LOG(INFO, "Directory removed: %s", path);
         return true;
     }
-    Serial.print("[SDCard] Failed to remove directory: ");
-    Serial.println(path);
+    SDCARD_LOG(ERROR, "Failed to remove directory: %s", path);
     return false;
 }
 
 /**
- * @brief List directory contents
+ * @brief Print one entry of a listDirectory() tree
+ * @param entry Directory entry
+ * @param context Base indentation level (uint8_t*)
+ * @return WalkAction always CONTINUE
+ */
+static WalkAction printEntry(const DirEntry& entry, void* context) {
+    uint8_t indent = *static_cast<uint8_t*>(context) + entry.depth;
+    for (uint8_t i = 0; i < indent; i++) {
+        Serial.print("  ");
+    }
+    Serial.print(entry.name);
+    if (entry.type == DirEntryType::DIRECTORY) {
+        Serial.println("/");
+    } else {
+        Serial.print(" - ");
+        Serial.print(entry.size);
+        Serial.println(" bytes");
+    }
+    return WalkAction::CONTINUE;
+}
+
+/**
+ * @brief Print a directory tree to Serial
  * @param path Directory path
- * @param indent Indentation level for display
+ * @param indent Indentation level of the first level
  * @return void
  */
 void EARS_sdCard::listDirectory(const char* path, uint8_t indent) {
     if (!_initialized) return;
     
-    File dir = SD.open(path);
-    if (!dir) {
-        Serial.print("[SDCard] Failed to open directory: ");
-        Serial.println(path);
+    WalkOptions options;
+    options.maxDepth = EARS_dirWalker::MAX_DEPTH;
+    WalkStats stats = walk(path, options, printEntry, &indent);
+    if (stats.directories == 0) {
+        SDCARD_LOG(ERROR, "Failed to open directory: %s", path);
         return;
     }
-    
-    if (!dir.isDirectory()) {
-        Serial.println("[SDCard] Not a directory");
-        dir.close();
-        return;
+    if (stats.tooLong || stats.tooDeep) {
+        SDCARD_LOG(WARN, "%u entries not listed (path too long or too deep)",
+                   (unsigned)(stats.tooLong + stats.tooDeep));
     }
-    
-    File file = dir.openNextFile();
-    while (file) {
-        for (uint8_t i = 0; i < indent; i++) {
-            Serial.print("  ");
-        }
-        
-        Serial.print(file.name());
-        
-        if (file.isDirectory()) {
-            Serial.println("/");
-            // Recursively list subdirectories
-            String subPath = String(path) + "/" + String(file.name());
-            listDirectory(subPath.c_str(), indent + 1);
-        } else {
-            Serial.print(" - ");
-            Serial.print(file.size());
-            Serial.println(" bytes");
+}
+
+/**
+ * @brief Walk a directory tree, parents before their contents
+ * @param root Directory to walk
+ * @param options Depth limit, type and name suffix filters
+ * @param visitor Called for each matching entry; may remove the entry it is given
+ * @param context Passed to visitor unchanged
+ * @return WalkStats what the walk did; complete is false if root could not be opened
+ */
+WalkStats EARS_sdCard::walk(const char* root, const WalkOptions& options, DirVisitor visitor, void* context) {
+    if (!_initialized || !root || !visitor) {
+        WalkStats stats;
+        stats.complete = false;
+        return stats;
+    }
+    sync();
+    EARS_posixDirReader reader(SD_MOUNT_POINT);
+    return EARS_dirWalker::walk(reader, root, options, visitor, context);
+}
+
+/**
+ * @brief listNames() output position
+ */
+struct NameListTarget {
+    char* buffer;
+    size_t capacity;
+    size_t used;
+};
+
+/**
+ * @brief Append one entry name to a NameListTarget
+ * @param entry Directory entry
+ * @param context NameListTarget
+ * @return WalkAction always CONTINUE, names that do not fit are left out
+ */
+static WalkAction appendName(const DirEntry& entry, void* context) {
+    NameListTarget* target = static_cast<NameListTarget*>(context);
+    bool directory = entry.type == DirEntryType::DIRECTORY;
+    size_t length = strlen(entry.name);
+    size_t needed = length + (directory ? 2 : 1);
+    if (target->used + needed <= target->capacity) {
+        memcpy(target->buffer + target->used, entry.name, length);
+        target->used += length;
+        if (directory) {
+            target->buffer[target->used++] = '/';
         }
-        
-        file.close();
-        file = dir.openNextFile();
+        target->buffer[target->used++] = '\n';
     }
+    return WalkAction::CONTINUE;
+}
+
+/**
+ * @brief Write a directory's entry names into a buffer
+ * @param path Directory path
+ * @param buffer Destination, one name per line, directories end in '/'
+ * @param capacity Size of buffer in bytes
+ * @return size_t bytes written, names that do not fit are left out
+ */
+size_t EARS_sdCard::listNames(const char* path, char* buffer, size_t capacity) {
+    if (!_initialized || !buffer) return 0;
     
-    dir.close();
+    NameListTarget target = { buffer, capacity, 0 };
+    WalkOptions options;
+    walk(path, options, appendName, &target);
+    return target.used;
 }
 
 /**
@@ -294,22 +953,189 @@ void EARS_sdCard::listDirectory(const char* path, uint8_t indent) {
 String EARS_sdCard::readFile(const char* path) {
     if (!_initialized) return "";
     
-    File file = SD.open(path, FILE_READ);
+    flushPooled(path);
+    File file = openFile(path, FILE_READ);
     if (!file) {
-        Serial.print("[SDCard] Failed to open file for reading: ");
-        Serial.println(path);
+        SDCARD_LOG(ERROR, "Failed to open file for reading: %s", path);
         return "";
     }
     
+    // One allocation for the whole file instead of growing per byte
     String content = "";
-    while (file.available()) {
-        content += char(file.read());
+    size_t remaining = file.size();
+    if (!content.reserve(remaining)) {
+        SDCARD_LOG(ERROR, "Not enough memory to read: %s", path);
+        file.close();
+        return "";
+    }
+    
+    // Stage reads in a PSRAM block, falling back to the stack without PSRAM
+    uint8_t stackBlock[512];
+    uint8_t* block = (uint8_t*)heap_caps_malloc(READ_BLOCK_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    size_t blockBytes = block ? READ_BLOCK_BYTES : sizeof(stackBlock);
+    if (!block) {
+        block = stackBlock;
     }
     
+    while (remaining > 0) {
+        size_t count = file.read(block, remaining < blockBytes ? remaining : blockBytes);
+        if (count == 0) {
+            break;
+        }
+        content.concat(block, count);
+        remaining -= count;
+    }
+    
+    if (block != stackBlock) {
+        heap_caps_free(block);
+    }
     file.close();
     return content;
 }
 
+/**
+ * @brief Read a file into a caller-owned buffer
+ * @param path File path
+ * @param buffer Destination
+ * @param capacity Size of buffer in bytes
+ * @return size_t bytes read, at most capacity (0 if failed)
+ */
+size_t EARS_sdCard::readFile(const char* path, uint8_t* buffer, size_t capacity) {
+    if (!_initialized || !buffer) return 0;
+    
+    flushPooled(path);
+    File file = openFile(path, FILE_READ);
+    if (!file) {
+        SDCARD_LOG(ERROR, "Failed to open file for reading: %s", path);
+        return 0;
+    }
+    
+    size_t wanted = file.size();
+    if (wanted > capacity) {
+        wanted = capacity;
+    }
+    
+    // Straight into the caller's buffer, no staging copy
+    size_t total = 0;
+    while (total < wanted) {
+        size_t chunk = wanted - total;
+        if (chunk > READ_BLOCK_BYTES) {
+            chunk = READ_BLOCK_BYTES;
+        }
+        size_t count = file.read(buffer + total, chunk);
+        if (count == 0) {
+            break;
+        }
+        total += count;
+    }
+    
+    file.close();
+    return total;
+}
+
+/**
+ * @brief Read a file of any size chunk by chunk
+ * @param path File path
+ * @param buffer Chunk buffer owned by the caller
+ * @param bufferBytes Size of buffer
+ * @param visitor Called with each chunk, returns false to stop
+ * @param context Passed to visitor unchanged
+ * @return size_t bytes handed to the visitor
+ */
+size_t EARS_sdCard::readChunks(const char* path, uint8_t* buffer, size_t bufferBytes,
+                               FsChunkVisitor visitor, void* context) {
+    if (!_initialized || !buffer || bufferBytes == 0 || !visitor) return 0;
+    
+    flushPooled(path);
+    File file = openFile(path, FILE_READ);
+    if (!file) {
+        SDCARD_LOG(ERROR, "Failed to open file for reading: %s", path);
+        return 0;
+    }
+    
+    // One open for the whole file, however large
+    size_t total = 0;
+    for (;;) {
+        size_t count = file.read(buffer, bufferBytes);
+        if (count == 0) {
+            break;
+        }
+        total += count;
+        if (!visitor(buffer, count, context)) {
+            break;
+        }
+    }
+    
+    file.close();
+    return total;
+}
+
+/**
+ * @brief Read a text file of any size line by line
+ * @param path File path
+ * @param line Line buffer owned by the caller; longer lines are cut
+ * @param lineBytes Size of line
+ * @param visitor Called with each line, returns false to stop
+ * @param context Passed to visitor unchanged
+ * @return uint32_t lines handed to the visitor
+ */
+uint32_t EARS_sdCard::readLines(const char* path, char* line, size_t lineBytes,
+                                FsLineVisitor visitor, void* context) {
+    uint8_t chunk[STREAM_CHUNK_BYTES];
+    EARS_lineSplitter splitter(line, lineBytes, visitor, context);
+    readChunks(path, chunk, sizeof(chunk), EARS_lineSplitter::feedChunk, &splitter);
+    splitter.finish();
+    return splitter.lines();
+}
+
+/**
+ * @brief Hand an open file to a reader
+ * @param path File path
+ * @param reader Reads from the file
+ * @param context Passed to reader unchanged
+ * @return true if the file opened and the reader succeeded
+ */
+bool EARS_sdCard::readStream(const char* path, SdStreamReader reader, void* context) {
+    if (!_initialized || !reader) return false;
+    
+    flushPooled(path);
+    File file = openFile(path, FILE_READ);
+    if (!file) {
+        SDCARD_LOG(ERROR, "Failed to open file for reading: %s", path);
+        return false;
+    }
+    
+    bool ok = reader(file, context);
+    file.close();
+    return ok;
+}
+
+/**
+ * @brief Read part of a file into a buffer
+ * @param path File path
+ * @param offset Byte offset to start at
+ * @param buffer Destination
+ * @param length Bytes wanted
+ * @return size_t bytes read (less at end of file, 0 if failed)
+ */
+size_t EARS_sdCard::readFileAt(const char* path, uint32_t offset, uint8_t* buffer, size_t length) {
+    if (!_initialized) return 0;
+    
+    flushPooled(path);
+    File file = openFile(path, FILE_READ);
+    if (!file) {
+        return 0;
+    }
+    
+    size_t count = 0;
+    if (file.seek(offset)) {
+        count = file.read(buffer, length);
+    }
+    
+    file.close();
+    return count;
+}
+
 /**
  * @brief Write String to file (overwrites existing)
  * @param path File path
@@ -320,23 +1146,114 @@ String EARS_sdCard::readFile(const char* path) {
 bool EARS_sdCard::writeFile(const char* path, const String& content) {
     if (!_initialized) return false;
     
-    File file = SD.open(path, FILE_WRITE);
-    if (!file) {
-        Serial.print("[SDCard] Failed to open file for writing: ");
-        Serial.println(path);
+    return writePooled(path, reinterpret_cast<const uint8_t*>(content.c_str()), content.length(), true);
+}
+
+/**
+ * @brief Write bytes to file (overwrites existing)
+ * @param path File path
+ * @param data Bytes to write
+ * @param length Number of bytes
+ * @return true if write successful
+ * @return false if write failed
+ */
+bool EARS_sdCard::writeFile(const char* path, const uint8_t* data, size_t length) {
+    if (!_initialized) return false;
+    
+    return writePooled(path, data, length, true);
+}
+
+/**
+ * @brief Replace a file with whatever a writer prints
+ * @param path File path
+ * @param writer Prints the new contents
+ * @param context Passed to writer unchanged
+ * @return true if the writer succeeded and every byte reached the file
+ * @return false otherwise
+ */
+bool EARS_sdCard::writeStream(const char* path, SdStreamWriter writer, void* context) {
+    if (!_initialized || !writer) return false;
+    
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    PathInfo before = statPath(path);
+    int slot = _pool.acquire(path, true);
+    if (slot < 0) {
+        SDCARD_LOG(ERROR, "Failed to open file for writing: %s", path);
         return false;
     }
     
-    size_t written = file.print(content);
-    file.close();
+    SdBufferedPrint out(_handles[slot]);
+    bool ok = writer(out, context);
+    out.drain();
+    _pool.markDirty((uint8_t)slot, millis());
     
-    if (written == content.length()) {
-        return true;
+    if (out.failed()) {
+        closeFiles();
+        _space.unknownChange();
+        SDCARD_LOG(ERROR, "Write failed: %s", path);
+        return false;
     }
     
-    Serial.print("[SDCard] Write failed: ");
-    Serial.println(path);
-    return false;
+    _pool.flush(path);
+    _paths.store(path, PathInfo(PathType::FILE, true, (uint32_t)out.written()));
+    _space.resized(before.type == PathType::FILE ? before.size : 0, out.written());
+    return ok;
+}
+
+/**
+ * @brief Replace a file all at once with whatever a writer prints
+ * @param path File path
+ * @param writer Prints the new contents
+ * @param context Passed to writer unchanged
+ * @return true if path now holds the new contents
+ * @return false otherwise; path still holds the old or the new contents
+ */
+bool EARS_sdCard::writeStreamAtomic(const char* path, SdStreamWriter writer, void* context) {
+    if (!_initialized || !writer) return false;
+    
+    char temp[EARS_FS_PORT_MAX_PATH];
+    if (!EARS_atomicFile::tempPath(path, temp, sizeof(temp))) {
+        return false;
+    }
+    
+    // One writer at a time from the temporary file's creation to the rename
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    SdSealedWriter sealed = { writer, context };
+    if (!writeStream(temp, writeSealed, &sealed)) {
+        return false;
+    }
+    if (!EARS_atomicFile::commit(*this, path)) {
+        SDCARD_LOG(ERROR, "Failed to replace file: %s", path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Finish or undo a writeStreamAtomic() cut short by a reset
+ * @param path File path
+ * @return AtomicRecovery what was found and done
+ */
+AtomicRecovery EARS_sdCard::recoverFile(const char* path) {
+    if (!_initialized) return AtomicRecovery::FAILED;
+    
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    AtomicRecovery result = EARS_atomicFile::recover(*this, path);
+    switch (result) {
+        case AtomicRecovery::COMPLETED:
+            SDCARD_LOG(WARN, "Finished interrupted write: %s", path);
+            break;
+        case AtomicRecovery::DISCARDED:
+            SDCARD_LOG(WARN, "Discarded interrupted write: %s", path);
+            break;
+        case AtomicRecovery::FAILED:
+            SDCARD_LOG(ERROR, "Failed to recover file: %s", path);
+            break;
+        case AtomicRecovery::NONE:
+        default:
+            break;
+    }
+    return result;
 }
 
 /**
@@ -349,23 +1266,135 @@ bool EARS_sdCard::writeFile(const char* path, const String& content) {
 bool EARS_sdCard::appendFile(const char* path, const String& content) {
     if (!_initialized) return false;
     
-    File file = SD.open(path, FILE_APPEND);
-    if (!file) {
-        Serial.print("[SDCard] Failed to open file for appending: ");
-        Serial.println(path);
+    return writePooled(path, reinterpret_cast<const uint8_t*>(content.c_str()), content.length(), false);
+}
+
+/**
+ * @brief Append raw bytes to file
+ * @param path File path
+ * @param data Bytes to append
+ * @param length Number of bytes
+ * @return true if append successful
+ * @return false if append failed
+ */
+bool EARS_sdCard::appendFile(const char* path, const uint8_t* data, size_t length) {
+    if (!_initialized) return false;
+    
+    return writePooled(path, data, length, false);
+}
+
+/**
+ * @brief Append several pieces to file in order
+ * @param path File path
+ * @param spans Pieces to append
+ * @param count Number of pieces
+ * @return true if every piece was appended
+ * @return false if append failed
+ */
+bool EARS_sdCard::appendFile(const char* path, const SdSpan* spans, size_t count) {
+    if (!_initialized || (!spans && count > 0)) return false;
+    
+    return writeSpans(path, spans, count, false);
+}
+
+/**
+ * @brief Create or replace a file of a fixed size in one allocation
+ * @param path File path
+ * @param bytes File size; the contents are whatever the clusters held
+ * @return true if the file now has that size
+ * @return false if creating or sizing it failed
+ */
+bool EARS_sdCard::preallocateFile(const char* path, uint32_t bytes) {
+    if (!_initialized) return false;
+    
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    PathInfo before = statPath(path);
+    _pool.close(path);
+    
+    // Writing the last byte makes FatFs allocate every cluster before it
+    File file = openFile(path, FILE_WRITE);
+    bool sized = file && (bytes == 0 || (file.seek(bytes - 1) && file.write((uint8_t)0) == 1));
+    if (file) {
+        file.close();
+    }
+    if (!sized) {
+        _paths.erase(path);
+        _space.unknownChange();
+        SDCARD_LOG(ERROR, "Failed to preallocate file: %s", path);
         return false;
     }
     
-    size_t written = file.print(content);
-    file.close();
+    _paths.store(path, PathInfo(PathType::FILE, true, bytes));
+    _space.resized(before.type == PathType::FILE ? before.size : 0, bytes);
+    return true;
+}
+
+/**
+ * @brief Overwrite part of an existing file
+ * @param path File path
+ * @param offset Byte offset to start at
+ * @param data Bytes to write
+ * @param length Number of bytes
+ * @return true if all bytes were written
+ * @return false if the file is missing or the write failed
+ */
+bool EARS_sdCard::writeFileAt(const char* path, uint32_t offset, const uint8_t* data, size_t length) {
+    if (!_initialized || (!data && length > 0)) return false;
     
-    if (written == content.length()) {
-        return true;
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
+    PathInfo before = statPath(path);
+    if (before.type != PathType::FILE) {
+        return false;
     }
     
-    Serial.print("[SDCard] Append failed: ");
-    Serial.println(path);
-    return false;
+    // An appending handle ignores the position
+    int open = _pool.slotOf(path);
+    if (open >= 0 && !_placed[open]) {
+        _pool.close(path);
+    }
+    _placeAt = offset;
+    int slot = _pool.acquire(path, false);
+    _placeAt = NO_PLACE;
+    if (slot < 0) {
+        SDCARD_LOG(ERROR, "Failed to open file for writing: %s", path);
+        return false;
+    }
+    
+    File& handle = _handles[slot];
+    EARS_writeCache& cache = _caches[slot];
+    bool sequential = cache.fileSize() == offset;
+    bool cached = sequential && getDurability(path) == SdDurability::CACHED;
+    bool complete;
+    if (cached) {
+        complete = cache.append(data, length, writeHandle, &handle);
+    } else if (sequential) {
+        complete = cache.drain(writeHandle, &handle) && writeHandle(data, length, &handle);
+        cache.reset(offset + (uint32_t)length);
+    } else {
+        // Somewhere else, then back to where sequential writes continue
+        uint32_t resume = cache.fileSize();
+        complete = cache.drain(writeHandle, &handle) && handle.seek(offset) &&
+                   writeHandle(data, length, &handle) && handle.seek(resume);
+    }
+    uint32_t now = millis();
+    _pool.markDirty((uint8_t)slot, now);
+    
+    if (!complete) {
+        closeFiles();
+        _space.unknownChange();
+        SDCARD_LOG(ERROR, "Write failed: %s", path);
+        return false;
+    }
+    
+    uint32_t size = before.size > offset + length ? before.size : offset + (uint32_t)length;
+    _paths.store(path, PathInfo(PathType::FILE, true, size));
+    _space.resized(before.size, size);
+    
+    if (!cached) {
+        _pool.flush(path);
+    }
+    _pool.flushExpired(now);
+    return true;
 }
 
 /**
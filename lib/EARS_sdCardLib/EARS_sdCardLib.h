@@ -2,8 +2,8 @@
  * @file EARS_sdCardLib.h
  * @author JTB & Claude Sonnet 4.2
  * @brief SD Card wrapper library for ESP32-S3 with separate SPI bus
- * @version 1.5.0
- * @date 20260116
+ * @version 1.19.1
+ * @date 20261016
  * 
  * @copyright Copyright (c) 2026 JTB. All rights reserved.
  */
@@ -15,14 +15,64 @@
 #include <Arduino.h>
 #include <SD.h>
 #include <SPI.h>
+#include <atomic>
+#include <mutex>
+#include "EARS_fsPortLib.h"
+#include "EARS_handlePool.h"
+#include "EARS_lineReader.h"
+#include "EARS_writeCache.h"
+#include "EARS_pathCache.h"
+#include "EARS_spaceTracker.h"
+#include "EARS_dirWalker.h"
+#include "EARS_atomicFile.h"
+
+/**
+ * @brief Reads from an open file
+ * @param in The file, positioned at its start
+ * @param context Caller context
+ * @return true if reading succeeded
+ */
+typedef bool (*SdStreamReader)(Stream& in, void* context);
+
+/**
+ * @brief Writes a file's new contents
+ * @param out The emptied file
+ * @param context Caller context
+ * @return true if writing succeeded
+ */
+typedef bool (*SdStreamWriter)(Print& out, void* context);
+
+/**
+ * @brief One piece of a gathered write
+ */
+struct SdSpan {
+    const uint8_t* data;
+    size_t length;
+};
+
+/**
+ * @brief When appends to a path reach the card
+ */
+enum class SdDurability : uint8_t {
+    CACHED,         // Held in the write cache until a block fills, sync() or the dirty timeout
+    WRITE_THROUGH   // Written and committed before the call returns
+};
 
 /**
  * @brief SD Card management class
  * 
  * Handles SD card initialization and provides basic file operations
- * for the Waveshare ESP32-S3 3.5" LCD with dedicated SD card SPI bus
+ * for the Waveshare ESP32-S3 3.5" LCD with dedicated SD card SPI bus.
+ * Implements EARS_fsPort so portable file algorithms run on the card.
+ * Files written through writeFile()/appendFile() stay open in a small LRU
+ * pool; other operations on the same path flush or close them first.
+ * Appends to CACHED paths go through a per-handle write cache that writes
+ * whole WRITE_CACHE_BYTES blocks; see setDurability().
+ * fileExists(), directoryExists() and getFileSize() answer from a path
+ * metadata cache that this class's own writes, removes and renames keep
+ * current; call invalidateMetadata() if the card changes any other way.
  */
-class EARS_sdCard {
+class EARS_sdCard : public EARS_fsPort, private EARS_handleOwner {
 public:
     /**
      * @brief Construct a new EARS_sdCard object
@@ -67,10 +117,27 @@ public:
     /**
      * @brief Get SD card free space in MB
      * 
-     * @return uint64_t free space in megabytes
+     * @return uint64_t free space in megabytes, 0 until the first count finishes
+     * 
+     * Counted by a background task after begin(), then kept current from
+     * this class's writes and removes and recounted every
+     * EARS_spaceTracker::RECOUNT_INTERVAL_MS
      */
     uint64_t getFreeSpaceMB();
     
+    /**
+     * @brief Check if the free space count has finished
+     * 
+     * @return true if getFreeSpaceMB() is meaningful
+     */
+    bool isFreeSpaceKnown();
+    
+    /**
+     * @brief Get the free space tracking counters
+     * @return SpaceTrackerStats counts, changes and drift
+     */
+    SpaceTrackerStats getSpaceStats();
+    
     /**
      * @brief Create a directory on SD card
      * 
@@ -87,7 +154,22 @@ public:
      * @return true if file exists
      * @return false if file does not exist
      */
-    bool fileExists(const char* path);
+    bool fileExists(const char* path) override;
+    
+    /**
+     * @brief Get file size with a single open
+     * 
+     * @param path File path
+     * @return uint32_t file size in bytes (0 if missing or a directory)
+     */
+    uint32_t getFileSize(const char* path);
+    
+    /**
+     * @brief Number of SD.open calls made through this class
+     * 
+     * @return uint32_t open count since construction
+     */
+    uint32_t getOpenCount() const { return _openCount.load(); }
     
     /**
      * @brief Check if directory exists
@@ -105,7 +187,17 @@ public:
      * @return true if file removed
      * @return false if removal failed
      */
-    bool removeFile(const char* path);
+    bool removeFile(const char* path) override;
+    
+    /**
+     * @brief Rename a file (directory entry only, no data copied)
+     * 
+     * @param fromPath Existing file path
+     * @param toPath New file path, must not exist
+     * @return true if file renamed
+     * @return false if rename failed
+     */
+    bool renameFile(const char* fromPath, const char* toPath) override;
     
     /**
      * @brief Remove a directory
@@ -117,21 +209,109 @@ public:
     bool removeDirectory(const char* path);
     
     /**
-     * @brief List directory contents
+     * @brief Print a directory tree to Serial
      * 
      * @param path Directory path
-     * @param indent Indentation level for display
+     * @param indent Indentation level of the first level
      */
     void listDirectory(const char* path, uint8_t indent = 0);
     
+    /**
+     * @brief Walk a directory tree, parents before their contents
+     * 
+     * @param root Directory to walk
+     * @param options Depth limit, type and name suffix filters
+     * @param visitor Called for each matching entry; may remove the entry it is given
+     * @param context Passed to visitor unchanged
+     * @return WalkStats what the walk did; complete is false if root could not be opened
+     * 
+     * Pending writes are synced first so file sizes are current. Only one
+     * directory is open at a time and nothing is allocated per entry.
+     */
+    WalkStats walk(const char* root, const WalkOptions& options, DirVisitor visitor, void* context);
+    
+    /**
+     * @brief Write a directory's entry names into a buffer
+     * 
+     * @param path Directory path
+     * @param buffer Destination, one name per line, directories end in '/'
+     * @param capacity Size of buffer in bytes
+     * @return size_t bytes written, names that do not fit are left out
+     */
+    size_t listNames(const char* path, char* buffer, size_t capacity);
+    
     /**
      * @brief Read entire file into String
      * 
      * @param path File path
      * @return String file contents (empty if failed)
+     * 
+     * Sized once from the file size and filled in READ_BLOCK_BYTES reads
      */
     String readFile(const char* path);
     
+    /**
+     * @brief Read a file into a caller-owned buffer
+     * 
+     * @param path File path
+     * @param buffer Destination, e.g. a PSRAM block
+     * @param capacity Size of buffer in bytes
+     * @return size_t bytes read, at most capacity (0 if failed)
+     * 
+     * No heap use; a file larger than capacity is read up to capacity.
+     * The buffer is not NUL terminated.
+     */
+    size_t readFile(const char* path, uint8_t* buffer, size_t capacity);
+    
+    /**
+     * @brief Read a file of any size chunk by chunk
+     * 
+     * @param path File path
+     * @param buffer Chunk buffer owned by the caller
+     * @param bufferBytes Size of buffer
+     * @param visitor Called with each chunk, returns false to stop
+     * @param context Passed to visitor unchanged
+     * @return size_t bytes handed to the visitor
+     */
+    size_t readChunks(const char* path, uint8_t* buffer, size_t bufferBytes,
+                      FsChunkVisitor visitor, void* context);
+    
+    /**
+     * @brief Read a text file of any size line by line
+     * 
+     * @param path File path
+     * @param line Line buffer owned by the caller; longer lines are cut
+     * @param lineBytes Size of line
+     * @param visitor Called with each line, returns false to stop
+     * @param context Passed to visitor unchanged
+     * @return uint32_t lines handed to the visitor
+     * 
+     * No heap use: the file is read in STREAM_CHUNK_BYTES stack chunks
+     */
+    uint32_t readLines(const char* path, char* line, size_t lineBytes,
+                       FsLineVisitor visitor, void* context);
+    
+    /**
+     * @brief Hand an open file to a reader, e.g. deserializeJson(doc, in)
+     * 
+     * @param path File path
+     * @param reader Reads from the file
+     * @param context Passed to reader unchanged
+     * @return true if the file opened and the reader succeeded
+     */
+    bool readStream(const char* path, SdStreamReader reader, void* context);
+    
+    /**
+     * @brief Read part of a file into a buffer
+     * 
+     * @param path File path
+     * @param offset Byte offset to start at
+     * @param buffer Destination
+     * @param length Bytes wanted
+     * @return size_t bytes read (less at end of file, 0 if failed)
+     */
+    size_t readFileAt(const char* path, uint32_t offset, uint8_t* buffer, size_t length) override;
+    
     /**
      * @brief Write String to file (overwrites existing)
      * 
@@ -142,6 +322,53 @@ public:
      */
     bool writeFile(const char* path, const String& content);
     
+    /**
+     * @brief Write bytes to file (overwrites existing)
+     * 
+     * @param path File path
+     * @param data Bytes to write
+     * @param length Number of bytes
+     * @return true if write successful
+     * @return false if write failed
+     */
+    bool writeFile(const char* path, const uint8_t* data, size_t length);
+    
+    /**
+     * @brief Replace a file with whatever a writer prints, e.g. serializeJson(doc, out)
+     * 
+     * @param path File path
+     * @param writer Prints the new contents
+     * @param context Passed to writer unchanged
+     * @return true if the writer succeeded and every byte reached the file
+     * @return false otherwise
+     */
+    bool writeStream(const char* path, SdStreamWriter writer, void* context);
+    
+    /**
+     * @brief Replace a file all at once with whatever a writer prints
+     * 
+     * @param path File path
+     * @param writer Prints the new contents
+     * @param context Passed to writer unchanged
+     * @return true if path now holds the new contents
+     * @return false otherwise; path still holds the old or the new contents
+     * 
+     * The contents go to "<path>.tmp" sealed with a length and checksum
+     * trailer, then the old file is removed and the new one renamed into
+     * place (see EARS_atomicFile). Call recoverFile() at boot.
+     */
+    bool writeStreamAtomic(const char* path, SdStreamWriter writer, void* context);
+    
+    /**
+     * @brief Finish or undo a writeStreamAtomic() cut short by a reset
+     * 
+     * @param path File path
+     * @return AtomicRecovery what was found and done
+     * 
+     * One cached existence check when nothing was interrupted
+     */
+    AtomicRecovery recoverFile(const char* path);
+    
     /**
      * @brief Append String to file
      * 
@@ -152,9 +379,277 @@ public:
      */
     bool appendFile(const char* path, const String& content);
     
+    /**
+     * @brief Append raw bytes to file
+     * 
+     * @param path File path
+     * @param data Bytes to append
+     * @param length Number of bytes
+     * @return true if append successful
+     * @return false if append failed
+     */
+    bool appendFile(const char* path, const uint8_t* data, size_t length) override;
+    
+    /**
+     * @brief Append several pieces to file in order, without joining them first
+     * 
+     * @param path File path
+     * @param spans Pieces to append
+     * @param count Number of pieces
+     * @return true if every piece was appended
+     * @return false if append failed
+     */
+    bool appendFile(const char* path, const SdSpan* spans, size_t count);
+    
+    /**
+     * @brief Create or replace a file of a fixed size in one allocation
+     * 
+     * @param path File path
+     * @param bytes File size; the contents are whatever the clusters held
+     * @return true if the file now has that size
+     * @return false if creating or sizing it failed
+     * 
+     * Seeking past the end of a new file makes FatFs chain all its clusters
+     * at once, contiguous wherever the card has a free run that long.
+     */
+    bool preallocateFile(const char* path, uint32_t bytes) override;
+    
+    /**
+     * @brief Overwrite part of an existing file
+     * 
+     * @param path File path
+     * @param offset Byte offset to start at
+     * @param data Bytes to write
+     * @param length Number of bytes
+     * @return true if all bytes were written
+     * @return false if the file is missing or the write failed
+     * 
+     * The file stays open in the pool. A write continuing the previous
+     * one goes through the write cache like an append; any other offset
+     * (e.g. a header) is written around it and committed at once.
+     */
+    bool writeFileAt(const char* path, uint32_t offset, const uint8_t* data, size_t length) override;
+    
+    /**
+     * @brief Commit one pooled file's cached and buffered writes to the card
+     * 
+     * @param path File path
+     * @return true unless the flush failed
+     */
+    bool syncFile(const char* path) override;
+    
+    /**
+     * @brief Commit every pooled file's cached and buffered writes to the card
+     * 
+     * @return true if all flushes succeeded
+     * @return false if a flush failed
+     * 
+     * Call before a planned restart or power off
+     */
+    bool sync();
+    
+    /**
+     * @brief Set how appends to paths starting with pathPrefix reach the card
+     * 
+     * @param pathPrefix Path or directory prefix, e.g. "/logs/"
+     * @param durability CACHED or WRITE_THROUGH
+     * @return true if the rule was stored
+     * @return false if all DURABILITY_RULES are taken
+     * 
+     * The longest matching prefix wins; paths without a rule are CACHED.
+     * "/config/" is WRITE_THROUGH from the start. Whole-file writes are
+     * always committed at once.
+     */
+    bool setDurability(const char* pathPrefix, SdDurability durability);
+    
+    /**
+     * @brief Get the durability that applies to path
+     * 
+     * @param path File path
+     * @return SdDurability CACHED or WRITE_THROUGH
+     */
+    SdDurability getDurability(const char* path);
+    
+    /**
+     * @brief Flush pooled files with writes older than HANDLE_MAX_DIRTY_MS
+     * 
+     * @return void
+     * 
+     * Writes do this themselves; call it periodically (main.cpp does from
+     * loop()) so the last write before a quiet spell, and the partial
+     * block still held in its write cache, are not left unflushed
+     */
+    void flushExpired();
+    
+    /**
+     * @brief Close every pooled file
+     * 
+     * @return void
+     * 
+     * Call when the card is removed or about to be; a failed pooled write
+     * does this itself
+     */
+    void closeFiles();
+    
+    /**
+     * @brief Forget all cached path metadata
+     * 
+     * @return void
+     * 
+     * Call after a card swap or after files were changed without this
+     * class; closeFiles() and begin() do this themselves
+     */
+    void invalidateMetadata();
+    
+    /**
+     * @brief Get the path metadata cache counters
+     * @return PathCacheStats hits, misses, evictions and clears
+     */
+    PathCacheStats getPathCacheStats();
+    
+    /**
+     * @brief Get the handle pool counters
+     * @return HandlePoolStats hits, opens, evictions and flushes
+     */
+    HandlePoolStats getHandleStats();
+    
+    /**
+     * @brief Get the write cache counters, summed over the pool
+     * @return WriteCacheStats appends, card writes and bytes
+     */
+    WriteCacheStats getWriteCacheStats();
+    
 private:
+    // Files kept open for writing; SD.begin() allows 5 open files in total
+    static const uint8_t HANDLE_POOL_SIZE = 3;
+    // Longest pooled writes stay unflushed (bounds data lost to a power cut)
+    static const uint32_t HANDLE_MAX_DIRTY_MS = 1000;
+    // Write cache block per pooled handle, a multiple of the 512 B sector
+    static const size_t WRITE_CACHE_BYTES = 4096;
+    // Free space task; it only wakes to check whether a recount is due
+    static const uint32_t SPACE_TASK_STACK = 3072;
+    static const UBaseType_t SPACE_TASK_PRIORITY = 1;
+    static const BaseType_t SPACE_TASK_CORE = 0;
+    static const uint32_t SPACE_CHECK_MS = 5000;
+    // Path prefixes with their own durability
+    static const uint8_t DURABILITY_RULES = 4;
+    static const size_t DURABILITY_PREFIX_BYTES = 32;
+
+    // Largest single read; readFile(String) stages blocks of this size in PSRAM
+    static const size_t READ_BLOCK_BYTES = 16384;
+    // Stack chunk readLines() splits lines from
+    static const size_t STREAM_CHUNK_BYTES = 512;
+    // _placeAt when the next pooled open appends
+    static const uint32_t NO_PLACE = 0xFFFFFFFF;
+    
     bool _initialized;
     SPIClass* _spi;
+    std::atomic<uint32_t> _openCount;     // Logger flush task opens from Core 0
+    
+    // Handle pool state, guarded by _poolMutex
+    EARS_handlePool _pool;
+    File _handles[HANDLE_POOL_SIZE];
+    EARS_writeCache _caches[HANDLE_POOL_SIZE];
+    bool _placed[HANDLE_POOL_SIZE];       // Opened for writeFileAt(), positioned at the cache's fileSize()
+    uint32_t _placeAt;                    // Offset the next openHandle() positions at, NO_PLACE to append
+    uint8_t* _cacheStorage;               // PSRAM, HANDLE_POOL_SIZE blocks
+    std::recursive_mutex _poolMutex;
+    
+    // Type and size of recently checked paths, changed under _poolMutex
+    EARS_pathCache _paths;
+    
+    // Used space, counted by the space task and followed from writes
+    EARS_spaceTracker _space;
+    TaskHandle_t _spaceTask;
+    std::atomic<bool> _spaceStop;
+    std::atomic<bool> _spaceRunning;
+    
+    struct DurabilityRule {
+        char prefix[DURABILITY_PREFIX_BYTES];
+        SdDurability durability;
+    };
+    DurabilityRule _rules[DURABILITY_RULES];  // Empty prefix = unused, guarded by _poolMutex
+    
+    /**
+     * @brief Open a file through the SD library, counting the open
+     * @param path File path
+     * @param mode FILE_READ, FILE_WRITE or FILE_APPEND
+     * @return File handle (false if open failed)
+     */
+    File openFile(const char* path, const char* mode);
+    
+    /**
+     * @brief Write through a pooled handle
+     * @param path File path
+     * @param data Bytes to write
+     * @param length Number of bytes
+     * @param truncate true to replace the file, false to append
+     * @return true if all bytes were written
+     */
+    bool writePooled(const char* path, const uint8_t* data, size_t length, bool truncate);
+    
+    /**
+     * @brief Write several pieces through one pooled handle
+     * @param path File path
+     * @param spans Pieces to write
+     * @param count Number of pieces
+     * @param truncate true to replace the file, false to append
+     * @return true if all bytes were written
+     */
+    bool writeSpans(const char* path, const SdSpan* spans, size_t count, bool truncate);
+    
+    /**
+     * @brief Flush path's pooled handle so a separate open sees its data
+     * @param path File path
+     * @return void
+     */
+    void flushPooled(const char* path);
+    
+    /**
+     * @brief Write cache sink, appends to the File in context
+     * @param data Bytes
+     * @param length Number of bytes
+     * @param context File*
+     * @return true if every byte was written
+     */
+    static bool writeHandle(const uint8_t* data, size_t length, void* context);
+    
+    /**
+     * @brief Allocate the write cache blocks (once, after SD.begin())
+     * @return void
+     */
+    void initWriteCache();
+    
+    /**
+     * @brief Look up a path's type and size, opening it on a cache miss
+     * @param path File or directory path
+     * @return PathInfo what is at path
+     */
+    PathInfo statPath(const char* path);
+    
+    /**
+     * @brief Start the task that counts and recounts used space
+     * @return void
+     */
+    void startSpaceTask();
+    
+    /**
+     * @brief FreeRTOS task body counting used space when due
+     * @param param EARS_sdCard instance
+     * @return void
+     */
+    static void spaceTaskMain(void* param);
+    
+    /**
+     * @brief Count used space (reads the whole FAT, seconds on large cards)
+     * @return void
+     */
+    void countSpace();
+    
+    // EARS_handleOwner: the pool's slots are _handles
+    bool openHandle(uint8_t slot, const char* path, bool truncate) override;
+    bool flushHandle(uint8_t slot) override;
+    void closeHandle(uint8_t slot) override;
     
     /**
      * @brief Initialize SPI bus for SD card
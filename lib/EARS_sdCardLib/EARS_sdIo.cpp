@@ -0,0 +1,211 @@
+/**
+ * @file EARS_sdIo.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Asynchronous SD card requests served by a Core 0 task
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include "EARS_sdIo.h"
+
+/**
+ * @brief Construct a stopped request queue
+ */
+EARS_sdIo::EARS_sdIo() : _card(nullptr), _task(nullptr), _stop(false), _running(false) {
+}
+
+/**
+ * @brief Stop the task before the queue goes away
+ */
+EARS_sdIo::~EARS_sdIo() {
+    end();
+}
+
+/**
+ * @brief Start the service task
+ * @param card Initialized SD card
+ * @return true if the task is running
+ */
+bool EARS_sdIo::begin(EARS_sdCard* card) {
+    if (_running.load()) {
+        return true;
+    }
+    if (!card || !card->isAvailable() || !_service.begin(this)) {
+        return false;
+    }
+    _card = card;
+    _stop.store(false);
+    _running.store(true);
+    if (xTaskCreatePinnedToCore(taskMain, "EARS_sdIo", IO_TASK_STACK, this,
+                                IO_TASK_PRIORITY, &_task, IO_TASK_CORE) != pdPASS) {
+        _running.store(false);
+        _task = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Finish queued requests and stop the task
+ * @return void
+ */
+void EARS_sdIo::end() {
+    if (!_running.load()) {
+        return;
+    }
+    _stop.store(true);
+    _service.wake();
+    while (_running.load()) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    _task = nullptr;
+}
+
+/**
+ * @brief FreeRTOS task body serving the queue
+ * @param param EARS_sdIo instance
+ * @return void
+ */
+void EARS_sdIo::taskMain(void* param) {
+    EARS_sdIo* io = static_cast<EARS_sdIo*>(param);
+    io->_service.run(io->_stop);
+    io->_running.store(false);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Queue a request
+ * @param request Request, copied
+ * @return true if queued
+ */
+bool EARS_sdIo::submit(const IoRequest& request) {
+    if (!_running.load() || _stop.load()) {
+        return false;
+    }
+    return _service.submit(request);
+}
+
+/**
+ * @brief Build and queue a request
+ * @return true if queued
+ */
+bool EARS_sdIo::queue(IoOp op, const char* path, uint32_t offset, uint8_t* buffer, size_t length,
+                      IoPriority priority, IoCompletion done, void* context, EARS_ioInbox* inbox) {
+    IoRequest request;
+    request.op = op;
+    request.priority = priority;
+    request.path = path;
+    request.buffer = buffer;
+    request.length = length;
+    request.offset = offset;
+    request.done = done;
+    request.context = context;
+    request.inbox = inbox;
+    return submit(request);
+}
+
+/**
+ * @brief Queue a read of length bytes at offset
+ * @return true if queued
+ */
+bool EARS_sdIo::read(const char* path, uint32_t offset, uint8_t* buffer, size_t length, IoPriority priority,
+                     IoCompletion done, void* context, EARS_ioInbox* inbox) {
+    return queue(IoOp::READ, path, offset, buffer, length, priority, done, context, inbox);
+}
+
+/**
+ * @brief Queue replacing a file with data
+ * @return true if queued
+ */
+bool EARS_sdIo::write(const char* path, const uint8_t* data, size_t length, IoPriority priority,
+                      IoCompletion done, void* context, EARS_ioInbox* inbox) {
+    return queue(IoOp::WRITE, path, 0, const_cast<uint8_t*>(data), length, priority, done, context, inbox);
+}
+
+/**
+ * @brief Queue appending data to a file
+ * @return true if queued
+ */
+bool EARS_sdIo::append(const char* path, const uint8_t* data, size_t length, IoPriority priority,
+                       IoCompletion done, void* context, EARS_ioInbox* inbox) {
+    return queue(IoOp::APPEND, path, 0, const_cast<uint8_t*>(data), length, priority, done, context, inbox);
+}
+
+/**
+ * @brief Queue removing a file
+ * @return true if queued
+ */
+bool EARS_sdIo::remove(const char* path, IoPriority priority,
+                       IoCompletion done, void* context, EARS_ioInbox* inbox) {
+    return queue(IoOp::REMOVE, path, 0, nullptr, 0, priority, done, context, inbox);
+}
+
+/**
+ * @brief Queue creating a directory
+ * @return true if queued
+ */
+bool EARS_sdIo::makeDirectory(const char* path, IoPriority priority,
+                              IoCompletion done, void* context, EARS_ioInbox* inbox) {
+    return queue(IoOp::MKDIR, path, 0, nullptr, 0, priority, done, context, inbox);
+}
+
+/**
+ * @brief Queue listing a directory's entry names
+ * @return true if queued
+ */
+bool EARS_sdIo::list(const char* path, char* buffer, size_t capacity, IoPriority priority,
+                     IoCompletion done, void* context, EARS_ioInbox* inbox) {
+    return queue(IoOp::LIST, path, 0, reinterpret_cast<uint8_t*>(buffer), capacity, priority, done, context, inbox);
+}
+
+/**
+ * @brief Run one request against the SD card (service task)
+ * @param op Operation
+ * @param path File or directory path
+ * @param offset READ offset
+ * @param buffer READ/LIST destination or WRITE/APPEND source
+ * @param length Size of buffer
+ * @param transferred Receives the bytes read, written or listed
+ * @return true if the operation succeeded
+ */
+bool EARS_sdIo::ioExecute(IoOp op, const char* path, uint32_t offset,
+                          uint8_t* buffer, size_t length, size_t& transferred) {
+    switch (op) {
+        case IoOp::READ:
+            transferred = _card->readFileAt(path, offset, buffer, length);
+            // Reading at the end of a file is not a failure
+            return transferred > 0 || length == 0 || _card->fileExists(path);
+        case IoOp::WRITE:
+            transferred = _card->writeFile(path, buffer, length) ? length : 0;
+            return transferred == length;
+        case IoOp::APPEND:
+            transferred = _card->appendFile(path, buffer, length) ? length : 0;
+            return transferred == length;
+        case IoOp::REMOVE:
+            return _card->removeFile(path);
+        case IoOp::MKDIR:
+            return _card->createDirectory(path);
+        case IoOp::LIST:
+            transferred = _card->listNames(path, reinterpret_cast<char*>(buffer), length);
+            return transferred > 0 || _card->directoryExists(path);
+    }
+    return false;
+}
+
+/**
+ * @brief Get the global SD card request queue
+ * @return EARS_sdIo& Reference to the global instance
+ */
+EARS_sdIo& using_sdio() {
+    static EARS_sdIo instance;
+    return instance;
+}
+
+/****************************************************************************
+ * End of EARS_sdIo.cpp
+ ***************************************************************************/
@@ -0,0 +1,204 @@
+/**
+ * @file EARS_sdIo.h
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Asynchronous SD card requests served by a Core 0 task
+ * @version 1.0.0
+ * @date 20261016
+ *
+ * @details
+ * EARS_sdCard calls block the caller until the card answers. EARS_sdIo
+ * queues them instead: an EARS_ioService task on Core 0 runs them against
+ * using_sdcard() in priority order, and completions come back either on
+ * that task or through an EARS_ioInbox the caller dispatches from its loop.
+ *
+ * @example
+ * static EARS_ioInbox uiInbox;
+ * static uint8_t image[32768];
+ *
+ * using_sdio().read("/images/logo.bin", 0, image, sizeof(image),
+ *                   IoPriority::CRITICAL, onImageLoaded, nullptr, &uiInbox);
+ *
+ * void loop() {
+ *     uiInbox.dispatch();     // onImageLoaded runs here
+ *     lv_timer_handler();
+ * }
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#pragma once
+#ifndef __EARS_SD_IO_H__
+#define __EARS_SD_IO_H__
+
+/******************************************************************************
+ * Includes Information
+ *****************************************************************************/
+#include <Arduino.h>
+#include <atomic>
+#include "EARS_ioService.h"
+#include "EARS_sdCardLib.h"
+
+/**
+ * @brief Queues SD card requests for a background task
+ */
+class EARS_sdIo : private EARS_ioDevice {
+public:
+    EARS_sdIo();
+    ~EARS_sdIo();
+
+    /**
+     * @brief Start the service task
+     * @param card Initialized SD card
+     * @return true if the task is running
+     */
+    bool begin(EARS_sdCard* card);
+
+    /**
+     * @brief Finish queued requests and stop the task
+     * @return void
+     */
+    void end();
+
+    /**
+     * @brief Check if the service task is running
+     * @return true if requests are served
+     */
+    bool isRunning() const { return _running.load(); }
+
+    /**
+     * @brief Queue a request
+     * @param request Request, copied
+     * @return true if queued
+     * @return false if the queue is full, the task is not running or the request is invalid
+     */
+    bool submit(const IoRequest& request);
+
+    /**
+     * @brief Queue a read of length bytes at offset
+     * @param path File path
+     * @param offset Byte offset
+     * @param buffer Destination, valid until done runs
+     * @param length Bytes wanted
+     * @param priority Request priority
+     * @param done Completion, result.transferred is the bytes read
+     * @param context Passed to done unchanged
+     * @param inbox Where done runs, nullptr for the service task
+     * @return true if queued
+     */
+    bool read(const char* path, uint32_t offset, uint8_t* buffer, size_t length, IoPriority priority,
+              IoCompletion done, void* context, EARS_ioInbox* inbox = nullptr);
+
+    /**
+     * @brief Queue replacing a file with data
+     * @param path File path
+     * @param data Bytes, valid until done runs
+     * @param length Number of bytes
+     * @param priority Request priority
+     * @param done Completion, may be nullptr
+     * @param context Passed to done unchanged
+     * @param inbox Where done runs, nullptr for the service task
+     * @return true if queued
+     */
+    bool write(const char* path, const uint8_t* data, size_t length, IoPriority priority,
+               IoCompletion done, void* context, EARS_ioInbox* inbox = nullptr);
+
+    /**
+     * @brief Queue appending data to a file
+     * @param path File path
+     * @param data Bytes, valid until done runs
+     * @param length Number of bytes
+     * @param priority Request priority
+     * @param done Completion, may be nullptr
+     * @param context Passed to done unchanged
+     * @param inbox Where done runs, nullptr for the service task
+     * @return true if queued
+     */
+    bool append(const char* path, const uint8_t* data, size_t length, IoPriority priority,
+                IoCompletion done, void* context, EARS_ioInbox* inbox = nullptr);
+
+    /**
+     * @brief Queue removing a file
+     * @param path File path
+     * @param priority Request priority
+     * @param done Completion, may be nullptr
+     * @param context Passed to done unchanged
+     * @param inbox Where done runs, nullptr for the service task
+     * @return true if queued
+     */
+    bool remove(const char* path, IoPriority priority,
+                IoCompletion done, void* context, EARS_ioInbox* inbox = nullptr);
+
+    /**
+     * @brief Queue creating a directory
+     * @param path Directory path
+     * @param priority Request priority
+     * @param done Completion, may be nullptr
+     * @param context Passed to done unchanged
+     * @param inbox Where done runs, nullptr for the service task
+     * @return true if queued
+     */
+    bool makeDirectory(const char* path, IoPriority priority,
+                       IoCompletion done, void* context, EARS_ioInbox* inbox = nullptr);
+
+    /**
+     * @brief Queue listing a directory's entry names
+     * @param path Directory path
+     * @param buffer Destination, one name per line, valid until done runs
+     * @param capacity Size of buffer
+     * @param priority Request priority
+     * @param done Completion, result.transferred is the bytes listed
+     * @param context Passed to done unchanged
+     * @param inbox Where done runs, nullptr for the service task
+     * @return true if queued
+     */
+    bool list(const char* path, char* buffer, size_t capacity, IoPriority priority,
+              IoCompletion done, void* context, EARS_ioInbox* inbox = nullptr);
+
+    /**
+     * @brief Get the queue counters
+     * @return IoServiceStats per priority completions and queueing times
+     */
+    IoServiceStats getStats() { return _service.getStats(); }
+
+private:
+    static const uint32_t IO_TASK_STACK = 6144;
+    // Above the logger flush task, so UI reads are not time-sliced behind it
+    static const UBaseType_t IO_TASK_PRIORITY = 2;
+    static const BaseType_t IO_TASK_CORE = 0;
+
+    EARS_ioService _service;
+    EARS_sdCard* _card;
+    TaskHandle_t _task;
+    std::atomic<bool> _stop;
+    std::atomic<bool> _running;
+
+    /**
+     * @brief Build and queue a request
+     * @return true if queued
+     */
+    bool queue(IoOp op, const char* path, uint32_t offset, uint8_t* buffer, size_t length,
+               IoPriority priority, IoCompletion done, void* context, EARS_ioInbox* inbox);
+
+    // EARS_ioDevice: requests run against _card
+    bool ioExecute(IoOp op, const char* path, uint32_t offset,
+                   uint8_t* buffer, size_t length, size_t& transferred) override;
+
+    /**
+     * @brief FreeRTOS task body serving the queue
+     * @param param EARS_sdIo instance
+     * @return void
+     */
+    static void taskMain(void* param);
+};
+
+/**
+ * @brief Global SD card request queue
+ * @return EARS_sdIo& Reference to the global instance
+ */
+EARS_sdIo& using_sdio();
+
+#endif // __EARS_SD_IO_H__
+
+/****************************************************************************
+ * End of EARS_sdIo.h
+ ***************************************************************************/
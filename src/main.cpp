@@ -17,6 +17,7 @@
   * Includes Information
   *****************************************************************************/
 #include <Arduino.h>
+#include <esp_heap_caps.h>
 #include <lvgl.h>
 #include <Arduino_GFX_Library.h>
 #include "EARS_ws35tlcdPins.h"
@@ -32,6 +33,7 @@
 #include "EARS_screenSaverLib.h"
 #include "EARS_errorsLib.h"
 #include "EARS_backLightManagerLib.h"
+#include "EARS_configLib.h"
 
 
 // === STEP 1: Uncomment ONE library at a time ===
@@ -42,6 +44,43 @@
 EARS_nvsEeprom using_nvseeprom;
 // EARS_logger using_logger; Do not create instance - use singleton pattern
 
+static const char* CONFIG_DIR = "/config";
+static const char* CONFIG_PATH = "/config/ears.config";
+
+/**
+ * @brief Start EARS_config once the SD card is up, before any library reads it
+ * @return true if ears.config is loaded
+ *
+ * The workspace lives for the whole run: PSRAM if there is any, internal
+ * RAM otherwise.
+ */
+static bool startConfig() {
+    if (!using_sdcard().isAvailable()) {
+        Serial.println("[Config] ERROR: No SD card - settings use their defaults");
+        return false;
+    }
+    if (!using_sdcard().directoryExists(CONFIG_DIR)) {
+        using_sdcard().createDirectory(CONFIG_DIR);
+    }
+
+    size_t bytes = EARS_config::workspaceBytes();
+    uint8_t* workspace = (uint8_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!workspace) {
+        workspace = (uint8_t*)heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (!workspace) {
+        Serial.printf("[Config] ERROR: No memory for the %u byte workspace - settings use their defaults\n",
+                      (unsigned)bytes);
+        return false;
+    }
+    if (!EARS_config::getInstance().begin(using_sdcard(), CONFIG_PATH, workspace, bytes, millis())) {
+        Serial.println("[Config] ERROR: Failed to start - settings use their defaults");
+        heap_caps_free(workspace);
+        return false;
+    }
+    return true;
+}
+
 
 void setup() {
     // Initialize serial for debug output
@@ -52,7 +91,9 @@ void setup() {
     
     // === STEP 3: Initialize the library ===
     using_nvseeprom.begin();
-    EARS_logger::getInstance().begin("/logs/debug.log", "/config/ears.config", nullptr);
+    using_sdcard().begin();
+    startConfig();
+    EARS_logger::getInstance().begin("/logs/debug.log", CONFIG_PATH, &using_sdcard());
     
 
     
@@ -62,6 +103,12 @@ void setup() {
 }
 
 void loop() {
-    // Empty loop - just testing compilation and initialization
+    // Tell libraries about changed settings, write them back once they settle
+    EARS_config::getInstance().poll(millis());
+    // Same for NVS changes, one commit per change set
+    using_nvseeprom.poll(millis());
+    // Pooled files written to more than HANDLE_MAX_DIRTY_MS ago reach the
+    // card even if nothing else is written after them
+    using_sdcard().flushExpired();
     delay(1000);
 }
\ No newline at end of file
@@ -0,0 +1,315 @@
+/**
+ * @file test_host_atomic_file.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and fault injection for atomic file replacement.
+ * @section tests Tests
+ * - Trailer round trip; sealed, plain, damaged and missing files.
+ * - Recovery: finish a sealed temporary file, drop an unsealed one.
+ * - Power cut after every byte and every metadata operation of a config
+ *   save, then recovery: the file is always exactly the old or the new
+ *   contents. The same cuts against an in-place rewrite for comparison.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "EARS_atomicFile.h"
+#include "EARS_memFs.h"
+
+static const char* CONFIG_PATH = "/config/ears.config";
+static const char* TEMP_PATH = "/config/ears.config.tmp";
+
+static EARS_memFs* fs;
+
+void setUp(void) {
+    fs = new EARS_memFs();
+}
+
+void tearDown(void) {
+    delete fs;
+}
+
+/*
+  Power cut model over an EARS_memFs: every byte written and every remove
+  or rename costs one unit. When the units run out mid-append only the
+  bytes paid for reach the file, and the card is dead from then on.
+*/
+class CutFs : public EARS_fsPort {
+public:
+    CutFs(EARS_memFs& inner, int64_t units) : _inner(inner), _units(units), _used(0) {}
+
+    bool fileExists(const char* path) override {
+        return !dead() && _inner.fileExists(path);
+    }
+
+    bool removeFile(const char* path) override {
+        return spend() && _inner.removeFile(path);
+    }
+
+    bool renameFile(const char* fromPath, const char* toPath) override {
+        return spend() && _inner.renameFile(fromPath, toPath);
+    }
+
+    size_t readFileAt(const char* path, uint32_t offset, uint8_t* buffer, size_t length) override {
+        return dead() ? 0 : _inner.readFileAt(path, offset, buffer, length);
+    }
+
+    bool appendFile(const char* path, const uint8_t* data, size_t length) override {
+        if (dead()) {
+            return false;
+        }
+        size_t allowed = length;
+        if (_units >= 0 && (int64_t)length > _units - _used) {
+            allowed = (size_t)(_units - _used);
+        }
+        _used += allowed;
+        _inner.appendFile(path, data, allowed);
+        if (allowed < length) {
+            _used = _units + 1;
+            return false;
+        }
+        return true;
+    }
+
+    int64_t used() const { return _used; }
+
+private:
+    EARS_memFs& _inner;
+    int64_t _units;         // -1 = no cut
+    int64_t _used;
+
+    bool dead() const { return _units >= 0 && _used > _units; }
+
+    bool spend() {
+        if (_units >= 0 && _used >= _units) {
+            _used = _units + 1;
+            return false;
+        }
+        _used++;
+        return true;
+    }
+};
+
+/**
+ * @brief Bytes of a file before its trailer, empty if missing
+ */
+static std::string contentOf(EARS_memFs& memFs, const char* path) {
+    uint32_t contentBytes = 0;
+    AtomicFileState state = EARS_atomicFile::inspect(memFs, path, &contentBytes);
+    if (state == AtomicFileState::MISSING) {
+        return std::string();
+    }
+    return memFs.peek(path)->substr(0, contentBytes);
+}
+
+static bool atomicWrite(EARS_fsPort& port, const std::string& content) {
+    return EARS_atomicFile::write(port, CONFIG_PATH, reinterpret_cast<const uint8_t*>(content.data()),
+                                  content.size());
+}
+
+// What EARS_sdCard::writeStream did: truncating open, then the bytes
+static bool inPlaceWrite(EARS_fsPort& port, const std::string& content) {
+    if (port.fileExists(CONFIG_PATH) && !port.removeFile(CONFIG_PATH)) {
+        return false;
+    }
+    return port.appendFile(CONFIG_PATH, reinterpret_cast<const uint8_t*>(content.data()), content.size());
+}
+
+static std::string configText(const char* level, int entries) {
+    char text[512];
+    snprintf(text, sizeof(text),
+             "{\n  \"system\": {\n    \"version\": \"1.0.0\",\n    \"device_name\": \"EARS\"\n  },\n"
+             "  \"logger\": {\n    \"log_level\": \"%s\",\n    \"max_file_size_bytes\": 1048576,\n"
+             "    \"sinks\": {\n      \"memory_entries\": %d\n    }\n  }\n}", level, entries);
+    return text;
+}
+
+void test_trailer_round_trip(void) {
+    EARS_atomicFile seal;
+    const char* text = "{\"a\":1}";
+    seal.add(reinterpret_cast<const uint8_t*>(text), 3);
+    seal.add(reinterpret_cast<const uint8_t*>(text) + 3, strlen(text) - 3);
+    char trailer[EARS_atomicFile::TRAILER_BYTES + 1];
+    TEST_ASSERT_EQUAL(EARS_atomicFile::TRAILER_BYTES, seal.trailer(trailer));
+    TEST_ASSERT_EQUAL(EARS_atomicFile::TRAILER_BYTES, strlen(trailer));
+    TEST_ASSERT_EQUAL_MEMORY("\n#EAW1 00000007 ", trailer, 16);
+
+    uint32_t length;
+    uint32_t check;
+    TEST_ASSERT_TRUE(EARS_atomicFile::decodeTrailer(reinterpret_cast<const uint8_t*>(trailer), length, check));
+    TEST_ASSERT_EQUAL(7, length);
+    trailer[10] = 'G';
+    TEST_ASSERT_FALSE(EARS_atomicFile::decodeTrailer(reinterpret_cast<const uint8_t*>(trailer), length, check));
+
+    char temp[8];
+    TEST_ASSERT_FALSE(EARS_atomicFile::tempPath(CONFIG_PATH, temp, sizeof(temp)));
+}
+
+void test_inspect_states(void) {
+    uint32_t contentBytes = 99;
+    TEST_ASSERT_EQUAL((int)AtomicFileState::MISSING, (int)EARS_atomicFile::inspect(*fs, CONFIG_PATH, &contentBytes));
+    TEST_ASSERT_EQUAL(0, contentBytes);
+
+    // Shipped or edited by hand: read whole
+    std::string text = configText("INFO", 64);
+    fs->writeFile(CONFIG_PATH, text.data(), text.size());
+    TEST_ASSERT_EQUAL((int)AtomicFileState::PLAIN, (int)EARS_atomicFile::inspect(*fs, CONFIG_PATH, &contentBytes));
+    TEST_ASSERT_EQUAL(text.size(), contentBytes);
+
+    // Larger than a check chunk, so the trailer straddles reads
+    std::string big = text + std::string(600, ' ');
+    TEST_ASSERT_TRUE(atomicWrite(*fs, big));
+    TEST_ASSERT_FALSE(fs->fileExists(TEMP_PATH));
+    TEST_ASSERT_EQUAL((int)AtomicFileState::SEALED, (int)EARS_atomicFile::inspect(*fs, CONFIG_PATH, &contentBytes));
+    TEST_ASSERT_EQUAL(big.size(), contentBytes);
+    TEST_ASSERT_TRUE(contentOf(*fs, CONFIG_PATH) == big);
+
+    // One flipped byte
+    uint8_t flipped = 'X';
+    fs->writeFileAt(CONFIG_PATH, 10, &flipped, 1);
+    TEST_ASSERT_EQUAL((int)AtomicFileState::DAMAGED, (int)EARS_atomicFile::inspect(*fs, CONFIG_PATH, nullptr));
+
+    // Empty contents still seal
+    TEST_ASSERT_TRUE(atomicWrite(*fs, std::string()));
+    TEST_ASSERT_EQUAL((int)AtomicFileState::SEALED, (int)EARS_atomicFile::inspect(*fs, CONFIG_PATH, &contentBytes));
+    TEST_ASSERT_EQUAL(0, contentBytes);
+}
+
+void test_recovery_cases(void) {
+    std::string oldText = configText("DEBUG", 64);
+    std::string newText = configText("WARN", 32);
+    TEST_ASSERT_EQUAL((int)AtomicRecovery::NONE, (int)EARS_atomicFile::recover(*fs, CONFIG_PATH));
+
+    // Sealed temporary next to the old file: finished
+    fs->writeFile(CONFIG_PATH, oldText.data(), oldText.size());
+    EARS_atomicFile seal;
+    seal.add(reinterpret_cast<const uint8_t*>(newText.data()), newText.size());
+    char trailer[EARS_atomicFile::TRAILER_BYTES + 1];
+    seal.trailer(trailer);
+    fs->writeFile(TEMP_PATH, (newText + trailer).data(), newText.size() + EARS_atomicFile::TRAILER_BYTES);
+    TEST_ASSERT_EQUAL((int)AtomicRecovery::COMPLETED, (int)EARS_atomicFile::recover(*fs, CONFIG_PATH));
+    TEST_ASSERT_TRUE(contentOf(*fs, CONFIG_PATH) == newText);
+    TEST_ASSERT_FALSE(fs->fileExists(TEMP_PATH));
+
+    // Unsealed temporary: dropped
+    fs->writeFile(TEMP_PATH, oldText.data(), 20);
+    TEST_ASSERT_EQUAL((int)AtomicRecovery::DISCARDED, (int)EARS_atomicFile::recover(*fs, CONFIG_PATH));
+    TEST_ASSERT_TRUE(contentOf(*fs, CONFIG_PATH) == newText);
+    TEST_ASSERT_FALSE(fs->fileExists(TEMP_PATH));
+
+    // Unsealed temporary and no file: left alone for inspection
+    fs->removeFile(CONFIG_PATH);
+    fs->writeFile(TEMP_PATH, oldText.data(), 20);
+    TEST_ASSERT_EQUAL((int)AtomicRecovery::FAILED, (int)EARS_atomicFile::recover(*fs, CONFIG_PATH));
+    TEST_ASSERT_TRUE(fs->fileExists(TEMP_PATH));
+
+    // A later save replaces the leftover
+    TEST_ASSERT_TRUE(atomicWrite(*fs, oldText));
+    TEST_ASSERT_TRUE(contentOf(*fs, CONFIG_PATH) == oldText);
+}
+
+/**
+ * @brief Cut a save at every unit, recover, and classify the result
+ * @param atomic Atomic or in-place write
+ * @param points Receives the number of cut points tried
+ * @param corrupt Receives the cut points leaving neither old nor new
+ * @param lost Receives the cut points where a save reporting success was lost
+ */
+static void cutEverywhere(bool atomic, int& points, int& corrupt, int& lost) {
+    std::string oldText = configText("DEBUG", 64);
+    std::string newText = configText("WARN", 32);
+
+    // Units one uncut save takes
+    EARS_memFs probe;
+    atomicWrite(probe, oldText);
+    CutFs measure(probe, -1);
+    if (atomic) {
+        atomicWrite(measure, newText);
+    } else {
+        inPlaceWrite(measure, newText);
+    }
+    int64_t total = measure.used();
+
+    points = 0;
+    corrupt = 0;
+    lost = 0;
+    for (int64_t units = 0; units <= total; units++) {
+        EARS_memFs card;
+        atomicWrite(card, oldText);
+        CutFs cut(card, units);
+        bool reported = atomic ? atomicWrite(cut, newText) : inPlaceWrite(cut, newText);
+
+        // Next boot
+        EARS_atomicFile::recover(card, CONFIG_PATH);
+        std::string after = contentOf(card, CONFIG_PATH);
+        bool intact = card.fileExists(CONFIG_PATH) && (after == oldText || after == newText);
+        if (!intact) {
+            corrupt++;
+        }
+        if (reported && after != newText) {
+            lost++;
+        }
+        if (atomic) {
+            TEST_ASSERT_FALSE(card.fileExists(TEMP_PATH));
+        }
+        points++;
+    }
+}
+
+void test_power_cut_at_every_byte(void) {
+    int points;
+    int corrupt;
+    int lost;
+    cutEverywhere(true, points, corrupt, lost);
+    TEST_ASSERT_TRUE(points > (int)configText("WARN", 32).size());
+    TEST_ASSERT_EQUAL(0, corrupt);
+    TEST_ASSERT_EQUAL(0, lost);
+}
+
+void benchmark_cut_points(void) {
+    int atomicPoints;
+    int atomicCorrupt;
+    int atomicLost;
+    cutEverywhere(true, atomicPoints, atomicCorrupt, atomicLost);
+    int inPlacePoints;
+    int inPlaceCorrupt;
+    int inPlaceLost;
+    cutEverywhere(false, inPlacePoints, inPlaceCorrupt, inPlaceLost);
+
+    // Operations per save after the first, from the memFs counters
+    std::string text = configText("WARN", 32);
+    EARS_memFs counted;
+    atomicWrite(counted, text);
+    counted.resetStats();
+    inPlaceWrite(counted, text);
+    MemFsStats inPlace = counted.getStats();
+    counted.resetStats();
+    atomicWrite(counted, text);
+    MemFsStats atomic = counted.getStats();
+
+    printf("[bench] in place: %d of %d cut points leave a corrupt file, %u writes, %u metadata ops, %u bytes\n",
+           inPlaceCorrupt, inPlacePoints, (unsigned)inPlace.writes, (unsigned)inPlace.metadataOps,
+           (unsigned)inPlace.bytesWritten);
+    printf("[bench] atomic:   %d of %d cut points leave a corrupt file, %u writes, %u metadata ops, %u bytes\n",
+           atomicCorrupt, atomicPoints, (unsigned)atomic.writes, (unsigned)atomic.metadataOps,
+           (unsigned)atomic.bytesWritten);
+
+    TEST_ASSERT_TRUE(inPlaceCorrupt > 0);
+    TEST_ASSERT_EQUAL(0, atomicCorrupt);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_trailer_round_trip);
+    RUN_TEST(test_inspect_states);
+    RUN_TEST(test_recovery_cases);
+    RUN_TEST(test_power_cut_at_every_byte);
+    RUN_TEST(benchmark_cut_points);
+    return UNITY_END();
+}
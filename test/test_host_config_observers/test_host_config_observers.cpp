@@ -0,0 +1,311 @@
+/**
+ * @file test_host_config_observers.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for config change observers.
+ * @section tests Tests
+ * - Changed keys per field, text compared up to the terminator.
+ * - A burst of changes is one call per observer with the final values.
+ * - Observers only hear about their keys; changed-back values are silent.
+ * - Loaded values reach early subscribers; setters inside observers.
+ * - Subscription limit and unsubscribe.
+ * - Per-tick cost: getter lookups vs cached values and an idle dispatch.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "EARS_configLib.h"
+#include "EARS_memFs.h"
+
+static const char* CONFIG_PATH = "/config/ears.config";
+
+static EARS_memFs* fs;
+static std::vector<uint8_t> workspace;
+
+/**
+ * @brief What a library keeps: its values and how often it was told
+ */
+struct Follower {
+    int calls;
+    ConfigKeyMask lastKeys;
+    uint8_t brightness;
+    uint16_t timeoutSeconds;
+    char logLevel[8];
+};
+
+static void followDisplay(ConfigKeyMask changed, const ConfigModel& model, void* context) {
+    Follower* follower = static_cast<Follower*>(context);
+    follower->calls++;
+    follower->lastKeys = changed;
+    follower->brightness = model.display.brightness;
+    follower->timeoutSeconds = model.display.timeoutSeconds;
+}
+
+static void followLogger(ConfigKeyMask changed, const ConfigModel& model, void* context) {
+    Follower* follower = static_cast<Follower*>(context);
+    follower->calls++;
+    follower->lastKeys = changed;
+    strcpy(follower->logLevel, model.logger.logLevel);
+}
+
+void setUp(void) {
+    fs = new EARS_memFs();
+    workspace.assign(EARS_config::workspaceBytes(), 0);
+}
+
+void tearDown(void) {
+    delete fs;
+}
+
+static bool beginService(EARS_config& config) {
+    return config.begin(*fs, CONFIG_PATH, workspace.data(), workspace.size(), 0);
+}
+
+static void setBrightness(EARS_config& config, uint8_t brightness) {
+    DisplaySettings display = config.display();
+    display.brightness = brightness;
+    config.setDisplay(display, 0);
+}
+
+void test_changed_keys(void) {
+    ConfigModel before;
+    ConfigModel after;
+    TEST_ASSERT_TRUE(EARS_configChangedKeys(before, after, 0xff) == 0);
+
+    after.display.brightness = 10;
+    after.display.theme[0] = 'x';
+    strcpy(after.logger.logLevel, "WARN");
+    ConfigKeyMask expected = EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS) |
+                             EARS_configKeyBit(ConfigKey::DISPLAY_THEME) |
+                             EARS_configKeyBit(ConfigKey::LOGGER_LOG_LEVEL);
+    TEST_ASSERT_TRUE(EARS_configChangedKeys(before, after, 0xff) == expected);
+    TEST_ASSERT_TRUE(EARS_configChangedKeys(before, after, 1u << (uint32_t)ConfigSection::LOGGER) ==
+                     EARS_configKeyBit(ConfigKey::LOGGER_LOG_LEVEL));
+
+    // Bytes after the terminator do not count
+    ConfigModel padded;
+    padded.system.version[10] = 'z';
+    TEST_ASSERT_TRUE(EARS_configChangedKeys(before, padded, 0xff) == 0);
+
+    after = before;
+    after.logger.setTagLevel("SDCARD", "WARN");
+    TEST_ASSERT_TRUE(EARS_configChangedKeys(before, after, 0xff) == EARS_configKeyBit(ConfigKey::LOGGER_TAG_LEVELS));
+    before = after;
+    after.logger.setTagLevel("SDCARD", "ERROR");
+    TEST_ASSERT_TRUE(EARS_configChangedKeys(before, after, 0xff) == EARS_configKeyBit(ConfigKey::LOGGER_TAG_LEVELS));
+
+    TEST_ASSERT_TRUE((size_t)ConfigKey::COUNT <= sizeof(ConfigKeyMask) * 8);
+}
+
+void test_burst_is_one_call_with_final_values(void) {
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config));
+    Follower display = {};
+    TEST_ASSERT_TRUE(config.subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS) |
+                                      EARS_configKeyBit(ConfigKey::DISPLAY_TIMEOUT_SECONDS),
+                                      followDisplay, &display));
+    config.dispatch();
+    TEST_ASSERT_EQUAL(0, display.calls);
+
+    for (int i = 0; i < 50; i++) {
+        setBrightness(config, (uint8_t)(20 + i));
+    }
+    DisplaySettings settings = config.display();
+    settings.timeoutSeconds = 90;
+    config.setDisplay(settings, 0);
+    config.dispatch();
+    TEST_ASSERT_EQUAL(1, display.calls);
+    TEST_ASSERT_EQUAL(69, display.brightness);
+    TEST_ASSERT_EQUAL(90, display.timeoutSeconds);
+    TEST_ASSERT_TRUE(display.lastKeys == (EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS) |
+                                          EARS_configKeyBit(ConfigKey::DISPLAY_TIMEOUT_SECONDS)));
+
+    config.dispatch();
+    TEST_ASSERT_EQUAL(1, display.calls);
+    TEST_ASSERT_EQUAL(51, config.getStats().changes);
+    TEST_ASSERT_EQUAL(1, config.getStats().notifications);
+}
+
+void test_only_subscribed_keys_are_reported(void) {
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config));
+    Follower display = {};
+    Follower logger = {};
+    config.subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS), followDisplay, &display);
+    config.subscribe(EARS_configKeyBit(ConfigKey::LOGGER_LOG_LEVEL), followLogger, &logger);
+
+    // Another display key
+    DisplaySettings settings = config.display();
+    strcpy(settings.theme, "dark");
+    config.setDisplay(settings, 0);
+    config.dispatch();
+    TEST_ASSERT_EQUAL(0, display.calls);
+
+    // Changed and changed back within one tick
+    setBrightness(config, 10);
+    setBrightness(config, 80);
+    config.dispatch();
+    TEST_ASSERT_EQUAL(0, display.calls);
+
+    LoggerSettings level = config.logger();
+    strcpy(level.logLevel, "ERROR");
+    config.setLogger(level, 0);
+    setBrightness(config, 11);
+    config.poll(0);
+    TEST_ASSERT_EQUAL(1, display.calls);
+    TEST_ASSERT_EQUAL(1, logger.calls);
+    TEST_ASSERT_EQUAL_STRING("ERROR", logger.logLevel);
+    TEST_ASSERT_TRUE(logger.lastKeys == EARS_configKeyBit(ConfigKey::LOGGER_LOG_LEVEL));
+}
+
+void test_loaded_values_reach_early_subscribers(void) {
+    {
+        EARS_config writer;
+        TEST_ASSERT_TRUE(beginService(writer));
+        setBrightness(writer, 35);
+        TEST_ASSERT_TRUE(writer.flush());
+    }
+
+    // Subscribed (and read the defaults) before the file was loaded
+    EARS_config config;
+    Follower display = {};
+    display.brightness = config.display().brightness;
+    config.subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS), followDisplay, &display);
+    config.dispatch();
+    TEST_ASSERT_EQUAL(0, display.calls);
+    TEST_ASSERT_EQUAL(80, display.brightness);
+
+    TEST_ASSERT_TRUE(beginService(config));
+    config.dispatch();
+    TEST_ASSERT_EQUAL(1, display.calls);
+    TEST_ASSERT_EQUAL(35, display.brightness);
+}
+
+/**
+ * @brief Observer that clamps brightness through the setter
+ */
+static void clampBrightness(ConfigKeyMask changed, const ConfigModel& model, void* context) {
+    EARS_config* config = static_cast<EARS_config*>(context);
+    (void)changed;
+    if (model.display.brightness < 10) {
+        setBrightness(*config, 10);
+    }
+}
+
+void test_setters_inside_observers(void) {
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config));
+    Follower display = {};
+    config.subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS), clampBrightness, &config);
+    config.subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS), followDisplay, &display);
+
+    setBrightness(config, 2);
+    config.dispatch();
+    TEST_ASSERT_EQUAL(2, display.brightness);
+    TEST_ASSERT_EQUAL(10, config.display().brightness);
+
+    // The correction goes out on the next tick
+    config.dispatch();
+    TEST_ASSERT_EQUAL(2, display.calls);
+    TEST_ASSERT_EQUAL(10, display.brightness);
+    config.dispatch();
+    TEST_ASSERT_EQUAL(2, display.calls);
+}
+
+void test_subscription_limit_and_unsubscribe(void) {
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config));
+    Follower followers[EARS_config::MAX_OBSERVERS + 1] = {};
+    for (size_t i = 0; i < EARS_config::MAX_OBSERVERS; i++) {
+        TEST_ASSERT_TRUE(config.subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS), followDisplay,
+                                          &followers[i]));
+    }
+    TEST_ASSERT_FALSE(config.subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS), followDisplay,
+                                       &followers[EARS_config::MAX_OBSERVERS]));
+    TEST_ASSERT_FALSE(config.subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS), nullptr, nullptr));
+
+    config.unsubscribe(followDisplay, &followers[0]);
+    config.unsubscribe(followDisplay, &followers[0]);
+    setBrightness(config, 50);
+    config.dispatch();
+    TEST_ASSERT_EQUAL(0, followers[0].calls);
+    for (size_t i = 1; i < EARS_config::MAX_OBSERVERS; i++) {
+        TEST_ASSERT_EQUAL(1, followers[i].calls);
+    }
+    TEST_ASSERT_TRUE(config.subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS), followDisplay,
+                                      &followers[EARS_config::MAX_OBSERVERS]));
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  A UI tick where backlight, screensaver and logger each need a setting.
+  Lookup: every tick copies each library's section out under the lock.
+  Observers: every tick is one dispatch(); the libraries read their own
+  copies. One brightness change every 1000 ticks.
+*/
+void benchmark_ui_tick(void) {
+    const int ticks = 1000000;
+    EARS_config config;
+    beginService(config);
+    config.dispatch();
+
+    volatile uint32_t sink = 0;
+    uint64_t start = nowNs();
+    for (int i = 0; i < ticks; i++) {
+        if (i % 1000 == 0) {
+            setBrightness(config, (uint8_t)(i / 1000 % 100));
+        }
+        sink += config.display().brightness;
+        sink += config.display().timeoutSeconds;
+        sink += (uint32_t)config.logger().logLevel[0];
+    }
+    uint64_t lookupNs = nowNs() - start;
+
+    Follower display = {};
+    Follower logger = {};
+    config.subscribe(EARS_configKeyBit(ConfigKey::DISPLAY_BRIGHTNESS) |
+                     EARS_configKeyBit(ConfigKey::DISPLAY_TIMEOUT_SECONDS), followDisplay, &display);
+    config.subscribe(EARS_configKeyBit(ConfigKey::LOGGER_LOG_LEVEL), followLogger, &logger);
+    start = nowNs();
+    for (int i = 0; i < ticks; i++) {
+        if (i % 1000 == 0) {
+            setBrightness(config, (uint8_t)(100 - i / 1000 % 100));
+        }
+        config.dispatch();
+        sink += display.brightness;
+        sink += display.timeoutSeconds;
+        sink += (uint32_t)logger.logLevel[0];
+    }
+    uint64_t observerNs = nowNs() - start;
+    ConfigStats stats = config.getStats();
+
+    printf("[bench] getter lookups:       %.1f ns/tick\n", (double)lookupNs / ticks);
+    printf("[bench] observers + dispatch: %.1f ns/tick, %u dispatches, %u observer calls\n",
+           (double)observerNs / ticks, (unsigned)stats.dispatches, (unsigned)stats.notifications);
+    TEST_ASSERT_EQUAL(ticks / 1000, display.calls);
+    TEST_ASSERT_EQUAL(0, logger.calls);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_changed_keys);
+    RUN_TEST(test_burst_is_one_call_with_final_values);
+    RUN_TEST(test_only_subscribed_keys_are_reported);
+    RUN_TEST(test_loaded_values_reach_early_subscribers);
+    RUN_TEST(test_setters_inside_observers);
+    RUN_TEST(test_subscription_limit_and_unsubscribe);
+    RUN_TEST(benchmark_ui_tick);
+    return UNITY_END();
+}
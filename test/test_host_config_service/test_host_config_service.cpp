@@ -0,0 +1,590 @@
+/**
+ * @file test_host_config_service.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the central ears.config service.
+ * @section tests Tests
+ * - The shipped ears.config decodes into the model and encodes back byte for byte.
+ * - Reader: escapes, unknown keys, arrays, nesting, trailer, malformed input.
+ * - Members the model does not know survive a section rewrite.
+ * - A file at the size limit, with its seal, loads; a maximum-size config
+ *   round-trips.
+ * - Missing file and missing sections get their defaults written.
+ * - Debounce, maximum delay, unchanged values, section-only re-encoding,
+ *   write failure retry, recovery of an interrupted save, concurrent use.
+ * - Burst of setting changes: reload/rewrite per change vs the service.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "EARS_configLib.h"
+#include "EARS_configJson.h"
+#include "EARS_memFs.h"
+
+static const char* CONFIG_PATH = "/config/ears.config";
+
+// data/config/ears.config as shipped, less its final newline
+static const char* SHIPPED =
+    "{\n"
+    "  \"system\": {\n"
+    "    \"version\": \"1.0.0\",\n"
+    "    \"zap_number\": \"\",\n"
+    "    \"device_name\": \"EARS\",\n"
+    "    \"created\": \"2025-01-05\",\n"
+    "    \"last_modified\": \"2025-01-05\"\n"
+    "  },\n"
+    "  \"logger\": {\n"
+    "    \"log_level\": \"DEBUG\",\n"
+    "    \"max_file_size_bytes\": 1048576,\n"
+    "    \"max_rotated_files\": 3,\n"
+    "    \"async\": true,\n"
+    "    \"async_buffer_bytes\": 65536,\n"
+    "    \"overflow_policy\": \"DROP_OLDEST\",\n"
+    "    \"log_format\": \"TEXT\",\n"
+    "    \"compress_rotated\": false,\n"
+    "    \"preallocate\": false,\n"
+    "    \"timestamp_precision\": \"SECONDS\",\n"
+    "    \"sinks\": {\n"
+    "      \"sd\": \"DEBUG\",\n"
+    "      \"serial\": \"INFO\",\n"
+    "      \"memory\": \"DEBUG\",\n"
+    "      \"memory_entries\": 64\n"
+    "    },\n"
+    "    \"tag_levels\": {\n"
+    "      \"APP\": \"DEBUG\",\n"
+    "      \"LOGGER\": \"DEBUG\",\n"
+    "      \"SDCARD\": \"DEBUG\",\n"
+    "      \"NVS\": \"DEBUG\",\n"
+    "      \"BACKLIGHT\": \"DEBUG\",\n"
+    "      \"SCREENSAVER\": \"DEBUG\",\n"
+    "      \"ERRORS\": \"DEBUG\",\n"
+    "      \"FLOW\": \"DEBUG\"\n"
+    "    }\n"
+    "  },\n"
+    "  \"display\": {\n"
+    "    \"brightness\": 80,\n"
+    "    \"timeout_seconds\": 30,\n"
+    "    \"theme\": \"default\"\n"
+    "  },\n"
+    "  \"network\": {\n"
+    "    \"wifi_enabled\": false,\n"
+    "    \"ssid\": \"\",\n"
+    "    \"auto_connect\": false\n"
+    "  },\n"
+    "  \"security\": {\n"
+    "    \"require_password\": true,\n"
+    "    \"auto_lock_minutes\": 5\n"
+    "  },\n"
+    "  \"application\": {\n"
+    "    \"units\": \"metric\",\n"
+    "    \"language\": \"en\",\n"
+    "    \"date_format\": \"YYYY-MM-DD\",\n"
+    "    \"time_format\": \"24h\"\n"
+    "  }\n"
+    "}";
+
+static EARS_memFs* fs;
+static std::vector<uint8_t> workspace;
+
+void setUp(void) {
+    fs = new EARS_memFs();
+    workspace.assign(EARS_config::workspaceBytes(), 0);
+}
+
+void tearDown(void) {
+    delete fs;
+}
+
+/**
+ * @brief Assemble a whole file from the model, as the service writes it
+ */
+static std::string encodeAll(const ConfigModel& model) {
+    std::string text = "{\n";
+    char section[EARS_config::SECTION_BYTES];
+    for (size_t i = 0; i < (size_t)ConfigSection::COUNT; i++) {
+        size_t length = EARS_configEncodeSection((ConfigSection)i, model, section, sizeof(section));
+        TEST_ASSERT_TRUE(length > 0);
+        if (i > 0) {
+            text += ",\n";
+        }
+        text.append(section, length);
+    }
+    return text + "\n}";
+}
+
+/**
+ * @brief Decode whatever the card holds now
+ */
+static ConfigModel modelOnCard() {
+    ConfigModel model;
+    uint32_t present = 0;
+    std::string text;
+    TEST_ASSERT_TRUE(fs->readFile(CONFIG_PATH, text));
+    TEST_ASSERT_TRUE(EARS_configDecode(text.data(), text.size(), model, present));
+    return model;
+}
+
+static bool beginService(EARS_config& config, uint32_t nowMs) {
+    return config.begin(*fs, CONFIG_PATH, workspace.data(), workspace.size(), nowMs);
+}
+
+void test_shipped_file_round_trip(void) {
+    ConfigModel model;
+    uint32_t present = 0;
+    TEST_ASSERT_TRUE(EARS_configDecode(SHIPPED, strlen(SHIPPED), model, present));
+    TEST_ASSERT_EQUAL((1u << (uint32_t)ConfigSection::COUNT) - 1, present);
+    TEST_ASSERT_EQUAL_STRING("2025-01-05", model.system.created);
+    TEST_ASSERT_TRUE(model.logger.async);
+    TEST_ASSERT_EQUAL(1048576, model.logger.maxFileSizeBytes);
+    TEST_ASSERT_EQUAL_STRING("INFO", model.logger.serialLevel);
+    TEST_ASSERT_EQUAL(8, model.logger.tagCount);
+    TEST_ASSERT_EQUAL_STRING("FLOW", model.logger.tags[7].name);
+    TEST_ASSERT_EQUAL(80, model.display.brightness);
+    TEST_ASSERT_TRUE(model.security.requirePassword);
+    TEST_ASSERT_EQUAL_STRING("24h", model.application.timeFormat);
+
+    // Same layout as serializeJsonPretty wrote
+    TEST_ASSERT_EQUAL_STRING(SHIPPED, encodeAll(model).c_str());
+
+    // The longest values still fit a section
+    ConfigModel longest;
+    memset(longest.logger.overflowPolicy, 'P', sizeof(longest.logger.overflowPolicy) - 1);
+    for (int i = 0; i < EARS_CONFIG_MAX_TAGS; i++) {
+        char name[24];
+        snprintf(name, sizeof(name), "TAG_NAME_NUM_%02d", i % 100);
+        TEST_ASSERT_TRUE(longest.logger.setTagLevel(name, "WARNING"));
+    }
+    TEST_ASSERT_FALSE(longest.logger.setTagLevel("ONE_TOO_MANY", "INFO"));
+    char section[EARS_config::SECTION_BYTES];
+    TEST_ASSERT_TRUE(EARS_configEncodeSection(ConfigSection::LOGGER, longest, section, sizeof(section)) > 0);
+}
+
+void test_reader_edge_cases(void) {
+    const char* text =
+        "{ \"system\": { \"device_name\": \"a\\\"b\\\\c\\u0041\\n\", \"extra\": [1, {\"x\": 2}, \"y\"],"
+        "  \"deep\": {\"a\": {\"b\": {\"c\": {\"d\": 1}}}} },"
+        "  \"unknown\": { \"brightness\": 5 },"
+        "  \"display\": { \"brightness\": 250, \"timeout_seconds\": -3, \"theme\": \"abcdefghijklmnopqrstuvwxyz\" } }"
+        "\n#EAW1 00000000 00000000\n";
+    ConfigModel model;
+    uint32_t present = 0;
+    TEST_ASSERT_TRUE(EARS_configDecode(text, strlen(text), model, present));
+    TEST_ASSERT_EQUAL((1u << (uint32_t)ConfigSection::SYSTEM) | (1u << (uint32_t)ConfigSection::DISPLAY), present);
+    TEST_ASSERT_EQUAL_STRING("a\"b\\cA\n", model.system.deviceName);
+    TEST_ASSERT_EQUAL(100, model.display.brightness);
+    TEST_ASSERT_EQUAL(0, model.display.timeoutSeconds);
+    TEST_ASSERT_EQUAL_STRING("abcdefghijklmno", model.display.theme);
+
+    // Escapes survive a write and a read
+    char section[EARS_config::SECTION_BYTES];
+    size_t length = EARS_configEncodeSection(ConfigSection::SYSTEM, model, section, sizeof(section));
+    std::string wrapped = "{\n" + std::string(section, length) + "\n}";
+    ConfigModel again;
+    TEST_ASSERT_TRUE(EARS_configDecode(wrapped.data(), wrapped.size(), again, present));
+    TEST_ASSERT_TRUE(again.system == model.system);
+
+    const char* broken[] = {
+        "", "[]", "{", "{\"a\" 1}", "{\"a\": tru}", "{\"a\": \"x}", "{\"a\": 1,}", "{\"a\": -}",
+        "{\"a\": [1, 2}", "{\"a\": \"\\q\"}"
+    };
+    for (size_t i = 0; i < sizeof(broken) / sizeof(broken[0]); i++) {
+        TEST_ASSERT_FALSE(EARS_configDecode(broken[i], strlen(broken[i]), model, present));
+    }
+    std::string nested(EARS_configJsonReader::MAX_NESTING + 1, '[');
+    nested = "{\"a\": " + nested;
+    TEST_ASSERT_FALSE(EARS_configDecode(nested.data(), nested.size(), model, present));
+}
+
+void test_missing_file_gets_defaults(void) {
+    EARS_config config;
+    TEST_ASSERT_FALSE(config.begin(*fs, CONFIG_PATH, workspace.data(), workspace.size() - 1, 0));
+    TEST_ASSERT_TRUE(beginService(config, 0));
+    TEST_ASSERT_TRUE(config.isLoaded());
+    TEST_ASSERT_FALSE(config.isDirty());
+
+    ConfigStats stats = config.getStats();
+    TEST_ASSERT_EQUAL(0, stats.parses);
+    TEST_ASSERT_EQUAL(1, stats.parseFailures);
+    TEST_ASSERT_EQUAL(1, stats.writes);
+    TEST_ASSERT_EQUAL(6, stats.serializes);
+    TEST_ASSERT_EQUAL((int)AtomicFileState::SEALED, (int)EARS_atomicFile::inspect(*fs, CONFIG_PATH, nullptr));
+    ConfigModel defaults;
+    TEST_ASSERT_EQUAL_STRING(encodeAll(defaults).c_str(), encodeAll(modelOnCard()).c_str());
+
+    // Garbage is replaced the same way
+    fs->writeFile(CONFIG_PATH, "{ not json", 10);
+    EARS_config again;
+    TEST_ASSERT_TRUE(beginService(again, 0));
+    TEST_ASSERT_EQUAL(1, again.getStats().parses);
+    TEST_ASSERT_EQUAL(1, again.getStats().parseFailures);
+    TEST_ASSERT_EQUAL(1, again.getStats().writes);
+}
+
+void test_missing_section_written_after_debounce(void) {
+    std::string text = SHIPPED;
+    size_t start = text.find(",\n  \"security\"");
+    size_t end = text.find(",\n  \"application\"");
+    text.erase(start, end - start);
+    fs->writeFile(CONFIG_PATH, text.data(), text.size());
+
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config, 1000));
+    TEST_ASSERT_EQUAL(1, config.getStats().parses);
+    TEST_ASSERT_TRUE(config.isDirty(ConfigSection::SECURITY));
+    TEST_ASSERT_FALSE(config.isDirty(ConfigSection::LOGGER));
+    TEST_ASSERT_FALSE(config.poll(1000 + EARS_config::DEBOUNCE_MS - 1));
+    TEST_ASSERT_EQUAL(0, config.getStats().writes);
+    TEST_ASSERT_TRUE(config.poll(1000 + EARS_config::DEBOUNCE_MS));
+    TEST_ASSERT_EQUAL(1, config.getStats().writes);
+
+    ConfigModel onCard = modelOnCard();
+    TEST_ASSERT_TRUE(onCard.security == SecuritySettings());
+    TEST_ASSERT_TRUE(onCard.logger == config.logger());
+    TEST_ASSERT_TRUE(config.poll(100000));
+    TEST_ASSERT_EQUAL(1, config.getStats().writes);
+}
+
+void test_debounce_max_delay_and_unchanged_values(void) {
+    fs->writeFile(CONFIG_PATH, SHIPPED, strlen(SHIPPED));
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config, 0));
+    TEST_ASSERT_FALSE(config.isDirty());
+
+    // Same values: nothing to do
+    config.setDisplay(config.display(), 10);
+    config.setLogger(config.logger(), 10);
+    TEST_ASSERT_FALSE(config.isDirty());
+    TEST_ASSERT_EQUAL(0, config.getStats().changes);
+
+    // A change every 500 ms never goes quiet; MAX_DELAY_MS forces the write
+    uint32_t now = 1000;
+    uint32_t writtenAt = 0;
+    for (int i = 0; i < 40 && writtenAt == 0; i++, now += 500) {
+        DisplaySettings display = config.display();
+        display.brightness = (uint8_t)(10 + i);
+        config.setDisplay(display, now);
+        config.poll(now);
+        if (config.getStats().writes > 0) {
+            writtenAt = now;
+        }
+    }
+    TEST_ASSERT_EQUAL(1000 + EARS_config::MAX_DELAY_MS, writtenAt);
+    TEST_ASSERT_EQUAL(modelOnCard().display.brightness, config.display().brightness);
+}
+
+void test_only_dirty_sections_are_encoded(void) {
+    fs->writeFile(CONFIG_PATH, SHIPPED, strlen(SHIPPED));
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config, 0));
+
+    DisplaySettings display = config.display();
+    display.brightness = 42;
+    config.setDisplay(display, 0);
+    TEST_ASSERT_TRUE(config.flush());
+    // First write encodes everything once
+    TEST_ASSERT_EQUAL(6, config.getStats().serializes);
+
+    LoggerSettings logger = config.logger();
+    strcpy(logger.logLevel, "WARN");
+    logger.setTagLevel("SDCARD", "ERROR");
+    config.setLogger(logger, 10);
+    display.brightness = 43;
+    config.setDisplay(display, 10);
+    TEST_ASSERT_TRUE(config.flush());
+    TEST_ASSERT_EQUAL(8, config.getStats().serializes);
+    TEST_ASSERT_EQUAL(2, config.getStats().writes);
+
+    ConfigModel onCard = modelOnCard();
+    TEST_ASSERT_EQUAL_STRING("WARN", onCard.logger.logLevel);
+    TEST_ASSERT_EQUAL_STRING("ERROR", onCard.logger.tags[2].level);
+    TEST_ASSERT_EQUAL(43, onCard.display.brightness);
+    TEST_ASSERT_EQUAL_STRING("2025-01-05", onCard.system.created);
+}
+
+void test_unknown_members_survive_rewrite(void) {
+    std::string text = SHIPPED;
+    text.insert(text.find("\n  },\n  \"logger\""), ",\n    \"serial_number\": \"A-17\"");
+    text.insert(text.find("\n    },\n    \"tag_levels\""), ",\n      \"udp\": {\"host\": \"10.0.0.2\", \"port\": 514}");
+    text.insert(text.find("\n    }\n  },\n  \"display\""), ",\n      \"WIFI\": 3");
+    text.insert(text.find("\n  },\n  \"network\""), ",\n    \"curve\": [0, 10, 40, 100]");
+    text.insert(text.size() - 2, ",\n  \"future\": {\"enabled\": true}");
+    fs->writeFile(CONFIG_PATH, text.data(), text.size());
+
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config, 0));
+    TEST_ASSERT_EQUAL(0, config.getStats().unknownDropped);
+    DisplaySettings display = config.display();
+    display.brightness = 42;
+    config.setDisplay(display, 0);
+    LoggerSettings logger = config.logger();
+    strcpy(logger.logLevel, "WARN");
+    config.setLogger(logger, 0);
+    SystemSettings system = config.system();
+    strcpy(system.deviceName, "BENCH");
+    config.setSystem(system, 0);
+    TEST_ASSERT_TRUE(config.flush());
+
+    // Back where they were, as written, after the known members
+    std::string onCard;
+    TEST_ASSERT_TRUE(fs->readFile(CONFIG_PATH, onCard));
+    const char* kept[] = {
+        "    \"last_modified\": \"2025-01-05\",\n    \"serial_number\": \"A-17\"\n  },",
+        "      \"memory_entries\": 64,\n      \"udp\": {\"host\": \"10.0.0.2\", \"port\": 514}\n    },",
+        "      \"FLOW\": \"DEBUG\",\n      \"WIFI\": 3\n    }\n  },",
+        "    \"theme\": \"default\",\n    \"curve\": [0, 10, 40, 100]\n  },",
+        "  },\n  \"future\": {\"enabled\": true}\n}"
+    };
+    for (size_t i = 0; i < sizeof(kept) / sizeof(kept[0]); i++) {
+        TEST_ASSERT_TRUE_MESSAGE(onCard.find(kept[i]) != std::string::npos, kept[i]);
+    }
+    ConfigModel model = modelOnCard();
+    TEST_ASSERT_EQUAL(42, model.display.brightness);
+    TEST_ASSERT_EQUAL_STRING("BENCH", model.system.deviceName);
+
+    // A snapshot boot keeps them too
+    EARS_config again;
+    TEST_ASSERT_TRUE(beginService(again, 0));
+    TEST_ASSERT_EQUAL(1, again.getStats().snapshotLoads);
+    display.brightness = 43;
+    again.setDisplay(display, 0);
+    TEST_ASSERT_TRUE(again.flush());
+    std::string rewritten;
+    TEST_ASSERT_TRUE(fs->readFile(CONFIG_PATH, rewritten));
+    for (size_t i = 0; i < sizeof(kept) / sizeof(kept[0]); i++) {
+        TEST_ASSERT_TRUE_MESSAGE(rewritten.find(kept[i]) != std::string::npos, kept[i]);
+    }
+
+    // What does not fit is counted, not silently lost
+    std::string crowded = SHIPPED;
+    std::string filler(EARS_CONFIG_EXTRA_BYTES, 'x');
+    crowded.insert(crowded.find("\n  },\n  \"logger\""), ",\n    \"notes\": \"" + filler + "\"");
+    ConfigModel full;
+    uint32_t present = 0;
+    TEST_ASSERT_TRUE(EARS_configDecode(crowded.data(), crowded.size(), full, present));
+    TEST_ASSERT_EQUAL(1, full.extras.dropped);
+}
+
+void test_maximum_size_config_round_trip(void) {
+    // Contents at the limit, sealed like every save: still loaded
+    std::string text = SHIPPED;
+    text.replace(text.find("\"brightness\": 80"), 16, "\"brightness\": 61");
+    text.insert(text.size() - 1, EARS_config::CONTENT_BYTES - text.size(), ' ');
+    TEST_ASSERT_EQUAL(EARS_config::CONTENT_BYTES, text.size());
+    TEST_ASSERT_TRUE(EARS_atomicFile::write(*fs, CONFIG_PATH, reinterpret_cast<const uint8_t*>(text.data()),
+                                            text.size()));
+
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config, 0));
+    TEST_ASSERT_EQUAL(0, config.getStats().parseFailures);
+    TEST_ASSERT_EQUAL(61, config.display().brightness);
+    TEST_ASSERT_FALSE(config.isDirty());
+
+    // Longest values and a full unknown member budget, written and read back
+    std::string crowded = SHIPPED;
+    std::string filler(EARS_CONFIG_EXTRA_BYTES - 11, 'x');
+    crowded.insert(crowded.find("\n  },\n  \"logger\""), ",\n    \"notes\": \"" + filler + "\"");
+    fs->writeFile(CONFIG_PATH, crowded.data(), crowded.size());
+
+    EARS_config full;
+    TEST_ASSERT_TRUE(beginService(full, 0));
+    TEST_ASSERT_EQUAL(0, full.getStats().unknownDropped);
+    SystemSettings system = full.system();
+    memset(system.deviceName, 'd', sizeof(system.deviceName) - 1);
+    full.setSystem(system, 0);
+    NetworkSettings network = full.network();
+    memset(network.ssid, 's', sizeof(network.ssid) - 1);
+    full.setNetwork(network, 0);
+    TEST_ASSERT_TRUE(full.flush());
+
+    EARS_config again;
+    TEST_ASSERT_TRUE(beginService(again, 0));
+    TEST_ASSERT_EQUAL(0, again.getStats().parseFailures);
+    TEST_ASSERT_EQUAL(0, again.getStats().unknownDropped);
+    TEST_ASSERT_EQUAL_STRING(system.deviceName, again.system().deviceName);
+    TEST_ASSERT_EQUAL_STRING(network.ssid, again.network().ssid);
+    std::string onCard;
+    TEST_ASSERT_TRUE(fs->readFile(CONFIG_PATH, onCard));
+    TEST_ASSERT_TRUE(onCard.find(filler) != std::string::npos);
+}
+
+void test_write_failure_is_retried(void) {
+    fs->writeFile(CONFIG_PATH, SHIPPED, strlen(SHIPPED));
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config, 0));
+    NetworkSettings network = config.network();
+    strcpy(network.ssid, "workshop");
+    config.setNetwork(network, 0);
+
+    fs->setOperationBudget(0);
+    TEST_ASSERT_FALSE(config.poll(EARS_config::DEBOUNCE_MS));
+    TEST_ASSERT_EQUAL(1, config.getStats().writeFailures);
+    TEST_ASSERT_TRUE(config.isDirty(ConfigSection::NETWORK));
+
+    // Not hammered: next try one debounce later
+    fs->setOperationBudget(-1);
+    TEST_ASSERT_FALSE(config.poll(EARS_config::DEBOUNCE_MS + 1));
+    TEST_ASSERT_EQUAL(0, config.getStats().writes);
+    TEST_ASSERT_TRUE(config.poll(2 * EARS_config::DEBOUNCE_MS));
+    TEST_ASSERT_EQUAL_STRING("workshop", modelOnCard().network.ssid);
+}
+
+void test_interrupted_save_recovered_at_begin(void) {
+    // Sealed temporary file left by a cut between sealing and rename
+    std::string newer = SHIPPED;
+    newer.replace(newer.find("\"brightness\": 80"), 16, "\"brightness\": 55");
+    EARS_atomicFile::write(*fs, CONFIG_PATH, reinterpret_cast<const uint8_t*>(SHIPPED), strlen(SHIPPED));
+    EARS_atomicFile seal;
+    seal.add(reinterpret_cast<const uint8_t*>(newer.data()), newer.size());
+    char trailer[EARS_atomicFile::TRAILER_BYTES + 1];
+    seal.trailer(trailer);
+    newer += trailer;
+    fs->writeFile("/config/ears.config.tmp", newer.data(), newer.size());
+
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config, 0));
+    TEST_ASSERT_EQUAL((int)AtomicRecovery::COMPLETED, (int)config.getStats().recovery);
+    TEST_ASSERT_EQUAL(55, config.display().brightness);
+    TEST_ASSERT_FALSE(config.isDirty());
+}
+
+void test_concurrent_setters_and_write_back(void) {
+    fs->writeFile(CONFIG_PATH, SHIPPED, strlen(SHIPPED));
+    EARS_config config;
+    TEST_ASSERT_TRUE(beginService(config, 0));
+
+    std::thread display([&config]() {
+        for (int i = 1; i <= 2000; i++) {
+            DisplaySettings value = config.display();
+            value.timeoutSeconds = (uint16_t)i;
+            config.setDisplay(value, (uint32_t)i);
+        }
+    });
+    std::thread security([&config]() {
+        for (int i = 1; i <= 2000; i++) {
+            SecuritySettings value = config.security();
+            value.autoLockMinutes = (uint16_t)i;
+            config.setSecurity(value, (uint32_t)i);
+        }
+    });
+    std::thread writer([&config]() {
+        for (int i = 0; i < 50; i++) {
+            config.flush();
+        }
+    });
+    display.join();
+    security.join();
+    writer.join();
+
+    TEST_ASSERT_TRUE(config.flush());
+    ConfigModel onCard = modelOnCard();
+    TEST_ASSERT_EQUAL(2000, onCard.display.timeoutSeconds);
+    TEST_ASSERT_EQUAL(2000, onCard.security.autoLockMinutes);
+    TEST_ASSERT_EQUAL(4000, config.getStats().changes);
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  A brightness slider dragged through 40 steps and a few log level
+  toggles, 20 ms apart. Before: every change reloaded the file, parsed the
+  whole document, serialized it again and rewrote it (as saveConfig() did).
+*/
+void benchmark_setting_burst(void) {
+    const int changes = 48;
+
+    fs->writeFile(CONFIG_PATH, SHIPPED, strlen(SHIPPED));
+    fs->resetStats();
+    uint32_t parses = 0;
+    uint32_t serializes = 0;
+    uint64_t start = nowNs();
+    for (int i = 0; i < changes; i++) {
+        std::string text;
+        fs->readFile(CONFIG_PATH, text);
+        ConfigModel model;
+        uint32_t present;
+        EARS_configDecode(text.data(), text.size(), model, present);
+        parses++;
+        if (i % 8 == 7) {
+            strcpy(model.logger.logLevel, (i / 8) % 2 ? "DEBUG" : "INFO");
+        } else {
+            model.display.brightness = (uint8_t)(30 + i);
+        }
+        std::string out = encodeAll(model);
+        serializes += (uint32_t)ConfigSection::COUNT;
+        EARS_atomicFile::write(*fs, CONFIG_PATH, reinterpret_cast<const uint8_t*>(out.data()), out.size());
+    }
+    uint64_t reloadNs = nowNs() - start;
+    MemFsStats reloadFs = fs->getStats();
+
+    fs->writeFile(CONFIG_PATH, SHIPPED, strlen(SHIPPED));
+    fs->resetStats();
+    EARS_config config;
+    start = nowNs();
+    beginService(config, 0);
+    uint64_t bootNs = nowNs() - start;
+    uint32_t now = 0;
+    start = nowNs();
+    for (int i = 0; i < changes; i++, now += 20) {
+        if (i % 8 == 7) {
+            LoggerSettings logger = config.logger();
+            strcpy(logger.logLevel, (i / 8) % 2 ? "DEBUG" : "INFO");
+            config.setLogger(logger, now);
+        } else {
+            DisplaySettings display = config.display();
+            display.brightness = (uint8_t)(30 + i);
+            config.setDisplay(display, now);
+        }
+        config.poll(now);
+    }
+    uint64_t setNs = nowNs() - start;
+    start = nowNs();
+    config.poll(now + EARS_config::DEBOUNCE_MS);
+    uint64_t writeNs = nowNs() - start;
+    ConfigStats stats = config.getStats();
+    MemFsStats serviceFs = fs->getStats();
+
+    printf("[bench] %d changes, reload per change: %u parses, %u section encodes, %u file writes, "
+           "%llu bytes written, %.1f us/change\n",
+           changes, (unsigned)parses, (unsigned)serializes, (unsigned)reloadFs.writes / 2,
+           (unsigned long long)reloadFs.bytesWritten, reloadNs / 1000.0 / changes);
+    printf("[bench] %d changes, config service:   %u parses, %u section encodes, %u file writes, "
+           "%llu bytes written, %.2f us/change, boot %.1f us, write-back %.1f us\n",
+           changes, (unsigned)stats.parses, (unsigned)stats.serializes, (unsigned)stats.writes,
+           (unsigned long long)serviceFs.bytesWritten, setNs / 1000.0 / changes, bootNs / 1000.0,
+           writeNs / 1000.0);
+
+    TEST_ASSERT_EQUAL(1, stats.parses);
+    TEST_ASSERT_EQUAL(1, stats.writes);
+    TEST_ASSERT_EQUAL(changes, stats.changes);
+    TEST_ASSERT_TRUE(stats.serializes <= (uint32_t)ConfigSection::COUNT);
+    TEST_ASSERT_EQUAL(30 + changes - 2, modelOnCard().display.brightness);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_shipped_file_round_trip);
+    RUN_TEST(test_reader_edge_cases);
+    RUN_TEST(test_missing_file_gets_defaults);
+    RUN_TEST(test_missing_section_written_after_debounce);
+    RUN_TEST(test_debounce_max_delay_and_unchanged_values);
+    RUN_TEST(test_only_dirty_sections_are_encoded);
+    RUN_TEST(test_unknown_members_survive_rewrite);
+    RUN_TEST(test_maximum_size_config_round_trip);
+    RUN_TEST(test_write_failure_is_retried);
+    RUN_TEST(test_interrupted_save_recovered_at_begin);
+    RUN_TEST(test_concurrent_setters_and_write_back);
+    RUN_TEST(benchmark_setting_burst);
+    return UNITY_END();
+}
@@ -0,0 +1,278 @@
+/**
+ * @file test_host_config_snapshot.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the ears.config boot snapshot.
+ * @section tests Tests
+ * - Seal/match: length, checksum, magic, layout and torn images are refused.
+ * - An unchanged file boots from the snapshot; a write-back refreshes it.
+ * - A hand edit, a damaged or missing snapshot fall back to parsing.
+ * - Sections missing from the file stay dirty across a snapshot boot.
+ * - Cold boot load time: JSON parse vs snapshot.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "EARS_configLib.h"
+#include "EARS_configSnapshot.h"
+#include "EARS_memFs.h"
+
+static const char* CONFIG_PATH = "/config/ears.config";
+static const char* SNAPSHOT_PATH = "/config/ears.config.snap";
+
+static EARS_memFs* fs;
+static std::vector<uint8_t> workspace;
+
+/**
+ * @brief A model like the shipped ears.config
+ */
+static ConfigModel shippedModel() {
+    ConfigModel model;
+    strcpy(model.system.created, "2025-01-05");
+    strcpy(model.system.lastModified, "2025-01-05");
+    model.logger.async = true;
+    strcpy(model.logger.serialLevel, "INFO");
+    const char* tags[] = {"APP", "LOGGER", "SDCARD", "NVS", "BACKLIGHT", "SCREENSAVER", "ERRORS", "FLOW"};
+    for (size_t i = 0; i < sizeof(tags) / sizeof(tags[0]); i++) {
+        model.logger.setTagLevel(tags[i], "DEBUG");
+    }
+    return model;
+}
+
+/**
+ * @brief Encode every section into a file, as the service writes it
+ */
+static std::string encodeAll(const ConfigModel& model, uint32_t sections) {
+    std::string text = "{\n";
+    char section[EARS_config::SECTION_BYTES];
+    for (size_t i = 0; i < (size_t)ConfigSection::COUNT; i++) {
+        if (!(sections & (1u << i))) {
+            continue;
+        }
+        size_t length = EARS_configEncodeSection((ConfigSection)i, model, section, sizeof(section));
+        if (text.size() > 2) {
+            text += ",\n";
+        }
+        text.append(section, length);
+    }
+    return text + "\n}";
+}
+
+static const uint32_t ALL = (1u << (uint32_t)ConfigSection::COUNT) - 1;
+
+void setUp(void) {
+    fs = new EARS_memFs();
+    workspace.assign(EARS_config::workspaceBytes(), 0);
+    std::string text = encodeAll(shippedModel(), ALL);
+    fs->writeFile(CONFIG_PATH, text.data(), text.size());
+}
+
+void tearDown(void) {
+    delete fs;
+}
+
+static bool beginService(EARS_config& config) {
+    return config.begin(*fs, CONFIG_PATH, workspace.data(), workspace.size(), 0);
+}
+
+void test_seal_and_match(void) {
+    ConfigSnapshot snapshot;
+    snapshot.model = shippedModel();
+    EARS_configSnapshotSeal(snapshot, ALL, 1200, 0x12345678);
+    TEST_ASSERT_TRUE(EARS_configSnapshotMatches(snapshot, sizeof(snapshot), 1200, 0x12345678));
+    TEST_ASSERT_FALSE(EARS_configSnapshotMatches(snapshot, sizeof(snapshot) - 1, 1200, 0x12345678));
+    TEST_ASSERT_FALSE(EARS_configSnapshotMatches(snapshot, sizeof(snapshot), 1201, 0x12345678));
+    TEST_ASSERT_FALSE(EARS_configSnapshotMatches(snapshot, sizeof(snapshot), 1200, 0x12345679));
+
+    ConfigSnapshot changed = snapshot;
+    changed.model.display.brightness++;
+    TEST_ASSERT_FALSE(EARS_configSnapshotMatches(changed, sizeof(changed), 1200, 0x12345678));
+    changed = snapshot;
+    changed.header.layout++;
+    EARS_configSnapshotSeal(changed, ALL, 1200, 0x12345678);
+    TEST_ASSERT_TRUE(EARS_configSnapshotMatches(changed, sizeof(changed), 1200, 0x12345678));
+    changed.header.layout++;
+    TEST_ASSERT_FALSE(EARS_configSnapshotMatches(changed, sizeof(changed), 1200, 0x12345678));
+    changed = snapshot;
+    changed.header.magic[0] = 'X';
+    TEST_ASSERT_FALSE(EARS_configSnapshotMatches(changed, sizeof(changed), 1200, 0x12345678));
+
+    char path[16];
+    TEST_ASSERT_FALSE(EARS_configSnapshotPath("/config/ears.config", path, sizeof(path)));
+    TEST_ASSERT_TRUE(EARS_configSnapshotPath("/c.json", path, sizeof(path)));
+    TEST_ASSERT_EQUAL_STRING("/c.json.snap", path);
+}
+
+void test_unchanged_file_boots_from_snapshot(void) {
+    EARS_config first;
+    TEST_ASSERT_TRUE(beginService(first));
+    TEST_ASSERT_EQUAL(1, first.getStats().parses);
+    TEST_ASSERT_EQUAL(0, first.getStats().snapshotLoads);
+    TEST_ASSERT_EQUAL(1, first.getStats().snapshotWrites);
+    TEST_ASSERT_TRUE(fs->fileExists(SNAPSHOT_PATH));
+
+    EARS_config second;
+    TEST_ASSERT_TRUE(beginService(second));
+    TEST_ASSERT_EQUAL(0, second.getStats().parses);
+    TEST_ASSERT_EQUAL(1, second.getStats().snapshotLoads);
+    TEST_ASSERT_EQUAL(0, second.getStats().snapshotWrites);
+    TEST_ASSERT_FALSE(second.isDirty());
+    TEST_ASSERT_TRUE(second.logger() == first.logger());
+    TEST_ASSERT_TRUE(second.system() == first.system());
+
+    // A write-back refreshes the snapshot for the sealed file
+    DisplaySettings display = second.display();
+    display.brightness = 33;
+    second.setDisplay(display, 0);
+    TEST_ASSERT_TRUE(second.flush());
+    TEST_ASSERT_EQUAL(1, second.getStats().snapshotWrites);
+
+    EARS_config third;
+    TEST_ASSERT_TRUE(beginService(third));
+    TEST_ASSERT_EQUAL(0, third.getStats().parses);
+    TEST_ASSERT_EQUAL(1, third.getStats().snapshotLoads);
+    TEST_ASSERT_EQUAL(33, third.display().brightness);
+}
+
+void test_stale_or_damaged_snapshot_falls_back(void) {
+    EARS_config first;
+    TEST_ASSERT_TRUE(beginService(first));
+
+    // Edited on a PC: same length, different value
+    std::string text;
+    TEST_ASSERT_TRUE(fs->readFile(CONFIG_PATH, text));
+    text.replace(text.find("\"brightness\": 80"), 16, "\"brightness\": 55");
+    fs->writeFile(CONFIG_PATH, text.data(), text.size());
+    EARS_config edited;
+    TEST_ASSERT_TRUE(beginService(edited));
+    TEST_ASSERT_EQUAL(1, edited.getStats().parses);
+    TEST_ASSERT_EQUAL(55, edited.display().brightness);
+    TEST_ASSERT_EQUAL(1, edited.getStats().snapshotWrites);
+
+    // Torn snapshot
+    std::string image;
+    TEST_ASSERT_TRUE(fs->readFile(SNAPSHOT_PATH, image));
+    fs->writeFile(SNAPSHOT_PATH, image.data(), image.size() / 2);
+    EARS_config torn;
+    TEST_ASSERT_TRUE(beginService(torn));
+    TEST_ASSERT_EQUAL(1, torn.getStats().parses);
+    TEST_ASSERT_EQUAL(55, torn.display().brightness);
+
+    // Flipped bit in the model
+    TEST_ASSERT_TRUE(fs->readFile(SNAPSHOT_PATH, image));
+    image[sizeof(ConfigSnapshotHeader) + 3] ^= 0x10;
+    fs->writeFile(SNAPSHOT_PATH, image.data(), image.size());
+    EARS_config flipped;
+    TEST_ASSERT_TRUE(beginService(flipped));
+    TEST_ASSERT_EQUAL(1, flipped.getStats().parses);
+
+    // Gone
+    fs->removeFile(SNAPSHOT_PATH);
+    EARS_config missing;
+    TEST_ASSERT_TRUE(beginService(missing));
+    TEST_ASSERT_EQUAL(1, missing.getStats().parses);
+    TEST_ASSERT_TRUE(fs->fileExists(SNAPSHOT_PATH));
+
+    // The config file is the source of truth: no file, no snapshot use
+    fs->removeFile(CONFIG_PATH);
+    EARS_config defaults;
+    TEST_ASSERT_TRUE(beginService(defaults));
+    TEST_ASSERT_EQUAL(0, defaults.getStats().snapshotLoads);
+    TEST_ASSERT_EQUAL(80, defaults.display().brightness);
+    TEST_ASSERT_FALSE(defaults.logger().async);
+}
+
+void test_missing_sections_stay_dirty(void) {
+    uint32_t sections = ALL & ~(1u << (uint32_t)ConfigSection::NETWORK);
+    std::string text = encodeAll(shippedModel(), sections);
+    fs->writeFile(CONFIG_PATH, text.data(), text.size());
+
+    EARS_config first;
+    TEST_ASSERT_TRUE(beginService(first));
+    TEST_ASSERT_TRUE(first.isDirty(ConfigSection::NETWORK));
+
+    // Rebooted before the debounce wrote them
+    EARS_config second;
+    TEST_ASSERT_TRUE(beginService(second));
+    TEST_ASSERT_EQUAL(1, second.getStats().snapshotLoads);
+    TEST_ASSERT_TRUE(second.isDirty(ConfigSection::NETWORK));
+    TEST_ASSERT_FALSE(second.isDirty(ConfigSection::LOGGER));
+    TEST_ASSERT_TRUE(second.flush());
+
+    EARS_config third;
+    TEST_ASSERT_TRUE(beginService(third));
+    TEST_ASSERT_EQUAL(1, third.getStats().snapshotLoads);
+    TEST_ASSERT_FALSE(third.isDirty());
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  Cold boot with the shipped settings: begin() as far as the first getter.
+  JSON is the first boot after the file changed (parse and snapshot
+  write); the snapshot boot reads both files, checks the config file and
+  copies the model.
+*/
+void benchmark_cold_boot_load(void) {
+    const int boots = 2000;
+    {
+        EARS_config prime;
+        beginService(prime);
+    }
+
+    std::string text;
+    fs->readFile(CONFIG_PATH, text);
+    uint64_t start = nowNs();
+    for (int i = 0; i < boots; i++) {
+        ConfigModel model;
+        uint32_t present;
+        EARS_configDecode(text.data(), text.size(), model, present);
+    }
+    uint64_t parseNs = nowNs() - start;
+
+    uint64_t jsonNs = 0;
+    for (int i = 0; i < boots; i++) {
+        fs->removeFile(SNAPSHOT_PATH);
+        EARS_config config;
+        start = nowNs();
+        beginService(config);
+        jsonNs += nowNs() - start;
+        TEST_ASSERT_EQUAL(1, config.getStats().parses);
+    }
+
+    uint64_t snapshotNs = 0;
+    for (int i = 0; i < boots; i++) {
+        EARS_config config;
+        start = nowNs();
+        beginService(config);
+        snapshotNs += nowNs() - start;
+        TEST_ASSERT_EQUAL(1, config.getStats().snapshotLoads);
+    }
+
+    printf("[bench] config file %u bytes, snapshot %u bytes\n", (unsigned)text.size(),
+           (unsigned)sizeof(ConfigSnapshot));
+    printf("[bench] JSON parse only:            %.2f us\n", parseNs / 1000.0 / boots);
+    printf("[bench] begin(), JSON + new snapshot: %.2f us\n", jsonNs / 1000.0 / boots);
+    printf("[bench] begin(), snapshot:            %.2f us\n", snapshotNs / 1000.0 / boots);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_seal_and_match);
+    RUN_TEST(test_unchanged_file_boots_from_snapshot);
+    RUN_TEST(test_stale_or_damaged_snapshot_falls_back);
+    RUN_TEST(test_missing_sections_stay_dirty);
+    RUN_TEST(benchmark_cold_boot_load);
+    return UNITY_END();
+}
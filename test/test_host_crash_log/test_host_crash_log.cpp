@@ -0,0 +1,238 @@
+/**
+ * @file test_host_crash_log.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the reboot-surviving crash log.
+ * @section tests Tests
+ * - A simulated region keeps the last entries across a "reboot", oldest first.
+ * - Power-on garbage and a damaged header are rejected by magic and CRC.
+ * - Slots torn by a crash mid-write are skipped.
+ * - Entries are cut to the slot size.
+ * - Cost of mirroring one entry.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "EARS_crashLogLib.h"
+
+/*
+  The simulated .noinit region. A "reboot" is a new EARS_crashLog over the
+  same bytes.
+*/
+static const size_t REGION_BYTES = 1024;
+static const size_t SLOT_BYTES = 64;
+alignas(4) static uint8_t region[REGION_BYTES];
+
+static void collect(const char* data, size_t length, void* context) {
+    static_cast<std::vector<std::string>*>(context)->push_back(std::string(data, length));
+}
+
+static std::vector<std::string> reboot(EARS_crashLog& log) {
+    std::vector<std::string> entries;
+    TEST_ASSERT_TRUE(log.begin(region, sizeof(region), SLOT_BYTES));
+    TEST_ASSERT_EQUAL(log.recoveredCount(), log.recover(collect, &entries));
+    return entries;
+}
+
+static void appendLine(EARS_crashLog& log, int number) {
+    char line[32];
+    int length = snprintf(line, sizeof(line), "line %d\n", number);
+    log.append(line, (size_t)length);
+}
+
+void setUp(void) {
+    // Power-on RAM content
+    for (size_t i = 0; i < sizeof(region); i++) {
+        region[i] = (uint8_t)(i * 131 + 7);
+    }
+}
+
+void tearDown(void) {
+}
+
+void test_first_boot_recovers_nothing(void) {
+    EARS_crashLog log;
+    std::vector<std::string> entries = reboot(log);
+    TEST_ASSERT_EQUAL(0, entries.size());
+    TEST_ASSERT_EQUAL(0, log.recoveredFlags());
+
+    // A started but empty session is valid and still empty
+    log.startSession(1, 42);
+    EARS_crashLog next;
+    TEST_ASSERT_EQUAL(0, reboot(next).size());
+}
+
+void test_entries_survive_reboot(void) {
+    EARS_crashLog log;
+    reboot(log);
+    log.startSession(7, 0x123456789ULL);
+    for (int i = 0; i < 5; i++) {
+        appendLine(log, i);
+    }
+
+    EARS_crashLog next;
+    std::vector<std::string> entries = reboot(next);
+    TEST_ASSERT_EQUAL(5, entries.size());
+    TEST_ASSERT_EQUAL_STRING("line 0\n", entries[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("line 4\n", entries[4].c_str());
+    TEST_ASSERT_EQUAL(7, next.recoveredFlags());
+    TEST_ASSERT_TRUE(next.recoveredBaseUs() == 0x123456789ULL);
+
+    // Starting the next session clears what was recovered
+    next.startSession(0, 0);
+    EARS_crashLog third;
+    TEST_ASSERT_EQUAL(0, reboot(third).size());
+}
+
+void test_wraparound_keeps_newest(void) {
+    EARS_crashLog log;
+    reboot(log);
+    log.startSession(0, 0);
+    const int total = (int)log.slotCount() * 3 + 5;
+    for (int i = 0; i < total; i++) {
+        appendLine(log, i);
+    }
+
+    EARS_crashLog next;
+    std::vector<std::string> entries = reboot(next);
+    TEST_ASSERT_EQUAL(log.slotCount(), entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        char expected[32];
+        snprintf(expected, sizeof(expected), "line %d\n", total - (int)entries.size() + (int)i);
+        TEST_ASSERT_EQUAL_STRING(expected, entries[i].c_str());
+    }
+}
+
+void test_damaged_header_is_rejected(void) {
+    EARS_crashLog log;
+    reboot(log);
+    log.startSession(0, 0);
+    appendLine(log, 1);
+
+    // Flip one bit of the time base: magic still matches, CRC does not
+    region[offsetof(CrashLogHeader, baseUsLow)] ^= 0x01;
+    EARS_crashLog next;
+    TEST_ASSERT_EQUAL(0, reboot(next).size());
+
+    // Wrong magic
+    region[offsetof(CrashLogHeader, baseUsLow)] ^= 0x01;
+    region[0] ^= 0xFF;
+    EARS_crashLog third;
+    TEST_ASSERT_EQUAL(0, reboot(third).size());
+
+    // Different geometry than the one the session was written with
+    region[0] ^= 0xFF;
+    EARS_crashLog fourth;
+    TEST_ASSERT_TRUE(fourth.begin(region, sizeof(region), SLOT_BYTES * 2));
+    TEST_ASSERT_EQUAL(0, fourth.recoveredCount());
+}
+
+void test_torn_slot_is_skipped(void) {
+    EARS_crashLog log;
+    reboot(log);
+    log.startSession(0, 0);
+    for (int i = 0; i < 4; i++) {
+        appendLine(log, i);
+    }
+
+    // Crash while the third entry's slot was being rewritten
+    uint32_t busy = EARS_crashLog::BUSY;
+    memcpy(region + sizeof(CrashLogHeader) + 2 * SLOT_BYTES, &busy, sizeof(busy));
+    // And a slot whose commit word does not match its position
+    uint32_t misplaced = 3;
+    memcpy(region + sizeof(CrashLogHeader) + 0 * SLOT_BYTES, &misplaced, sizeof(misplaced));
+
+    EARS_crashLog next;
+    std::vector<std::string> entries = reboot(next);
+    TEST_ASSERT_EQUAL(2, entries.size());
+    TEST_ASSERT_EQUAL_STRING("line 1\n", entries[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("line 3\n", entries[1].c_str());
+}
+
+void test_long_entry_is_cut(void) {
+    EARS_crashLog log;
+    reboot(log);
+    log.startSession(0, 0);
+    std::string longLine(200, 'x');
+    log.append(longLine.c_str(), longLine.size());
+    TEST_ASSERT_EQUAL(1, log.getStats().truncated);
+    TEST_ASSERT_EQUAL(1, log.getStats().appended);
+
+    EARS_crashLog next;
+    std::vector<std::string> entries = reboot(next);
+    TEST_ASSERT_EQUAL(1, entries.size());
+    TEST_ASSERT_EQUAL(log.slotPayloadBytes(), entries[0].size());
+}
+
+void test_invalid_parameters(void) {
+    EARS_crashLog log;
+    TEST_ASSERT_FALSE(log.begin(nullptr, sizeof(region), SLOT_BYTES));
+    TEST_ASSERT_FALSE(log.begin(region + 1, sizeof(region) - 1, SLOT_BYTES));
+    TEST_ASSERT_FALSE(log.begin(region, sizeof(region), 6));
+    TEST_ASSERT_FALSE(log.begin(region, sizeof(region), 66));
+    TEST_ASSERT_FALSE(log.begin(region, sizeof(CrashLogHeader), SLOT_BYTES));
+
+    // Never started: append must not touch the region
+    uint8_t before[REGION_BYTES];
+    memcpy(before, region, sizeof(region));
+    log.append("x", 1);
+    TEST_ASSERT_EQUAL_MEMORY(before, region, sizeof(region));
+}
+
+void test_crc32_reference(void) {
+    const char* check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, EARS_crashLog::crc32((const uint8_t*)check, 9));
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  Mirroring a typical 70 byte text line into a 4 KB region of 128 byte slots,
+  the size the logger uses
+*/
+void benchmark_append_cost(void) {
+    alignas(4) static uint8_t device[4096];
+    const char* line = "[2026-10-16 12:34:56] [INFO] SD card mounted, 1234 MB free of 30436 MB\n";
+    const size_t length = strlen(line);
+    const int calls = 2000000;
+
+    EARS_crashLog log;
+    TEST_ASSERT_TRUE(log.begin(device, sizeof(device), 128));
+    log.startSession(0, 0);
+
+    uint64_t start = nowNs();
+    for (int i = 0; i < calls; i++) {
+        log.append(line, length);
+    }
+    uint64_t elapsed = nowNs() - start;
+
+    printf("[bench] crash log append: %.2f ns/entry (%u byte entries, %u slots)\n",
+           (double)elapsed / calls, (unsigned)length, (unsigned)log.slotCount());
+    TEST_ASSERT_EQUAL(calls, log.getStats().appended);
+    TEST_ASSERT_EQUAL(0, log.getStats().collisions);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_boot_recovers_nothing);
+    RUN_TEST(test_entries_survive_reboot);
+    RUN_TEST(test_wraparound_keeps_newest);
+    RUN_TEST(test_damaged_header_is_rejected);
+    RUN_TEST(test_torn_slot_is_skipped);
+    RUN_TEST(test_long_entry_is_cut);
+    RUN_TEST(test_invalid_parameters);
+    RUN_TEST(test_crc32_reference);
+    RUN_TEST(benchmark_append_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,421 @@
+/**
+ * @file test_host_dir_walker.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the iterative directory walker.
+ * @section tests Tests
+ * - Parents before contents, full paths, sizes, types and depths.
+ * - Type, suffix and depth filters; SKIP and STOP.
+ * - Too deep and too long entries are counted, not overrun.
+ * - A visitor removing the files it is given (log cleanup).
+ * - Recursive String-building listing vs the walker: heap allocations,
+ *   open directories and time on a generated tree.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+#include "EARS_dirWalker.h"
+#include "EARS_posixDirReader.h"
+
+/*
+  Counts heap allocations so a walk can show it makes none per entry
+*/
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* memory = malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+static char mountPoint[64];
+
+static void makeDirectory(const char* path) {
+    char full[256];
+    snprintf(full, sizeof(full), "%s%s", mountPoint, path);
+    mkdir(full, 0755);
+}
+
+static void makeFile(const char* path, size_t bytes) {
+    char full[256];
+    snprintf(full, sizeof(full), "%s%s", mountPoint, path);
+    FILE* file = fopen(full, "wb");
+    for (size_t i = 0; i < bytes; i++) {
+        fputc('x', file);
+    }
+    fclose(file);
+}
+
+static void removeTree(const char* full) {
+    DIR* dir = opendir(full);
+    if (!dir) {
+        remove(full);
+        return;
+    }
+    struct dirent* item;
+    while ((item = readdir(dir)) != nullptr) {
+        if (strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0) {
+            continue;
+        }
+        std::string child = std::string(full) + "/" + item->d_name;
+        removeTree(child.c_str());
+    }
+    closedir(dir);
+    rmdir(full);
+}
+
+void setUp(void) {
+    strcpy(mountPoint, "/tmp/ears_walkXXXXXX");
+    TEST_ASSERT_NOT_NULL(mkdtemp(mountPoint));
+
+    // The layout the device keeps on its card
+    makeDirectory("/logs");
+    makeFile("/logs/debug.log", 100);
+    makeFile("/logs/debug.1.log", 200);
+    makeFile("/logs/crash.txt", 30);
+    makeDirectory("/logs/archive");
+    makeFile("/logs/archive/debug.2.log", 400);
+    makeDirectory("/config");
+    makeFile("/config/settings.json", 50);
+    makeFile("/readme.txt", 10);
+}
+
+void tearDown(void) {
+    removeTree(mountPoint);
+}
+
+/*
+  Collects visits as "depth path size" lines, sorted since readdir order is unspecified
+*/
+struct Recorder {
+    std::vector<std::string> lines;
+    std::vector<std::string> order;
+    const char* skip;
+    const char* stopAt;
+    Recorder() : skip(nullptr), stopAt(nullptr) {}
+};
+
+static WalkAction record(const DirEntry& entry, void* context) {
+    Recorder* recorder = static_cast<Recorder*>(context);
+    char line[160];
+    snprintf(line, sizeof(line), "%u %s%s %u", (unsigned)entry.depth, entry.path,
+             entry.type == DirEntryType::DIRECTORY ? "/" : "", (unsigned)entry.size);
+    recorder->lines.push_back(line);
+    recorder->order.push_back(entry.path);
+    TEST_ASSERT_EQUAL_STRING(strrchr(entry.path, '/') + 1, entry.name);
+    TEST_ASSERT_TRUE(entry.modified > 0);
+    if (recorder->skip && strcmp(entry.path, recorder->skip) == 0) {
+        return WalkAction::SKIP;
+    }
+    if (recorder->stopAt && strcmp(entry.path, recorder->stopAt) == 0) {
+        return WalkAction::STOP;
+    }
+    return WalkAction::CONTINUE;
+}
+
+static std::string joined(std::vector<std::string> lines) {
+    std::sort(lines.begin(), lines.end());
+    std::string out;
+    for (size_t i = 0; i < lines.size(); i++) {
+        out += lines[i];
+        out += "\n";
+    }
+    return out;
+}
+
+static size_t indexOf(const std::vector<std::string>& order, const char* path) {
+    for (size_t i = 0; i < order.size(); i++) {
+        if (order[i] == path) {
+            return i;
+        }
+    }
+    return order.size();
+}
+
+void test_walks_whole_tree_parents_first(void) {
+    EARS_posixDirReader reader(mountPoint);
+    Recorder recorder;
+    WalkOptions options;
+    options.maxDepth = EARS_dirWalker::MAX_DEPTH;
+    WalkStats stats = EARS_dirWalker::walk(reader, "/", options, record, &recorder);
+
+    TEST_ASSERT_EQUAL_STRING(
+        "0 /config/ 0\n"
+        "0 /logs/ 0\n"
+        "0 /readme.txt 10\n"
+        "1 /config/settings.json 50\n"
+        "1 /logs/archive/ 0\n"
+        "1 /logs/crash.txt 30\n"
+        "1 /logs/debug.1.log 200\n"
+        "1 /logs/debug.log 100\n"
+        "2 /logs/archive/debug.2.log 400\n",
+        joined(recorder.lines).c_str());
+    TEST_ASSERT_TRUE(indexOf(recorder.order, "/logs") < indexOf(recorder.order, "/logs/debug.log"));
+    TEST_ASSERT_TRUE(indexOf(recorder.order, "/logs/archive") <
+                     indexOf(recorder.order, "/logs/archive/debug.2.log"));
+    TEST_ASSERT_EQUAL(9, stats.visited);
+    TEST_ASSERT_EQUAL(4, stats.directories);
+    TEST_ASSERT_TRUE(stats.complete);
+    TEST_ASSERT_FALSE(stats.stopped);
+
+    // A subdirectory root, with or without a trailing '/'
+    Recorder sub;
+    stats = EARS_dirWalker::walk(reader, "/logs/archive/", options, record, &sub);
+    TEST_ASSERT_EQUAL_STRING("0 /logs/archive/debug.2.log 400\n", joined(sub.lines).c_str());
+
+    stats = EARS_dirWalker::walk(reader, "/missing", options, record, &sub);
+    TEST_ASSERT_FALSE(stats.complete);
+    TEST_ASSERT_EQUAL(0, stats.directories);
+}
+
+void test_filters_and_depth_limit(void) {
+    EARS_posixDirReader reader(mountPoint);
+    WalkOptions options;
+    options.maxDepth = EARS_dirWalker::MAX_DEPTH;
+    options.types = EARS_WALK_FILES;
+    options.suffix = ".log";
+    Recorder logs;
+    WalkStats stats = EARS_dirWalker::walk(reader, "/", options, record, &logs);
+    TEST_ASSERT_EQUAL_STRING(
+        "1 /logs/debug.1.log 200\n"
+        "1 /logs/debug.log 100\n"
+        "2 /logs/archive/debug.2.log 400\n",
+        joined(logs.lines).c_str());
+    TEST_ASSERT_EQUAL(9, stats.entries);
+
+    // Depth 0 lists one directory, as listNames() does
+    WalkOptions shallow;
+    Recorder top;
+    EARS_dirWalker::walk(reader, "/logs", shallow, record, &top);
+    TEST_ASSERT_EQUAL_STRING(
+        "0 /logs/archive/ 0\n"
+        "0 /logs/crash.txt 30\n"
+        "0 /logs/debug.1.log 200\n"
+        "0 /logs/debug.log 100\n",
+        joined(top.lines).c_str());
+
+    WalkOptions directories;
+    directories.maxDepth = 1;
+    directories.types = EARS_WALK_DIRECTORIES;
+    Recorder dirs;
+    EARS_dirWalker::walk(reader, "/", directories, record, &dirs);
+    TEST_ASSERT_EQUAL_STRING("0 /config/ 0\n0 /logs/ 0\n1 /logs/archive/ 0\n", joined(dirs.lines).c_str());
+
+    TEST_ASSERT_TRUE(EARS_dirWalker::matchesSuffix("a.log", nullptr));
+    TEST_ASSERT_FALSE(EARS_dirWalker::matchesSuffix("g", ".log"));
+}
+
+void test_skip_and_stop(void) {
+    EARS_posixDirReader reader(mountPoint);
+    WalkOptions options;
+    options.maxDepth = EARS_dirWalker::MAX_DEPTH;
+
+    Recorder skipping;
+    skipping.skip = "/logs";
+    EARS_dirWalker::walk(reader, "/", options, record, &skipping);
+    TEST_ASSERT_EQUAL_STRING("0 /config/ 0\n0 /logs/ 0\n0 /readme.txt 10\n1 /config/settings.json 50\n",
+                             joined(skipping.lines).c_str());
+
+    Recorder stopping;
+    stopping.stopAt = "/logs/archive";
+    WalkStats stats = EARS_dirWalker::walk(reader, "/", options, record, &stopping);
+    TEST_ASSERT_TRUE(stats.stopped);
+    TEST_ASSERT_EQUAL_STRING("/logs/archive", stopping.order.back().c_str());
+    TEST_ASSERT_EQUAL(stopping.order.size(), stats.visited);
+}
+
+void test_too_deep_and_too_long_are_counted(void) {
+    std::string path;
+    for (int level = 0; level <= EARS_dirWalker::MAX_DEPTH + 1; level++) {
+        path += "/d";
+        makeDirectory(path.c_str());
+    }
+    std::string longName = "/config/" + std::string(EARS_dirWalker::PATH_BYTES, 'n');
+    makeFile(longName.c_str(), 1);
+
+    EARS_posixDirReader reader(mountPoint);
+    Recorder recorder;
+    WalkOptions options;
+    options.maxDepth = 255;
+    WalkStats stats = EARS_dirWalker::walk(reader, "/", options, record, &recorder);
+    TEST_ASSERT_EQUAL(1, stats.tooDeep);
+    TEST_ASSERT_EQUAL(1, stats.tooLong);
+    TEST_ASSERT_TRUE(stats.complete);
+    // /d at depth 0 down to the one at MAX_DEPTH, whose child is not entered
+    TEST_ASSERT_EQUAL(EARS_dirWalker::MAX_DEPTH + 1 + 9, stats.visited);
+}
+
+static WalkAction removeLog(const DirEntry& entry, void* context) {
+    char full[256];
+    snprintf(full, sizeof(full), "%s%s", static_cast<const char*>(context), entry.path);
+    TEST_ASSERT_EQUAL(0, remove(full));
+    return WalkAction::CONTINUE;
+}
+
+void test_visitor_removes_its_entries(void) {
+    for (int i = 0; i < 40; i++) {
+        char name[48];
+        snprintf(name, sizeof(name), "/logs/archive/old.%d.log", i);
+        makeFile(name, 8);
+    }
+    EARS_posixDirReader reader(mountPoint);
+    WalkOptions options;
+    options.maxDepth = EARS_dirWalker::MAX_DEPTH;
+    options.types = EARS_WALK_FILES;
+    options.suffix = ".log";
+    WalkStats stats = EARS_dirWalker::walk(reader, "/logs", options, removeLog, mountPoint);
+    TEST_ASSERT_EQUAL(43, stats.visited);
+
+    Recorder left;
+    options.suffix = nullptr;
+    options.types = EARS_WALK_ALL;
+    EARS_dirWalker::walk(reader, "/logs", options, record, &left);
+    TEST_ASSERT_EQUAL_STRING("0 /logs/archive/ 0\n0 /logs/crash.txt 30\n", joined(left.lines).c_str());
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  The old listDirectory(): recursion with a String path per subdirectory and
+  one more open directory per level, building each entry's path on the heap
+*/
+static size_t openDirectories = 0;
+static size_t peakOpenDirectories = 0;
+
+static void recursiveList(const std::string& path, uint32_t& total, size_t& count) {
+    std::string full = std::string(mountPoint) + path;
+    DIR* dir = opendir(full.c_str());
+    if (!dir) {
+        return;
+    }
+    openDirectories++;
+    if (openDirectories > peakOpenDirectories) {
+        peakOpenDirectories = openDirectories;
+    }
+    struct dirent* item;
+    while ((item = readdir(dir)) != nullptr) {
+        if (strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0) {
+            continue;
+        }
+        std::string subPath = path + "/" + item->d_name;
+        struct stat info;
+        stat((std::string(mountPoint) + subPath).c_str(), &info);
+        count++;
+        if (S_ISDIR(info.st_mode)) {
+            recursiveList(subPath, total, count);
+        } else {
+            total += (uint32_t)info.st_size;
+        }
+    }
+    closedir(dir);
+    openDirectories--;
+}
+
+struct Totals {
+    uint32_t bytes;
+    size_t count;
+};
+
+static WalkAction sumEntry(const DirEntry& entry, void* context) {
+    Totals* totals = static_cast<Totals*>(context);
+    totals->bytes += entry.size;
+    totals->count++;
+    return WalkAction::CONTINUE;
+}
+
+void benchmark_recursive_vs_walker(void) {
+    // 6 directories of 6 subdirectories, 20 files each: 36 log folders
+    for (int a = 0; a < 6; a++) {
+        char dir[64];
+        snprintf(dir, sizeof(dir), "/logs/year%d", a);
+        makeDirectory(dir);
+        for (int b = 0; b < 6; b++) {
+            char sub[80];
+            snprintf(sub, sizeof(sub), "%s/month%d", dir, b);
+            makeDirectory(sub);
+            for (int f = 0; f < 20; f++) {
+                char file[112];
+                snprintf(file, sizeof(file), "%s/day%02d.log", sub, f);
+                makeFile(file, (size_t)f);
+            }
+        }
+    }
+    const int rounds = 50;
+
+    uint32_t recursiveBytes = 0;
+    size_t recursiveCount = 0;
+    size_t before = allocations;
+    uint64_t start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        recursiveBytes = 0;
+        recursiveCount = 0;
+        recursiveList("", recursiveBytes, recursiveCount);
+    }
+    uint64_t recursiveNs = nowNs() - start;
+    size_t recursiveAllocations = (allocations - before) / rounds;
+
+    EARS_posixDirReader reader(mountPoint);
+    WalkOptions options;
+    options.maxDepth = EARS_dirWalker::MAX_DEPTH;
+    Totals totals = { 0, 0 };
+    WalkStats stats;
+    before = allocations;
+    start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        totals.bytes = 0;
+        totals.count = 0;
+        stats = EARS_dirWalker::walk(reader, "/", options, sumEntry, &totals);
+    }
+    uint64_t walkerNs = nowNs() - start;
+    size_t walkerAllocations = (allocations - before) / rounds;
+
+    printf("[bench] recursive: %zu entries, %zu heap allocations, %zu open directories, %.1f us/walk\n",
+           recursiveCount, recursiveAllocations, peakOpenDirectories, recursiveNs / 1000.0 / rounds);
+    printf("[bench] walker:    %zu entries, %zu heap allocations, 1 open directory, %.1f us/walk\n",
+           totals.count, walkerAllocations, walkerNs / 1000.0 / rounds);
+
+    TEST_ASSERT_EQUAL(recursiveCount, totals.count);
+    TEST_ASSERT_EQUAL(recursiveBytes, totals.bytes);
+    TEST_ASSERT_EQUAL(0, walkerAllocations);
+    TEST_ASSERT_TRUE(recursiveAllocations > recursiveCount);
+    TEST_ASSERT_TRUE(stats.complete);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_walks_whole_tree_parents_first);
+    RUN_TEST(test_filters_and_depth_limit);
+    RUN_TEST(test_skip_and_stop);
+    RUN_TEST(test_too_deep_and_too_long_are_counted);
+    RUN_TEST(test_visitor_removes_its_entries);
+    RUN_TEST(benchmark_recursive_vs_walker);
+    return UNITY_END();
+}
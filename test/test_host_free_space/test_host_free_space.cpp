@@ -0,0 +1,237 @@
+/**
+ * @file test_host_free_space.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for background free space accounting.
+ * @section tests Tests
+ * - Resizes are followed in whole clusters and match a real allocation.
+ * - Changes made while a count runs survive its result.
+ * - Recounts are due after the interval, after uncertain changes, never before.
+ * - Boot time of a blocking count vs a background count on a simulated
+ *   64 GB FAT32 volume; the tracked estimate matches a final recount.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "EARS_spaceTracker.h"
+
+static const uint64_t GB = 1024ULL * 1024ULL * 1024ULL;
+
+/*
+  FAT volume stand-in: one FAT entry per cluster, files own whole clusters.
+  count() reads the FAT sector by sector at a simulated card speed.
+*/
+class FatVolume {
+public:
+    static const uint32_t SECTOR_ENTRIES = 128;     // 512 B of FAT32 entries
+
+    uint32_t clusterBytes;
+    std::vector<uint8_t> fat;
+    std::map<std::string, uint64_t> files;
+    uint32_t sectorDelayUs;
+    std::mutex mutex;
+
+    FatVolume(uint64_t totalBytes, uint32_t cluster)
+        : clusterBytes(cluster), fat((size_t)(totalBytes / cluster), 0), sectorDelayUs(0) {
+        fat[0] = 1;     // Root directory
+    }
+
+    uint64_t totalBytes() const { return (uint64_t)fat.size() * clusterBytes; }
+
+    uint64_t clustersFor(uint64_t size) const { return (size + clusterBytes - 1) / clusterBytes; }
+
+    void setSize(const std::string& name, uint64_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint64_t have = clustersFor(files[name]);
+        uint64_t want = clustersFor(size);
+        for (size_t i = 1; i < fat.size() && have < want; i++) {
+            if (!fat[i]) { fat[i] = 1; have++; }
+        }
+        for (size_t i = fat.size() - 1; i > 0 && have > want; i--) {
+            if (fat[i]) { fat[i] = 0; have--; }
+        }
+        files[name] = size;
+    }
+
+    void remove(const std::string& name) {
+        setSize(name, 0);
+        std::lock_guard<std::mutex> lock(mutex);
+        files.erase(name);
+    }
+
+    uint64_t count() {
+        uint64_t used = 0;
+        for (size_t sector = 0; sector * SECTOR_ENTRIES < fat.size(); sector++) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                size_t end = std::min(fat.size(), (sector + 1) * SECTOR_ENTRIES);
+                for (size_t i = sector * SECTOR_ENTRIES; i < end; i++) {
+                    used += fat[i];
+                }
+            }
+            if (sectorDelayUs && sector % 64 == 63) {
+                std::this_thread::sleep_for(std::chrono::microseconds(sectorDelayUs * 64));
+            }
+        }
+        return used * clusterBytes;
+    }
+};
+
+/*
+  What EARS_sdCard does around its writes and removes
+*/
+static void append(FatVolume& volume, EARS_spaceTracker& tracker, const std::string& name, uint64_t bytes) {
+    uint64_t before = volume.files.count(name) ? volume.files[name] : 0;
+    volume.setSize(name, before + bytes);
+    tracker.resized(before, before + bytes);
+}
+
+static void removeFile(FatVolume& volume, EARS_spaceTracker& tracker, const std::string& name) {
+    uint64_t before = volume.files[name];
+    volume.remove(name);
+    tracker.resized(before, 0);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_resizes_follow_clusters(void) {
+    FatVolume volume(1 * GB, 32768);
+    EARS_spaceTracker tracker;
+    tracker.begin(volume.totalBytes(), 32768);
+    TEST_ASSERT_FALSE(tracker.isKnown());
+    TEST_ASSERT_EQUAL(0, tracker.freeBytes());
+
+    tracker.beginCount();
+    tracker.endCount(volume.count(), 0);
+    TEST_ASSERT_TRUE(tracker.isKnown());
+
+    for (int i = 0; i < 500; i++) {
+        append(volume, tracker, "/logs/debug.log", 96);
+        append(volume, tracker, "/logs/error.log", 700);
+    }
+    removeFile(volume, tracker, "/logs/error.log");
+    append(volume, tracker, "/config/ears.config", 1);
+
+    TEST_ASSERT_EQUAL((uint32_t)(volume.count() / 1024), (uint32_t)(tracker.usedBytes() / 1024));
+    TEST_ASSERT_EQUAL((uint32_t)((volume.totalBytes() - volume.count()) / 1024),
+                      (uint32_t)(tracker.freeBytes() / 1024));
+}
+
+void test_changes_during_count_survive(void) {
+    EARS_spaceTracker tracker;
+    tracker.begin(1 * GB, 4096);
+    tracker.beginCount();
+    tracker.resized(0, 10000);          // 12288 bytes, after the count read its part of the FAT
+    tracker.endCount(1000000, 0);
+    TEST_ASSERT_EQUAL(1000000 + 12288, (uint32_t)tracker.usedBytes());
+
+    tracker.beginCount();
+    tracker.resized(0, 4096);
+    tracker.endCount(1000000 + 12288 + 8192, 10);
+    TEST_ASSERT_EQUAL(1000000 + 12288 + 8192 + 4096, (uint32_t)tracker.usedBytes());
+    TEST_ASSERT_EQUAL(8192, (int32_t)tracker.getStats().lastDriftBytes);
+}
+
+void test_recount_due(void) {
+    EARS_spaceTracker tracker;
+    tracker.begin(32 * GB, 32768);
+    TEST_ASSERT_TRUE(tracker.countDue(0));
+    tracker.beginCount();
+    tracker.endCount(GB, 1000);
+    TEST_ASSERT_FALSE(tracker.countDue(1000 + EARS_spaceTracker::RECOUNT_INTERVAL_MS - 1));
+    TEST_ASSERT_TRUE(tracker.countDue(1000 + EARS_spaceTracker::RECOUNT_INTERVAL_MS));
+
+    tracker.added(100);
+    TEST_ASSERT_FALSE(tracker.countDue(2000));
+    tracker.unknownChange();
+    TEST_ASSERT_TRUE(tracker.countDue(2000));
+
+    TEST_ASSERT_EQUAL(32768, EARS_spaceTracker::typicalClusterBytes(32 * GB));
+    TEST_ASSERT_EQUAL(131072, EARS_spaceTracker::typicalClusterBytes(64 * GB));
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  64 GB volume with 32 KB clusters: 2M FAT entries in 16384 sectors, read
+  at a simulated 20 us per sector
+*/
+void benchmark_boot_time(void) {
+    FatVolume volume(64 * GB, 32768);
+    volume.sectorDelayUs = 20;
+    EARS_spaceTracker existing;
+    for (int i = 0; i < 100; i++) {
+        append(volume, existing, "/history/" + std::to_string(i), 1000000);
+    }
+
+    // Blocking: begin() counts before it returns
+    EARS_spaceTracker blocking;
+    uint64_t start = nowNs();
+    blocking.begin(volume.totalBytes(), 32768);
+    blocking.beginCount();
+    blocking.endCount(volume.count(), 0);
+    uint64_t blockingNs = nowNs() - start;
+
+    // Background: begin() starts the count and returns, the logger writes meanwhile
+    EARS_spaceTracker tracker;
+    start = nowNs();
+    tracker.begin(volume.totalBytes(), 32768);
+    std::atomic<bool> counted(false);
+    std::thread counter([&] {
+        tracker.beginCount();
+        tracker.endCount(volume.count(), 0);
+        counted.store(true);
+    });
+    uint64_t bootNs = nowNs() - start;
+
+    int lines = 0;
+    while (!counted.load()) {
+        append(volume, tracker, "/logs/debug.log", 96);
+        lines++;
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    uint64_t knownNs = nowNs() - start;
+    counter.join();
+    for (int i = 0; i < 2000; i++) {
+        append(volume, tracker, "/logs/debug.log", 96);
+    }
+    removeFile(volume, tracker, "/history/7");
+
+    uint64_t actual = volume.count();
+    int64_t error = (int64_t)tracker.usedBytes() - (int64_t)actual;
+    printf("[bench] blocking count: begin() %7.1f ms\n", blockingNs / 1e6);
+    printf("[bench] background:     begin() %7.3f ms, count known after %.1f ms, "
+           "%d lines written meanwhile, estimate off by %lld bytes\n",
+           bootNs / 1e6, knownNs / 1e6, lines, (long long)error);
+
+    TEST_ASSERT_TRUE(bootNs * 100 < blockingNs);
+    // A cluster allocated ahead of the count's position may be counted twice
+    TEST_ASSERT_TRUE(error <= 32768 && error >= -32768);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_resizes_follow_clusters);
+    RUN_TEST(test_changes_during_count_survive);
+    RUN_TEST(test_recount_due);
+    RUN_TEST(benchmark_boot_time);
+    return UNITY_END();
+}
@@ -0,0 +1,252 @@
+/**
+ * @file test_host_handle_pool.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the LRU file handle pool.
+ * @section tests Tests
+ * - Repeated appends reuse one open; the least recently used handle is evicted.
+ * - Truncating writes reopen; flush/close by path; closeAll on card removal.
+ * - Dirty handles are flushed once maxDirtyMs passes, across the millis() wrap.
+ * - Cost of open/append/close per line vs pooled appends, on stdio files.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include "EARS_handlePool.h"
+
+/*
+  Records what the pool asks of the owner
+*/
+class RecordingOwner : public EARS_handleOwner {
+public:
+    std::string opened[EARS_handlePool::MAX_HANDLES];
+    bool truncated[EARS_handlePool::MAX_HANDLES];
+    int opens;
+    int flushes;
+    int closes;
+    bool failOpen;
+
+    RecordingOwner() : opens(0), flushes(0), closes(0), failOpen(false) {}
+
+    bool openHandle(uint8_t slot, const char* path, bool truncate) override {
+        if (failOpen) return false;
+        opened[slot] = path;
+        truncated[slot] = truncate;
+        opens++;
+        return true;
+    }
+    bool flushHandle(uint8_t slot) override {
+        (void)slot;
+        flushes++;
+        return true;
+    }
+    void closeHandle(uint8_t slot) override {
+        opened[slot].clear();
+        closes++;
+    }
+};
+
+static RecordingOwner* owner;
+static EARS_handlePool* pool;
+
+void setUp(void) {
+    owner = new RecordingOwner();
+    pool = new EARS_handlePool();
+    pool->begin(owner, 2, 1000);
+}
+
+void tearDown(void) {
+    delete pool;
+    delete owner;
+}
+
+void test_begin_validates(void) {
+    EARS_handlePool other;
+    TEST_ASSERT_FALSE(other.begin(nullptr, 2, 1000));
+    TEST_ASSERT_FALSE(other.begin(owner, 0, 1000));
+    TEST_ASSERT_FALSE(other.begin(owner, EARS_handlePool::MAX_HANDLES + 1, 1000));
+    TEST_ASSERT_EQUAL(-1, other.acquire("/logs/debug.log", false));
+}
+
+void test_appends_reuse_one_open(void) {
+    for (int i = 0; i < 100; i++) {
+        int slot = pool->acquire("/logs/debug.log", false);
+        TEST_ASSERT_EQUAL(0, slot);
+        pool->markDirty((uint8_t)slot, (uint32_t)i);
+    }
+    TEST_ASSERT_EQUAL(1, owner->opens);
+    TEST_ASSERT_FALSE(owner->truncated[0]);
+    TEST_ASSERT_EQUAL(99, pool->getStats().hits);
+    TEST_ASSERT_EQUAL(1, pool->openCount());
+    TEST_ASSERT_TRUE(pool->isDirty());
+}
+
+void test_least_recently_used_is_evicted(void) {
+    int a = pool->acquire("/a", false);
+    int b = pool->acquire("/b", false);
+    TEST_ASSERT_NOT_EQUAL(a, b);
+    pool->acquire("/a", false);                 // /b is now the oldest
+    int c = pool->acquire("/c", false);
+    TEST_ASSERT_EQUAL(b, c);
+    TEST_ASSERT_EQUAL_STRING("/c", owner->opened[c].c_str());
+    TEST_ASSERT_EQUAL_STRING("/a", owner->opened[a].c_str());
+    TEST_ASSERT_EQUAL(1, pool->getStats().evictions);
+    TEST_ASSERT_EQUAL(1, owner->closes);
+    TEST_ASSERT_EQUAL(2, pool->openCount());
+}
+
+void test_truncate_reopens(void) {
+    int slot = pool->acquire("/config/ears.config", false);
+    slot = pool->acquire("/config/ears.config", true);
+    TEST_ASSERT_TRUE(slot >= 0);
+    TEST_ASSERT_EQUAL(2, owner->opens);
+    TEST_ASSERT_EQUAL(1, owner->closes);
+    TEST_ASSERT_TRUE(owner->truncated[slot]);
+    TEST_ASSERT_EQUAL(1, pool->openCount());
+}
+
+void test_flush_and_close_by_path(void) {
+    int slot = pool->acquire("/logs/debug.log", false);
+    TEST_ASSERT_TRUE(pool->flush("/logs/debug.log"));
+    TEST_ASSERT_EQUAL(0, owner->flushes);      // Clean handles are not flushed
+
+    pool->markDirty((uint8_t)slot, 0);
+    TEST_ASSERT_TRUE(pool->flush("/logs/other.log"));
+    TEST_ASSERT_EQUAL(0, owner->flushes);
+    TEST_ASSERT_TRUE(pool->flush("/logs/debug.log"));
+    TEST_ASSERT_EQUAL(1, owner->flushes);
+    TEST_ASSERT_FALSE(pool->isDirty());
+
+    pool->close("/logs/debug.log");
+    TEST_ASSERT_EQUAL(0, pool->openCount());
+    TEST_ASSERT_EQUAL(1, owner->closes);
+    pool->close("/logs/debug.log");
+    TEST_ASSERT_EQUAL(1, owner->closes);
+}
+
+void test_close_all_and_failed_open(void) {
+    pool->acquire("/a", false);
+    pool->acquire("/b", false);
+    pool->closeAll();
+    TEST_ASSERT_EQUAL(0, pool->openCount());
+    TEST_ASSERT_EQUAL(2, owner->closes);
+
+    owner->failOpen = true;
+    TEST_ASSERT_EQUAL(-1, pool->acquire("/a", false));
+    TEST_ASSERT_EQUAL(0, pool->openCount());
+
+    std::string longPath(EARS_FS_PORT_MAX_PATH, 'x');
+    owner->failOpen = false;
+    TEST_ASSERT_EQUAL(-1, pool->acquire(longPath.c_str(), false));
+}
+
+void test_dirty_handles_expire(void) {
+    int a = pool->acquire("/a", false);
+    int b = pool->acquire("/b", false);
+    pool->markDirty((uint8_t)a, 100);
+    pool->markDirty((uint8_t)a, 900);           // Still dirty since 100
+    pool->markDirty((uint8_t)b, 600);
+
+    TEST_ASSERT_EQUAL(0, pool->flushExpired(1099));
+    TEST_ASSERT_EQUAL(1, pool->flushExpired(1100));
+    TEST_ASSERT_EQUAL(1, owner->flushes);
+    TEST_ASSERT_EQUAL(0, pool->flushExpired(1500));
+    TEST_ASSERT_EQUAL(1, pool->flushExpired(1600));
+    TEST_ASSERT_FALSE(pool->isDirty());
+
+    // millis() wraps after 49.7 days
+    pool->markDirty((uint8_t)a, 0xFFFFFF00u);
+    TEST_ASSERT_EQUAL(0, pool->flushExpired(0x00000100u));
+    TEST_ASSERT_EQUAL(1, pool->flushExpired(0x00000300u));
+
+    TEST_ASSERT_TRUE(pool->flushAll());
+    TEST_ASSERT_EQUAL(3, owner->flushes);
+    TEST_ASSERT_EQUAL(3, pool->getStats().flushes);
+}
+
+/*
+  stdio stand-in for EARS_sdCard's File slots
+*/
+class StdioOwner : public EARS_handleOwner {
+public:
+    FILE* files[EARS_handlePool::MAX_HANDLES];
+    bool openHandle(uint8_t slot, const char* path, bool truncate) override {
+        files[slot] = fopen(path, truncate ? "wb" : "ab");
+        return files[slot] != nullptr;
+    }
+    bool flushHandle(uint8_t slot) override { return fflush(files[slot]) == 0; }
+    void closeHandle(uint8_t slot) override { fclose(files[slot]); }
+};
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  Log lines alternating with error history lines, as the logger in
+  synchronous mode and EARS_errors produce them
+*/
+void benchmark_pooled_appends(void) {
+    const char* paths[2] = {"test_host_handle_pool_debug.tmp", "test_host_handle_pool_error.tmp"};
+    const char* line = "2026-10-16 12:34:56 [INFO ] Backlight level 80, screensaver in 30 s, core 1\n";
+    size_t length = strlen(line);
+    const int appends = 20000;
+    remove(paths[0]);
+    remove(paths[1]);
+
+    uint64_t start = nowNs();
+    for (int i = 0; i < appends; i++) {
+        FILE* file = fopen(paths[i % 4 == 3], "ab");
+        fwrite(line, 1, length, file);
+        fclose(file);
+    }
+    uint64_t perCallNs = nowNs() - start;
+
+    StdioOwner stdioOwner;
+    EARS_handlePool stdioPool;
+    stdioPool.begin(&stdioOwner, 2, 1000);
+    start = nowNs();
+    for (int i = 0; i < appends; i++) {
+        int slot = stdioPool.acquire(paths[i % 4 == 3], false);
+        fwrite(line, 1, length, stdioOwner.files[slot]);
+        uint32_t nowMs = (uint32_t)((nowNs() - start) / 1000000);
+        stdioPool.markDirty((uint8_t)slot, nowMs);
+        stdioPool.flushExpired(nowMs);
+    }
+    stdioPool.closeAll();
+    uint64_t pooledNs = nowNs() - start;
+
+    printf("[bench] open/append/close: %.2f us/line, %d opens\n", perCallNs / 1000.0 / appends, appends);
+    printf("[bench] pooled handles:    %.2f us/line, %u opens, %u flushes\n", pooledNs / 1000.0 / appends,
+           (unsigned)stdioPool.getStats().opens, (unsigned)stdioPool.getStats().flushes);
+
+    FILE* file = fopen(paths[0], "rb");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    TEST_ASSERT_EQUAL((long)(length * appends * 3 / 4 * 2), size);
+    TEST_ASSERT_EQUAL(2, stdioPool.getStats().opens);
+    remove(paths[0]);
+    remove(paths[1]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_validates);
+    RUN_TEST(test_appends_reuse_one_open);
+    RUN_TEST(test_least_recently_used_is_evicted);
+    RUN_TEST(test_truncate_reopens);
+    RUN_TEST(test_flush_and_close_by_path);
+    RUN_TEST(test_close_all_and_failed_open);
+    RUN_TEST(test_dirty_handles_expire);
+    RUN_TEST(benchmark_pooled_appends);
+    return UNITY_END();
+}
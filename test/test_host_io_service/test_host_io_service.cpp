@@ -0,0 +1,331 @@
+/**
+ * @file test_host_io_service.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the prioritised file request service.
+ * @section tests Tests
+ * - Requests run by priority, FIFO within one; invalid or excess requests are rejected.
+ * - A passed-over priority is served after STARVATION_LIMIT picks.
+ * - Requests never overtake an earlier one for the same path.
+ * - Inbox completions run on the dispatching thread only.
+ * - run() finishes the queue after stop.
+ * - Queueing latency of UI reads behind a flood of log appends on a
+ *   simulated slow card, FIFO vs prioritised.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include "EARS_ioService.h"
+#include "EARS_memFs.h"
+
+/*
+  Simulated card: EARS_memFs behind a fixed delay per operation, recording
+  the order operations arrive in
+*/
+class SlowDevice : public EARS_ioDevice {
+public:
+    EARS_memFs fs;
+    std::vector<std::string> order;
+    uint32_t readUs;
+    uint32_t writeUs;
+
+    SlowDevice() : readUs(0), writeUs(0) {}
+
+    bool ioExecute(IoOp op, const char* path, uint32_t offset,
+                   uint8_t* buffer, size_t length, size_t& transferred) override {
+        order.push_back(path);
+        uint32_t delayUs = (op == IoOp::READ || op == IoOp::LIST) ? readUs : writeUs;
+        if (delayUs) {
+            std::this_thread::sleep_for(std::chrono::microseconds(delayUs));
+        }
+        switch (op) {
+            case IoOp::READ:
+                transferred = fs.readFileAt(path, offset, buffer, length);
+                return transferred > 0 || fs.fileExists(path);
+            case IoOp::WRITE:
+                transferred = length;
+                return fs.writeFile(path, buffer, length);
+            case IoOp::APPEND:
+                transferred = length;
+                return fs.appendFile(path, static_cast<const void*>(buffer), length);
+            case IoOp::REMOVE:
+                return fs.removeFile(path);
+            default:
+                return true;
+        }
+    }
+};
+
+static SlowDevice* device;
+static EARS_ioService* service;
+static uint8_t scratch[256];
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static void fresh() {
+    delete service;
+    delete device;
+    device = new SlowDevice();
+    service = new EARS_ioService();
+    service->begin(device);
+}
+
+static IoRequest request(IoOp op, IoPriority priority, const char* path) {
+    IoRequest r;
+    r.op = op;
+    r.priority = priority;
+    r.path = path;
+    r.buffer = scratch;
+    r.length = 4;
+    return r;
+}
+
+void test_submit_validates(void) {
+    EARS_ioService idle;
+    TEST_ASSERT_FALSE(idle.begin(nullptr));
+    TEST_ASSERT_FALSE(idle.submit(request(IoOp::READ, IoPriority::NORMAL, "/a")));
+
+    fresh();
+    std::string longPath(EARS_ioService::PATH_BYTES, 'x');
+    TEST_ASSERT_FALSE(service->submit(request(IoOp::READ, IoPriority::NORMAL, longPath.c_str())));
+    TEST_ASSERT_FALSE(service->submit(request(IoOp::READ, IoPriority::NORMAL, "")));
+    IoRequest noBuffer = request(IoOp::APPEND, IoPriority::BULK, "/a");
+    noBuffer.buffer = nullptr;
+    TEST_ASSERT_FALSE(service->submit(noBuffer));
+    TEST_ASSERT_TRUE(service->submit(request(IoOp::REMOVE, IoPriority::BULK, "/a")));
+
+    for (uint8_t i = 1; i < EARS_ioService::QUEUE_DEPTH; i++) {
+        TEST_ASSERT_TRUE(service->submit(request(IoOp::APPEND, IoPriority::BULK, "/a")));
+    }
+    TEST_ASSERT_FALSE(service->submit(request(IoOp::READ, IoPriority::CRITICAL, "/b")));
+    TEST_ASSERT_EQUAL(EARS_ioService::QUEUE_DEPTH, service->queued());
+    TEST_ASSERT_EQUAL(4, service->getStats().rejected);
+}
+
+void test_priority_order(void) {
+    fresh();
+    service->submit(request(IoOp::APPEND, IoPriority::BULK, "/bulk1"));
+    service->submit(request(IoOp::APPEND, IoPriority::NORMAL, "/normal1"));
+    service->submit(request(IoOp::APPEND, IoPriority::BULK, "/bulk2"));
+    service->submit(request(IoOp::READ, IoPriority::CRITICAL, "/critical1"));
+    service->submit(request(IoOp::READ, IoPriority::CRITICAL, "/critical2"));
+    service->submit(request(IoOp::APPEND, IoPriority::NORMAL, "/normal2"));
+
+    while (service->serviceOne(0)) {
+    }
+    const char* expected[] = { "/critical1", "/critical2", "/normal1", "/normal2", "/bulk1", "/bulk2" };
+    TEST_ASSERT_EQUAL(6, device->order.size());
+    for (int i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL_STRING(expected[i], device->order[i].c_str());
+    }
+    IoServiceStats stats = service->getStats();
+    TEST_ASSERT_EQUAL(2, stats.completed[0]);
+    TEST_ASSERT_EQUAL(2, stats.completed[1]);
+    TEST_ASSERT_EQUAL(2, stats.completed[2]);
+    TEST_ASSERT_EQUAL(0, stats.promoted);
+}
+
+void test_starved_priority_is_served(void) {
+    fresh();
+    service->submit(request(IoOp::APPEND, IoPriority::BULK, "/bulk"));
+    static char paths[15][8];
+    for (int i = 0; i < 15; i++) {
+        snprintf(paths[i], sizeof(paths[i]), "/c%d", i);
+        service->submit(request(IoOp::READ, IoPriority::CRITICAL, paths[i]));
+    }
+    while (service->serviceOne(0)) {
+    }
+    TEST_ASSERT_EQUAL_STRING("/bulk", device->order[EARS_ioService::STARVATION_LIMIT].c_str());
+    TEST_ASSERT_EQUAL(1, service->getStats().promoted);
+}
+
+static std::string readBack;
+
+static void captureRead(const IoResult& result, void* context) {
+    (void)context;
+    readBack.assign((const char*)result.buffer, result.transferred);
+}
+
+void test_same_path_is_not_overtaken(void) {
+    fresh();
+    static uint8_t line[] = "late";
+    IoRequest append = request(IoOp::APPEND, IoPriority::BULK, "/config/ui.json");
+    append.buffer = line;
+    append.length = 4;
+    service->submit(append);
+    service->submit(request(IoOp::APPEND, IoPriority::BULK, "/logs/debug.log"));
+
+    IoRequest read = request(IoOp::READ, IoPriority::CRITICAL, "/config/ui.json");
+    read.buffer = scratch;
+    read.length = sizeof(scratch);
+    read.done = captureRead;
+    service->submit(read);
+
+    while (service->serviceOne(0)) {
+    }
+    TEST_ASSERT_EQUAL_STRING("/config/ui.json", device->order[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("/config/ui.json", device->order[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("/logs/debug.log", device->order[2].c_str());
+    TEST_ASSERT_EQUAL_STRING("late", readBack.c_str());
+}
+
+static std::thread::id completionThread;
+static int completions;
+
+static void recordThread(const IoResult& result, void* context) {
+    (void)context;
+    TEST_ASSERT_TRUE(result.ok);
+    completionThread = std::this_thread::get_id();
+    completions++;
+}
+
+void test_inbox_completions_run_on_dispatcher(void) {
+    fresh();
+    device->fs.writeFile("/img", "pixels", 6);
+    EARS_ioInbox inbox;
+    std::atomic<bool> stop(false);
+    std::thread worker([&] { service->run(stop); });
+
+    completions = 0;
+    IoRequest read = request(IoOp::READ, IoPriority::CRITICAL, "/img");
+    read.done = recordThread;
+    read.inbox = &inbox;
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(service->submit(read));
+    }
+    while (inbox.pending() < 3) {
+        std::this_thread::yield();
+    }
+    TEST_ASSERT_EQUAL(0, completions);
+
+    TEST_ASSERT_EQUAL(3, inbox.dispatch());
+    TEST_ASSERT_EQUAL(3, completions);
+    TEST_ASSERT_TRUE(completionThread == std::this_thread::get_id());
+    TEST_ASSERT_EQUAL(0, inbox.pending());
+    TEST_ASSERT_EQUAL(0, inbox.dispatch());
+
+    stop.store(true);
+    service->wake();
+    worker.join();
+}
+
+void test_run_finishes_queue_after_stop(void) {
+    fresh();
+    device->writeUs = 200;
+    std::atomic<bool> stop(false);
+    for (int i = 0; i < 10; i++) {
+        service->submit(request(IoOp::APPEND, IoPriority::BULK, "/logs/debug.log"));
+    }
+    stop.store(true);
+    std::thread worker([&] { service->run(stop); });
+    worker.join();
+    TEST_ASSERT_EQUAL(10, device->order.size());
+    TEST_ASSERT_EQUAL(40, device->fs.peek("/logs/debug.log")->size());
+}
+
+/*
+  UI task issues a read every 20 ms while a logger task keeps the queue
+  topped up with appends; the card takes 1 ms per append, 0.5 ms per read
+*/
+static uint64_t uiWaitUs;
+static uint32_t uiMaxWaitUs;
+static uint32_t uiReads;
+
+static void recordUiWait(const IoResult& result, void* context) {
+    (void)context;
+    uiWaitUs += result.waitUs;
+    if (result.waitUs > uiMaxWaitUs) {
+        uiMaxWaitUs = result.waitUs;
+    }
+    uiReads++;
+}
+
+static void measureUiWait(bool prioritised, uint32_t& appends) {
+    const int reads = 20;
+    fresh();
+    device->readUs = 500;
+    device->writeUs = 1000;
+    device->fs.writeFile("/config/ui.json", "{}", 2);
+    uiWaitUs = 0;
+    uiMaxWaitUs = 0;
+    uiReads = 0;
+
+    std::atomic<bool> stop(false);
+    std::atomic<bool> producing(true);
+    std::thread worker([&] { service->run(stop); });
+    std::thread logger([&] {
+        static uint8_t line[96];
+        IoRequest append = request(IoOp::APPEND, prioritised ? IoPriority::BULK : IoPriority::NORMAL,
+                                   "/logs/debug.log");
+        append.buffer = line;
+        append.length = sizeof(line);
+        while (producing.load()) {
+            // Leaves slots free for the UI, as the logger's own ring absorbs bursts
+            if (service->queued() >= EARS_ioService::QUEUE_DEPTH - 4 || !service->submit(append)) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    });
+
+    static uint8_t ui[64];
+    IoRequest read = request(IoOp::READ, prioritised ? IoPriority::CRITICAL : IoPriority::NORMAL,
+                             "/config/ui.json");
+    read.buffer = ui;
+    read.length = sizeof(ui);
+    read.done = recordUiWait;
+    for (int i = 0; i < reads; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        TEST_ASSERT_TRUE(service->submit(read));
+    }
+    producing.store(false);
+    logger.join();
+    stop.store(true);
+    service->wake();
+    worker.join();
+
+    TEST_ASSERT_EQUAL(reads, uiReads);
+    IoServiceStats stats = service->getStats();
+    appends = stats.completed[0] + stats.completed[1] + stats.completed[2] - reads;
+}
+
+void benchmark_ui_read_latency(void) {
+    uint32_t appends;
+    measureUiWait(false, appends);
+    double fifoAverage = (double)uiWaitUs / uiReads;
+    printf("[bench] FIFO:        UI read wait %7.0f us average, %6u us max, %u appends\n",
+           fifoAverage, uiMaxWaitUs, appends);
+
+    measureUiWait(true, appends);
+    double prioritisedAverage = (double)uiWaitUs / uiReads;
+    printf("[bench] prioritised: UI read wait %7.0f us average, %6u us max, %u appends\n",
+           prioritisedAverage, uiMaxWaitUs, appends);
+
+    TEST_ASSERT_TRUE(prioritisedAverage * 4 < fifoAverage);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_submit_validates);
+    RUN_TEST(test_priority_order);
+    RUN_TEST(test_starved_priority_is_served);
+    RUN_TEST(test_same_path_is_not_overtaken);
+    RUN_TEST(test_inbox_completions_run_on_dispatcher);
+    RUN_TEST(test_run_finishes_queue_after_stop);
+    RUN_TEST(benchmark_ui_read_latency);
+    delete service;
+    delete device;
+    return UNITY_END();
+}
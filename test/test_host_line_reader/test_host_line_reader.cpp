@@ -0,0 +1,197 @@
+/**
+ * @file test_host_line_reader.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for constant-memory chunk and line reading.
+ * @section tests Tests
+ * - Lines split the same for every chunk size, "\r\n" and a missing last newline.
+ * - Overlong lines are cut and flagged; visitors can stop early.
+ * - Empty and missing files.
+ * - Lines/s and memory held: whole file in a string vs 512 byte chunks.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "EARS_memFs.h"
+#include "EARS_lineReader.h"
+
+struct Collected {
+    std::vector<std::string> lines;
+    std::vector<bool> truncated;
+    size_t stopAfter;
+};
+
+static bool collect(const char* line, size_t length, bool truncated, void* context) {
+    Collected* out = static_cast<Collected*>(context);
+    TEST_ASSERT_EQUAL(strlen(line), length);
+    out->lines.push_back(std::string(line, length));
+    out->truncated.push_back(truncated);
+    return out->stopAfter == 0 || out->lines.size() < out->stopAfter;
+}
+
+static Collected readAll(EARS_memFs& fs, const char* path, size_t chunkBytes, size_t lineBytes) {
+    std::vector<uint8_t> chunk(chunkBytes);
+    std::vector<char> line(lineBytes);
+    Collected out;
+    out.stopAfter = 0;
+    uint32_t count = EARS_readLines(fs, path, &chunk[0], chunk.size(), &line[0], line.size(), collect, &out);
+    TEST_ASSERT_EQUAL(out.lines.size(), count);
+    return out;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_lines_independent_of_chunk_size(void) {
+    EARS_memFs fs;
+    const char* text = "first\nsecond line\r\n\nfourth\r\nlast without newline";
+    fs.writeFile("/f.txt", text, strlen(text));
+
+    for (size_t chunk = 1; chunk <= strlen(text) + 1; chunk++) {
+        Collected out = readAll(fs, "/f.txt", chunk, 64);
+        TEST_ASSERT_EQUAL(5, out.lines.size());
+        TEST_ASSERT_EQUAL_STRING("first", out.lines[0].c_str());
+        TEST_ASSERT_EQUAL_STRING("second line", out.lines[1].c_str());
+        TEST_ASSERT_EQUAL_STRING("", out.lines[2].c_str());
+        TEST_ASSERT_EQUAL_STRING("fourth", out.lines[3].c_str());
+        TEST_ASSERT_EQUAL_STRING("last without newline", out.lines[4].c_str());
+        for (size_t i = 0; i < out.truncated.size(); i++) {
+            TEST_ASSERT_FALSE(out.truncated[i]);
+        }
+    }
+}
+
+void test_long_lines_are_cut_and_skipped(void) {
+    EARS_memFs fs;
+    std::string text = "short\n" + std::string(100, 'x') + "\nafter\n";
+    fs.writeFile("/f.txt", text.data(), text.size());
+
+    for (size_t chunk = 1; chunk <= 16; chunk++) {
+        Collected out = readAll(fs, "/f.txt", chunk, 11);
+        TEST_ASSERT_EQUAL(3, out.lines.size());
+        TEST_ASSERT_EQUAL_STRING("short", out.lines[0].c_str());
+        TEST_ASSERT_EQUAL_STRING(std::string(10, 'x').c_str(), out.lines[1].c_str());
+        TEST_ASSERT_TRUE(out.truncated[1]);
+        TEST_ASSERT_EQUAL_STRING("after", out.lines[2].c_str());
+        TEST_ASSERT_FALSE(out.truncated[2]);
+    }
+}
+
+void test_visitor_stops_early(void) {
+    EARS_memFs fs;
+    std::string text;
+    for (int i = 0; i < 1000; i++) {
+        text += "line\n";
+    }
+    fs.writeFile("/f.txt", text.data(), text.size());
+
+    uint8_t chunk[64];
+    char line[32];
+    Collected out;
+    out.stopAfter = 3;
+    TEST_ASSERT_EQUAL(3, EARS_readLines(fs, "/f.txt", chunk, sizeof(chunk), line, sizeof(line), collect, &out));
+
+    // Stopping also stops reading: one chunk, not the whole file
+    TEST_ASSERT_EQUAL(1, fs.getStats().reads);
+}
+
+void test_empty_and_missing_files(void) {
+    EARS_memFs fs;
+    fs.writeFile("/empty.txt", "", 0);
+    TEST_ASSERT_EQUAL(0, readAll(fs, "/empty.txt", 16, 16).lines.size());
+    TEST_ASSERT_EQUAL(0, readAll(fs, "/missing.txt", 16, 16).lines.size());
+
+    // A file that is just a newline holds one empty line
+    fs.writeFile("/newline.txt", "\n", 1);
+    TEST_ASSERT_EQUAL(1, readAll(fs, "/newline.txt", 16, 16).lines.size());
+}
+
+static bool countBytes(const uint8_t* data, size_t length, void* context) {
+    (void)data;
+    *static_cast<size_t*>(context) += length;
+    return true;
+}
+
+void test_chunks_cover_file(void) {
+    EARS_memFs fs;
+    std::string text(10000, 'a');
+    fs.writeFile("/f.bin", text.data(), text.size());
+    uint8_t chunk[512];
+    size_t seen = 0;
+    TEST_ASSERT_EQUAL(text.size(), EARS_readChunks(fs, "/f.bin", chunk, sizeof(chunk), countBytes, &seen));
+    TEST_ASSERT_EQUAL(text.size(), seen);
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool countLine(const char* line, size_t length, bool truncated, void* context) {
+    (void)line;
+    (void)truncated;
+    *static_cast<size_t*>(context) += length;
+    return true;
+}
+
+/*
+  A 16 MB log: readFile() then split vs readLines() through 512 + 256 bytes
+*/
+void benchmark_read_lines(void) {
+    EARS_memFs fs;
+    std::string text;
+    char line[128];
+    for (unsigned i = 0; text.size() < 16u * 1048576u; i++) {
+        int n = snprintf(line, sizeof(line), "2026-10-16 12:00:%02u [INFO ] entry %u from the logger\n", i % 60, i);
+        text.append(line, (size_t)n);
+    }
+    fs.writeFile("/logs/debug.log", text.data(), text.size());
+    double mb = text.size() / 1048576.0;
+
+    uint64_t start = nowNs();
+    std::string whole;
+    fs.readFile("/logs/debug.log", whole);
+    size_t wholeChars = 0;
+    size_t from = 0;
+    while (from < whole.size()) {
+        size_t newline = whole.find('\n', from);
+        if (newline == std::string::npos) newline = whole.size();
+        wholeChars += newline - from;
+        from = newline + 1;
+    }
+    double wholeS = (nowNs() - start) / 1e9;
+    size_t wholeHeld = whole.capacity();
+
+    uint8_t chunk[512];
+    char lineBuffer[256];
+    size_t chunkChars = 0;
+    start = nowNs();
+    EARS_readLines(fs, "/logs/debug.log", chunk, sizeof(chunk), lineBuffer, sizeof(lineBuffer), countLine, &chunkChars);
+    double chunkS = (nowNs() - start) / 1e9;
+
+    printf("[bench] whole file: %7.1f MB/s, %u bytes held\n", mb / wholeS, (unsigned)wholeHeld);
+    printf("[bench] readLines:  %7.1f MB/s, %u bytes held\n", mb / chunkS, (unsigned)(sizeof(chunk) + sizeof(lineBuffer)));
+    TEST_ASSERT_EQUAL(wholeChars, chunkChars);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_lines_independent_of_chunk_size);
+    RUN_TEST(test_long_lines_are_cut_and_skipped);
+    RUN_TEST(test_visitor_stops_early);
+    RUN_TEST(test_empty_and_missing_files);
+    RUN_TEST(test_chunks_cover_file);
+    RUN_TEST(benchmark_read_lines);
+    return UNITY_END();
+}
@@ -0,0 +1,257 @@
+/**
+ * @file test_host_log_binary.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the binary log format.
+ * @section tests Tests
+ * - Decoded messages match vsnprintf for every supported conversion.
+ * - FORMAT records are written once per file and found across files.
+ * - Arguments that do not fit a record decode as "?".
+ * - Encode time and bytes per entry against the text logger's path.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "EARS_logBinaryLib.h"
+#include "EARS_logBinaryDecoder.h"
+
+static const uint64_t BASE_US = 1768564800000000ULL;   // 2026-01-16 12:00:00 UTC
+
+/*
+  Log file under construction, written the way EARS_logger writes it
+*/
+struct BinaryFile {
+    EARS_logBinaryWriter writer;
+    std::vector<uint8_t> bytes;
+
+    BinaryFile() {
+        writer.begin(BASE_US);
+        uint8_t header[EARS_logBinaryWriter::FILE_HEADER_BYTES];
+        size_t length = writer.fileHeader(header, sizeof(header));
+        bytes.insert(bytes.end(), header, header + length);
+    }
+
+    void logf(uint64_t nowUs, uint8_t level, size_t capacity, const char* format, ...) {
+        uint8_t record[560];
+        uint32_t id;
+        size_t formatLength = writer.formatRecord(record, sizeof(record), format, id);
+        va_list args;
+        va_start(args, format);
+        size_t length = writer.entry(record + formatLength, capacity, nowUs, level, id, format, args);
+        va_end(args);
+        bytes.insert(bytes.end(), record, record + formatLength + length);
+    }
+};
+
+static std::string expected(const char* format, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return buffer;
+}
+
+static std::vector<LogBinaryLine> decodeAll(const BinaryFile& file) {
+    EARS_logBinaryDecoder decoder;
+    std::vector<LogBinaryLine> lines;
+    TEST_ASSERT_TRUE(decoder.decode(file.bytes.data(), file.bytes.size(), lines));
+    return lines;
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+#define ROUND_TRIP(format, ...) do { \
+        BinaryFile file; \
+        file.logf(BASE_US, 3, 271, format, __VA_ARGS__); \
+        std::vector<LogBinaryLine> lines = decodeAll(file); \
+        TEST_ASSERT_EQUAL(1, lines.size()); \
+        TEST_ASSERT_EQUAL_STRING(expected(format, __VA_ARGS__).c_str(), lines[0].message.c_str()); \
+    } while (0)
+
+void test_integers_round_trip(void) {
+    ROUND_TRIP("Sensor %d reading %u mV", -3, 1234u);
+    ROUND_TRIP("%ld %lld %i", -2147483647L - 1, -9000000000000LL, 0);
+    ROUND_TRIP("%hhd %hd %hhu", -5, -30000, 250);
+    ROUND_TRIP("%08x %X %o %#x", 0xBEEFu, 0xABCDu, 8u, 255u);
+    ROUND_TRIP("%zu %llu", (size_t)4096, 18446744073709551615ULL);
+    ROUND_TRIP("%5d|%-5d|%+d", 42, 42, 42);
+}
+
+void test_floats_strings_and_chars_round_trip(void) {
+    ROUND_TRIP("Max file size: %d bytes (%.2f MB)", 1048576, 1048576 / 1048576.0);
+    ROUND_TRIP("%e %g %10.3f", 12345.678, 0.0001, -3.14159);
+    ROUND_TRIP("Log file: %s", "/logs/debug.log");
+    ROUND_TRIP("[%-8s] [%.3s] %c%c", "left", "truncated", 'O', 'K');
+    ROUND_TRIP("%*d|%.*f|%*.*s", 6, 7, 2, 2.5, 8, 3, "abcdef");
+    ROUND_TRIP("100%% done, %d%%", 50);
+}
+
+void test_text_records_and_timestamps(void) {
+    BinaryFile file;
+    uint8_t record[128];
+    size_t length = file.writer.text(record, sizeof(record), BASE_US + 1500, 4, "=== Logger Initialized ===");
+    file.bytes.insert(file.bytes.end(), record, record + length);
+    file.logf(BASE_US - 250, 1, 271, "late clock %d", 1);
+
+    std::vector<LogBinaryLine> lines = decodeAll(file);
+    TEST_ASSERT_EQUAL(2, lines.size());
+    TEST_ASSERT_EQUAL_STRING("[2026-01-16 12:00:00.001500] [DEBUG] === Logger Initialized ===",
+                             EARS_logBinaryDecoder::toText(lines[0]).c_str());
+    TEST_ASSERT_EQUAL_STRING("[2026-01-16 11:59:59.999750] [ERROR] late clock 1",
+                             EARS_logBinaryDecoder::toText(lines[1]).c_str());
+}
+
+void test_format_written_once_per_file(void) {
+    BinaryFile file;
+    file.logf(BASE_US, 3, 271, "tick %d", 1);
+    size_t first = file.bytes.size();
+    file.logf(BASE_US, 3, 271, "tick %d", 2);
+    size_t second = file.bytes.size() - first;
+    TEST_ASSERT_LESS_THAN(first - EARS_logBinaryWriter::FILE_HEADER_BYTES, second);
+
+    // New file - the format must be written again
+    file.writer.resetDictionary();
+    uint8_t record[64];
+    uint32_t id;
+    TEST_ASSERT_GREATER_THAN(0, file.writer.formatRecord(record, sizeof(record), "tick %d", id));
+    TEST_ASSERT_EQUAL(0, file.writer.formatRecord(record, sizeof(record), "tick %d", id));
+}
+
+void test_formats_learned_across_files(void) {
+    BinaryFile older;
+    older.logf(BASE_US, 3, 271, "value %d", 7);
+
+    // Entry whose FORMAT record landed in the older file (async rotation)
+    BinaryFile newer;
+    uint32_t id;
+    uint8_t scratch[64];
+    newer.writer.formatRecord(scratch, sizeof(scratch), "value %d", id);
+    newer.logf(BASE_US, 3, 271, "value %d", 8);
+
+    EARS_logBinaryDecoder alone;
+    std::vector<LogBinaryLine> lines;
+    TEST_ASSERT_TRUE(alone.decode(newer.bytes.data(), newer.bytes.size(), lines));
+    TEST_ASSERT_EQUAL(1, alone.unknownFormats());
+
+    EARS_logBinaryDecoder decoder;
+    TEST_ASSERT_EQUAL(1, decoder.learnFormats(older.bytes.data(), older.bytes.size()));
+    lines.clear();
+    TEST_ASSERT_TRUE(decoder.decode(newer.bytes.data(), newer.bytes.size(), lines));
+    TEST_ASSERT_EQUAL_STRING("value 8", lines[0].message.c_str());
+    TEST_ASSERT_EQUAL(0, decoder.unknownFormats());
+}
+
+void test_arguments_that_do_not_fit_decode_as_unknown(void) {
+    BinaryFile file;
+    // 7 byte header (offset 0) plus room for the first argument only
+    file.logf(BASE_US, 3, 7 + 1, "%d and %d and %s", 5, 6, "gone");
+    std::vector<LogBinaryLine> lines = decodeAll(file);
+    TEST_ASSERT_EQUAL_STRING("5 and ? and ?", lines[0].message.c_str());
+}
+
+void test_cut_off_file_stops_cleanly(void) {
+    BinaryFile file;
+    file.logf(BASE_US, 3, 271, "first %s", "entry");
+    size_t whole = file.bytes.size();
+    file.logf(BASE_US, 3, 271, "second %s", "entry");
+
+    // Power cut in the middle of the last append
+    EARS_logBinaryDecoder decoder;
+    std::vector<LogBinaryLine> lines;
+    TEST_ASSERT_FALSE(decoder.decode(file.bytes.data(), whole + 3, lines));
+    TEST_ASSERT_EQUAL(1, lines.size());
+    TEST_ASSERT_EQUAL_STRING("first entry", lines[0].message.c_str());
+}
+
+/*
+  The text path EARS_logger runs per LOG_*F call: vsnprintf the message,
+  build the timestamp string, then snprintf the whole line.
+*/
+static size_t textEntry(char* out, size_t capacity, const char* format, ...) {
+    char message[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    time_t seconds = (time_t)(BASE_US / 1000000ULL);
+    struct tm timeinfo;
+    localtime_r(&seconds, &timeinfo);
+    char timestamp[64];
+    snprintf(timestamp, sizeof(timestamp), "%04d-%02d-%02d %02d:%02d:%02d",
+             timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+             timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+    std::string stamp(timestamp);
+    return (size_t)snprintf(out, capacity, "[%s] [%s] %s\n", stamp.c_str(), "INFO", message);
+}
+
+static size_t binaryEntry(EARS_logBinaryWriter& writer, uint8_t* out, size_t capacity, const char* format, ...) {
+    uint32_t id;
+    size_t length = writer.formatRecord(out, capacity, format, id);
+    va_list args;
+    va_start(args, format);
+    length += writer.entry(out + length, capacity - length, BASE_US + 1234, 3, id, format, args);
+    va_end(args);
+    return length;
+}
+
+void benchmark_text_vs_binary(void) {
+    static const char FORMAT[] = "Sensor %d reading %u mV, %.2f V, state %s";
+    const size_t calls = 200000;
+    char text[560];
+    uint8_t binary[560];
+    size_t textBytes = 0;
+    size_t binaryBytes = 0;
+
+    uint64_t start = nowNs();
+    for (size_t i = 0; i < calls; i++) {
+        textBytes += textEntry(text, sizeof(text), FORMAT, (int)(i & 7), (unsigned)(1200 + (i & 63)), 3.3, "OK");
+    }
+    uint64_t textNs = nowNs() - start;
+
+    EARS_logBinaryWriter writer;
+    writer.begin(BASE_US);
+    start = nowNs();
+    for (size_t i = 0; i < calls; i++) {
+        binaryBytes += binaryEntry(writer, binary, sizeof(binary), FORMAT, (int)(i & 7), (unsigned)(1200 + (i & 63)), 3.3, "OK");
+    }
+    uint64_t binaryNs = nowNs() - start;
+
+    printf("[bench] text:   %.0f ns/call, %.1f bytes/call\n", (double)textNs / calls, (double)textBytes / calls);
+    printf("[bench] binary: %.0f ns/call, %.1f bytes/call\n", (double)binaryNs / calls, (double)binaryBytes / calls);
+    printf("[bench] binary is %.1fx faster and %.1fx smaller\n",
+           (double)textNs / (double)binaryNs, (double)textBytes / (double)binaryBytes);
+
+    TEST_ASSERT_LESS_THAN(textBytes / 2, binaryBytes);
+    TEST_ASSERT_LESS_THAN(textNs, binaryNs);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_integers_round_trip);
+    RUN_TEST(test_floats_strings_and_chars_round_trip);
+    RUN_TEST(test_text_records_and_timestamps);
+    RUN_TEST(test_format_written_once_per_file);
+    RUN_TEST(test_formats_learned_across_files);
+    RUN_TEST(test_arguments_that_do_not_fit_decode_as_unknown);
+    RUN_TEST(test_cut_off_file_stops_cleanly);
+    RUN_TEST(benchmark_text_vs_binary);
+    return UNITY_END();
+}
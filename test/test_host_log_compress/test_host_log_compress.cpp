@@ -0,0 +1,360 @@
+/**
+ * @file test_host_log_compress.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for rotated log compression.
+ * @section tests Tests
+ * - LZ4 blocks round-trip for text, runs, random and tiny inputs.
+ * - Files round-trip through EARS_memFs and the streaming reader.
+ * - Incompressible blocks are stored, plain files pass through.
+ * - Damaged files stop the reader without reading out of bounds.
+ * - Ratio and CPU cost on a text and a binary log corpus.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "EARS_memFs.h"
+#include "EARS_logCompressLib.h"
+#include "EARS_logCompressReader.h"
+#include "EARS_logBinaryLib.h"
+
+static const uint64_t BASE_US = 1768564800000000ULL;   // 2026-01-16 12:00:00 UTC
+
+static std::vector<uint8_t> compressorWorkspace(EARS_logCompressor::workspaceBytes(EARS_logCompressor::DEFAULT_BLOCK_BYTES));
+static std::vector<uint8_t> readerWorkspace(EARS_logCompressReader::workspaceBytes(EARS_logCompressor::DEFAULT_BLOCK_BYTES));
+static uint16_t table[EARS_lz4Block::TABLE_BYTES / sizeof(uint16_t)];
+
+/*
+  Deterministic pseudo random numbers for the corpus
+*/
+static uint32_t lcgState = 1;
+static uint32_t nextRandom() {
+    lcgState = lcgState * 1664525u + 1013904223u;
+    return lcgState >> 8;
+}
+
+/*
+  A day on the device: typical messages from the modules that log, with
+  the timestamps and readings changing from line to line
+*/
+static const char* const LEVELS[] = { "ERROR", "WARN", "INFO", "DEBUG" };
+
+static void corpusCall(uint32_t pick, char* message, size_t size, int& level, const char*& format) {
+    switch (pick % 10) {
+        case 0: format = "Sensor %d reading %u mV, %.2f V, state %s"; level = 3;
+            snprintf(message, size, format, (int)(pick & 7), 1200 + (pick & 63), 3.3, "OK"); break;
+        case 1: format = "Backlight set to %d%%"; level = 2;
+            snprintf(message, size, format, (int)(pick % 101)); break;
+        case 2: format = "Touch at x=%d y=%d pressure %d"; level = 3;
+            snprintf(message, size, format, (int)(pick % 480), (int)(pick % 320), (int)(pick % 255)); break;
+        case 3: format = "Free heap %u bytes, PSRAM %u bytes, largest block %u"; level = 3;
+            snprintf(message, size, format, 180000 + (pick % 5000), 7800000 + (pick % 90000), 110000 + (pick % 3000)); break;
+        case 4: format = "Screen saver %s after %u s idle"; level = 2;
+            snprintf(message, size, format, (pick & 1) ? "started" : "stopped", pick % 600); break;
+        case 5: format = "SD card write %u bytes in %u us"; level = 3;
+            snprintf(message, size, format, 512 + (pick % 8192), 900 + (pick % 4000)); break;
+        case 6: format = "EEZ-FLOW: %s"; level = 2;
+            snprintf(message, size, format, (pick & 2) ? "page MAIN loaded" : "button SETTINGS pressed"); break;
+        case 7: format = "NVS key %s updated"; level = 3;
+            snprintf(message, size, format, (pick & 4) ? "zap_number" : "brightness"); break;
+        case 8: format = "Retrying SD mount, attempt %d of %d"; level = 1;
+            snprintf(message, size, format, (int)(pick % 3) + 1, 3); break;
+        default: format = "Loop time %u us, %u frames"; level = 3;
+            snprintf(message, size, format, 4000 + (pick % 9000), pick % 60); break;
+    }
+}
+
+static std::string textCorpus(size_t bytes) {
+    std::string corpus;
+    lcgState = 1;
+    uint64_t nowUs = BASE_US;
+    while (corpus.size() < bytes) {
+        nowUs += 1000 + nextRandom() % 250000;
+        time_t seconds = (time_t)(nowUs / 1000000);
+        struct tm parts;
+        gmtime_r(&seconds, &parts);
+        char stamp[32];
+        strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &parts);
+
+        char message[160];
+        int level;
+        const char* format;
+        corpusCall(nextRandom(), message, sizeof(message), level, format);
+        char line[220];
+        int length = snprintf(line, sizeof(line), "[%s] [%s] %s\n", stamp, LEVELS[level], message);
+        corpus.append(line, (size_t)length);
+    }
+    return corpus;
+}
+
+static void binaryAppend(std::string& out, EARS_logBinaryWriter& writer, uint64_t nowUs, uint8_t level, const char* format, ...) {
+    uint8_t record[560];
+    uint32_t id;
+    size_t formatLength = writer.formatRecord(record, sizeof(record), format, id);
+    va_list args;
+    va_start(args, format);
+    size_t length = writer.entry(record + formatLength, sizeof(record) - formatLength, nowUs, level, id, format, args);
+    va_end(args);
+    out.append((const char*)record, formatLength + length);
+}
+
+static std::string binaryCorpus(size_t bytes) {
+    std::string corpus;
+    EARS_logBinaryWriter writer;
+    writer.begin(BASE_US);
+    uint8_t header[EARS_logBinaryWriter::FILE_HEADER_BYTES];
+    corpus.append((const char*)header, writer.fileHeader(header, sizeof(header)));
+
+    lcgState = 1;
+    uint64_t nowUs = BASE_US;
+    while (corpus.size() < bytes) {
+        nowUs += 1000 + nextRandom() % 250000;
+        uint32_t pick = nextRandom();
+        char message[160];
+        int level;
+        const char* format;
+        corpusCall(pick, message, sizeof(message), level, format);
+        // Same arguments as the text corpus, encoded raw
+        switch (pick % 10) {
+            case 0: binaryAppend(corpus, writer, nowUs, level, format, (int)(pick & 7), 1200 + (pick & 63), 3.3, "OK"); break;
+            case 1: binaryAppend(corpus, writer, nowUs, level, format, (int)(pick % 101)); break;
+            case 2: binaryAppend(corpus, writer, nowUs, level, format, (int)(pick % 480), (int)(pick % 320), (int)(pick % 255)); break;
+            case 3: binaryAppend(corpus, writer, nowUs, level, format, 180000 + (pick % 5000), 7800000 + (pick % 90000), 110000 + (pick % 3000)); break;
+            case 4: binaryAppend(corpus, writer, nowUs, level, format, (pick & 1) ? "started" : "stopped", pick % 600); break;
+            case 5: binaryAppend(corpus, writer, nowUs, level, format, 512 + (pick % 8192), 900 + (pick % 4000)); break;
+            case 6: binaryAppend(corpus, writer, nowUs, level, format, (pick & 2) ? "page MAIN loaded" : "button SETTINGS pressed"); break;
+            case 7: binaryAppend(corpus, writer, nowUs, level, format, (pick & 4) ? "zap_number" : "brightness"); break;
+            case 8: binaryAppend(corpus, writer, nowUs, level, format, (int)(pick % 3) + 1, 3); break;
+            default: binaryAppend(corpus, writer, nowUs, level, format, 4000 + (pick % 9000), pick % 60); break;
+        }
+    }
+    return corpus;
+}
+
+static std::string randomBytes(size_t bytes) {
+    std::string data;
+    lcgState = 99;
+    for (size_t i = 0; i < bytes; i++) {
+        data.push_back((char)(nextRandom() & 0xFF));
+    }
+    return data;
+}
+
+static void assertBlockRoundTrip(const std::string& raw) {
+    std::vector<uint8_t> packed(EARS_lz4Block::bound(raw.size()));
+    size_t packedLength = EARS_lz4Block::compress((const uint8_t*)raw.data(), raw.size(),
+                                                  packed.data(), packed.size(), table);
+    TEST_ASSERT_NOT_EQUAL(0, packedLength);
+    std::vector<uint8_t> back(raw.size());
+    TEST_ASSERT_EQUAL(raw.size(), EARS_lz4Block::decompress(packed.data(), packedLength, back.data(), back.size()));
+    TEST_ASSERT_EQUAL_MEMORY(raw.data(), back.data(), raw.size());
+}
+
+static std::string readAll(EARS_memFs& fs, const char* path, size_t chunk, bool& failed) {
+    EARS_logCompressReader reader;
+    TEST_ASSERT_TRUE(reader.begin(readerWorkspace.data(), readerWorkspace.size()));
+    std::string out;
+    if (!reader.open(fs, path)) {
+        failed = true;
+        return out;
+    }
+    std::vector<uint8_t> buffer(chunk);
+    size_t got;
+    while ((got = reader.read(buffer.data(), buffer.size())) > 0) {
+        out.append((const char*)buffer.data(), got);
+    }
+    failed = reader.failed();
+    return out;
+}
+
+static LogCompressStats compressIn(EARS_memFs& fs, const std::string& content) {
+    fs.writeFile("/logs/debug.log.1", content.data(), content.size());
+    EARS_logCompressor compressor;
+    TEST_ASSERT_TRUE(compressor.begin(compressorWorkspace.data(), compressorWorkspace.size()));
+    LogCompressStats stats;
+    TEST_ASSERT_TRUE(compressor.compressFile(fs, "/logs/debug.log.1", "/logs/debug.log.1.tmp", stats));
+    return stats;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_blocks_round_trip(void) {
+    assertBlockRoundTrip("a");
+    assertBlockRoundTrip("short line\n");
+    assertBlockRoundTrip("exactly thirteen!");
+    assertBlockRoundTrip(std::string(5000, 'z'));
+    assertBlockRoundTrip(std::string(300, 'a') + std::string(300, 'b') + std::string(17, 'a'));
+    assertBlockRoundTrip(textCorpus(8192).substr(0, 8192));
+    assertBlockRoundTrip(randomBytes(4096));
+
+    // Long literal and match runs need the 255 length extensions
+    std::string mixed = randomBytes(700) + std::string(2000, 'q') + randomBytes(300);
+    assertBlockRoundTrip(mixed);
+}
+
+void test_files_round_trip_through_reader(void) {
+    EARS_memFs fs;
+    std::string content = textCorpus(100000);
+    LogCompressStats stats = compressIn(fs, content);
+    TEST_ASSERT_EQUAL(content.size(), stats.rawBytes);
+    TEST_ASSERT_EQUAL(fs.peek("/logs/debug.log.1.tmp")->size(), stats.packedBytes);
+    TEST_ASSERT_TRUE(stats.ratio() > 2.0f);
+    TEST_ASSERT_TRUE(EARS_logCompressor::isCompressed(fs, "/logs/debug.log.1.tmp"));
+    TEST_ASSERT_FALSE(EARS_logCompressor::isCompressed(fs, "/logs/debug.log.1"));
+
+    // Odd chunk sizes cross block boundaries at every offset
+    const size_t chunks[] = { 1, 7, 100, 8192, 70000 };
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        bool failed = true;
+        std::string back = readAll(fs, "/logs/debug.log.1.tmp", chunks[i], failed);
+        TEST_ASSERT_FALSE(failed);
+        TEST_ASSERT_TRUE(back == content);
+    }
+}
+
+void test_incompressible_blocks_are_stored(void) {
+    EARS_memFs fs;
+    std::string content = randomBytes(20000);
+    LogCompressStats stats = compressIn(fs, content);
+    TEST_ASSERT_EQUAL(stats.blocks, stats.storedBlocks);
+    TEST_ASSERT_EQUAL(content.size() + EARS_logCompressor::FILE_HEADER_BYTES +
+                      stats.blocks * EARS_logCompressor::BLOCK_HEADER_BYTES, stats.packedBytes);
+
+    bool failed = true;
+    TEST_ASSERT_TRUE(readAll(fs, "/logs/debug.log.1.tmp", 333, failed) == content);
+    TEST_ASSERT_FALSE(failed);
+}
+
+void test_empty_and_plain_files(void) {
+    EARS_memFs fs;
+    LogCompressStats stats = compressIn(fs, "");
+    TEST_ASSERT_EQUAL(0, stats.blocks);
+    TEST_ASSERT_EQUAL(EARS_logCompressor::FILE_HEADER_BYTES, stats.packedBytes);
+    bool failed = true;
+    TEST_ASSERT_EQUAL(0, readAll(fs, "/logs/debug.log.1.tmp", 64, failed).size());
+    TEST_ASSERT_FALSE(failed);
+
+    // A generation not compressed yet reads the same way
+    std::string plain = textCorpus(5000);
+    fs.writeFile("/logs/debug.log", plain.data(), plain.size());
+    TEST_ASSERT_TRUE(readAll(fs, "/logs/debug.log", 1000, failed) == plain);
+    TEST_ASSERT_FALSE(failed);
+
+    // Missing source
+    EARS_logCompressor compressor;
+    TEST_ASSERT_TRUE(compressor.begin(compressorWorkspace.data(), compressorWorkspace.size()));
+    TEST_ASSERT_FALSE(compressor.compressFile(fs, "/logs/missing", "/logs/missing.tmp", stats));
+    TEST_ASSERT_FALSE(fs.fileExists("/logs/missing.tmp"));
+}
+
+void test_damaged_files_stop_reader(void) {
+    EARS_memFs fs;
+    std::string content = textCorpus(40000);
+    compressIn(fs, content);
+    std::string packed = *fs.peek("/logs/debug.log.1.tmp");
+
+    // Cut off in the middle of a block
+    fs.writeFile("/logs/cut", packed.data(), packed.size() - 10);
+    bool failed = false;
+    std::string back = readAll(fs, "/logs/cut", 512, failed);
+    TEST_ASSERT_TRUE(failed);
+    TEST_ASSERT_TRUE(back.size() < content.size());
+    TEST_ASSERT_TRUE(content.compare(0, back.size(), back) == 0);
+
+    // Bit flips anywhere must never crash or overrun; most are detected
+    int detected = 0;
+    for (size_t i = EARS_logCompressor::FILE_HEADER_BYTES; i < packed.size(); i += 97) {
+        std::string damaged = packed;
+        damaged[i] ^= 0x5A;
+        fs.writeFile("/logs/flip", damaged.data(), damaged.size());
+        back = readAll(fs, "/logs/flip", 4096, failed);
+        if (failed || back != content) {
+            detected++;
+        }
+    }
+    TEST_ASSERT_TRUE(detected > 0);
+
+    // Block size larger than the reader accepts
+    std::string huge = packed;
+    huge[4] = 0x00;
+    huge[5] = (char)0x80;
+    fs.writeFile("/logs/huge", huge.data(), huge.size());
+    readAll(fs, "/logs/huge", 64, failed);
+    TEST_ASSERT_TRUE(failed);
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void benchmarkCorpus(const char* name, const std::string& content) {
+    EARS_memFs fs;
+    fs.writeFile("/logs/debug.log.1", content.data(), content.size());
+    EARS_logCompressor compressor;
+    TEST_ASSERT_TRUE(compressor.begin(compressorWorkspace.data(), compressorWorkspace.size()));
+
+    const int rounds = 5;
+    LogCompressStats stats;
+    uint64_t start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        TEST_ASSERT_TRUE(compressor.compressFile(fs, "/logs/debug.log.1", "/logs/debug.log.1.tmp", stats));
+    }
+    uint64_t compressNs = (nowNs() - start) / rounds;
+
+    fs.resetStats();
+    bool failed = true;
+    std::string back;
+    start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        back = readAll(fs, "/logs/debug.log.1.tmp", 4096, failed);
+    }
+    uint64_t decompressNs = (nowNs() - start) / rounds;
+    uint32_t readOps = fs.getStats().reads / rounds;
+
+    TEST_ASSERT_FALSE(failed);
+    TEST_ASSERT_TRUE(back == content);
+
+    double megabytes = content.size() / 1048576.0;
+    printf("[bench] %s: %u -> %u bytes, ratio %.2f, %u blocks (%u stored)\n", name,
+           (unsigned)stats.rawBytes, (unsigned)stats.packedBytes, stats.ratio(),
+           (unsigned)stats.blocks, (unsigned)stats.storedBlocks);
+    printf("[bench] %s: compress %.1f ms/MB (%.0f MB/s), decompress %.1f ms/MB (%.0f MB/s), %u reads\n", name,
+           compressNs / 1e6 / megabytes, megabytes / (compressNs / 1e9),
+           decompressNs / 1e6 / megabytes, megabytes / (decompressNs / 1e9), (unsigned)readOps);
+}
+
+/*
+  1 MB generations, the default max_file_size_bytes
+*/
+void benchmark_ratio_and_cpu_cost(void) {
+    printf("[bench] workspace: compressor %u bytes, reader %u bytes\n",
+           (unsigned)compressorWorkspace.size(), (unsigned)readerWorkspace.size());
+    benchmarkCorpus("text log  ", textCorpus(1048576));
+    benchmarkCorpus("binary log", binaryCorpus(1048576));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_blocks_round_trip);
+    RUN_TEST(test_files_round_trip_through_reader);
+    RUN_TEST(test_incompressible_blocks_are_stored);
+    RUN_TEST(test_empty_and_plain_files);
+    RUN_TEST(test_damaged_files_stop_reader);
+    RUN_TEST(benchmark_ratio_and_cpu_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,227 @@
+/**
+ * @file test_host_log_filter.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for per-module log filtering.
+ * @section tests Tests
+ * - Compiled out and runtime disabled statements never evaluate arguments.
+ * - Tag levels, names and parsing.
+ * - Assigning a whole table never shows a module an interim level.
+ * - Cost of a disabled statement: eager call vs runtime vs compile-time filter.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+// FLOW is built in up to WARN only, everything else up to DEBUG
+#define EARS_LOG_COMPILE_LEVEL EARS_LOG_LEVEL_DEBUG
+#define EARS_LOG_COMPILE_LEVEL_FLOW EARS_LOG_LEVEL_WARN
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "EARS_logFilterLib.h"
+
+/*
+  Stand-in for EARS_logger: a global level, the tag table and a sink that
+  counts calls. The sink is out of line like the logger's methods.
+*/
+static uint8_t globalLevel = EARS_LOG_LEVEL_DEBUG;
+static EARS_logTagLevels tagLevels;
+static int sinkCalls = 0;
+static int argumentEvaluations = 0;
+
+__attribute__((noinline)) static void sink(uint8_t level, const char* format, ...) {
+    // What logf() did before the macros filtered: check the level inside
+    if (level > globalLevel) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    char buffer[128];
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    sinkCalls++;
+}
+
+static bool wouldLog(LogTag tag, uint8_t level) {
+    return level <= globalLevel && tagLevels.allows(tag, level);
+}
+
+__attribute__((noinline)) static int expensiveArgument() {
+    argumentEvaluations++;
+    return argumentEvaluations;
+}
+
+#define TEST_LOG(tag, level, fmt, ...) \
+    EARS_LOG_IF(tag, EARS_LOG_LEVEL_##level, wouldLog(LogTag::tag, EARS_LOG_LEVEL_##level), \
+                sink(EARS_LOG_LEVEL_##level, fmt, __VA_ARGS__))
+
+// The LOG_*F macros before filtering: always evaluate and call
+#define EAGER_LOG(level, fmt, ...) sink(EARS_LOG_LEVEL_##level, fmt, __VA_ARGS__)
+
+void setUp(void) {
+    globalLevel = EARS_LOG_LEVEL_DEBUG;
+    tagLevels.setAll(EARS_LOG_LEVEL_DEBUG);
+    sinkCalls = 0;
+    argumentEvaluations = 0;
+}
+
+void tearDown(void) {
+}
+
+void test_compile_levels_are_constant(void) {
+    TEST_ASSERT_TRUE(EARS_LOG_COMPILED(SDCARD, EARS_LOG_LEVEL_DEBUG));
+    TEST_ASSERT_TRUE(EARS_LOG_COMPILED(FLOW, EARS_LOG_LEVEL_WARN));
+    TEST_ASSERT_FALSE(EARS_LOG_COMPILED(FLOW, EARS_LOG_LEVEL_INFO));
+
+    // Usable where only constant expressions are allowed
+    static_assert(!EARS_LOG_COMPILED(FLOW, EARS_LOG_LEVEL_DEBUG), "FLOW DEBUG must be compiled out");
+}
+
+void test_compiled_out_statement_skips_arguments(void) {
+    TEST_LOG(FLOW, DEBUG, "value %d", expensiveArgument());
+    TEST_LOG(FLOW, INFO, "value %d", expensiveArgument());
+    TEST_ASSERT_EQUAL(0, argumentEvaluations);
+    TEST_ASSERT_EQUAL(0, sinkCalls);
+
+    TEST_LOG(FLOW, WARN, "value %d", expensiveArgument());
+    TEST_ASSERT_EQUAL(1, argumentEvaluations);
+    TEST_ASSERT_EQUAL(1, sinkCalls);
+}
+
+void test_runtime_tag_level_skips_arguments(void) {
+    tagLevels.set(LogTag::SDCARD, EARS_LOG_LEVEL_WARN);
+    TEST_LOG(SDCARD, DEBUG, "value %d", expensiveArgument());
+    TEST_LOG(SDCARD, INFO, "value %d", expensiveArgument());
+    TEST_ASSERT_EQUAL(0, argumentEvaluations);
+
+    TEST_LOG(SDCARD, ERROR, "value %d", expensiveArgument());
+    TEST_LOG(NVS, DEBUG, "value %d", expensiveArgument());
+    TEST_ASSERT_EQUAL(2, argumentEvaluations);
+    TEST_ASSERT_EQUAL(2, sinkCalls);
+}
+
+void test_global_level_still_applies(void) {
+    globalLevel = EARS_LOG_LEVEL_ERROR;
+    TEST_LOG(NVS, WARN, "value %d", expensiveArgument());
+    TEST_ASSERT_EQUAL(0, argumentEvaluations);
+    TEST_LOG(NVS, ERROR, "value %d", expensiveArgument());
+    TEST_ASSERT_EQUAL(1, sinkCalls);
+}
+
+void test_statement_form_is_safe_in_if_else(void) {
+    bool branch = false;
+    if (branch)
+        TEST_LOG(APP, INFO, "never %d", expensiveArgument());
+    else
+        sinkCalls += 10;
+    TEST_ASSERT_EQUAL(10, sinkCalls);
+}
+
+void test_tag_names_round_trip(void) {
+    for (size_t i = 0; i < (size_t)LogTag::COUNT; i++) {
+        LogTag tag;
+        TEST_ASSERT_TRUE(EARS_logTagLevels::parseTag(EARS_logTagLevels::tagName((LogTag)i), tag));
+        TEST_ASSERT_EQUAL(i, (size_t)tag);
+    }
+    LogTag tag;
+    TEST_ASSERT_TRUE(EARS_logTagLevels::parseTag("backlight", tag));
+    TEST_ASSERT_EQUAL((int)LogTag::BACKLIGHT, (int)tag);
+    TEST_ASSERT_FALSE(EARS_logTagLevels::parseTag("WIFI", tag));
+    TEST_ASSERT_EQUAL(EARS_LOG_LEVEL_NONE, tagLevels.get(LogTag::COUNT));
+}
+
+void test_assign_keeps_unchanged_levels_steady(void) {
+    tagLevels.set(LogTag::SDCARD, EARS_LOG_LEVEL_WARN);
+    std::atomic<bool> done(false);
+    std::atomic<int> wrongReads(0);
+    std::thread reader([&]() {
+        while (!done.load()) {
+            if (tagLevels.get(LogTag::SDCARD) != EARS_LOG_LEVEL_WARN) {
+                wrongReads++;
+            }
+        }
+    });
+
+    // Tables that only differ elsewhere, as each config change builds them
+    uint8_t levels[(size_t)LogTag::COUNT];
+    for (int round = 0; round < 20000; round++) {
+        for (size_t i = 0; i < (size_t)LogTag::COUNT; i++) {
+            levels[i] = (uint8_t)((round + i) % (EARS_LOG_LEVEL_DEBUG + 1));
+        }
+        levels[(size_t)LogTag::SDCARD] = EARS_LOG_LEVEL_WARN;
+        tagLevels.assign(levels);
+    }
+    done = true;
+    reader.join();
+
+    TEST_ASSERT_EQUAL(0, wrongReads.load());
+    for (size_t i = 0; i < (size_t)LogTag::COUNT; i++) {
+        TEST_ASSERT_EQUAL(levels[i], tagLevels.get((LogTag)i));
+    }
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  Disabled DEBUG statements, as in a production build with logging at INFO
+*/
+void benchmark_disabled_statement_cost(void) {
+    const int calls = 2000000;
+    globalLevel = EARS_LOG_LEVEL_INFO;
+
+    uint64_t start = nowNs();
+    for (int i = 0; i < calls; i++) {
+        EAGER_LOG(DEBUG, "value %d of %d", expensiveArgument(), i);
+    }
+    uint64_t eagerNs = nowNs() - start;
+    int eagerEvaluations = argumentEvaluations;
+
+    argumentEvaluations = 0;
+    start = nowNs();
+    for (int i = 0; i < calls; i++) {
+        TEST_LOG(SDCARD, DEBUG, "value %d of %d", expensiveArgument(), i);
+    }
+    uint64_t runtimeNs = nowNs() - start;
+    int runtimeEvaluations = argumentEvaluations;
+
+    argumentEvaluations = 0;
+    start = nowNs();
+    for (int i = 0; i < calls; i++) {
+        TEST_LOG(FLOW, DEBUG, "value %d of %d", expensiveArgument(), i);
+    }
+    uint64_t compiledNs = nowNs() - start;
+
+    printf("[bench] eager call:     %.2f ns/statement, %d argument evaluations\n",
+           (double)eagerNs / calls, eagerEvaluations);
+    printf("[bench] runtime filter: %.2f ns/statement, %d argument evaluations\n",
+           (double)runtimeNs / calls, runtimeEvaluations);
+    printf("[bench] compiled out:   %.2f ns/statement, %d argument evaluations\n",
+           (double)compiledNs / calls, argumentEvaluations);
+
+    TEST_ASSERT_EQUAL(calls, eagerEvaluations);
+    TEST_ASSERT_EQUAL(0, runtimeEvaluations);
+    TEST_ASSERT_EQUAL(0, argumentEvaluations);
+    TEST_ASSERT_EQUAL(0, sinkCalls);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_compile_levels_are_constant);
+    RUN_TEST(test_compiled_out_statement_skips_arguments);
+    RUN_TEST(test_runtime_tag_level_skips_arguments);
+    RUN_TEST(test_global_level_still_applies);
+    RUN_TEST(test_statement_form_is_safe_in_if_else);
+    RUN_TEST(test_tag_names_round_trip);
+    RUN_TEST(test_assign_keeps_unchanged_levels_steady);
+    RUN_TEST(benchmark_disabled_statement_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,279 @@
+/**
+ * @file test_host_log_mpsc.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host stress test for concurrent producers on the lock-free log ring.
+ * @section tests Tests
+ * - 1, 2 and 4 producer threads: nothing lost, per-producer order kept.
+ * - DROP_OLDEST under contention never reorders a producer's entries.
+ * - Contention cost per push against a mutex-protected ring.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "EARS_logRingLib.h"
+
+static const size_t SLOT_BYTES = 128;
+static const size_t ENTRY_BYTES = 64;      // A typical log line
+static const size_t MAX_PRODUCERS = 4;
+
+static uint8_t storage[64 * 1024];
+static char batch[8192];
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  Fixed-size entry: producer number and its sequence, padded to a line
+*/
+static void makeEntry(char* entry, uint32_t producer, uint32_t sequence) {
+    memset(entry, '.', ENTRY_BYTES);
+    memcpy(entry, &producer, sizeof(producer));
+    memcpy(entry + sizeof(producer), &sequence, sizeof(sequence));
+    entry[ENTRY_BYTES - 1] = '\n';
+}
+
+/*
+  Sink that checks every producer's entries arrive in push order
+*/
+struct OrderCheck {
+    uint32_t next[MAX_PRODUCERS];
+    uint32_t received;
+    uint32_t gaps;          // Entries skipped (drops)
+    uint32_t reordered;     // Entries older than one already seen
+
+    OrderCheck() : received(0), gaps(0), reordered(0) {
+        memset(next, 0, sizeof(next));
+    }
+};
+
+static bool orderSink(const char* data, size_t length, void* context) {
+    OrderCheck* check = static_cast<OrderCheck*>(context);
+    for (size_t offset = 0; offset + ENTRY_BYTES <= length; offset += ENTRY_BYTES) {
+        uint32_t producer;
+        uint32_t sequence;
+        memcpy(&producer, data + offset, sizeof(producer));
+        memcpy(&sequence, data + offset + sizeof(producer), sizeof(sequence));
+        if (sequence < check->next[producer]) {
+            check->reordered++;
+        } else {
+            check->gaps += sequence - check->next[producer];
+            check->next[producer] = sequence + 1;
+        }
+        check->received++;
+    }
+    return true;
+}
+
+/*
+  The previous ring design for comparison: one mutex around every push
+*/
+class MutexRing {
+public:
+    explicit MutexRing(size_t slots) : _entries(slots * ENTRY_BYTES), _slots(slots), _head(0), _count(0) {}
+
+    bool push(const char* data) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_count == _slots) {
+            return false;
+        }
+        memcpy(&_entries[((_head + _count) % _slots) * ENTRY_BYTES], data, ENTRY_BYTES);
+        _count++;
+        return true;
+    }
+
+    size_t drain(char* out, size_t capacity) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        size_t used = 0;
+        while (_count > 0 && used + ENTRY_BYTES <= capacity) {
+            memcpy(out + used, &_entries[_head * ENTRY_BYTES], ENTRY_BYTES);
+            used += ENTRY_BYTES;
+            _head = (_head + 1) % _slots;
+            _count--;
+        }
+        return used;
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<char> _entries;
+    size_t _slots;
+    size_t _head;
+    size_t _count;
+};
+
+struct RunResult {
+    double nsPerPush;
+    uint32_t p99;
+    uint32_t received;
+};
+
+static RunResult summarize(const std::vector<std::vector<uint32_t> >& samples, uint64_t elapsed,
+                           const OrderCheck& check) {
+    std::vector<uint32_t> all;
+    for (size_t p = 0; p < samples.size(); p++) {
+        all.insert(all.end(), samples[p].begin(), samples[p].end());
+    }
+    std::sort(all.begin(), all.end());
+
+    RunResult result;
+    result.nsPerPush = (double)elapsed / (double)all.size();
+    result.p99 = all[all.size() * 99 / 100];
+    result.received = check.received;
+    return result;
+}
+
+/*
+  producers threads each push perProducer entries against a live flusher
+*/
+static RunResult runLockFree(size_t producers, size_t perProducer, LogOverflowPolicy policy, OrderCheck& check) {
+    EARS_logRing ring;
+    TEST_ASSERT_TRUE(ring.begin(storage, sizeof(storage), SLOT_BYTES, policy));
+    ring.setBlockTimeout(5000);
+    EARS_logFlusher flusher;
+    TEST_ASSERT_TRUE(flusher.begin(&ring, batch, sizeof(batch), orderSink, &check, 5));
+
+    std::atomic<bool> stop(false);
+    std::thread worker([&flusher, &stop] { flusher.run(stop); });
+
+    std::vector<std::vector<uint32_t> > samples(producers);
+    std::vector<std::thread> threads;
+    uint64_t start = nowNs();
+    for (size_t p = 0; p < producers; p++) {
+        threads.push_back(std::thread([&ring, &samples, p, perProducer] {
+            char entry[ENTRY_BYTES];
+            samples[p].reserve(perProducer);
+            for (uint32_t i = 0; i < perProducer; i++) {
+                makeEntry(entry, (uint32_t)p, i);
+                uint64_t t0 = nowNs();
+                ring.push(entry, ENTRY_BYTES);
+                samples[p].push_back((uint32_t)(nowNs() - t0));
+            }
+        }));
+    }
+    for (size_t p = 0; p < producers; p++) {
+        threads[p].join();
+    }
+    uint64_t elapsed = nowNs() - start;
+    stop.store(true);
+    worker.join();
+
+    return summarize(samples, elapsed, check);
+}
+
+static RunResult runMutex(size_t producers, size_t perProducer, OrderCheck& check) {
+    MutexRing ring(sizeof(storage) / SLOT_BYTES);
+    std::atomic<bool> stop(false);
+    std::thread worker([&ring, &stop, &check] {
+        for (;;) {
+            size_t length = ring.drain(batch, sizeof(batch));
+            if (length) {
+                orderSink(batch, length, &check);
+            } else if (stop.load()) {
+                break;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<std::vector<uint32_t> > samples(producers);
+    std::vector<std::thread> threads;
+    uint64_t start = nowNs();
+    for (size_t p = 0; p < producers; p++) {
+        threads.push_back(std::thread([&ring, &samples, p, perProducer] {
+            char entry[ENTRY_BYTES];
+            samples[p].reserve(perProducer);
+            for (uint32_t i = 0; i < perProducer; i++) {
+                makeEntry(entry, (uint32_t)p, i);
+                uint64_t t0 = nowNs();
+                while (!ring.push(entry)) {
+                    std::this_thread::yield();
+                }
+                samples[p].push_back((uint32_t)(nowNs() - t0));
+            }
+        }));
+    }
+    for (size_t p = 0; p < producers; p++) {
+        threads[p].join();
+    }
+    uint64_t elapsed = nowNs() - start;
+    stop.store(true);
+    worker.join();
+    return summarize(samples, elapsed, check);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void checkLossless(size_t producers) {
+    const size_t perProducer = 50000;
+    OrderCheck check;
+    runLockFree(producers, perProducer, LogOverflowPolicy::BLOCK, check);
+
+    TEST_ASSERT_EQUAL(producers * perProducer, check.received);
+    TEST_ASSERT_EQUAL(0, check.gaps);
+    TEST_ASSERT_EQUAL(0, check.reordered);
+    for (size_t p = 0; p < producers; p++) {
+        TEST_ASSERT_EQUAL(perProducer, check.next[p]);
+    }
+}
+
+void test_one_producer_lossless_in_order(void) {
+    checkLossless(1);
+}
+
+void test_two_producers_lossless_in_order(void) {
+    checkLossless(2);
+}
+
+void test_four_producers_lossless_in_order(void) {
+    checkLossless(4);
+}
+
+void test_drop_oldest_keeps_producer_order(void) {
+    const size_t producers = 4;
+    const size_t perProducer = 100000;
+    OrderCheck check;
+    runLockFree(producers, perProducer, LogOverflowPolicy::DROP_OLDEST, check);
+
+    // Drops show up as gaps, never as entries going backwards
+    TEST_ASSERT_EQUAL(0, check.reordered);
+    TEST_ASSERT_GREATER_THAN(0, check.received);
+    TEST_ASSERT_LESS_OR_EQUAL(producers * perProducer, check.received + check.gaps);
+}
+
+void benchmark_contention_cost(void) {
+    const size_t perProducer = 200000;
+    for (size_t producers = 1; producers <= MAX_PRODUCERS; producers *= 2) {
+        OrderCheck check;
+        RunResult lockFree = runLockFree(producers, perProducer, LogOverflowPolicy::BLOCK, check);
+        OrderCheck mutexCheck;
+        RunResult mutex = runMutex(producers, perProducer, mutexCheck);
+        printf("[bench] %u producer(s): lock-free %.0f ns/push (p99 %u ns), mutex %.0f ns/push (p99 %u ns)\n",
+               (unsigned)producers, lockFree.nsPerPush, lockFree.p99, mutex.nsPerPush, mutex.p99);
+        TEST_ASSERT_EQUAL(producers * perProducer, lockFree.received);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_one_producer_lossless_in_order);
+    RUN_TEST(test_two_producers_lossless_in_order);
+    RUN_TEST(test_four_producers_lossless_in_order);
+    RUN_TEST(test_drop_oldest_keeps_producer_order);
+    RUN_TEST(benchmark_contention_cost);
+    return UNITY_END();
+}
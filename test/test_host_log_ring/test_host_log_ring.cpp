@@ -0,0 +1,223 @@
+/**
+ * @file test_host_log_ring.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the asynchronous log ring.
+ * @section tests Tests
+ * - Overflow policies and drop counters.
+ * - Producer latency and sustained throughput with a flusher thread.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "EARS_logRingLib.h"
+
+static const size_t SLOT_BYTES = 192;
+static const char LINE[] = "[2026-01-16 12:00:00] [DEBUG] Sensor 3 reading 1234 mV, state OK\n";
+
+static uint8_t storage[64 * 1024];
+
+/*
+  Sink that just counts bytes, so the benchmark measures the ring itself
+*/
+static bool countingSink(const char* data, size_t length, void* context) {
+    (void)data;
+    *static_cast<size_t*>(context) += length;
+    return true;
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_push_drain_preserves_order(void) {
+    EARS_logRing ring;
+    TEST_ASSERT_TRUE(ring.begin(storage, 8 * SLOT_BYTES, SLOT_BYTES, LogOverflowPolicy::DROP_NEWEST));
+
+    TEST_ASSERT_TRUE(ring.push("a\n", 2));
+    TEST_ASSERT_TRUE(ring.push("bb\n", 3));
+    TEST_ASSERT_TRUE(ring.push("ccc\n", 4));
+
+    char out[64];
+    size_t length = ring.drain(out, sizeof(out));
+    TEST_ASSERT_EQUAL(9, length);
+    TEST_ASSERT_EQUAL_MEMORY("a\nbb\nccc\n", out, 9);
+    TEST_ASSERT_EQUAL(0, ring.pending());
+}
+
+void test_drain_never_splits_entries(void) {
+    EARS_logRing ring;
+    TEST_ASSERT_TRUE(ring.begin(storage, 8 * SLOT_BYTES, SLOT_BYTES, LogOverflowPolicy::DROP_NEWEST));
+    ring.push("12345", 5);
+    ring.push("67890", 5);
+
+    char out[8];
+    TEST_ASSERT_EQUAL(5, ring.drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL(1, ring.pending());
+    TEST_ASSERT_EQUAL(5, ring.drain(out, sizeof(out)));
+}
+
+void test_drop_newest_counts_rejections(void) {
+    EARS_logRing ring;
+    TEST_ASSERT_TRUE(ring.begin(storage, 4 * SLOT_BYTES, SLOT_BYTES, LogOverflowPolicy::DROP_NEWEST));
+    for (int i = 0; i < 6; i++) {
+        char c = (char)('0' + i);
+        ring.push(&c, 1);
+    }
+
+    LogRingStats stats = ring.getStats();
+    TEST_ASSERT_EQUAL(4, stats.pushed);
+    TEST_ASSERT_EQUAL(2, stats.droppedNewest);
+
+    char out[8];
+    TEST_ASSERT_EQUAL(4, ring.drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY("0123", out, 4);
+}
+
+void test_drop_oldest_keeps_latest(void) {
+    EARS_logRing ring;
+    TEST_ASSERT_TRUE(ring.begin(storage, 4 * SLOT_BYTES, SLOT_BYTES, LogOverflowPolicy::DROP_OLDEST));
+    for (int i = 0; i < 6; i++) {
+        char c = (char)('0' + i);
+        ring.push(&c, 1);
+    }
+
+    LogRingStats stats = ring.getStats();
+    TEST_ASSERT_EQUAL(6, stats.pushed);
+    TEST_ASSERT_EQUAL(2, stats.droppedOldest);
+
+    char out[8];
+    TEST_ASSERT_EQUAL(4, ring.drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY("2345", out, 4);
+}
+
+void test_block_times_out_then_succeeds(void) {
+    EARS_logRing ring;
+    TEST_ASSERT_TRUE(ring.begin(storage, 2 * SLOT_BYTES, SLOT_BYTES, LogOverflowPolicy::BLOCK));
+    ring.setBlockTimeout(10);
+    ring.push("a", 1);
+    ring.push("b", 1);
+
+    // Nobody drains: the push gives up after the timeout
+    TEST_ASSERT_FALSE(ring.push("c", 1));
+    TEST_ASSERT_EQUAL(1, ring.getStats().droppedNewest);
+
+    // A consumer frees space while the producer is waiting
+    ring.setBlockTimeout(1000);
+    std::thread consumer([&ring] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        char out[4];
+        ring.drain(out, 1);
+    });
+    TEST_ASSERT_TRUE(ring.push("d", 1));
+    consumer.join();
+    TEST_ASSERT_EQUAL(2, ring.getStats().blockedPushes);
+}
+
+void test_long_entries_are_truncated(void) {
+    EARS_logRing ring;
+    TEST_ASSERT_TRUE(ring.begin(storage, 4 * SLOT_BYTES, SLOT_BYTES, LogOverflowPolicy::DROP_NEWEST));
+    char big[400];
+    memset(big, 'x', sizeof(big));
+    ring.push(big, sizeof(big));
+
+    char out[400];
+    TEST_ASSERT_EQUAL(ring.slotPayloadBytes(), ring.drain(out, sizeof(out)));
+    TEST_ASSERT_EQUAL(1, ring.getStats().truncated);
+}
+
+void test_flusher_batches_everything(void) {
+    EARS_logRing ring;
+    TEST_ASSERT_TRUE(ring.begin(storage, sizeof(storage), SLOT_BYTES, LogOverflowPolicy::BLOCK));
+    static char batch[8192];
+    size_t received = 0;
+    EARS_logFlusher flusher;
+    TEST_ASSERT_TRUE(flusher.begin(&ring, batch, sizeof(batch), countingSink, &received, 5));
+
+    std::atomic<bool> stop(false);
+    std::thread worker([&flusher, &stop] { flusher.run(stop); });
+
+    const size_t lines = 20000;
+    for (size_t i = 0; i < lines; i++) {
+        ring.push(LINE, sizeof(LINE) - 1);
+    }
+    stop.store(true);
+    worker.join();
+
+    TEST_ASSERT_EQUAL(lines * (sizeof(LINE) - 1), received);
+    TEST_ASSERT_EQUAL(0, ring.getStats().droppedNewest);
+    TEST_ASSERT_LESS_THAN(lines / 10, flusher.getStats().batches);
+}
+
+/*
+  Runs lines pushes against a live flusher and reports latency/throughput
+*/
+static void runBenchmark(const char* name, LogOverflowPolicy policy) {
+    EARS_logRing ring;
+    TEST_ASSERT_TRUE(ring.begin(storage, sizeof(storage), SLOT_BYTES, policy));
+    static char batch[8192];
+    size_t received = 0;
+    EARS_logFlusher flusher;
+    TEST_ASSERT_TRUE(flusher.begin(&ring, batch, sizeof(batch), countingSink, &received, 5));
+
+    std::atomic<bool> stop(false);
+    std::thread worker([&flusher, &stop] { flusher.run(stop); });
+
+    const size_t lines = 200000;
+    std::vector<uint32_t> samples;
+    samples.reserve(lines);
+    uint64_t start = nowNs();
+    for (size_t i = 0; i < lines; i++) {
+        uint64_t t0 = nowNs();
+        ring.push(LINE, sizeof(LINE) - 1);
+        samples.push_back((uint32_t)(nowNs() - t0));
+    }
+    stop.store(true);
+    worker.join();
+    uint64_t elapsed = nowNs() - start;
+
+    std::sort(samples.begin(), samples.end());
+    LogRingStats stats = ring.getStats();
+    double mbps = (double)received / (1024.0 * 1024.0) / ((double)elapsed / 1e9);
+    printf("[bench] %s: push p50 %u ns, p99 %u ns, max %u ns\n",
+           name, samples[lines / 2], samples[lines * 99 / 100], samples[lines - 1]);
+    printf("[bench] %s: sustained %.1f MB/s, %u batches, %u dropped\n",
+           name, mbps, flusher.getStats().batches, stats.droppedNewest + stats.droppedOldest);
+
+    TEST_ASSERT_EQUAL(stats.drained * (sizeof(LINE) - 1), received);
+}
+
+void benchmark_producer_latency_drop_newest(void) {
+    runBenchmark("DROP_NEWEST", LogOverflowPolicy::DROP_NEWEST);
+}
+
+void benchmark_sustained_throughput_block(void) {
+    runBenchmark("BLOCK", LogOverflowPolicy::BLOCK);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_push_drain_preserves_order);
+    RUN_TEST(test_drain_never_splits_entries);
+    RUN_TEST(test_drop_newest_counts_rejections);
+    RUN_TEST(test_drop_oldest_keeps_latest);
+    RUN_TEST(test_block_times_out_then_succeeds);
+    RUN_TEST(test_long_entries_are_truncated);
+    RUN_TEST(test_flusher_batches_everything);
+    RUN_TEST(benchmark_producer_latency_drop_newest);
+    RUN_TEST(benchmark_sustained_throughput_block);
+    return UNITY_END();
+}
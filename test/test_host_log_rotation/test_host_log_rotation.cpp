@@ -0,0 +1,215 @@
+/**
+ * @file test_host_log_rotation.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for rename-based log rotation.
+ * @section tests Tests
+ * - Generations shift correctly and the oldest is dropped.
+ * - A power cut at every step never loses the active log.
+ * - Rotation time and peak heap against the old copy-based rotation.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <new>
+#include <string>
+#include "EARS_fsPortLib.h"
+#include "EARS_memFs.h"
+
+/*
+  Heap accounting: every allocation carries its size so peak usage can be
+  reported for each rotation strategy.
+*/
+static size_t heapCurrent = 0;
+static size_t heapPeak = 0;
+
+void* operator new(size_t size) {
+    size_t* block = static_cast<size_t*>(malloc(size + sizeof(size_t)));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *block = size;
+    heapCurrent += size;
+    if (heapCurrent > heapPeak) {
+        heapPeak = heapCurrent;
+    }
+    return block + 1;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    size_t* block = static_cast<size_t*>(ptr) - 1;
+    heapCurrent -= *block;
+    free(block);
+}
+
+static const char* BASE = "/logs/debug.log";
+static const uint8_t GENERATIONS = 3;
+static const size_t FILE_BYTES = 1048576;
+
+static void fillFile(EARS_memFs& fs, const char* path, char tag, size_t bytes) {
+    std::string content(bytes, tag);
+    fs.writeFile(path, content.data(), content.size());
+}
+
+static char tagOf(EARS_memFs& fs, const char* path) {
+    const std::string* content = fs.peek(path);
+    return (content && !content->empty()) ? (*content)[0] : 0;
+}
+
+/*
+  The rotation EARS_logger used before: every generation is read into
+  RAM, written to its new name and the old name removed.
+*/
+static bool copyRotate(EARS_memFs& fs, const char* basePath, uint8_t generations) {
+    char oldName[EARS_FS_PORT_MAX_PATH];
+    char newName[EARS_FS_PORT_MAX_PATH];
+    snprintf(oldName, sizeof(oldName), "%s.%u", basePath, generations);
+    if (fs.fileExists(oldName)) {
+        fs.removeFile(oldName);
+    }
+    for (int i = generations - 1; i >= 1; i--) {
+        snprintf(oldName, sizeof(oldName), "%s.%d", basePath, i);
+        snprintf(newName, sizeof(newName), "%s.%d", basePath, i + 1);
+        if (fs.fileExists(oldName)) {
+            std::string content;
+            fs.readFile(oldName, content);
+            fs.writeFile(newName, content.data(), content.size());
+            fs.removeFile(oldName);
+        }
+    }
+    snprintf(newName, sizeof(newName), "%s.1", basePath);
+    if (fs.fileExists(basePath)) {
+        std::string content;
+        fs.readFile(basePath, content);
+        fs.writeFile(newName, content.data(), content.size());
+        fs.removeFile(basePath);
+    }
+    return true;
+}
+
+static void populate(EARS_memFs& fs, size_t bytes) {
+    fillFile(fs, BASE, 'A', bytes);
+    fillFile(fs, "/logs/debug.log.1", '1', bytes);
+    fillFile(fs, "/logs/debug.log.2", '2', bytes);
+    fillFile(fs, "/logs/debug.log.3", '3', bytes);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_rotation_shifts_generations(void) {
+    EARS_memFs fs;
+    populate(fs, 16);
+
+    TEST_ASSERT_TRUE(EARS_rotateGenerations(fs, BASE, GENERATIONS));
+    TEST_ASSERT_FALSE(fs.fileExists(BASE));
+    TEST_ASSERT_EQUAL('A', tagOf(fs, "/logs/debug.log.1"));
+    TEST_ASSERT_EQUAL('1', tagOf(fs, "/logs/debug.log.2"));
+    TEST_ASSERT_EQUAL('2', tagOf(fs, "/logs/debug.log.3"));
+    TEST_ASSERT_EQUAL(3, fs.fileCount());
+}
+
+void test_rotation_with_missing_generations(void) {
+    EARS_memFs fs;
+    fillFile(fs, BASE, 'A', 16);
+    fillFile(fs, "/logs/debug.log.2", '2', 16);
+
+    TEST_ASSERT_TRUE(EARS_rotateGenerations(fs, BASE, GENERATIONS));
+    TEST_ASSERT_EQUAL('A', tagOf(fs, "/logs/debug.log.1"));
+    TEST_ASSERT_EQUAL('2', tagOf(fs, "/logs/debug.log.3"));
+    TEST_ASSERT_FALSE(fs.fileExists("/logs/debug.log.2"));
+}
+
+void test_rotation_moves_no_file_data(void) {
+    EARS_memFs fs;
+    populate(fs, 4096);
+    fs.resetStats();
+
+    TEST_ASSERT_TRUE(EARS_rotateGenerations(fs, BASE, GENERATIONS));
+    MemFsStats stats = fs.getStats();
+    TEST_ASSERT_EQUAL(0, stats.bytesRead);
+    TEST_ASSERT_EQUAL(0, stats.bytesWritten);
+}
+
+void test_power_cut_never_loses_active_log(void) {
+    // Try a cut before every possible operation of the rotation
+    for (int32_t budget = 0; budget < 16; budget++) {
+        EARS_memFs fs;
+        populate(fs, 16);
+        fs.setOperationBudget(budget);
+        EARS_rotateGenerations(fs, BASE, GENERATIONS);
+        fs.setOperationBudget(-1);
+
+        // Active log and generations 1, 2 each survive under exactly one name
+        int active = (tagOf(fs, BASE) == 'A') + (tagOf(fs, "/logs/debug.log.1") == 'A');
+        int gen1 = (tagOf(fs, "/logs/debug.log.1") == '1') + (tagOf(fs, "/logs/debug.log.2") == '1');
+        int gen2 = (tagOf(fs, "/logs/debug.log.2") == '2') + (tagOf(fs, "/logs/debug.log.3") == '2');
+        TEST_ASSERT_EQUAL(1, active);
+        TEST_ASSERT_EQUAL(1, gen1);
+        TEST_ASSERT_EQUAL(1, gen2);
+
+        // The next rotation after power-up completes normally
+        TEST_ASSERT_TRUE(EARS_rotateGenerations(fs, BASE, GENERATIONS));
+        TEST_ASSERT_FALSE(fs.fileExists(BASE));
+    }
+}
+
+void benchmark_rename_vs_copy_rotation(void) {
+    struct Result {
+        double ms;
+        size_t peakHeap;
+        MemFsStats stats;
+    } results[2];
+
+    for (int strategy = 0; strategy < 2; strategy++) {
+        EARS_memFs fs;
+        populate(fs, FILE_BYTES);
+        fs.resetStats();
+
+        size_t baseline = heapCurrent;
+        heapPeak = heapCurrent;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (strategy == 0) {
+            copyRotate(fs, BASE, GENERATIONS);
+        } else {
+            EARS_rotateGenerations(fs, BASE, GENERATIONS);
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        results[strategy].ms = elapsed.count();
+        results[strategy].peakHeap = heapPeak - baseline;
+        results[strategy].stats = fs.getStats();
+    }
+
+    const char* names[2] = { "copy  ", "rename" };
+    for (int i = 0; i < 2; i++) {
+        printf("[bench] %s: %.3f ms, peak heap %zu bytes, %llu bytes read, %llu bytes written, %u metadata ops\n",
+               names[i], results[i].ms, results[i].peakHeap,
+               (unsigned long long)results[i].stats.bytesRead,
+               (unsigned long long)results[i].stats.bytesWritten,
+               results[i].stats.metadataOps);
+    }
+
+    TEST_ASSERT_GREATER_OR_EQUAL(FILE_BYTES, results[0].peakHeap);
+    TEST_ASSERT_LESS_THAN(1024, results[1].peakHeap);
+    TEST_ASSERT_EQUAL(0, results[1].stats.bytesWritten);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_rotation_shifts_generations);
+    RUN_TEST(test_rotation_with_missing_generations);
+    RUN_TEST(test_rotation_moves_no_file_data);
+    RUN_TEST(test_power_cut_never_loses_active_log);
+    RUN_TEST(benchmark_rename_vs_copy_rotation);
+    return UNITY_END();
+}
@@ -0,0 +1,274 @@
+/**
+ * @file test_host_log_sinks.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for log sinks and the in-RAM ring sink.
+ * @section tests Tests
+ * - Sink level thresholds.
+ * - The ring keeps the last N lines, oldest first, without their newline.
+ * - Long lines are cut, iteration can stop early or resume after a sequence.
+ * - Visited text points into the caller's storage (no copies).
+ * - Concurrent writers lose nothing but the oldest lines.
+ * - Cost of a ring write and of visiting a full ring.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "EARS_logSinkLib.h"
+
+static const size_t SLOT_BYTES = 64;
+static const size_t SLOTS = 8;
+alignas(4) static uint8_t storage[SLOT_BYTES * SLOTS];
+
+struct Collected {
+    std::vector<std::string> lines;
+    std::vector<uint32_t> sequences;
+    std::vector<uint8_t> levels;
+    std::vector<const char*> pointers;
+    size_t stopAfter;
+};
+
+static bool collect(const LogMemoryEntry& entry, void* context) {
+    Collected* out = static_cast<Collected*>(context);
+    out->lines.push_back(std::string(entry.text, entry.length));
+    out->sequences.push_back(entry.sequence);
+    out->levels.push_back(entry.level);
+    out->pointers.push_back(entry.text);
+    return out->stopAfter == 0 || out->lines.size() < out->stopAfter;
+}
+
+static void writeLine(EARS_logMemorySink& sink, uint8_t level, const char* line) {
+    sink.write(level, line, strlen(line));
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_sink_level_threshold(void) {
+    EARS_logMemorySink sink;
+    TEST_ASSERT_TRUE(sink.accepts(EARS_LOG_LEVEL_DEBUG));
+    sink.setLevel(EARS_LOG_LEVEL_WARN);
+    TEST_ASSERT_TRUE(sink.accepts(EARS_LOG_LEVEL_ERROR));
+    TEST_ASSERT_TRUE(sink.accepts(EARS_LOG_LEVEL_WARN));
+    TEST_ASSERT_FALSE(sink.accepts(EARS_LOG_LEVEL_INFO));
+    TEST_ASSERT_FALSE(sink.accepts(EARS_LOG_LEVEL_NONE));
+    sink.setLevel(EARS_LOG_LEVEL_NONE);
+    TEST_ASSERT_FALSE(sink.accepts(EARS_LOG_LEVEL_ERROR));
+}
+
+void test_begin_rejects_bad_storage(void) {
+    EARS_logMemorySink sink;
+    TEST_ASSERT_FALSE(sink.begin(nullptr, sizeof(storage), SLOT_BYTES));
+    TEST_ASSERT_FALSE(sink.begin(storage, sizeof(storage), EARS_logMemorySink::SLOT_HEADER_BYTES));
+    TEST_ASSERT_FALSE(sink.begin(storage, SLOT_BYTES - 1, SLOT_BYTES));
+
+    // Without storage lines are dropped quietly
+    writeLine(sink, EARS_LOG_LEVEL_INFO, "dropped\n");
+    TEST_ASSERT_EQUAL(0, sink.count());
+
+    TEST_ASSERT_TRUE(sink.begin(storage, sizeof(storage), SLOT_BYTES));
+    TEST_ASSERT_EQUAL(SLOTS, sink.slotCount());
+    TEST_ASSERT_EQUAL(SLOT_BYTES - EARS_logMemorySink::SLOT_HEADER_BYTES, sink.textCapacity());
+}
+
+void test_keeps_last_lines_in_order(void) {
+    EARS_logMemorySink sink;
+    sink.begin(storage, sizeof(storage), SLOT_BYTES);
+    TEST_ASSERT_EQUAL(0, sink.lastSequence());
+
+    char line[32];
+    for (int i = 1; i <= 20; i++) {
+        snprintf(line, sizeof(line), "line %d\n", i);
+        writeLine(sink, (uint8_t)(i % 4 + 1), line);
+    }
+    TEST_ASSERT_EQUAL(SLOTS, sink.count());
+    TEST_ASSERT_EQUAL(20, sink.lastSequence());
+
+    Collected out;
+    out.stopAfter = 0;
+    TEST_ASSERT_EQUAL(SLOTS, sink.forEach(collect, &out));
+    for (size_t i = 0; i < SLOTS; i++) {
+        int number = (int)(20 - SLOTS + 1 + i);
+        snprintf(line, sizeof(line), "line %d", number);
+        TEST_ASSERT_EQUAL_STRING(line, out.lines[i].c_str());
+        TEST_ASSERT_EQUAL(number, out.sequences[i]);
+        TEST_ASSERT_EQUAL(number % 4 + 1, out.levels[i]);
+    }
+}
+
+void test_long_lines_are_cut(void) {
+    EARS_logMemorySink sink;
+    sink.begin(storage, sizeof(storage), SLOT_BYTES);
+    std::string longLine(200, 'x');
+    longLine += '\n';
+    sink.write(EARS_LOG_LEVEL_INFO, longLine.c_str(), longLine.size());
+
+    Collected out;
+    out.stopAfter = 0;
+    sink.forEach(collect, &out);
+    TEST_ASSERT_EQUAL(1, out.lines.size());
+    TEST_ASSERT_EQUAL(sink.textCapacity(), out.lines[0].size());
+    TEST_ASSERT_EQUAL_STRING(std::string(sink.textCapacity(), 'x').c_str(), out.lines[0].c_str());
+}
+
+void test_after_sequence_and_early_stop(void) {
+    EARS_logMemorySink sink;
+    sink.begin(storage, sizeof(storage), SLOT_BYTES);
+    char line[32];
+    for (int i = 1; i <= 12; i++) {
+        snprintf(line, sizeof(line), "line %d\n", i);
+        writeLine(sink, EARS_LOG_LEVEL_DEBUG, line);
+    }
+
+    // A screen remembers the last sequence it showed and asks for newer lines
+    Collected newer;
+    newer.stopAfter = 0;
+    TEST_ASSERT_EQUAL(2, sink.forEach(collect, &newer, 10));
+    TEST_ASSERT_EQUAL(11, newer.sequences[0]);
+    TEST_ASSERT_EQUAL(12, newer.sequences[1]);
+
+    // Asking for lines that were already overwritten starts at the oldest held
+    Collected overwritten;
+    overwritten.stopAfter = 0;
+    TEST_ASSERT_EQUAL(SLOTS, sink.forEach(collect, &overwritten, 2));
+    TEST_ASSERT_EQUAL(5, overwritten.sequences[0]);
+
+    TEST_ASSERT_EQUAL(0, sink.forEach(collect, &newer, 12));
+
+    Collected stopped;
+    stopped.stopAfter = 3;
+    TEST_ASSERT_EQUAL(3, sink.forEach(collect, &stopped));
+    TEST_ASSERT_EQUAL(3, stopped.lines.size());
+
+    sink.clear();
+    TEST_ASSERT_EQUAL(0, sink.count());
+    writeLine(sink, EARS_LOG_LEVEL_INFO, "after clear\n");
+    Collected cleared;
+    cleared.stopAfter = 0;
+    TEST_ASSERT_EQUAL(1, sink.forEach(collect, &cleared));
+    TEST_ASSERT_EQUAL(13, cleared.sequences[0]);
+}
+
+void test_iteration_is_zero_copy(void) {
+    EARS_logMemorySink sink;
+    sink.begin(storage, sizeof(storage), SLOT_BYTES);
+    for (int i = 0; i < 5; i++) {
+        writeLine(sink, EARS_LOG_LEVEL_INFO, "zero copy\n");
+    }
+
+    Collected out;
+    out.stopAfter = 0;
+    sink.forEach(collect, &out);
+    for (size_t i = 0; i < out.pointers.size(); i++) {
+        const uint8_t* text = reinterpret_cast<const uint8_t*>(out.pointers[i]);
+        TEST_ASSERT_TRUE(text >= storage && text < storage + sizeof(storage));
+        TEST_ASSERT_EQUAL(EARS_logMemorySink::SLOT_HEADER_BYTES, (size_t)(text - storage) % SLOT_BYTES);
+    }
+}
+
+void test_concurrent_writers(void) {
+    static uint8_t big[SLOT_BYTES * 1024];
+    EARS_logMemorySink sink;
+    sink.begin(big, sizeof(big), SLOT_BYTES);
+
+    const int threads = 4;
+    const int perThread = 5000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&sink, t]() {
+            char line[32];
+            for (int i = 0; i < perThread; i++) {
+                int length = snprintf(line, sizeof(line), "t%d %d\n", t, i);
+                sink.write(EARS_LOG_LEVEL_INFO, line, (size_t)length);
+            }
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+
+    TEST_ASSERT_EQUAL(threads * perThread, sink.lastSequence());
+    TEST_ASSERT_EQUAL(1024, sink.count());
+
+    // Each thread's surviving lines are intact and in its own order
+    Collected out;
+    out.stopAfter = 0;
+    sink.forEach(collect, &out);
+    int last[threads] = {-1, -1, -1, -1};
+    for (size_t i = 0; i < out.lines.size(); i++) {
+        int t, n;
+        TEST_ASSERT_EQUAL(2, sscanf(out.lines[i].c_str(), "t%d %d", &t, &n));
+        TEST_ASSERT_TRUE(n > last[t]);
+        last[t] = n;
+        if (i > 0) {
+            TEST_ASSERT_EQUAL(out.sequences[i - 1] + 1, out.sequences[i]);
+        }
+    }
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool countVisit(const LogMemoryEntry& entry, void* context) {
+    *static_cast<size_t*>(context) += entry.length;
+    return true;
+}
+
+/*
+  A typical 80 character line into a 64 entry ring like the logger's,
+  then one screen refresh visiting every held line
+*/
+void benchmark_memory_sink(void) {
+    static uint8_t ring[160 * 64];
+    EARS_logMemorySink sink;
+    sink.begin(ring, sizeof(ring), 160);
+
+    const char* line = "2026-10-16 12:34:56 [INFO ] Backlight level 80, screensaver in 30 s, core 1\n";
+    size_t length = strlen(line);
+    const int writes = 1000000;
+
+    uint64_t start = nowNs();
+    for (int i = 0; i < writes; i++) {
+        sink.write(EARS_LOG_LEVEL_INFO, line, length);
+    }
+    uint64_t writeNs = nowNs() - start;
+
+    const int visits = 10000;
+    size_t bytes = 0;
+    start = nowNs();
+    for (int i = 0; i < visits; i++) {
+        sink.forEach(countVisit, &bytes);
+    }
+    uint64_t visitNs = nowNs() - start;
+
+    printf("[bench] memory sink write: %.1f ns/line\n", (double)writeNs / writes);
+    printf("[bench] visit 64 lines:    %.1f ns/refresh\n", (double)visitNs / visits);
+    TEST_ASSERT_EQUAL((size_t)visits * 64 * (length - 1), bytes);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_sink_level_threshold);
+    RUN_TEST(test_begin_rejects_bad_storage);
+    RUN_TEST(test_keeps_last_lines_in_order);
+    RUN_TEST(test_long_lines_are_cut);
+    RUN_TEST(test_after_sequence_and_early_stop);
+    RUN_TEST(test_iteration_is_zero_copy);
+    RUN_TEST(test_concurrent_writers);
+    RUN_TEST(benchmark_memory_sink);
+    return UNITY_END();
+}
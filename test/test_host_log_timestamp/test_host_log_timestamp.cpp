@@ -0,0 +1,246 @@
+/**
+ * @file test_host_log_timestamp.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the cached timestamp formatter.
+ * @section tests Tests
+ * - Output matches localtime_r + strftime across hour, day, year and DST edges.
+ * - Millisecond and microsecond digits, buffer too small.
+ * - Concurrent formatting from several threads stays correct.
+ * - ns per timestamp against the logger's previous getTimestamp() path.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "EARS_logTimeLib.h"
+
+// UK rules as a POSIX TZ string, the form the device is configured with
+static const char* const TIME_ZONE = "GMT0BST,M3.5.0/1,M10.5.0";
+
+static const uint32_t NEW_YEAR_2026 = 1767225600;   // 2026-01-01 00:00:00 UTC
+static const uint32_t BST_START_2026 = 1774746000;  // 2026-03-29 01:00:00 UTC, clocks go forward
+static const uint32_t BST_END_2026 = 1792890000;    // 2026-10-25 01:00:00 UTC, clocks go back
+
+static std::string reference(uint64_t nowUs, LogTimePrecision precision) {
+    time_t seconds = (time_t)(nowUs / 1000000ULL);
+    struct tm parts;
+    localtime_r(&seconds, &parts);
+    char buffer[40];
+    size_t length = strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &parts);
+    unsigned micros = (unsigned)(nowUs % 1000000ULL);
+    if (precision == LogTimePrecision::MILLIS) {
+        snprintf(buffer + length, sizeof(buffer) - length, ".%03u", micros / 1000);
+    } else if (precision == LogTimePrecision::MICROS) {
+        snprintf(buffer + length, sizeof(buffer) - length, ".%06u", micros);
+    }
+    return buffer;
+}
+
+static void assertMatches(EARS_logTimestamp& stamp, uint64_t nowUs) {
+    char out[EARS_logTimestamp::MAX_LENGTH];
+    size_t length = stamp.format(nowUs, out, sizeof(out));
+    std::string expected = reference(nowUs, stamp.getPrecision());
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), out);
+    TEST_ASSERT_EQUAL(expected.size(), length);
+}
+
+/*
+  The logger's getTimestamp() before this formatter, with std::string
+  standing in for Arduino String (both allocate)
+*/
+__attribute__((noinline)) static std::string legacyTimestamp() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+
+    struct tm timeinfo;
+    localtime_r(&tv.tv_sec, &timeinfo);
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d",
+             timeinfo.tm_year + 1900,
+             timeinfo.tm_mon + 1,
+             timeinfo.tm_mday,
+             timeinfo.tm_hour,
+             timeinfo.tm_min,
+             timeinfo.tm_sec);
+
+    return std::string(buffer);
+}
+
+static uint64_t wallClockUs() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
+}
+
+void setUp(void) {
+    setenv("TZ", TIME_ZONE, 1);
+    tzset();
+}
+
+void tearDown(void) {
+}
+
+void test_matches_localtime_across_boundaries(void) {
+    EARS_logTimestamp stamp;
+    const uint32_t edges[] = { NEW_YEAR_2026, BST_START_2026, BST_END_2026, 1798761600 /* 2027-01-01 */, 0 };
+    for (size_t e = 0; e < sizeof(edges) / sizeof(edges[0]); e++) {
+        // Walk through the edge in uneven steps, going back in time as well
+        for (int64_t offset = -7300; offset <= 7300; offset += 37) {
+            int64_t seconds = (int64_t)edges[e] + offset;
+            if (seconds < 0) {
+                continue;
+            }
+            assertMatches(stamp, (uint64_t)seconds * 1000000ULL + 123456);
+        }
+    }
+}
+
+void test_matches_localtime_at_random_times(void) {
+    EARS_logTimestamp stamp;
+    uint32_t state = 12345;
+    for (int i = 0; i < 20000; i++) {
+        state = state * 1664525u + 1013904223u;
+        uint64_t seconds = NEW_YEAR_2026 + (state % (3u * 365u * 86400u));
+        assertMatches(stamp, seconds * 1000000ULL + (state % 1000000u));
+    }
+}
+
+void test_fraction_digits(void) {
+    EARS_logTimestamp stamp(LogTimePrecision::MILLIS);
+    char out[EARS_logTimestamp::MAX_LENGTH];
+    uint64_t nowUs = (uint64_t)BST_END_2026 * 1000000ULL + 7089;
+    TEST_ASSERT_EQUAL(23, stamp.format(nowUs, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("2026-10-25 01:00:00.007", out);
+
+    stamp.setPrecision(LogTimePrecision::MICROS);
+    TEST_ASSERT_EQUAL(26, stamp.format(nowUs, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("2026-10-25 01:00:00.007089", out);
+    TEST_ASSERT_EQUAL(26, stamp.format(nowUs + 999999 - 7089, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("2026-10-25 01:00:00.999999", out);
+
+    stamp.setPrecision(LogTimePrecision::SECONDS);
+    TEST_ASSERT_EQUAL(19, stamp.format(nowUs, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("2026-10-25 01:00:00", out);
+}
+
+void test_buffer_too_small(void) {
+    EARS_logTimestamp stamp(LogTimePrecision::MILLIS);
+    char out[23];
+    memset(out, 'x', sizeof(out));
+    TEST_ASSERT_EQUAL(0, stamp.format((uint64_t)NEW_YEAR_2026 * 1000000ULL, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("", out);
+    TEST_ASSERT_EQUAL(0, stamp.format((uint64_t)NEW_YEAR_2026 * 1000000ULL, out, 0));
+}
+
+void test_invalidate_after_time_zone_change(void) {
+    EARS_logTimestamp stamp;
+    uint64_t nowUs = (uint64_t)(BST_START_2026 + 86400) * 1000000ULL;
+    assertMatches(stamp, nowUs);
+
+    setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+    tzset();
+    stamp.invalidate();
+    assertMatches(stamp, nowUs + 1000000ULL);
+}
+
+void test_concurrent_formatting(void) {
+    EARS_logTimestamp stamp(LogTimePrecision::MICROS);
+    const int threads = 4;
+    std::vector<int> failures(threads, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&stamp, &failures, t]() {
+            // Each thread in its own hour, so the cache keeps changing hands
+            uint64_t base = (uint64_t)(NEW_YEAR_2026 + t * 3600 * 5) * 1000000ULL;
+            char out[EARS_logTimestamp::MAX_LENGTH];
+            for (int i = 0; i < 50000; i++) {
+                uint64_t nowUs = base + (uint64_t)i * 70001ULL;
+                stamp.format(nowUs, out, sizeof(out));
+                if (reference(nowUs, LogTimePrecision::MICROS) != out) {
+                    failures[t]++;
+                }
+            }
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+    for (int t = 0; t < threads; t++) {
+        TEST_ASSERT_EQUAL(0, failures[t]);
+    }
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  One timestamp per log line, as formatEntry() takes them
+*/
+void benchmark_timestamp_cost(void) {
+    const int calls = 1000000;
+    size_t sink = 0;
+
+    uint64_t start = nowNs();
+    for (int i = 0; i < calls; i++) {
+        sink += legacyTimestamp().size();
+    }
+    uint64_t legacyNs = nowNs() - start;
+
+    EARS_logTimestamp stamp;
+    char out[EARS_logTimestamp::MAX_LENGTH];
+    start = nowNs();
+    for (int i = 0; i < calls; i++) {
+        sink += stamp.format(wallClockUs(), out, sizeof(out));
+    }
+    uint64_t cachedNs = nowNs() - start;
+
+    stamp.setPrecision(LogTimePrecision::MICROS);
+    start = nowNs();
+    for (int i = 0; i < calls; i++) {
+        sink += stamp.format(wallClockUs(), out, sizeof(out));
+    }
+    uint64_t microsNs = nowNs() - start;
+
+    // Without the clock read: the formatting alone, a new second every call
+    uint64_t nowUs = (uint64_t)NEW_YEAR_2026 * 1000000ULL;
+    start = nowNs();
+    for (int i = 0; i < calls; i++) {
+        sink += stamp.format(nowUs + (uint64_t)i * 1000001ULL, out, sizeof(out));
+    }
+    uint64_t formatNs = nowNs() - start;
+
+    printf("[bench] previous getTimestamp():    %.1f ns/timestamp\n", (double)legacyNs / calls);
+    printf("[bench] cached, seconds:            %.1f ns/timestamp\n", (double)cachedNs / calls);
+    printf("[bench] cached, microseconds:       %.1f ns/timestamp\n", (double)microsNs / calls);
+    printf("[bench] format only, every second:  %.1f ns/timestamp\n", (double)formatNs / calls);
+    printf("[bench] %.1fx faster (%u)\n", (double)legacyNs / (double)cachedNs, (unsigned)(sink & 1));
+
+    TEST_ASSERT_LESS_THAN(legacyNs, cachedNs);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_localtime_across_boundaries);
+    RUN_TEST(test_matches_localtime_at_random_times);
+    RUN_TEST(test_fraction_digits);
+    RUN_TEST(test_buffer_too_small);
+    RUN_TEST(test_invalidate_after_time_zone_change);
+    RUN_TEST(test_concurrent_formatting);
+    RUN_TEST(benchmark_timestamp_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,450 @@
+/**
+ * @file test_host_nvs_shadow.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the NVS RAM shadow.
+ * @section tests Tests
+ * - Reads are served from RAM after one load.
+ * - Changes wait for the debounce, or MAX_DELAY_MS under a steady stream.
+ * - Unchanged values and an unchanged CRC are not written.
+ * - Per-key write counters, untracked keys, limits and failed commits.
+ * - A busy port leaves the shadow unloaded and the record CRC intact.
+ * - Key writes and commits per change set: per-call setters vs shadow.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "EARS_nvsShadow.h"
+#include "EARS_nvsTransaction.h"
+#include "EARS_memNvs.h"
+
+/*
+  Emulator whose commits can be made to fail
+*/
+class FailingNvs : public EARS_memNvs {
+public:
+    bool failCommits;
+
+    FailingNvs() : failCommits(false) {}
+
+    bool commitNamespace() override {
+        return !failCommits && EARS_memNvs::commitNamespace();
+    }
+};
+
+static FailingNvs* nvs = nullptr;
+
+static void provision(EARS_nvsPort& port) {
+    EARS_nvsTransaction transaction(port, false);
+    transaction.putU16(EARS_NVS_KEY_VERSION, 1);
+    transaction.putString(EARS_NVS_KEY_ZAPNUMBER, "AB1234");
+    transaction.putString(EARS_NVS_KEY_PASSWORD_HASH, "DEADBEEF");
+}
+
+static NVSStatus validate(EARS_nvsPort& port) {
+    EARS_nvsTransaction transaction(port, true);
+    return transaction.validate(1).status;
+}
+
+/*
+  What the EARS_nvsEeprom setters did before the shadow: each put opened
+  the namespace and Preferences committed it, then the CRC was re-read
+  and written with another commit.
+*/
+static void legacyPut(EARS_nvsPort& port, const char* key, const char* value) {
+    port.openNamespace(EARS_NVS_NAMESPACE, false);
+    port.writeString(key, value);
+    port.commitNamespace();
+    port.closeNamespace();
+}
+
+static void legacyPutVersion(EARS_nvsPort& port, uint16_t version) {
+    port.openNamespace(EARS_NVS_NAMESPACE, false);
+    port.writeU16(EARS_NVS_KEY_VERSION, version);
+    port.commitNamespace();
+    port.closeNamespace();
+}
+
+static void legacyUpdateCRC(EARS_nvsPort& port) {
+    uint32_t crc;
+    {
+        EARS_nvsTransaction transaction(port, true);
+        crc = transaction.calculateCRC();
+    }
+    port.openNamespace(EARS_NVS_NAMESPACE, false);
+    port.writeU32(EARS_NVS_KEY_CRC, crc);
+    port.commitNamespace();
+    port.closeNamespace();
+}
+
+static void legacySetZapNumber(EARS_nvsPort& port, const char* zapNumber) {
+    legacyPut(port, EARS_NVS_KEY_ZAPNUMBER, zapNumber);
+    legacyUpdateCRC(port);
+}
+
+static uint32_t keyWrites(EARS_nvsShadow& shadow, const char* key) {
+    NvsKeyStats stats[EARS_nvsShadow::MAX_KEYS];
+    size_t count = shadow.keyStats(stats, EARS_nvsShadow::MAX_KEYS);
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(stats[i].key, key) == 0) {
+            return stats[i].writes;
+        }
+    }
+    return 0;
+}
+
+void setUp(void) {
+    nvs = new FailingNvs();
+}
+
+void tearDown(void) {
+    delete nvs;
+    nvs = nullptr;
+}
+
+void test_reads_are_memory_lookups(void) {
+    provision(*nvs);
+    nvs->resetStats();
+    EARS_nvsShadow shadow(*nvs);
+
+    char zapNumber[16];
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL(6, shadow.getString(EARS_NVS_KEY_ZAPNUMBER, zapNumber, sizeof(zapNumber)));
+        TEST_ASSERT_EQUAL(1, shadow.getU16(EARS_NVS_KEY_VERSION));
+    }
+    TEST_ASSERT_EQUAL_STRING("AB1234", zapNumber);
+    TEST_ASSERT_EQUAL(1, nvs->getStats().opens);
+    TEST_ASSERT_EQUAL(4, nvs->getStats().reads);
+    TEST_ASSERT_EQUAL(200, shadow.getStats().lookups);
+    TEST_ASSERT_EQUAL(1, shadow.getStats().loads);
+
+    // Cut to fit
+    char small[4];
+    TEST_ASSERT_EQUAL(3, shadow.getString(EARS_NVS_KEY_ZAPNUMBER, small, sizeof(small)));
+    TEST_ASSERT_EQUAL_STRING("AB1", small);
+}
+
+void test_changes_wait_for_poll(void) {
+    provision(*nvs);
+    EARS_nvsShadow shadow(*nvs);
+    nvs->resetStats();
+
+    TEST_ASSERT_TRUE(shadow.putString(EARS_NVS_KEY_ZAPNUMBER, "CD5678", 0));
+    TEST_ASSERT_TRUE(shadow.putString(EARS_NVS_KEY_PASSWORD_HASH, "CAFEF00D", 400));
+    TEST_ASSERT_TRUE(shadow.isDirty());
+    TEST_ASSERT_FALSE(shadow.poll(1000));
+    TEST_ASSERT_EQUAL(0, nvs->getStats().commits);
+
+    TEST_ASSERT_TRUE(shadow.poll(1400));
+    TEST_ASSERT_FALSE(shadow.isDirty());
+    TEST_ASSERT_EQUAL(1, nvs->getStats().commits);
+    TEST_ASSERT_EQUAL(3, nvs->getStats().writes);    // Two keys and the CRC
+    TEST_ASSERT_EQUAL((int)NVSStatus::VALID, (int)validate(*nvs));
+    TEST_ASSERT_EQUAL_HEX32(shadow.calculateCRC(), shadow.getU32(EARS_NVS_KEY_CRC));
+
+    // Nothing left to do
+    TEST_ASSERT_TRUE(shadow.poll(5000));
+    TEST_ASSERT_EQUAL(1, nvs->getStats().commits);
+}
+
+void test_max_delay_bounds_a_stream_of_changes(void) {
+    provision(*nvs);
+    EARS_nvsShadow shadow(*nvs);
+    nvs->resetStats();
+
+    char zapNumber[8];
+    uint32_t now = 0;
+    for (int i = 0; now < EARS_nvsShadow::MAX_DELAY_MS; i++, now += 500) {
+        snprintf(zapNumber, sizeof(zapNumber), "AB%04d", i);
+        shadow.putString(EARS_NVS_KEY_ZAPNUMBER, zapNumber, now);
+        TEST_ASSERT_FALSE(shadow.poll(now));
+    }
+    TEST_ASSERT_TRUE(shadow.poll(now));
+    TEST_ASSERT_EQUAL(1, nvs->getStats().commits);
+    TEST_ASSERT_EQUAL(10, shadow.getStats().changes);
+    TEST_ASSERT_EQUAL(1, shadow.writeCount(EARS_NVS_KEY_ZAPNUMBER));
+}
+
+void test_unchanged_values_write_nothing(void) {
+    provision(*nvs);
+    EARS_nvsShadow shadow(*nvs);
+    nvs->resetStats();
+
+    TEST_ASSERT_TRUE(shadow.putString(EARS_NVS_KEY_ZAPNUMBER, "AB1234", 0));
+    TEST_ASSERT_TRUE(shadow.putU16(EARS_NVS_KEY_VERSION, 1, 0));
+    TEST_ASSERT_FALSE(shadow.isDirty());
+    TEST_ASSERT_TRUE(shadow.flush());
+    TEST_ASSERT_EQUAL(2, shadow.getStats().skipped);
+    TEST_ASSERT_EQUAL(0, nvs->getStats().commits);
+
+    // A key outside the record leaves the CRC alone
+    TEST_ASSERT_TRUE(shadow.putU16("brightness", 80, 0));
+    TEST_ASSERT_TRUE(shadow.flush());
+    TEST_ASSERT_EQUAL(1, nvs->getStats().writes);
+    TEST_ASSERT_EQUAL(0, shadow.writeCount(EARS_NVS_KEY_CRC));
+
+    // So does updateCRC() when the CRC already matches
+    TEST_ASSERT_TRUE(shadow.updateCRC());
+    TEST_ASSERT_EQUAL(1, nvs->getStats().writes);
+}
+
+void test_per_key_write_counters(void) {
+    provision(*nvs);
+    EARS_nvsShadow shadow(*nvs);
+
+    for (int i = 0; i < 3; i++) {
+        shadow.putString(EARS_NVS_KEY_PASSWORD_HASH, i % 2 ? "DEADBEEF" : "CAFEF00D", 0);
+        shadow.flush();
+    }
+    shadow.putU16(EARS_NVS_KEY_VERSION, 2, 0);
+    shadow.flush();
+
+    TEST_ASSERT_EQUAL(3, keyWrites(shadow, EARS_NVS_KEY_PASSWORD_HASH));
+    TEST_ASSERT_EQUAL(1, keyWrites(shadow, EARS_NVS_KEY_VERSION));
+    TEST_ASSERT_EQUAL(0, keyWrites(shadow, EARS_NVS_KEY_ZAPNUMBER));
+    TEST_ASSERT_EQUAL(4, keyWrites(shadow, EARS_NVS_KEY_CRC));
+    TEST_ASSERT_EQUAL(8, shadow.getStats().flashWrites);
+    TEST_ASSERT_EQUAL(4, shadow.getStats().commits);
+    TEST_ASSERT_EQUAL(0, shadow.writeCount("unknown"));
+}
+
+void test_untracked_keys_and_limits(void) {
+    provision(*nvs);
+    nvs->openNamespace(EARS_NVS_NAMESPACE, false);
+    nvs->writeU32("bootCount", 41);
+    nvs->commitNamespace();
+    nvs->closeNamespace();
+    nvs->resetStats();
+
+    EARS_nvsShadow shadow(*nvs);
+    TEST_ASSERT_EQUAL(1, shadow.getU16(EARS_NVS_KEY_VERSION));
+    TEST_ASSERT_EQUAL(41, shadow.getU32("bootCount"));
+    TEST_ASSERT_EQUAL(41, shadow.getU32("bootCount"));
+    TEST_ASSERT_EQUAL(2, nvs->getStats().opens);   // Record load, then the new key once
+
+    // Wrong type, too long, table full
+    TEST_ASSERT_EQUAL(7, shadow.getU16("bootCount", 7));
+    TEST_ASSERT_FALSE(shadow.putU16("bootCount", 1, 0));
+    char longValue[EARS_nvsTransaction::MAX_STRING + 1];
+    memset(longValue, 'x', sizeof(longValue) - 1);
+    longValue[sizeof(longValue) - 1] = '\0';
+    TEST_ASSERT_FALSE(shadow.putString(EARS_NVS_KEY_ZAPNUMBER, longValue, 0));
+    TEST_ASSERT_FALSE(shadow.putU16("a_key_far_too_long", 1, 0));
+    char key[16];
+    for (int i = 0; i < 3; i++) {
+        snprintf(key, sizeof(key), "extra%d", i);
+        TEST_ASSERT_TRUE(shadow.putU16(key, (uint16_t)i, 0));
+    }
+    TEST_ASSERT_FALSE(shadow.putU16("oneTooMany", 1, 0));
+
+    // What EARS_nvsEeprom checks before falling back to direct NVS access
+    TEST_ASSERT_TRUE(shadow.accepts("extra0", NvsValueType::U16));
+    TEST_ASSERT_TRUE(shadow.accepts(EARS_NVS_KEY_ZAPNUMBER, NvsValueType::STRING));
+    TEST_ASSERT_FALSE(shadow.accepts("bootCount", NvsValueType::U16));
+    TEST_ASSERT_FALSE(shadow.accepts("oneTooMany", NvsValueType::U16));
+    NvsKeyStats stats[EARS_nvsShadow::MAX_KEYS];
+    TEST_ASSERT_EQUAL(EARS_nvsShadow::MAX_KEYS, shadow.keyStats(stats, EARS_nvsShadow::MAX_KEYS));
+}
+
+void test_failed_commit_is_retried(void) {
+    provision(*nvs);
+    EARS_nvsShadow shadow(*nvs);
+
+    nvs->failCommits = true;
+    shadow.putString(EARS_NVS_KEY_ZAPNUMBER, "CD5678", 0);
+    TEST_ASSERT_FALSE(shadow.poll(2000));
+    TEST_ASSERT_TRUE(shadow.isDirty());
+    TEST_ASSERT_EQUAL(1, shadow.getStats().commitFailures);
+    TEST_ASSERT_EQUAL(0, shadow.writeCount(EARS_NVS_KEY_ZAPNUMBER));
+
+    // Waits DEBOUNCE_MS from the failure before trying again
+    nvs->failCommits = false;
+    TEST_ASSERT_FALSE(shadow.poll(2500));
+    TEST_ASSERT_EQUAL(1, shadow.getStats().commitFailures);
+    TEST_ASSERT_TRUE(shadow.poll(3000));
+    TEST_ASSERT_EQUAL(1, shadow.writeCount(EARS_NVS_KEY_ZAPNUMBER));
+    TEST_ASSERT_EQUAL(1, shadow.writeCount(EARS_NVS_KEY_CRC));
+    TEST_ASSERT_EQUAL((int)NVSStatus::VALID, (int)validate(*nvs));
+}
+
+void test_empty_namespace_and_invalidate(void) {
+    EARS_nvsShadow shadow(*nvs);
+    char text[16];
+    TEST_ASSERT_EQUAL(0, shadow.getString(EARS_NVS_KEY_ZAPNUMBER, text, sizeof(text)));
+    TEST_ASSERT_EQUAL(9, shadow.getU16(EARS_NVS_KEY_VERSION, 9));
+
+    shadow.putU16(EARS_NVS_KEY_VERSION, 1, 0);
+    shadow.putString(EARS_NVS_KEY_ZAPNUMBER, "AB1234", 0);
+    shadow.putString(EARS_NVS_KEY_PASSWORD_HASH, "DEADBEEF", 0);
+    TEST_ASSERT_TRUE(shadow.flush());
+    TEST_ASSERT_EQUAL((int)NVSStatus::VALID, (int)validate(*nvs));
+
+    // A write around the shadow shows after invalidate(), pending changes survive
+    {
+        EARS_nvsTransaction transaction(*nvs, false);
+        transaction.putString(EARS_NVS_KEY_ZAPNUMBER, "XY9876");
+    }
+    shadow.putString(EARS_NVS_KEY_PASSWORD_HASH, "CAFEF00D", 0);
+    shadow.getString(EARS_NVS_KEY_ZAPNUMBER, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("AB1234", text);
+    shadow.invalidate();
+    shadow.getString(EARS_NVS_KEY_ZAPNUMBER, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("XY9876", text);
+    shadow.getString(EARS_NVS_KEY_PASSWORD_HASH, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("CAFEF00D", text);
+    TEST_ASSERT_TRUE(shadow.flush());
+    TEST_ASSERT_EQUAL((int)NVSStatus::VALID, (int)validate(*nvs));
+}
+
+void test_busy_port_keeps_record_intact(void) {
+    provision(*nvs);
+    EARS_nvsShadow shadow(*nvs);
+    char text[16];
+
+    {
+        // validateNVS() on another task holds the port's one session
+        EARS_nvsTransaction transaction(*nvs, true);
+        TEST_ASSERT_TRUE(transaction.isOpen());
+        TEST_ASSERT_EQUAL(0, shadow.getString(EARS_NVS_KEY_ZAPNUMBER, text, sizeof(text)));
+        TEST_ASSERT_EQUAL(7, shadow.getU16(EARS_NVS_KEY_VERSION, 7));
+        TEST_ASSERT_EQUAL(0, shadow.getStats().loads);
+
+        // A change made meanwhile cannot be committed, and no CRC is guessed
+        TEST_ASSERT_TRUE(shadow.putString(EARS_NVS_KEY_ZAPNUMBER, "CD5678", 0));
+        TEST_ASSERT_FALSE(shadow.flush());
+        TEST_ASSERT_EQUAL(0, shadow.writeCount(EARS_NVS_KEY_CRC));
+    }
+
+    // Free again: the other keys are read before the CRC is built
+    TEST_ASSERT_EQUAL(1, shadow.getU16(EARS_NVS_KEY_VERSION, 7));
+    shadow.getString(EARS_NVS_KEY_PASSWORD_HASH, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("DEADBEEF", text);
+    TEST_ASSERT_TRUE(shadow.flush());
+    TEST_ASSERT_EQUAL((int)NVSStatus::VALID, (int)validate(*nvs));
+
+    // Same when the first access after the busy spell is the commit itself
+    EARS_nvsShadow late(*nvs);
+    {
+        EARS_nvsTransaction transaction(*nvs, true);
+        TEST_ASSERT_TRUE(late.putString(EARS_NVS_KEY_ZAPNUMBER, "EF9012", 0));
+        TEST_ASSERT_FALSE(late.updateCRC());
+    }
+    TEST_ASSERT_TRUE(late.flush());
+    TEST_ASSERT_EQUAL((int)NVSStatus::VALID, (int)validate(*nvs));
+    late.getString(EARS_NVS_KEY_PASSWORD_HASH, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("DEADBEEF", text);
+
+    // A namespace that does not exist is empty, not busy
+    EARS_memNvs blank;
+    EARS_nvsShadow fresh(blank);
+    TEST_ASSERT_TRUE(fresh.load());
+    TEST_ASSERT_EQUAL(9, fresh.getU16(EARS_NVS_KEY_VERSION, 9));
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void report(const char* what, const MemNvsStats& perCall, const MemNvsStats& shadow) {
+    printf("[bench] %-18s per-call: %u key writes, %u commits | shadow: %u key writes, %u commits\n",
+           what, perCall.writes, perCall.commits, shadow.writes, shadow.commits);
+}
+
+/*
+  Flash key writes and commits per change set, then the cost of a read.
+  On the device each key write and commit is a flash access.
+*/
+void benchmark_writes_per_change_set(void) {
+    EARS_memNvs before;
+    EARS_memNvs after;
+    provision(before);
+    provision(after);
+    EARS_nvsShadow shadow(after);
+    shadow.load();
+
+    // ZapNumber change
+    before.resetStats();
+    after.resetStats();
+    legacySetZapNumber(before, "CD5678");
+    shadow.putString(EARS_NVS_KEY_ZAPNUMBER, "CD5678", 0);
+    shadow.flush();
+    report("setZapNumber", before.getStats(), after.getStats());
+    TEST_ASSERT_EQUAL(2, before.getStats().commits);
+    TEST_ASSERT_EQUAL(2, after.getStats().writes);
+    TEST_ASSERT_EQUAL(1, after.getStats().commits);
+
+    // The same value again
+    before.resetStats();
+    after.resetStats();
+    legacySetZapNumber(before, "CD5678");
+    shadow.putString(EARS_NVS_KEY_ZAPNUMBER, "CD5678", 0);
+    shadow.flush();
+    report("unchanged value", before.getStats(), after.getStats());
+    TEST_ASSERT_EQUAL(0, after.getStats().writes);
+    TEST_ASSERT_EQUAL(0, after.getStats().commits);
+
+    // First-time setup: version, ZapNumber, password hash, CRC
+    EARS_memNvs blankBefore;
+    EARS_memNvs blankAfter;
+    legacyPutVersion(blankBefore, 1);
+    legacySetZapNumber(blankBefore, "AB1234");
+    legacyPut(blankBefore, EARS_NVS_KEY_PASSWORD_HASH, "DEADBEEF");
+    legacyUpdateCRC(blankBefore);
+    {
+        EARS_nvsShadow blankShadow(blankAfter);
+        blankShadow.putU16(EARS_NVS_KEY_VERSION, 1, 0);
+        blankShadow.putString(EARS_NVS_KEY_ZAPNUMBER, "AB1234", 0);
+        blankShadow.putString(EARS_NVS_KEY_PASSWORD_HASH, "DEADBEEF", 0);
+        blankShadow.flush();
+    }
+    report("first-time setup", blankBefore.getStats(), blankAfter.getStats());
+    TEST_ASSERT_EQUAL(5, blankBefore.getStats().commits);
+    TEST_ASSERT_EQUAL(4, blankAfter.getStats().writes);
+    TEST_ASSERT_EQUAL(1, blankAfter.getStats().commits);
+    TEST_ASSERT_EQUAL((int)NVSStatus::VALID, (int)validate(blankAfter));
+
+    // Reading the ZapNumber: a session per call vs a RAM lookup
+    const int rounds = 200000;
+    char zapNumber[EARS_nvsTransaction::MAX_STRING];
+    size_t total = 0;
+    before.resetStats();
+    after.resetStats();
+    uint64_t start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        EARS_nvsTransaction transaction(before, true);
+        total += transaction.getString(EARS_NVS_KEY_ZAPNUMBER, zapNumber, sizeof(zapNumber));
+    }
+    uint64_t perCallNs = nowNs() - start;
+    start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        total += shadow.getString(EARS_NVS_KEY_ZAPNUMBER, zapNumber, sizeof(zapNumber));
+    }
+    uint64_t shadowNs = nowNs() - start;
+    printf("[bench] getZapNumber: per-call %.1f ns and %u opens, shadow %.1f ns and %u opens (%d reads)\n",
+           (double)perCallNs / rounds, before.getStats().opens,
+           (double)shadowNs / rounds, after.getStats().opens, rounds);
+    TEST_ASSERT_EQUAL(12 * rounds, total);
+    TEST_ASSERT_EQUAL(0, after.getStats().opens);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reads_are_memory_lookups);
+    RUN_TEST(test_changes_wait_for_poll);
+    RUN_TEST(test_max_delay_bounds_a_stream_of_changes);
+    RUN_TEST(test_unchanged_values_write_nothing);
+    RUN_TEST(test_per_key_write_counters);
+    RUN_TEST(test_untracked_keys_and_limits);
+    RUN_TEST(test_failed_commit_is_retried);
+    RUN_TEST(test_empty_namespace_and_invalidate);
+    RUN_TEST(test_busy_port_keeps_record_intact);
+    RUN_TEST(benchmark_writes_per_change_set);
+    return UNITY_END();
+}
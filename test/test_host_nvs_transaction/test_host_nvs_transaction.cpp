@@ -0,0 +1,446 @@
+/**
+ * @file test_host_nvs_transaction.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for scoped NVS transactions.
+ * @section tests Tests
+ * - The record CRC keeps the layout earlier releases stored.
+ * - Validation of valid, upgraded, missing and tampered records.
+ * - Pending writes commit once, also on scope exit.
+ * - Same results as the per-call code it replaces.
+ * - Opens and commits per validation, ZapNumber change and provisioning:
+ *   per-call sessions vs one transaction.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "EARS_nvsTransaction.h"
+#include "EARS_memNvs.h"
+
+static const uint16_t CURRENT_VERSION = 1;
+
+static EARS_memNvs* nvs = nullptr;
+static int upgradeCalls = 0;
+static bool upgradeResult = true;
+
+static bool countingUpgrade(EARS_nvsTransaction& transaction, uint16_t fromVersion,
+                            uint16_t toVersion, void* context) {
+    (void)transaction;
+    (void)fromVersion;
+    (void)toVersion;
+    (void)context;
+    upgradeCalls++;
+    return upgradeResult;
+}
+
+static void provision(EARS_nvsPort& port, uint16_t version, const char* zapNumber, const char* passwordHash) {
+    EARS_nvsTransaction transaction(port, false);
+    transaction.putU16(EARS_NVS_KEY_VERSION, version);
+    transaction.putString(EARS_NVS_KEY_ZAPNUMBER, zapNumber);
+    transaction.putString(EARS_NVS_KEY_PASSWORD_HASH, passwordHash);
+    transaction.commit();
+}
+
+// Raw write that leaves the CRC alone, as tampering would
+static void poke(EARS_nvsPort& port, const char* key, const char* value) {
+    port.openNamespace(EARS_NVS_NAMESPACE, false);
+    port.writeString(key, value);
+    port.commitNamespace();
+    port.closeNamespace();
+}
+
+/*
+  What EARS_nvsEeprom did before transactions, call for call: every getter
+  and setter opened the namespace itself and Preferences committed each put.
+*/
+static uint32_t legacyCalculateCRC(EARS_nvsPort& port) {
+    if (!port.openNamespace(EARS_NVS_NAMESPACE, true)) {
+        return 0;
+    }
+    uint16_t version = 0;
+    char zapNumber[64] = "";
+    char passwordHash[64] = "";
+    port.readU16(EARS_NVS_KEY_VERSION, version);
+    port.readString(EARS_NVS_KEY_ZAPNUMBER, zapNumber, sizeof(zapNumber));
+    port.readString(EARS_NVS_KEY_PASSWORD_HASH, passwordHash, sizeof(passwordHash));
+    port.closeNamespace();
+
+    char data[160];
+    int length = snprintf(data, sizeof(data), "%u|%s|%s", (unsigned)version, zapNumber, passwordHash);
+    return EARS_nvsCRC32((const uint8_t*)data, (size_t)length);
+}
+
+static bool legacyPut(EARS_nvsPort& port, const char* key, const char* value) {
+    if (!port.openNamespace(EARS_NVS_NAMESPACE, false)) {
+        return false;
+    }
+    bool ok = port.writeString(key, value) && port.commitNamespace();
+    port.closeNamespace();
+    return ok;
+}
+
+static bool legacyPutVersion(EARS_nvsPort& port, uint16_t version) {
+    if (!port.openNamespace(EARS_NVS_NAMESPACE, false)) {
+        return false;
+    }
+    bool ok = port.writeU16(EARS_NVS_KEY_VERSION, version) && port.commitNamespace();
+    port.closeNamespace();
+    return ok;
+}
+
+static bool legacyUpdateCRC(EARS_nvsPort& port) {
+    uint32_t crc = legacyCalculateCRC(port);
+    if (!port.openNamespace(EARS_NVS_NAMESPACE, false)) {
+        return false;
+    }
+    bool ok = port.writeU32(EARS_NVS_KEY_CRC, crc) && port.commitNamespace();
+    port.closeNamespace();
+    return ok;
+}
+
+static bool legacySetZapNumber(EARS_nvsPort& port, const char* zapNumber) {
+    return EARS_nvsValidZapNumber(zapNumber) &&
+           legacyPut(port, EARS_NVS_KEY_ZAPNUMBER, zapNumber) &&
+           legacyUpdateCRC(port);
+}
+
+static NVSValidationResult legacyValidate(EARS_nvsPort& port) {
+    NVSValidationResult result;
+    result.expectedVersion = CURRENT_VERSION;
+
+    if (!port.openNamespace(EARS_NVS_NAMESPACE, true)) {
+        result.status = NVSStatus::INITIALIZATION_FAILED;
+        return result;
+    }
+    port.readU16(EARS_NVS_KEY_VERSION, result.currentVersion);
+
+    if (result.currentVersion < CURRENT_VERSION) {
+        port.closeNamespace();
+        if (!legacyPutVersion(port, CURRENT_VERSION) || !legacyUpdateCRC(port)) {
+            result.status = NVSStatus::INVALID_VERSION;
+            return result;
+        }
+        result.wasUpgraded = true;
+        result.currentVersion = CURRENT_VERSION;
+        if (!port.openNamespace(EARS_NVS_NAMESPACE, true)) {
+            result.status = NVSStatus::INITIALIZATION_FAILED;
+            return result;
+        }
+    } else if (result.currentVersion > CURRENT_VERSION) {
+        result.status = NVSStatus::INVALID_VERSION;
+        port.closeNamespace();
+        return result;
+    }
+
+    char zapNumber[64] = "";
+    port.readString(EARS_NVS_KEY_ZAPNUMBER, zapNumber, sizeof(zapNumber));
+    if (!EARS_nvsValidZapNumber(zapNumber)) {
+        result.status = NVSStatus::MISSING_ZAPNUMBER;
+        port.closeNamespace();
+        return result;
+    }
+    result.zapNumberValid = true;
+    memcpy(result.zapNumber, zapNumber, sizeof(result.zapNumber));
+
+    char passwordHash[64] = "";
+    if (!port.readString(EARS_NVS_KEY_PASSWORD_HASH, passwordHash, sizeof(passwordHash)) ||
+        passwordHash[0] == '\0') {
+        result.status = NVSStatus::MISSING_PASSWORD;
+        port.closeNamespace();
+        return result;
+    }
+    result.passwordHashValid = true;
+
+    uint32_t storedCRC = 0;
+    port.readU32(EARS_NVS_KEY_CRC, storedCRC);
+    port.closeNamespace();
+
+    result.calculatedCRC = legacyCalculateCRC(port);
+    if (storedCRC != result.calculatedCRC) {
+        result.status = NVSStatus::CRC_FAILED;
+        return result;
+    }
+    result.crcValid = true;
+    result.status = result.wasUpgraded ? NVSStatus::UPGRADED : NVSStatus::VALID;
+    return result;
+}
+
+static NVSValidationResult validate(EARS_nvsPort& port) {
+    EARS_nvsTransaction transaction(port, true);
+    return transaction.validate(CURRENT_VERSION, countingUpgrade, nullptr);
+}
+
+void setUp(void) {
+    nvs = new EARS_memNvs();
+    upgradeCalls = 0;
+    upgradeResult = true;
+}
+
+void tearDown(void) {
+    delete nvs;
+    nvs = nullptr;
+}
+
+void test_crc_keeps_previous_layout(void) {
+    const char* check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, EARS_nvsCRC32((const uint8_t*)check, strlen(check)));
+
+    provision(*nvs, 1, "AB1234", "DEADBEEF");
+    const char* record = "1|AB1234|DEADBEEF";
+    uint32_t expected = EARS_nvsCRC32((const uint8_t*)record, strlen(record));
+
+    EARS_nvsTransaction transaction(*nvs, true);
+    TEST_ASSERT_EQUAL_HEX32(expected, transaction.getU32(EARS_NVS_KEY_CRC));
+    TEST_ASSERT_EQUAL_HEX32(expected, transaction.calculateCRC());
+}
+
+void test_valid_record_opens_once(void) {
+    provision(*nvs, 1, "AB1234", "DEADBEEF");
+    nvs->resetStats();
+
+    NVSValidationResult result = validate(*nvs);
+    TEST_ASSERT_EQUAL((int)NVSStatus::VALID, (int)result.status);
+    TEST_ASSERT_TRUE(result.zapNumberValid && result.passwordHashValid && result.crcValid);
+    TEST_ASSERT_EQUAL_STRING("AB1234", result.zapNumber);
+    TEST_ASSERT_EQUAL(1, nvs->getStats().opens);
+    TEST_ASSERT_EQUAL(0, nvs->getStats().commits);
+    TEST_ASSERT_EQUAL(0, nvs->getStats().writes);
+    TEST_ASSERT_FALSE(nvs->isOpen());
+    TEST_ASSERT_EQUAL(0, upgradeCalls);
+}
+
+void test_missing_namespace_fails_initialization(void) {
+    NVSValidationResult result = validate(*nvs);
+    TEST_ASSERT_EQUAL((int)NVSStatus::INITIALIZATION_FAILED, (int)result.status);
+    TEST_ASSERT_EQUAL(CURRENT_VERSION, result.expectedVersion);
+    TEST_ASSERT_EQUAL(0, nvs->getStats().opens);
+}
+
+void test_upgrade_reopens_and_commits_once(void) {
+    poke(*nvs, EARS_NVS_KEY_ZAPNUMBER, "AB1234");
+    poke(*nvs, EARS_NVS_KEY_PASSWORD_HASH, "DEADBEEF");
+    nvs->resetStats();
+
+    NVSValidationResult result = validate(*nvs);
+    TEST_ASSERT_EQUAL((int)NVSStatus::UPGRADED, (int)result.status);
+    TEST_ASSERT_TRUE(result.wasUpgraded);
+    TEST_ASSERT_EQUAL(CURRENT_VERSION, result.currentVersion);
+    TEST_ASSERT_EQUAL(1, upgradeCalls);
+    TEST_ASSERT_EQUAL(2, nvs->getStats().opens);
+    TEST_ASSERT_EQUAL(1, nvs->getStats().commits);
+
+    TEST_ASSERT_EQUAL((int)NVSStatus::VALID, (int)validate(*nvs).status);
+    TEST_ASSERT_EQUAL(1, upgradeCalls);
+}
+
+void test_bad_versions_are_invalid(void) {
+    poke(*nvs, EARS_NVS_KEY_ZAPNUMBER, "AB1234");
+    upgradeResult = false;
+    nvs->resetStats();
+    TEST_ASSERT_EQUAL((int)NVSStatus::INVALID_VERSION, (int)validate(*nvs).status);
+    TEST_ASSERT_EQUAL(0, nvs->getStats().commits);
+
+    provision(*nvs, CURRENT_VERSION + 1, "AB1234", "DEADBEEF");
+    NVSValidationResult result = validate(*nvs);
+    TEST_ASSERT_EQUAL((int)NVSStatus::INVALID_VERSION, (int)result.status);
+    TEST_ASSERT_EQUAL(CURRENT_VERSION + 1, result.currentVersion);
+}
+
+void test_missing_and_tampered_values(void) {
+    provision(*nvs, 1, "A12345", "DEADBEEF");
+    TEST_ASSERT_EQUAL((int)NVSStatus::MISSING_ZAPNUMBER, (int)validate(*nvs).status);
+
+    provision(*nvs, 1, "AB1234", "");
+    TEST_ASSERT_EQUAL((int)NVSStatus::MISSING_PASSWORD, (int)validate(*nvs).status);
+
+    provision(*nvs, 1, "AB1234", "DEADBEEF");
+    poke(*nvs, EARS_NVS_KEY_PASSWORD_HASH, "00000000");
+    NVSValidationResult result = validate(*nvs);
+    TEST_ASSERT_EQUAL((int)NVSStatus::CRC_FAILED, (int)result.status);
+    TEST_ASSERT_FALSE(result.crcValid);
+}
+
+void test_scope_exit_commits_pending_writes(void) {
+    provision(*nvs, 1, "AB1234", "DEADBEEF");
+    nvs->resetStats();
+    {
+        EARS_nvsTransaction transaction(*nvs, false);
+        TEST_ASSERT_TRUE(transaction.putString(EARS_NVS_KEY_ZAPNUMBER, "CD5678"));
+        TEST_ASSERT_TRUE(transaction.putString(EARS_NVS_KEY_PASSWORD_HASH, "CAFEF00D"));
+        TEST_ASSERT_EQUAL(0, nvs->getStats().commits);
+    }
+    TEST_ASSERT_EQUAL(1, nvs->getStats().opens);
+    TEST_ASSERT_EQUAL(1, nvs->getStats().commits);
+    TEST_ASSERT_FALSE(nvs->isOpen());
+
+    NVSValidationResult result = validate(*nvs);
+    TEST_ASSERT_EQUAL((int)NVSStatus::VALID, (int)result.status);
+    TEST_ASSERT_EQUAL_STRING("CD5678", result.zapNumber);
+
+    // Nothing written, nothing committed; read only refuses writes
+    nvs->resetStats();
+    {
+        EARS_nvsTransaction writable(*nvs, false);
+        TEST_ASSERT_TRUE(writable.commit());
+    }
+    {
+        EARS_nvsTransaction readOnly(*nvs, true);
+        TEST_ASSERT_FALSE(readOnly.putString(EARS_NVS_KEY_ZAPNUMBER, "EF9012"));
+        TEST_ASSERT_FALSE(readOnly.updateCRC());
+    }
+    TEST_ASSERT_EQUAL(0, nvs->getStats().commits);
+    TEST_ASSERT_EQUAL(0, nvs->getStats().writes);
+}
+
+void test_matches_per_call_results(void) {
+    struct Case {
+        uint16_t version;
+        const char* zapNumber;
+        const char* passwordHash;
+        bool tamper;
+    };
+    const Case cases[] = {
+        {1, "AB1234", "DEADBEEF", false},
+        {0, "AB1234", "DEADBEEF", false},
+        {2, "AB1234", "DEADBEEF", false},
+        {1, "AB123", "DEADBEEF", false},
+        {1, "AB1234", "", false},
+        {1, "AB1234", "DEADBEEF", true},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        EARS_memNvs before;
+        EARS_memNvs after;
+        provision(before, cases[i].version, cases[i].zapNumber, cases[i].passwordHash);
+        provision(after, cases[i].version, cases[i].zapNumber, cases[i].passwordHash);
+        if (cases[i].tamper) {
+            poke(before, EARS_NVS_KEY_ZAPNUMBER, "ZZ9999");
+            poke(after, EARS_NVS_KEY_ZAPNUMBER, "ZZ9999");
+        }
+        NVSValidationResult expected = legacyValidate(before);
+        NVSValidationResult actual = validate(after);
+        TEST_ASSERT_EQUAL((int)expected.status, (int)actual.status);
+        TEST_ASSERT_EQUAL(expected.currentVersion, actual.currentVersion);
+        TEST_ASSERT_EQUAL_HEX32(expected.calculatedCRC, actual.calculatedCRC);
+        TEST_ASSERT_EQUAL_STRING(expected.zapNumber, actual.zapNumber);
+    }
+
+    // A ZapNumber change leaves the same record either way
+    EARS_memNvs before;
+    EARS_memNvs after;
+    provision(before, 1, "AB1234", "DEADBEEF");
+    provision(after, 1, "AB1234", "DEADBEEF");
+    TEST_ASSERT_TRUE(legacySetZapNumber(before, "XY4321"));
+    {
+        EARS_nvsTransaction transaction(after, false);
+        TEST_ASSERT_TRUE(transaction.putString(EARS_NVS_KEY_ZAPNUMBER, "XY4321"));
+        TEST_ASSERT_TRUE(transaction.commit());
+    }
+    TEST_ASSERT_EQUAL_HEX32(legacyValidate(before).calculatedCRC, validate(after).calculatedCRC);
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void report(const char* what, const MemNvsStats& perCall, const MemNvsStats& transaction) {
+    printf("[bench] %-18s per-call: %u opens, %u commits | transaction: %u opens, %u commits\n",
+           what, perCall.opens, perCall.commits, transaction.opens, transaction.commits);
+}
+
+/*
+  Opens and commits per operation on the emulator. Each open and each
+  commit is a flash access on the device; the time is emulator overhead.
+*/
+void benchmark_opens_and_commits(void) {
+    EARS_memNvs before;
+    EARS_memNvs after;
+
+    // Validation of a valid record
+    provision(before, 1, "AB1234", "DEADBEEF");
+    provision(after, 1, "AB1234", "DEADBEEF");
+    before.resetStats();
+    after.resetStats();
+    legacyValidate(before);
+    validate(after);
+    report("validate (valid)", before.getStats(), after.getStats());
+    TEST_ASSERT_EQUAL(2, before.getStats().opens);
+    TEST_ASSERT_EQUAL(1, after.getStats().opens);
+    TEST_ASSERT_EQUAL(0, after.getStats().commits);
+
+    // Validation that upgrades a version 0 record
+    provision(before, 0, "AB1234", "DEADBEEF");
+    provision(after, 0, "AB1234", "DEADBEEF");
+    before.resetStats();
+    after.resetStats();
+    legacyValidate(before);
+    validate(after);
+    report("validate (upgrade)", before.getStats(), after.getStats());
+    TEST_ASSERT_EQUAL(6, before.getStats().opens);
+    TEST_ASSERT_EQUAL(2, before.getStats().commits);
+    TEST_ASSERT_EQUAL(2, after.getStats().opens);
+    TEST_ASSERT_EQUAL(1, after.getStats().commits);
+
+    // ZapNumber change
+    before.resetStats();
+    after.resetStats();
+    legacySetZapNumber(before, "XY4321");
+    {
+        EARS_nvsTransaction transaction(after, false);
+        transaction.putString(EARS_NVS_KEY_ZAPNUMBER, "XY4321");
+    }
+    report("setZapNumber", before.getStats(), after.getStats());
+    TEST_ASSERT_EQUAL(3, before.getStats().opens);
+    TEST_ASSERT_EQUAL(1, after.getStats().commits);
+
+    // First-time setup: version, ZapNumber, password hash, CRC
+    EARS_memNvs blankBefore;
+    EARS_memNvs blankAfter;
+    legacyPutVersion(blankBefore, 1);
+    legacySetZapNumber(blankBefore, "AB1234");
+    legacyPut(blankBefore, EARS_NVS_KEY_PASSWORD_HASH, "DEADBEEF");
+    legacyUpdateCRC(blankBefore);
+    provision(blankAfter, 1, "AB1234", "DEADBEEF");
+    report("provisioning", blankBefore.getStats(), blankAfter.getStats());
+    TEST_ASSERT_EQUAL(1, blankAfter.getStats().opens);
+    TEST_ASSERT_EQUAL(1, blankAfter.getStats().commits);
+
+    // Emulator time per validation
+    const int rounds = 200000;
+    provision(before, 1, "AB1234", "DEADBEEF");
+    provision(after, 1, "AB1234", "DEADBEEF");
+    int valid = 0;
+    uint64_t start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        valid += legacyValidate(before).status == NVSStatus::VALID;
+    }
+    uint64_t perCallNs = nowNs() - start;
+    start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        valid += validate(after).status == NVSStatus::VALID;
+    }
+    uint64_t transactionNs = nowNs() - start;
+    printf("[bench] validate on emulator: per-call %.1f ns, transaction %.1f ns\n",
+           (double)perCallNs / rounds, (double)transactionNs / rounds);
+    TEST_ASSERT_EQUAL(2 * rounds, valid);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_keeps_previous_layout);
+    RUN_TEST(test_valid_record_opens_once);
+    RUN_TEST(test_missing_namespace_fails_initialization);
+    RUN_TEST(test_upgrade_reopens_and_commits_once);
+    RUN_TEST(test_bad_versions_are_invalid);
+    RUN_TEST(test_missing_and_tampered_values);
+    RUN_TEST(test_scope_exit_commits_pending_writes);
+    RUN_TEST(test_matches_per_call_results);
+    RUN_TEST(benchmark_opens_and_commits);
+    return UNITY_END();
+}
@@ -0,0 +1,247 @@
+/**
+ * @file test_host_path_cache.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the path metadata cache.
+ * @section tests Tests
+ * - Hits, misses and negative entries; a trailing '/' names the same path.
+ * - Appends grow cached sizes and turn MISSING into FILE.
+ * - Least recently used eviction; erase, eraseTree and clear.
+ * - Metadata operations of a log session with rotations, uncached vs cached,
+ *   through a wrapper keeping the cache coherent the way EARS_sdCard does.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "EARS_pathCache.h"
+#include "EARS_memFs.h"
+#include "EARS_fsPortLib.h"
+
+static EARS_pathCache* cache;
+
+void setUp(void) {
+    cache = new EARS_pathCache();
+}
+
+void tearDown(void) {
+    delete cache;
+}
+
+void test_hits_misses_and_negative_entries(void) {
+    PathInfo info;
+    TEST_ASSERT_FALSE(cache->lookup("/logs/debug.log", info));
+
+    cache->store("/logs/debug.log", PathInfo(PathType::FILE, true, 1234));
+    cache->store("/logs/debug.log.5", PathInfo());
+    cache->store("/logs/", PathInfo(PathType::DIRECTORY, false, 0));
+
+    TEST_ASSERT_TRUE(cache->lookup("/logs/debug.log", info));
+    TEST_ASSERT_EQUAL((int)PathType::FILE, (int)info.type);
+    TEST_ASSERT_EQUAL(1234, info.size);
+    TEST_ASSERT_TRUE(cache->lookup("/logs/debug.log.5", info));
+    TEST_ASSERT_EQUAL((int)PathType::MISSING, (int)info.type);
+    TEST_ASSERT_TRUE(cache->lookup("/logs", info));
+    TEST_ASSERT_EQUAL((int)PathType::DIRECTORY, (int)info.type);
+    TEST_ASSERT_FALSE(cache->lookup("/logs/debug", info));
+
+    PathCacheStats stats = cache->getStats();
+    TEST_ASSERT_EQUAL(3, stats.hits);
+    TEST_ASSERT_EQUAL(2, stats.misses);
+}
+
+void test_appends_grow_sizes(void) {
+    cache->store("/a", PathInfo(PathType::FILE, true, 10));
+    cache->store("/b", PathInfo());
+    cache->store("/c", PathInfo(PathType::FILE, false, 0));
+    cache->appended("/a", 5);
+    cache->appended("/b", 7);
+    cache->appended("/c", 9);
+    cache->appended("/uncached", 3);
+
+    PathInfo info;
+    cache->lookup("/a", info);
+    TEST_ASSERT_EQUAL(15, info.size);
+    cache->lookup("/b", info);
+    TEST_ASSERT_EQUAL((int)PathType::FILE, (int)info.type);
+    TEST_ASSERT_TRUE(info.sizeKnown);
+    TEST_ASSERT_EQUAL(7, info.size);
+    cache->lookup("/c", info);
+    TEST_ASSERT_FALSE(info.sizeKnown);
+    TEST_ASSERT_FALSE(cache->lookup("/uncached", info));
+}
+
+void test_least_recently_used_is_evicted(void) {
+    char path[16];
+    for (int i = 0; i < EARS_pathCache::MAX_ENTRIES; i++) {
+        snprintf(path, sizeof(path), "/f%d", i);
+        cache->store(path, PathInfo(PathType::FILE, true, i));
+    }
+    PathInfo info;
+    TEST_ASSERT_TRUE(cache->lookup("/f0", info));
+
+    cache->store("/new", PathInfo());
+    TEST_ASSERT_EQUAL(EARS_pathCache::MAX_ENTRIES, cache->count());
+    TEST_ASSERT_TRUE(cache->lookup("/f0", info));
+    TEST_ASSERT_FALSE(cache->lookup("/f1", info));
+    TEST_ASSERT_EQUAL(1, cache->getStats().evictions);
+
+    std::string longPath(EARS_pathCache::PATH_BYTES, 'x');
+    cache->store(longPath.c_str(), PathInfo());
+    TEST_ASSERT_FALSE(cache->lookup(longPath.c_str(), info));
+}
+
+void test_erase_tree_and_clear(void) {
+    cache->store("/logs", PathInfo(PathType::DIRECTORY, false, 0));
+    cache->store("/logs/debug.log", PathInfo(PathType::FILE, true, 1));
+    cache->store("/logs/old/debug.log.1", PathInfo(PathType::FILE, true, 1));
+    cache->store("/logsbackup", PathInfo(PathType::DIRECTORY, false, 0));
+    cache->store("/config/ears.config", PathInfo(PathType::FILE, true, 1));
+
+    cache->eraseTree("/logs/");
+    PathInfo info;
+    TEST_ASSERT_FALSE(cache->lookup("/logs", info));
+    TEST_ASSERT_FALSE(cache->lookup("/logs/debug.log", info));
+    TEST_ASSERT_FALSE(cache->lookup("/logs/old/debug.log.1", info));
+    TEST_ASSERT_TRUE(cache->lookup("/logsbackup", info));
+
+    cache->erase("/logsbackup/");
+    TEST_ASSERT_FALSE(cache->lookup("/logsbackup", info));
+    TEST_ASSERT_EQUAL(1, cache->count());
+
+    cache->clear();
+    TEST_ASSERT_EQUAL(0, cache->count());
+    TEST_ASSERT_EQUAL(1, cache->getStats().clears);
+}
+
+/*
+  fsPort wrapper keeping the cache coherent the way EARS_sdCard does:
+  misses stat the file, its own writes, removes and renames update entries
+*/
+class CachedFs : public EARS_fsPort {
+public:
+    EARS_memFs& fs;
+    EARS_pathCache paths;
+    bool enabled;
+
+    CachedFs(EARS_memFs& backing, bool useCache) : fs(backing), enabled(useCache) {}
+
+    bool fileExists(const char* path) override {
+        PathInfo info;
+        if (enabled && paths.lookup(path, info)) {
+            return info.type == PathType::FILE;
+        }
+        bool exists = fs.fileExists(path);
+        const std::string* content = fs.peek(path);
+        paths.store(path, exists ? PathInfo(PathType::FILE, true, (uint32_t)content->size()) : PathInfo());
+        return exists;
+    }
+    uint32_t getFileSize(const char* path) {
+        PathInfo info;
+        if (enabled && paths.lookup(path, info)) {
+            return info.size;
+        }
+        // The device opens the file for its size
+        bool exists = fs.fileExists(path);
+        uint32_t size = exists ? (uint32_t)fs.peek(path)->size() : 0;
+        paths.store(path, exists ? PathInfo(PathType::FILE, true, size) : PathInfo());
+        return size;
+    }
+    bool removeFile(const char* path) override {
+        bool ok = fs.removeFile(path);
+        if (ok) paths.store(path, PathInfo()); else paths.erase(path);
+        return ok;
+    }
+    bool renameFile(const char* fromPath, const char* toPath) override {
+        PathInfo moved;
+        bool known = paths.lookup(fromPath, moved);
+        bool ok = fs.renameFile(fromPath, toPath);
+        paths.erase(toPath);
+        if (ok) {
+            paths.store(fromPath, PathInfo());
+            if (known) paths.store(toPath, moved);
+        } else {
+            paths.erase(fromPath);
+        }
+        return ok;
+    }
+    size_t readFileAt(const char* path, uint32_t offset, uint8_t* buffer, size_t length) override {
+        return fs.readFileAt(path, offset, buffer, length);
+    }
+    bool appendFile(const char* path, const uint8_t* data, size_t length) override {
+        bool ok = fs.appendFile(path, data, length);
+        if (ok) paths.appended(path, (uint32_t)length); else paths.erase(path);
+        return ok;
+    }
+};
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  A size check before every 96 byte append and a 5 generation rotation at
+  64 KB, 200 rotations long
+*/
+static uint32_t runSession(CachedFs& fs) {
+    static uint8_t line[96];
+    memset(line, 'x', sizeof(line));
+    const char* path = "/logs/debug.log";
+    uint32_t rotations = 0;
+    while (rotations < 200) {
+        if (fs.getFileSize(path) + sizeof(line) > 65536) {
+            TEST_ASSERT_TRUE(EARS_rotateGenerations(fs, path, 5));
+            rotations++;
+        }
+        fs.appendFile(path, line, sizeof(line));
+    }
+    return rotations;
+}
+
+void benchmark_rotation_metadata_ops(void) {
+    EARS_memFs plainFs;
+    CachedFs uncached(plainFs, false);
+    uint64_t start = nowNs();
+    runSession(uncached);
+    uint64_t uncachedNs = nowNs() - start;
+    MemFsStats plain = plainFs.getStats();
+
+    EARS_memFs cachedFs;
+    CachedFs cached(cachedFs, true);
+    start = nowNs();
+    runSession(cached);
+    uint64_t cachedNs = nowNs() - start;
+    MemFsStats withCache = cachedFs.getStats();
+    PathCacheStats stats = cached.paths.getStats();
+
+    printf("[bench] uncached: %6u metadata ops (exists/stat/remove/rename), %6.1f ms\n",
+           plain.metadataOps, uncachedNs / 1e6);
+    printf("[bench] cached:   %6u metadata ops, %u hits, %u misses, %6.1f ms\n",
+           withCache.metadataOps, stats.hits, stats.misses, cachedNs / 1e6);
+
+    TEST_ASSERT_TRUE(plainFs.peek("/logs/debug.log.5") != nullptr);
+    TEST_ASSERT_EQUAL(plainFs.fileCount(), cachedFs.fileCount());
+    for (int i = 1; i <= 5; i++) {
+        char path[32];
+        snprintf(path, sizeof(path), "/logs/debug.log.%d", i);
+        TEST_ASSERT_EQUAL(plainFs.peek(path)->size(), cachedFs.peek(path)->size());
+    }
+    // Only the removes and renames themselves remain
+    TEST_ASSERT_TRUE(withCache.metadataOps * 10 < plain.metadataOps);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_hits_misses_and_negative_entries);
+    RUN_TEST(test_appends_grow_sizes);
+    RUN_TEST(test_least_recently_used_is_evicted);
+    RUN_TEST(test_erase_tree_and_clear);
+    RUN_TEST(benchmark_rotation_metadata_ops);
+    return UNITY_END();
+}
@@ -0,0 +1,507 @@
+/**
+ * @file test_host_prealloc_log.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and simulation for preallocated log files.
+ * @section tests Tests
+ * - Create, append, commit; a reopen sees only committed data.
+ * - A torn header slot falls back to the other one.
+ * - Plain files are refused; rotation recycles the oldest generation.
+ * - The log reader and compressor return only the committed data.
+ * - FAT simulation over many rotation cycles, a log growing by appends vs
+ *   a preallocated one, next to a second growing file and config
+ *   rewrites: fragments per log file, free space runs and modelled
+ *   append latency in the first and last cycles.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include "EARS_preallocLog.h"
+#include "EARS_memFs.h"
+#include "EARS_logCompressLib.h"
+#include "EARS_logCompressReader.h"
+
+static const char* LOG_PATH = "/logs/debug.log";
+static const uint32_t CAPACITY = 4096;
+
+static EARS_memFs* fs;
+
+void setUp(void) {
+    fs = new EARS_memFs();
+}
+
+void tearDown(void) {
+    delete fs;
+}
+
+static bool appendText(EARS_preallocLog& log, const char* text) {
+    return log.append(*fs, LOG_PATH, reinterpret_cast<const uint8_t*>(text), strlen(text));
+}
+
+void test_create_append_commit_reopen(void) {
+    EARS_preallocLog log;
+    log.begin(CAPACITY);
+    TEST_ASSERT_TRUE(log.attach(*fs, LOG_PATH));
+    TEST_ASSERT_EQUAL(EARS_preallocLog::HEADER_BYTES + CAPACITY, fs->peek(LOG_PATH)->size());
+    TEST_ASSERT_EQUAL(1, log.getStats().created);
+
+    TEST_ASSERT_TRUE(appendText(log, "first line\n"));
+    TEST_ASSERT_TRUE(log.isDirty());
+    TEST_ASSERT_TRUE(log.commit(*fs, LOG_PATH));
+    TEST_ASSERT_FALSE(log.isDirty());
+    TEST_ASSERT_TRUE(appendText(log, "lost line\n"));
+    TEST_ASSERT_EQUAL(21, log.end());
+
+    // A reset before the next commit: the file still has its size, the header the old end
+    EARS_preallocLog reopened;
+    reopened.begin(CAPACITY);
+    TEST_ASSERT_TRUE(reopened.attach(*fs, LOG_PATH));
+    TEST_ASSERT_EQUAL(11, reopened.end());
+    TEST_ASSERT_EQUAL(CAPACITY, reopened.capacity());
+    TEST_ASSERT_TRUE(appendText(reopened, "next\n"));
+    TEST_ASSERT_EQUAL_MEMORY("first line\nnext\n",
+                             fs->peek(LOG_PATH)->data() + EARS_preallocLog::HEADER_BYTES, 16);
+
+    // Full: nothing is written past the capacity
+    std::string big(CAPACITY - 16, 'x');
+    TEST_ASSERT_TRUE(reopened.fits(big.size()));
+    TEST_ASSERT_FALSE(reopened.fits(big.size() + 1));
+    TEST_ASSERT_FALSE(appendText(reopened, (big + "y").c_str()));
+    TEST_ASSERT_EQUAL(1, reopened.getStats().full);
+    TEST_ASSERT_EQUAL(EARS_preallocLog::HEADER_BYTES + CAPACITY, fs->peek(LOG_PATH)->size());
+}
+
+void test_torn_header_uses_other_slot(void) {
+    EARS_preallocLog log;
+    log.begin(CAPACITY);
+    TEST_ASSERT_TRUE(log.attach(*fs, LOG_PATH));
+    appendText(log, "abc");
+    log.commit(*fs, LOG_PATH);      // sequence 1, slot B
+    appendText(log, "def");
+    log.commit(*fs, LOG_PATH);      // sequence 2, slot A
+
+    PreallocHeader header;
+    TEST_ASSERT_TRUE(EARS_preallocLog::readHeader(*fs, LOG_PATH, header));
+    TEST_ASSERT_EQUAL(6, header.end);
+    TEST_ASSERT_EQUAL(2, header.sequence);
+
+    // Half of slot A reached the card
+    uint8_t torn[8];
+    memset(torn, 0, sizeof(torn));
+    fs->writeFileAt(LOG_PATH, 10, torn, sizeof(torn));
+    TEST_ASSERT_TRUE(EARS_preallocLog::readHeader(*fs, LOG_PATH, header));
+    TEST_ASSERT_EQUAL(3, header.end);
+    TEST_ASSERT_EQUAL(1, header.sequence);
+
+    // Sequence numbers compare across wrap-around
+    PreallocHeader older;
+    older.capacity = 10;
+    older.sequence = 0xFFFFFFFF;
+    PreallocHeader newer = older;
+    newer.sequence = 0;
+    newer.end = 5;
+    uint8_t slot[EARS_preallocLog::SLOT_RECORD_BYTES];
+    EARS_preallocLog::encodeSlot(older, slot);
+    fs->writeFileAt(LOG_PATH, 0, slot, sizeof(slot));
+    EARS_preallocLog::encodeSlot(newer, slot);
+    fs->writeFileAt(LOG_PATH, EARS_preallocLog::SLOT_BYTES, slot, sizeof(slot));
+    TEST_ASSERT_TRUE(EARS_preallocLog::readHeader(*fs, LOG_PATH, header));
+    TEST_ASSERT_EQUAL(5, header.end);
+}
+
+void test_plain_file_refused_and_rotation_recycles(void) {
+    fs->writeFile(LOG_PATH, "plain\n", 6);
+    EARS_preallocLog log;
+    log.begin(CAPACITY);
+    TEST_ASSERT_FALSE(log.attach(*fs, LOG_PATH));
+    TEST_ASSERT_FALSE(log.isAttached());
+
+    // The plain file rotates away like any generation
+    TEST_ASSERT_TRUE(log.rotate(*fs, LOG_PATH, 2));
+    TEST_ASSERT_TRUE(fs->fileExists("/logs/debug.log.1"));
+
+    for (int cycle = 0; cycle < 6; cycle++) {
+        TEST_ASSERT_TRUE(log.attach(*fs, LOG_PATH));
+        char line[32];
+        snprintf(line, sizeof(line), "cycle %d\n", cycle);
+        appendText(log, line);
+        TEST_ASSERT_TRUE(log.rotate(*fs, LOG_PATH, 2));
+        TEST_ASSERT_FALSE(fs->fileExists(LOG_PATH));
+    }
+    // Three files exist at most (active, .1, .2); then the oldest is reused
+    PreallocStats stats = log.getStats();
+    TEST_ASSERT_EQUAL(3, stats.created);
+    TEST_ASSERT_EQUAL(3, stats.recycled);
+    TEST_ASSERT_TRUE(fs->fileExists("/logs/debug.log.spare"));
+
+    // A recycled file shows none of its old data
+    TEST_ASSERT_TRUE(log.attach(*fs, LOG_PATH));
+    TEST_ASSERT_EQUAL(0, log.end());
+    TEST_ASSERT_FALSE(fs->fileExists("/logs/debug.log.spare"));
+    PreallocHeader header;
+    TEST_ASSERT_TRUE(EARS_preallocLog::readHeader(*fs, "/logs/debug.log.1", header));
+    TEST_ASSERT_EQUAL(8, header.end);
+}
+
+void test_reader_and_compressor_see_committed_data(void) {
+    EARS_preallocLog log;
+    log.begin(CAPACITY);
+    TEST_ASSERT_TRUE(log.attach(*fs, LOG_PATH));
+    std::string text;
+    for (int i = 0; i < 40; i++) {
+        char line[48];
+        snprintf(line, sizeof(line), "2026-10-16 12:00:%02d [INFO] line %d\n", i % 60, i);
+        text += line;
+        appendText(log, line);
+    }
+    log.commit(*fs, LOG_PATH);
+    appendText(log, "not committed\n");
+
+    std::vector<uint8_t> workspace(EARS_logCompressReader::workspaceBytes(1024));
+    EARS_logCompressReader reader;
+    TEST_ASSERT_TRUE(reader.begin(workspace.data(), workspace.size(), 1024));
+    TEST_ASSERT_TRUE(reader.open(*fs, LOG_PATH));
+    std::string read;
+    uint8_t chunk[100];
+    size_t got;
+    while ((got = reader.read(chunk, sizeof(chunk))) > 0) {
+        read.append(reinterpret_cast<char*>(chunk), got);
+    }
+    TEST_ASSERT_EQUAL(text.size(), read.size());
+    TEST_ASSERT_TRUE(text == read);
+
+    std::vector<uint8_t> compressWorkspace(EARS_logCompressor::workspaceBytes(1024));
+    EARS_logCompressor compressor;
+    TEST_ASSERT_TRUE(compressor.begin(compressWorkspace.data(), compressWorkspace.size(), 1024));
+    LogCompressStats stats;
+    TEST_ASSERT_TRUE(compressor.compressFile(*fs, LOG_PATH, "/logs/debug.log.tmp", stats));
+    TEST_ASSERT_EQUAL(text.size(), stats.rawBytes);
+
+    TEST_ASSERT_TRUE(reader.open(*fs, "/logs/debug.log.tmp"));
+    TEST_ASSERT_TRUE(reader.isCompressed());
+    read.clear();
+    while ((got = reader.read(chunk, sizeof(chunk))) > 0) {
+        read.append(reinterpret_cast<char*>(chunk), got);
+    }
+    TEST_ASSERT_TRUE(text == read);
+}
+
+/*
+  FAT volume model: files are cluster chains allocated the way FatFs does
+  (the next cluster after the file's last one if free, else a scan from
+  the last cluster allocated anywhere). Every write is charged a modelled
+  SD card time:
+  - 300 us per command, 30 us per 512 byte sector
+  - 1000 us when it continues in a cluster that does not follow the one
+    the file wrote last (a new allocation unit on the card)
+  - per cluster allocated: 3 x 400 us for both FAT copies and the
+    directory entry, plus 200 us per FAT sector (128 entries) scanned
+*/
+class SimFatFs : public EARS_fsPort {
+public:
+    static const uint32_t CLUSTER_BYTES = 4096;
+    static const uint32_t CLUSTERS = 8192;      // 32 MB volume
+
+    SimFatFs() : _used(CLUSTERS, false), _lastAllocated(0), _lastCostUs(0) {}
+
+    bool fileExists(const char* path) override {
+        return _files.count(path) != 0;
+    }
+
+    bool removeFile(const char* path) override {
+        std::map<std::string, File>::iterator it = _files.find(path);
+        if (it == _files.end()) {
+            return false;
+        }
+        for (size_t i = 0; i < it->second.clusters.size(); i++) {
+            _used[it->second.clusters[i]] = false;
+        }
+        _files.erase(it);
+        return true;
+    }
+
+    bool renameFile(const char* fromPath, const char* toPath) override {
+        std::map<std::string, File>::iterator it = _files.find(fromPath);
+        if (it == _files.end() || _files.count(toPath)) {
+            return false;
+        }
+        _files[toPath] = it->second;
+        _files.erase(fromPath);
+        return true;
+    }
+
+    size_t readFileAt(const char* path, uint32_t offset, uint8_t* buffer, size_t length) override {
+        std::map<std::string, File>::iterator it = _files.find(path);
+        if (it == _files.end() || offset >= it->second.data.size()) {
+            return 0;
+        }
+        size_t count = std::min(length, it->second.data.size() - offset);
+        memcpy(buffer, it->second.data.data() + offset, count);
+        return count;
+    }
+
+    bool appendFile(const char* path, const uint8_t* data, size_t length) override {
+        File& file = _files[path];
+        return write(file, (uint32_t)file.data.size(), data, length);
+    }
+
+    bool preallocateFile(const char* path, uint32_t bytes) override {
+        removeFile(path);
+        File& file = _files[path];
+        _lastCostUs = 300;
+        if (!allocate(file, bytes)) {
+            return false;
+        }
+        file.data.assign(bytes, '\xFF');
+        return true;
+    }
+
+    bool writeFileAt(const char* path, uint32_t offset, const uint8_t* data, size_t length) override {
+        std::map<std::string, File>::iterator it = _files.find(path);
+        if (it == _files.end() || offset > it->second.data.size()) {
+            return false;
+        }
+        return write(it->second, offset, data, length);
+    }
+
+    /**
+     * @brief Contiguous runs in a file's cluster chain
+     */
+    uint32_t fragments(const char* path) const {
+        std::map<std::string, File>::const_iterator it = _files.find(path);
+        if (it == _files.end() || it->second.clusters.empty()) {
+            return 0;
+        }
+        uint32_t runs = 1;
+        for (size_t i = 1; i < it->second.clusters.size(); i++) {
+            if (it->second.clusters[i] != it->second.clusters[i - 1] + 1) {
+                runs++;
+            }
+        }
+        return runs;
+    }
+
+    /**
+     * @brief Runs of free clusters on the volume
+     */
+    uint32_t freeRuns() const {
+        uint32_t runs = 0;
+        for (uint32_t i = 0; i < CLUSTERS; i++) {
+            if (!_used[i] && (i == 0 || _used[i - 1])) {
+                runs++;
+            }
+        }
+        return runs;
+    }
+
+    uint32_t lastCostUs() const { return _lastCostUs; }
+
+private:
+    struct File {
+        std::string data;
+        std::vector<uint32_t> clusters;
+        int64_t lastCluster;        // Cluster written last, -1 = none
+        File() : lastCluster(-1) {}
+    };
+
+    std::map<std::string, File> _files;
+    std::vector<bool> _used;
+    uint32_t _lastAllocated;
+    uint32_t _lastCostUs;
+
+    bool allocate(File& file, uint64_t bytes) {
+        while ((uint64_t)file.clusters.size() * CLUSTER_BYTES < bytes) {
+            uint32_t start = file.clusters.empty() ? _lastAllocated : file.clusters.back();
+            uint32_t candidate = (start + 1) % CLUSTERS;
+            uint32_t scanned = 1;
+            if (_used[candidate]) {
+                candidate = (_lastAllocated + 1) % CLUSTERS;
+                while (_used[candidate] && scanned < CLUSTERS) {
+                    candidate = (candidate + 1) % CLUSTERS;
+                    scanned++;
+                }
+                if (scanned >= CLUSTERS) {
+                    return false;
+                }
+            }
+            _used[candidate] = true;
+            _lastAllocated = candidate;
+            file.clusters.push_back(candidate);
+            _lastCostUs += 3 * 400 + 200 * ((scanned + 127) / 128);
+        }
+        return true;
+    }
+
+    bool write(File& file, uint32_t offset, const uint8_t* data, size_t length) {
+        _lastCostUs = 300 + 30 * (uint32_t)((length + 511) / 512);
+        if (!allocate(file, (uint64_t)offset + length)) {
+            return false;
+        }
+        if (offset + length > file.data.size()) {
+            file.data.resize(offset + length);
+        }
+        file.data.replace(offset, length, reinterpret_cast<const char*>(data), length);
+
+        // Each cluster the write touches, charged when it does not follow the last one
+        for (uint32_t at = offset; at < offset + length; at = (at / CLUSTER_BYTES + 1) * CLUSTER_BYTES) {
+            uint32_t cluster = file.clusters[at / CLUSTER_BYTES];
+            if (file.lastCluster >= 0 && cluster != (uint32_t)file.lastCluster &&
+                cluster != (uint32_t)file.lastCluster + 1) {
+                _lastCostUs += 1000;
+            }
+            file.lastCluster = cluster;
+        }
+        return true;
+    }
+};
+
+struct CycleLatency {
+    std::vector<uint32_t> costs;
+
+    double mean() const {
+        double total = 0;
+        for (size_t i = 0; i < costs.size(); i++) {
+            total += costs[i];
+        }
+        return costs.empty() ? 0 : total / costs.size();
+    }
+
+    uint32_t p99() const {
+        std::vector<uint32_t> sorted = costs;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted.empty() ? 0 : sorted[sorted.size() * 99 / 100];
+    }
+};
+
+struct SimResult {
+    CycleLatency first;
+    CycleLatency last;
+    double fragmentsPerLog;
+    uint32_t freeRuns;
+    PreallocStats prealloc;
+};
+
+/*
+  One write cache block (4 KB) per log write; a trace file takes a block
+  every other log write and rotates on its own; the config file is
+  rewritten now and then. The logger commits its header every 16 writes.
+*/
+static SimResult simulate(bool preallocated, int cycles) {
+    const uint32_t logBytes = 256 * 1024;
+    const uint32_t traceBytes = 384 * 1024;
+    const char* tracePath = "/data/trace.csv";
+    const char* configPath = "/config/ears.config";
+    uint8_t block[SimFatFs::CLUSTER_BYTES];
+    memset(block, 'L', sizeof(block));
+
+    SimFatFs sim;
+    EARS_preallocLog log;
+    log.begin(logBytes);
+    SimResult result;
+    result.fragmentsPerLog = 0;
+
+    uint32_t written = 0;
+    uint32_t writes = 0;
+    for (int cycle = 0; cycle < cycles; cycle++) {
+        CycleLatency latency;
+        while (written + sizeof(block) <= logBytes) {
+            if (preallocated) {
+                if (!log.isAttached()) {
+                    TEST_ASSERT_TRUE(log.attach(sim, LOG_PATH));
+                }
+                TEST_ASSERT_TRUE(log.append(sim, LOG_PATH, block, sizeof(block)));
+                latency.costs.push_back(sim.lastCostUs());
+                if (++writes % 16 == 0) {
+                    log.commit(sim, LOG_PATH);
+                    latency.costs.push_back(sim.lastCostUs());
+                }
+            } else {
+                TEST_ASSERT_TRUE(sim.appendFile(LOG_PATH, block, sizeof(block)));
+                latency.costs.push_back(sim.lastCostUs());
+                writes++;
+            }
+            written += sizeof(block);
+
+            // The other writers on the card
+            if (writes % 2 == 0) {
+                uint8_t trace[SimFatFs::CLUSTER_BYTES];
+                memset(trace, 'T', sizeof(trace));
+                uint8_t probe;
+                if (sim.readFileAt(tracePath, traceBytes - sizeof(trace), &probe, 1) == 1) {
+                    EARS_rotateGenerations(sim, tracePath, 2);
+                }
+                sim.appendFile(tracePath, trace, sizeof(trace));
+            }
+            if (writes % 24 == 0) {
+                sim.removeFile(configPath);
+                sim.appendFile(configPath, block, 1500);
+            }
+        }
+
+        if (preallocated) {
+            TEST_ASSERT_TRUE(log.rotate(sim, LOG_PATH, 3));
+        } else {
+            TEST_ASSERT_TRUE(EARS_rotateGenerations(sim, LOG_PATH, 3));
+        }
+        written = 0;
+
+        if (cycle == 0) {
+            result.first = latency;
+        }
+        result.last = latency;
+    }
+
+    uint32_t total = 0;
+    for (unsigned generation = 1; generation <= 3; generation++) {
+        char path[64];
+        snprintf(path, sizeof(path), "%s.%u", LOG_PATH, generation);
+        total += sim.fragments(path);
+    }
+    result.fragmentsPerLog = total / 3.0;
+    result.freeRuns = sim.freeRuns();
+    result.prealloc = log.getStats();
+    return result;
+}
+
+void benchmark_fragmentation_across_rotations(void) {
+    const int cycles = 60;
+    SimResult plain = simulate(false, cycles);
+    SimResult prealloc = simulate(true, cycles);
+
+    printf("[bench] %d rotation cycles of a 256 KB log, 4 KB writes, modelled card time\n", cycles);
+    printf("[bench] appended:     %.1f fragments/log file, %u free runs, "
+           "cycle 1 %.0f us mean %u us p99, cycle %d %.0f us mean %u us p99\n",
+           plain.fragmentsPerLog, plain.freeRuns, plain.first.mean(), plain.first.p99(),
+           cycles, plain.last.mean(), plain.last.p99());
+    printf("[bench] preallocated: %.1f fragments/log file, %u free runs, "
+           "cycle 1 %.0f us mean %u us p99, cycle %d %.0f us mean %u us p99\n",
+           prealloc.fragmentsPerLog, prealloc.freeRuns, prealloc.first.mean(), prealloc.first.p99(),
+           cycles, prealloc.last.mean(), prealloc.last.p99());
+    printf("[bench] preallocated files: %u created, %u recycled, %u header commits\n",
+           (unsigned)prealloc.prealloc.created, (unsigned)prealloc.prealloc.recycled,
+           (unsigned)prealloc.prealloc.commits);
+
+    TEST_ASSERT_TRUE(prealloc.fragmentsPerLog < plain.fragmentsPerLog);
+    TEST_ASSERT_TRUE(prealloc.last.mean() < plain.last.mean());
+    TEST_ASSERT_TRUE(prealloc.last.p99() <= plain.last.p99());
+    TEST_ASSERT_EQUAL(cycles, prealloc.prealloc.created + prealloc.prealloc.recycled);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_create_append_commit_reopen);
+    RUN_TEST(test_torn_header_uses_other_slot);
+    RUN_TEST(test_plain_file_refused_and_rotation_recycles);
+    RUN_TEST(test_reader_and_compressor_see_committed_data);
+    RUN_TEST(benchmark_fragmentation_across_rotations);
+    return UNITY_END();
+}
@@ -0,0 +1,288 @@
+/**
+ * @file test_host_sd_read.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for EARS_sdCard::readFile() bulk reads.
+ * @section tests Tests
+ * - Per-byte, bulk String and caller buffer reads return the same bytes.
+ * - The caller buffer read stops at capacity and handles empty files.
+ * - MB/s and heap allocations of each path for 4 KB, 64 KB and 1 MB files.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <chrono>
+#include <string>
+
+/*
+  Stand-ins for the Arduino pieces readFile() uses. fs::File forwards every
+  call to a virtual FileImpl backed by stdio (VFSFileImpl on the device), and
+  File::read() with no arguments is a one byte read through it. StandInString
+  grows like the ESP32 core's String: realloc to the next 16 byte multiple.
+  Every heap call is counted.
+*/
+static uint32_t heapAllocations = 0;
+
+static void* countedRealloc(void* p, size_t bytes) {
+    heapAllocations++;
+    return realloc(p, bytes);
+}
+
+static void* countedMalloc(size_t bytes) {
+    heapAllocations++;
+    return malloc(bytes);
+}
+
+class FileImpl {
+public:
+    explicit FileImpl(const char* path) : _file(fopen(path, "rb")), _size(0), _position(0) {
+        if (_file) {
+            fseek(_file, 0, SEEK_END);
+            _size = (size_t)ftell(_file);
+            fseek(_file, 0, SEEK_SET);
+        }
+    }
+    virtual ~FileImpl() {
+        if (_file) fclose(_file);
+    }
+    virtual size_t read(uint8_t* buffer, size_t length) {
+        size_t count = fread(buffer, 1, length, _file);
+        _position += count;
+        return count;
+    }
+    virtual size_t size() const { return _size; }
+    virtual size_t position() const { return _position; }
+    bool isOpen() const { return _file != nullptr; }
+
+private:
+    FILE* _file;
+    size_t _size;
+    size_t _position;
+};
+
+class File {
+public:
+    explicit File(const char* path) : _impl(new FileImpl(path)) {}
+    ~File() { delete _impl; }
+    operator bool() const { return _impl->isOpen(); }
+    int available() { return (int)(_impl->size() - _impl->position()); }
+    int read() {
+        uint8_t c;
+        return _impl->read(&c, 1) ? c : -1;
+    }
+    size_t read(uint8_t* buffer, size_t length) { return _impl->read(buffer, length); }
+    size_t size() const { return _impl->size(); }
+
+private:
+    FileImpl* _impl;
+};
+
+class StandInString {
+public:
+    StandInString() : _buffer(nullptr), _capacity(0), _length(0) {}
+    ~StandInString() { free(_buffer); }
+    bool reserve(size_t size) {
+        if (_buffer && _capacity >= size) return true;
+        size_t newSize = (size + 16) & ~(size_t)0xf;
+        char* grown = (char*)countedRealloc(_buffer, newSize);
+        if (!grown) return false;
+        _buffer = grown;
+        _capacity = newSize - 1;
+        return true;
+    }
+    StandInString& operator+=(char c) {
+        if (reserve(_length + 1)) {
+            _buffer[_length++] = c;
+            _buffer[_length] = 0;
+        }
+        return *this;
+    }
+    bool concat(const uint8_t* data, size_t length) {
+        if (!reserve(_length + length)) return false;
+        memcpy(_buffer + _length, data, length);
+        _length += length;
+        _buffer[_length] = 0;
+        return true;
+    }
+    size_t length() const { return _length; }
+    const char* c_str() const { return _buffer ? _buffer : ""; }
+
+private:
+    char* _buffer;
+    size_t _capacity;
+    size_t _length;
+};
+
+static const size_t READ_BLOCK_BYTES = 16384;
+
+// readFile() before: one virtual call and a possible realloc per byte
+static void readPerByte(const char* path, StandInString& content) {
+    File file(path);
+    while (file.available()) {
+        content += char(file.read());
+    }
+}
+
+// readFile() now: reserve once, READ_BLOCK_BYTES reads staged in one block
+static void readBulk(const char* path, StandInString& content) {
+    File file(path);
+    size_t remaining = file.size();
+    if (!content.reserve(remaining)) return;
+    uint8_t* block = (uint8_t*)countedMalloc(READ_BLOCK_BYTES);
+    while (remaining > 0) {
+        size_t count = file.read(block, remaining < READ_BLOCK_BYTES ? remaining : READ_BLOCK_BYTES);
+        if (count == 0) break;
+        content.concat(block, count);
+        remaining -= count;
+    }
+    free(block);
+}
+
+// readFile(path, buffer, capacity): straight into the caller's buffer
+static size_t readIntoBuffer(const char* path, uint8_t* buffer, size_t capacity) {
+    File file(path);
+    if (!file) return 0;
+    size_t wanted = file.size() < capacity ? file.size() : capacity;
+    size_t total = 0;
+    while (total < wanted) {
+        size_t chunk = wanted - total < READ_BLOCK_BYTES ? wanted - total : READ_BLOCK_BYTES;
+        size_t count = file.read(buffer + total, chunk);
+        if (count == 0) break;
+        total += count;
+    }
+    return total;
+}
+
+static std::string makeFile(const char* path, size_t bytes) {
+    std::string data;
+    data.reserve(bytes);
+    unsigned line = 0;
+    while (data.size() < bytes) {
+        char text[96];
+        snprintf(text, sizeof(text), "2026-10-16 12:00:%02u [INFO ] line %u of the log\n", line % 60, line);
+        data += text;
+        line++;
+    }
+    data.resize(bytes);
+    FILE* file = fopen(path, "wb");
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+    return data;
+}
+
+static const char* PATH = "test_host_sd_read.tmp";
+
+void setUp(void) {
+    heapAllocations = 0;
+}
+
+void tearDown(void) {
+    remove(PATH);
+}
+
+void test_all_paths_read_same_bytes(void) {
+    std::string expected = makeFile(PATH, 70000);
+
+    StandInString perByte;
+    readPerByte(PATH, perByte);
+    StandInString bulk;
+    readBulk(PATH, bulk);
+    std::string buffer(expected.size(), '\0');
+    size_t count = readIntoBuffer(PATH, (uint8_t*)&buffer[0], buffer.size());
+
+    TEST_ASSERT_EQUAL(expected.size(), perByte.length());
+    TEST_ASSERT_EQUAL(expected.size(), bulk.length());
+    TEST_ASSERT_EQUAL(expected.size(), count);
+    TEST_ASSERT_TRUE(expected == perByte.c_str());
+    TEST_ASSERT_TRUE(expected == bulk.c_str());
+    TEST_ASSERT_TRUE(expected == buffer);
+}
+
+void test_buffer_read_stops_at_capacity(void) {
+    std::string expected = makeFile(PATH, 40000);
+    std::string buffer(20000, '\0');
+    TEST_ASSERT_EQUAL(20000, readIntoBuffer(PATH, (uint8_t*)&buffer[0], buffer.size()));
+    TEST_ASSERT_TRUE(expected.compare(0, 20000, buffer) == 0);
+    TEST_ASSERT_EQUAL(0, heapAllocations);
+}
+
+void test_empty_and_missing_files(void) {
+    makeFile(PATH, 0);
+    uint8_t buffer[16];
+    TEST_ASSERT_EQUAL(0, readIntoBuffer(PATH, buffer, sizeof(buffer)));
+    StandInString bulk;
+    readBulk(PATH, bulk);
+    TEST_ASSERT_EQUAL(0, bulk.length());
+    remove(PATH);
+    TEST_ASSERT_EQUAL(0, readIntoBuffer(PATH, buffer, sizeof(buffer)));
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void benchmarkSize(size_t bytes) {
+    makeFile(PATH, bytes);
+    // Roughly 16 MB per path, at least 4 reads
+    int repeats = (int)(16u * 1048576u / bytes);
+    if (repeats < 4) repeats = 4;
+    double mb = (double)bytes * repeats / 1048576.0;
+
+    heapAllocations = 0;
+    uint64_t start = nowNs();
+    for (int i = 0; i < repeats; i++) {
+        StandInString content;
+        readPerByte(PATH, content);
+    }
+    double perByteS = (double)(nowNs() - start) / 1e9;
+    uint32_t perByteAllocs = heapAllocations / repeats;
+
+    heapAllocations = 0;
+    start = nowNs();
+    for (int i = 0; i < repeats; i++) {
+        StandInString content;
+        readBulk(PATH, content);
+    }
+    double bulkS = (double)(nowNs() - start) / 1e9;
+    uint32_t bulkAllocs = heapAllocations / repeats;
+
+    uint8_t* buffer = (uint8_t*)malloc(bytes);
+    heapAllocations = 0;
+    start = nowNs();
+    for (int i = 0; i < repeats; i++) {
+        readIntoBuffer(PATH, buffer, bytes);
+    }
+    double bufferS = (double)(nowNs() - start) / 1e9;
+    uint32_t bufferAllocs = heapAllocations / repeats;
+    free(buffer);
+
+    printf("[bench] %7u B  per byte: %7.1f MB/s %6u allocs | bulk String: %7.1f MB/s %u allocs | caller buffer: %7.1f MB/s %u allocs\n",
+           (unsigned)bytes, mb / perByteS, perByteAllocs, mb / bulkS, bulkAllocs, mb / bufferS, bufferAllocs);
+
+    TEST_ASSERT_EQUAL(2, bulkAllocs);
+    TEST_ASSERT_EQUAL(0, bufferAllocs);
+    TEST_ASSERT_TRUE(perByteAllocs >= bytes / 16);
+}
+
+void benchmark_read_paths(void) {
+    benchmarkSize(4096);
+    benchmarkSize(65536);
+    benchmarkSize(1048576);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_all_paths_read_same_bytes);
+    RUN_TEST(test_buffer_read_stops_at_capacity);
+    RUN_TEST(test_empty_and_missing_files);
+    RUN_TEST(benchmark_read_paths);
+    return UNITY_END();
+}
@@ -0,0 +1,342 @@
+/**
+ * @file test_host_write_cache.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tests and benchmark for the aligned write-behind cache.
+ * @section tests Tests
+ * - Appends reach the sink only as blocks ending on a block boundary.
+ * - Files reopened mid-block are topped up to the boundary first.
+ * - Large appends skip the copy; drain() writes the rest; failed sinks keep data.
+ * - With no further writes, the pool's dirty timeout drains the cache to the file.
+ * - Write amplification and throughput of log-sized appends, direct vs cached,
+ *   on a block-device stand-in with 512 B sectors and 4 KB erase blocks.
+ * @version 0.1
+ * @date 20261016
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "EARS_writeCache.h"
+#include "EARS_handlePool.h"
+
+/*
+  Block-device stand-in: one file on a card that programs whole sectors.
+  A write touching part of a sector reads it, merges and programs all of it;
+  every sector a write touches is counted and copied in full.
+*/
+class BlockFile {
+public:
+    static const size_t SECTOR_BYTES = 512;
+    static const size_t ERASE_BYTES = 4096;
+
+    std::vector<uint8_t> content;
+    uint64_t sectorsProgrammed;
+    uint64_t sectorsRead;
+    uint64_t eraseBlocksTouched;
+    uint32_t writes;
+    uint32_t unalignedWrites;   // Writes not ending on a sector boundary
+    bool fail;
+
+    BlockFile() : sectorsProgrammed(0), sectorsRead(0), eraseBlocksTouched(0),
+                  writes(0), unalignedWrites(0), fail(false) {}
+
+    bool write(const uint8_t* data, size_t length) {
+        if (fail) return false;
+        size_t offset = content.size();
+        size_t first = offset / SECTOR_BYTES;
+        size_t last = (offset + length - 1) / SECTOR_BYTES;
+        content.resize((last + 1) * SECTOR_BYTES);
+        memcpy(&content[offset], data, length);
+
+        for (size_t sector = first; sector <= last; sector++) {
+            size_t start = sector * SECTOR_BYTES;
+            if (start < offset || start + SECTOR_BYTES > offset + length) {
+                sectorsRead++;
+            }
+            memcpy(programmed, &content[start], SECTOR_BYTES);
+            sectorsProgrammed++;
+        }
+        eraseBlocksTouched += (offset + length - 1) / ERASE_BYTES - offset / ERASE_BYTES + 1;
+        content.resize(offset + length);
+        writes++;
+        if ((offset + length) % SECTOR_BYTES != 0) {
+            unalignedWrites++;
+        }
+        return true;
+    }
+
+    static bool sink(const uint8_t* data, size_t length, void* context) {
+        return static_cast<BlockFile*>(context)->write(data, length);
+    }
+
+private:
+    uint8_t programmed[SECTOR_BYTES];
+};
+
+static uint8_t block[4096];
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static void fillLine(uint8_t* line, size_t length, int index) {
+    for (size_t i = 0; i < length; i++) {
+        line[i] = (uint8_t)('a' + (index + i) % 26);
+    }
+    line[length - 1] = '\n';
+}
+
+void test_begin_validates(void) {
+    EARS_writeCache cache;
+    TEST_ASSERT_FALSE(cache.begin(nullptr, 4096));
+    TEST_ASSERT_FALSE(cache.begin(block, 256));
+    TEST_ASSERT_FALSE(cache.begin(block, 3000));
+    TEST_ASSERT_TRUE(cache.begin(block, 512));
+    TEST_ASSERT_TRUE(cache.begin(block, 4096));
+}
+
+void test_appends_write_whole_blocks(void) {
+    EARS_writeCache cache;
+    BlockFile file;
+    cache.begin(block, 4096);
+    cache.reset(0);
+
+    uint8_t line[100];
+    std::vector<uint8_t> expected;
+    for (int i = 0; i < 100; i++) {
+        fillLine(line, sizeof(line), i);
+        expected.insert(expected.end(), line, line + sizeof(line));
+        TEST_ASSERT_TRUE(cache.append(line, sizeof(line), BlockFile::sink, &file));
+    }
+
+    // 10000 bytes: two full blocks written, 1808 bytes waiting
+    TEST_ASSERT_EQUAL(2, file.writes);
+    TEST_ASSERT_EQUAL(8192, file.content.size());
+    TEST_ASSERT_EQUAL(1808, cache.pending());
+    TEST_ASSERT_EQUAL(10000, cache.fileSize());
+    TEST_ASSERT_EQUAL(0, file.sectorsRead);
+
+    TEST_ASSERT_TRUE(cache.drain(BlockFile::sink, &file));
+    TEST_ASSERT_EQUAL(0, cache.pending());
+    TEST_ASSERT_EQUAL(expected.size(), file.content.size());
+    TEST_ASSERT_EQUAL_MEMORY(&expected[0], &file.content[0], expected.size());
+
+    WriteCacheStats stats = cache.getStats();
+    TEST_ASSERT_EQUAL(100, stats.appends);
+    TEST_ASSERT_EQUAL(3, stats.sinkWrites);
+    TEST_ASSERT_EQUAL(1, stats.partialWrites);
+    TEST_ASSERT_EQUAL(10000, (uint32_t)stats.bytes);
+}
+
+void test_reopened_file_is_topped_up_to_boundary(void) {
+    EARS_writeCache cache;
+    BlockFile file;
+    uint8_t existing[1000];
+    fillLine(existing, sizeof(existing), 7);
+    file.write(existing, sizeof(existing));
+    file.writes = 0;
+    file.unalignedWrites = 0;
+
+    cache.begin(block, 4096);
+    cache.reset((uint32_t)file.content.size());
+
+    uint8_t line[128];
+    for (int i = 0; i < 40; i++) {
+        fillLine(line, sizeof(line), i);
+        cache.append(line, sizeof(line), BlockFile::sink, &file);
+    }
+
+    // 1000 + 5120: the first write ends at 4096, nothing else is full yet
+    TEST_ASSERT_EQUAL(1, file.writes);
+    TEST_ASSERT_EQUAL(4096, file.content.size());
+    TEST_ASSERT_EQUAL(0, file.unalignedWrites);
+    TEST_ASSERT_EQUAL(6120 - 4096, cache.pending());
+}
+
+void test_large_append_skips_the_copy(void) {
+    EARS_writeCache cache;
+    BlockFile file;
+    cache.begin(block, 512);
+    cache.reset(0);
+
+    static uint8_t big[2000];
+    fillLine(big, sizeof(big), 3);
+    TEST_ASSERT_TRUE(cache.append(big, 100, BlockFile::sink, &file));
+    TEST_ASSERT_TRUE(cache.append(big + 100, 1900, BlockFile::sink, &file));
+
+    // 412 to fill the first block, 1024 direct, 464 left
+    TEST_ASSERT_EQUAL(2, file.writes);
+    TEST_ASSERT_EQUAL(1536, file.content.size());
+    TEST_ASSERT_EQUAL(464, cache.pending());
+    cache.drain(BlockFile::sink, &file);
+    TEST_ASSERT_EQUAL_MEMORY(big, &file.content[0], sizeof(big));
+}
+
+void test_failed_sink_keeps_the_block(void) {
+    EARS_writeCache cache;
+    BlockFile file;
+    cache.begin(block, 512);
+    cache.reset(0);
+
+    uint8_t line[300];
+    fillLine(line, sizeof(line), 1);
+    file.fail = true;
+    cache.append(line, sizeof(line), BlockFile::sink, &file);
+    TEST_ASSERT_FALSE(cache.append(line, sizeof(line), BlockFile::sink, &file));
+    TEST_ASSERT_EQUAL(512, cache.pending());
+    TEST_ASSERT_FALSE(cache.drain(BlockFile::sink, &file));
+
+    file.fail = false;
+    TEST_ASSERT_TRUE(cache.drain(BlockFile::sink, &file));
+    TEST_ASSERT_EQUAL(512, file.content.size());
+    TEST_ASSERT_EQUAL(0, cache.pending());
+}
+
+void test_without_buffer_writes_through(void) {
+    EARS_writeCache cache;
+    BlockFile file;
+    uint8_t line[50];
+    fillLine(line, sizeof(line), 0);
+    TEST_ASSERT_TRUE(cache.append(line, sizeof(line), BlockFile::sink, &file));
+    TEST_ASSERT_EQUAL(1, file.writes);
+    TEST_ASSERT_EQUAL(0, cache.pending());
+    TEST_ASSERT_TRUE(cache.drain(BlockFile::sink, &file));
+}
+
+/*
+  EARS_sdCard's slots in miniature: flushing a handle drains its cache first
+*/
+class CachedOwner : public EARS_handleOwner {
+public:
+    EARS_writeCache caches[2];
+    BlockFile files[2];
+
+    bool openHandle(uint8_t slot, const char* path, bool truncate) override {
+        (void)path;
+        (void)truncate;
+        caches[slot].reset((uint32_t)files[slot].content.size());
+        return true;
+    }
+    bool flushHandle(uint8_t slot) override {
+        return caches[slot].drain(BlockFile::sink, &files[slot]);
+    }
+    void closeHandle(uint8_t slot) override {
+        caches[slot].drain(BlockFile::sink, &files[slot]);
+    }
+};
+
+void test_quiet_spell_drains_cache_on_dirty_timeout(void) {
+    static uint8_t blocks[2][4096];
+    CachedOwner owner;
+    owner.caches[0].begin(blocks[0], sizeof(blocks[0]));
+    owner.caches[1].begin(blocks[1], sizeof(blocks[1]));
+    EARS_handlePool pool;
+    TEST_ASSERT_TRUE(pool.begin(&owner, 2, 1000));
+
+    // The last lines before the device goes quiet, far short of a block
+    int slot = pool.acquire("/logs/error_log.txt", false);
+    TEST_ASSERT_TRUE(slot >= 0);
+    uint8_t line[80];
+    for (int i = 0; i < 3; i++) {
+        fillLine(line, sizeof(line), i);
+        TEST_ASSERT_TRUE(owner.caches[slot].append(line, sizeof(line), BlockFile::sink, &owner.files[slot]));
+        pool.markDirty((uint8_t)slot, 10u * i);
+    }
+    TEST_ASSERT_EQUAL(0, owner.files[slot].content.size());
+
+    // Only the periodic tick runs from here (loop() -> flushExpired())
+    TEST_ASSERT_EQUAL(0, pool.flushExpired(500));
+    TEST_ASSERT_EQUAL(0, owner.files[slot].content.size());
+    TEST_ASSERT_EQUAL(1, pool.flushExpired(1000));
+    TEST_ASSERT_EQUAL(3 * sizeof(line), owner.files[slot].content.size());
+    TEST_ASSERT_EQUAL(0, owner.caches[slot].pending());
+    fillLine(line, sizeof(line), 2);
+    TEST_ASSERT_EQUAL_MEMORY(line, &owner.files[slot].content[2 * sizeof(line)], sizeof(line));
+    TEST_ASSERT_FALSE(pool.isDirty());
+}
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void report(const char* name, const BlockFile& file, uint64_t payload, uint64_t ns) {
+    printf("[bench] %-13s %6u writes, %5.2fx sector amplification (%llu programmed, %llu read-modify-write), "
+           "%llu erase-block touches, %7.1f MB/s\n",
+           name, file.writes,
+           (double)(file.sectorsProgrammed * BlockFile::SECTOR_BYTES) / payload,
+           (unsigned long long)file.sectorsProgrammed, (unsigned long long)file.sectorsRead,
+           (unsigned long long)file.eraseBlocksTouched,
+           (double)payload / 1e6 / ((double)ns / 1e9));
+}
+
+/*
+  4 MB of 96 byte log lines, each appended as the logger does
+*/
+void benchmark_write_amplification(void) {
+    const int lines = 43690;
+    uint8_t line[96];
+    uint64_t payload = (uint64_t)lines * sizeof(line);
+
+    BlockFile direct;
+    uint64_t start = nowNs();
+    for (int i = 0; i < lines; i++) {
+        fillLine(line, sizeof(line), i);
+        direct.write(line, sizeof(line));
+    }
+    uint64_t directNs = nowNs() - start;
+
+    BlockFile sector;
+    EARS_writeCache sectorCache;
+    sectorCache.begin(block, 512);
+    sectorCache.reset(0);
+    start = nowNs();
+    for (int i = 0; i < lines; i++) {
+        fillLine(line, sizeof(line), i);
+        sectorCache.append(line, sizeof(line), BlockFile::sink, &sector);
+    }
+    sectorCache.drain(BlockFile::sink, &sector);
+    uint64_t sectorNs = nowNs() - start;
+
+    BlockFile cached;
+    EARS_writeCache cache;
+    cache.begin(block, 4096);
+    cache.reset(0);
+    start = nowNs();
+    for (int i = 0; i < lines; i++) {
+        fillLine(line, sizeof(line), i);
+        cache.append(line, sizeof(line), BlockFile::sink, &cached);
+    }
+    cache.drain(BlockFile::sink, &cached);
+    uint64_t cachedNs = nowNs() - start;
+
+    report("direct:", direct, payload, directNs);
+    report("512 B cache:", sector, payload, sectorNs);
+    report("4 KB cache:", cached, payload, cachedNs);
+
+    TEST_ASSERT_TRUE(direct.content == cached.content);
+    TEST_ASSERT_TRUE(direct.content == sector.content);
+    TEST_ASSERT_TRUE(direct.sectorsProgrammed > 5 * cached.sectorsProgrammed);
+    TEST_ASSERT_TRUE(cached.sectorsRead <= 1);
+    TEST_ASSERT_TRUE(cached.eraseBlocksTouched <= payload / BlockFile::ERASE_BYTES + 1);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_validates);
+    RUN_TEST(test_appends_write_whole_blocks);
+    RUN_TEST(test_reopened_file_is_topped_up_to_boundary);
+    RUN_TEST(test_large_append_skips_the_copy);
+    RUN_TEST(test_failed_sink_keeps_the_block);
+    RUN_TEST(test_without_buffer_writes_through);
+    RUN_TEST(test_quiet_spell_drains_cache_on_dirty_timeout);
+    RUN_TEST(benchmark_write_amplification);
+    return UNITY_END();
+}
@@ -0,0 +1,61 @@
+/**
+ * @file ears_logcat.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tool printing EARS log generations, compressed or plain
+ * @version 1.1.0
+ * @date 20261016
+ *
+ * @details
+ * Build from the project root:
+ *   g++ -std=gnu++11 -O2 -I lib/EARS_fsPortLib -I lib/EARS_logCompressLib -o ears_logcat \
+ *       tools/ears_logcat/ears_logcat.cpp \
+ *       lib/EARS_fsPortLib/EARS_fsPortLib.cpp lib/EARS_fsPortLib/EARS_stdioFs.cpp \
+ *       lib/EARS_fsPortLib/EARS_preallocLog.cpp \
+ *       lib/EARS_logCompressLib/EARS_logCompressLib.cpp \
+ *       lib/EARS_logCompressLib/EARS_logCompressReader.cpp
+ *
+ * Usage, oldest generation first:
+ *   ears_logcat debug.log.3 debug.log.2 debug.log.1 debug.log > debug.txt
+ *
+ * Preallocated files are printed up to their committed end. Binary (.ebl)
+ * generations go through ears_logdecode instead, which also reads
+ * compressed and preallocated files.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <vector>
+#include "EARS_stdioFs.h"
+#include "EARS_logCompressReader.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <debug.log.N> [more files, oldest first]\n", argv[0]);
+        return 2;
+    }
+
+    EARS_stdioFs fs;
+    std::vector<uint8_t> workspace(EARS_logCompressReader::workspaceBytes(EARS_logCompressor::MAX_BLOCK_BYTES));
+    EARS_logCompressReader reader;
+    reader.begin(workspace.data(), workspace.size(), EARS_logCompressor::MAX_BLOCK_BYTES);
+
+    int status = 0;
+    uint8_t chunk[4096];
+    for (int i = 1; i < argc; i++) {
+        if (!reader.open(fs, argv[i])) {
+            fprintf(stderr, "Cannot read %s\n", argv[i]);
+            status = 1;
+            continue;
+        }
+        size_t count;
+        while ((count = reader.read(chunk, sizeof(chunk))) > 0) {
+            fwrite(chunk, 1, count, stdout);
+        }
+        if (reader.failed()) {
+            fprintf(stderr, "%s: stopped at a corrupt or cut off block\n", argv[i]);
+            status = 1;
+        }
+    }
+    return status;
+}
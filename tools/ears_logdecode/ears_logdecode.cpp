@@ -0,0 +1,88 @@
+/**
+ * @file ears_logdecode.cpp
+ * @author Julian (51fiftyone51fiftyone@gmail.com)
+ * @brief Host tool printing binary EARS logs as text
+ * @version 1.2.0
+ * @date 20261016
+ *
+ * @details
+ * Build from the project root:
+ *   g++ -std=gnu++11 -O2 -I lib/EARS_logBinaryLib -I lib/EARS_fsPortLib \
+ *       -I lib/EARS_logCompressLib -o ears_logdecode \
+ *       tools/ears_logdecode/ears_logdecode.cpp \
+ *       lib/EARS_logBinaryLib/EARS_logBinaryLib.cpp \
+ *       lib/EARS_logBinaryLib/EARS_logBinaryDecoder.cpp \
+ *       lib/EARS_fsPortLib/EARS_fsPortLib.cpp lib/EARS_fsPortLib/EARS_stdioFs.cpp \
+ *       lib/EARS_fsPortLib/EARS_preallocLog.cpp \
+ *       lib/EARS_logCompressLib/EARS_logCompressLib.cpp \
+ *       lib/EARS_logCompressLib/EARS_logCompressReader.cpp
+ *
+ * Usage, oldest generation first:
+ *   ears_logdecode debug.ebl.3 debug.ebl.2 debug.ebl.1 debug.ebl > debug.log
+ *
+ * Compressed generations are decompressed on the fly; preallocated ones
+ * are read up to their committed end.
+ *
+ * @copyright Copyright (c) 2026 JTB. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "EARS_logBinaryDecoder.h"
+#include "EARS_stdioFs.h"
+#include "EARS_logCompressReader.h"
+
+static bool readFile(const char* path, std::vector<uint8_t>& data) {
+    static EARS_stdioFs fs;
+    static std::vector<uint8_t> workspace(EARS_logCompressReader::workspaceBytes(EARS_logCompressor::MAX_BLOCK_BYTES));
+    EARS_logCompressReader reader;
+    reader.begin(workspace.data(), workspace.size(), EARS_logCompressor::MAX_BLOCK_BYTES);
+    if (!reader.open(fs, path)) {
+        return false;
+    }
+    uint8_t chunk[4096];
+    size_t count;
+    while ((count = reader.read(chunk, sizeof(chunk))) > 0) {
+        data.insert(data.end(), chunk, chunk + count);
+    }
+    return !reader.failed();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <file.ebl> [more files, oldest first]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<std::vector<uint8_t> > files(argc - 1);
+    for (int i = 1; i < argc; i++) {
+        if (!readFile(argv[i], files[i - 1])) {
+            fprintf(stderr, "Cannot read %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // Async logging can put a FORMAT record in an earlier generation
+    EARS_logBinaryDecoder decoder;
+    for (size_t i = 0; i < files.size(); i++) {
+        decoder.learnFormats(files[i].data(), files[i].size());
+    }
+
+    int status = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        std::vector<LogBinaryLine> lines;
+        if (!decoder.decode(files[i].data(), files[i].size(), lines)) {
+            fprintf(stderr, "%s: stopped at a corrupt or cut off record\n", argv[i + 1]);
+            status = 1;
+        }
+        for (size_t j = 0; j < lines.size(); j++) {
+            printf("%s\n", EARS_logBinaryDecoder::toText(lines[j]).c_str());
+        }
+    }
+
+    if (decoder.unknownFormats()) {
+        fprintf(stderr, "%u entries with unknown format\n", (unsigned)decoder.unknownFormats());
+    }
+    return status;
+}